@@ -29,9 +29,14 @@
 // ____________________________________________________________________ //
 //                                                                      //
 
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <math.h>
 #include <time.h>
 #include <string.h>
@@ -42,14 +47,22 @@
 	#include <omp.h>
 #endif
 
+// WARNING: The following requires an MPI implementation and
+//          will only be enabled when compiled with -DSOFIA_MPI.
+#ifdef SOFIA_MPI
+	#include <mpi.h>
+#endif
+
 // WARNING: The following will only work on POSIX-compliant
-//          systems, but is needed for mkdir().
+//          systems, but is needed for mkdir() and posix_fadvise().
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 
 #include "src/common.h"
 #include "src/Table.h"
 #include "src/Path.h"
+#include "src/Profiler.h"
 #include "src/Array_dbl.h"
 #include "src/Array_siz.h"
 #include "src/Map.h"
@@ -68,6 +81,31 @@
 // and write out catalogues and images.                              //
 // ----------------------------------------------------------------- //
 
+PRIVATE Catalog  *run_pipeline   (Parameter *par, const bool tiled, const bool allow_empty, const char *checkpoint_name, Profiler *profiler, const time_t start_time, const clock_t start_clock);
+PRIVATE void      run_tiled      (Parameter *par, Profiler *profiler, const time_t start_time, const clock_t start_clock);
+PRIVATE void      run_sweep      (Parameter *par, Profiler *profiler, const time_t start_time, const clock_t start_clock);
+PRIVATE void      run_batch      (Parameter *par, Profiler *profiler, const time_t start_time, const clock_t start_clock);
+PRIVATE void      batch_output_path(Path *path, const char *file_name, const char *base_dir);
+PRIVATE void      batch_prefetch (const char *filename);
+PRIVATE void      plan_memory    (Parameter *par, const bool allow_tiling);
+PRIVATE size_t    plan_stages    (const Parameter *par, const size_t n_vox, const size_t word_size, size_t *mem_data, size_t *mem_keep, size_t *mem_noise, size_t *mem_bits, size_t *mem_scfind, size_t *mem_mask);
+PRIVATE size_t    plan_tile_core (const Parameter *par, const size_t word_size, const size_t *extent, const size_t overlap, const bool spatial, const size_t limit);
+PRIVATE size_t    plan_peak      (const size_t data, const size_t keep, const size_t noise, const size_t bits, const size_t scfind, const size_t mask);
+PRIVATE void      mpi_get_rank   (int *rank, int *size);
+PRIVATE void      mpi_sum        (size_t *value);
+PRIVATE Catalog  *mpi_gather_catalog(Catalog *catalog, Array_siz **source_tiles);
+#ifdef SOFIA_MPI
+PRIVATE void      mpi_abort_on_exit(void);
+PRIVATE void      mpi_pack       (char **buffer, size_t *size, const void *data, const size_t n);
+PRIVATE void      mpi_pack_string(char **buffer, size_t *size, const char *string);
+PRIVATE void      mpi_unpack     (const char **ptr, const char *end, void *data, const size_t n);
+PRIVATE String   *mpi_unpack_string(const char **ptr, const char *end, String *string);
+#endif
+PRIVATE uint64_t  checkpoint_hash(uint64_t hash, const char *string);
+PRIVATE uint64_t  checkpoint_key (const Parameter *par);
+PRIVATE DataCube *checkpoint_load(Path *path_cube, Path *path_mask, const uint64_t key, Array_siz **flag_regions, bool *use_flagging, BitMask **maskBits, const bool verbosity);
+PRIVATE void      checkpoint_save(Path *path_cube, Path *path_mask, const uint64_t key, DataCube *dataCube, const BitMask *maskBits, const Array_siz *flag_regions, const bool use_flagging);
+
 int main(int argc, char **argv)
 {
 	// ---------------------------- //
@@ -79,13 +117,24 @@ int main(int argc, char **argv)
 	
 	
 	
+	// ---------------------------- //
+	// Initialise MPI if enabled    //
+	// ---------------------------- //
+	
+	#ifdef SOFIA_MPI
+		MPI_Init(&argc, &argv);
+		atexit(mpi_abort_on_exit);
+	#endif
+	
+	int mpi_rank, mpi_size;
+	mpi_get_rank(&mpi_rank, &mpi_size);
+	
+	
+	
 	// ---------------------------- //
 	// A few global definitions     //
 	// ---------------------------- //
 	
-	const char *noise_stat_name[] = {"standard deviation", "median absolute deviation", "Gaussian fit to flux histogram", "mean", "median"};
-	const char *flux_range_name[] = {"negative", "full", "positive"};
-	double global_rms = 1.0;
 	#ifdef _OPENMP
 		const int n_cpu_cores = omp_get_num_procs();
 	#endif
@@ -104,6 +153,9 @@ int main(int argc, char **argv)
 	#else
 		message("CPU:      OpenMP disabled");
 	#endif
+	#ifdef SOFIA_MPI
+		message("MPI:      process %d of %d", mpi_rank + 1, mpi_size);
+	#endif
 	message("Time:     %s", ctime(&start_time));
 	
 	
@@ -202,6 +254,68 @@ int main(int argc, char **argv)
 		warning("Multi-threading is currently disabled. To enable it, please re-\n         install SoFiA with the '-fopenmp' option.");
 	#endif
 	
+	// Request huge pages for large data arrays if specified
+	DataCube_set_huge_pages(Parameter_get_bool(par, "pipeline.hugePages"));
+	
+	
+	
+	// ---------------------------- //
+	// Run pipeline                 //
+	// ---------------------------- //
+	
+	// Set up profiler if requested
+	Profiler *profiler = Parameter_get_bool(par, "pipeline.profile") ? Profiler_new() : NULL;
+	
+	// Adjust execution strategy to memory limit if specified
+	// NOTE: In batch mode, each cube will be planned separately.
+	ensure(Parameter_get_int(par, "pipeline.memoryLimit") >= 0, ERR_USER_INPUT, "Memory limit must not be negative.");
+	if(Parameter_get_int(par, "pipeline.memoryLimit") > 0 && !strlen(Parameter_get_str(par, "input.batch"))) plan_memory(par, !strlen(Parameter_get_str(par, "pipeline.sweep")) && !Parameter_get_bool(par, "pipeline.checkpoint"));
+	
+	// Multiple MPI processes can only share work in tiled or batch mode
+	ensure(mpi_size == 1 || Parameter_get_bool(par, "tiling.enable") || strlen(Parameter_get_str(par, "input.batch")), ERR_USER_INPUT, "Running on multiple MPI processes requires either tiling\n       (\'tiling.enable = true\') or batch mode (\'input.batch\').");
+	
+	if(strlen(Parameter_get_str(par, "input.batch"))) run_batch(par, profiler, start_time, start_clock);
+	else if(Parameter_get_bool(par, "tiling.enable")) run_tiled(par, profiler, start_time, start_clock);
+	else if(strlen(Parameter_get_str(par, "pipeline.sweep"))) run_sweep(par, profiler, start_time, start_clock);
+	else Catalog_delete(run_pipeline(par, false, false, NULL, profiler, start_time, start_clock));
+	
+	// Delete profiler and input parameters
+	Profiler_delete(profiler);
+	Parameter_delete(par);
+	
+	// Print status message
+	status("Pipeline finished.");
+	
+	#ifdef SOFIA_MPI
+		MPI_Finalize();
+	#endif
+	
+	return ERR_SUCCESS;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Run the actual source finding pipeline on the data cube or sub-   //
+// region specified in the parameter settings. If empty results are  //
+// allowed (always the case in tiled mode), the absence of sources   //
+// will not terminate the pipeline, and the final source catalogue   //
+// will be returned to the caller, e.g. for merging with the cata-   //
+// logues of the remaining tiles. If a checkpoint name is provided,  //
+// checkpointing will be enabled and the checkpoint files will be    //
+// named after it rather than the output file name.                  //
+// ----------------------------------------------------------------- //
+
+PRIVATE Catalog *run_pipeline(Parameter *par, const bool tiled, const bool allow_empty, const char *checkpoint_name, Profiler *profiler, const time_t start_time, const clock_t start_clock)
+{
+	// ---------------------------- //
+	// A few global definitions     //
+	// ---------------------------- //
+	
+	const char *noise_stat_name[] = {"standard deviation", "median absolute deviation", "Gaussian fit to flux histogram", "mean", "median"};
+	const char *flux_range_name[] = {"negative", "full", "positive"};
+	double global_rms = 1.0;
+	
 	
 	
 	// ---------------------------- //
@@ -215,6 +329,7 @@ int main(int argc, char **argv)
 	const bool use_weights       = strlen(Parameter_get_str(par, "input.weights"))? true : false;
 	const bool use_mask          = strlen(Parameter_get_str(par, "input.mask"))   ? true : false;
 	const bool use_invert        = Parameter_get_bool(par, "input.invert");
+	const bool use_single        = strcmp(Parameter_get_str(par, "input.precision"), "single") == 0;
 	      bool use_flagging      = strlen(Parameter_get_str(par, "flag.region"))  ? true : false;
 	const bool use_flagging_cat  = strlen(Parameter_get_str(par, "flag.catalog")) ? true : false;
 	const bool autoflag_log      = Parameter_get_bool(par, "flag.log");
@@ -237,10 +352,14 @@ int main(int argc, char **argv)
 	const bool use_wcs           = Parameter_get_bool(par, "parameter.wcs");
 	const bool use_physical      = Parameter_get_bool(par, "parameter.physical");
 	const bool use_pos_offset    = Parameter_get_bool(par, "parameter.offset");
+	const bool use_reload        = use_noise || use_weights || use_noise_scaling;  // ALERT: Add conditions here as needed.
+	const bool keep_data         = Parameter_get_bool(par, "parameter.keepData") && use_reload;
+	const bool use_checkpoint    = (Parameter_get_bool(par, "pipeline.checkpoint") || checkpoint_name != NULL) && !tiled;
 	
 	const bool write_ascii       = Parameter_get_bool(par, "output.writeCatASCII");
 	const bool write_xml         = Parameter_get_bool(par, "output.writeCatXML");
 	const bool write_sql         = Parameter_get_bool(par, "output.writeCatSQL");
+	const bool write_fits        = Parameter_get_bool(par, "output.writeCatFITS");
 	const bool write_noise       = Parameter_get_bool(par, "output.writeNoise");
 	const bool write_filtered    = Parameter_get_bool(par, "output.writeFiltered");
 	const bool write_mask        = Parameter_get_bool(par, "output.writeMask");
@@ -290,6 +409,9 @@ int main(int argc, char **argv)
 	int ripple_filter_statistic = NOISE_STAT_MEDIAN;
 	if(strcmp(Parameter_get_str(par, "rippleFilter.statistic"), "mean") == 0) ripple_filter_statistic = NOISE_STAT_MEAN;
 	
+	// Working precision sanity check
+	ensure(use_single || strcmp(Parameter_get_str(par, "input.precision"), "native") == 0, ERR_USER_INPUT, "Invalid working precision: \'%s\'. Must be \'native\' or \'single\'.", Parameter_get_str(par, "input.precision"));
+	
 	// Noise and weights sanity check
 	if(use_noise && use_weights) warning("Applying both a weights cube and a noise cube.");
 	
@@ -360,6 +482,7 @@ int main(int argc, char **argv)
 	Path *path_cat_ascii = Path_new();
 	Path *path_cat_xml   = Path_new();
 	Path *path_cat_sql   = Path_new();
+	Path *path_cat_fits  = Path_new();
 	Path *path_noise_out = Path_new();
 	Path *path_filtered  = Path_new();
 	Path *path_mask_out  = Path_new();
@@ -375,11 +498,15 @@ int main(int argc, char **argv)
 	Path *path_skel_plot = Path_new();
 	Path *path_flag      = Path_new();
 	Path *path_cubelets  = Path_new();
+	Path *path_profile   = Path_new();
+	Path *path_chk_cube  = Path_new();
+	Path *path_chk_mask  = Path_new();
 	
 	// Set up global output directory names
 	Path_set_dir(path_cat_ascii, String_get(output_dir_name));
 	Path_set_dir(path_cat_xml,   String_get(output_dir_name));
 	Path_set_dir(path_cat_sql,   String_get(output_dir_name));
+	Path_set_dir(path_cat_fits,  String_get(output_dir_name));
 	Path_set_dir(path_noise_out, String_get(output_dir_name));
 	Path_set_dir(path_filtered,  String_get(output_dir_name));
 	Path_set_dir(path_mask_out,  String_get(output_dir_name));
@@ -395,11 +522,15 @@ int main(int argc, char **argv)
 	Path_set_dir(path_skel_plot, String_get(output_dir_name));
 	Path_set_dir(path_flag,      String_get(output_dir_name));
 	Path_set_dir(path_cubelets,  String_get(output_dir_name));
+	Path_set_dir(path_profile,   String_get(output_dir_name));
+	Path_set_dir(path_chk_cube,  String_get(output_dir_name));
+	Path_set_dir(path_chk_mask,  String_get(output_dir_name));
 	
 	// Set up global output file names
 	Path_set_file_from_template(path_cat_ascii,  String_get(output_file_name), "_cat",         ".txt");
 	Path_set_file_from_template(path_cat_xml,    String_get(output_file_name), "_cat",         ".xml");
 	Path_set_file_from_template(path_cat_sql,    String_get(output_file_name), "_cat",         ".sql");
+	Path_set_file_from_template(path_cat_fits,   String_get(output_file_name), "_cat",         ".fits");
 	Path_set_file_from_template(path_noise_out,  String_get(output_file_name), "_noise",       use_local_scaling ? ".fits" : ".txt");
 	Path_set_file_from_template(path_filtered,   String_get(output_file_name), "_filtered",    ".fits");
 	Path_set_file_from_template(path_mask_out,   String_get(output_file_name), "_mask",        ".fits");
@@ -414,6 +545,9 @@ int main(int argc, char **argv)
 	Path_set_file_from_template(path_rel_cat_p,  String_get(output_file_name), "_rel_cat_pos", ".xml");
 	Path_set_file_from_template(path_skel_plot,  String_get(output_file_name), "_skellam",     ".eps");
 	Path_set_file_from_template(path_flag,       String_get(output_file_name), "_flags",       ".log");
+	Path_set_file_from_template(path_profile,    String_get(output_file_name), "_profile",     ".json");
+	Path_set_file_from_template(path_chk_cube,   checkpoint_name != NULL ? checkpoint_name : String_get(output_file_name), "_checkpoint", ".fits");
+	Path_set_file_from_template(path_chk_mask,   checkpoint_name != NULL ? checkpoint_name : String_get(output_file_name), "_checkpoint", ".bin");
 	
 	// Set up cubelet directory and file base name
 	Path_append_dir_from_template(path_cubelets, String_get(output_file_name), "_cubelets");
@@ -490,6 +624,11 @@ int main(int argc, char **argv)
 				"SQL catalogue file already exists. Please delete the file\n"
 				"       or set \'output.overwrite = true\'.");
 		}
+		if(write_fits) {
+			ensure(!Path_file_is_readable(path_cat_fits), ERR_FILE_ACCESS,
+				"FITS catalogue file already exists. Please delete the file\n"
+				"       or set \'output.overwrite = true\'.");
+		}
 		if(use_noise_scaling && write_noise) {
 			ensure(!Path_file_is_readable(path_noise_out), ERR_FILE_ACCESS,
 				"Noise cube/spectrum already exists. Please delete the file\n"
@@ -515,6 +654,11 @@ int main(int argc, char **argv)
 				"Raw mask cube already exists. Please delete the file\n"
 				"       or set \'output.overwrite = true\'.");
 		}
+		if(profiler != NULL && !tiled) {
+			ensure(!Path_file_is_readable(path_profile), ERR_FILE_ACCESS,
+				"Profiling report already exists. Please delete the file\n"
+				"       or set \'output.overwrite = true\'.");
+		}
 		if(write_moments) {
 			ensure(!Path_file_is_readable(path_mom0) && !Path_file_is_readable(path_mom1) && !Path_file_is_readable(path_mom2), ERR_FILE_ACCESS,
 				"Moment maps already exist. Please delete the files\n"
@@ -555,10 +699,31 @@ int main(int argc, char **argv)
 	// Set up flagging region if required
 	Array_siz *flag_regions = use_flagging ? Array_siz_new_str(Parameter_get_str(par, "flag.region")) : Array_siz_new(0);
 	
+	// Restore processed data cube and source finding mask from checkpoint if possible
+	const uint64_t checkpoint_id = use_checkpoint ? checkpoint_key(par) : 0;
+	BitMask  *maskBits = NULL;
+	DataCube *dataCube = NULL;
+	
+	if(use_checkpoint)
+	{
+		status("Restoring checkpoint");
+		Profiler_start(profiler, "restore_checkpoint", 0);
+		dataCube = checkpoint_load(path_chk_cube, path_chk_mask, checkpoint_id, &flag_regions, &use_flagging, &maskBits, verbosity);
+		if(dataCube != NULL) message("Skipping preprocessing and source finding.");
+		if(dataCube != NULL && use_noise_scaling && write_noise) warning("Noise cube/spectrum will not be written when restoring from checkpoint.");
+	}
+	
+	const bool restored = (dataCube != NULL);
+	
 	// Load data cube
-	status("Loading data cube");
-	DataCube *dataCube = DataCube_new(verbosity);
-	DataCube_load(dataCube, Path_get(path_data_in), region);
+	if(!restored)
+	{
+		status("Loading data cube");
+		Profiler_start(profiler, "load", 0);
+		dataCube = DataCube_new(verbosity);
+		DataCube_load(dataCube, Path_get(path_data_in), region);
+		if(use_single) DataCube_convert_single(dataCube);
+	}
 	
 	// Check for CELLSCAL = '1/F' setting
 	if(DataCube_cmphd(dataCube, "CELLSCAL", "1/F", 3))
@@ -581,16 +746,21 @@ int main(int argc, char **argv)
 	
 	// Search for values of infinity and append affected pixels to flagging region
 	// (Yes, some data cubes do contain those!)
-	if(DataCube_flag_infinity(dataCube, flag_regions)) use_flagging = true;
+	if(!restored && DataCube_flag_infinity(dataCube, flag_regions)) use_flagging = true;
 	
 	// Apply flags if required
-	if(use_flagging) DataCube_flag_regions(dataCube, flag_regions);
+	if(!restored && use_flagging) DataCube_flag_regions(dataCube, flag_regions);
 	
 	// Invert cube if requested
-	if(use_invert)
+	// NOTE: Unless a copy of the original data is kept or the flagging catalogue
+	//       is applied in between, inversion is deferred to the same pass as the
+	//       application of the noise and weights cubes further down.
+	const bool defer_invert = use_invert && !keep_data && !use_flagging_cat;
+	
+	if(!restored && use_invert)
 	{
 		message("Inverting data cube");
-		DataCube_multiply_const(dataCube, -1.0);
+		if(!defer_invert) DataCube_multiply_const(dataCube, -1.0);
 	}
 	
 	// Print time
@@ -602,9 +772,10 @@ int main(int argc, char **argv)
 	// Apply flagging catalogue     //
 	// ---------------------------- //
 	
-	if(use_flagging_cat)
+	if(!restored && use_flagging_cat)
 	{
 		status("Loading and applying flagging catalogue");
+		Profiler_start(profiler, "flag_catalog", DataCube_get_size(dataCube));
 		message("Catalogue file:   %s", Parameter_get_str(par, "flag.catalog"));
 		message("Flagging radius:  %ld", Parameter_get_int(par, "flag.radius"));
 		DataCube_continuum_flagging(dataCube, Parameter_get_str(par, "flag.catalog"), 1, Parameter_get_int(par, "flag.radius"));
@@ -616,45 +787,58 @@ int main(int argc, char **argv)
 	
 	
 	// ---------------------------- //
-	// Load and apply noise cube    //
+	// Keep copy of original data   //
 	// ---------------------------- //
 	
-	if(use_noise)
+	// NOTE: The copy will replace the reload of the data cube prior to
+	//       parameterisation, trading memory for a second pass over disk.
+	DataCube *dataCubeOrig = NULL;
+	
+	if(!restored && keep_data)
 	{
-		status("Loading and applying noise cube");
-		DataCube *noiseCube = DataCube_new(verbosity);
-		DataCube_load(noiseCube, Path_get(path_noise_in), region);
-		
-		// Divide data by noise cube
-		DataCube_divide(dataCube, noiseCube);
-		
-		// Delete noise cube again
-		DataCube_delete(noiseCube);
-		
-		// Print time
-		timestamp(start_time, start_clock);
+		message("Keeping copy of original data cube for parameterisation (%.1f MB).", (double)(DataCube_get_size(dataCube) * labs(DataCube_gethd_int(dataCube, "BITPIX")) / 8) / MEGABYTE);
+		dataCubeOrig = DataCube_copy(dataCube);
 	}
 	
 	
 	
 	// ---------------------------- //
-	// Load and apply weights cube  //
+	// Load and apply noise and     //
+	// weights cubes                //
 	// ---------------------------- //
 	
-	if(use_weights)
+	if(!restored && (use_noise || use_weights || defer_invert))
 	{
-		status("Loading and applying weights cube");
-		DataCube *weightsCube = DataCube_new(verbosity);
-		DataCube_load(weightsCube, Path_get(path_weights_in), region);
+		DataCube *noiseCube   = NULL;
+		DataCube *weightsCube = NULL;
+		
+		if(use_noise && use_weights) status("Loading and applying noise and weights cubes");
+		else if(use_noise) status("Loading and applying noise cube");
+		else if(use_weights) status("Loading and applying weights cube");
+		Profiler_start(profiler, "noise_weights", DataCube_get_size(dataCube));
+		
+		if(use_noise)
+		{
+			noiseCube = DataCube_new(verbosity);
+			DataCube_map(noiseCube, Path_get(path_noise_in), region);
+		}
+		
+		if(use_weights)
+		{
+			weightsCube = DataCube_new(verbosity);
+			DataCube_map(weightsCube, Path_get(path_weights_in), region);
+		}
 		
-		// Multiply data by square root of weights cube
-		DataCube_apply_weights(dataCube, weightsCube);
+		// Invert data, divide by noise cube and multiply by square
+		// root of weights cube in a single pass over the data
+		DataCube_preprocess(dataCube, noiseCube, weightsCube, defer_invert);
 		
-		// Delete weights cube again
+		// Delete noise and weights cubes again
+		DataCube_delete(noiseCube);
 		DataCube_delete(weightsCube);
 		
 		// Print time
-		timestamp(start_time, start_clock);
+		if(use_noise || use_weights) timestamp(start_time, start_clock);
 	}
 	
 	
@@ -663,9 +847,10 @@ int main(int argc, char **argv)
 	// Continuum subtraction        //
 	// ---------------------------- //
 	
-	if(use_cont_sub)
+	if(!restored && use_cont_sub)
 	{
 		status("Continuum subtraction");
+		Profiler_start(profiler, "contsub", DataCube_get_size(dataCube));
 		message("Subtracting residual continuum emission.");
 		message("- Polynomial order:  %ld",   Parameter_get_int(par, "contsub.order"));
 		message("- Clip threshold:    %.1f",  Parameter_get_flt(par, "contsub.threshold"));
@@ -684,9 +869,10 @@ int main(int argc, char **argv)
 	// Scale data by noise level    //
 	// ---------------------------- //
 	
-	if(use_noise_scaling)
+	if(!restored && use_noise_scaling)
 	{
 		status("Scaling data by noise");
+		Profiler_start(profiler, "scale_noise", DataCube_get_size(dataCube));
 		
 		if(use_local_scaling)
 		{
@@ -750,9 +936,10 @@ int main(int argc, char **argv)
 	// Automatic data flagging      //
 	// ---------------------------- //
 	
-	if(autoflag_mode)
+	if(!restored && autoflag_mode)
 	{
 		status("Auto-flagging");
+		Profiler_start(profiler, "autoflag", DataCube_get_size(dataCube));
 		
 		// Set up auto-flagging if requested
 		Array_siz *autoflag_regions = Array_siz_new(0);
@@ -834,9 +1021,10 @@ int main(int argc, char **argv)
 	// Ripple filter                //
 	// ---------------------------- //
 	
-	if(use_ripple_filter)
+	if(!restored && use_ripple_filter)
 	{
 		status("Applying ripple filter");
+		Profiler_start(profiler, "ripple_filter", DataCube_get_size(dataCube));
 		
 		// Ripple filter
 		message("Subtracting offset from data.");
@@ -868,6 +1056,7 @@ int main(int argc, char **argv)
 	if(write_filtered)  // UPDATE 24/10/2022: Condition changed to always write filtered cube if requested!
 	{
 		status("Writing filtered cube");
+		Profiler_start(profiler, "write_filtered", DataCube_get_size(dataCube));
 		DataCube_add_history(dataCube, par);
 		DataCube_save(dataCube, Path_get(path_filtered), overwrite, PRESERVE);
 		
@@ -889,12 +1078,13 @@ int main(int argc, char **argv)
 	//       traction, might alter the noise level.
 	
 	status("Measuring global noise level");
+	Profiler_start(profiler, "global_noise", DataCube_get_size(dataCube));
 	
 	size_t cadence = DataCube_get_size(dataCube) / NOISE_SAMPLE_SIZE;          // Stride for noise calculation
 	if(cadence < 2) cadence = 1;
 	else if(cadence % DataCube_get_axis_size(dataCube, 0) == 0) cadence -= 1;  // Ensure stride is not equal to multiple of x-axis size
 	
-	global_rms = MAD_TO_STD * DataCube_stat_mad(dataCube, 0.0, cadence, -1);
+	global_rms = MAD_TO_STD * DataCube_stat_mad(dataCube, 0.0, cadence, -1, Parameter_get_flt(par, "pipeline.madTolerance"));
 	message("Global RMS:  %.3e  (using stride of %zu)", global_rms, cadence);
 	
 	// Print time
@@ -909,22 +1099,40 @@ int main(int argc, char **argv)
 	// Terminate if no source finder is to be run, but no input mask is provided either
 	ensure(use_scfind || use_threshold || use_mask, ERR_USER_INPUT, "No mask provided and no source finder selected. Cannot proceed.");
 	
-	// Create temporary 8-bit mask to hold source finding output
-	DataCube *maskCubeTmp = DataCube_blank(DataCube_get_axis_size(dataCube, 0), DataCube_get_axis_size(dataCube, 1), DataCube_get_axis_size(dataCube, 2), 8, verbosity);
-	DataCube_copy_wcs(dataCube, maskCubeTmp);
-	DataCube_puthd_str(maskCubeTmp, "BUNIT", " ");
+	// Create temporary bit mask to hold source finding output
+	if(!restored) maskBits = BitMask_new(DataCube_get_size(dataCube));
 	
 	// S+C finder
-	if(use_scfind)
+	if(!restored && use_scfind)
 	{
+		      bool use_sc_device = strcmp(Parameter_get_str(par, "pipeline.device"), "gpu") == 0;
+		const bool use_sc_fused  = Parameter_get_bool(par, "scfind.fused");
+		ensure(use_sc_device || strcmp(Parameter_get_str(par, "pipeline.device"), "cpu") == 0, ERR_USER_INPUT, "Invalid device: \'%s\'. Must be \'cpu\' or \'gpu\'.", Parameter_get_str(par, "pipeline.device"));
+		ensure(Parameter_get_int(par, "scfind.workingSet") >= 0, ERR_USER_INPUT, "Working set of S+C finder must not be negative.");
+		
+		// Device offloading requires single-precision data and does not support noise scaling of smoothed data
+		if(use_sc_device && DataCube_gethd_int(dataCube, "BITPIX") != -32)
+		{
+			warning("Device offloading of the S+C finder requires 32-bit floating-point data.\n         Reverting to S+C finder on CPU.");
+			use_sc_device = false;
+		}
+		if(use_sc_device && use_noise_scaling && use_sc_scaling)
+		{
+			warning("Noise scaling within the S+C finder is not supported on device.\n         Reverting to S+C finder on CPU.");
+			use_sc_device = false;
+		}
+		if(use_sc_device && use_sc_fused) warning("Fused mode is not supported on device and will be ignored.");
+		
 		status("Running S+C finder");
+		Profiler_start(profiler, "scfind", DataCube_get_size(dataCube));
 		message("Using the following parameters:");
 		message("- Kernels");
 		message("  - spatial:        %s", Parameter_get_str(par, "scfind.kernelsXY"));
 		message("  - spectral:       %s", Parameter_get_str(par, "scfind.kernelsZ"));
 		message("- Flux threshold:   %s * rms", Parameter_get_str(par, "scfind.threshold"));
 		message("- Noise statistic:  %s", noise_stat_name[sc_statistic]);
-		message("- Flux range:       %s\n", flux_range_name[sc_range + 1]);
+		message("- Flux range:       %s", flux_range_name[sc_range + 1]);
+		message("- Mode:             %s\n", use_sc_device ? "device" : (use_sc_fused ? "fused" : "standard"));
 		
 		// Extract and sort kernel sizes to ensure that smallest kernel comes first
 		Array_dbl *kernels_spat = Array_dbl_new_str(Parameter_get_str(par, "scfind.kernelsXY"));
@@ -949,16 +1157,49 @@ int main(int argc, char **argv)
 		if(Array_dbl_get(kernels_spat, 0) > 0.0) warning("Including spatial kernel size of 0 is strongly advised.");
 		if(Array_siz_get(kernels_spec, 0) > 0) warning("Including spectral kernel size of 0 is strongly advised.");
 		
+		// Fused mode does not support noise scaling of smoothed data
+		if(!use_sc_device && use_sc_fused && use_noise_scaling && use_sc_scaling) warning("Noise scaling within the S+C finder is not supported in fused mode.\n         Reverting to standard S+C finder.");
+		
 		// Run S+C finder to obtain mask
-		DataCube_run_scfind(
+		if(use_sc_device) DataCube_run_scfind_device(
+			dataCube,
+			maskBits,
+			kernels_spat,
+			kernels_spec,
+			Parameter_get_flt(par, "scfind.threshold"),
+			Parameter_get_flt(par, "scfind.replacement"),
+			sc_statistic,
+			sc_range,
+			Parameter_get_flt(par, "pipeline.madTolerance"),
+			profiler,
+			start_time,
+			start_clock
+		);
+		else if(use_sc_fused && !(use_noise_scaling && use_sc_scaling)) DataCube_run_scfind_fused(
+			dataCube,
+			maskBits,
+			kernels_spat,
+			kernels_spec,
+			Parameter_get_flt(par, "scfind.threshold"),
+			Parameter_get_flt(par, "scfind.replacement"),
+			sc_statistic,
+			sc_range,
+			Parameter_get_flt(par, "pipeline.madTolerance"),
+			Parameter_get_int(par, "scfind.workingSet") * MEGABYTE,
+			profiler,
+			start_time,
+			start_clock
+		);
+		else DataCube_run_scfind(
 			dataCube,
-			maskCubeTmp,
+			maskBits,
 			kernels_spat,
 			kernels_spec,
 			Parameter_get_flt(par, "scfind.threshold"),
 			Parameter_get_flt(par, "scfind.replacement"),
 			sc_statistic,
 			sc_range,
+			Parameter_get_flt(par, "pipeline.madTolerance"),
 			(use_noise_scaling && use_sc_scaling) ? (strcmp(Parameter_get_str(par, "scaleNoise.mode"), "local") == 0 ? 2 : 1) : 0,
 			sn_statistic,
 			sn_range,
@@ -967,6 +1208,7 @@ int main(int argc, char **argv)
 			Parameter_get_int(par, "scaleNoise.gridXY"),
 			Parameter_get_int(par, "scaleNoise.gridZ"),
 			Parameter_get_bool(par, "scaleNoise.interpolate"),
+			profiler,
 			start_time,
 			start_clock
 		);
@@ -976,16 +1218,17 @@ int main(int argc, char **argv)
 		Array_siz_delete(kernels_spec);
 		
 		// Apply flags to mask cube
-		if(use_flagging) DataCube_flag_regions(maskCubeTmp, flag_regions);
+		if(use_flagging) DataCube_flag_regions_bits(dataCube, maskBits, flag_regions);
 	}
 	
 	// Threshold finder
-	if(use_threshold)
+	if(!restored && use_threshold)
 	{
 		// Determine mode
 		const bool absolute = (strcmp(Parameter_get_str(par, "threshold.mode"), "absolute") == 0);
 		
 		status("Running threshold finder");
+		Profiler_start(profiler, "threshold", DataCube_get_size(dataCube));
 		message("Using the following parameters:");
 		message("- Mode:             %s", absolute ? "absolute" : "relative");
 		message("- Flux threshold:   %s%s", Parameter_get_str(par, "threshold.threshold"), absolute ? "" : " * rms");
@@ -998,15 +1241,32 @@ int main(int argc, char **argv)
 		// Run threshold finder
 		DataCube_run_threshold(
 			dataCube,
-			maskCubeTmp,
+			maskBits,
 			absolute,
 			Parameter_get_flt(par, "threshold.threshold"),
 			tf_statistic,
-			tf_range
+			tf_range,
+			Parameter_get_flt(par, "pipeline.madTolerance")
 		);
 		
 		// Apply flags to mask cube
-		if(use_flagging) DataCube_flag_regions(maskCubeTmp, flag_regions);
+		if(use_flagging) DataCube_flag_regions_bits(dataCube, maskBits, flag_regions);
+		
+		// Print time
+		timestamp(start_time, start_clock);
+	}
+	
+	
+	
+	// ---------------------------- //
+	// Write checkpoint             //
+	// ---------------------------- //
+	
+	if(use_checkpoint && !restored)
+	{
+		status("Writing checkpoint");
+		Profiler_start(profiler, "write_checkpoint", DataCube_get_size(dataCube));
+		checkpoint_save(path_chk_cube, path_chk_mask, checkpoint_id, dataCube, maskBits, flag_regions, use_flagging);
 		
 		// Print time
 		timestamp(start_time, start_clock);
@@ -1024,6 +1284,7 @@ int main(int argc, char **argv)
 	{
 		// Load mask cube
 		status("Loading mask cube");
+		Profiler_start(profiler, "load_mask", DataCube_get_size(dataCube));
 		DataCube *inputMaskCube = DataCube_new(verbosity);
 		DataCube_load(inputMaskCube, Path_get(path_mask_in), region);
 		
@@ -1081,6 +1342,7 @@ int main(int argc, char **argv)
 	{
 		// Else create an empty mask cube
 		status("Creating source mask cube");
+		Profiler_start(profiler, "create_mask", DataCube_get_size(dataCube));
 		maskCube = DataCube_blank(DataCube_get_axis_size(dataCube, 0), DataCube_get_axis_size(dataCube, 1), DataCube_get_axis_size(dataCube, 2), 32, verbosity);
 		
 		// Copy WCS header elements from data cube to mask cube
@@ -1097,7 +1359,7 @@ int main(int argc, char **argv)
 	// ---------------------------- //
 	
 	// Copy SF mask prior to linking
-	const size_t n_pix_det = DataCube_copy_mask_32(maskCube, maskCubeTmp, -1);
+	const size_t n_pix_det = DataCube_copy_bitmask(maskCube, maskBits, -1);
 	message("%zu pixels detected by source finder (%.3f%%).", n_pix_det, 100.0 * (double)(n_pix_det) / (double)(DataCube_get_size(maskCube)));
 	
 	// Print time
@@ -1112,15 +1374,21 @@ int main(int argc, char **argv)
 	if(write_rawmask)
 	{
 		status("Writing raw binary mask");
-		DataCube_add_history(maskCubeTmp, par);
-		DataCube_save(maskCubeTmp, Path_get(path_mask_raw), overwrite, DESTROY);
+		Profiler_start(profiler, "write_rawmask", DataCube_get_size(dataCube));
+		DataCube *maskCubeRaw = DataCube_blank(DataCube_get_axis_size(dataCube, 0), DataCube_get_axis_size(dataCube, 1), DataCube_get_axis_size(dataCube, 2), 8, verbosity);
+		DataCube_copy_wcs(dataCube, maskCubeRaw);
+		DataCube_puthd_str(maskCubeRaw, "BUNIT", " ");
+		DataCube_copy_bitmask(maskCubeRaw, maskBits, 1);
+		DataCube_add_history(maskCubeRaw, par);
+		DataCube_save(maskCubeRaw, Path_get(path_mask_raw), overwrite, DESTROY);
+		DataCube_delete(maskCubeRaw);
 		
 		// Print time
 		timestamp(start_time, start_clock);
 	}
 	
 	// Delete temporary SF mask again
-	DataCube_delete(maskCubeTmp);
+	BitMask_delete(maskBits);
 	
 	
 	
@@ -1131,6 +1399,7 @@ int main(int argc, char **argv)
 	ensure(use_linker, ERR_NO_SRC_FOUND, "Terminating pipeline, as linker is disabled.\n       No source catalogue has been created.");
 	
 	status("Running Linker");
+	Profiler_start(profiler, "linker", DataCube_get_size(dataCube));
 	
 	const bool remove_neg_src = !use_reliability && !keep_negative;  // ALERT: Add conditions here as needed.
 	
@@ -1152,14 +1421,15 @@ int main(int argc, char **argv)
 		Parameter_get_flt(par, "linker.maxFill"),
 		linker_pos_pix,
 		remove_neg_src,
-		global_rms
+		global_rms,
+		Parameter_get_bool(par, "linker.parallel")
 	);
 	
 	// Print time
 	timestamp(start_time, start_clock);
 	
 	// Terminate pipeline if no sources left after linking
-	ensure(LinkerPar_get_size(lpar), ERR_NO_SRC_FOUND, "No sources left after linking. Terminating pipeline.");
+	ensure(allow_empty || LinkerPar_get_size(lpar), ERR_NO_SRC_FOUND, "No sources left after linking. Terminating pipeline.");
 	
 	
 	
@@ -1169,9 +1439,10 @@ int main(int argc, char **argv)
 	
 	Map *rel_filter = Map_new();  // Empty container for storing old and new labels of reliable sources
 	
-	if(use_reliability)
+	if(use_reliability && LinkerPar_get_size(lpar))
 	{
 		status("Measuring reliability");
+		Profiler_start(profiler, "reliability", DataCube_get_size(dataCube));
 		
 		// Extract parameter space and dimensionality
 		Array_siz *rel_par_space = Array_siz_new(0);
@@ -1219,15 +1490,30 @@ int main(int argc, char **argv)
 				
 				if(wcs != NULL)
 				{
-					// Loop over all rows and convert WCS to pixels
-					for(size_t row = 0; row < Table_rows(rel_cat); ++row)
+					// Convert all rows from WCS to pixels in one go
+					const size_t n_rows = Table_rows(rel_cat);
+					double *coord_world = (double *)memory(CALLOC, 3 * n_rows, sizeof(double));
+					double *coord_pixel = (double *)memory(MALLOC, 3 * n_rows, sizeof(double));
+					
+					for(size_t row = 0; row < n_rows; ++row)
+					{
+						coord_world[3 * row]     = Table_get(rel_cat, row, 0);
+						coord_world[3 * row + 1] = Table_get(rel_cat, row, 1);
+						coord_pixel[3 * row]     = -1e+30;
+						coord_pixel[3 * row + 1] = -1e+30;
+						coord_pixel[3 * row + 2] = 0.0;
+					}
+					
+					WCS_convertToPixel_batch(wcs, coord_world, coord_pixel, n_rows);
+					
+					for(size_t row = 0; row < n_rows; ++row)
 					{
-						double lon = -1e+30;
-						double lat = -1e+30;
-						WCS_convertToPixel(wcs, Table_get(rel_cat, row, 0), Table_get(rel_cat, row, 1), 0.0, &lon, &lat, NULL);
-						Table_set(rel_cat, row, 0, lon);
-						Table_set(rel_cat, row, 1, lat);
+						Table_set(rel_cat, row, 0, coord_pixel[3 * row]);
+						Table_set(rel_cat, row, 1, coord_pixel[3 * row + 1]);
 					}
+					
+					free(coord_world);
+					free(coord_pixel);
 				}
 				else
 				{
@@ -1252,9 +1538,10 @@ int main(int argc, char **argv)
 		const double rel_fmin = rel_snr_min * sqrt_beam_area;
 		
 		// Calculate reliability values
+		ensure(Parameter_get_int(par, "reliability.cacheLimit") >= 0, ERR_USER_INPUT, "Reliability cache limit must not be negative.");
 		double scale_kernel = Parameter_get_flt(par, "reliability.scaleKernel");
 		Array_dbl *skellam = NULL;
-		Matrix *covar = LinkerPar_reliability(lpar, rel_par_space, &scale_kernel, rel_fmin, rel_min_pix, rel_cat, use_rel_plot || scale_kernel == 0 ? &skellam : NULL, Parameter_get_bool(par, "reliability.autoKernel"), Parameter_get_int(par, "reliability.iterations"), Parameter_get_flt(par, "reliability.tolerance"));
+		Matrix *covar = LinkerPar_reliability(lpar, rel_par_space, &scale_kernel, rel_fmin, rel_min_pix, rel_cat, use_rel_plot || scale_kernel == 0 ? &skellam : NULL, Parameter_get_bool(par, "reliability.autoKernel"), Parameter_get_int(par, "reliability.iterations"), Parameter_get_flt(par, "reliability.tolerance"), Parameter_get_flt(par, "reliability.kdeTolerance"), (size_t)(Parameter_get_int(par, "reliability.cacheLimit")) * MEGABYTE);
 		
 		// Create plots if requested
 		if(use_rel_plot)
@@ -1271,6 +1558,7 @@ int main(int argc, char **argv)
 		
 		// Set up relabelling filter by recording old and new label pairs of reliable sources
 		size_t new_label = 1;
+		Map_reserve(rel_filter, LinkerPar_get_size(lpar));
 		
 		for(size_t i = 0; i < LinkerPar_get_size(lpar); ++i)
 		{
@@ -1281,8 +1569,8 @@ int main(int argc, char **argv)
 		}
 		
 		// Check if any reliable sources left
-		ensure(Map_get_size(rel_filter), ERR_NO_SRC_FOUND, "No reliable sources found. Terminating pipeline.");
-		message("%zu reliable %s found.", Map_get_size(rel_filter), Map_get_size(rel_filter) > 1 ? "sources" : "source");
+		ensure(allow_empty || Map_get_size(rel_filter), ERR_NO_SRC_FOUND, "No reliable sources found. Terminating pipeline.");
+		message("%zu reliable %s found.", Map_get_size(rel_filter), Map_get_size(rel_filter) == 1 ? "source" : "sources");
 		
 		// Apply filter to mask cube, so unreliable sources are removed
 		// and reliable ones relabelled in consecutive order
@@ -1299,6 +1587,7 @@ int main(int argc, char **argv)
 	// ---------------------------- //
 	
 	status("Creating initial catalogue");
+	Profiler_start(profiler, "catalogue", DataCube_get_size(dataCube));
 	
 	// Extract flux unit from header
 	String *unit_flux = String_trim(DataCube_gethd_string(dataCube, "BUNIT"));
@@ -1309,7 +1598,8 @@ int main(int argc, char **argv)
 	}
 	
 	// Generate catalogue of reliable sources from linker output
-	Catalog *catalog = LinkerPar_make_catalog(lpar, rel_filter, String_get(unit_flux));
+	// (an empty filter would retain all sources, hence the special case of empty tiles)
+	Catalog *catalog = (use_reliability && !Map_get_size(rel_filter)) ? Catalog_new() : LinkerPar_make_catalog(lpar, rel_filter, String_get(unit_flux));
 	message("Initial source catalogue created.");
 	
 	// Create and save reliability parameter catalogues if requested
@@ -1336,7 +1626,7 @@ int main(int argc, char **argv)
 	String_delete(unit_flux);
 	
 	// Terminate if catalogue is empty
-	ensure(Catalog_get_size(catalog), ERR_NO_SRC_FOUND, "No reliable sources found. Terminating pipeline.");
+	ensure(allow_empty || Catalog_get_size(catalog), ERR_NO_SRC_FOUND, "No reliable sources found. Terminating pipeline.");
 	
 	// Print time
 	timestamp(start_time, start_clock);
@@ -1349,9 +1639,10 @@ int main(int argc, char **argv)
 	// NOTE: It is not yet clear if mask dilation should happen in the noise-normalised data cube
 	//       or the original data cube. Some more though will need to go into this...
 	
-	if(use_mask_dilation)
+	if(use_mask_dilation && Catalog_get_size(catalog))
 	{
 		status("Mask dilation");
+		Profiler_start(profiler, "dilation", DataCube_get_size(dataCube));
 		
 		message("Spectral dilation");
 		DataCube_dilate_mask_z(dataCube, maskCube, catalog, Parameter_get_int(par, "dilation.iterationsZ"), Parameter_get_flt(par, "dilation.threshold"));
@@ -1368,37 +1659,56 @@ int main(int argc, char **argv)
 	// Reload data cube if required //
 	// ---------------------------- //
 	
-	if(use_noise || use_weights || use_noise_scaling)  // ALERT: Add conditions here as needed.
+	if(use_reload && Catalog_get_size(catalog))
 	{
 		// NOTE: Continuum subtraction and ripple filter will not trigger a reload, but they
 		//       won't get reapplied either should the cube be reloaded. While flagging does
 		//       not trigger a reload either, all flags (including from auto-flagging) will be
 		//       reapplied.
-		status("Reloading data cube for parameterisation");
-		DataCube_load(dataCube, Path_get(path_data_in), region);
-		
-		// Apply flags if required
-		if(use_flagging) DataCube_flag_regions(dataCube, flag_regions);
-		
-		// Apply flagging catalogue if required
-		if(use_flagging_cat) DataCube_continuum_flagging(dataCube, Parameter_get_str(par, "flag.catalog"), 1, Parameter_get_int(par, "flag.radius"));
-		
-		// Invert cube if requested
-		if(use_invert)
+		if(keep_data && dataCubeOrig != NULL)
+		{
+			// Swap in copy of original data cube, which already had
+			// the flagging catalogue and inversion applied
+			status("Restoring data cube for parameterisation");
+			Profiler_start(profiler, "restore", DataCube_get_size(dataCube));
+			DataCube_delete(dataCube);
+			dataCube = dataCubeOrig;
+			dataCubeOrig = NULL;
+			
+			// Apply flags if required (including those from auto-flagging)
+			if(use_flagging) DataCube_flag_regions(dataCube, flag_regions);
+		}
+		else
 		{
-			message("Inverting data cube");
-			DataCube_multiply_const(dataCube, -1.0);
+			status("Reloading data cube for parameterisation");
+			Profiler_start(profiler, "reload", DataCube_get_size(dataCube));
+			DataCube_load(dataCube, Path_get(path_data_in), region);
+			if(use_single) DataCube_convert_single(dataCube);
+			
+			// Apply flags if required
+			if(use_flagging) DataCube_flag_regions(dataCube, flag_regions);
+			
+			// Apply flagging catalogue if required
+			if(use_flagging_cat) DataCube_continuum_flagging(dataCube, Parameter_get_str(par, "flag.catalog"), 1, Parameter_get_int(par, "flag.radius"));
+			
+			// Invert cube if requested; deferred to the gain cube pass if possible
+			if(use_invert)
+			{
+				message("Inverting data cube");
+				if(!use_gain) DataCube_multiply_const(dataCube, -1.0);
+			}
 		}
 		
 		// Apply gain cube if provided
 		if(use_gain)
 		{
 			status("Loading and applying gain cube");
+			Profiler_start(profiler, "gain", DataCube_get_size(dataCube));
 			DataCube *gainCube = DataCube_new(verbosity);
-			DataCube_load(gainCube, Path_get(path_gain_in), region);
+			DataCube_map(gainCube, Path_get(path_gain_in), region);
 			
-			// Divide by gain cube
-			DataCube_divide(dataCube, gainCube);
+			// Invert data if requested and divide by gain cube
+			DataCube_preprocess(dataCube, gainCube, NULL, use_invert && !keep_data);
 			
 			// Delete gain cube again
 			DataCube_delete(gainCube);
@@ -1410,14 +1720,26 @@ int main(int argc, char **argv)
 	
 	
 	
+	// ---------------------------- //
+	// Create list of source voxels //
+	// ---------------------------- //
+	
+	// NOTE: This must happen after mask dilation, as the voxel list
+	//       would otherwise not contain the dilated pixels.
+	VoxelList *voxelList = NULL;
+	if((use_parameteriser || write_cubelets) && Catalog_get_size(catalog)) voxelList = DataCube_get_voxel_list(maskCube);
+	
+	
+	
 	// ---------------------------- //
 	// Parameterise sources         //
 	// ---------------------------- //
 	
-	if(use_parameteriser)
+	if(use_parameteriser && Catalog_get_size(catalog))
 	{
 		status("Measuring source parameters");
-		DataCube_parameterise(dataCube, maskCube, catalog, use_wcs, use_physical, Parameter_get_str(par, "parameter.prefix"));
+		Profiler_start(profiler, "parameterise", DataCube_get_size(dataCube));
+		DataCube_parameterise(dataCube, maskCube, voxelList, catalog, use_wcs, use_physical, Parameter_get_str(par, "parameter.prefix"));
 		
 		// Print time
 		timestamp(start_time, start_clock);
@@ -1429,13 +1751,15 @@ int main(int argc, char **argv)
 	// Create and save cubelets     //
 	// ---------------------------- //
 	
-	if(write_cubelets)
+	if(write_cubelets && Catalog_get_size(catalog))
 	{
 		status("Creating cubelets");
+		Profiler_start(profiler, "cubelets", DataCube_get_size(dataCube));
 		message("Flux threshold (moment 1 and 2): %.2e", thresh_mom);
 		DataCube_create_cubelets(
 			dataCube,
 			maskCube,
+			voxelList,
 			catalog,
 			Path_get(path_cubelets),
 			overwrite,
@@ -1451,15 +1775,22 @@ int main(int argc, char **argv)
 		timestamp(start_time, start_clock);
 	}
 	
+	// Voxel list no longer needed
+	VoxelList_delete(voxelList);
+	
 	
 	
 	// ---------------------------- //
 	// Create and save moment maps  //
 	// ---------------------------- //
 	
+	// Projected 2-D mask, if created alongside the moment maps
+	DataCube *maskImage = NULL;
+	
 	if(write_moments)
 	{
 		status("Creating moment maps");
+		Profiler_start(profiler, "moments", DataCube_get_size(dataCube));
 		
 		// Generate moment maps
 		DataCube *mom0 = NULL;
@@ -1467,7 +1798,7 @@ int main(int argc, char **argv)
 		DataCube *mom2 = NULL;
 		DataCube *chan = NULL;
 		DataCube *snr  = NULL;
-		DataCube_create_moments(dataCube, maskCube, &mom0, &mom1, &mom2, &chan, &snr, NULL, use_wcs, 0.0, 0.0);
+		DataCube_create_moments(dataCube, maskCube, &mom0, &mom1, &mom2, &chan, &snr, write_mask2d ? &maskImage : NULL, NULL, use_wcs, 0.0, 0.0);
 		// NOTE: snr will not actually be created or written, as this would not work in general
 		//       unless the noise was guaranteed to be constant across the entire data cube.
 		
@@ -1513,11 +1844,12 @@ int main(int argc, char **argv)
 	if(write_mask || write_mask2d)
 	{
 		status("Writing mask cube");
+		Profiler_start(profiler, "write_mask", DataCube_get_size(dataCube));
 		
 		// Create and save projected 2-D mask image
 		if(write_mask2d)
 		{
-			DataCube *maskImage = DataCube_2d_mask(maskCube);
+			if(maskImage == NULL) maskImage = DataCube_2d_mask(maskCube);
 			DataCube_add_history(maskImage, par);
 			DataCube_save(maskImage, Path_get(path_mask_2d), overwrite, DESTROY);
 			DataCube_delete(maskImage);
@@ -1540,9 +1872,10 @@ int main(int argc, char **argv)
 	// Save catalogue(s)            //
 	// ---------------------------- //
 	
-	if(write_ascii || write_xml || write_sql)
+	if(write_ascii || write_xml || write_sql || write_fits)
 	{
 		status("Writing source catalogue");
+		Profiler_start(profiler, "write_catalogue", DataCube_get_size(dataCube));
 		
 		// Correct x, y and z for subregion offset if requested
 		// WARNING: This will alter the original x, y and z positions!
@@ -1573,12 +1906,33 @@ int main(int argc, char **argv)
 			Catalog_save(catalog, Path_get(path_cat_sql), CATALOG_FORMAT_SQL, overwrite, NULL);
 		}
 		
+		if(write_fits)
+		{
+			message("Writing FITS file:    %s", Path_get_file(path_cat_fits));
+			Catalog_save(catalog, Path_get(path_cat_fits), CATALOG_FORMAT_FITS, overwrite, NULL);
+		}
+		
 		// Print time
 		timestamp(start_time, start_clock);
 	}
 	
 	
 	
+	// ---------------------------- //
+	// Save profiling report        //
+	// ---------------------------- //
+	
+	// NOTE: In tiled mode, the report covering all tiles is saved by run_tiled().
+	if(profiler != NULL && !tiled)
+	{
+		Profiler_stop(profiler);
+		status("Writing profiling report");
+		message("Writing JSON file:    %s", Path_get_file(path_profile));
+		Profiler_save(profiler, Path_get(path_profile), overwrite);
+	}
+	
+	
+	
 	// ---------------------------- //
 	// Clean up and exit            //
 	// ---------------------------- //
@@ -1586,6 +1940,7 @@ int main(int argc, char **argv)
 	// Delete data cube and mask cube
 	DataCube_delete(maskCube);
 	DataCube_delete(dataCube);
+	DataCube_delete(dataCubeOrig);
 	
 	// Delete sub-cube region
 	Array_siz_delete(region);
@@ -1593,9 +1948,6 @@ int main(int argc, char **argv)
 	// Delete flagging regions
 	Array_siz_delete(flag_regions);
 	
-	// Delete input parameters
-	Parameter_delete(par);
-	
 	// Delete input file paths
 	Path_delete(path_data_in);
 	Path_delete(path_gain_in);
@@ -1608,6 +1960,7 @@ int main(int argc, char **argv)
 	Path_delete(path_cat_ascii);
 	Path_delete(path_cat_xml);
 	Path_delete(path_cat_sql);
+	Path_delete(path_cat_fits);
 	Path_delete(path_mask_out);
 	Path_delete(path_mask_2d);
 	Path_delete(path_mask_raw);
@@ -1623,12 +1976,1453 @@ int main(int argc, char **argv)
 	Path_delete(path_skel_plot);
 	Path_delete(path_flag);
 	Path_delete(path_cubelets);
+	Path_delete(path_profile);
+	Path_delete(path_chk_cube);
+	Path_delete(path_chk_mask);
 	
-	// Delete source catalogue
-	Catalog_delete(catalog);
+	return catalog;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Run the pipeline in tiled mode. The data cube (or the sub-region  //
+// specified by input.region) is split into tiles of the requested   //
+// size that overlap by the specified margin. Tiles are loaded and   //
+// processed one after the other, so only a single tile needs to be  //
+// held in memory at any time. The catalogues of all tiles are then  //
+// merged by Catalog_merge_tiles(), which ensures that sources cros- //
+// sing tile boundaries are catalogued exactly once, even if they    //
+// are larger than the overlap and hence truncated by the edge of a  //
+// tile.                                                             //
+// In streaming mode, tiles are processed in order of increasing     //
+// channel number as soon as all of their planes have arrived in the //
+// input file, so only a window of channels needs to be available.   //
+// ----------------------------------------------------------------- //
+
+PRIVATE void run_tiled(Parameter *par, Profiler *profiler, const time_t start_time, const clock_t start_clock)
+{
+	// ---------------------------- //
+	// Extract tiling settings      //
+	// ---------------------------- //
 	
-	// Print status message
-	status("Pipeline finished.");
+	status("Setting up tiling");
 	
-	return ERR_SUCCESS;
-}
+	const bool verbosity      = Parameter_get_bool(par, "pipeline.verbose");
+	const bool use_region     = strlen(Parameter_get_str(par, "input.region")) ? true : false;
+	const bool use_pos_offset = Parameter_get_bool(par, "parameter.offset");
+	const bool write_ascii    = Parameter_get_bool(par, "output.writeCatASCII");
+	const bool write_xml      = Parameter_get_bool(par, "output.writeCatXML");
+	const bool write_sql      = Parameter_get_bool(par, "output.writeCatSQL");
+	const bool write_fits     = Parameter_get_bool(par, "output.writeCatFITS");
+	const bool overwrite      = Parameter_get_bool(par, "output.overwrite");
+	const bool use_stream     = Parameter_get_bool(par, "tiling.stream");
+	const long int timeout    = Parameter_get_int(par, "tiling.streamTimeout");
+	
+	ensure(Parameter_get_bool(par, "linker.enable"), ERR_USER_INPUT, "The linker must be enabled in tiled mode, as no source\n       catalogue would be created otherwise.");
+	ensure(Parameter_get_int(par, "tiling.sizeXY") >= 0 && Parameter_get_int(par, "tiling.sizeZ") >= 0, ERR_USER_INPUT, "Tile size must not be negative.");
+	ensure(Parameter_get_int(par, "tiling.overlapXY") >= 0 && Parameter_get_int(par, "tiling.overlapZ") >= 0, ERR_USER_INPUT, "Tile overlap must not be negative.");
+	ensure(!use_stream || timeout > 0, ERR_USER_INPUT, "Streaming timeout must be positive.");
+	
+	// Outputs that are only meaningful for the full cube will not be created in tiled mode
+	const char *tile_disabled[] = {"output.writeCatASCII", "output.writeCatXML", "output.writeCatSQL", "output.writeCatFITS", "output.writeNoise", "output.writeFiltered", "output.writeMask", "output.writeMask2d", "output.writeRawMask", "output.writeMoments", "output.writeCubelets", "reliability.plot", "reliability.debug", "flag.log", "pipeline.checkpoint"};
+	const size_t n_tile_disabled = sizeof(tile_disabled) / sizeof(tile_disabled[0]);
+	for(size_t i = 4; i < n_tile_disabled; ++i) if(Parameter_get_bool(par, tile_disabled[i])) warning("Setting \'%s\' will be ignored in tiled mode.", tile_disabled[i]);
+	if(strlen(Parameter_get_str(par, "pipeline.sweep"))) warning("Setting \'pipeline.sweep\' will be ignored in tiled mode.");
+	
+	
+	
+	// ---------------------------- //
+	// Set up tile grid             //
+	// ---------------------------- //
+	
+	// Read header to determine cube size
+	// NOTE: In streaming mode, the header must be complete before any channels arrive.
+	DataCube *dataCube = DataCube_new(verbosity);
+	DataCube_load_header(dataCube, Parameter_get_str(par, "input.data"));
+	
+	// Determine bounds of area to be processed
+	size_t bounds[6] = {0, DataCube_get_axis_size(dataCube, 0) - 1, 0, DataCube_get_axis_size(dataCube, 1) - 1, 0, DataCube_get_axis_size(dataCube, 2) - 1};
+	DataCube_delete(dataCube);
+	
+	if(use_region)
+	{
+		Array_siz *region = Array_siz_new_str(Parameter_get_str(par, "input.region"));
+		ensure(Array_siz_get_size(region) == 6, ERR_USER_INPUT, "Invalid region supplied; must contain 6 values.");
+		for(size_t i = 0; i < 6; i += 2)
+		{
+			if(Array_siz_get(region, i)     > bounds[i])     bounds[i]     = Array_siz_get(region, i);
+			if(Array_siz_get(region, i + 1) < bounds[i + 1]) bounds[i + 1] = Array_siz_get(region, i + 1);
+			ensure(bounds[i] <= bounds[i + 1], ERR_USER_INPUT, "Invalid data cube region requested.");
+		}
+		Array_siz_delete(region);
+	}
+	
+	// Determine tile size, overlap and number of tiles along each axis
+	size_t tile_size[3];
+	size_t overlap[3];
+	size_t n_tiles[3];
+	
+	for(size_t i = 0; i < 3; ++i)
+	{
+		const size_t extent = bounds[2 * i + 1] - bounds[2 * i] + 1;
+		tile_size[i] = Parameter_get_int(par, i < 2 ? "tiling.sizeXY" : "tiling.sizeZ");
+		overlap[i]   = Parameter_get_int(par, i < 2 ? "tiling.overlapXY" : "tiling.overlapZ");
+		if(tile_size[i] == 0 || tile_size[i] > extent) tile_size[i] = extent;
+		n_tiles[i] = (extent + tile_size[i] - 1) / tile_size[i];
+	}
+	
+	const size_t n_tiles_total = n_tiles[0] * n_tiles[1] * n_tiles[2];
+	
+	message("Region:     %zu-%zu, %zu-%zu, %zu-%zu", bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+	message("Tile size:  %zu x %zu x %zu", tile_size[0], tile_size[1], tile_size[2]);
+	message("Overlap:    %zu, %zu, %zu", overlap[0], overlap[1], overlap[2]);
+	message("Tiles:      %zu x %zu x %zu = %zu", n_tiles[0], n_tiles[1], n_tiles[2], n_tiles_total);
+	
+	if(use_stream)
+	{
+		// Spectral overlap must cover the largest spectral kernel and the merging radius
+		Array_siz *kernels_spec = Array_siz_new_str(Parameter_get_str(par, "scfind.kernelsZ"));
+		size_t window = 0;
+		for(size_t i = 0; i < Array_siz_get_size(kernels_spec); ++i) if(Array_siz_get(kernels_spec, i) / 2 > window) window = Array_siz_get(kernels_spec, i) / 2;
+		window += Parameter_get_int(par, "linker.radiusZ");
+		Array_siz_delete(kernels_spec);
+		
+		message("Streaming:  %zu channels per tile, %zu channels of overlap", tile_size[2], overlap[2]);
+		if(n_tiles[2] < 2) warning("Only a single spectral tile defined; processing will not start\n         before the entire cube has arrived. Please set \'tiling.sizeZ\'.");
+		if(overlap[2] < window) warning("Spectral overlap is smaller than the largest spectral kernel\n         radius plus the linker radius (%zu channels).", window);
+	}
+	
+	
+	
+	// ---------------------------- //
+	// Set up output catalogues     //
+	// ---------------------------- //
+	
+	const char *base_dir  = Parameter_get_str(par, "output.directory");
+	const char *base_name = Parameter_get_str(par, "output.filename");
+	
+	Path *path_data_in = Path_new();
+	Path_set(path_data_in, Parameter_get_str(par, "input.data"));
+	
+	// Choose appropriate output file and directory names depending on user input
+	String *output_file_name = String_new(strlen(base_name) ? base_name : Path_get_file(path_data_in));
+	String *output_dir_name  = String_new(strlen(base_dir) ? base_dir : (strlen(Path_get_dir(path_data_in)) ? Path_get_dir(path_data_in) : "."));
+	
+	// Ensure that output file name ends with .fits or similar
+	String *check_mime_type = String_new("");
+	String_to_lower(String_set_delim(check_mime_type, String_get(output_file_name), '.', false, false));
+	if(!String_compare(check_mime_type, "fits") && !String_compare(check_mime_type, "fit")) String_append(output_file_name, ".fits");
+	String_delete(check_mime_type);
+	
+	Path *path_cat_ascii = Path_new();
+	Path *path_cat_xml   = Path_new();
+	Path *path_cat_sql   = Path_new();
+	Path *path_cat_fits  = Path_new();
+	Path *path_profile   = Path_new();
+	Path_set_dir(path_cat_ascii, String_get(output_dir_name));
+	Path_set_dir(path_cat_xml,   String_get(output_dir_name));
+	Path_set_dir(path_cat_sql,   String_get(output_dir_name));
+	Path_set_dir(path_cat_fits,  String_get(output_dir_name));
+	Path_set_dir(path_profile,   String_get(output_dir_name));
+	Path_set_file_from_template(path_cat_ascii, String_get(output_file_name), "_cat", ".txt");
+	Path_set_file_from_template(path_cat_xml,   String_get(output_file_name), "_cat", ".xml");
+	Path_set_file_from_template(path_cat_sql,   String_get(output_file_name), "_cat", ".sql");
+	Path_set_file_from_template(path_cat_fits,  String_get(output_file_name), "_cat", ".fits");
+	Path_set_file_from_template(path_profile,   String_get(output_file_name), "_profile", ".json");
+	
+	String_delete(output_file_name);
+	String_delete(output_dir_name);
+	Path_delete(path_data_in);
+	
+	// Check overwrite conditions before processing any tiles
+	if(!overwrite)
+	{
+		if(write_ascii) {
+			ensure(!Path_file_is_readable(path_cat_ascii), ERR_FILE_ACCESS,
+				"ASCII catalogue file already exists. Please delete the file\n"
+				"       or set \'output.overwrite = true\'.");
+		}
+		if(write_xml) {
+			ensure(!Path_file_is_readable(path_cat_xml), ERR_FILE_ACCESS,
+				"XML catalogue file already exists. Please delete the file\n"
+				"       or set \'output.overwrite = true\'.");
+		}
+		if(write_sql) {
+			ensure(!Path_file_is_readable(path_cat_sql), ERR_FILE_ACCESS,
+				"SQL catalogue file already exists. Please delete the file\n"
+				"       or set \'output.overwrite = true\'.");
+		}
+		if(write_fits) {
+			ensure(!Path_file_is_readable(path_cat_fits), ERR_FILE_ACCESS,
+				"FITS catalogue file already exists. Please delete the file\n"
+				"       or set \'output.overwrite = true\'.");
+		}
+		if(profiler != NULL) {
+			ensure(!Path_file_is_readable(path_profile), ERR_FILE_ACCESS,
+				"Profiling report already exists. Please delete the file\n"
+				"       or set \'output.overwrite = true\'.");
+		}
+	}
+	
+	
+	
+	// ---------------------------- //
+	// Process individual tiles     //
+	// ---------------------------- //
+	
+	Catalog *catalog = Catalog_new();
+	Array_siz *source_tiles = Array_siz_new(0);  // Tile index of each retained source
+	String *tile_region = String_new("");
+	String *name = String_new("");
+	const char *prefix = Parameter_get_str(par, "parameter.prefix");
+	size_t tile_counter = 0;
+	
+	// Tiles are distributed across MPI processes in round-robin fashion
+	int mpi_rank, mpi_size;
+	mpi_get_rank(&mpi_rank, &mpi_size);
+	if(mpi_size > 1) message("Distributing tiles across %d MPI processes.", mpi_size);
+	
+	for(size_t iz = 0; iz < n_tiles[2]; ++iz)
+	{
+		// Last channel required by this row of tiles, including overlap
+		const size_t row_core_max = bounds[4] + (iz + 1) * tile_size[2] - 1 < bounds[5] ? bounds[4] + (iz + 1) * tile_size[2] - 1 : bounds[5];
+		const size_t row_tile_max = row_core_max + overlap[2] < bounds[5] ? row_core_max + overlap[2] : bounds[5];
+		
+		// Wait for channels to arrive in streaming mode
+		if(use_stream)
+		{
+			DataCube *dataCube_stream = DataCube_new(verbosity);
+			DataCube_wait_for_planes(dataCube_stream, Parameter_get_str(par, "input.data"), row_tile_max, (unsigned int)timeout);
+			DataCube_delete(dataCube_stream);
+		}
+		
+		for(size_t iy = 0; iy < n_tiles[1]; ++iy)
+		{
+			for(size_t ix = 0; ix < n_tiles[0]; ++ix)
+			{
+				const size_t index[3] = {ix, iy, iz};
+				const size_t tile_index = tile_counter++;
+				size_t core_min[3], core_max[3], tile_min[3], tile_max[3];
+				
+				// Skip tiles assigned to other processes
+				if(tile_index % (size_t)mpi_size != (size_t)mpi_rank) continue;
+				
+				// Determine core and full extent of tile including overlap
+				tile_extent(index, bounds, tile_size, overlap, core_min, core_max, tile_min, tile_max);
+				
+				status("Processing tile %zu of %zu", tile_index + 1, n_tiles_total);
+				message("Tile region:  %zu-%zu, %zu-%zu, %zu-%zu", tile_min[0], tile_max[0], tile_min[1], tile_max[1], tile_min[2], tile_max[2]);
+				message("Tile core:    %zu-%zu, %zu-%zu, %zu-%zu", core_min[0], core_max[0], core_min[1], core_max[1], core_min[2], core_max[2]);
+				
+				// Set up tile parameters
+				Parameter *par_tile = Parameter_copy(par);
+				String_set_int(tile_region, "%ld", tile_min[0]);
+				String_append_int(tile_region, ",%ld", tile_max[0]);
+				String_append_int(tile_region, ",%ld", tile_min[1]);
+				String_append_int(tile_region, ",%ld", tile_max[1]);
+				String_append_int(tile_region, ",%ld", tile_min[2]);
+				String_append_int(tile_region, ",%ld", tile_max[2]);
+				Parameter_set(par_tile, "input.region", String_get(tile_region));
+				Parameter_set(par_tile, "parameter.offset", "false");
+				for(size_t i = 0; i < n_tile_disabled; ++i) Parameter_set(par_tile, tile_disabled[i], "false");
+				
+				// Run pipeline on tile
+				Catalog *catalog_tile = run_pipeline(par_tile, true, true, NULL, profiler, start_time, start_clock);
+				Parameter_delete(par_tile);
+				
+				// Keep all sources for merging; duplicates are removed by Catalog_merge_tiles()
+				for(size_t i = 0; i < Catalog_get_size(catalog_tile); ++i)
+				{
+					const Source *src_tile = Catalog_get_source(catalog_tile, i);
+					
+					// Convert positions to global or region-relative pixel coordinates
+					Source *src = Source_copy(src_tile);
+					Source_offset_xyz(src,
+						tile_min[0] - (use_pos_offset ? 0 : bounds[0]),
+						tile_min[1] - (use_pos_offset ? 0 : bounds[2]),
+						tile_min[2] - (use_pos_offset ? 0 : bounds[4]));
+					
+					Catalog_add_source(catalog, src);
+					Array_siz_push(source_tiles, tile_index);
+				}
+				
+				message("%zu source%s found in tile.", Catalog_get_size(catalog_tile), Catalog_get_size(catalog_tile) == 1 ? "" : "s");
+				Catalog_delete(catalog_tile);
+			}
+		}
+		
+		// Sources detected up to the end of the current core are final
+		if(use_stream) message("Channels up to %zu finalised; %zu source candidate%s collected so far.\n", row_core_max, Catalog_get_size(catalog), Catalog_get_size(catalog) == 1 ? "" : "s");
+	}
+	
+	String_delete(tile_region);
+	
+	
+	
+	// ---------------------------- //
+	// Save merged catalogue(s)     //
+	// ---------------------------- //
+	
+	status("Merging tile catalogues");
+	Profiler_start(profiler, "merge_tiles", 0);
+	
+	// Collect sources from all processes on first process
+	catalog = mpi_gather_catalog(catalog, &source_tiles);
+	
+	if(mpi_rank != 0)
+	{
+		message("Sources sent to first MPI process for merging.");
+		Array_siz_delete(source_tiles);
+		String_delete(name);
+		Path_delete(path_cat_ascii);
+		Path_delete(path_cat_xml);
+		Path_delete(path_cat_sql);
+		Path_delete(path_cat_fits);
+		Path_delete(path_profile);
+		Catalog_delete(catalog);
+		return;
+	}
+	
+	// Remove duplicate and truncated copies of sources crossing tile boundaries
+	Catalog *merged = Catalog_merge_tiles(catalog, source_tiles, bounds, tile_size, overlap, n_tiles, use_pos_offset);
+	Catalog_delete(catalog);
+	Array_siz_delete(source_tiles);
+	catalog = merged;
+	
+	// Assign new, unique source IDs and update generic source names accordingly
+	for(size_t i = 0; i < Catalog_get_size(catalog); ++i)
+	{
+		Source *src = Catalog_get_source(catalog, i);
+		const long int old_id = Source_get_par_by_name_int(src, "id");
+		const long int new_id = i + 1;
+		
+		String_set(name, prefix);
+		String_append_int(name, "-%04ld", old_id);
+		if(String_compare(name, Source_get_identifier(src)))
+		{
+			String_set(name, prefix);
+			String_append_int(name, "-%04ld", new_id);
+			Source_set_identifier(src, String_get(name));
+		}
+		else if(String_compare(String_set_int(name, "%ld", old_id), Source_get_identifier(src)))
+		{
+			Source_set_identifier(src, String_get(String_set_int(name, "%ld", new_id)));
+		}
+		
+		Source_set_par_int(src, "id", new_id, NULL, NULL);
+	}
+	
+	String_delete(name);
+	message("%zu source%s found across all tiles.", Catalog_get_size(catalog), Catalog_get_size(catalog) == 1 ? "" : "s");
+	ensure(Catalog_get_size(catalog), ERR_NO_SRC_FOUND, "No reliable sources found. Terminating pipeline.");
+	
+	if(write_ascii || write_xml || write_sql || write_fits)
+	{
+		status("Writing source catalogue");
+		Profiler_start(profiler, "write_catalogue", 0);
+		
+		if(write_ascii)
+		{
+			message("Writing ASCII file:   %s", Path_get_file(path_cat_ascii));
+			Catalog_save(catalog, Path_get(path_cat_ascii), CATALOG_FORMAT_ASCII, overwrite, NULL);
+		}
+		
+		if(write_xml)
+		{
+			message("Writing VOTable file: %s", Path_get_file(path_cat_xml));
+			Catalog_save(catalog, Path_get(path_cat_xml), CATALOG_FORMAT_XML, overwrite, par);
+		}
+		
+		if(write_sql)
+		{
+			message("Writing SQL file:     %s", Path_get_file(path_cat_sql));
+			Catalog_save(catalog, Path_get(path_cat_sql), CATALOG_FORMAT_SQL, overwrite, NULL);
+		}
+		
+		if(write_fits)
+		{
+			message("Writing FITS file:    %s", Path_get_file(path_cat_fits));
+			Catalog_save(catalog, Path_get(path_cat_fits), CATALOG_FORMAT_FITS, overwrite, NULL);
+		}
+		
+		// Print time
+		timestamp(start_time, start_clock);
+	}
+	
+	// Save profiling report
+	if(profiler != NULL)
+	{
+		Profiler_stop(profiler);
+		status("Writing profiling report");
+		message("Writing JSON file:    %s", Path_get_file(path_profile));
+		Profiler_save(profiler, Path_get(path_profile), overwrite);
+	}
+	
+	// Clean up
+	Path_delete(path_cat_ascii);
+	Path_delete(path_cat_xml);
+	Path_delete(path_cat_sql);
+	Path_delete(path_cat_fits);
+	Path_delete(path_profile);
+	Catalog_delete(catalog);
+	
+	return;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Run the pipeline for several configurations of the linker, reli-  //
+// ability filter, mask dilation and parameterisation settings from  //
+// a single source finding pass. Each entry in the comma-separated   //
+// list of 'pipeline.sweep' is a parameter file whose settings are   //
+// applied on top of the main parameter settings. The first config-  //
+// uration runs the full pipeline and writes a checkpoint which is   //
+// then restored by all remaining configurations, such that prepro-  //
+// cessing and source finding are only carried out once. Output file //
+// names are suffixed with the configuration number unless a config- //
+// uration specifies its own output file name.                       //
+// ----------------------------------------------------------------- //
+
+PRIVATE void run_sweep(Parameter *par, Profiler *profiler, const time_t start_time, const clock_t start_clock)
+{
+	// ---------------------------- //
+	// Load sweep configurations    //
+	// ---------------------------- //
+	
+	status("Setting up parameter sweep");
+	
+	const char *base_dir  = Parameter_get_str(par, "output.directory");
+	const char *base_name = Parameter_get_str(par, "output.filename");
+	const bool keep_checkpoint = Parameter_get_bool(par, "pipeline.checkpoint");
+	const uint64_t key = checkpoint_key(par);
+	
+	// Split list of parameter files first, as Parameter_load() relies on strtok() as well
+	const char *list = Parameter_get_str(par, "pipeline.sweep");
+	char *buffer = (char *)memory(MALLOC, strlen(list) + 1, sizeof(char));
+	strcpy(buffer, list);
+	
+	String **file_names = NULL;
+	size_t n_configs = 0;
+	
+	for(char *token = strtok(buffer, ","); token != NULL; token = strtok(NULL, ","))
+	{
+		String *file_name = String_trim(String_new(token));
+		
+		if(String_size(file_name))
+		{
+			file_names = (String **)memory_realloc(file_names, n_configs + 1, sizeof(String *));
+			file_names[n_configs++] = file_name;
+		}
+		else String_delete(file_name);
+	}
+	
+	free(buffer);
+	ensure(n_configs, ERR_USER_INPUT, "No sweep parameter files specified.");
+	
+	// Load parameter settings of each configuration
+	Parameter **configs = (Parameter **)memory(MALLOC, n_configs, sizeof(Parameter *));
+	
+	for(size_t i = 0; i < n_configs; ++i)
+	{
+		const char *file_name = String_get(file_names[i]);
+		message("- Loading sweep parameter file: %s", file_name);
+		configs[i] = Parameter_copy(par);
+		Parameter_load(configs[i], file_name, PARAMETER_UPDATE);
+		
+		// Only settings applied after source finding may differ between configurations
+		ensure(checkpoint_key(configs[i]) == key, ERR_USER_INPUT, "Sweep parameter file %s changes settings that affect\n       preprocessing or source finding; only linker, reliability,\n       dilation, parameter and output settings can be swept.", file_name);
+		ensure(strcmp(Parameter_get_str(configs[i], "output.directory"), base_dir) == 0, ERR_USER_INPUT, "Sweep parameter file %s must not change the output\n       directory, as all configurations share one checkpoint.", file_name);
+		ensure(Parameter_get_bool(configs[i], "linker.enable"), ERR_USER_INPUT, "The linker must be enabled in sweep mode, as no source\n       catalogue would be created otherwise.");
+		String_delete(file_names[i]);
+	}
+	
+	free(file_names);
+	message("Sweeping over %zu configuration%s.", n_configs, n_configs == 1 ? "" : "s");
+	
+	// Determine common base name for checkpoint and output files
+	Path *path_data_in = Path_new();
+	Path_set(path_data_in, Parameter_get_str(par, "input.data"));
+	String *output_file_name = String_new(strlen(base_name) ? base_name : Path_get_file(path_data_in));
+	String *output_stem = String_new("");
+	String *check_mime_type = String_new("");
+	String_to_lower(String_set_delim(check_mime_type, String_get(output_file_name), '.', false, false));
+	if(!String_compare(check_mime_type, "fits") && !String_compare(check_mime_type, "fit")) String_append(output_file_name, ".fits");
+	String_set_delim(output_stem, String_get(output_file_name), '.', false, true);
+	String_delete(check_mime_type);
+	
+	// Set up checkpoint paths for clean-up
+	Path *path_chk_cube = Path_new();
+	Path *path_chk_mask = Path_new();
+	Path_set_dir(path_chk_cube, strlen(base_dir) ? base_dir : (strlen(Path_get_dir(path_data_in)) ? Path_get_dir(path_data_in) : "."));
+	Path_set_dir(path_chk_mask, Path_get_dir(path_chk_cube));
+	Path_set_file_from_template(path_chk_cube, String_get(output_file_name), "_checkpoint", ".fits");
+	Path_set_file_from_template(path_chk_mask, String_get(output_file_name), "_checkpoint", ".bin");
+	Path_delete(path_data_in);
+	
+	
+	
+	// ---------------------------- //
+	// Run sweep configurations     //
+	// ---------------------------- //
+	
+	String *name = String_new("");
+	
+	for(size_t i = 0; i < n_configs; ++i)
+	{
+		status("Processing sweep configuration %zu of %zu", i + 1, n_configs);
+		
+		// Suffix output file names with configuration number, unless overridden by the user
+		if(strcmp(Parameter_get_str(configs[i], "output.filename"), base_name) == 0)
+		{
+			String_set(name, String_get(output_stem));
+			String_append_int(name, "_sweep%ld", (long int)(i + 1));
+			String_append(name, ".fits");
+			Parameter_set(configs[i], "output.filename", String_get(name));
+		}
+		message("Output file name:  %s", Parameter_get_str(configs[i], "output.filename"));
+		
+		// Run pipeline with separate profiler for each configuration
+		Profiler *profiler_cfg = profiler != NULL ? Profiler_new() : NULL;
+		Catalog_delete(run_pipeline(configs[i], false, true, String_get(output_file_name), profiler_cfg, start_time, start_clock));
+		Profiler_delete(profiler_cfg);
+		Parameter_delete(configs[i]);
+	}
+	
+	// Remove temporary checkpoint unless requested by the user
+	if(!keep_checkpoint)
+	{
+		status("Removing checkpoint");
+		message("Deleting checkpoint: %s", Path_get_file(path_chk_cube));
+		remove(Path_get(path_chk_cube));
+		remove(Path_get(path_chk_mask));
+	}
+	
+	// Clean up
+	free(configs);
+	String_delete(name);
+	String_delete(output_stem);
+	String_delete(output_file_name);
+	Path_delete(path_chk_cube);
+	Path_delete(path_chk_mask);
+	
+	return;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Run the pipeline on a batch of data cubes with identical parame-  //
+// ter settings. The cubes are listed in the text file specified by  //
+// 'input.batch', one file name per line, and processed one after    //
+// another within the same process, thus avoiding the start-up cost  //
+// of repeated pipeline invocations. While a cube is being processed //
+// the operating system is asked to read the next cube into the page //
+// cache in the background, so loading of the next cube will not     //
+// need to wait for the disk. Cubes without any sources will not     //
+// terminate the batch. Output file names are derived from the names //
+// of the individual input cubes. The batch will be rejected up front //
+// if two cubes would write to the same output files, e.g. because   //
+// they share the same file name in different input directories and  //
+// output.directory is set.                                          //
+// ----------------------------------------------------------------- //
+
+PRIVATE void run_batch(Parameter *par, Profiler *profiler, const time_t start_time, const clock_t start_clock)
+{
+	// ---------------------------- //
+	// Read list of input cubes     //
+	// ---------------------------- //
+	
+	status("Setting up batch processing");
+	
+	const char *list_name = Parameter_get_str(par, "input.batch");
+	const char *base_dir  = Parameter_get_str(par, "output.directory");
+	const bool  use_sweep = strlen(Parameter_get_str(par, "pipeline.sweep")) ? true : false;
+	
+	ensure(!Parameter_get_bool(par, "tiling.enable"), ERR_USER_INPUT, "Tiling is not supported in batch mode. Please set\n       \'tiling.enable = false\'.");
+	if(strlen(Parameter_get_str(par, "input.data")))      warning("Setting \'input.data\' will be ignored in batch mode.");
+	if(strlen(Parameter_get_str(par, "output.filename"))) warning("Setting \'output.filename\' will be ignored in batch mode.");
+	
+	message("Reading list of input cubes: %s", list_name);
+	FILE *fp = fopen(list_name, "r");
+	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open batch file: %s", list_name);
+	
+	char line[PARAMETER_MAX_LINE_SIZE];
+	String **cubes = NULL;
+	size_t n_cubes = 0;
+	
+	// Hash of output path of each cube for detecting name clashes
+	Map *output_names = Map_new();
+	Path *path_output = Path_new();
+	Path *path_other  = Path_new();
+	
+	while(fgets(line, PARAMETER_MAX_LINE_SIZE, fp))
+	{
+		const char *file_name = trim_string(line);
+		if(strlen(file_name) == 0 || file_name[0] == '#') continue;  // Skip empty lines and comments
+		
+		// Check input cubes up front, so the batch will not fail half-way through
+		FILE *fp_cube = fopen(file_name, "rb");
+		ensure(fp_cube != NULL, ERR_FILE_ACCESS, "Failed to open input cube: %s", file_name);
+		fclose(fp_cube);
+		
+		// Ensure that no two cubes write to the same output files
+		batch_output_path(path_output, file_name, base_dir);
+		const size_t key = (size_t)checkpoint_hash(14695981039346656037ULL, Path_get(path_output));
+		if(Map_key_exists(output_names, key))
+		{
+			const char *other_name = String_get(cubes[Map_get_value(output_names, key)]);
+			batch_output_path(path_other, other_name, base_dir);
+			ensure(strcmp(Path_get(path_output), Path_get(path_other)), ERR_USER_INPUT, "Input cubes %s and %s would write to\n       the same output files. Please rename one of them or\n       process them in separate batches.", other_name, file_name);
+		}
+		Map_push(output_names, key, n_cubes);
+		
+		cubes = (String **)memory_realloc(cubes, n_cubes + 1, sizeof(String *));
+		cubes[n_cubes++] = String_new(file_name);
+	}
+	
+	fclose(fp);
+	Map_delete(output_names);
+	Path_delete(path_output);
+	Path_delete(path_other);
+	ensure(n_cubes, ERR_USER_INPUT, "No input cubes listed in batch file.");
+	message("Processing %zu input cube%s.", n_cubes, n_cubes == 1 ? "" : "s");
+	
+	
+	
+	// ---------------------------- //
+	// Process individual cubes     //
+	// ---------------------------- //
+	
+	size_t n_sources = 0;
+	size_t n_empty   = 0;
+	
+	// Cubes are distributed across MPI processes in round-robin fashion
+	int mpi_rank, mpi_size;
+	mpi_get_rank(&mpi_rank, &mpi_size);
+	if(mpi_size > 1) message("Distributing cubes across %d MPI processes.", mpi_size);
+	
+	for(size_t i = 0; i < n_cubes; ++i)
+	{
+		// Skip cubes assigned to other processes
+		if(i % (size_t)mpi_size != (size_t)mpi_rank)
+		{
+			String_delete(cubes[i]);
+			continue;
+		}
+		
+		status("Processing cube %zu of %zu", i + 1, n_cubes);
+		message("Input cube:  %s", String_get(cubes[i]));
+		
+		// Start reading next cube while current one is processed
+		if(i + mpi_size < n_cubes) batch_prefetch(String_get(cubes[i + mpi_size]));
+		
+		// Set up parameters for current cube
+		Parameter *par_cube = Parameter_copy(par);
+		Parameter_set(par_cube, "input.data", String_get(cubes[i]));
+		Parameter_set(par_cube, "input.batch", "");
+		Parameter_set(par_cube, "output.filename", "");
+		
+		// Cubes can differ in size and are planned individually, but never tiled
+		if(Parameter_get_int(par_cube, "pipeline.memoryLimit") > 0) plan_memory(par_cube, false);
+		
+		// Run pipeline with separate profiler for each cube
+		Profiler *profiler_cube = profiler != NULL ? Profiler_new() : NULL;
+		
+		if(use_sweep) run_sweep(par_cube, profiler_cube, start_time, start_clock);
+		else
+		{
+			Catalog *catalog = run_pipeline(par_cube, false, true, NULL, profiler_cube, start_time, start_clock);
+			if(Catalog_get_size(catalog)) n_sources += Catalog_get_size(catalog);
+			else ++n_empty;
+			Catalog_delete(catalog);
+		}
+		
+		Profiler_delete(profiler_cube);
+		Parameter_delete(par_cube);
+		String_delete(cubes[i]);
+	}
+	
+	free(cubes);
+	
+	// Print summary
+	mpi_sum(&n_sources);
+	mpi_sum(&n_empty);
+	status("Batch processing finished");
+	message("%zu input cube%s processed.", n_cubes, n_cubes == 1 ? "" : "s");
+	if(!use_sweep) message("%zu source%s found; %zu cube%s without sources.", n_sources, n_sources == 1 ? "" : "s", n_empty, n_empty == 1 ? "" : "s");
+	
+	return;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Set path to the base name of the output files of the specified    //
+// input cube in batch mode, using the same naming rules as the      //
+// pipeline, but without any suffix or file extension.               //
+// ----------------------------------------------------------------- //
+
+PRIVATE void batch_output_path(Path *path, const char *file_name, const char *base_dir)
+{
+	Path *path_data_in = Path_new();
+	Path_set(path_data_in, file_name);
+	
+	String *output_file_name = String_new(Path_get_file(path_data_in));
+	String *check_mime_type = String_new("");
+	String_to_lower(String_set_delim(check_mime_type, String_get(output_file_name), '.', false, false));
+	if(!String_compare(check_mime_type, "fits") && !String_compare(check_mime_type, "fit")) String_append(output_file_name, ".fits");
+	
+	Path_set_dir(path, strlen(base_dir) ? base_dir : (strlen(Path_get_dir(path_data_in)) ? Path_get_dir(path_data_in) : "."));
+	Path_set_file_from_template(path, String_get(output_file_name), "", "");
+	
+	String_delete(check_mime_type);
+	String_delete(output_file_name);
+	Path_delete(path_data_in);
+	
+	return;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Ask the operating system to start reading the specified file into //
+// the page cache in the background. This is merely a hint and will  //
+// silently do nothing if not supported by the system.               //
+// ----------------------------------------------------------------- //
+
+PRIVATE void batch_prefetch(const char *filename)
+{
+	#ifdef POSIX_FADV_WILLNEED
+		FILE *fp = fopen(filename, "rb");
+		if(fp == NULL) return;
+		posix_fadvise(fileno(fp), 0, 0, POSIX_FADV_WILLNEED);
+		fclose(fp);
+	#else
+		(void)filename;
+	#endif
+	
+	return;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Plan the execution of the pipeline within the memory limit given  //
+// by pipeline.memoryLimit. The footprint of each stage is estimated //
+// from the size of the cube (or of a single tile in tiled mode) and //
+// the working word size. If the peak footprint exceeds the limit,   //
+// the following strategies are applied one after the other until it //
+// fits: reloading the data instead of keeping a copy, running the   //
+// fused S+C finder with a working set that fits the remaining       //
+// budget, and splitting the cube into spectral slabs or spatial     //
+// tiles if allowed. Noise, weights and gain cubes are memory-mapped //
+// and the S+C finder mask is bit-packed in any case; neither adds   //
+// to the estimate beyond the mask bits. Tiles are sized from the    //
+// footprint of a tile including its overlap, and their core must be //
+// at least PLAN_CORE_RATIO times the overlap, as the overhead of    //
+// processing the overlap would otherwise dominate. As tiled mode    //
+// cannot create any image products, the pipeline will terminate if  //
+// tiling is needed, but not possible, or if image products were     //
+// requested. The resulting plan will be logged, and the parameter   //
+// settings will be adjusted accordingly.                            //
+// ----------------------------------------------------------------- //
+
+#define PLAN_CORE_RATIO 4
+
+PRIVATE void plan_memory(Parameter *par, const bool allow_tiling)
+{
+	status("Planning memory usage");
+	
+	const size_t limit = (size_t)Parameter_get_int(par, "pipeline.memoryLimit") * MEGABYTE;
+	const bool use_scfind  = Parameter_get_bool(par, "scfind.enable");
+	const bool use_linker  = Parameter_get_bool(par, "linker.enable");
+	const bool use_device  = strcmp(Parameter_get_str(par, "pipeline.device"), "gpu") == 0;
+	const bool use_scaling = Parameter_get_bool(par, "scaleNoise.enable");
+	const bool use_reload  = strlen(Parameter_get_str(par, "input.noise")) || strlen(Parameter_get_str(par, "input.weights")) || use_scaling;
+	const bool can_fuse    = use_scfind && !use_device && !(use_scaling && Parameter_get_bool(par, "scaleNoise.scfind"));
+	      bool keep_data   = Parameter_get_bool(par, "parameter.keepData") && use_reload;
+	      bool use_fused   = Parameter_get_bool(par, "scfind.fused");
+	      bool use_tiling  = Parameter_get_bool(par, "tiling.enable");
+	
+	// Read header to determine cube size and data type
+	DataCube *dataCube = DataCube_new(false);
+	DataCube_load_header(dataCube, Parameter_get_str(par, "input.data"));
+	
+	size_t bounds[6] = {0, DataCube_get_axis_size(dataCube, 0) - 1, 0, DataCube_get_axis_size(dataCube, 1) - 1, 0, DataCube_get_axis_size(dataCube, 2) - 1};
+	const long int bitpix = DataCube_gethd_int(dataCube, "BITPIX");
+	const double bscale = DataCube_gethd_flt(dataCube, "BSCALE");
+	const double bzero  = DataCube_gethd_flt(dataCube, "BZERO");
+	DataCube_delete(dataCube);
+	
+	if(strlen(Parameter_get_str(par, "input.region")))
+	{
+		Array_siz *region = Array_siz_new_str(Parameter_get_str(par, "input.region"));
+		ensure(Array_siz_get_size(region) == 6, ERR_USER_INPUT, "Invalid region supplied; must contain 6 values.");
+		for(size_t i = 0; i < 6; i += 2)
+		{
+			if(Array_siz_get(region, i)     > bounds[i])     bounds[i]     = Array_siz_get(region, i);
+			if(Array_siz_get(region, i + 1) < bounds[i + 1]) bounds[i + 1] = Array_siz_get(region, i + 1);
+			ensure(bounds[i] <= bounds[i + 1], ERR_USER_INPUT, "Invalid data cube region requested.");
+		}
+		Array_siz_delete(region);
+	}
+	
+	const size_t extent[3] = {bounds[1] - bounds[0] + 1, bounds[3] - bounds[2] + 1, bounds[5] - bounds[4] + 1};
+	
+	// Working word size; scaled integers and single precision end up as 32-bit floats
+	const bool scaled = (IS_NOT_NAN(bscale) && bscale != 1.0) || (IS_NOT_NAN(bzero) && bzero != 0.0);
+	const size_t word_size = (strcmp(Parameter_get_str(par, "input.precision"), "single") == 0 || (bitpix > 0 && scaled)) ? 4 : (size_t)(labs(bitpix) / 8);
+	
+	// Number of voxels processed at once (entire region or largest tile including overlap)
+	size_t n_vox = 1;
+	
+	for(size_t i = 0; i < 3; ++i)
+	{
+		size_t size = extent[i];
+		
+		if(use_tiling)
+		{
+			const size_t tile    = Parameter_get_int(par, i < 2 ? "tiling.sizeXY" : "tiling.sizeZ");
+			const size_t overlap = Parameter_get_int(par, i < 2 ? "tiling.overlapXY" : "tiling.overlapZ");
+			if(tile > 0 && tile + 2 * overlap < size) size = tile + 2 * overlap;
+		}
+		
+		n_vox *= size;
+	}
+	
+	// Estimate footprint of individual stages (in bytes)
+	size_t mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask;
+	plan_stages(par, n_vox, word_size, &mem_data, &mem_keep, &mem_noise, &mem_bits, &mem_scfind, &mem_mask);
+	
+	message("Memory limit:        %.1f MB", (double)limit / MEGABYTE);
+	message("Estimated footprint%s:", use_tiling ? " per tile" : "");
+	message("  Data cube:         %.1f MB", (double)mem_data / MEGABYTE);
+	message("  Original data:     %.1f MB", (double)mem_keep / MEGABYTE);
+	message("  Noise scaling:     %.1f MB", (double)mem_noise / MEGABYTE);
+	message("  S+C finder:        %.1f MB", (double)(mem_bits + mem_scfind) / MEGABYTE);
+	message("  Linker mask:       %.1f MB", (double)(mem_bits + mem_mask) / MEGABYTE);
+	message("  Peak:              %.1f MB\n", (double)plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) / MEGABYTE);
+	
+	// Apply strategies until estimated peak footprint fits within limit
+	String *value = String_new("");
+	
+	if(plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) > limit && keep_data)
+	{
+		keep_data = false;
+		Parameter_set(par, "parameter.keepData", "false");
+		plan_stages(par, n_vox, word_size, &mem_data, &mem_keep, &mem_noise, &mem_bits, &mem_scfind, &mem_mask);
+		message("- Reloading data for parameterisation instead of keeping a copy.");
+	}
+	
+	if(plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) > limit && can_fuse && mem_scfind == mem_data)
+	{
+		// Working set for whatever is left after the data cube, its copy and the mask bits
+		const size_t used = mem_data + mem_keep + mem_bits;
+		const size_t budget = limit > used + MEGABYTE ? (limit - used) / MEGABYTE : 1;
+		
+		use_fused = true;
+		Parameter_set(par, "scfind.fused", "true");
+		Parameter_set(par, "scfind.workingSet", String_get(String_set_int(value, "%ld", budget)));
+		plan_stages(par, n_vox, word_size, &mem_data, &mem_keep, &mem_noise, &mem_bits, &mem_scfind, &mem_mask);
+		message("- Running fused S+C finder with a working set of %zu MB.", budget);
+	}
+	
+	if(plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) > limit && allow_tiling && !use_tiling && use_linker)
+	{
+		// Tiled mode cannot create image products, so none must have been requested
+		const char *products[][2] = {{"output.writeNoise", NULL}, {"output.writeFiltered", NULL}, {"output.writeMask", NULL}, {"output.writeMask2d", NULL}, {"output.writeRawMask", NULL}, {"output.writeMoments", NULL}, {"output.writeCubelets", NULL}, {"reliability.plot", "reliability.enable"}, {"reliability.debug", "reliability.enable"}, {"flag.log", "flag.auto"}};
+		String *requested = String_new("");
+		
+		for(size_t i = 0; i < sizeof(products) / sizeof(products[0]); ++i)
+		{
+			if(!Parameter_get_bool(par, products[i][0]) || (products[i][1] != NULL && !Parameter_get_bool(par, products[i][1]))) continue;
+			String_append(requested, String_size(requested) ? ",\n         " : "         ");
+			String_append(requested, products[i][0]);
+		}
+		
+		ensure(!String_size(requested), ERR_USER_INPUT, "Cannot fit in pipeline.memoryLimit. The cube would need to be\n       processed in tiles, but the following outputs are not supported\n       in tiled mode:\n%s\n       Please disable these outputs or increase the memory limit.", String_get(requested));
+		String_delete(requested);
+		
+		// Largest slab or tile core for which the footprint including overlap fits
+		const size_t overlap_z  = Parameter_get_int(par, "tiling.overlapZ");
+		const size_t overlap_xy = Parameter_get_int(par, "tiling.overlapXY");
+		const size_t core_z  = plan_tile_core(par, word_size, extent, overlap_z,  false, limit);
+		const size_t core_xy = plan_tile_core(par, word_size, extent, overlap_xy, true,  limit);
+		
+		// Prefer spectral slabs, which keep spatial structure intact, over spatial tiles
+		if(core_z && core_z >= PLAN_CORE_RATIO * overlap_z)
+		{
+			Parameter_set(par, "tiling.sizeXY", "0");
+			Parameter_set(par, "tiling.sizeZ", String_get(String_set_int(value, "%ld", core_z)));
+			n_vox = extent[0] * extent[1] * (core_z + 2 * overlap_z < extent[2] ? core_z + 2 * overlap_z : extent[2]);
+			message("- Splitting cube into spectral slabs of %zu channels.", core_z);
+			message("  Voxels processed including overlap: about %.2f times cube size.", (double)(core_z + 2 * overlap_z) / (double)core_z);
+		}
+		else if(core_xy && core_xy >= PLAN_CORE_RATIO * overlap_xy)
+		{
+			const size_t side_x = core_xy + 2 * overlap_xy < extent[0] ? core_xy + 2 * overlap_xy : extent[0];
+			const size_t side_y = core_xy + 2 * overlap_xy < extent[1] ? core_xy + 2 * overlap_xy : extent[1];
+			Parameter_set(par, "tiling.sizeXY", String_get(String_set_int(value, "%ld", core_xy)));
+			Parameter_set(par, "tiling.sizeZ", "0");
+			n_vox = side_x * side_y * extent[2];
+			message("- Splitting cube into spatial tiles of %zu x %zu pixels.", core_xy, core_xy);
+			message("  Voxels processed including overlap: about %.2f times cube size.", (double)((core_xy + 2 * overlap_xy) * (core_xy + 2 * overlap_xy)) / (double)(core_xy * core_xy));
+		}
+		else ensure(false, ERR_USER_INPUT, "Cannot fit in pipeline.memoryLimit. No spectral slab or spatial\n       tile with a core of at least %d times the overlap fits within\n       the limit. Please increase the memory limit or reduce the\n       tile overlap.", PLAN_CORE_RATIO);
+		
+		// Footprint of a single tile including overlap
+		use_tiling = true;
+		Parameter_set(par, "tiling.enable", "true");
+		plan_stages(par, n_vox, word_size, &mem_data, &mem_keep, &mem_noise, &mem_bits, &mem_scfind, &mem_mask);
+		message("  Estimated peak footprint per tile: %.1f MB", (double)plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) / MEGABYTE);
+	}
+	
+	if(plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) > limit && !use_tiling) warning("Estimated memory footprint of %.1f MB exceeds the memory\n         limit, and no further strategy is available.", (double)plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) / MEGABYTE);
+	else if(plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) > limit) warning("Estimated memory footprint per tile of %.1f MB exceeds the\n         memory limit. Please reduce the tile size.", (double)plan_peak(mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask) / MEGABYTE);
+	
+	String_delete(value);
+	
+	message("Plan: %s S+C finder%s%s.\n",
+		use_fused && can_fuse ? "fused" : (use_device ? "device" : "standard"),
+		keep_data ? ", original data kept in memory" : "",
+		use_tiling ? ", tiled processing" : "");
+	
+	return;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Estimate the memory footprint (in bytes) of the individual stages //
+// of the pipeline for the current parameter settings when process-  //
+// ing n_vox voxels of the specified working word size at once. The  //
+// peak footprint across all stages is returned.                     //
+// ----------------------------------------------------------------- //
+
+PRIVATE size_t plan_stages(const Parameter *par, const size_t n_vox, const size_t word_size, size_t *mem_data, size_t *mem_keep, size_t *mem_noise, size_t *mem_bits, size_t *mem_scfind, size_t *mem_mask)
+{
+	const bool use_scfind  = Parameter_get_bool(par, "scfind.enable");
+	const bool use_device  = strcmp(Parameter_get_str(par, "pipeline.device"), "gpu") == 0;
+	const bool use_scaling = Parameter_get_bool(par, "scaleNoise.enable");
+	const bool use_local   = use_scaling && strcmp(Parameter_get_str(par, "scaleNoise.mode"), "local") == 0;
+	const bool use_reload  = strlen(Parameter_get_str(par, "input.noise")) || strlen(Parameter_get_str(par, "input.weights")) || use_scaling;
+	const bool can_fuse    = use_scfind && !use_device && !(use_scaling && Parameter_get_bool(par, "scaleNoise.scfind"));
+	const bool use_fused   = Parameter_get_bool(par, "scfind.fused");
+	const size_t working_set = (size_t)Parameter_get_int(par, "scfind.workingSet") * MEGABYTE;
+	
+	*mem_data   = n_vox * word_size;
+	*mem_bits   = (n_vox + 7) / 8;
+	*mem_noise  = (use_local || Parameter_get_bool(par, "rippleFilter.enable")) ? *mem_data : 0;
+	*mem_mask   = Parameter_get_bool(par, "linker.enable") ? n_vox * (Parameter_get_bool(par, "output.writeRawMask") ? 5 : 4) : 0;
+	*mem_keep   = (Parameter_get_bool(par, "parameter.keepData") && use_reload) ? *mem_data : 0;
+	*mem_scfind = use_scfind ? (use_device ? 2 * n_vox * sizeof(float) : ((use_fused && can_fuse && working_set > 0 && working_set < *mem_data) ? working_set : *mem_data)) : 0;
+	
+	return plan_peak(*mem_data, *mem_keep, *mem_noise, *mem_bits, *mem_scfind, *mem_mask);
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Return the largest core size of a spectral slab (or of a square   //
+// spatial tile if spatial is true) for which the estimated peak     //
+// footprint of a slab or tile, including an overlap of the given    //
+// size on either side, does not exceed the limit. 0 is returned if  //
+// not even a core of 1 channel or pixel would fit.                  //
+// ----------------------------------------------------------------- //
+
+PRIVATE size_t plan_tile_core(const Parameter *par, const size_t word_size, const size_t *extent, const size_t overlap, const bool spatial, const size_t limit)
+{
+	size_t mem_data, mem_keep, mem_noise, mem_bits, mem_scfind, mem_mask;
+	size_t lower = 0;
+	size_t upper = spatial ? (extent[0] > extent[1] ? extent[0] : extent[1]) : extent[2];
+	
+	// Binary search, as the footprint increases monotonically with core size
+	while(lower < upper)
+	{
+		const size_t core = upper - (upper - lower) / 2;
+		const size_t side_x = spatial && core + 2 * overlap < extent[0] ? core + 2 * overlap : extent[0];
+		const size_t side_y = spatial && core + 2 * overlap < extent[1] ? core + 2 * overlap : extent[1];
+		const size_t side_z = !spatial && core + 2 * overlap < extent[2] ? core + 2 * overlap : extent[2];
+		
+		if(plan_stages(par, side_x * side_y * side_z, word_size, &mem_data, &mem_keep, &mem_noise, &mem_bits, &mem_scfind, &mem_mask) <= limit) lower = core;
+		else upper = core - 1;
+	}
+	
+	return lower;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Return the peak memory footprint of the pipeline for the given    //
+// footprints of the individual stages. The data cube and its copy   //
+// are held throughout, while noise scaling, the S+C finder and the  //
+// linker mask are needed one after the other, with the mask bits    //
+// shared by the last two of them.                                   //
+// ----------------------------------------------------------------- //
+
+PRIVATE size_t plan_peak(const size_t data, const size_t keep, const size_t noise, const size_t bits, const size_t scfind, const size_t mask)
+{
+	const size_t stage = bits + (scfind > mask ? scfind : mask);
+	return data + keep + (noise > stage ? noise : stage);
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Helper functions for running the pipeline across multiple MPI     //
+// processes. Tiles (in tiled mode) or input cubes (in batch mode)   //
+// are distributed across processes, with the tile overlap acting as //
+// the halo around each tile's core region. At the end, all sources  //
+// are sent to the first process, which assembles them in the same   //
+// tile order as a single process would. Without SOFIA_MPI defined,  //
+// the pipeline runs as a single process, and the helpers will do    //
+// nothing.                                                          //
+// ----------------------------------------------------------------- //
+
+PRIVATE void mpi_get_rank(int *rank, int *size)
+{
+	#ifdef SOFIA_MPI
+		MPI_Comm_rank(MPI_COMM_WORLD, rank);
+		MPI_Comm_size(MPI_COMM_WORLD, size);
+	#else
+		*rank = 0;
+		*size = 1;
+	#endif
+	
+	return;
+}
+
+
+
+// Sum up value across all processes
+
+PRIVATE void mpi_sum(size_t *value)
+{
+	#ifdef SOFIA_MPI
+		unsigned long long int local = *value;
+		unsigned long long int total = 0;
+		MPI_Allreduce(&local, &total, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+		*value = (size_t)total;
+	#else
+		(void)value;
+	#endif
+	
+	return;
+}
+
+
+
+// Send sources from all processes to the first process and merge
+// them in order of tile index. On the first process, the merged
+// catalogue will be returned, while all other processes will re-
+// ceive an empty catalogue. The original catalogue is consumed, and
+// source_tiles is replaced with the tile indices of the returned
+// sources.
+
+PRIVATE Catalog *mpi_gather_catalog(Catalog *catalog, Array_siz **source_tiles)
+{
+	#ifdef SOFIA_MPI
+		int rank, size;
+		mpi_get_rank(&rank, &size);
+		if(size == 1) return catalog;
+		
+		// Serialise local sources along with their tile index
+		char *buffer = NULL;
+		size_t buffer_size = 0;
+		
+		for(size_t i = 0; i < Catalog_get_size(catalog); ++i)
+		{
+			const Source *src = Catalog_get_source(catalog, i);
+			const uint64_t tile  = Array_siz_get(*source_tiles, i);
+			const uint64_t n_par = Source_get_num_par(src);
+			
+			mpi_pack(&buffer, &buffer_size, &tile, sizeof(uint64_t));
+			mpi_pack_string(&buffer, &buffer_size, Source_get_identifier(src));
+			mpi_pack(&buffer, &buffer_size, &n_par, sizeof(uint64_t));
+			
+			for(size_t j = 0; j < n_par; ++j)
+			{
+				const unsigned char type = Source_get_type(src, j);
+				mpi_pack(&buffer, &buffer_size, &type, 1);
+				mpi_pack_string(&buffer, &buffer_size, Source_get_name(src, j));
+				mpi_pack_string(&buffer, &buffer_size, Source_get_unit(src, j));
+				mpi_pack_string(&buffer, &buffer_size, Source_get_ucd(src, j));
+				
+				if(type == SOURCE_TYPE_INT)
+				{
+					const int64_t value = Source_get_par_int(src, j);
+					mpi_pack(&buffer, &buffer_size, &value, sizeof(int64_t));
+				}
+				else
+				{
+					const double value = Source_get_par_flt(src, j);
+					mpi_pack(&buffer, &buffer_size, &value, sizeof(double));
+				}
+			}
+		}
+		
+		ensure(buffer_size <= INT_MAX, ERR_INT_OVERFLOW, "Source catalogue too large to be sent via MPI.");
+		Catalog_delete(catalog);
+		Array_siz_delete(*source_tiles);
+		*source_tiles = Array_siz_new(0);
+		
+		// Send serialised sources to first process
+		if(rank != 0)
+		{
+			const int count = (int)buffer_size;
+			MPI_Send(&count, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
+			MPI_Send(buffer, count, MPI_BYTE, 0, 1, MPI_COMM_WORLD);
+			free(buffer);
+			return Catalog_new();
+		}
+		
+		// Receive serialised sources from all other processes
+		char   **buffers = (char **)memory(MALLOC, size, sizeof(char *));
+		int     *counts  = (int *)memory(MALLOC, size, sizeof(int));
+		const char **ptr = (const char **)memory(MALLOC, size, sizeof(char *));
+		buffers[0] = buffer;
+		counts[0]  = (int)buffer_size;
+		
+		for(int i = 1; i < size; ++i)
+		{
+			MPI_Recv(&counts[i], 1, MPI_INT, i, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+			buffers[i] = (char *)memory(MALLOC, counts[i] > 0 ? counts[i] : 1, sizeof(char));
+			MPI_Recv(buffers[i], counts[i], MPI_BYTE, i, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		}
+		
+		for(int i = 0; i < size; ++i) ptr[i] = buffers[i];
+		
+		// Merge sources in order of tile index; as tiles were assigned in
+		// round-robin fashion and processed in order, each process's sources
+		// are already sorted, and the next one will always come from the
+		// process holding the lowest pending tile index
+		Catalog *merged = Catalog_new();
+		String *string = String_new("");
+		
+		while(true)
+		{
+			int next = -1;
+			uint64_t next_tile = 0;
+			
+			for(int i = 0; i < size; ++i)
+			{
+				if(ptr[i] >= buffers[i] + counts[i]) continue;
+				uint64_t tile;
+				memcpy(&tile, ptr[i], sizeof(uint64_t));
+				if(next < 0 || tile < next_tile)
+				{
+					next = i;
+					next_tile = tile;
+				}
+			}
+			
+			if(next < 0) break;
+			
+			// Deserialise source
+			const char *end = buffers[next] + counts[next];
+			uint64_t tile, n_par;
+			mpi_unpack(&ptr[next], end, &tile, sizeof(uint64_t));
+			Source *src = Source_new(false);
+			Source_set_identifier(src, String_get(mpi_unpack_string(&ptr[next], end, string)));
+			mpi_unpack(&ptr[next], end, &n_par, sizeof(uint64_t));
+			
+			for(size_t j = 0; j < n_par; ++j)
+			{
+				unsigned char type;
+				mpi_unpack(&ptr[next], end, &type, 1);
+				String *par_name = String_copy(mpi_unpack_string(&ptr[next], end, string));
+				String *par_unit = String_copy(mpi_unpack_string(&ptr[next], end, string));
+				mpi_unpack_string(&ptr[next], end, string);
+				
+				if(type == SOURCE_TYPE_INT)
+				{
+					int64_t value;
+					mpi_unpack(&ptr[next], end, &value, sizeof(int64_t));
+					Source_add_par_int(src, String_get(par_name), value, String_get(par_unit), String_get(string));
+				}
+				else
+				{
+					double value;
+					mpi_unpack(&ptr[next], end, &value, sizeof(double));
+					Source_add_par_flt(src, String_get(par_name), value, String_get(par_unit), String_get(string));
+				}
+				
+				String_delete(par_name);
+				String_delete(par_unit);
+			}
+			
+			Catalog_add_source(merged, src);
+			Array_siz_push(*source_tiles, tile);
+		}
+		
+		// Clean up
+		for(int i = 0; i < size; ++i) free(buffers[i]);
+		free(buffers);
+		free(counts);
+		free(ptr);
+		String_delete(string);
+		
+		return merged;
+	#else
+		(void)source_tiles;
+		return catalog;
+	#endif
+}
+
+
+
+#ifdef SOFIA_MPI
+
+// Abort all processes if one of them terminates prematurely
+
+PRIVATE void mpi_abort_on_exit(void)
+{
+	int finalized = 0;
+	MPI_Finalized(&finalized);
+	if(!finalized) MPI_Abort(MPI_COMM_WORLD, 1);
+	
+	return;
+}
+
+
+
+// Append n bytes of data to buffer
+
+PRIVATE void mpi_pack(char **buffer, size_t *size, const void *data, const size_t n)
+{
+	*buffer = (char *)memory_realloc(*buffer, *size + n, sizeof(char));
+	memcpy(*buffer + *size, data, n);
+	*size += n;
+	
+	return;
+}
+
+
+
+// Append string preceded by its length to buffer
+
+PRIVATE void mpi_pack_string(char **buffer, size_t *size, const char *string)
+{
+	const uint64_t length = string != NULL ? strlen(string) : 0;
+	mpi_pack(buffer, size, &length, sizeof(uint64_t));
+	if(length) mpi_pack(buffer, size, string, length);
+	
+	return;
+}
+
+
+
+// Extract n bytes of data from buffer
+
+PRIVATE void mpi_unpack(const char **ptr, const char *end, void *data, const size_t n)
+{
+	ensure(*ptr + n <= end, ERR_FAILURE, "Corrupted source data received via MPI.");
+	memcpy(data, *ptr, n);
+	*ptr += n;
+	
+	return;
+}
+
+
+
+// Extract string preceded by its length from buffer
+
+PRIVATE String *mpi_unpack_string(const char **ptr, const char *end, String *string)
+{
+	uint64_t length;
+	mpi_unpack(ptr, end, &length, sizeof(uint64_t));
+	ensure(*ptr + length <= end, ERR_FAILURE, "Corrupted source data received via MPI.");
+	
+	// NOTE: String only accepts NUL-terminated input.
+	char *copy = (char *)memory(MALLOC, length + 1, sizeof(char));
+	memcpy(copy, *ptr, length);
+	copy[length] = '\0';
+	String_set(string, copy);
+	free(copy);
+	*ptr += length;
+	
+	return string;
+}
+
+#endif
+
+
+
+// ----------------------------------------------------------------- //
+// Checkpoint of the source finding stage. The processed data cube   //
+// is written to a FITS file, while the bit-packed source finding    //
+// mask and the flagging regions (including those from auto-flag-    //
+// ging) are written to a binary file. Both files are tagged with a  //
+// 64-bit key derived from the identity (path, size and modification //
+// time) of the input files and from all parameter settings affect-  //
+// ing the data cube or mask prior to linking. If the key of an ex-  //
+// isting checkpoint matches, the pipeline can skip straight to the  //
+// linker, such that the linker, reliability, dilation and parame-   //
+// terisation settings can be tuned without rerunning the expensive  //
+// preprocessing and source finding steps.                           //
+// ----------------------------------------------------------------- //
+
+#define CHECKPOINT_MAGIC "SoFiA-CP"
+
+PRIVATE uint64_t checkpoint_hash(uint64_t hash, const char *string)
+{
+	// FNV-1a hash, including terminating null character as separator
+	do
+	{
+		hash ^= (unsigned char)(*string);
+		hash *= 1099511628211ULL;
+	} while(*string++);
+	
+	return hash;
+}
+
+PRIVATE uint64_t checkpoint_key(const Parameter *par)
+{
+	// Parameters that only affect the linker and subsequent steps
+	const char *downstream[] = {"linker.", "reliability.", "dilation.", "parameter.", "output.", "tiling.", "input.gain", "flag.log", "pipeline.verbose", "pipeline.pedantic", "pipeline.threads", "pipeline.hugePages", "pipeline.memoryLimit", "pipeline.profile", "pipeline.checkpoint", "pipeline.sweep"};
+	const size_t n_downstream = sizeof(downstream) / sizeof(downstream[0]);
+	
+	// Input files that affect the data cube or mask prior to linking
+	const char *files[] = {"input.data", "input.noise", "input.weights", "input.mask", "flag.catalog"};
+	const size_t n_files = sizeof(files) / sizeof(files[0]);
+	
+	uint64_t hash = checkpoint_hash(14695981039346656037ULL, SOFIA_VERSION);
+	
+	for(size_t i = 0; i < Parameter_get_size(par); ++i)
+	{
+		const char *key = Parameter_get_key(par, i);
+		bool relevant = true;
+		for(size_t j = 0; j < n_downstream && relevant; ++j) if(strncmp(key, downstream[j], strlen(downstream[j])) == 0) relevant = false;
+		
+		if(relevant)
+		{
+			hash = checkpoint_hash(hash, key);
+			hash = checkpoint_hash(hash, Parameter_get_str_index(par, i));
+		}
+	}
+	
+	for(size_t i = 0; i < n_files; ++i)
+	{
+		const char *filename = Parameter_get_str(par, files[i]);
+		struct stat info;
+		char identity[64] = "";
+		
+		if(strlen(filename) && stat(filename, &info) == 0) snprintf(identity, sizeof(identity), "%lld %lld", (long long int)(info.st_size), (long long int)(info.st_mtime));
+		hash = checkpoint_hash(hash, identity);
+	}
+	
+	return hash;
+}
+
+PRIVATE DataCube *checkpoint_load(Path *path_cube, Path *path_mask, const uint64_t key, Array_siz **flag_regions, bool *use_flagging, BitMask **maskBits, const bool verbosity)
+{
+	if(!Path_file_is_readable(path_cube) || !Path_file_is_readable(path_mask))
+	{
+		message("No checkpoint found.");
+		return NULL;
+	}
+	
+	// Read and check header of mask file
+	FILE *fp = fopen(Path_get(path_mask), "rb");
+	if(fp == NULL) return NULL;
+	
+	char magic[8];
+	uint64_t stored_key = 0;
+	uint64_t flags[2] = {0, 0};  // flagging switch, number of flagging region values
+	
+	if(fread(magic, 1, 8, fp) != 8 || memcmp(magic, CHECKPOINT_MAGIC, 8) != 0 || fread(&stored_key, sizeof(uint64_t), 1, fp) != 1 || stored_key != key || fread(flags, sizeof(uint64_t), 2, fp) != 2)
+	{
+		fclose(fp);
+		message("Checkpoint does not match current input and settings.");
+		return NULL;
+	}
+	
+	// Read flagging regions
+	Array_siz *regions = Array_siz_new(0);
+	bool success = true;
+	
+	for(uint64_t i = 0; i < flags[1] && success; ++i)
+	{
+		uint64_t value;
+		success = (fread(&value, sizeof(uint64_t), 1, fp) == 1);
+		if(success) Array_siz_push(regions, value);
+	}
+	
+	// Load data cube and check its key
+	DataCube *dataCube = NULL;
+	
+	if(success)
+	{
+		message("Loading checkpoint: %s", Path_get_file(path_cube));
+		dataCube = DataCube_new(verbosity);
+		DataCube_load(dataCube, Path_get(path_cube), NULL);
+		
+		char key_string[32];
+		snprintf(key_string, sizeof(key_string), "%016llx", (unsigned long long int)key);
+		success = DataCube_cmphd(dataCube, "SOFIACHK", key_string, strlen(key_string));
+		DataCube_delhd(dataCube, "SOFIACHK");
+	}
+	
+	// Read source finding mask
+	BitMask *bits = NULL;
+	
+	if(success)
+	{
+		message("Loading checkpoint: %s", Path_get_file(path_mask));
+		bits = BitMask_new(DataCube_get_size(dataCube));
+		success = BitMask_read(bits, fp);
+	}
+	
+	fclose(fp);
+	
+	if(!success)
+	{
+		warning("Failed to read checkpoint; running full pipeline.");
+		DataCube_delete(dataCube);
+		BitMask_delete(bits);
+		Array_siz_delete(regions);
+		return NULL;
+	}
+	
+	Array_siz_delete(*flag_regions);
+	*flag_regions = regions;
+	*use_flagging = flags[0] ? true : false;
+	*maskBits = bits;
+	message("%zu pixels detected by source finder according to checkpoint.", BitMask_count(bits));
+	
+	return dataCube;
+}
+
+PRIVATE void checkpoint_save(Path *path_cube, Path *path_mask, const uint64_t key, DataCube *dataCube, const BitMask *maskBits, const Array_siz *flag_regions, const bool use_flagging)
+{
+	// Write data cube first, tagged with key
+	char key_string[32];
+	snprintf(key_string, sizeof(key_string), "%016llx", (unsigned long long int)key);
+	DataCube_puthd_str(dataCube, "SOFIACHK", key_string);
+	DataCube_save(dataCube, Path_get(path_cube), true, PRESERVE);
+	DataCube_delhd(dataCube, "SOFIACHK");
+	
+	// Write mask file last, so an incomplete checkpoint will not match
+	message("Creating checkpoint: %s", Path_get_file(path_mask));
+	FILE *fp = fopen(Path_get(path_mask), "wb");
+	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open output file: %s", Path_get(path_mask));
+	
+	const uint64_t flags[2] = {use_flagging ? 1 : 0, Array_siz_get_size(flag_regions)};
+	bool success = (fwrite(CHECKPOINT_MAGIC, 1, 8, fp) == 8 && fwrite(&key, sizeof(uint64_t), 1, fp) == 1 && fwrite(flags, sizeof(uint64_t), 2, fp) == 2);
+	
+	for(size_t i = 0; i < Array_siz_get_size(flag_regions) && success; ++i)
+	{
+		const uint64_t value = Array_siz_get(flag_regions, i);
+		success = (fwrite(&value, sizeof(uint64_t), 1, fp) == 1);
+	}
+	
+	ensure(success, ERR_FILE_ACCESS, "Failed to write checkpoint file: %s", Path_get(path_mask));
+	BitMask_write(maskBits, fp);
+	fclose(fp);
+	
+	return;
+}
+
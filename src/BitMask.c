@@ -0,0 +1,363 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (BitMask.c) - Source Finding Application                 //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+/// @file   BitMask.c
+/// @date   14/10/2026
+/// @brief  Class implementing a bit-packed binary mask.
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "BitMask.h"
+
+
+
+/// @brief Class implementing a bit-packed binary mask
+///
+/// The purpose of this class is to provide a compact binary mask
+/// that stores one bit per element in 64-bit words. Element `i` is
+/// stored in bit `i % 64` of word `i / 64`. Bits beyond the size of
+/// the mask in the last word are always 0.
+
+CLASS BitMask
+{
+	size_t    size;   ///< Number of elements (bits) in the mask.
+	size_t    words;  ///< Number of 64-bit words allocated.
+	uint64_t *data;   ///< Pointer to array of words.
+};
+
+
+
+/// @brief Standard constructor
+///
+/// Standard constructor. Will create a new BitMask object capable of
+/// holding `size` elements, all of which will initially be 0. Note
+/// that the destructor will need to be called explicitly once the
+/// object is no longer required to release its memory again.
+///
+/// @param size  Number of elements of the mask.
+///
+/// @return Pointer to newly created BitMask object.
+
+PUBLIC BitMask *BitMask_new(const size_t size)
+{
+	BitMask *self = (BitMask *)memory(MALLOC, 1, sizeof(BitMask));
+	
+	self->size  = size;
+	self->words = (size + BITMASK_WORD_BITS - 1) / BITMASK_WORD_BITS;
+	self->data  = self->words ? (uint64_t *)memory(CALLOC, self->words, sizeof(uint64_t)) : NULL;
+	
+	return self;
+}
+
+
+
+/// @brief Destructor
+///
+/// Destructor. Note that the destructor must be called explicitly
+/// if the object is no longer required. This will release the
+/// memory occupied by the object.
+///
+/// @param self  Object self-reference.
+
+PUBLIC void BitMask_delete(BitMask *self)
+{
+	if(self != NULL)
+	{
+		free(self->data);
+		free(self);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Return number of elements
+///
+/// Public method for returning the number of elements (bits) of the
+/// specified mask.
+///
+/// @param self  Object self-reference.
+///
+/// @return Number of elements of the mask.
+
+PUBLIC size_t BitMask_get_size(const BitMask *self)
+{
+	check_null(self);
+	return self->size;
+}
+
+
+
+/// @brief Return number of words
+///
+/// Public method for returning the number of 64-bit words used to
+/// store the specified mask.
+///
+/// @param self  Object self-reference.
+///
+/// @return Number of words of the mask.
+
+PUBLIC size_t BitMask_get_words(const BitMask *self)
+{
+	check_null(self);
+	return self->words;
+}
+
+
+
+/// @brief Check if element is set
+///
+/// Public method for checking whether the specified element of the
+/// mask is set. No bounds checking is carried out.
+///
+/// @param self   Object self-reference.
+/// @param index  Index of the element to be checked.
+///
+/// @return `true` if the element is set, `false` otherwise.
+
+PUBLIC bool BitMask_get(const BitMask *self, const size_t index)
+{
+	return (self->data[index / BITMASK_WORD_BITS] >> (index % BITMASK_WORD_BITS)) & 1u;
+}
+
+
+
+/// @brief Set element
+///
+/// Public method for setting the specified element of the mask to 1.
+/// The operation is atomic, so elements sharing the same word can be
+/// set concurrently from different threads. No bounds checking is
+/// carried out.
+///
+/// @param self   Object self-reference.
+/// @param index  Index of the element to be set.
+
+PUBLIC void BitMask_set(BitMask *self, const size_t index)
+{
+	uint64_t *word = self->data + index / BITMASK_WORD_BITS;
+	const uint64_t bit = (uint64_t)1 << (index % BITMASK_WORD_BITS);
+	
+	#pragma omp atomic update
+	*word |= bit;
+	
+	return;
+}
+
+
+
+/// @brief Return word
+///
+/// Public method for returning the 64-bit word with the specified
+/// index. This will contain elements `64 * word` to `64 * word + 63`.
+/// No bounds checking is carried out.
+///
+/// @param self  Object self-reference.
+/// @param word  Index of the word to be returned.
+///
+/// @return Requested word.
+
+PUBLIC uint64_t BitMask_get_word(const BitMask *self, const size_t word)
+{
+	return self->data[word];
+}
+
+
+
+/// @brief Set bits of word
+///
+/// Public method for setting all bits of the specified word that are
+/// set in `bits`. Bits already set will remain set. This operation is
+/// not atomic, and each word must only be written by one thread at a
+/// time. No bounds checking is carried out.
+///
+/// @param self  Object self-reference.
+/// @param word  Index of the word to be modified.
+/// @param bits  Bits to be set.
+
+PUBLIC void BitMask_set_word(BitMask *self, const size_t word, const uint64_t bits)
+{
+	self->data[word] |= bits;
+	return;
+}
+
+
+
+/// @brief Clear range of elements
+///
+/// Public method for setting all elements from `first` to `last`
+/// (inclusive) to 0. Boundaries beyond the size of the mask will be
+/// adjusted.
+///
+/// @param self   Object self-reference.
+/// @param first  Index of the first element to be cleared.
+/// @param last   Index of the last element to be cleared.
+
+PUBLIC void BitMask_clear_range(BitMask *self, const size_t first, size_t last)
+{
+	check_null(self);
+	if(last >= self->size) last = self->size - 1;
+	if(first > last) return;
+	
+	const size_t word_first = first / BITMASK_WORD_BITS;
+	const size_t word_last  = last  / BITMASK_WORD_BITS;
+	const uint64_t mask_first = ~(uint64_t)0 << (first % BITMASK_WORD_BITS);
+	const uint64_t mask_last  = ~(uint64_t)0 >> (BITMASK_WORD_BITS - 1 - last % BITMASK_WORD_BITS);
+	
+	if(word_first == word_last)
+	{
+		self->data[word_first] &= ~(mask_first & mask_last);
+		return;
+	}
+	
+	self->data[word_first] &= ~mask_first;
+	for(size_t i = word_first + 1; i < word_last; ++i) self->data[i] = 0;
+	self->data[word_last] &= ~mask_last;
+	
+	return;
+}
+
+
+
+/// @brief Merge two masks
+///
+/// Public method for setting all elements of the mask that are set
+/// in the source mask. Both masks must have the same size.
+///
+/// @param self    Object self-reference.
+/// @param source  Mask to be merged into `self`.
+
+PUBLIC void BitMask_merge(BitMask *self, const BitMask *source)
+{
+	check_null(self);
+	check_null(source);
+	ensure(self->size == source->size, ERR_USER_INPUT, "Cannot merge masks of different size.");
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t i = 0; i < self->words; ++i) self->data[i] |= source->data[i];
+	
+	return;
+}
+
+
+
+/// @brief Reset mask
+///
+/// Public method for setting all elements of the mask to 0.
+///
+/// @param self  Object self-reference.
+
+PUBLIC void BitMask_reset(BitMask *self)
+{
+	check_null(self);
+	if(self->words) memset(self->data, 0, self->words * sizeof(uint64_t));
+	return;
+}
+
+
+
+/// @brief Count set elements
+///
+/// Public method for counting the number of elements of the mask
+/// that are set.
+///
+/// @param self  Object self-reference.
+///
+/// @return Number of set elements.
+
+PUBLIC size_t BitMask_count(const BitMask *self)
+{
+	check_null(self);
+	size_t counter = 0;
+	
+	#pragma omp parallel for schedule(static) reduction(+: counter)
+	for(size_t i = 0; i < self->words; ++i)
+	{
+		uint64_t word = self->data[i];
+		while(word)
+		{
+			word &= word - 1;
+			++counter;
+		}
+	}
+	
+	return counter;
+}
+
+
+
+/// @brief Write mask to binary file
+///
+/// Public method for writing the mask to a file that has been opened
+/// for binary output. The number of elements is written first, fol-
+/// lowed by the raw 64-bit words in native byte order. The file will
+/// not be closed by this method.
+///
+/// @param self  Object self-reference.
+/// @param fp    Pointer to output file.
+
+PUBLIC void BitMask_write(const BitMask *self, FILE *fp)
+{
+	check_null(self);
+	check_null(fp);
+	
+	const uint64_t size = self->size;
+	ensure(fwrite(&size, sizeof(uint64_t), 1, fp) == 1 && fwrite(self->data, sizeof(uint64_t), self->words, fp) == self->words, ERR_FILE_ACCESS, "Failed to write bit mask to file.");
+	
+	return;
+}
+
+
+
+/// @brief Read mask from binary file
+///
+/// Public method for reading a mask previously written with
+/// BitMask_write() from a file that has been opened for binary input.
+/// The stored number of elements must match the size of the mask.
+/// The file will not be closed by this method.
+///
+/// @param self  Object self-reference.
+/// @param fp    Pointer to input file.
+///
+/// @return `true` on success, `false` if the size does not match or
+///         the file could not be read.
+
+PUBLIC bool BitMask_read(BitMask *self, FILE *fp)
+{
+	check_null(self);
+	check_null(fp);
+	
+	uint64_t size = 0;
+	if(fread(&size, sizeof(uint64_t), 1, fp) != 1 || size != self->size) return false;
+	return fread(self->data, sizeof(uint64_t), self->words, fp) == self->words;
+}
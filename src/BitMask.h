@@ -0,0 +1,77 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (BitMask.h) - Source Finding Application                 //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+/// @file   BitMask.h
+/// @date   14/10/2026
+/// @brief  Class implementing a bit-packed binary mask (header).
+
+
+#ifndef BITMASK_H
+#define BITMASK_H
+
+#include <stdint.h>
+#include "common.h"
+
+#define BITMASK_WORD_BITS 64
+
+
+// ----------------------------------------------------------------- //
+// Class 'BitMask'                                                   //
+// ----------------------------------------------------------------- //
+// The purpose of this class is to provide a compact binary mask     //
+// that stores one bit per element in 64-bit words. It is used by    //
+// the source finders for recording detected pixels at one eighth of //
+// the memory footprint of an 8-bit mask cube. Individual bits can   //
+// be set from multiple threads, while entire words can be written   //
+// by a single thread without the need for atomic operations.        //
+// ----------------------------------------------------------------- //
+
+typedef CLASS BitMask BitMask;
+
+// Constructor and destructor
+PUBLIC BitMask      *BitMask_new        (const size_t size);
+PUBLIC void          BitMask_delete     (BitMask *self);
+
+// Public methods
+PUBLIC size_t        BitMask_get_size   (const BitMask *self);
+PUBLIC size_t        BitMask_get_words  (const BitMask *self);
+PUBLIC bool          BitMask_get        (const BitMask *self, const size_t index);
+PUBLIC void          BitMask_set        (BitMask *self, const size_t index);
+PUBLIC uint64_t      BitMask_get_word   (const BitMask *self, const size_t word);
+PUBLIC void          BitMask_set_word   (BitMask *self, const size_t word, const uint64_t bits);
+PUBLIC void          BitMask_clear_range(BitMask *self, const size_t first, size_t last);
+PUBLIC void          BitMask_merge      (BitMask *self, const BitMask *source);
+PUBLIC void          BitMask_reset      (BitMask *self);
+PUBLIC size_t        BitMask_count      (const BitMask *self);
+PUBLIC void          BitMask_write      (const BitMask *self, FILE *fp);
+PUBLIC bool          BitMask_read       (BitMask *self, FILE *fp);
+
+#endif
@@ -43,6 +43,11 @@
 
 #include "Catalog.h"
 #include "String.h"
+#include "Header.h"
+#include "Map.h"
+
+/// Size of the buffer used for assembling rows of FITS binary tables (in bytes).
+#define CATALOG_FITS_BLOCK (4 * MEGABYTE)
 
 
 
@@ -55,7 +60,9 @@
 CLASS Catalog
 {
 	size_t size;       ///< Number of sources in catalogue.
+	size_t capacity;   ///< Number of sources for which memory has been allocated.
 	Source **sources;  ///< Pointer to the array of Source objects stored in the catalogue.
+	Map *index;        ///< Map of source addresses to their index in the catalogue.
 };
 
 
@@ -64,10 +71,10 @@ CLASS Catalog
 ///
 /// Standard constructor. Will create a new and empty Catalog object
 /// and return a pointer to the newly created object. No memory will
-/// be allocated other than for the object itself. Note that the
-/// destructor will need to be called explicitly once the object is
-/// no longer required to release any memory allocated during the
-/// lifetime of the object.
+/// be allocated other than for the object itself and an empty index
+/// used for looking up sources. Note that the destructor will need
+/// to be called explicitly once the object is no longer required to
+/// release any memory allocated during the lifetime of the object.
 ///
 /// @return Pointer to newly created Catalog object.
 
@@ -78,7 +85,9 @@ PUBLIC Catalog *Catalog_new(void)
 	
 	// Initialise properties
 	self->size = 0;
+	self->capacity = 0;
 	self->sources = NULL;
+	self->index = Map_new();
 	
 	return self;
 }
@@ -112,7 +121,8 @@ PUBLIC void Catalog_delete(Catalog *self)
 			free(self->sources);
 		}
 		
-		// Lastly, de-allocate memory for catalog object
+		// Lastly, de-allocate memory for index and catalog object
+		Map_delete(self->index);
 		free(self);
 	}
 	
@@ -140,6 +150,7 @@ PUBLIC void Catalog_add_source(Catalog *self, Source *src)
 	
 	Catalog_append_memory(self);
 	*(self->sources + self->size - 1) = src;
+	Map_push(self->index, (size_t)(uintptr_t)src, self->size - 1);
 	
 	return;
 }
@@ -166,12 +177,8 @@ PUBLIC size_t Catalog_get_index(const Catalog *self, const Source *src)
 	check_null(self);
 	check_null(src);
 	
-	for(size_t i = 0; i < self->size; ++i)
-	{
-		if(self->sources[i] == src) return i;
-	}
-	
-	return SIZE_MAX;
+	const size_t key = (size_t)(uintptr_t)src;
+	return Map_key_exists(self->index, key) ? Map_get_value(self->index, key) : SIZE_MAX;
 }
 
 
@@ -199,13 +206,12 @@ PUBLIC bool Catalog_source_exists(const Catalog *self, const Source *src, size_t
 	check_null(self);
 	check_null(src);
 	
-	for(size_t i = 0; i < self->size; ++i)
+	const size_t key = (size_t)(uintptr_t)src;
+	
+	if(Map_key_exists(self->index, key))
 	{
-		if(self->sources[i] == src)
-		{
-			if(index != NULL) *index = i;
-			return true;
-		}
+		if(index != NULL) *index = Map_get_value(self->index, key);
+		return true;
 	}
 	
 	return false;
@@ -255,20 +261,224 @@ PUBLIC size_t Catalog_get_size(const Catalog *self)
 
 
 
+/// @brief Merge catalogues of overlapping tiles
+///
+/// Public method for merging the catalogues of all tiles of a tiled
+/// source finding run into a single catalogue without duplicates.
+/// The catalogue must contain all sources detected in any tile, with
+/// `source_tiles` holding the tile index of each. A source touching
+/// the inner edge of its tile (i.e. an edge that is not also the edge
+/// of the region) has been truncated by the tile. Complete sources
+/// are retained only if their centroid falls within the core of their
+/// tile, which leaves exactly one copy of each. A truncated source is
+/// discarded if its bounding box is contained in that of a complete
+/// copy from another tile; if that copy was not retained because its
+/// centroid lies outside of its own core, it is retained instead.
+/// Sources not detected in full by any tile, as they are larger than
+/// the overlap, are reduced to their largest fragment, which already
+/// carries the edge flag from its tile, and a warning is printed.
+///
+/// Sources are sorted into buckets by tile, such that each truncated
+/// source is only compared with the sources of those tiles whose full
+/// extent can overlap with its bounding box, rather than with the
+/// entire catalogue.
+///
+/// @param self            Object self-reference.
+/// @param source_tiles    Tile index of each source in the catalogue,
+///                        where the index along the first axis runs
+///                        fastest.
+/// @param bounds          Region covered by the tiles, given as minimum
+///                        and maximum along each of the 3 axes.
+/// @param tile_size       Core size of the tiles along each axis.
+/// @param overlap         Overlap of the tiles along each axis.
+/// @param n_tiles         Number of tiles along each axis.
+/// @param use_pos_offset  If `true`, source positions are absolute;
+///                        otherwise, they are relative to `bounds`.
+///
+/// @return Pointer to newly created catalogue containing copies of
+///         the retained sources.
+///
+/// @note The original catalogue will not be modified.
+
+PUBLIC Catalog *Catalog_merge_tiles(const Catalog *self, const Array_siz *source_tiles, const size_t *bounds, const size_t *tile_size, const size_t *overlap, const size_t *n_tiles, const bool use_pos_offset)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(source_tiles);
+	ensure(Array_siz_get_size(source_tiles) == self->size, ERR_USER_INPUT, "Number of tile indices differs from number of sources.");
+	
+	enum {TILE_CORE, TILE_SPARE, TILE_FRAGMENT};
+	const char *bbox_names[6] = {"x_min", "x_max", "y_min", "y_max", "z_min", "z_max"};
+	const char *pos_names[3] = {"x", "y", "z"};
+	const size_t n_src = self->size;
+	const size_t n_tiles_total = n_tiles[0] * n_tiles[1] * n_tiles[2];
+	
+	unsigned char *kind = (unsigned char *)memory(MALLOC, n_src > 0 ? n_src : 1, sizeof(unsigned char));
+	size_t *bbox  = (size_t *)memory(MALLOC, n_src > 0 ? 6 * n_src : 1, sizeof(size_t));
+	bool   *keep  = (bool *)memory(CALLOC, n_src > 0 ? n_src : 1, sizeof(bool));
+	bool   *done  = (bool *)memory(CALLOC, n_src > 0 ? n_src : 1, sizeof(bool));
+	size_t *group = (size_t *)memory(MALLOC, n_src > 0 ? n_src : 1, sizeof(size_t));
+	size_t *candidates   = (size_t *)memory(MALLOC, n_src > 0 ? n_src : 1, sizeof(size_t));
+	size_t *tile_members = (size_t *)memory(MALLOC, n_src > 0 ? n_src : 1, sizeof(size_t));
+	size_t *tile_first   = (size_t *)memory(CALLOC, n_tiles_total + 1, sizeof(size_t));
+	size_t *tile_fill    = (size_t *)memory(CALLOC, n_tiles_total, sizeof(size_t));
+	
+	// Classify all sources based on their position within their tile
+	for(size_t i = 0; i < n_src; ++i)
+	{
+		const Source *src = self->sources[i];
+		const size_t tile = Array_siz_get(source_tiles, i);
+		ensure(tile < n_tiles_total, ERR_INDEX_RANGE, "Tile index out of range.");
+		const size_t index[3] = {tile % n_tiles[0], (tile / n_tiles[0]) % n_tiles[1], tile / (n_tiles[0] * n_tiles[1])};
+		size_t core_min[3], core_max[3], tile_min[3], tile_max[3];
+		tile_extent(index, bounds, tile_size, overlap, core_min, core_max, tile_min, tile_max);
+		
+		kind[i] = TILE_CORE;
+		
+		for(size_t j = 0; j < 3; ++j)
+		{
+			const size_t offset = use_pos_offset ? 0 : bounds[2 * j];
+			const double pos = Source_get_par_by_name_flt(src, pos_names[j]) + offset;
+			bbox[6 * i + 2 * j]     = Source_get_par_by_name_int(src, bbox_names[2 * j])     + offset;
+			bbox[6 * i + 2 * j + 1] = Source_get_par_by_name_int(src, bbox_names[2 * j + 1]) + offset;
+			
+			if((tile_min[j] > bounds[2 * j] && bbox[6 * i + 2 * j] <= tile_min[j])
+			|| (tile_max[j] < bounds[2 * j + 1] && bbox[6 * i + 2 * j + 1] >= tile_max[j])) kind[i] = TILE_FRAGMENT;
+			else if(kind[i] == TILE_CORE && (pos < core_min[j] - 0.5 || pos >= core_max[j] + 0.5)) kind[i] = TILE_SPARE;
+		}
+		
+		keep[i] = (kind[i] == TILE_CORE);
+		++tile_first[tile + 1];
+	}
+	
+	// Sort sources into buckets by tile, in ascending order of index
+	for(size_t t = 0; t < n_tiles_total; ++t) tile_first[t + 1] += tile_first[t];
+	for(size_t i = 0; i < n_src; ++i)
+	{
+		const size_t tile = Array_siz_get(source_tiles, i);
+		tile_members[tile_first[tile] + tile_fill[tile]++] = i;
+	}
+	
+	// Discard fragments that were detected in full by another tile
+	size_t n_unresolved = 0;
+	
+	for(size_t i = 0; i < n_src; ++i)
+	{
+		if(kind[i] != TILE_FRAGMENT) continue;
+		
+		// A complete copy must lie in a tile overlapping the fragment
+		const size_t n_cand = Catalog_tile_candidates(bbox + 6 * i, bounds, tile_size, overlap, n_tiles, tile_first, tile_members, candidates);
+		size_t spare = n_src;
+		bool resolved = false;
+		
+		for(size_t c = 0; c < n_cand && !resolved; ++c)
+		{
+			const size_t j = candidates[c];
+			if(kind[j] == TILE_FRAGMENT || Array_siz_get(source_tiles, j) == Array_siz_get(source_tiles, i)) continue;
+			
+			bool contained = true;
+			for(size_t k = 0; k < 6 && contained; k += 2) contained = bbox[6 * j + k] <= bbox[6 * i + k] && bbox[6 * j + k + 1] >= bbox[6 * i + k + 1];
+			if(!contained) continue;
+			
+			if(keep[j]) resolved = true;
+			else if(j < spare) spare = j;
+		}
+		
+		if(!resolved && spare < n_src)
+		{
+			// Retain complete copy unless an identical copy has already been retained
+			bool duplicate = false;
+			for(size_t c = 0; c < n_cand && !duplicate; ++c)
+			{
+				const size_t j = candidates[c];
+				duplicate = keep[j] && kind[j] != TILE_FRAGMENT && !memcmp(bbox + 6 * j, bbox + 6 * spare, 6 * sizeof(size_t));
+			}
+			if(!duplicate) keep[spare] = true;
+			resolved = true;
+		}
+		
+		done[i] = resolved;
+		if(!resolved) ++n_unresolved;
+	}
+	
+	// Group remaining fragments of the same source across tiles and retain the largest one
+	size_t n_truncated = 0;
+	
+	for(size_t i = 0; i < n_src && n_unresolved; ++i)
+	{
+		if(kind[i] != TILE_FRAGMENT || done[i]) continue;
+		
+		size_t n_group = 0;
+		size_t largest = i;
+		group[n_group++] = i;
+		done[i] = true;
+		
+		for(size_t m = 0; m < n_group; ++m)
+		{
+			const size_t a = group[m];
+			const size_t n_cand = Catalog_tile_candidates(bbox + 6 * a, bounds, tile_size, overlap, n_tiles, tile_first, tile_members, candidates);
+			
+			for(size_t c = 0; c < n_cand; ++c)
+			{
+				const size_t j = candidates[c];
+				if(j <= i || kind[j] != TILE_FRAGMENT || done[j] || Array_siz_get(source_tiles, j) == Array_siz_get(source_tiles, a)) continue;
+				
+				bool overlapping = true;
+				for(size_t k = 0; k < 6 && overlapping; k += 2) overlapping = bbox[6 * a + k] <= bbox[6 * j + k + 1] && bbox[6 * j + k] <= bbox[6 * a + k + 1];
+				if(!overlapping) continue;
+				
+				group[n_group++] = j;
+				done[j] = true;
+				
+				// Largest fragment, or first in catalogue if equally large
+				const long int n_pix_j = Source_get_par_by_name_int(self->sources[j], "n_pix");
+				const long int n_pix_largest = Source_get_par_by_name_int(self->sources[largest], "n_pix");
+				if(n_pix_j > n_pix_largest || (n_pix_j == n_pix_largest && j < largest)) largest = j;
+			}
+		}
+		
+		keep[largest] = true;
+		++n_truncated;
+	}
+	
+	// Copy retained sources into merged catalogue
+	Catalog *merged = Catalog_new();
+	for(size_t i = 0; i < n_src; ++i) if(keep[i]) Catalog_add_source(merged, Source_copy(self->sources[i]));
+	
+	message("%zu of %zu source candidate%s retained after merging.", merged->size, n_src, n_src == 1 ? "" : "s");
+	if(n_truncated) warning("%zu source%s larger than the tile overlap and only partially\n         detected in every tile. The largest fragment has been catalogued.\n         Please increase \'tiling.overlapXY\' or \'tiling.overlapZ\'.", n_truncated, n_truncated == 1 ? " is" : "s are");
+	
+	// Clean up
+	free(kind);
+	free(bbox);
+	free(keep);
+	free(done);
+	free(group);
+	free(candidates);
+	free(tile_members);
+	free(tile_first);
+	free(tile_fill);
+	
+	return merged;
+}
+
+
+
 /// @brief Save catalogue to file
 ///
 /// Public method for saving the current catalogue under the specified
 /// name in the specified file format. The file name will be relative to
 /// the process execution directory unless the full path to the output
 /// directory is specified. Available formats are plain text ASCII,
-/// VOTable XML format and SQL format.
+/// VOTable XML format, SQL format and FITS binary table.
 ///
 /// @param self       Object self-reference.
 /// @param filename   Full path to the output file.
 /// @param format     Output format; can be `CATALOG_FORMAT_ASCII` for
 ///                   plain text ASCII files, `CATALOG_FORMAT_XML` for
-///                   VOTable format or `CATALOG_FORMAT_SQL` for SQL
-///                   table format.
+///                   VOTable format, `CATALOG_FORMAT_SQL` for SQL
+///                   table format or `CATALOG_FORMAT_FITS` for FITS
+///                   binary table format.
 /// @param overwrite  Overwrite existing file (`true`) or not (`false`)?
 /// @param par        SoFiA parameter settings for inclusion in VOTable
 ///                   metadata. Set to NULL if not required.
@@ -304,7 +514,12 @@ PUBLIC void Catalog_save(const Catalog *self, const char *filename, const file_f
 	// Get first source to extract parameter names and units
 	Source *src0 = self->sources[0];
 	
-	if(format == CATALOG_FORMAT_XML)
+	if(format == CATALOG_FORMAT_FITS)
+	{
+		// Write FITS binary table
+		Catalog_save_fits(self, fp);
+	}
+	else if(format == CATALOG_FORMAT_XML)
 	{
 		const char *data_type_names[2] = {"long", "double"};
 		const char *indentation[7] = {"", "\t", "\t\t", "\t\t\t", "\t\t\t\t", "\t\t\t\t\t", "\t\t\t\t\t\t"}; // Better readability
@@ -472,12 +687,10 @@ PUBLIC void Catalog_save(const Catalog *self, const char *filename, const file_f
 		{
 			Source *src = self->sources[i];
 			
-			String *identifier = String_new(Source_get_identifier(src));
-			String_prepend(identifier, "\"");
-			String_append(identifier, "\"");
+			// Right-align quoted identifier without creating a copy
+			const int padding = 2 * CATALOG_COLUMN_WIDTH - 2 - (int)strlen(Source_get_identifier(src));
 			fprintf(fp, "%c", char_nocomment);
-			fprintf(fp, "%*s", 2 * CATALOG_COLUMN_WIDTH, String_get(identifier));
-			String_delete(identifier);
+			fprintf(fp, "%*s\"%s\"", padding > 0 ? padding : 0, "", Source_get_identifier(src));
 			
 			for(size_t j = 0; j < Source_get_num_par(src); ++j)
 			{
@@ -512,14 +725,220 @@ PUBLIC void Catalog_save(const Catalog *self, const char *filename, const file_f
 /// Private method for allocating additional memory for one more
 /// source in the specified catalogue. Note that this will not
 /// create a new source yet, but just allocate the memory needed
-/// to append a source at the end of the catalogue. The function
-/// should be called from public member functions that will add
-/// sources to a catalogue prior to inserting the new source.
+/// to append a source at the end of the catalogue. The capacity
+/// will be doubled whenever it is exceeded, so that adding sources
+/// takes amortised constant time. The function should be called
+/// from public member functions that will add sources to a cata-
+/// logue prior to inserting the new source.
 ///
 /// @param self  Object self-reference.
 
 PRIVATE void Catalog_append_memory(Catalog *self)
 {
-	self->sources = (Source **)memory_realloc(self->sources, ++(self->size), sizeof(Source *));
+	if(++(self->size) > self->capacity)
+	{
+		self->capacity = self->capacity ? 2 * self->capacity : 64;
+		self->sources = (Source **)memory_realloc(self->sources, self->capacity, sizeof(Source *));
+	}
+	
+	return;
+}
+
+
+
+/// @brief Write catalogue as FITS binary table
+///
+/// Private method for writing the specified catalogue to the speci-
+/// fied file as a FITS binary table. The file will consist of an
+/// empty primary HDU followed by a `BINTABLE` extension with one row
+/// per source. The first column contains the source name, followed
+/// by all source parameters as 64-bit integers (`K`) or 64-bit
+/// floating-point numbers (`D`) with their units and UCDs recorded
+/// in the `TUNITn` and `TUCDn` keywords. Rows are assembled in a
+/// buffer in big-endian byte order and written in large blocks.
+///
+/// @param self  Object self-reference.
+/// @param fp    File pointer of the output file; must be open for
+///              writing in binary mode.
+
+PRIVATE void Catalog_save_fits(const Catalog *self, FILE *fp)
+{
+	const Source *src0 = self->sources[0];
+	const size_t n_par = Source_get_num_par(src0);
+	const bool swap = is_little_endian();
+	char key[FITS_HEADER_KEYWORD_SIZE + 1];
+	char value[FITS_HEADER_VALUE_SIZE + 1];
+	const char footer[FITS_HEADER_BLOCK_SIZE] = {0};
+	
+	// Get current date and time
+	char current_time_string[32];
+	time_t current_time = time(NULL);
+	strftime(current_time_string, 32, "%Y-%m-%dT%H:%M:%S", gmtime(&current_time));
+	
+	// Determine width of name column
+	size_t name_size = 1;
+	for(size_t i = 0; i < self->size; ++i)
+	{
+		const size_t size = strlen(Source_get_identifier(self->sources[i]));
+		if(size > name_size) name_size = size;
+	}
+	
+	const size_t row_size = name_size + n_par * sizeof(int64_t);
+	
+	// Write empty primary HDU
+	Header *header = Header_blank(false);
+	Header_set_bool(header, "SIMPLE", true);
+	Header_set_int (header, "BITPIX", 8);
+	Header_set_int (header, "NAXIS",  0);
+	Header_set_bool(header, "EXTEND", true);
+	ensure(fwrite(Header_get(header), 1, Header_get_size(header), fp) == Header_get_size(header), ERR_FILE_ACCESS, "Failed to write FITS catalogue header.");
+	Header_delete(header);
+	
+	// Assemble binary table header
+	header = Header_blank(false);
+	Header_set_str (header, "XTENSION", "BINTABLE");
+	Header_set_int (header, "BITPIX",   8);
+	Header_set_int (header, "NAXIS",    2);
+	Header_set_int (header, "NAXIS1",   row_size);
+	Header_set_int (header, "NAXIS2",   self->size);
+	Header_set_int (header, "PCOUNT",   0);
+	Header_set_int (header, "GCOUNT",   1);
+	Header_set_int (header, "TFIELDS",  n_par + 1);
+	
+	snprintf(value, sizeof(value), "%zuA", name_size);
+	Header_set_str (header, "TTYPE1",   "name");
+	Header_set_str (header, "TFORM1",   value);
+	Header_set_str (header, "TUCD1",    "meta.id");
+	
+	for(size_t j = 0; j < n_par; ++j)
+	{
+		snprintf(key, sizeof(key), "TTYPE%zu", j + 2);
+		Header_set_str(header, key, Source_get_name(src0, j));
+		snprintf(key, sizeof(key), "TFORM%zu", j + 2);
+		Header_set_str(header, key, Source_get_type(src0, j) == SOURCE_TYPE_INT ? "K" : "D");
+		if(strlen(Source_get_unit(src0, j)))
+		{
+			snprintf(key, sizeof(key), "TUNIT%zu", j + 2);
+			Header_set_str(header, key, Source_get_unit(src0, j));
+		}
+		if(strlen(Source_get_ucd(src0, j)))
+		{
+			snprintf(key, sizeof(key), "TUCD%zu", j + 2);
+			Header_set_str(header, key, Source_get_ucd(src0, j));
+		}
+	}
+	
+	Header_set_str (header, "EXTNAME",  "SoFiA_source_catalogue");
+	Header_set_str (header, "ORIGIN",   SOFIA_VERSION_FULL " (" SOFIA_CREATION_DATE ")");
+	Header_set_str (header, "DATE",     current_time_string);
+	ensure(fwrite(Header_get(header), 1, Header_get_size(header), fp) == Header_get_size(header), ERR_FILE_ACCESS, "Failed to write FITS catalogue header.");
+	Header_delete(header);
+	
+	// Assemble rows in buffer and write in blocks
+	const size_t rows_per_block = row_size < CATALOG_FITS_BLOCK ? CATALOG_FITS_BLOCK / row_size : 1;
+	char *buffer = (char *)memory(MALLOC, rows_per_block, row_size);
+	
+	for(size_t first = 0; first < self->size; first += rows_per_block)
+	{
+		const size_t n_rows = (self->size - first < rows_per_block) ? self->size - first : rows_per_block;
+		
+		for(size_t i = 0; i < n_rows; ++i)
+		{
+			const Source *src = self->sources[first + i];
+			char *ptr = buffer + i * row_size;
+			
+			// Name, padded with NUL characters
+			const char *name = Source_get_identifier(src);
+			const size_t size = strlen(name);
+			memcpy(ptr, name, size);
+			memset(ptr + size, 0, name_size - size);
+			ptr += name_size;
+			
+			// Parameters
+			for(size_t j = 0; j < n_par; ++j)
+			{
+				if(Source_get_type(src, j) == SOURCE_TYPE_INT)
+				{
+					const int64_t value_int = Source_get_par_int(src, j);
+					memcpy(ptr, &value_int, sizeof(int64_t));
+				}
+				else
+				{
+					const double value_flt = Source_get_par_flt(src, j);
+					memcpy(ptr, &value_flt, sizeof(double));
+				}
+				
+				if(swap) swap_byte_order(ptr, sizeof(int64_t));
+				ptr += sizeof(int64_t);
+			}
+		}
+		
+		ensure(fwrite(buffer, row_size, n_rows, fp) == n_rows, ERR_FILE_ACCESS, "Failed to write FITS catalogue data.");
+	}
+	
+	free(buffer);
+	
+	// Pad data array to full FITS block
+	const size_t size_data = row_size * self->size;
+	const size_t size_footer = (FITS_HEADER_BLOCK_SIZE - size_data % FITS_HEADER_BLOCK_SIZE) % FITS_HEADER_BLOCK_SIZE;
+	ensure(fwrite(footer, 1, size_footer, fp) == size_footer, ERR_FILE_ACCESS, "Failed to write FITS catalogue data.");
+	
 	return;
 }
+
+
+
+/// @brief Collect sources from tiles overlapping bounding box
+///
+/// Private method for collecting the indices of all sources that
+/// belong to a tile whose full extent, including overlap, can overlap
+/// with the specified bounding box. Sources must have been sorted into
+/// buckets by tile, with the members of tile `t` stored in
+/// `tile_members[tile_first[t]]` to `tile_members[tile_first[t + 1] - 1]`.
+///
+/// @param box           Bounding box, given as minimum and maximum
+///                      along each of the 3 axes.
+/// @param bounds        Region covered by the tiles.
+/// @param tile_size     Core size of the tiles along each axis.
+/// @param overlap       Overlap of the tiles along each axis.
+/// @param n_tiles       Number of tiles along each axis.
+/// @param tile_first    Index of first bucket member of each tile.
+/// @param tile_members  Source indices sorted into buckets by tile.
+/// @param candidates    Array for holding the source indices found;
+///                      must be large enough for all sources.
+///
+/// @return Number of source indices written to `candidates`.
+
+PRIVATE size_t Catalog_tile_candidates(const size_t *box, const size_t *bounds, const size_t *tile_size, const size_t *overlap, const size_t *n_tiles, const size_t *tile_first, const size_t *tile_members, size_t *candidates)
+{
+	// Range of tile indices along each axis; the core of each such
+	// tile lies within the bounding box widened by the overlap
+	size_t lo[3], hi[3];
+	
+	for(size_t i = 0; i < 3; ++i)
+	{
+		const size_t box_min = box[2 * i] > bounds[2 * i] + overlap[i] ? box[2 * i] - overlap[i] : bounds[2 * i];
+		const size_t box_max = box[2 * i + 1] + overlap[i] > box_min ? box[2 * i + 1] + overlap[i] : box_min;
+		lo[i] = (box_min - bounds[2 * i]) / tile_size[i];
+		hi[i] = (box_max - bounds[2 * i]) / tile_size[i];
+		if(hi[i] >= n_tiles[i]) hi[i] = n_tiles[i] - 1;
+		if(lo[i] > hi[i]) lo[i] = hi[i];
+	}
+	
+	// Collect members of all tiles within range
+	size_t n_cand = 0;
+	
+	for(size_t z = lo[2]; z <= hi[2]; ++z)
+	{
+		for(size_t y = lo[1]; y <= hi[1]; ++y)
+		{
+			for(size_t x = lo[0]; x <= hi[0]; ++x)
+			{
+				const size_t tile = x + n_tiles[0] * (y + n_tiles[1] * z);
+				for(size_t m = tile_first[tile]; m < tile_first[tile + 1]; ++m) candidates[n_cand++] = tile_members[m];
+			}
+		}
+	}
+	
+	return n_cand;
+}
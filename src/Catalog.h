@@ -41,11 +41,12 @@
 #include <stdint.h>
 #include "common.h"
 #include "Source.h"
+#include "Array_siz.h"
 #include "Parameter.h"
 
 #define CATALOG_COLUMN_WIDTH 14  ///< Defines the width of each column in the plain-text SoFiA source catalogue.
 
-typedef enum {CATALOG_FORMAT_ASCII, CATALOG_FORMAT_XML, CATALOG_FORMAT_SQL} file_format;
+typedef enum {CATALOG_FORMAT_ASCII, CATALOG_FORMAT_XML, CATALOG_FORMAT_SQL, CATALOG_FORMAT_FITS} file_format;
 
 
 // ----------------------------------------------------------------- //
@@ -70,9 +71,13 @@ PUBLIC  bool     Catalog_source_exists (const Catalog *self, const Source *src,
 
 PUBLIC  size_t   Catalog_get_size      (const Catalog *self);
 
+PUBLIC  Catalog *Catalog_merge_tiles   (const Catalog *self, const Array_siz *source_tiles, const size_t *bounds, const size_t *tile_size, const size_t *overlap, const size_t *n_tiles, const bool use_pos_offset);
+
 PUBLIC  void     Catalog_save          (const Catalog *self, const char *filename, const file_format format, const bool overwrite, const Parameter *par);
 
 // Private methods
 PRIVATE void     Catalog_append_memory (Catalog *self);
+PRIVATE void     Catalog_save_fits     (const Catalog *self, FILE *fp);
+PRIVATE size_t   Catalog_tile_candidates(const size_t *box, const size_t *bounds, const size_t *tile_size, const size_t *overlap, const size_t *n_tiles, const size_t *tile_first, const size_t *tile_members, size_t *candidates);
 
 #endif
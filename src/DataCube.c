@@ -35,6 +35,16 @@
 /// @brief  Class for storage, source finding and parameterisation of FITS data cubes.
 
 
+// NOTE: Required for pread() when compiling with --std=c99.
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+// NOTE: Required for MADV_HUGEPAGE when compiling with --std=c99.
+#ifndef _DEFAULT_SOURCE
+	#define _DEFAULT_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -42,17 +52,40 @@
 #include <math.h>
 #include <stdint.h>
 #include <limits.h>
+#include <errno.h>
 
 #ifdef _OPENMP
 	#include <omp.h>
 #endif
 
+// WARNING: The following will only work on POSIX-compliant
+//          systems, but is needed for mmap() and pread().
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "DataCube.h"
 #include "Table.h"
 #include "Source.h"
 #include "statistics_flt.h"
 #include "statistics_dbl.h"
 
+/// Size of the staging buffer used for byte swapping when writing FITS files (in bytes).
+/// Must be a multiple of the largest word size of 8 bytes.
+#define DATACUBE_WRITE_CHUNK (8 * MEGABYTE)
+
+/// Maximum number of sources dilated in parallel in a single batch.
+#define DATACUBE_DILATION_BATCH 256
+
+/// Number of adjacent spectra processed together in continuum subtraction.
+#define DATACUBE_CONTSUB_BLOCK 64
+
+/// Alignment of data arrays backed by transparent huge pages (in bytes).
+/// Arrays smaller than this will always be allocated from the heap.
+#define DATACUBE_HUGE_PAGE (2 * MEGABYTE)
+
+/// Request huge-page backing for cube-sized data arrays (see DataCube_set_huge_pages()).
+PRIVATE bool DataCube_huge_pages = false;
 
 
 // ----------------------------------------------------------------- //
@@ -108,6 +141,13 @@ CLASS DataCube
 	int     word_size;     ///< Size of a single datum in multiples of `sizeof(char)`.
 	size_t  dimension;     ///< Dimension of the cube (1-4).
 	size_t  axis_size[4];  ///< Size of the up-to-four axes of the cube.
+	char   *map;           ///< Pointer to memory-mapped FITS file in read-only mode (`NULL` if not mapped).
+	size_t  map_size;      ///< Size of the memory-mapped file in bytes.
+	size_t  map_axis[2];   ///< Size of the first two axes of the full cube in the mapped file.
+	size_t  map_origin[3]; ///< Origin of the mapped region within the full cube.
+	double  map_bscale;    ///< BSCALE value to be applied to mapped data values.
+	double  map_bzero;     ///< BZERO value to be applied to mapped data values.
+	bool    external;      ///< `true` if data array is owned by the caller and must not be released.
 	bool    verbosity;     ///< Verbosity level (0 or 1).
 };
 
@@ -141,6 +181,11 @@ PUBLIC DataCube *DataCube_new(const bool verbosity)
 	self->axis_size[1] = 0;
 	self->axis_size[2] = 0;
 	self->axis_size[3] = 0;
+	self->map          = NULL;
+	self->map_size     = 0;
+	self->map_bscale   = 1.0;
+	self->map_bzero    = 0.0;
+	self->external     = false;
 	
 	self->verbosity = verbosity;
 	
@@ -166,6 +211,7 @@ PUBLIC DataCube *DataCube_copy(const DataCube *source)
 {
 	// Sanity checks
 	check_null(source);
+	ensure(source->map == NULL, ERR_USER_INPUT, "Cannot copy memory-mapped data cube.");
 	
 	DataCube *self = DataCube_new(source->verbosity);
 	
@@ -173,8 +219,7 @@ PUBLIC DataCube *DataCube_copy(const DataCube *source)
 	self->header = Header_copy(source->header);
 	
 	// Copy data
-	self->data = (char *)memory(MALLOC, source->data_size, source->word_size * sizeof(char));
-	memcpy(self->data, source->data, source->word_size * source->data_size);
+	self->data = DataCube_allocate(source->axis_size[2], source->axis_size[0] * source->axis_size[1] * source->word_size, source->data);
 	
 	// Copy remaining properties
 	self->data_size    = source->data_size;
@@ -234,7 +279,7 @@ PUBLIC DataCube *DataCube_blank(const size_t nx, const size_t ny, const size_t n
 	strftime(current_time_string, 32, "%Y-%m-%dT%H:%M:%S", gmtime(&current_time));
 	
 	// Create data array filled with 0
-	self->data = (char *)memory(CALLOC, self->data_size, self->word_size * sizeof(char));
+	self->data = DataCube_allocate(nz, nx * ny * self->word_size, NULL);
 	
 	// Create empty header (single block with just the END keyword)
 	self->header = Header_blank(verbosity);
@@ -276,6 +321,76 @@ PUBLIC DataCube *DataCube_blank(const size_t nx, const size_t ny, const size_t n
 
 
 
+/// @brief Variant of standard constructor for external data
+///
+/// Alternative standard constructor. Will create a new DataCube
+/// object that wraps an existing data array owned by the caller
+/// without copying it. This allows data cubes already held in
+/// memory by another application to be processed directly. All
+/// operations will act on the external array, which must remain
+/// valid for the lifetime of the object and will not be released
+/// by the destructor. The array must be stored in FITS order, i.e.
+/// with the first axis varying fastest, and in native byte order.
+/// The header will be copied, and its BITPIX and NAXIS keywords
+/// will be updated to match the data array. A pointer to the newly
+/// created object will be returned. Note that the destructor will
+/// need to be called explicitly once the object is no longer
+/// required to release any memory allocated to the object.
+///
+/// @param data       Pointer to external data array.
+/// @param nx         Size of first axis of data array.
+/// @param ny         Size of second axis of data array.
+/// @param nz         Size of third axis of data array.
+/// @param type       Standard FITS data type (-64, -32, 8, 16,
+///                   32 or 64).
+/// @param header     Header to be copied into the new object.
+/// @param verbosity  Verbosity level of the new object.
+///
+/// @return Pointer to newly created DataCube object.
+
+PUBLIC DataCube *DataCube_wrap(void *data, const size_t nx, const size_t ny, const size_t nz, const int type, const Header *header, const bool verbosity)
+{
+	// Sanity checks
+	check_null(data);
+	check_null(header);
+	ensure(nx > 0 && ny > 0 && nz > 0, ERR_USER_INPUT, "Illegal data cube size of (%zu, %zu, %zu) requested.", nx, ny, nz);
+	ensure(abs(type) == 64 || abs(type) == 32 || type == 8 || type == 16, ERR_USER_INPUT, "Invalid FITS data type of %d requested.", type);
+	
+	DataCube *self = DataCube_new(verbosity);
+	
+	// Set up properties
+	self->data         = (char *)data;
+	self->external     = true;
+	self->data_size    = nx * ny * nz;
+	self->data_type    = type;
+	self->word_size    = abs(type / 8);
+	self->dimension    = nz > 1 ? 3 : (ny > 1 ? 2 : 1);
+	self->axis_size[0] = nx;
+	self->axis_size[1] = ny;
+	self->axis_size[2] = nz;
+	self->axis_size[3] = 0;
+	
+	// Copy header and ensure that it matches data array
+	self->header = Header_copy(header);
+	Header_set_int(self->header, "BITPIX", self->data_type);
+	Header_set_int(self->header, "NAXIS",  self->dimension);
+	Header_set_int(self->header, "NAXIS1", self->axis_size[0]);
+	if(self->dimension > 1) Header_set_int (self->header, "NAXIS2", self->axis_size[1]);
+	if(self->dimension > 2) Header_set_int (self->header, "NAXIS3", self->axis_size[2]);
+	
+	// Floating-point data are assumed to be scaled already
+	if(self->data_type < 0)
+	{
+		Header_remove(self->header, "BSCALE");
+		Header_remove(self->header, "BZERO");
+		Header_remove(self->header, "BLANK");
+	}
+	
+	return self;
+}
+
+
+
 /// @brief Destructor
 ///
 /// Destructor. Note that the destructor must be called explicitly
@@ -289,7 +404,8 @@ PUBLIC void DataCube_delete(DataCube *self)
 	if(self != NULL)
 	{
 		Header_delete(self->header);
-		free(self->data);
+		if(self->map != NULL) munmap(self->map, self->map_size);
+		else if(!self->external) free(self->data);
 		free(self);
 	}
 	
@@ -298,6 +414,25 @@ PUBLIC void DataCube_delete(DataCube *self)
 
 
 
+/// @brief Enable or disable huge pages for data arrays
+///
+/// Public function for requesting that the data arrays of all data
+/// cubes subsequently created or loaded be backed by transparent huge
+/// pages where supported by the operating system. This can reduce the
+/// number of TLB misses when processing large cubes. Only arrays of at
+/// least `DATACUBE_HUGE_PAGE` bytes will be affected. The setting ap-
+/// plies to the entire process and is disabled by default.
+///
+/// @param enable  If `true`, huge pages will be requested.
+
+PUBLIC void DataCube_set_huge_pages(const bool enable)
+{
+	DataCube_huge_pages = enable;
+	return;
+}
+
+
+
 /// @brief Get data array size
 ///
 /// Public method for retrieving the size of the data array of the
@@ -356,6 +491,8 @@ PUBLIC void DataCube_load(DataCube *self, const char *filename, const Array_siz
 	check_null(self);
 	check_null(filename);
 	ensure(strlen(filename), ERR_USER_INPUT, "Empty file name provided.");
+	ensure(self->map == NULL, ERR_USER_INPUT, "Cannot load data into memory-mapped data cube.");
+	ensure(!self->external, ERR_USER_INPUT, "Cannot load data into externally owned data array.");
 	
 	// Check region specification
 	if(region != NULL)
@@ -369,116 +506,8 @@ PUBLIC void DataCube_load(DataCube *self, const char *filename, const Array_siz
 	FILE *fp = fopen(filename, "rb");
 	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open FITS file \'%s\'.", filename);
 		
-	// Read entire header into temporary array
-	char *header = NULL;
-	size_t header_size = 0;
-	bool end_reached = false;
-	
-	while(!end_reached)
-	{
-		// (Re-)allocate memory as needed
-		header = (char *)memory_realloc(header, header_size + FITS_HEADER_BLOCK_SIZE, sizeof(char));
-		
-		// Read header block
-		ensure(fread(header + header_size, 1, FITS_HEADER_BLOCK_SIZE, fp) == FITS_HEADER_BLOCK_SIZE, ERR_FILE_ACCESS, "FITS file ended unexpectedly while reading header.");
-		
-		// Check if we have reached the end of the header
-		char *ptr = header + header_size;
-		
-		while(!end_reached && ptr < header + header_size + FITS_HEADER_BLOCK_SIZE)
-		{
-			if(strncmp(ptr, "END", 3) == 0) end_reached = true;
-			else ptr += FITS_HEADER_LINE_SIZE;
-		}
-		
-		// Set header size parameter
-		header_size += FITS_HEADER_BLOCK_SIZE;
-	}
-	
-	// Check if valid FITS file
-	ensure(strncmp(header, "SIMPLE", 6) == 0, ERR_USER_INPUT, "Missing \'SIMPLE\' keyword; file does not appear to be a FITS file.");
-	
-	// Create Header object and de-allocate memory again
-	self->header = Header_new(header, header_size, self->verbosity);
-	free(header);
-	
-	// Extract crucial header elements
-	self->data_type    = Header_get_int(self->header, "BITPIX");
-	self->dimension    = Header_get_int(self->header, "NAXIS");
-	self->axis_size[0] = Header_get_int(self->header, "NAXIS1");
-	self->axis_size[1] = Header_get_int(self->header, "NAXIS2");
-	self->axis_size[2] = Header_get_int(self->header, "NAXIS3");
-	self->axis_size[3] = Header_get_int(self->header, "NAXIS4");
-	self->word_size    = abs(self->data_type) / 8;             // WARNING: Assumes 8 bits per char; see CHAR_BIT in limits.h.
-	self->data_size    = self->axis_size[0];
-	for(size_t i = 1; i < self->dimension; ++i) self->data_size *= self->axis_size[i];
-	
-	// Sanity checks
-	ensure(self->data_type == -64
-		|| self->data_type == -32
-		|| self->data_type == 8
-		|| self->data_type == 16
-		|| self->data_type == 32
-		|| self->data_type == 64,
-		ERR_USER_INPUT, "Invalid BITPIX keyword encountered.");
-	
-	ensure(self->dimension > 0
-		&& self->dimension < 5,
-		ERR_USER_INPUT, "Only FITS files with 1-4 dimensions are supported.");
-	
-	ensure(self->dimension < 4
-		|| self->axis_size[3] == 1
-		|| self->axis_size[2] == 1,
-		ERR_USER_INPUT, "The size of the 3rd or 4th axis must be 1.");
-	
-	ensure(self->data_size > 0,
-		ERR_USER_INPUT, "Invalid NAXISn keyword encountered.");
-	
-	if(self->dimension < 3) self->axis_size[2] = 1;
-	if(self->dimension < 2) self->axis_size[1] = 1;
-	
-	// Swap third and fourth axis header keywords if necessary
-	if(self->dimension == 4 && self->axis_size[2] == 1 && self->axis_size[3] > 1)
-	{
-		warning("Swapping order of 3rd and 4th axis of 4D cube.");
-		
-		double tmp;
-		size_t tmp2;
-		String *str3, *str4;
-		
-		tmp2 = self->axis_size[2];
-		self->axis_size[2] = self->axis_size[3];
-		self->axis_size[3] = tmp2;
-		
-		Header_set_int(self->header, "NAXIS3", Header_get_int(self->header, "NAXIS4"));
-		Header_set_int(self->header, "NAXIS4", 1);
-		
-		tmp = Header_get_flt(self->header, "CRPIX3");
-		Header_set_flt(self->header, "CRPIX3", Header_get_flt(self->header, "CRPIX4"));
-		Header_set_flt(self->header, "CRPIX4", tmp);
-		
-		tmp = Header_get_flt(self->header, "CRVAL3");
-		Header_set_flt(self->header, "CRVAL3", Header_get_flt(self->header, "CRVAL4"));
-		Header_set_flt(self->header, "CRVAL4", tmp);
-		
-		tmp = Header_get_flt(self->header, "CDELT3");
-		Header_set_flt(self->header, "CDELT3", Header_get_flt(self->header, "CDELT4"));
-		Header_set_flt(self->header, "CDELT4", tmp);
-		
-		str3 = Header_get_string(self->header, "CTYPE3");
-		str4 = Header_get_string(self->header, "CTYPE4");
-		Header_set_str(self->header, "CTYPE3", String_get(str4));
-		Header_set_str(self->header, "CTYPE4", String_get(str3));
-		String_delete(str3);
-		String_delete(str4);
-		
-		str3 = Header_get_string(self->header, "CUNIT3");
-		str4 = Header_get_string(self->header, "CUNIT4");
-		Header_set_str(self->header, "CUNIT3", String_get(str4));
-		Header_set_str(self->header, "CUNIT4", String_get(str3));
-		String_delete(str3);
-		String_delete(str4);
-	}
+	// Read and parse header
+	DataCube_read_header(self, fp);
 	
 	// Work out region
 	const size_t x_min = (region != NULL && Array_siz_get(region, 0) > 0) ? Array_siz_get(region, 0) : 0;
@@ -504,7 +533,11 @@ PUBLIC void DataCube_load(DataCube *self, const char *filename, const Array_siz
 	message("  Memory used:  %.1f MB", (double)(region_size * self->word_size) / MEGABYTE);
 	
 	// Allocate memory for data array
-	self->data = (char *)memory_realloc(self->data, region_size, self->word_size * sizeof(char));
+	// NOTE: The array is zeroed plane by plane in parallel, so that pages
+	//       are placed close to the threads that will later process them
+	//       rather than all on the node of the thread reading the file.
+	free(self->data);
+	self->data = DataCube_allocate(region_nz, region_nx * region_ny * self->word_size, NULL);
 	
 	// Read data
 	if(region == NULL)
@@ -515,42 +548,68 @@ PUBLIC void DataCube_load(DataCube *self, const char *filename, const Array_siz
 	else
 	{
 		// Region supplied -> read sub-cube
-		char *ptr_data = self->data;
+		// NOTE: Image planes are read in parallel with positioned reads
+		//       from the underlying file descriptor, starting from the
+		//       first pixel of the region in each plane. If the region
+		//       spans the full width of the cube, the required rows are
+		//       contiguous in the file and read straight into the data
+		//       array; otherwise, only the span from the first to the
+		//       last pixel of the region is read into a buffer. Byte
+		//       swapping is applied to each plane right after reading.
+		const int fd = fileno(fp);
 		const size_t fp_start = (size_t)ftell(fp); // Start position of data array in file
-		
-		// Create buffer for a single set of image rows
-		const size_t buffer_size = self->axis_size[0] * region_ny;
-		char *buffer = (char *)memory(MALLOC, buffer_size, self->word_size * sizeof(char));
+		const bool full_rows = (region_nx == self->axis_size[0]);
+		const bool swap = is_little_endian() && self->word_size > 1;
 		
 		const size_t bytes_per_data_row = self->axis_size[0] * self->word_size;
 		const size_t bytes_per_region_row = region_nx * self->word_size;
+		const size_t bytes_per_region_plane = bytes_per_region_row * region_ny;
+		const size_t bytes_per_span = bytes_per_data_row * (region_ny - 1) + bytes_per_region_row;
 		
-		// Read relevant data segments
-		for(size_t z = z_min; z <= z_max; ++z)
+		// Number of planes read so far (for progress bar)
+		size_t n_done = 0;
+		
+		#pragma omp parallel
 		{
-			progress_bar("Progress: ", z - z_min, z_max - z_min);
-			
-			// Point file pointer to start of image segment to be read
-			ensure(!fseek(fp, fp_start + DataCube_get_index(self, 0, y_min, z) * self->word_size, SEEK_SET), ERR_FILE_ACCESS, "Error while reading FITS file.");
-			
-			// Read image plane into buffer
-			ensure(fread(buffer, self->word_size, buffer_size, fp) == buffer_size, ERR_FILE_ACCESS, "FITS file ended unexpectedly while reading data.");
+			// Create buffer for a single span of image rows
+			char *buffer = full_rows ? NULL : (char *)memory(MALLOC, bytes_per_span, sizeof(char));
 			
-			// Point to start of first row to be extracted
-			char *ptr_buffer = buffer + x_min * self->word_size;
-			
-			// Copy relevant segments into data array
-			for(size_t y = y_min; y <= y_max; ++y)
+			#pragma omp for schedule(dynamic)
+			for(size_t z = z_min; z <= z_max; ++z)
 			{
-				memcpy(ptr_data, ptr_buffer, bytes_per_region_row);
-				ptr_buffer += bytes_per_data_row;
-				ptr_data   += bytes_per_region_row;
+				char *ptr_data = self->data + (z - z_min) * bytes_per_region_plane;
+				const size_t offset = fp_start + DataCube_get_index(self, x_min, y_min, z) * self->word_size;
+				
+				if(full_rows)
+				{
+					// Read image plane directly into data array
+					DataCube_read_block(fd, ptr_data, bytes_per_region_plane, offset);
+				}
+				else
+				{
+					// Read span of image rows into buffer
+					DataCube_read_block(fd, buffer, bytes_per_span, offset);
+					
+					// Copy relevant segments into data array
+					const char *ptr_buffer = buffer;
+					for(size_t y = 0; y < region_ny; ++y)
+					{
+						memcpy(ptr_data + y * bytes_per_region_row, ptr_buffer, bytes_per_region_row);
+						ptr_buffer += bytes_per_data_row;
+					}
+				}
+				
+				// Swap byte order of image plane if required
+				if(swap) for(size_t i = 0; i < bytes_per_region_plane; i += self->word_size) swap_byte_order(ptr_data + i, self->word_size);
+				
+				#pragma omp critical
+				progress_bar("Progress: ", n_done++, region_nz - 1);
 			}
+			
+			// Delete buffer again
+			free(buffer);
 		}
 		
-		// Delete buffer again
-		free(buffer);
-		
 		// Update object properties
 		// NOTE: This must happen after reading the sub-cube, as the full
 		///     cube dimensions must be known during data extraction.
@@ -566,8 +625,8 @@ PUBLIC void DataCube_load(DataCube *self, const char *filename, const Array_siz
 	// Close FITS file
 	fclose(fp);
 	
-	// Swap byte order if required
-	DataCube_swap_byte_order(self);
+	// Swap byte order if required (already done for sub-cubes)
+	if(region == NULL) DataCube_swap_byte_order(self);
 	
 	// Handle BSCALE and BZERO if necessary
 	const double bscale = Header_get_flt(self->header, "BSCALE");
@@ -593,44 +652,7 @@ PUBLIC void DataCube_load(DataCube *self, const char *filename, const Array_siz
 		{
 			// Integer data; conversion to 32-bit floating-point data required
 			warning("Applying non-trivial BSCALE and BZERO to integer data\n         and converting to 32-bit floating-point type.");
-			
-			// Create 32-bit array
-			float *data_copy = (float *)memory(MALLOC, self->axis_size[0] * self->axis_size[1] * self->axis_size[2], sizeof(float));
-			float *ptr = data_copy;
-			
-			// Check for blanking value
-			const bool blanking_required = (Header_check(self->header, "BLANK") > 0);
-			const long int blanking_value = blanking_required ? Header_get_int(self->header, "BLANK") : 0;
-			long int value;
-			
-			// Copy scaled data over
-			for(size_t z = 0; z < self->axis_size[2]; ++z)
-			{
-				for(size_t y = 0; y < self->axis_size[1]; ++y)
-				{
-					for(size_t x = 0; x < self->axis_size[0]; ++x)
-					{
-						value = DataCube_get_data_int(self, x, y, z);
-						if(blanking_required && blanking_value == value) *ptr = NAN;
-						else *ptr = bzero + bscale * value;
-						++ptr;
-					}
-				}
-			}
-			
-			// Delete original array and point to new copy instead
-			free(self->data);
-			self->data = (char *)data_copy;
-			
-			// Update header
-			Header_set_int(self->header, "BITPIX", -32);
-			Header_remove(self->header, "BSCALE");
-			Header_remove(self->header, "BZERO");
-			Header_remove(self->header, "BLANK");
-			
-			// Update object properties
-			self->data_type = -32;
-			self->word_size = 4;
+			DataCube_convert_int(self, bscale, bzero);
 		}
 	}
 	
@@ -639,80 +661,414 @@ PUBLIC void DataCube_load(DataCube *self, const char *filename, const Array_siz
 
 
 
-/// @brief Write data cube into FITS file
+/// @brief Convert data cube to single precision
 ///
-/// Public method for writing the current data cube object
-/// (referenced by `self`) into a FITS file. The function will
-/// terminate the current programme execution if an error is
-/// encountered during the write process. If the output file
-/// already exists, it will be overwritten only if overwrite
-/// is set to true.
+/// Public method for converting the data array of the specified data
+/// cube to 32-bit floating-point type in order to reduce its memory
+/// footprint. Double-precision data will be converted in place, and
+/// the memory released by the conversion will be returned to the
+/// system afterwards. Integer data will be converted into a new array,
+/// with any blanking value specified by the `BLANK` keyword being
+/// replaced by `NaN`. The conversion is not supported for memory-mapped
+/// or externally owned data arrays. Single-precision data will remain
+/// unchanged.
 ///
-/// @param self        Object self-reference.
-/// @param filename    Name of output FITS file.
-/// @param overwrite   If `true`, overwrite existing file. Otherwise
-///                    terminate if the file already exists.
-/// @param preserve    If `true`, ensure that the data array is in the
-///                    correct byte order after returning. If `false`,
-///                    the byte order may be corrupted, which may be
-///                    faster and acceptable if the data are no
-///                    longer needed afterwards.
+/// @param self  Object self-reference.
 
-PUBLIC void DataCube_save(const DataCube *self, const char *filename, const bool overwrite, const bool preserve)
+PUBLIC void DataCube_convert_single(DataCube *self)
 {
 	// Sanity checks
 	check_null(self);
-	check_null(filename);
-	ensure(strlen(filename), ERR_USER_INPUT, "Empty file name provided.");
-	
-	// Open FITS file
-	FILE *fp;
-	if(overwrite) fp = fopen(filename, "wb");
-	else fp = fopen(filename, "wxb");
-	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to create new FITS file: %s\n       Does the destination exist and is writeable?", filename);
-	
-	message("Creating FITS file: %s", strrchr(filename, '/') == NULL ? filename : strrchr(filename, '/') + 1);
-	
-	// Write entire header
-	ensure(fwrite(Header_get(self->header), 1, Header_get_size(self->header), fp) == Header_get_size(self->header), ERR_FILE_ACCESS, "Failed to write header to FITS file.");
+	check_null(self->data);
+	ensure(self->map == NULL, ERR_USER_INPUT, "Cannot convert memory-mapped data cube.");
+	ensure(!self->external, ERR_USER_INPUT, "Cannot convert externally owned data array.");
 	
-	// Swap byte order of array in memory if necessary
-	DataCube_swap_byte_order(self);
+	if(self->data_type == -32) return;
 	
-	// Write entire data array
-	ensure(fwrite(self->data, self->word_size, self->data_size, fp) == self->data_size, ERR_FILE_ACCESS, "Failed to write data to FITS file.");
+	message("Converting data to 32-bit floating-point type (%.1f MB).", (double)(self->data_size * sizeof(float)) / MEGABYTE);
 	
-	// Fill file with 0x00 if necessary
-	const size_t size_footer = ((self->data_size * self->word_size) % FITS_HEADER_BLOCK_SIZE);
-	if(size_footer)
+	if(self->data_type == -64)
 	{
-		const char footer = '\0';
-		for(size_t counter = FITS_HEADER_BLOCK_SIZE - size_footer; counter--;) fwrite(&footer, 1, 1, fp);
+		// Double precision; convert in place
+		// NOTE: This must be done sequentially from the start of the
+		//       array, as each float overwrites part of a double that
+		//       has already been read.
+		const double *ptr_src = (double *)(self->data);
+		float *ptr_dst = (float *)(self->data);
+		for(size_t i = 0; i < self->data_size; ++i) ptr_dst[i] = ptr_src[i];
+		
+		// Release memory no longer needed
+		self->data = (char *)memory_realloc(self->data, self->data_size, sizeof(float));
+		
+		// Update header and object properties
+		Header_set_int(self->header, "BITPIX", -32);
+		self->data_type = -32;
+		self->word_size = 4;
 	}
-	
-	// Close file
-	fclose(fp);
-	
-	// Revert to original byte order if necessary and requested
-	if(preserve) DataCube_swap_byte_order(self);
+	else DataCube_convert_int(self, 1.0, 0.0);
 	
 	return;
 }
 
 
 
-/// @brief Wrapper around commonly needed Header method
+/// @brief Convert integer data cube to single precision
 ///
-/// See Header_get_int() in class Header for detailed information on
-/// the respective method and its arguments and return value.
-
-PUBLIC long int DataCube_gethd_int(const DataCube *self, const char *key) {
-	return Header_get_int(self->header, key);
-}
-
-/// @brief Wrapper around commonly needed Header method
+/// Private method for converting the integer data array of the
+/// specified data cube into a new 32-bit floating-point array, while
+/// applying the specified scale factor and offset. Any blanking value
+/// specified by the `BLANK` keyword will be replaced by `NaN`. The
+/// `BSCALE`, `BZERO` and `BLANK` keywords will be removed from the
+/// header afterwards.
 ///
-/// See Header_get_flt() in class Header for detailed information on
+/// @param self    Object self-reference.
+/// @param bscale  Scale factor to be applied to data values.
+/// @param bzero   Offset to be added to scaled data values.
+
+PRIVATE void DataCube_convert_int(DataCube *self, const double bscale, const double bzero)
+{
+	// Create 32-bit array
+	float *data_copy = (float *)memory(MALLOC, self->axis_size[0] * self->axis_size[1] * self->axis_size[2], sizeof(float));
+	float *ptr = data_copy;
+	
+	// Check for blanking value
+	const bool blanking_required = (Header_check(self->header, "BLANK") > 0);
+	const long int blanking_value = blanking_required ? Header_get_int(self->header, "BLANK") : 0;
+	long int value;
+	
+	// Copy scaled data over
+	for(size_t z = 0; z < self->axis_size[2]; ++z)
+	{
+		for(size_t y = 0; y < self->axis_size[1]; ++y)
+		{
+			for(size_t x = 0; x < self->axis_size[0]; ++x)
+			{
+				value = DataCube_get_data_int(self, x, y, z);
+				if(blanking_required && blanking_value == value) *ptr = NAN;
+				else *ptr = bzero + bscale * value;
+				++ptr;
+			}
+		}
+	}
+	
+	// Delete original array and point to new copy instead
+	free(self->data);
+	self->data = (char *)data_copy;
+	
+	// Update header
+	Header_set_int(self->header, "BITPIX", -32);
+	Header_remove(self->header, "BSCALE");
+	Header_remove(self->header, "BZERO");
+	Header_remove(self->header, "BLANK");
+	
+	// Update object properties
+	self->data_type = -32;
+	self->word_size = 4;
+	
+	return;
+}
+
+
+
+/// @brief Read header of FITS file
+///
+/// Public method for reading only the header of a FITS file without
+/// loading any data. The header and axis sizes of the object will
+/// be set according to the header of the file, thus allowing the
+/// full cube dimensions to be queried without the memory overhead
+/// of reading the data array. The data array will be left unset.
+///
+/// @param self      Object self-reference.
+/// @param filename  Name of the input FITS file.
+
+PUBLIC void DataCube_load_header(DataCube *self, const char *filename)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(filename);
+	ensure(strlen(filename), ERR_USER_INPUT, "Empty file name provided.");
+	ensure(self->data == NULL, ERR_USER_INPUT, "Data cube already contains data.");
+	
+	// Open FITS file
+	message("Opening FITS file \'%s\'.", filename);
+	FILE *fp = fopen(filename, "rb");
+	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open FITS file \'%s\'.", filename);
+	
+	// Read and parse header
+	DataCube_read_header(self, fp);
+	
+	// Close FITS file
+	fclose(fp);
+	
+	return;
+}
+
+
+
+/// @brief Wait for image planes to arrive in FITS file
+///
+/// Public method for waiting until a FITS file that is still being
+/// written, e.g. channel by channel by a correlator or imager, con-
+/// tains all image planes up to and including the specified plane.
+/// The header must already be complete and must specify the final
+/// size of the cube. The size of the file will be checked once per
+/// second, and the process will be terminated if the file has not
+/// grown for the specified number of seconds while the requested
+/// planes are still missing. As with DataCube_load_header(), only
+/// the header will be read into the object, which must not already
+/// contain a header or data.
+///
+/// @param self      Object self-reference.
+/// @param filename  Name of the input FITS file.
+/// @param z_max     Last image plane that must be available.
+/// @param timeout   Maximum time to wait for the file to grow (in
+///                  seconds).
+
+PUBLIC void DataCube_wait_for_planes(DataCube *self, const char *filename, const size_t z_max, const unsigned int timeout)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(filename);
+	ensure(strlen(filename), ERR_USER_INPUT, "Empty file name provided.");
+	ensure(self->data == NULL && self->header == NULL, ERR_USER_INPUT, "Data cube already contains data.");
+	
+	// Read header to determine required file size
+	FILE *fp = fopen(filename, "rb");
+	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open FITS file \'%s\'.", filename);
+	DataCube_read_header(self, fp);
+	const size_t fp_start = (size_t)ftell(fp);
+	fclose(fp);
+	
+	ensure(z_max < self->axis_size[2], ERR_INDEX_RANGE, "Requested image plane outside of data cube.");
+	const size_t required = fp_start + (z_max + 1) * self->axis_size[0] * self->axis_size[1] * self->word_size;
+	
+	// Poll size of file until requested planes are available
+	struct stat file_info;
+	off_t last_size = -1;
+	time_t last_change = time(NULL);
+	bool waiting = false;
+	
+	while(true)
+	{
+		ensure(stat(filename, &file_info) == 0, ERR_FILE_ACCESS, "Failed to access FITS file \'%s\'.", filename);
+		if((size_t)file_info.st_size >= required) break;
+		
+		if(file_info.st_size != last_size)
+		{
+			last_size = file_info.st_size;
+			last_change = time(NULL);
+		}
+		else ensure(difftime(time(NULL), last_change) < timeout, ERR_FILE_ACCESS, "No new data received for %u s while waiting for\n       image plane %zu of \'%s\'.", timeout, z_max, filename);
+		
+		if(!waiting) message("Waiting for image planes up to %zu to arrive.", z_max);
+		waiting = true;
+		sleep(1);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Memory-map data cube from FITS file
+///
+/// Public method for opening a FITS file in read-only, memory-mapped
+/// mode. Instead of reading the entire data array into memory, the
+/// file will be mapped into the address space of the process, and
+/// pages will only be read from disk when they are first accessed.
+/// If a region is specified, only the pages covering that region
+/// will be touched. No byte-order conversion of the data array will
+/// take place; instead, values will be byte-swapped on the fly when
+/// read. Memory-mapped cubes are read-only and currently only sup-
+/// ported as the divisor in DataCube_divide() and as the weights cube
+/// in DataCube_apply_weights(). Only floating-point data are supported.
+///
+/// @param self      Object self-reference.
+/// @param filename  Name of the input FITS file.
+/// @param region    Array of 6 values denoting a region of the cube
+///                  to be mapped (format: `x_min`, `x_max`, `y_min`,
+///                  `y_max`, `z_min`, `z_max`). Set to `NULL` to map
+///                  entire data cube.
+
+PUBLIC void DataCube_map(DataCube *self, const char *filename, const Array_siz *region)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(filename);
+	ensure(strlen(filename), ERR_USER_INPUT, "Empty file name provided.");
+	ensure(self->data == NULL, ERR_USER_INPUT, "Data cube already contains data.");
+	
+	// Check region specification
+	if(region != NULL)
+	{
+		ensure(Array_siz_get_size(region) == 6, ERR_USER_INPUT, "Invalid region supplied; must contain 6 values.");
+		for(size_t i = 0; i < Array_siz_get_size(region); i += 2) ensure(Array_siz_get(region, i) <= Array_siz_get(region, i + 1), ERR_USER_INPUT, "Invalid region supplied; minimum greater than maximum.");
+	}
+	
+	// Open FITS file
+	message("Opening FITS file \'%s\'.", filename);
+	FILE *fp = fopen(filename, "rb");
+	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open FITS file \'%s\'.", filename);
+	
+	// Read and parse header
+	DataCube_read_header(self, fp);
+	ensure(self->data_type == -32 || self->data_type == -64, ERR_USER_INPUT, "Memory mapping only supported for floating-point data.");
+	const size_t data_start = (size_t)ftell(fp);
+	
+	// Check file size
+	struct stat file_stat;
+	ensure(fstat(fileno(fp), &file_stat) == 0, ERR_FILE_ACCESS, "Failed to determine size of FITS file.");
+	self->map_size = (size_t)file_stat.st_size;
+	ensure(self->map_size >= data_start + self->data_size * self->word_size, ERR_FILE_ACCESS, "FITS file ended unexpectedly while mapping data.");
+	
+	// Map file into memory
+	// NOTE: The mapping remains valid after closing the file.
+	void *map = mmap(NULL, self->map_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+	ensure(map != MAP_FAILED, ERR_FILE_ACCESS, "Failed to memory-map FITS file \'%s\'.", filename);
+	fclose(fp);
+	
+	// Work out region
+	const size_t x_min = (region != NULL && Array_siz_get(region, 0) > 0) ? Array_siz_get(region, 0) : 0;
+	const size_t x_max = (region != NULL && Array_siz_get(region, 1) < self->axis_size[0] - 1) ? Array_siz_get(region, 1) : self->axis_size[0] - 1;
+	const size_t y_min = (region != NULL && Array_siz_get(region, 2) > 0) ? Array_siz_get(region, 2) : 0;
+	const size_t y_max = (region != NULL && Array_siz_get(region, 3) < self->axis_size[1] - 1) ? Array_siz_get(region, 3) : self->axis_size[1] - 1;
+	const size_t z_min = (region != NULL && Array_siz_get(region, 4) > 0) ? Array_siz_get(region, 4) : 0;
+	const size_t z_max = (region != NULL && Array_siz_get(region, 5) < self->axis_size[2] - 1) ? Array_siz_get(region, 5) : self->axis_size[2] - 1;
+	
+	ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_USER_INPUT, "Invalid data cube region requested.");
+	
+	// Print status information
+	message("Mapping FITS data with the following specifications:");
+	message("  Data type:    %d", self->data_type);
+	message("  No. of axes:  %zu", self->dimension);
+	message("  Axis sizes:   %zu, %zu, %zu", self->axis_size[0], self->axis_size[1], self->axis_size[2]);
+	message("  Region:       %zu-%zu, %zu-%zu, %zu-%zu", x_min, x_max, y_min, y_max, z_min, z_max);
+	
+	// Update object properties
+	self->map           = (char *)map;
+	self->data          = self->map + data_start;
+	self->map_axis[0]   = self->axis_size[0];
+	self->map_axis[1]   = self->axis_size[1];
+	self->map_origin[0] = x_min;
+	self->map_origin[1] = y_min;
+	self->map_origin[2] = z_min;
+	self->axis_size[0]  = x_max - x_min + 1;
+	self->axis_size[1]  = y_max - y_min + 1;
+	self->axis_size[2]  = z_max - z_min + 1;
+	self->data_size     = self->axis_size[0] * self->axis_size[1] * self->axis_size[2];
+	
+	// Adjust WCS information in header
+	if(region != NULL) Header_adjust_wcs_to_subregion(self->header, x_min, x_max, y_min, y_max, z_min, z_max);
+	
+	// Record BSCALE and BZERO to be applied on the fly
+	const double bscale = Header_get_flt(self->header, "BSCALE");
+	const double bzero  = Header_get_flt(self->header, "BZERO");
+	
+	if((IS_NOT_NAN(bscale) && bscale != 1.0) || (IS_NOT_NAN(bzero) && bzero != 0.0))
+	{
+		warning("Applying non-trivial BSCALE and BZERO to floating-point data.");
+		if(IS_NOT_NAN(bscale)) self->map_bscale = bscale;
+		if(IS_NOT_NAN(bzero))  self->map_bzero  = bzero;
+		Header_remove(self->header, "BSCALE");
+		Header_remove(self->header, "BZERO");
+	}
+	
+	return;
+}
+
+
+
+/// @brief Write data cube into FITS file
+///
+/// Public method for writing the current data cube object
+/// (referenced by `self`) into a FITS file. The function will
+/// terminate the current programme execution if an error is
+/// encountered during the write process. If the output file
+/// already exists, it will be overwritten only if overwrite
+/// is set to true.
+///
+/// @param self        Object self-reference.
+/// @param filename    Name of output FITS file.
+/// @param overwrite   If `true`, overwrite existing file. Otherwise
+///                    terminate if the file already exists.
+/// @param preserve    Retained for compatibility only. The data array
+///                    is never modified, as byte swapping is carried
+///                    out in a separate staging buffer of fixed size,
+///                    so `PRESERVE` and `DESTROY` are equivalent.
+
+PUBLIC void DataCube_save(const DataCube *self, const char *filename, const bool overwrite, const bool preserve)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(filename);
+	ensure(strlen(filename), ERR_USER_INPUT, "Empty file name provided.");
+	(void)preserve;  // data array is never modified
+	
+	// Open FITS file
+	FILE *fp;
+	if(overwrite) fp = fopen(filename, "wb");
+	else fp = fopen(filename, "wxb");
+	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to create new FITS file: %s\n       Does the destination exist and is writeable?", filename);
+	
+	message("Creating FITS file: %s", strrchr(filename, '/') == NULL ? filename : strrchr(filename, '/') + 1);
+	
+	// Write entire header
+	ensure(fwrite(Header_get(self->header), 1, Header_get_size(self->header), fp) == Header_get_size(self->header), ERR_FILE_ACCESS, "Failed to write header to FITS file.");
+	
+	// Write data array
+	const size_t size_data = self->data_size * self->word_size;
+	
+	if(is_little_endian() && self->word_size > 1)
+	{
+		// Byte order must be swapped; copy data into staging buffer
+		// one chunk at a time, swap and write, leaving original intact
+		const size_t size_buffer = size_data < DATACUBE_WRITE_CHUNK ? size_data : DATACUBE_WRITE_CHUNK;
+		char *buffer = (char *)memory(MALLOC, size_buffer, sizeof(char));
+		
+		for(size_t offset = 0; offset < size_data; offset += size_buffer)
+		{
+			const size_t size_chunk = (size_data - offset < size_buffer) ? size_data - offset : size_buffer;
+			memcpy(buffer, self->data + offset, size_chunk);
+			for(size_t i = 0; i < size_chunk; i += self->word_size) swap_byte_order(buffer + i, self->word_size);
+			ensure(fwrite(buffer, 1, size_chunk, fp) == size_chunk, ERR_FILE_ACCESS, "Failed to write data to FITS file.");
+		}
+		
+		free(buffer);
+	}
+	else
+	{
+		// Byte order already correct; write entire data array directly
+		ensure(fwrite(self->data, 1, size_data, fp) == size_data, ERR_FILE_ACCESS, "Failed to write data to FITS file.");
+	}
+	
+	// Fill last FITS block with 0x00 if necessary
+	const size_t size_footer = size_data % FITS_HEADER_BLOCK_SIZE;
+	if(size_footer)
+	{
+		const char footer[FITS_HEADER_BLOCK_SIZE] = {0};
+		ensure(fwrite(footer, 1, FITS_HEADER_BLOCK_SIZE - size_footer, fp) == FITS_HEADER_BLOCK_SIZE - size_footer, ERR_FILE_ACCESS, "Failed to write data to FITS file.");
+	}
+	
+	// Close file
+	ensure(fclose(fp) == 0, ERR_FILE_ACCESS, "Failed to close FITS file.");
+	
+	return;
+}
+
+
+
+/// @brief Wrapper around commonly needed Header method
+///
+/// See Header_get_int() in class Header for detailed information on
+/// the respective method and its arguments and return value.
+
+PUBLIC long int DataCube_gethd_int(const DataCube *self, const char *key) {
+	return Header_get_int(self->header, key);
+}
+
+/// @brief Wrapper around commonly needed Header method
+///
+/// See Header_get_flt() in class Header for detailed information on
 /// the respective method and its arguments and return value.
 
 PUBLIC double DataCube_gethd_flt(const DataCube *self, const char *key) {
@@ -951,45 +1307,47 @@ PUBLIC long int DataCube_get_data_int(const DataCube *self, const size_t x, cons
 
 
 
-/// @brief Set data value as double-precision floating-point number
+/// @brief Read row of data values as double-precision numbers
 ///
-/// Public method to write the data value to the specified position
-/// (`x`, `y`, `z`), where `x` indexes the first axis, `y` the second
-/// axis and `z` the third axis of the cube. Note that the data value
-/// will be cast to the native data type of the array before being written.
+/// Private method to extract the data values from `x_min` to `x_max`
+/// (inclusive) of row (`y`, `z`) into the array `row`, converting
+/// them to double precision. Unlike repeated calls to
+/// DataCube_get_data_flt(), the data type is only checked once per
+/// row, and the values are read from contiguous memory in a tight
+/// loop. No sanity or bounds checks are carried out.
 ///
 /// @param self   Object self-reference.
-/// @param x      First coordinate.
+/// @param x_min  First position along the first axis.
+/// @param x_max  Last position along the first axis.
 /// @param y      Second coordinate.
 /// @param z      Third coordinate.
-/// @param value  Data value to be written to array.
+/// @param row    Array of at least `x_max - x_min + 1` elements for
+///               holding the values of the row.
 
-PUBLIC void DataCube_set_data_flt(DataCube *self, const size_t x, const size_t y, const size_t z, const double value)
+PRIVATE void DataCube_get_row_flt(const DataCube *self, const size_t x_min, const size_t x_max, const size_t y, const size_t z, double *row)
 {
-	//check_null(self);
-	//check_null(self->data);
-	//ensure(x < self->axis_size[0] && y < self->axis_size[1] && z < self->axis_size[2], ERR_INDEX_RANGE, "Position outside of image boundaries.");
-	const size_t i = DataCube_get_index(self, x, y, z);
+	const size_t first = DataCube_get_index(self, x_min, y, z);
+	const size_t size  = x_max - x_min + 1;
 	
 	switch(self->data_type)
 	{
 		case -64:
-			*((double *)(self->data + i * self->word_size))  = value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((double *)(self->data) + first + i);
 			break;
 		case -32:
-			*((float *)(self->data + i * self->word_size))   = (float)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((float *)(self->data) + first + i);
 			break;
 		case 8:
-			*((uint8_t *)(self->data + i * self->word_size)) = (uint8_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((uint8_t *)(self->data) + first + i);
 			break;
 		case 16:
-			*((int16_t *)(self->data + i * self->word_size)) = (int16_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((int16_t *)(self->data) + first + i);
 			break;
 		case 32:
-			*((int32_t *)(self->data + i * self->word_size)) = (int32_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((int32_t *)(self->data) + first + i);
 			break;
 		case 64:
-			*((int64_t *)(self->data + i * self->word_size)) = (int64_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((int64_t *)(self->data) + first + i);
 			break;
 	}
 	
@@ -998,45 +1356,46 @@ PUBLIC void DataCube_set_data_flt(DataCube *self, const size_t x, const size_t y
 
 
 
-/// @brief Add data value as double-precision floating-point number
+/// @brief Read row of data values as long integer numbers
 ///
-/// Public method to add the data value to the specified position
-/// (`x`, `y`, `z`), where `x` indexes the first axis, `y` the second
-/// axis and `z` the third axis of the cube. Note that the data value
-/// will be cast to the native data type of the array before being written.
+/// Private method to extract the data values from `x_min` to `x_max`
+/// (inclusive) of row (`y`, `z`) into the array `row`, converting
+/// them to long integer values. Unlike repeated calls to
+/// DataCube_get_data_int(), the data type is only checked once per
+/// row. No sanity or bounds checks are carried out.
 ///
 /// @param self   Object self-reference.
-/// @param x      First coordinate.
+/// @param x_min  First position along the first axis.
+/// @param x_max  Last position along the first axis.
 /// @param y      Second coordinate.
 /// @param z      Third coordinate.
-/// @param value  Data value to be added to array.
+/// @param row    Array of at least `x_max - x_min + 1` elements for
+///               holding the values of the row.
 
-PUBLIC void DataCube_add_data_flt(DataCube *self, const size_t x, const size_t y, const size_t z, const double value)
+PRIVATE void DataCube_get_row_int(const DataCube *self, const size_t x_min, const size_t x_max, const size_t y, const size_t z, long int *row)
 {
-	//check_null(self);
-	//check_null(self->data);
-	//ensure(x < self->axis_size[0] && y < self->axis_size[1] && z < self->axis_size[2], ERR_INDEX_RANGE, "Position outside of image boundaries.");
-	const size_t i = DataCube_get_index(self, x, y, z);
+	const size_t first = DataCube_get_index(self, x_min, y, z);
+	const size_t size  = x_max - x_min + 1;
 	
 	switch(self->data_type)
 	{
 		case -64:
-			*((double *)(self->data + i * self->word_size))  += value;
+			for(size_t i = 0; i < size; ++i) row[i] = (long int)(*((double *)(self->data) + first + i));
 			break;
 		case -32:
-			*((float *)(self->data + i * self->word_size))   += (float)value;
+			for(size_t i = 0; i < size; ++i) row[i] = (long int)(*((float *)(self->data) + first + i));
 			break;
 		case 8:
-			*((uint8_t *)(self->data + i * self->word_size)) += (uint8_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((uint8_t *)(self->data) + first + i);
 			break;
 		case 16:
-			*((int16_t *)(self->data + i * self->word_size)) += (int16_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((int16_t *)(self->data) + first + i);
 			break;
 		case 32:
-			*((int32_t *)(self->data + i * self->word_size)) += (int32_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = *((int32_t *)(self->data) + first + i);
 			break;
 		case 64:
-			*((int64_t *)(self->data + i * self->word_size)) += (int64_t)value;
+			for(size_t i = 0; i < size; ++i) row[i] = (long int)(*((int64_t *)(self->data) + first + i));
 			break;
 	}
 	
@@ -1045,7 +1404,7 @@ PUBLIC void DataCube_add_data_flt(DataCube *self, const size_t x, const size_t y
 
 
 
-/// @brief Set data value as long integer number
+/// @brief Set data value as double-precision floating-point number
 ///
 /// Public method to write the data value to the specified position
 /// (`x`, `y`, `z`), where `x` indexes the first axis, `y` the second
@@ -1058,16 +1417,17 @@ PUBLIC void DataCube_add_data_flt(DataCube *self, const size_t x, const size_t y
 /// @param z      Third coordinate.
 /// @param value  Data value to be written to array.
 
-PUBLIC void DataCube_set_data_int(DataCube *self, const size_t x, const size_t y, const size_t z, const long int value)
+PUBLIC void DataCube_set_data_flt(DataCube *self, const size_t x, const size_t y, const size_t z, const double value)
 {
 	//check_null(self);
 	//check_null(self->data);
 	//ensure(x < self->axis_size[0] && y < self->axis_size[1] && z < self->axis_size[2], ERR_INDEX_RANGE, "Position outside of image boundaries.");
 	const size_t i = DataCube_get_index(self, x, y, z);
 	
-	switch(self->data_type) {
+	switch(self->data_type)
+	{
 		case -64:
-			*((double *)(self->data + i * self->word_size))  = (double)value;
+			*((double *)(self->data + i * self->word_size))  = value;
 			break;
 		case -32:
 			*((float *)(self->data + i * self->word_size))   = (float)value;
@@ -1091,7 +1451,7 @@ PUBLIC void DataCube_set_data_int(DataCube *self, const size_t x, const size_t y
 
 
 
-/// @brief Add data value as long integer number
+/// @brief Add data value as double-precision floating-point number
 ///
 /// Public method to add the data value to the specified position
 /// (`x`, `y`, `z`), where `x` indexes the first axis, `y` the second
@@ -1104,16 +1464,17 @@ PUBLIC void DataCube_set_data_int(DataCube *self, const size_t x, const size_t y
 /// @param z      Third coordinate.
 /// @param value  Data value to be added to array.
 
-PUBLIC void DataCube_add_data_int(DataCube *self, const size_t x, const size_t y, const size_t z, const long int value)
+PUBLIC void DataCube_add_data_flt(DataCube *self, const size_t x, const size_t y, const size_t z, const double value)
 {
 	//check_null(self);
 	//check_null(self->data);
 	//ensure(x < self->axis_size[0] && y < self->axis_size[1] && z < self->axis_size[2], ERR_INDEX_RANGE, "Position outside of image boundaries.");
 	const size_t i = DataCube_get_index(self, x, y, z);
 	
-	switch(self->data_type) {
+	switch(self->data_type)
+	{
 		case -64:
-			*((double *)(self->data + i * self->word_size))  += (double)value;
+			*((double *)(self->data + i * self->word_size))  += value;
 			break;
 		case -32:
 			*((float *)(self->data + i * self->word_size))   += (float)value;
@@ -1137,7 +1498,99 @@ PUBLIC void DataCube_add_data_int(DataCube *self, const size_t x, const size_t y
 
 
 
-/// @brief Fill data cube with floating-point value
+/// @brief Set data value as long integer number
+///
+/// Public method to write the data value to the specified position
+/// (`x`, `y`, `z`), where `x` indexes the first axis, `y` the second
+/// axis and `z` the third axis of the cube. Note that the data value
+/// will be cast to the native data type of the array before being written.
+///
+/// @param self   Object self-reference.
+/// @param x      First coordinate.
+/// @param y      Second coordinate.
+/// @param z      Third coordinate.
+/// @param value  Data value to be written to array.
+
+PUBLIC void DataCube_set_data_int(DataCube *self, const size_t x, const size_t y, const size_t z, const long int value)
+{
+	//check_null(self);
+	//check_null(self->data);
+	//ensure(x < self->axis_size[0] && y < self->axis_size[1] && z < self->axis_size[2], ERR_INDEX_RANGE, "Position outside of image boundaries.");
+	const size_t i = DataCube_get_index(self, x, y, z);
+	
+	switch(self->data_type) {
+		case -64:
+			*((double *)(self->data + i * self->word_size))  = (double)value;
+			break;
+		case -32:
+			*((float *)(self->data + i * self->word_size))   = (float)value;
+			break;
+		case 8:
+			*((uint8_t *)(self->data + i * self->word_size)) = (uint8_t)value;
+			break;
+		case 16:
+			*((int16_t *)(self->data + i * self->word_size)) = (int16_t)value;
+			break;
+		case 32:
+			*((int32_t *)(self->data + i * self->word_size)) = (int32_t)value;
+			break;
+		case 64:
+			*((int64_t *)(self->data + i * self->word_size)) = (int64_t)value;
+			break;
+	}
+	
+	return;
+}
+
+
+
+/// @brief Add data value as long integer number
+///
+/// Public method to add the data value to the specified position
+/// (`x`, `y`, `z`), where `x` indexes the first axis, `y` the second
+/// axis and `z` the third axis of the cube. Note that the data value
+/// will be cast to the native data type of the array before being written.
+///
+/// @param self   Object self-reference.
+/// @param x      First coordinate.
+/// @param y      Second coordinate.
+/// @param z      Third coordinate.
+/// @param value  Data value to be added to array.
+
+PUBLIC void DataCube_add_data_int(DataCube *self, const size_t x, const size_t y, const size_t z, const long int value)
+{
+	//check_null(self);
+	//check_null(self->data);
+	//ensure(x < self->axis_size[0] && y < self->axis_size[1] && z < self->axis_size[2], ERR_INDEX_RANGE, "Position outside of image boundaries.");
+	const size_t i = DataCube_get_index(self, x, y, z);
+	
+	switch(self->data_type) {
+		case -64:
+			*((double *)(self->data + i * self->word_size))  += (double)value;
+			break;
+		case -32:
+			*((float *)(self->data + i * self->word_size))   += (float)value;
+			break;
+		case 8:
+			*((uint8_t *)(self->data + i * self->word_size)) += (uint8_t)value;
+			break;
+		case 16:
+			*((int16_t *)(self->data + i * self->word_size)) += (int16_t)value;
+			break;
+		case 32:
+			*((int32_t *)(self->data + i * self->word_size)) += (int32_t)value;
+			break;
+		case 64:
+			*((int64_t *)(self->data + i * self->word_size)) += (int64_t)value;
+			break;
+	}
+	
+	return;
+}
+
+
+
+/// @brief Fill data cube with floating-point value
 ///
 /// Public method for filling the data cube with the specified
 /// floating-point value. Note that this will only be possible if
@@ -1169,6 +1622,96 @@ PUBLIC void DataCube_fill_flt(DataCube *self, const double value)
 
 
 
+/// @brief Read row of data values from loaded or memory-mapped cube
+///
+/// Private method to extract an entire row (`y`, `z`) of a data cube
+/// of floating-point type into the array `row`, converting the values
+/// to double precision. If the cube is memory-mapped, the values will
+/// be read with byte-order correction as in DataCube_get_mapped_flt().
+/// No sanity or bounds checks are carried out.
+///
+/// @param self  Object self-reference.
+/// @param y     Second coordinate.
+/// @param z     Third coordinate.
+/// @param row   Array of at least `axis_size[0]` elements for
+///              holding the values of the row.
+
+PRIVATE void DataCube_read_row_flt(const DataCube *self, const size_t y, const size_t z, double *row)
+{
+	if(self->map != NULL)
+	{
+		for(size_t x = 0; x < self->axis_size[0]; ++x) row[x] = DataCube_get_mapped_flt(self, x, y, z);
+	}
+	else DataCube_get_row_flt(self, 0, self->axis_size[0] - 1, y, z, row);
+	
+	return;
+}
+
+
+
+/// @brief Divide row of data cube by array of values
+///
+/// Private method for dividing row (`y`, `z`) of a floating-point
+/// data cube by the values in the array `divisor`. Data values will
+/// be set to `NaN` where the divisor is zero.
+///
+/// @param self     Object self-reference.
+/// @param divisor  Array of `axis_size[0]` values to divide by.
+/// @param y        Second coordinate.
+/// @param z        Third coordinate.
+
+PRIVATE void DataCube_divide_row(DataCube *self, const double *divisor, const size_t y, const size_t z)
+{
+	const size_t index = DataCube_get_index(self, 0, y, z);
+	const size_t size  = self->axis_size[0];
+	
+	if(self->data_type == -32)
+	{
+		float *ptr = (float *)(self->data) + index;
+		for(size_t x = 0; x < size; ++x) ptr[x] = (divisor[x] != 0.0) ? ptr[x] / divisor[x] : NAN;
+	}
+	else
+	{
+		double *ptr = (double *)(self->data) + index;
+		for(size_t x = 0; x < size; ++x) ptr[x] = (divisor[x] != 0.0) ? ptr[x] / divisor[x] : NAN;
+	}
+	
+	return;
+}
+
+
+
+/// @brief Multiply row of data cube by square root of weights
+///
+/// Private method for multiplying row (`y`, `z`) of a floating-point
+/// data cube by the square root of the values in the array `weights`.
+///
+/// @param self     Object self-reference.
+/// @param weights  Array of `axis_size[0]` weights to be applied.
+/// @param y        Second coordinate.
+/// @param z        Third coordinate.
+
+PRIVATE void DataCube_weight_row(DataCube *self, const double *weights, const size_t y, const size_t z)
+{
+	const size_t index = DataCube_get_index(self, 0, y, z);
+	const size_t size  = self->axis_size[0];
+	
+	if(self->data_type == -32)
+	{
+		float *ptr = (float *)(self->data) + index;
+		for(size_t x = 0; x < size; ++x) ptr[x] *= sqrt(weights[x]);
+	}
+	else
+	{
+		double *ptr = (double *)(self->data) + index;
+		for(size_t x = 0; x < size; ++x) ptr[x] *= sqrt(weights[x]);
+	}
+	
+	return;
+}
+
+
+
 /// @brief Divide a data cube by another cube
 ///
 /// Public method for dividing a data cube by another one. Both
@@ -1182,67 +1725,10 @@ PUBLIC void DataCube_fill_flt(DataCube *self, const double value)
 PUBLIC void DataCube_divide(DataCube *self, const DataCube *divisor)
 {
 	// Sanity checks
-	check_null(self);
 	check_null(divisor);
-	check_null(self->data);
 	check_null(divisor->data);
-	ensure((self->data_type == -32 || self->data_type == -64) && (divisor->data_type == -32 || divisor->data_type == -64), ERR_USER_INPUT, "Dividend and divisor cubes must be of floating-point type.");
-	ensure(self->axis_size[0] == divisor->axis_size[0] && self->axis_size[1] == divisor->axis_size[1] && self->axis_size[2] == divisor->axis_size[2], ERR_USER_INPUT, "Dividend and divisor cubes have different sizes.");
 	
-	if(self->data_type == -32)
-	{
-		if(divisor->data_type == -32)
-		{
-			float *ptr_data    = (float *)(self->data);
-			float *ptr_divisor = (float *)(divisor->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i)
-			{
-				if(*(ptr_divisor + i) != 0.0) *(ptr_data + i) /= *(ptr_divisor + i);
-				else *(ptr_data + i) = NAN;
-			}
-		}
-		else
-		{
-			float  *ptr_data    = (float *)(self->data);
-			double *ptr_divisor = (double *)(divisor->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i)
-			{
-				if(*(ptr_divisor + i) != 0.0) *(ptr_data + i) /= *(ptr_divisor + i);
-				else *(ptr_data + i) = NAN;
-			}
-		}
-	}
-	else
-	{
-		if(divisor->data_type == -32)
-		{
-			double *ptr_data    = (double *)(self->data);
-			float  *ptr_divisor = (float *)(divisor->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i)
-			{
-				if(*(ptr_divisor + i) != 0.0) *(ptr_data + i) /= *(ptr_divisor + i);
-				else *(ptr_data + i) = NAN;
-			}
-		}
-		else
-		{
-			double *ptr_data    = (double *)(self->data);
-			double *ptr_divisor = (double *)(divisor->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i)
-			{
-				if(*(ptr_divisor + i) != 0.0) *(ptr_data + i) /= *(ptr_divisor + i);
-				else *(ptr_data + i) = NAN;
-			}
-		}
-	}
+	DataCube_preprocess(self, divisor, NULL, false);
 	
 	return;
 }
@@ -1262,50 +1748,90 @@ PUBLIC void DataCube_divide(DataCube *self, const DataCube *divisor)
 PUBLIC void DataCube_apply_weights(DataCube *self, const DataCube *weights)
 {
 	// Sanity checks
-	check_null(self);
 	check_null(weights);
-	check_null(self->data);
 	check_null(weights->data);
-	ensure((self->data_type == -32 || self->data_type == -64) && (weights->data_type == -32 || weights->data_type == -64), ERR_USER_INPUT, "Data and weights cubes must be of floating-point type.");
-	ensure(self->axis_size[0] == weights->axis_size[0] && self->axis_size[1] == weights->axis_size[1] && self->axis_size[2] == weights->axis_size[2], ERR_USER_INPUT, "Data and weights cubes have different sizes.");
 	
-	if(self->data_type == -32)
+	DataCube_preprocess(self, NULL, weights, false);
+	
+	return;
+}
+
+
+
+/// @brief Apply pointwise preprocessing steps in a single pass
+///
+/// Public method for applying the pointwise preprocessing steps of
+/// the pipeline to a data cube in a single pass. Depending on the
+/// arguments, the cube will first be inverted, then divided by the
+/// noise cube (see DataCube_divide()) and finally multiplied by the
+/// square root of the weights cube (see DataCube_apply_weights()).
+/// The steps are applied one row at a time, such that each row only
+/// needs to be read from and written to memory once irrespective of
+/// the number of steps. The noise and weights cubes can be loaded or
+/// memory-mapped, must be of floating-point type and need to have
+/// the same size as the data cube.
+///
+/// @param self     Object self-reference.
+/// @param noise    Noise cube to divide by. Set to `NULL` to skip.
+/// @param weights  Weights cube to be applied. Set to `NULL` to skip.
+/// @param invert   If `true`, multiply the cube by -1 first.
+
+PUBLIC void DataCube_preprocess(DataCube *self, const DataCube *noise, const DataCube *weights, const bool invert)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	ensure(self->data_type == -32 || self->data_type == -64, ERR_USER_INPUT, "Data cube must be of floating-point type for preprocessing.");
+	
+	if(noise != NULL)
 	{
-		if(weights->data_type == -32)
-		{
-			float *ptr_data    = (float *)(self->data);
-			float *ptr_weights = (float *)(weights->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i) *(ptr_data + i) *= sqrt(*(ptr_weights + i));
-		}
-		else
-		{
-			float  *ptr_data    = (float *)(self->data);
-			double *ptr_weights = (double *)(weights->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i) *(ptr_data + i) *= sqrt(*(ptr_weights + i));
-		}
+		check_null(noise->data);
+		ensure(noise->data_type == -32 || noise->data_type == -64, ERR_USER_INPUT, "Dividend and divisor cubes must be of floating-point type.");
+		ensure(self->axis_size[0] == noise->axis_size[0] && self->axis_size[1] == noise->axis_size[1] && self->axis_size[2] == noise->axis_size[2], ERR_USER_INPUT, "Dividend and divisor cubes have different sizes.");
 	}
-	else
+	
+	if(weights != NULL)
 	{
-		if(weights->data_type == -32)
-		{
-			double *ptr_data    = (double *)(self->data);
-			float  *ptr_weights = (float *)(weights->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i) *(ptr_data + i) *= sqrt(*(ptr_weights + i));
-		}
-		else
+		check_null(weights->data);
+		ensure(weights->data_type == -32 || weights->data_type == -64, ERR_USER_INPUT, "Data and weights cubes must be of floating-point type.");
+		ensure(self->axis_size[0] == weights->axis_size[0] && self->axis_size[1] == weights->axis_size[1] && self->axis_size[2] == weights->axis_size[2], ERR_USER_INPUT, "Data and weights cubes have different sizes.");
+	}
+	
+	if(noise == NULL && weights == NULL && !invert) return;
+	
+	#pragma omp parallel
+	{
+		double *row = (double *)memory(MALLOC, self->axis_size[0], sizeof(double));
+		
+		#pragma omp for collapse(2) schedule(static)
+		for(size_t z = 0; z < self->axis_size[2]; ++z)
 		{
-			double *ptr_data    = (double *)(self->data);
-			double *ptr_weights = (double *)(weights->data);
-			
-			#pragma omp parallel for schedule(static)
-			for(size_t i = 0; i < self->data_size; ++i) *(ptr_data + i) *= sqrt(*(ptr_weights + i));
+			for(size_t y = 0; y < self->axis_size[1]; ++y)
+			{
+				// NOTE: NaN values are left untouched, as the compiler is free to
+				//       turn a multiplication by -1 into a flip of the sign bit.
+				if(invert)
+				{
+					const size_t index = DataCube_get_index(self, 0, y, z);
+					if(self->data_type == -32) for(float  *ptr = (float  *)(self->data) + index + self->axis_size[0]; ptr --> (float  *)(self->data) + index;) *ptr = IS_NAN(*ptr) ? *ptr : -*ptr;
+					else                       for(double *ptr = (double *)(self->data) + index + self->axis_size[0]; ptr --> (double *)(self->data) + index;) *ptr = IS_NAN(*ptr) ? *ptr : -*ptr;
+				}
+				
+				if(noise != NULL)
+				{
+					DataCube_read_row_flt(noise, y, z, row);
+					DataCube_divide_row(self, row, y, z);
+				}
+				
+				if(weights != NULL)
+				{
+					DataCube_read_row_flt(weights, y, z, row);
+					DataCube_weight_row(self, row, y, z);
+				}
+			}
 		}
+		
+		free(row);
 	}
 	
 	return;
@@ -1410,29 +1936,39 @@ PUBLIC double DataCube_stat_std(const DataCube *self, const double value, const
 /// Public method for calculating the median absolute deviation re
 /// relative to the specified value.
 ///
-/// @param self     Object self-reference.
-/// @param value    Value relative to which to calculate the MAD.
-/// @param cadence  Cadence used in the calculation, i.e. a cadence
-///                 of N will calculate the standard deviation using
-///                 every N-th element from the array.
-/// @param range    Flux range to be used in the calculation. Options
-///                 are 0 (entire flux range), -1 (negative fluxes
-///                 only) and +1 (positive fluxes only).
+/// @param self       Object self-reference.
+/// @param value      Value relative to which to calculate the MAD.
+/// @param cadence    Cadence used in the calculation, i.e. a cadence
+///                   of N will calculate the standard deviation using
+///                   every N-th element from the array.
+/// @param range      Flux range to be used in the calculation. Options
+///                   are 0 (entire flux range), -1 (negative fluxes
+///                   only) and +1 (positive fluxes only).
+/// @param tolerance  If greater than 0, an approximate MAD with a
+///                   relative error not exceeding `tolerance` will be
+///                   derived from a histogram of the data instead.
 ///
 /// @return Median absolute deviation of the data array.
 ///         were found.
 ///
-/// @note A copy of (parts of) the data array will need to be made
-///       in order to calculate the median of the data as part of
-///       this process.
+/// @note Unless `tolerance` is greater than 0, a copy of (parts of)
+///       the data array will need to be made in order to calculate
+///       the median of the data as part of this process.
 
-PUBLIC double DataCube_stat_mad(const DataCube *self, const double value, const size_t cadence, const int range)
+PUBLIC double DataCube_stat_mad(const DataCube *self, const double value, const size_t cadence, const int range, const double tolerance)
 {
 	// Sanity checks
 	check_null(self);
 	check_null(self->data);
 	ensure(self->data_type == -32 || self->data_type == -64, ERR_USER_INPUT, "Cannot evaluate MAD for integer array.");
 	
+	// Derive approximate MAD from histogram if requested
+	if(tolerance > 0.0)
+	{
+		if(self->data_type == -32) return mad_val_hist_flt((float *)self->data, self->data_size, value, cadence ? cadence : 1, range, tolerance);
+		return mad_val_hist_dbl((double *)self->data, self->data_size, value, cadence ? cadence : 1, range, tolerance);
+	}
+	
 	// Derive MAD of data copy
 	if(self->data_type == -32) return mad_val_flt((float *)self->data, self->data_size, value, cadence ? cadence : 1, range);
 	return mad_val_dbl((double *)self->data, self->data_size, value, cadence ? cadence : 1, range);
@@ -1658,87 +2194,118 @@ PUBLIC DataCube *DataCube_scale_noise_local(DataCube *self, const noise_stat sta
 	size_t progress = 0;
 	const size_t progress_max = (grid_end_z - grid_start_z) / grid_spec;
 	
+	// Standard deviation and mean can be derived from running sums
+	const bool running_sums = (statistic == NOISE_STAT_STD || statistic == NOISE_STAT_MEAN);
+	const size_t size_x = self->axis_size[0];
+	
 	// Determine RMS/mean/median across window centred on grid cell
-	#pragma omp parallel for schedule(static)
-	for(size_t z = grid_start_z; z <= grid_end_z; z += grid_spec)
+	#pragma omp parallel
 	{
-		#pragma omp critical
-		progress_bar("Progress: ", progress++, progress_max);
+		// Allocate scratch memory once per thread
+		// NOTE: The use of float is faster and more memory-efficient than double.
+		float *array = running_sums ? NULL : (float *)memory(MALLOC, (2 * radius_window_spec + 1) * (2 * radius_window_spat + 1) * (2 * radius_window_spat + 1), sizeof(float));
+		double *column_sum = running_sums ? (double *)memory(MALLOC, size_x, sizeof(double)) : NULL;
+		size_t *column_cnt = running_sums ? (size_t *)memory(MALLOC, 2 * size_x, sizeof(size_t)) : NULL;
 		
-		for(size_t y = grid_start_y; y < self->axis_size[1]; y += grid_spat)
+		#pragma omp for schedule(static)
+		for(size_t z = grid_start_z; z <= grid_end_z; z += grid_spec)
 		{
-			for(size_t x = grid_start_x; x < self->axis_size[0]; x += grid_spat)
+			#pragma omp critical
+			progress_bar("Progress: ", progress++, progress_max);
+			
+			for(size_t y = grid_start_y; y < self->axis_size[1]; y += grid_spat)
 			{
-				// Determine extent of grid cell (inclusive of end point)
-				const size_t grid[6] = {
-					x < radius_grid_spat ? 0 : x - radius_grid_spat,
-					x + radius_grid_spat >= self->axis_size[0] ? self->axis_size[0] - 1 : x + radius_grid_spat,
-					y < radius_grid_spat ? 0 : y - radius_grid_spat,
-					y + radius_grid_spat >= self->axis_size[1] ? self->axis_size[1] - 1 : y + radius_grid_spat,
-					z < radius_grid_spec ? 0 : z - radius_grid_spec,
-					z + radius_grid_spec >= self->axis_size[2] ? self->axis_size[2] - 1 : z + radius_grid_spec
-				};
-				
-				// Determine extent of window (inclusive of end point)
-				const size_t window[6] = {
-					x < radius_window_spat ? 0 : x - radius_window_spat,
-					x + radius_window_spat >= self->axis_size[0] ? self->axis_size[0] - 1 : x + radius_window_spat,
+				// Determine spectral and vertical extent of window (inclusive of end point)
+				const size_t window_yz[4] = {
 					y < radius_window_spat ? 0 : y - radius_window_spat,
 					y + radius_window_spat >= self->axis_size[1] ? self->axis_size[1] - 1 : y + radius_window_spat,
 					z < radius_window_spec ? 0 : z - radius_window_spec,
 					z + radius_window_spec >= self->axis_size[2] ? self->axis_size[2] - 1 : z + radius_window_spec
 				};
 				
-				// Create temporary array
-				// NOTE: The use of float is faster and more memory-efficient than double.
-				float *array = (float *)memory(MALLOC, (window[5] - window[4] + 1) * (window[3] - window[2] + 1) * (window[1] - window[0] + 1), sizeof(float));
+				// Accumulate sums along each column of window once for the entire row of grid points
+				if(running_sums) DataCube_sum_window_columns(self, window_yz, statistic == NOISE_STAT_STD, range, column_sum, column_cnt);
 				
-				// Copy values from window into temporary array
-				size_t counter = 0;
-				for(size_t zz = window[4]; zz <= window[5]; ++zz)
+				for(size_t x = grid_start_x; x < size_x; x += grid_spat)
 				{
-					for(size_t yy = window[2]; yy <= window[3]; ++yy)
+					// Determine extent of grid cell (inclusive of end point)
+					const size_t grid[6] = {
+						x < radius_grid_spat ? 0 : x - radius_grid_spat,
+						x + radius_grid_spat >= size_x ? size_x - 1 : x + radius_grid_spat,
+						y < radius_grid_spat ? 0 : y - radius_grid_spat,
+						y + radius_grid_spat >= self->axis_size[1] ? self->axis_size[1] - 1 : y + radius_grid_spat,
+						z < radius_grid_spec ? 0 : z - radius_grid_spec,
+						z + radius_grid_spec >= self->axis_size[2] ? self->axis_size[2] - 1 : z + radius_grid_spec
+					};
+					
+					// Determine extent of window (inclusive of end point)
+					const size_t window[6] = {
+						x < radius_window_spat ? 0 : x - radius_window_spat,
+						x + radius_window_spat >= size_x ? size_x - 1 : x + radius_window_spat,
+						window_yz[0],
+						window_yz[1],
+						window_yz[2],
+						window_yz[3]
+					};
+					
+					double rms;
+					
+					if(running_sums)
 					{
+						// Add up column sums across window
+						double sum = 0.0;
+						size_t counter = 0;
+						size_t counter_range = 0;
+						
 						for(size_t xx = window[0]; xx <= window[1]; ++xx)
 						{
-							const double value = DataCube_get_data_flt(self, xx, yy, zz);
-							if(IS_NOT_NAN(value)) array[counter++] = value;
+							sum += column_sum[xx];
+							counter += column_cnt[2 * xx];
+							counter_range += column_cnt[2 * xx + 1];
 						}
+						
+						// Move on if not enough finite values found
+						// NOTE: The threshold of 10 is somewhat arbitrary.
+						if(counter < 10) continue;
+						
+						// Determine noise/mean from sums
+						if(statistic == NOISE_STAT_STD) rms = counter_range ? sqrt(sum / counter_range) : NAN;
+						else rms = sum / counter;
 					}
-				}
-				
-				// Move on if not enough finite values found
-				// NOTE: The threshold of 10 is somewhat arbitrary.
-				if(counter < 10)
-				{
-					free(array);
-					continue;
-				}
-				
-				// Determine noise/mean/median in temporary array
-				double rms;
-				if(statistic == NOISE_STAT_STD) rms = std_dev_val_flt(array, counter, 0.0, 1, range);
-				else if(statistic == NOISE_STAT_MAD) rms = MAD_TO_STD * mad_val_flt(array, counter, 0.0, 1, range);
-				else if(statistic == NOISE_STAT_GAUSS) rms = gaufit_flt(array, counter, 1, range);
-				else if(statistic == NOISE_STAT_MEAN) rms = mean_flt(array, counter);
-				else rms = median_flt(array, counter, false);
-				
-				// Delete temporary array again
-				free(array);
-				
-				// Fill entire grid cell with noise/mean/median value
-				for(size_t zz = grid[4]; zz <= grid[5]; ++zz)
-				{
-					for(size_t yy = grid[2]; yy <= grid[3]; ++yy)
+					else
+					{
+						// Copy values from window into scratch array
+						const size_t counter = DataCube_copy_window(self, window, array);
+						
+						// Move on if not enough finite values found
+						// NOTE: The threshold of 10 is somewhat arbitrary.
+						if(counter < 10) continue;
+						
+						// Determine noise/median in scratch array
+						if(statistic == NOISE_STAT_MAD) rms = MAD_TO_STD * mad_val_flt(array, counter, 0.0, 1, range);
+						else if(statistic == NOISE_STAT_GAUSS) rms = gaufit_flt(array, counter, 1, range);
+						else rms = median_flt(array, counter, false);
+					}
+					
+					// Fill entire grid cell with noise/mean/median value
+					for(size_t zz = grid[4]; zz <= grid[5]; ++zz)
 					{
-						for(size_t xx = grid[0]; xx <= grid[1]; ++xx)
+						for(size_t yy = grid[2]; yy <= grid[3]; ++yy)
 						{
-							DataCube_set_data_flt(noiseCube, xx, yy, zz, rms);
+							for(size_t xx = grid[0]; xx <= grid[1]; ++xx)
+							{
+								DataCube_set_data_flt(noiseCube, xx, yy, zz, rms);
+							}
 						}
 					}
 				}
 			}
 		}
+		
+		// Release scratch memory again
+		free(array);
+		free(column_sum);
+		free(column_cnt);
 	}
 	
 	// Apply bilinear interpolation if requested
@@ -1888,6 +2455,115 @@ PUBLIC DataCube *DataCube_scale_noise_local(DataCube *self, const noise_stat sta
 
 
 
+/// @brief Copy finite values from window into array
+///
+/// Private method for copying all finite values from the specified
+/// window of the data cube into the array provided. Values will be
+/// copied in the order of increasing x, y and z. The array must be
+/// large enough to hold all values within the window. The data cube
+/// must be of floating-point type.
+///
+/// @param self    Object self-reference.
+/// @param window  Array of 6 elements specifying the window as
+///                x_min, x_max, y_min, y_max, z_min, z_max (all of
+///                which are inclusive).
+/// @param array   Array for holding the values copied.
+///
+/// @return Number of finite values copied into the array.
+
+PRIVATE size_t DataCube_copy_window(const DataCube *self, const size_t *window, float *array)
+{
+	size_t counter = 0;
+	
+	for(size_t zz = window[4]; zz <= window[5]; ++zz)
+	{
+		for(size_t yy = window[2]; yy <= window[3]; ++yy)
+		{
+			const size_t first = DataCube_get_index(self, window[0], yy, zz);
+			const size_t last  = first + window[1] - window[0];
+			
+			if(self->data_type == -32)
+			{
+				const float *data = (const float *)(self->data);
+				for(size_t i = first; i <= last; ++i) if(IS_NOT_NAN(data[i])) array[counter++] = data[i];
+			}
+			else
+			{
+				const double *data = (const double *)(self->data);
+				for(size_t i = first; i <= last; ++i) if(IS_NOT_NAN(data[i])) array[counter++] = data[i];
+			}
+		}
+	}
+	
+	return counter;
+}
+
+
+
+/// @brief Sum up values along columns of window
+///
+/// Private method for summing up the values within the specified
+/// window of the data cube along each column, i.e. across y and z
+/// for every x position of the cube. This allows the mean or the
+/// standard deviation of all windows within the same row of grid
+/// points to be derived by adding up the column sums across the
+/// x range of each window, without having to revisit every value.
+/// If `squares` is `true`, the squares of all values within the
+/// flux range specified by `range` will be summed up instead of the
+/// values themselves. For each column, the number of finite values
+/// and the number of values within the flux range will be written
+/// to `counts` as consecutive pairs. Values will be converted to
+/// single precision first, such that the results are consistent
+/// with those obtained from a copy of the window in single precision.
+///
+/// @param self     Object self-reference.
+/// @param window   Array of 4 elements specifying the extent of the
+///                 window as y_min, y_max, z_min, z_max (all of which
+///                 are inclusive).
+/// @param squares  If `true`, sum up squares of values in range.
+///                 Otherwise, sum up all finite values.
+/// @param range    Flux range to be used for squares. Can be -1, 0
+///                 or +1 for negative range, full range or positive
+///                 range, respectively.
+/// @param sums     Array of size `nx` for holding the column sums.
+/// @param counts   Array of size `2 * nx` for holding the number of
+///                 finite values and the number of values in range.
+
+PRIVATE void DataCube_sum_window_columns(const DataCube *self, const size_t *window, const bool squares, const int range, double *sums, size_t *counts)
+{
+	const size_t size_x = self->axis_size[0];
+	
+	for(size_t x = 0; x < size_x; ++x) sums[x] = 0.0;
+	for(size_t x = 0; x < 2 * size_x; ++x) counts[x] = 0;
+	
+	for(size_t z = window[2]; z <= window[3]; ++z)
+	{
+		for(size_t y = window[0]; y <= window[1]; ++y)
+		{
+			const size_t first = DataCube_get_index(self, 0, y, z);
+			
+			for(size_t x = 0; x < size_x; ++x)
+			{
+				const float value = (self->data_type == -32) ? *((float *)(self->data) + first + x) : *((double *)(self->data) + first + x);
+				
+				if(IS_NAN(value)) continue;
+				++counts[2 * x];
+				
+				if(!squares) sums[x] += value;
+				else if(range == 0 || (range < 0 && value < 0.0) || (range > 0 && value > 0.0))
+				{
+					sums[x] += (double)value * (double)value;
+					++counts[2 * x + 1];
+				}
+			}
+		}
+	}
+	
+	return;
+}
+
+
+
 /// @brief Apply boxcar filter to spectral axis
 ///
 /// Public method for convolving each spectrum of the data cube
@@ -2015,12 +2691,12 @@ PUBLIC void DataCube_gaussian_filter(DataCube *self, const double sigma)
 	{
 		#pragma omp parallel
 		{
-			// Memory for one column
-			float  *column   = (float *)memory(MALLOC, self->axis_size[1], sizeof(float));
+			// Memory for one block of columns
+			float  *column   = (float *)memory(MALLOC, FILTER_BLOCK_SIZE * self->axis_size[1], sizeof(float));
 			
 			// Memory for boxcar filter to operate on
 			float  *data_row = (float *)memory(MALLOC, self->axis_size[0] + 2 * filter_radius, sizeof(float));
-			float  *data_col = (float *)memory(MALLOC, self->axis_size[1] + 2 * filter_radius, sizeof(float));
+			float  *data_col = (float *)memory(MALLOC, FILTER_BLOCK_SIZE * (self->axis_size[1] + 2 * filter_radius), sizeof(float));
 			
 			// Apply filter
 			#pragma omp for schedule(static)
@@ -2041,10 +2717,10 @@ PUBLIC void DataCube_gaussian_filter(DataCube *self, const double sigma)
 		{
 			// Memory for boxcar filter to operate on
 			double *data_row = (double *)memory(MALLOC, self->axis_size[0] + 2 * filter_radius, sizeof(double));
-			double *data_col = (double *)memory(MALLOC, self->axis_size[1] + 2 * filter_radius, sizeof(double));
+			double *data_col = (double *)memory(MALLOC, FILTER_BLOCK_SIZE * (self->axis_size[1] + 2 * filter_radius), sizeof(double));
 			
-			// Memory for one column
-			double *column   = (double *)memory(MALLOC, self->axis_size[1], sizeof(double));
+			// Memory for one block of columns
+			double *column   = (double *)memory(MALLOC, FILTER_BLOCK_SIZE * self->axis_size[1], sizeof(double));
 			
 			// Apply filter
 			#pragma omp for schedule(static)
@@ -2088,6 +2764,10 @@ PUBLIC void DataCube_gaussian_filter(DataCube *self, const double sigma)
 /// cover more than about 20% of the spectral band, as otherwise
 /// their presence may start to influence the fit.
 ///
+/// Spectra are processed in blocks of `DATACUBE_CONTSUB_BLOCK`
+/// adjacent pixels, with each step of the algorithm iterating over
+/// contiguous channel planes of the block wherever possible.
+///
 /// @param self       Object self-reference.
 /// @param order      Order of polynomial fit (0 or 1).
 /// @param shift      Amount by which to shift and subtract spectrum.
@@ -2127,157 +2807,211 @@ PUBLIC void DataCube_contsub(DataCube *self, unsigned int order, size_t shift, c
 	const size_t nxy = nx * ny;
 	size_t progress = 0;
 	
+	// Spectra are processed in blocks of adjacent pixels along the x axis,
+	// stored plane by plane such that each channel of the block is contiguous
+	// in memory. This allows the data to be read and written in contiguous
+	// runs rather than along the strided spectral axis, and all steps other
+	// than the noise measurement operate on entire planes of the block.
+	const size_t block = nx < DATACUBE_CONTSUB_BLOCK ? nx : DATACUBE_CONTSUB_BLOCK;
+	
 	#pragma omp parallel
 	{
-		double *spectrum     = (double *)memory(MALLOC, nz, sizeof(double));
-		double *spectrum_tmp = (double *)memory(MALLOC, nz, sizeof(double));
-		
-		// Loop over all spatial pixels
+		double *spectra = (double *)memory(MALLOC, nz * block, sizeof(double));
+		double *diff    = (double *)memory(MALLOC, nz * block, sizeof(double));
+		double *scratch = (double *)memory(MALLOC, nz, sizeof(double));
+		double *x_mean  = (double *)memory(MALLOC, block, sizeof(double));
+		double *y_mean  = (double *)memory(MALLOC, block, sizeof(double));
+		double *sum_xx  = (double *)memory(MALLOC, block, sizeof(double));
+		double *sum_xy  = (double *)memory(MALLOC, block, sizeof(double));
+		double *offset  = (double *)memory(MALLOC, block, sizeof(double));
+		double *slope   = (double *)memory(MALLOC, block, sizeof(double));
+		size_t *counter = (size_t *)memory(MALLOC, block, sizeof(size_t));
+		
+		// Loop over all rows
 		#pragma omp for schedule(static)
 		for(size_t y = 0; y < ny; ++y)
 		{
 			#pragma omp critical
 			progress_bar("Progress: ", progress++, ny - 1);
 			
-			for(size_t x = 0; x < nx; ++x)
+			for(size_t x0 = 0; x0 < nx; x0 += block)
 			{
-				// Extract spectrum
+				const size_t nb = (x0 + block <= nx) ? block : nx - x0;
+				const size_t start = x0 + nx * y;
+				
+				// Extract block of spectra one channel at a time
 				if(self->data_type == -32)
 				{
 					// 32-bit float
-					float *ptr = (float *)(self->data) + x + nx * y;
 					for(size_t i = 0; i < nz; ++i)
 					{
-						spectrum[i] = *ptr;
-						ptr += nxy;
+						const float *ptr = (float *)(self->data) + start + nxy * i;
+						double *plane = spectra + block * i;
+						for(size_t b = 0; b < nb; ++b) plane[b] = ptr[b];
 					}
 				}
 				else
 				{
 					// 64-bit float
-					double *ptr = (double *)(self->data) + x + nx * y;
 					for(size_t i = 0; i < nz; ++i)
 					{
-						spectrum[i] = *ptr;
-						ptr += nxy;
+						const double *ptr = (double *)(self->data) + start + nxy * i;
+						double *plane = spectra + block * i;
+						for(size_t b = 0; b < nb; ++b) plane[b] = ptr[b];
 					}
 				}
 				
-				// Shift and subtract spectrum from itself
+				// Shift and subtract spectra from themselves
 				for(size_t i = 0; i < nz; ++i)
 				{
-					spectrum_tmp[i] = (i < shift || i >= nz - shift) ? NAN : spectrum[i - shift] - spectrum[i + shift];
+					double *plane = diff + block * i;
+					
+					if(i < shift || i >= nz - shift)
+					{
+						for(size_t b = 0; b < nb; ++b) plane[b] = NAN;
+					}
+					else
+					{
+						const double *lower = spectra + block * (i - shift);
+						const double *upper = spectra + block * (i + shift);
+						for(size_t b = 0; b < nb; ++b) plane[b] = lower[b] - upper[b];
+					}
 				}
 				
-				// Robust noise measurement
-				const double rms = threshold * robust_noise_2_dbl(spectrum_tmp, nz);
-				
-				// Mask everything > rms
-				for(size_t i = 0; i < nz; ++i)
+				// Robust noise measurement and masking of emission in each spectrum
+				for(size_t b = 0; b < nb; ++b)
 				{
-					if(fabs(spectrum_tmp[i]) > rms)
+					size_t size = 0;
+					for(size_t i = 0; i < nz; ++i)
+					{
+						const double value = diff[block * i + b];
+						if(IS_NOT_NAN(value)) scratch[size++] = fabs(value);
+					}
+					if(size == 0) continue;  // No valid data, hence nothing to mask
+					
+					// Mask everything > rms
+					const double rms = threshold * (MAD_TO_STD * nth_element_dbl(scratch, size, size / 2));
+					
+					for(size_t i = 0; i < nz; ++i)
 					{
-						const size_t j_min = (i > padding) ? i - padding : 0;
-						const size_t j_max = (i + padding < nz) ? i + padding : nz - 1;
-						for(size_t j = j_min; j <= j_max; ++j) spectrum[j] = NAN;
+						if(fabs(diff[block * i + b]) > rms)
+						{
+							const size_t j_min = (i > padding) ? i - padding : 0;
+							const size_t j_max = (i + padding < nz) ? i + padding : nz - 1;
+							for(size_t j = j_min; j <= j_max; ++j) spectra[block * j + b] = NAN;
+						}
 					}
 				}
 				
 				// Measure means
-				double x_mean = 0.0;
-				double y_mean = 0.0;
-				size_t counter = 0;
+				for(size_t b = 0; b < nb; ++b)
+				{
+					x_mean[b] = 0.0;
+					y_mean[b] = 0.0;
+					counter[b] = 0;
+				}
 				
 				for(size_t i = 0; i < nz; ++i)
 				{
-					if(IS_NOT_NAN(spectrum[i]))
+					const double *plane = spectra + block * i;
+					
+					for(size_t b = 0; b < nb; ++b)
 					{
-						x_mean += i;
-						y_mean += spectrum[i];
-						++counter;
+						const bool valid = IS_NOT_NAN(plane[b]);
+						x_mean[b] = valid ? x_mean[b] + i : x_mean[b];
+						y_mean[b] = valid ? y_mean[b] + plane[b] : y_mean[b];
+						counter[b] += valid;
 					}
 				}
 				
-				if(counter == 0) continue;  // Cannot fit, as nothing left after filtering
-				x_mean /= counter;
-				y_mean /= counter;
+				for(size_t b = 0; b < nb; ++b)
+				{
+					if(counter[b] == 0) continue;
+					x_mean[b] /= counter[b];
+					y_mean[b] /= counter[b];
+				}
 				
+				// Fit 1st-order polynomial if requested
 				if(order)
 				{
-					// Fit and subtract 1st-order polynomial
-					double alpha = 0.0;
-					double beta = 0.0;
+					for(size_t b = 0; b < nb; ++b)
+					{
+						sum_xx[b] = 0.0;
+						sum_xy[b] = 0.0;
+					}
 					
 					for(size_t i = 0; i < nz; ++i)
 					{
-						if(IS_NOT_NAN(spectrum[i]))
+						const double *plane = spectra + block * i;
+						
+						for(size_t b = 0; b < nb; ++b)
 						{
-							alpha += (x_mean - i) * (x_mean - i);
-							beta  += (x_mean - i) * (y_mean - spectrum[i]);
+							const bool valid = IS_NOT_NAN(plane[b]);
+							sum_xx[b] = valid ? sum_xx[b] + (x_mean[b] - i) * (x_mean[b] - i) : sum_xx[b];
+							sum_xy[b] = valid ? sum_xy[b] + (x_mean[b] - i) * (y_mean[b] - plane[b]) : sum_xy[b];
 						}
 					}
+				}
+				
+				// Determine polynomial to be subtracted; a zero polynomial
+				// leaves spectra that cannot be fitted unchanged
+				for(size_t b = 0; b < nb; ++b)
+				{
+					offset[b] = 0.0;
+					slope[b]  = 0.0;
 					
-					if(alpha == 0)
-					{
-						// Cannot fit for some reason
-						warning("Polynomial fit failed at position (%zu, %zu).", x, y);
-						continue;
-					}
-					
-					beta /= alpha;
-					alpha = y_mean - beta * x_mean;
+					if(counter[b] == 0) continue;  // Cannot fit, as nothing left after filtering
 					
-					if(self->data_type == -32)
+					if(order)
 					{
-						// 32-bit float
-						float *ptr = (float *)(self->data) + x + nx * y;
-						for(size_t i = 0; i < nz; ++i)
+						if(sum_xx[b] == 0)
 						{
-							*ptr -= (alpha + beta * i);
-							ptr += nxy;
+							// Cannot fit for some reason
+							warning("Polynomial fit failed at position (%zu, %zu).", x0 + b, y);
+							continue;
 						}
+						
+						slope[b]  = sum_xy[b] / sum_xx[b];
+						offset[b] = y_mean[b] - slope[b] * x_mean[b];
 					}
-					else
+					else offset[b] = y_mean[b];
+				}
+				
+				// Subtract polynomial one channel at a time
+				if(self->data_type == -32)
+				{
+					// 32-bit float
+					for(size_t i = 0; i < nz; ++i)
 					{
-						// 64-bit float
-						double *ptr = (double *)(self->data) + x + nx * y;
-						for(size_t i = 0; i < nz; ++i)
-						{
-							*ptr -= (alpha + beta * i);
-							ptr += nxy;
-						}
+						float *ptr = (float *)(self->data) + start + nxy * i;
+						if(order) for(size_t b = 0; b < nb; ++b) ptr[b] -= (offset[b] + slope[b] * i);
+						else      for(size_t b = 0; b < nb; ++b) ptr[b] -= offset[b];
 					}
 				}
 				else
 				{
-					// Subtract mean
-					if(self->data_type == -32)
-					{
-						// 32-bit float
-						float *ptr = (float *)(self->data) + x + nx * y;
-						for(size_t i = 0; i < nz; ++i)
-						{
-							*ptr -= y_mean;
-							ptr += nxy;
-						}
-					}
-					else
+					// 64-bit float
+					for(size_t i = 0; i < nz; ++i)
 					{
-						// 64-bit float
-						double *ptr = (double *)(self->data) + x + nx * y;
-						for(size_t i = 0; i < nz; ++i)
-						{
-							*ptr -= y_mean;
-							ptr += nxy;
-						}
+						double *ptr = (double *)(self->data) + start + nxy * i;
+						if(order) for(size_t b = 0; b < nb; ++b) ptr[b] -= (offset[b] + slope[b] * i);
+						else      for(size_t b = 0; b < nb; ++b) ptr[b] -= offset[b];
 					}
 				}
 			}
 		}
 		
 		// Clean-up
-		free(spectrum);
-		free(spectrum_tmp);
+		free(spectra);
+		free(diff);
+		free(scratch);
+		free(x_mean);
+		free(y_mean);
+		free(sum_xx);
+		free(sum_xy);
+		free(offset);
+		free(slope);
+		free(counter);
 	}
 	
 	return;
@@ -2506,6 +3240,174 @@ PUBLIC void DataCube_set_masked_8(DataCube *self, const DataCube *maskCube, cons
 
 
 
+/// @brief Mask pixels of abs(value) > threshold in bit mask
+///
+/// Public method for setting the elements of the bit mask specified
+/// in `mask` when the absolute value of the corresponding pixel in the
+/// data cube is greater than the specified threshold. Similar to
+/// DataCube_mask_8(), but for bit-packed masks. Each thread processes
+/// entire 64-bit words of the mask, so no atomic operations are needed.
+///
+/// @param self       Object self-reference.
+/// @param mask       Pointer to bit mask.
+/// @param threshold  Flux threshold for masking operation.
+
+PUBLIC void DataCube_mask_bits(const DataCube *self, BitMask *mask, const double threshold)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	check_null(mask);
+	ensure(self->data_type == -32 || self->data_type == -64, ERR_USER_INPUT, "Data cube must be of floating-point type.");
+	ensure(BitMask_get_size(mask) == self->data_size, ERR_USER_INPUT, "Data cube and mask have different sizes.");
+	ensure(threshold > 0.0, ERR_USER_INPUT, "Threshold must be positive.");
+	
+	const size_t n_words = BitMask_get_words(mask);
+	
+	if(self->data_type == -32)
+	{
+		const float *ptr_data = (float *)(self->data);
+		
+		#pragma omp parallel for schedule(static)
+		for(size_t w = 0; w < n_words; ++w)
+		{
+			const size_t first = w * BITMASK_WORD_BITS;
+			const size_t last  = first + BITMASK_WORD_BITS < self->data_size ? first + BITMASK_WORD_BITS : self->data_size;
+			uint64_t bits = 0;
+			
+			for(size_t i = first; i < last; ++i) if(fabs(ptr_data[i]) > threshold) bits |= (uint64_t)1 << (i - first);
+			if(bits) BitMask_set_word(mask, w, bits);
+		}
+	}
+	else
+	{
+		const double *ptr_data = (double *)(self->data);
+		
+		#pragma omp parallel for schedule(static)
+		for(size_t w = 0; w < n_words; ++w)
+		{
+			const size_t first = w * BITMASK_WORD_BITS;
+			const size_t last  = first + BITMASK_WORD_BITS < self->data_size ? first + BITMASK_WORD_BITS : self->data_size;
+			uint64_t bits = 0;
+			
+			for(size_t i = first; i < last; ++i) if(fabs(ptr_data[i]) > threshold) bits |= (uint64_t)1 << (i - first);
+			if(bits) BitMask_set_word(mask, w, bits);
+		}
+	}
+	
+	return;
+}
+
+
+
+/// @brief Set pixels masked in bit mask to constant value
+///
+/// Public method for replacing the values of all pixels in the
+/// data cube that are set in the bit mask with their signum
+/// multiplied by the specified value. Same as DataCube_set_masked_8(),
+/// but for bit-packed masks. Words of the mask without any set bits
+/// are skipped.
+///
+/// @param self   Object self-reference.
+/// @param mask   Pointer to bit mask.
+/// @param value  Flux value to replace pixels with.
+
+PUBLIC void DataCube_set_masked_bits(DataCube *self, const BitMask *mask, const double value)
+{
+	check_null(self);
+	check_null(self->data);
+	check_null(mask);
+	ensure(self->data_type == -32 || self->data_type == -64, ERR_USER_INPUT, "Data cube must be of floating-point type.");
+	ensure(BitMask_get_size(mask) == self->data_size, ERR_USER_INPUT, "Data cube and mask have different sizes.");
+	
+	const size_t n_words = BitMask_get_words(mask);
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t w = 0; w < n_words; ++w)
+	{
+		uint64_t bits = BitMask_get_word(mask, w);
+		
+		while(bits)
+		{
+			// Index of lowest set bit
+			size_t bit = 0;
+			while(!((bits >> bit) & 1u)) ++bit;
+			bits &= bits - 1;
+			
+			const size_t i = w * BITMASK_WORD_BITS + bit;
+			if(self->data_type == -32) *((float *)(self->data) + i) = copysign(value, *((float *)(self->data) + i));
+			else *((double *)(self->data) + i) = copysign(value, *((double *)(self->data) + i));
+		}
+	}
+	
+	return;
+}
+
+
+
+/// @brief Copy bit mask into integer mask
+///
+/// Public method for setting all pixels of the integer mask cube
+/// that are set in the specified bit mask to `value`. All other
+/// pixels will remain unchanged. This can be used to transfer the
+/// bit-packed output of the source finders into the 32-bit mask
+/// required by the linker, or into an 8-bit cube for output.
+///
+/// @param self    Integer target mask.
+/// @param source  Bit mask to be copied.
+/// @param value   Mask value to set in target mask.
+///
+/// @return Number of masked pixels.
+
+PUBLIC size_t DataCube_copy_bitmask(DataCube *self, const BitMask *source, const long int value)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	check_null(source);
+	ensure(self->data_type > 0, ERR_USER_INPUT, "Target mask cube must be of integer type.");
+	ensure(BitMask_get_size(source) == self->data_size, ERR_USER_INPUT, "Mask cube and bit mask have different sizes.");
+	
+	const size_t n_words = BitMask_get_words(source);
+	size_t counter = 0;
+	
+	#pragma omp parallel for schedule(static) reduction(+: counter)
+	for(size_t w = 0; w < n_words; ++w)
+	{
+		uint64_t bits = BitMask_get_word(source, w);
+		
+		while(bits)
+		{
+			// Index of lowest set bit
+			size_t bit = 0;
+			while(!((bits >> bit) & 1u)) ++bit;
+			bits &= bits - 1;
+			
+			const size_t i = w * BITMASK_WORD_BITS + bit;
+			switch(self->data_type)
+			{
+				case 8:
+					*((uint8_t *)(self->data) + i) = (uint8_t)value;
+					break;
+				case 16:
+					*((int16_t *)(self->data) + i) = (int16_t)value;
+					break;
+				case 32:
+					*((int32_t *)(self->data) + i) = (int32_t)value;
+					break;
+				case 64:
+					*((int64_t *)(self->data) + i) = (int64_t)value;
+					break;
+			}
+			++counter;
+		}
+	}
+	
+	return counter;
+}
+
+
+
 /// @brief Replace masked pixels with the specified value
 ///
 /// Public method for replacing the values of all pixels in the
@@ -2666,130 +3568,534 @@ PUBLIC size_t DataCube_copy_mask_32(DataCube *self, const DataCube *source, cons
 
 
 
-/// @brief Grow mask and update basic source parameters
+/// @brief Determine next batch of independent sources
 ///
-/// Private method for growing the mask of the source identified by
-/// `src_id` radially outwards using a circular kernel of the specified
-/// radius (in pixels). The algorithm will update the relevant source
-/// parameters (which must be provided as pointers holding the old
-/// values prior to mask growth), including fluxes, flags and source
-/// bounding boxes. In addition, the user can specify a mask value to
-/// which all newly added pixels will be set in the source mask.
+/// Private method for determining the next batch of consecutive
+/// sources, starting with source `first`, whose dilation regions do
+/// not overlap with each other. The sources of a batch can then be
+/// dilated in parallel without changing the result, as none of them
+/// can read or write any mask pixels accessed by another source of
+/// the same batch. The dilation regions must be provided as an array
+/// of 6 inclusive boundaries, `x_min`, `x_max`, `y_min`, `y_max`,
+/// `z_min` and `z_max`, per source. The size of a batch is limited to
+/// `DATACUBE_DILATION_BATCH` sources.
 ///
-/// @param self        Data cube.
-/// @param mask        Mask cube.
-/// @param src_id      ID of source to be grown.
-/// @param radius      Radius by which to grow (in pixels).
-/// @param mask_value  Value to set grown pixels to in the mask.
-/// @param f_sum       Summed flux density prior to mask growth.
-/// @param f_min       Minimum flux density prior to mask growth.
-/// @param f_max       Maximum flux density prior to mask growth.
-/// @param n_pix       Number of pixels in mask prior to mask growth.
-/// @param flag        Source flag prior to mask growth.
-/// @param x_min       Source bounding box prior to mask growth.
-/// @param x_max       Source bounding box prior to mask growth.
-/// @param y_min       Source bounding box prior to mask growth.
-/// @param y_max       Source bounding box prior to mask growth.
-/// @param z_min       Source bounding box prior to mask growth.
-/// @param z_max       Source bounding box prior to mask growth.
-///
-/// @note As the algorithm only grows the mask in x and y, the
-///       bounding box in z will not change and will need to be
-///       provided by value rather than by reference.
-
-PRIVATE void DataCube_grow_mask_xy(const DataCube *self, DataCube *mask, const long int src_id, const size_t radius, const long int mask_value, double *f_sum, double *f_min, double *f_max, size_t *n_pix, long int *flag, size_t *x_min, size_t *x_max, size_t *y_min, size_t *y_max, const size_t z_min, const size_t z_max)
+/// @param box    Array of dilation regions of all sources.
+/// @param first  Index of the first source of the batch.
+/// @param size   Total number of sources.
+///
+/// @return Index of the first source not included in the batch.
+
+PRIVATE size_t DataCube_dilation_batch(const size_t *box, const size_t first, const size_t size)
 {
-	// Set loop boundaries from bounding box
-	const size_t x1 = *x_min;
-	const size_t x2 = *x_max;
-	const size_t y1 = *y_min;
-	const size_t y2 = *y_max;
-	
-	// Additional variables
-	const double radius2 = (double)(radius * radius);
-	size_t xx_min = 0;
-	size_t xx_max = 0;
-	size_t yy_min = 0;
-	size_t yy_max = 0;
-	
-	// Loop over source bounding box
-	for(size_t z = z_min; z <= z_max; ++z)
-	{
-		for(size_t y = y1; y <= y2; ++y)
-		{
-			for(size_t x = x1; x <= x2; ++x)
-			{
-				const long int id = DataCube_get_data_int(mask, x, y, z);
-				
-				if(id == src_id)
-				{
-					// Define boundaries of box to be processed
-					if(x < radius) xx_min = 0, *flag |= 1L;
-					else xx_min = x - radius;
-					
-					if(x + radius >= self->axis_size[0]) xx_max = self->axis_size[0] - 1, *flag |= 1L;
-					else xx_max = x + radius;
-					
-					if(y < radius) yy_min = 0, *flag |= 1L;
-					else yy_min = y - radius;
-					
-					if(y + radius >= self->axis_size[1]) yy_max = self->axis_size[1] - 1, *flag |= 1L;
-					else yy_max = y + radius;
-					
-					// Loop over that box
-					for(size_t yy = yy_min; yy <= yy_max; ++yy)
-					{
-						for(size_t xx = xx_min; xx <= xx_max; ++xx)
-						{
-							const double tmp1 = (double)xx - (double)x;
-							const double tmp2 = (double)yy - (double)y;
-							if(tmp1 * tmp1 + tmp2 * tmp2 > radius2) continue;
-							
-							const long int id_new = DataCube_get_data_int(mask, xx, yy, z);
-							if(id_new == 0)
-							{
-								const double value = DataCube_get_data_flt(self, xx, yy, z);
-								
-								if(IS_NOT_NAN(value))
-								{
-									DataCube_set_data_int(mask, xx, yy, z, -1);
-									*f_sum += value;
-									if(value < *f_min) *f_min = value;
-									if(value > *f_max) *f_max = value;
-									if(xx < *x_min) *x_min = xx;
-									if(xx > *x_max) *x_max = xx;
-									if(yy < *y_min) *y_min = yy;
-									if(yy > *y_max) *y_max = yy;
-									*n_pix += 1;
-								}
-								else *flag |= 4L;
-							}
-							else if(id_new > 0 && id_new != src_id) *flag |= 8L;
-						} // END loop over xx
-					} // END loop over yy
-				}
-			} // END loop over x
-		} // END loop over y
-	} // END loop over z
+	size_t last = first + 1;
 	
-	// Replace mask values as per user request
-	for(size_t z = z_min; z <= z_max; ++z)
+	while(last < size && last - first < DATACUBE_DILATION_BATCH)
 	{
-		for(size_t y = *y_min; y <= *y_max; ++y)
+		const size_t *b = box + 6 * last;
+		
+		for(size_t j = first; j < last; ++j)
 		{
-			for(size_t x = *x_min; x <= *x_max; ++x)
-			{
-				if(DataCube_get_data_int(mask, x, y, z) == -1) DataCube_set_data_int(mask, x, y, z, mask_value);
-			}
+			const size_t *a = box + 6 * j;
+			if(a[0] <= b[1] && b[0] <= a[1] && a[2] <= b[3] && b[2] <= a[3] && a[4] <= b[5] && b[4] <= a[5]) return last;
 		}
+		
+		++last;
 	}
 	
-	return;
+	return last;
 }
 
 
 
-/// @brief Mask dilation in the spatial plane
+/// @brief Determine dilation regions of all sources
+///
+/// Private method for extracting the bounding box of each source in
+/// the catalogue and extending it by the specified number of pixels
+/// in x and y or z, depending on the direction of dilation. The
+/// resulting regions, clipped to the cube boundaries, are returned as
+/// an array of 6 inclusive boundaries per source for use with
+/// `DataCube_dilation_batch()`. It is the caller's responsibility to
+/// release the returned array again.
+///
+/// @param self       Data cube.
+/// @param cat        Source catalogue.
+/// @param extent_xy  Extension in x and y.
+/// @param extent_z   Extension in z.
+///
+/// @return Array of dilation regions of all sources.
+
+PRIVATE size_t *DataCube_dilation_boxes(const DataCube *self, const Catalog *cat, const size_t extent_xy, const size_t extent_z)
+{
+	const size_t cat_size = Catalog_get_size(cat);
+	size_t *box = (size_t *)memory(MALLOC, 6 * cat_size, sizeof(size_t));
+	
+	for(size_t i = 0; i < cat_size; ++i)
+	{
+		const Source *src = Catalog_get_source(cat, i);
+		size_t *b = box + 6 * i;
+		
+		// Check source ID
+		ensure(Source_get_par_by_name_int(src, "id"), ERR_USER_INPUT, "Source ID missing from catalogue; mask dilation failed.");
+		
+		// Get source bounding box
+		const size_t x_min = Source_get_par_by_name_int(src, "x_min");
+		const size_t x_max = Source_get_par_by_name_int(src, "x_max");
+		const size_t y_min = Source_get_par_by_name_int(src, "y_min");
+		const size_t y_max = Source_get_par_by_name_int(src, "y_max");
+		const size_t z_min = Source_get_par_by_name_int(src, "z_min");
+		const size_t z_max = Source_get_par_by_name_int(src, "z_max");
+		ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_INDEX_RANGE, "Illegal source bounding box: min > max!");
+		ensure(x_max < self->axis_size[0] && y_max < self->axis_size[1] && z_max < self->axis_size[2], ERR_INDEX_RANGE, "Source bounding box outside data cube boundaries.");
+		
+		// Extend bounding box
+		b[0] = x_min > extent_xy ? x_min - extent_xy : 0;
+		b[1] = x_max + extent_xy;
+		b[2] = y_min > extent_xy ? y_min - extent_xy : 0;
+		b[3] = y_max + extent_xy;
+		b[4] = z_min > extent_z ? z_min - extent_z : 0;
+		b[5] = z_max + extent_z;
+	}
+	
+	return box;
+}
+
+
+
+/// @brief Dilate mask of a single source in the spatial plane
+///
+/// Private method for dilating the mask of a single source in the
+/// spatial plane as described in `DataCube_dilate_mask_xy()`. Rather
+/// than growing the original mask by the full kernel radius in each
+/// iteration, only the pixels on the boundary of the original mask
+/// are considered, and in iteration `r` they are merely combined with
+/// the ring of kernel offsets at distances of `(r - 1, r]`. Hence,
+/// only the shell of pixels newly added in each iteration will be
+/// visited, and the flux and other source parameters are updated
+/// incrementally. Pixels added in an iteration that is subsequently
+/// rejected are reset to 0 again.
+///
+/// @param self        Data cube.
+/// @param mask        Mask cube.
+/// @param src         Source to be dilated.
+/// @param index       Index of the source in the catalogue.
+/// @param iter_max    Maximum number of iterations.
+/// @param threshold   Threshold for relative flux increase.
+/// @param ring        Pixel offsets, `dx` and `dy`, of the kernel
+///                    ordered by ring.
+/// @param ring_start  Index of the first offset of each ring; ring
+///                    `r` ends where ring `r + 1` starts.
+
+PRIVATE void DataCube_dilate_source_xy(const DataCube *self, DataCube *mask, Source *src, const size_t index, const size_t iter_max, const double threshold, const long int *ring, const size_t *ring_start)
+{
+	const size_t nx = self->axis_size[0];
+	const size_t ny = self->axis_size[1];
+	const size_t nxy = nx * ny;
+	
+	// Get source ID and bounding box
+	const long int src_id = Source_get_par_by_name_int(src, "id");
+	const size_t x1 = Source_get_par_by_name_int(src, "x_min");
+	const size_t x2 = Source_get_par_by_name_int(src, "x_max");
+	const size_t y1 = Source_get_par_by_name_int(src, "y_min");
+	const size_t y2 = Source_get_par_by_name_int(src, "y_max");
+	const size_t z1 = Source_get_par_by_name_int(src, "z_min");
+	const size_t z2 = Source_get_par_by_name_int(src, "z_max");
+	
+	// Get fluxes and other relevant source parameters
+	double   f_sum = Source_get_par_by_name_flt(src, "f_sum");
+	double   f_min = Source_get_par_by_name_flt(src, "f_min");
+	double   f_max = Source_get_par_by_name_flt(src, "f_max");
+	size_t   n_pix = Source_get_par_by_name_int(src, "n_pix");
+	long int flag  = Source_get_par_by_name_int(src, "flag");
+	size_t   x_min = x1;
+	size_t   x_max = x2;
+	size_t   y_min = y1;
+	size_t   y_max = y2;
+	const bool is_negative = (f_sum < 0.0);
+	
+	// Collect boundary pixels of source mask in each channel; interior
+	// pixels can be ignored, as their kernel is entirely covered by the
+	// kernels of their neighbours
+	size_t  cap_edge = 64;
+	size_t  n_edge   = 0;
+	size_t *edge     = (size_t *)memory(MALLOC, cap_edge, sizeof(size_t));
+	size_t  sx_min   = SIZE_MAX;
+	size_t  sx_max   = 0;
+	size_t  sy_min   = SIZE_MAX;
+	size_t  sy_max   = 0;
+	
+	for(size_t z = z1; z <= z2; ++z)
+	{
+		for(size_t y = y1; y <= y2; ++y)
+		{
+			for(size_t x = x1; x <= x2; ++x)
+			{
+				if(DataCube_get_data_int(mask, x, y, z) != src_id) continue;
+				
+				if(x < sx_min) sx_min = x;
+				if(x > sx_max) sx_max = x;
+				if(y < sy_min) sy_min = y;
+				if(y > sy_max) sy_max = y;
+				
+				bool is_edge = (x == x1 || x == x2 || y == y1 || y == y2);
+				for(size_t yy = y - 1; !is_edge && yy <= y + 1; ++yy)
+				{
+					for(size_t xx = x - 1; !is_edge && xx <= x + 1; ++xx)
+					{
+						is_edge = DataCube_get_data_int(mask, xx, yy, z) != src_id;
+					}
+				}
+				
+				if(is_edge)
+				{
+					if(n_edge == cap_edge) edge = (size_t *)memory_realloc(edge, cap_edge *= 2, sizeof(size_t));
+					edge[n_edge++] = DataCube_get_index(self, x, y, z);
+				}
+			}
+		}
+	}
+	
+	// List of pixels added so far; the first n_done of them have been accepted
+	size_t  cap_added = 64;
+	size_t  n_added   = 0;
+	size_t  n_done    = 0;
+	size_t *added     = (size_t *)memory(MALLOC, cap_added, sizeof(size_t));
+	
+	if(threshold >= 0.0) message_verb(self->verbosity, "Source %zu", index);
+	
+	// Iterate
+	for(size_t iter = 1; iter <= iter_max; ++iter)
+	{
+		double   f_sum_new = f_sum;
+		double   f_min_new = f_min;
+		double   f_max_new = f_max;
+		long int flag_new  = flag;
+		size_t   x_min_new = x_min;
+		size_t   x_max_new = x_max;
+		size_t   y_min_new = y_min;
+		size_t   y_max_new = y_max;
+		
+		// Kernel touching edge of image?
+		if(sx_min < iter || sx_max + iter >= nx || sy_min < iter || sy_max + iter >= ny) flag_new |= 1L;
+		
+		// Add shell of pixels at distance (iter - 1, iter] from source mask
+		for(size_t i = 0; i < n_edge; ++i)
+		{
+			const size_t z = edge[i] / nxy;
+			const size_t y = (edge[i] % nxy) / nx;
+			const size_t x = edge[i] % nx;
+			
+			for(size_t j = ring_start[iter]; j < ring_start[iter + 1]; ++j)
+			{
+				const long int xl = (long int)x + ring[2 * j];
+				const long int yl = (long int)y + ring[2 * j + 1];
+				if(xl < 0 || yl < 0 || xl >= (long int)nx || yl >= (long int)ny) continue;
+				const size_t xx = xl;
+				const size_t yy = yl;
+				
+				const long int id_new = DataCube_get_data_int(mask, xx, yy, z);
+				if(id_new == 0)
+				{
+					const double value = DataCube_get_data_flt(self, xx, yy, z);
+					
+					if(IS_NOT_NAN(value))
+					{
+						DataCube_set_data_int(mask, xx, yy, z, -1);
+						if(n_added == cap_added) added = (size_t *)memory_realloc(added, cap_added *= 2, sizeof(size_t));
+						added[n_added++] = DataCube_get_index(self, xx, yy, z);
+						f_sum_new += value;
+						if(value < f_min_new) f_min_new = value;
+						if(value > f_max_new) f_max_new = value;
+						if(xx < x_min_new) x_min_new = xx;
+						if(xx > x_max_new) x_max_new = xx;
+						if(yy < y_min_new) y_min_new = yy;
+						if(yy > y_max_new) y_max_new = yy;
+					}
+					else flag_new |= 4L;
+				}
+				else if(id_new > 0 && id_new != src_id) flag_new |= 8L;
+			}
+		}
+		
+		if(threshold >= 0.0)
+		{
+			// Print information
+			message_verb(self->verbosity, " - Iteration %zu: df = %.3f (%.3f%%)", iter, f_sum_new - f_sum, 100.0 * (f_sum_new - f_sum) / f_sum);
+			
+			// Check if flux increased within boundaries
+			if(!((is_negative && (f_sum_new - f_sum) < threshold * f_sum) || (!is_negative && (f_sum_new - f_sum) > threshold * f_sum)))
+			{
+				// No significant improvement; reset shell and stop iterating
+				DataCube_set_data_list(mask, added + n_done, n_added - n_done, 0);
+				n_added = n_done;
+				break;
+			}
+		}
+		
+		// Accept shell
+		f_sum = f_sum_new;
+		f_min = f_min_new;
+		f_max = f_max_new;
+		flag  = flag_new;
+		n_pix += n_added - n_done;
+		n_done = n_added;
+		x_min = x_min_new;
+		x_max = x_max_new;
+		y_min = y_min_new;
+		y_max = y_max_new;
+	} // END iteration loop
+	
+	// Assign accepted pixels to source
+	DataCube_set_data_list(mask, added, n_done, src_id);
+	
+	// Update source parameters with new values
+	Source_set_par_flt(src, "f_min", f_min, NULL, NULL);
+	Source_set_par_flt(src, "f_max", f_max, NULL, NULL);
+	Source_set_par_flt(src, "f_sum", f_sum, NULL, NULL);
+	Source_set_par_int(src, "x_min", x_min, NULL, NULL);
+	Source_set_par_int(src, "x_max", x_max, NULL, NULL);
+	Source_set_par_int(src, "y_min", y_min, NULL, NULL);
+	Source_set_par_int(src, "y_max", y_max, NULL, NULL);
+	Source_set_par_int(src, "n_pix", n_pix, NULL, NULL);
+	Source_set_par_int(src, "flag",  flag,  NULL, NULL);
+	
+	// Clean up
+	free(edge);
+	free(added);
+	
+	return;
+}
+
+
+
+/// @brief Set list of pixels to integer value
+///
+/// Private method for setting all pixels whose indices are listed in
+/// the specified array to the specified integer value.
+///
+/// @param self   Object self-reference.
+/// @param list   Array of pixel indices.
+/// @param size   Number of pixel indices in array.
+/// @param value  Value to set the pixels to.
+
+PRIVATE void DataCube_set_data_list(DataCube *self, const size_t *list, const size_t size, const long int value)
+{
+	size_t x, y, z;
+	
+	for(size_t i = 0; i < size; ++i)
+	{
+		DataCube_get_xyz(self, list[i], &x, &y, &z);
+		DataCube_set_data_int(self, x, y, z, value);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Dilate mask of a single source along spectral axis
+///
+/// Private method for dilating the mask of a single source along
+/// the spectral axis as described in `DataCube_dilate_mask_z()`.
+/// Only the first iteration needs to check all pixels of the source
+/// mask; in each subsequent iteration the dilation can only progress
+/// from the pixels added in the previous iteration, which form the
+/// frontier of the mask. The frontier is kept in ascending order of
+/// pixel index, so the flux increase is summed in the same order as
+/// in a full scan of the bounding box.
+///
+/// @param self       Data cube.
+/// @param mask       Mask cube.
+/// @param src        Source to be dilated.
+/// @param index      Index of the source in the catalogue.
+/// @param iter_max   Maximum number of iterations.
+/// @param threshold  Threshold for relative flux increase.
+
+PRIVATE void DataCube_dilate_source_z(const DataCube *self, DataCube *mask, Source *src, const size_t index, const size_t iter_max, const double threshold)
+{
+	const size_t nz  = self->axis_size[2];
+	const size_t nxy = self->axis_size[0] * self->axis_size[1];
+	message_verb(self->verbosity, "Source %zu", index + 1);
+	
+	// Get source ID & flag
+	const long int src_id = Source_get_par_by_name_int(src, "id");
+	long int flag = Source_get_par_by_name_int(src, "flag");
+	
+	// Get source bounding box
+	const size_t x_min = Source_get_par_by_name_int(src, "x_min");
+	const size_t x_max = Source_get_par_by_name_int(src, "x_max");
+	const size_t y_min = Source_get_par_by_name_int(src, "y_min");
+	const size_t y_max = Source_get_par_by_name_int(src, "y_max");
+	size_t z_min = Source_get_par_by_name_int(src, "z_min");
+	size_t z_max = Source_get_par_by_name_int(src, "z_max");
+	
+	// Get flux and check if source has negative flux
+	double f_sum = Source_get_par_by_name_flt(src, "f_sum");
+	double f_min = Source_get_par_by_name_flt(src, "f_min");
+	double f_max = Source_get_par_by_name_flt(src, "f_max");
+	size_t n_pix = Source_get_par_by_name_int(src, "n_pix");
+	const bool is_negative = (f_sum < 0.0);
+	
+	// Initial frontier is the entire source mask
+	size_t  cap_front = 64;
+	size_t  n_front   = 0;
+	size_t *front     = (size_t *)memory(MALLOC, cap_front, sizeof(size_t));
+	
+	for(size_t z = z_min; z <= z_max; ++z)
+	{
+		for(size_t y = y_min; y <= y_max; ++y)
+		{
+			for(size_t x = x_min; x <= x_max; ++x)
+			{
+				if(DataCube_get_data_int(mask, x, y, z) == src_id)
+				{
+					if(n_front == cap_front) front = (size_t *)memory_realloc(front, cap_front *= 2, sizeof(size_t));
+					front[n_front++] = DataCube_get_index(self, x, y, z);
+				}
+			}
+		}
+	}
+	
+	// Pixels added below and above the frontier; each list is in ascending order
+	size_t  cap_new = cap_front;
+	size_t  n_lower = 0;
+	size_t  n_upper = 0;
+	size_t *lower   = (size_t *)memory(MALLOC, cap_new, sizeof(size_t));
+	size_t *upper   = (size_t *)memory(MALLOC, cap_new, sizeof(size_t));
+	
+	// Iterate
+	for(size_t iter = 0; iter < iter_max && n_front; ++iter)
+	{
+		double df_sum = 0.0;
+		size_t z_min_new = z_min;
+		size_t z_max_new = z_max;
+		n_lower = 0;
+		n_upper = 0;
+		
+		if(cap_new < n_front)
+		{
+			cap_new = n_front;
+			lower = (size_t *)memory_realloc(lower, cap_new, sizeof(size_t));
+			upper = (size_t *)memory_realloc(upper, cap_new, sizeof(size_t));
+		}
+		
+		// Loop over frontier
+		for(size_t i = 0; i < n_front; ++i)
+		{
+			size_t x, y, z;
+			DataCube_get_xyz(self, front[i], &x, &y, &z);
+			
+			// Check lower z
+			if(z > 0)
+			{
+				const long int id_new = DataCube_get_data_int(mask, x, y, z - 1);
+				if(id_new == 0)
+				{
+					const double value = DataCube_get_data_flt(self, x, y, z - 1);
+					if(IS_NOT_NAN(value))
+					{
+						DataCube_set_data_int(mask, x, y, z - 1, -1);
+						lower[n_lower++] = front[i] - nxy;
+						df_sum += value;
+						if(z - 1 < z_min_new) z_min_new = z - 1;
+					}
+					else flag |= 4L;
+				}
+				else if(id_new > 0 && id_new != src_id) flag |= 8L;
+			}
+			else flag |= 2L;
+			
+			// Check higher z
+			if(z < nz - 1)
+			{
+				const long int id_new = DataCube_get_data_int(mask, x, y, z + 1);
+				if(id_new == 0)
+				{
+					const double value = DataCube_get_data_flt(self, x, y, z + 1);
+					if(IS_NOT_NAN(value))
+					{
+						DataCube_set_data_int(mask, x, y, z + 1, -1);
+						upper[n_upper++] = front[i] + nxy;
+						df_sum += value;
+						if(z + 1 > z_max_new) z_max_new = z + 1;
+					}
+					else flag |= 4L;
+				}
+				else if(id_new > 0 && id_new != src_id) flag |= 8L;
+			}
+			else flag |= 2L;
+		}
+		
+		// Check if flux increased within boundaries
+		if(threshold < 0.0 || (is_negative && df_sum < threshold * f_sum) || (!is_negative && df_sum > threshold * f_sum))
+		{
+			// Mask should be grown
+			f_sum += df_sum;
+			z_min = z_min_new;
+			z_max = z_max_new;
+			
+			// Merge new pixels into next frontier in ascending order...
+			if(cap_front < n_lower + n_upper)
+			{
+				cap_front = n_lower + n_upper;
+				front = (size_t *)memory_realloc(front, cap_front, sizeof(size_t));
+			}
+			
+			n_front = 0;
+			for(size_t i = 0, j = 0; i < n_lower || j < n_upper;)
+			{
+				if(j == n_upper || (i < n_lower && lower[i] < upper[j])) front[n_front++] = lower[i++];
+				else front[n_front++] = upper[j++];
+			}
+			
+			for(size_t i = 0; i < n_front; ++i)
+			{
+				size_t x, y, z;
+				DataCube_get_xyz(self, front[i], &x, &y, &z);
+				
+				// ...switch mask value to source ID...
+				DataCube_set_data_int(mask, x, y, z, src_id);
+				
+				// ...and update n_pix, f_min and f_max if necessary
+				const double value = DataCube_get_data_flt(self, x, y, z);
+				if(value < f_min) f_min = value;
+				if(value > f_max) f_max = value;
+				++n_pix;
+			}
+			
+			message_verb(self->verbosity, " - Iteration %zu: df = %.3f (%.3f%%)", iter + 1, df_sum, 100.0 * df_sum / (f_sum - df_sum));
+		}
+		else
+		{
+			// No significant improvement; clean up again and exit
+			DataCube_set_data_list(mask, lower, n_lower, 0);
+			DataCube_set_data_list(mask, upper, n_upper, 0);
+			
+			// Stop iterating
+			break;
+		}
+	} // END iteration loop
+	
+	// Update source parameters
+	Source_set_par_flt(src, "f_min", f_min, NULL, NULL);
+	Source_set_par_flt(src, "f_max", f_max, NULL, NULL);
+	Source_set_par_flt(src, "f_sum", f_sum, NULL, NULL);
+	Source_set_par_int(src, "z_min", z_min, NULL, NULL);
+	Source_set_par_int(src, "z_max", z_max, NULL, NULL);
+	Source_set_par_int(src, "n_pix", n_pix, NULL, NULL);
+	Source_set_par_int(src, "flag",  flag,  NULL, NULL);
+	
+	// Clean up
+	free(front);
+	free(lower);
+	free(upper);
+	
+	return;
+}
+
+
+
+/// @brief Mask dilation in the spatial plane
 ///
 /// Public method for dilating the masks of all sources found in
 /// catalogue in the spatial plane. Dilation will occur iteratively
@@ -2808,6 +4114,10 @@ PRIVATE void DataCube_grow_mask_xy(const DataCube *self, DataCube *mask, const l
 /// 1 pixel in each iteration. The source mask should therefore
 /// approach a circle for a large number of iterations.
 ///
+/// Sources whose dilation regions do not overlap are dilated in
+/// parallel in batches of consecutive catalogue entries, which
+/// yields the same result as dilating all sources one by one.
+///
 /// @param self       Data cube.
 /// @param mask       Mask cube.
 /// @param cat        Source catalogue.
@@ -2835,141 +4145,50 @@ PUBLIC void DataCube_dilate_mask_xy(const DataCube *self, DataCube *mask, Catalo
 		return;
 	}
 	
-	// Loop over all sources in catalogue
-	for(size_t i = 0; i < cat_size; ++i)
+	// Determine dilation regions of all sources
+	size_t *box = DataCube_dilation_boxes(self, cat, iter_max, 0);
+	
+	// Precompute pixel offsets of circular kernel ordered by ring
+	const long int radius = iter_max;
+	size_t   *ring_start = (size_t *)memory(MALLOC, iter_max + 2, sizeof(size_t));
+	long int *ring       = (long int *)memory(MALLOC, 2 * (2 * iter_max + 1) * (2 * iter_max + 1), sizeof(long int));
+	size_t    n_ring     = 0;
+	
+	for(long int r = 0; r <= radius; ++r)
 	{
-		// Extract source
-		Source *src = Catalog_get_source(cat, i);
-		
-		// Get source ID
-		const long int src_id = Source_get_par_by_name_int(src, "id");
-		ensure(src_id, ERR_USER_INPUT, "Source ID missing from catalogue; mask dilation failed.");
-		
-		// Get source bounding box
-		const size_t x_min = Source_get_par_by_name_int(src, "x_min");
-		const size_t x_max = Source_get_par_by_name_int(src, "x_max");
-		const size_t y_min = Source_get_par_by_name_int(src, "y_min");
-		const size_t y_max = Source_get_par_by_name_int(src, "y_max");
-		const size_t z_min = Source_get_par_by_name_int(src, "z_min");
-		const size_t z_max = Source_get_par_by_name_int(src, "z_max");
-		ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_INDEX_RANGE, "Illegal source bounding box: min > max!");
-		ensure(x_max < self->axis_size[0] && y_max < self->axis_size[1] && z_max < self->axis_size[2], ERR_INDEX_RANGE, "Source bounding box outside data cube boundaries.");
-		
-		// Get fluxes and check if negative
-		const double f_sum = Source_get_par_by_name_flt(src, "f_sum");
-		const double f_min = Source_get_par_by_name_flt(src, "f_min");
-		const double f_max = Source_get_par_by_name_flt(src, "f_max");
-		const bool is_negative = (f_sum < 0.0);
+		ring_start[r] = n_ring;
 		
-		// Get other relevant source parameters
-		const size_t n_pix = Source_get_par_by_name_int(src, "n_pix");
-		const long int flag = Source_get_par_by_name_int(src, "flag");
-		
-		// If threshold negative, simply dilate and move on
-		if(threshold < 0.0)
-		{
-			double f_sum_new = f_sum;
-			double f_min_new = f_min;
-			double f_max_new = f_max;
-			long int flag_new = flag;
-			size_t n_pix_new = n_pix;
-			size_t x_min_new = x_min;
-			size_t x_max_new = x_max;
-			size_t y_min_new = y_min;
-			size_t y_max_new = y_max;
-			
-			// Dilate by iter_max
-			DataCube_grow_mask_xy(self, mask, src_id, iter_max, src_id, &f_sum_new, &f_min_new, &f_max_new, &n_pix_new, &flag_new, &x_min_new, &x_max_new, &y_min_new, &y_max_new, z_min, z_max);
-			
-			// Update source parameters with new values
-			Source_set_par_flt(src, "f_min", f_min_new, NULL, NULL);
-			Source_set_par_flt(src, "f_max", f_max_new, NULL, NULL);
-			Source_set_par_flt(src, "f_sum", f_sum_new, NULL, NULL);
-			Source_set_par_int(src, "x_min", x_min_new, NULL, NULL);
-			Source_set_par_int(src, "x_max", x_max_new, NULL, NULL);
-			Source_set_par_int(src, "y_min", y_min_new, NULL, NULL);
-			Source_set_par_int(src, "y_max", y_max_new, NULL, NULL);
-			Source_set_par_int(src, "n_pix", n_pix_new, NULL, NULL);
-			Source_set_par_int(src, "flag",  flag_new,  NULL, NULL);
-			
-			// Update progress bar
-			progress_bar("Progress: ", i + 1, cat_size);
-			
-			// Next source
-			continue;
-		}
-		else
+		for(long int dy = -r; dy <= r; ++dy)
 		{
-			// Iterative dilation required
-			message_verb(self->verbosity, "Source %zu", i);
-			
-			// Iterate
-			size_t iter = 1;
-			double f_sum_old = f_sum;
-			while(iter <= iter_max)
-			{
-				double f_sum_new = f_sum;
-				double f_min_new = f_min;
-				double f_max_new = f_max;
-				long int flag_new = flag;
-				size_t n_pix_new = n_pix;
-				size_t x_min_new = x_min;
-				size_t x_max_new = x_max;
-				size_t y_min_new = y_min;
-				size_t y_max_new = y_max;
-				
-				// Dilate mask by radius 'iter'
-				DataCube_grow_mask_xy(self, mask, src_id, iter, 0, &f_sum_new, &f_min_new, &f_max_new, &n_pix_new, &flag_new, &x_min_new, &x_max_new, &y_min_new, &y_max_new, z_min, z_max);
-				
-				// Print information
-				message_verb(self->verbosity, " - Iteration %zu: df = %.3f (%.3f%%)", iter, f_sum_new - f_sum_old, 100.0 * (f_sum_new - f_sum_old) / f_sum_old);
-				
-				// Check if flux increased within boundaries
-				if((is_negative && (f_sum_new - f_sum_old) < threshold * f_sum_old) || (!is_negative && (f_sum_new - f_sum_old) > threshold * f_sum_old))
-				{
-					// Mask should be grown further
-					f_sum_old = f_sum_new;
-					++iter;
-					continue;
-				}
-				else
-				{
-					// No significant improvement; stop iterating
-					break;
-				}
-			} // END iteration loop
-			
-			// Apply final dilation if required
-			if(iter > 1)
+			for(long int dx = -r; dx <= r; ++dx)
 			{
-				double f_sum_new = f_sum;
-				double f_min_new = f_min;
-				double f_max_new = f_max;
-				long int flag_new = flag;
-				size_t n_pix_new = n_pix;
-				size_t x_min_new = x_min;
-				size_t x_max_new = x_max;
-				size_t y_min_new = y_min;
-				size_t y_max_new = y_max;
-				
-				DataCube_grow_mask_xy(self, mask, src_id, iter - 1, src_id, &f_sum_new, &f_min_new, &f_max_new, &n_pix_new, &flag_new, &x_min_new, &x_max_new, &y_min_new, &y_max_new, z_min, z_max);
-				
-				// Update source parameters with new values
-				Source_set_par_flt(src, "f_min", f_min_new, NULL, NULL);
-				Source_set_par_flt(src, "f_max", f_max_new, NULL, NULL);
-				Source_set_par_flt(src, "f_sum", f_sum_new, NULL, NULL);
-				Source_set_par_int(src, "x_min", x_min_new, NULL, NULL);
-				Source_set_par_int(src, "x_max", x_max_new, NULL, NULL);
-				Source_set_par_int(src, "y_min", y_min_new, NULL, NULL);
-				Source_set_par_int(src, "y_max", y_max_new, NULL, NULL);
-				Source_set_par_int(src, "n_pix", n_pix_new, NULL, NULL);
-				Source_set_par_int(src, "flag",  flag_new,  NULL, NULL);
+				const long int d2 = dx * dx + dy * dy;
+				if(d2 > r * r || (r > 0 && d2 <= (r - 1) * (r - 1))) continue;
+				ring[2 * n_ring]     = dx;
+				ring[2 * n_ring + 1] = dy;
+				++n_ring;
 			}
-			
-			// Update progress bar
-			if(!self->verbosity) progress_bar("Progress: ", i + 1, cat_size);
 		}
-	}  // END source loop
+	}
+	ring_start[iter_max + 1] = n_ring;
+	
+	// Loop over all batches of independent sources
+	for(size_t first = 0; first < cat_size;)
+	{
+		const size_t last = DataCube_dilation_batch(box, first, cat_size);
+		
+		#pragma omp parallel for schedule(dynamic) if(!self->verbosity)
+		for(size_t i = first; i < last; ++i) DataCube_dilate_source_xy(self, mask, Catalog_get_source(cat, i), i, iter_max, threshold, ring, ring_start);
+		
+		// Update progress bar
+		if(!self->verbosity) progress_bar("Progress: ", last, cat_size);
+		first = last;
+	}
+	
+	// Clean up
+	free(box);
+	free(ring);
+	free(ring_start);
 	
 	return;
 }
@@ -2991,6 +4210,10 @@ PUBLIC void DataCube_dilate_mask_xy(const DataCube *self, DataCube *mask, Catalo
 /// Dilation will progress by 1 channel per iteration in the
 /// directions directly adjacent to a pixel along the spectral axis.
 ///
+/// Sources whose dilation regions do not overlap are dilated in
+/// parallel in batches of consecutive catalogue entries, which
+/// yields the same result as dilating all sources one by one.
+///
 /// @param self       Data cube.
 /// @param mask       Mask cube.
 /// @param cat        Source catalogue.
@@ -3018,161 +4241,24 @@ PUBLIC void DataCube_dilate_mask_z(const DataCube *self, DataCube *mask, Catalog
 		return;
 	}
 	
-	// Loop over all sources in catalogue
-	for(size_t i = 0; i < cat_size; ++i)
+	// Determine dilation regions of all sources
+	size_t *box = DataCube_dilation_boxes(self, cat, 0, iter_max);
+	
+	// Loop over all batches of independent sources
+	for(size_t first = 0; first < cat_size;)
 	{
-		// Extract source
-		Source *src = Catalog_get_source(cat, i);
-		message_verb(self->verbosity, "Source %zu", i + 1);
-		
-		// Get source ID & flag
-		const long int src_id = Source_get_par_by_name_int(src, "id");
-		ensure(src_id, ERR_USER_INPUT, "Source ID missing from catalogue; mask dilation failed.");
-		long int flag = Source_get_par_by_name_int(src, "flag");
-		
-		// Get source bounding box
-		const size_t x_min = Source_get_par_by_name_int(src, "x_min");
-		const size_t x_max = Source_get_par_by_name_int(src, "x_max");
-		const size_t y_min = Source_get_par_by_name_int(src, "y_min");
-		const size_t y_max = Source_get_par_by_name_int(src, "y_max");
-		size_t z_min = Source_get_par_by_name_int(src, "z_min");
-		size_t z_max = Source_get_par_by_name_int(src, "z_max");
-		ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_INDEX_RANGE, "Illegal source bounding box: min > max!");
-		ensure(x_max < self->axis_size[0] && y_max < self->axis_size[1] && z_max < self->axis_size[2], ERR_INDEX_RANGE, "Source bounding box outside data cube boundaries.");
+		const size_t last = DataCube_dilation_batch(box, first, cat_size);
 		
-		// Get flux and check if source has negative flux
-		double f_sum = Source_get_par_by_name_flt(src, "f_sum");
-		double f_min = Source_get_par_by_name_flt(src, "f_min");
-		double f_max = Source_get_par_by_name_flt(src, "f_max");
-		size_t n_pix = Source_get_par_by_name_int(src, "n_pix");
-		const bool is_negative = (f_sum < 0.0);
-		
-		// Additional variables
-		double df_sum = 0.0;
-		size_t z_min_new = z_min;
-		size_t z_max_new = z_max;
-		
-		// Iterate
-		for(size_t iter = 0; iter < iter_max; ++iter)
-		{
-			df_sum = 0.0;
-			
-			// Loop over source bounding box
-			for(size_t z = z_min; z <= z_max; ++z)
-			{
-				for(size_t y = y_min; y <= y_max; ++y)
-				{
-					for(size_t x = x_min; x <= x_max; ++x)
-					{
-						const long int id = DataCube_get_data_int(mask, x, y, z);
-						
-						if(id == src_id)
-						{
-							// Check lower z
-							if(z > 0)
-							{
-								const long int id_new = DataCube_get_data_int(mask, x, y, z - 1);
-								if(id_new == 0)
-								{
-									if(IS_NOT_NAN(DataCube_get_data_flt(self, x, y, z - 1)))
-									{
-										DataCube_set_data_int(mask, x, y, z - 1, -1);
-										df_sum += DataCube_get_data_flt(self, x, y, z - 1);
-										if(z - 1 < z_min_new) z_min_new = z - 1;
-									}
-									else flag |= 4L;
-								}
-								else if(id_new > 0 && id_new != src_id) flag |= 8L;
-							}
-							else flag |= 2L;
-							
-							// Check higher z
-							if(z < self->axis_size[2] - 1)
-							{
-								const long int id_new = DataCube_get_data_int(mask, x, y, z + 1);
-								if(id_new == 0)
-								{
-									if(IS_NOT_NAN(DataCube_get_data_flt(self, x, y, z + 1)))
-									{
-										DataCube_set_data_int(mask, x, y, z + 1, -1);
-										df_sum += DataCube_get_data_flt(self, x, y, z + 1);
-										if(z + 1 > z_max_new) z_max_new = z + 1;
-									}
-									else flag |= 4L;
-								}
-								else if(id_new > 0 && id_new != src_id) flag |= 8L;
-							}
-							else flag |= 2L;
-						}
-					} // END loop over x
-				} // END loop over y
-			} // END loop over z
-			
-			// Check if flux increased within boundaries
-			if(threshold < 0.0 || (is_negative && df_sum < threshold * f_sum) || (!is_negative && df_sum > threshold * f_sum))
-			{
-				// Mask should be grown
-				f_sum += df_sum;
-				z_min = z_min_new;
-				z_max = z_max_new;
-				
-				// Loop over new bounding box
-				for(size_t z = z_min; z <= z_max; ++z)
-				{
-					for(size_t y = y_min; y <= y_max; ++y)
-					{
-						for(size_t x = x_min; x <= x_max; ++x)
-						{
-							// If mask value is -1...
-							if(DataCube_get_data_int(mask, x, y, z) == -1)
-							{
-								// ...switch to source ID...
-								DataCube_set_data_int(mask, x, y, z, src_id);
-								
-								// ...and update n_pix, f_min and f_max if necessary
-								const double value = DataCube_get_data_flt(self, x, y, z);
-								if(value < f_min) f_min = value;
-								if(value > f_max) f_max = value;
-								++n_pix;
-							}
-						}
-					}
-				}
-				
-				message_verb(self->verbosity, " - Iteration %zu: df = %.3f (%.3f%%)", iter + 1, df_sum, 100.0 * df_sum / (f_sum - df_sum));
-			}
-			else
-			{
-				// No significant improvement; clean up again and exit
-				for(size_t z = z_min_new; z <= z_max_new; ++z)
-				{
-					for(size_t y = y_min; y <= y_max; ++y)
-					{
-						for(size_t x = x_min; x <= x_max; ++x)
-						{
-							// Reset mask value again
-							if(DataCube_get_data_int(mask, x, y, z) == -1) DataCube_set_data_int(mask, x, y, z, 0);
-						}
-					}
-				}
-				
-				// Stop iterating
-				break;
-			}
-		} // END iteration loop
-		
-		// Update source parameters
-		Source_set_par_flt(src, "f_min", f_min, NULL, NULL);
-		Source_set_par_flt(src, "f_max", f_max, NULL, NULL);
-		Source_set_par_flt(src, "f_sum", f_sum, NULL, NULL);
-		Source_set_par_int(src, "z_min", z_min, NULL, NULL);
-		Source_set_par_int(src, "z_max", z_max, NULL, NULL);
-		Source_set_par_int(src, "n_pix", n_pix, NULL, NULL);
-		Source_set_par_int(src, "flag",  flag,  NULL, NULL);
+		#pragma omp parallel for schedule(dynamic) if(!self->verbosity)
+		for(size_t i = first; i < last; ++i) DataCube_dilate_source_z(self, mask, Catalog_get_source(cat, i), i, iter_max, threshold);
 		
 		// Update progress bar
-		progress_bar("Progress: ", i + 1, cat_size);
-	}  // END source loop
+		progress_bar("Progress: ", last, cat_size);
+		first = last;
+	}
+	
+	// Clean up
+	free(box);
 	
 	return;
 }
@@ -3200,22 +4286,40 @@ PUBLIC DataCube *DataCube_2d_mask(const DataCube *self)
 	Header_copy_wcs(self->header, maskImage->header);
 	Header_copy_misc(self->header, maskImage->header, true, true);
 	
-	// Loop over all pixels to project mask cube onto image
-	#pragma omp parallel for schedule(static)
-	for(size_t y = 0; y < self->axis_size[1]; ++y)
+	// Project mask cube onto image one row at a time, running
+	// through the spectral axis from the top for each row
+	const size_t nx = self->axis_size[0];
+	
+	#pragma omp parallel
 	{
-		for(size_t x = self->axis_size[0]; x--;)
+		long int *row  = (long int *)memory(MALLOC, nx, sizeof(long int));
+		long int *proj = (long int *)memory(MALLOC, nx, sizeof(long int));
+		
+		#pragma omp for schedule(static)
+		for(size_t y = 0; y < self->axis_size[1]; ++y)
 		{
-			for(size_t z = self->axis_size[2]; z--;)
+			size_t n_open = nx;
+			memset(proj, 0, nx * sizeof(long int));
+			
+			for(size_t z = self->axis_size[2]; z-- && n_open;)
 			{
-				size_t value = DataCube_get_data_int(self, x, y, z);
-				if(value)
+				DataCube_get_row_int(self, 0, nx - 1, y, z, row);
+				
+				for(size_t x = nx; x--;)
 				{
-					DataCube_set_data_int(maskImage, x, y, 0, value);
-					break;
+					if(row[x] && proj[x] == 0)
+					{
+						proj[x] = row[x];
+						--n_open;
+					}
 				}
 			}
+			
+			for(size_t x = nx; x--;) if(proj[x]) DataCube_set_data_int(maskImage, x, y, 0, proj[x]);
 		}
+		
+		free(row);
+		free(proj);
 	}
 	
 	return maskImage;
@@ -3291,6 +4395,70 @@ PUBLIC void DataCube_flag_regions(DataCube *self, const Array_siz *region)
 
 
 
+/// @brief Flag regions in bit mask
+///
+/// @param self    Data cube defining the geometry of the mask.
+/// @param mask    Bit mask to be flagged.
+/// @param region  Array containing the regions to be flagged.
+///                Must be of the form `x_min`, `x_max`, `y_min`,
+///                `y_max`, `z_min`, `z_max`, ... where the
+///                boundaries are inclusive.
+///
+/// Public method for clearing the specified regions in a bit mask of
+/// the same size as the data cube. This is the equivalent of
+/// DataCube_flag_regions() for bit-packed masks, with the axis sizes
+/// taken from `self`.
+
+PUBLIC void DataCube_flag_regions_bits(const DataCube *self, BitMask *mask, const Array_siz *region)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(mask);
+	check_null(region);
+	ensure(BitMask_get_size(mask) == self->data_size, ERR_USER_INPUT, "Data cube and mask have different sizes.");
+	
+	const size_t size = Array_siz_get_size(region);
+	ensure(size % 6 == 0, ERR_USER_INPUT, "Flagging regions must contain a multiple of 6 entries.");
+	
+	message("Applying flags.");
+	
+	// Loop over regions
+	for(size_t i = 0; i < size; i += 6)
+	{
+		// Establish boundaries
+		size_t x_min = Array_siz_get(region, i + 0);
+		size_t x_max = Array_siz_get(region, i + 1);
+		size_t y_min = Array_siz_get(region, i + 2);
+		size_t y_max = Array_siz_get(region, i + 3);
+		size_t z_min = Array_siz_get(region, i + 4);
+		size_t z_max = Array_siz_get(region, i + 5);
+		
+		// Adjust boundaries if necessary
+		if(x_max >= self->axis_size[0]) x_max = self->axis_size[0] - 1;
+		if(y_max >= self->axis_size[1]) y_max = self->axis_size[1] - 1;
+		if(z_max >= self->axis_size[2]) z_max = self->axis_size[2] - 1;
+		
+		if(x_min > x_max) x_min = x_max;
+		if(y_min > y_max) y_min = y_max;
+		if(z_min > z_max) z_min = z_max;
+		
+		message_verb(self->verbosity, "  Region: [%zu, %zu, %zu, %zu, %zu, %zu]", x_min, x_max, y_min, y_max, z_min, z_max);
+		
+		// Clear one row at a time
+		for(size_t z = z_min; z <= z_max; ++z)
+		{
+			for(size_t y = y_min; y <= y_max; ++y)
+			{
+				BitMask_clear_range(mask, DataCube_get_index(self, x_min, y, z), DataCube_get_index(self, x_max, y, z));
+			}
+		}
+	}
+	
+	return;
+}
+
+
+
 /// @brief Flagging based on catalogue of positions
 ///
 /// Public method for flagging positions specified in an external
@@ -3345,19 +4513,44 @@ PUBLIC void DataCube_continuum_flagging(DataCube *self, const char *filename, co
 		}
 	}
 	
-	// Process catalogue line-by-line
-	for(size_t i = 0; i < Table_rows(cont_cat); ++i)
+	// Convert all positions from WCS to pixels in one go if needed
+	// (positions that fail to convert will remain outside of the cube)
+	const size_t n_rows = Table_rows(cont_cat);
+	double *coord_world = NULL;
+	double *coord_pixel = (double *)memory(MALLOC, 3 * n_rows, sizeof(double));
+	for(size_t i = 0; i < 3 * n_rows; ++i) coord_pixel[i] = -1e+30;
+	
+	if(coord_sys == 1)
+	{
+		coord_world = (double *)memory(CALLOC, 3 * n_rows, sizeof(double));
+		for(size_t i = 0; i < n_rows; ++i)
+		{
+			coord_world[3 * i]     = Table_get(cont_cat, i, 0);
+			coord_world[3 * i + 1] = Table_get(cont_cat, i, 1);
+		}
+		WCS_convertToPixel_batch(wcs, coord_world, coord_pixel, n_rows);
+	}
+	else
+	{
+		for(size_t i = 0; i < n_rows; ++i)
+		{
+			coord_pixel[3 * i]     = Table_get(cont_cat, i, 0);
+			coord_pixel[3 * i + 1] = Table_get(cont_cat, i, 1);
+		}
+	}
+	
+	// Build spatial footprint of all positions first
+	// NOTE: Overlapping discs are merged in the footprint, so every pixel
+	//       is flagged only once, and all channels can then be flagged
+	//       in a single pass through the cube.
+	const size_t plane_size = self->axis_size[0] * self->axis_size[1];
+	BitMask *footprint = BitMask_new(plane_size);
+	
+	for(size_t i = 0; i < n_rows; ++i)
 	{
-		// Extract longitude and latitude
-		double lon = -1e+30;
-		double lat = -1e+30;
-		
-		// Convert position from WCS to pixels if needed
-		if(coord_sys == 1) WCS_convertToPixel(wcs, Table_get(cont_cat, i, 0), Table_get(cont_cat, i, 1), 0.0, &lon, &lat, NULL);
-		
 		// Ensure that source is within cube boundaries
-		const long int pos_x = (long int)(lon + 0.5);
-		const long int pos_y = (long int)(lat + 0.5);
+		const long int pos_x = (long int)(coord_pixel[3 * i] + 0.5);
+		const long int pos_y = (long int)(coord_pixel[3 * i + 1] + 0.5);
 		if(pos_x < 0 || pos_y < 0 || pos_x >= axis_size_x || pos_y >= axis_size_y) continue;
 		++counter;
 		
@@ -3367,22 +4560,74 @@ PUBLIC void DataCube_continuum_flagging(DataCube *self, const char *filename, co
 		const long int x_max = pos_x + radius < axis_size_x ? pos_x + radius : axis_size_x - 1;
 		const long int y_max = pos_y + radius < axis_size_y ? pos_y + radius : axis_size_y - 1;
 		
-		for(long int z = 0; z < axis_size_z; ++z)
+		// Add disc to footprint
+		for(long int y = y_min; y <= y_max; ++y)
 		{
-			for(long int y = y_min; y <= y_max; ++y)
+			for(long int x = x_min; x <= x_max; ++x)
 			{
-				for(long int x = x_min; x <= x_max; ++x)
-				{
-					if((x - pos_x) * (x - pos_x) + (y - pos_y) * (y - pos_y) <= radius2) DataCube_set_data_flt(self, x, y, z, NAN);
-				}
+				if((x - pos_x) * (x - pos_x) + (y - pos_y) * (y - pos_y) <= radius2) BitMask_set(footprint, x + axis_size_x * y);
+			}
+		}
+	}
+	
+	// Convert footprint into list of spans (start index and length within plane)
+	size_t n_spans = 0;
+	size_t n_flagged = 0;
+	size_t capacity = 0;
+	size_t *spans = NULL;
+	
+	for(size_t i = 0; i < plane_size; ++i)
+	{
+		if(!BitMask_get(footprint, i)) continue;
+		
+		// Extend span, but never across the end of a row
+		size_t j = i + 1;
+		while(j < plane_size && j % axis_size_x && BitMask_get(footprint, j)) ++j;
+		
+		if(n_spans == capacity)
+		{
+			capacity = capacity ? 2 * capacity : 256;
+			spans = (size_t *)memory_realloc(spans, 2 * capacity, sizeof(size_t));
+		}
+		
+		spans[2 * n_spans]     = i;
+		spans[2 * n_spans + 1] = j - i;
+		++n_spans;
+		n_flagged += j - i;
+		i = j - 1;
+	}
+	
+	// Apply footprint to all channels
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < (size_t)axis_size_z; ++z)
+	{
+		if(self->data_type == -32)
+		{
+			float *plane = (float *)(self->data) + z * plane_size;
+			for(size_t i = 0; i < n_spans; ++i)
+			{
+				for(float *ptr = plane + spans[2 * i], *end = ptr + spans[2 * i + 1]; ptr < end; ++ptr) *ptr = NAN;
+			}
+		}
+		else
+		{
+			double *plane = (double *)(self->data) + z * plane_size;
+			for(size_t i = 0; i < n_spans; ++i)
+			{
+				for(double *ptr = plane + spans[2 * i], *end = ptr + spans[2 * i + 1]; ptr < end; ++ptr) *ptr = NAN;
 			}
 		}
 	}
 	
 	// Print some statistics
-	message("Flagged %zu out of %zu positions from catalogue.", counter, Table_rows(cont_cat));
+	message("Flagged %zu out of %zu positions from catalogue.", counter, n_rows);
+	message_verb(self->verbosity, "Footprint covers %zu spatial pixels in %zu spans.", n_flagged, n_spans);
 	
 	// Clean up
+	free(spans);
+	free(coord_world);
+	free(coord_pixel);
+	BitMask_delete(footprint);
 	Table_delete(cont_cat);
 	WCS_delete(wcs);
 	
@@ -3729,6 +4974,103 @@ PUBLIC void DataCube_copy_blanked(DataCube *self, const DataCube *source)
 
 
 
+/// @brief Create bit mask of blanked pixels
+///
+/// Public method for recording all blanked pixels of a floating-
+/// point data cube in a compact bit mask with one bit per pixel.
+/// Blanked pixels are assumed to be represented by `NaN` (not a
+/// number). The mask can be used to restore the blanks in derived
+/// cubes with DataCube_copy_blanked_bits() without having to read
+/// the original data again. A pointer to the newly created mask
+/// will be returned, and its destructor will need to be called
+/// explicitly once it is no longer required.
+///
+/// @param self  Object self-reference.
+///
+/// @return Pointer to newly created bit mask of blanked pixels.
+
+PUBLIC BitMask *DataCube_get_blanked_bits(const DataCube *self)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	ensure(self->data_type == -32 || self->data_type == -64, ERR_USER_INPUT, "Cannot determine blanked pixels; data cube must be floating-point.");
+	
+	BitMask *blanks = BitMask_new(self->data_size);
+	const size_t n_words = BitMask_get_words(blanks);
+	
+	// Assemble each word separately, so threads never write to the same word
+	#pragma omp parallel for schedule(static)
+	for(size_t w = 0; w < n_words; ++w)
+	{
+		const size_t first = w * BITMASK_WORD_BITS;
+		const size_t n_bits = first + BITMASK_WORD_BITS <= self->data_size ? BITMASK_WORD_BITS : self->data_size - first;
+		uint64_t bits = 0;
+		
+		if(self->data_type == -32)
+		{
+			const float *ptr = (const float *)(self->data) + first;
+			for(size_t bit = 0; bit < n_bits; ++bit) if(IS_NAN(ptr[bit])) bits |= (uint64_t)1 << bit;
+		}
+		else
+		{
+			const double *ptr = (const double *)(self->data) + first;
+			for(size_t bit = 0; bit < n_bits; ++bit) if(IS_NAN(ptr[bit])) bits |= (uint64_t)1 << bit;
+		}
+		
+		if(bits) BitMask_set_word(blanks, w, bits);
+	}
+	
+	return blanks;
+}
+
+
+
+/// @brief Copy blanked pixels from bit mask
+///
+/// Public method for blanking all pixels of a floating-point data
+/// cube that are set in the specified bit mask of blanked pixels,
+/// e.g. as created by DataCube_get_blanked_bits(). This is equiva-
+/// lent to DataCube_copy_blanked(), but only visits words of the
+/// mask that contain blanked pixels.
+///
+/// @param self    Object self-reference.
+/// @param blanks  Bit mask of blanked pixels to be copied.
+
+PUBLIC void DataCube_copy_blanked_bits(DataCube *self, const BitMask *blanks)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	check_null(blanks);
+	ensure(self->data_type == -32 || self->data_type == -64, ERR_USER_INPUT, "Cannot copy blanked pixels; data cube must be floating-point.");
+	ensure(BitMask_get_size(blanks) == self->data_size, ERR_USER_INPUT, "Cannot copy blanked pixels; data cube and mask differ in size.");
+	
+	const size_t n_words = BitMask_get_words(blanks);
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t w = 0; w < n_words; ++w)
+	{
+		uint64_t bits = BitMask_get_word(blanks, w);
+		
+		while(bits)
+		{
+			// Index of lowest set bit
+			size_t bit = 0;
+			while(!((bits >> bit) & 1u)) ++bit;
+			bits &= bits - 1;
+			
+			const size_t i = w * BITMASK_WORD_BITS + bit;
+			if(self->data_type == -32) *((float *)(self->data) + i) = NAN;
+			else *((double *)(self->data) + i) = NAN;
+		}
+	}
+	
+	return;
+}
+
+
+
 /// @brief Return array index from x, y and z
 ///
 /// Private method to turn a 3-D pixel coordinate into a 1-D array
@@ -3787,9 +5129,9 @@ PRIVATE void DataCube_get_xyz(const DataCube *self, const size_t index, size_t *
 /// filter in the spatial domain and a boxcar filter in the spectral
 /// domain. It will then measure the noise level in each iteration
 /// and mark all pixels with absolute values greater than or equal
-/// to the specified threshold (relative to the noise level) as 1
-/// in the specified mask cube, which must be of 8-bit integer
-/// type, while non-detected pixels will be set to a value of 0.
+/// to the specified threshold (relative to the noise level) as set
+/// in the specified bit mask, while non-detected pixels will be left
+/// unset.
 /// Pixels already detected in a previous iteration will be set to
 /// `maskScaleXY` times the original rms noise level of the data
 /// before smoothing. If the value of `maskScaleXY` is negative, no
@@ -3827,7 +5169,7 @@ PRIVATE void DataCube_get_xyz(const DataCube *self, const size_t index, size_t *
 /// may have become too low for a reliable measurement of the noise.
 ///
 /// @param self          Data cube to run the S+C finder on.
-/// @param maskCube      Mask cube for recording detected pixels.
+/// @param mask          Bit mask for recording detected pixels.
 /// @param kernels_spat  List of spatial smoothing lengths corresponding
 ///                      to the FWHM of the Gaussian kernels to be
 ///                      applied; 0 = no smoothing.
@@ -3848,6 +5190,9 @@ PRIVATE void DataCube_get_xyz(const DataCube *self, const size_t index, size_t *
 /// @param range         Flux range to used in noise measurement, Can
 ///                      be -1, 0 or 1 for negative only, all or
 ///                      positive only.
+/// @param mad_tolerance If greater than 0, the MAD will be approximated
+///                      from a histogram with a relative error not
+///                      exceeding this value. See DataCube_stat_mad().
 /// @param scaleNoise    0 = no noise scaling; 1 = global noise scaling;
 ///                      2 = local noise scaling. Applied after each
 ///                      smoothing operation.
@@ -3870,6 +5215,8 @@ PRIVATE void DataCube_get_xyz(const DataCube *self, const size_t index, size_t *
 /// @param snInterpol    Enable interpolation for local noise scaling
 ///                      if true. See DataCube_scale_noise_local()
 ///                      for details.
+/// @param profiler      Profiler for recording the statistics of each
+///                      smoothing kernel. Can be `NULL`.
 /// @param start_time    Arbitrary time stamp; progress time of the
 ///                      algorithm will be calculated and printed
 ///                      relative to `start_time`.
@@ -3877,16 +5224,14 @@ PRIVATE void DataCube_get_xyz(const DataCube *self, const size_t index, size_t *
 ///                      algorithm in term of CPU time will be
 ///                      calculated and printed relative to `clock_time`.
 
-PUBLIC void DataCube_run_scfind(const DataCube *self, DataCube *maskCube, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const int scaleNoise, const noise_stat snStatistic, const int snRange, const size_t snWindowXY, const size_t snWindowZ, const size_t snGridXY, const size_t snGridZ, const bool snInterpol, const time_t start_time, const clock_t start_clock)
+PUBLIC void DataCube_run_scfind(const DataCube *self, BitMask *mask, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const double mad_tolerance, const int scaleNoise, const noise_stat snStatistic, const int snRange, const size_t snWindowXY, const size_t snWindowZ, const size_t snGridXY, const size_t snGridZ, const bool snInterpol, Profiler *profiler, const time_t start_time, const clock_t start_clock)
 {
 	// Sanity checks
 	check_null(self);
 	check_null(self->data);
 	ensure(self->data_type < 0, ERR_USER_INPUT, "The S+C finder can only be applied to floating-point data.");
-	check_null(maskCube);
-	check_null(maskCube->data);
-	ensure(maskCube->data_type == 8, ERR_USER_INPUT, "Mask cube must be of 8-bit integer type.");
-	ensure(self->axis_size[0] == maskCube->axis_size[0] && self->axis_size[1] == maskCube->axis_size[1] && self->axis_size[2] == maskCube->axis_size[2], ERR_USER_INPUT, "Data cube and mask cube have different sizes.");
+	check_null(mask);
+	ensure(BitMask_get_size(mask) == self->data_size, ERR_USER_INPUT, "Data cube and mask have different sizes.");
 	check_null(kernels_spat);
 	check_null(kernels_spec);
 	ensure(Array_dbl_get_size(kernels_spat) && Array_siz_get_size(kernels_spec), ERR_USER_INPUT, "Invalid spatial or spectral kernel list encountered.");
@@ -3900,83 +5245,857 @@ PUBLIC void DataCube_run_scfind(const DataCube *self, DataCube *maskCube, const
 	else if(cadence % self->axis_size[0] == 0) cadence -= 1;    // Ensure stride is not equal to multiple of x-axis size
 	message("Using a stride of %zu in noise measurement.\n", cadence);
 	
-	// Measure noise in original cube with sampling "cadence"
-	double rms;
-	double rms_smooth;
+	// Measure noise in original cube with sampling "cadence"
+	double rms;
+	double rms_smooth;
+	
+	if(method == NOISE_STAT_STD)      rms = DataCube_stat_std(self, 0.0, cadence, range);
+	else if(method == NOISE_STAT_MAD) rms = MAD_TO_STD * DataCube_stat_mad(self, 0.0, cadence, range, mad_tolerance);
+	else                              rms = DataCube_stat_gauss(self, cadence, range);
+	
+	// Record original blanks once, so they can be restored after each
+	// smoothing operation without having to read the original cube again
+	BitMask *blanks = DataCube_get_blanked_bits(self);
+	const bool has_blanks = BitMask_count(blanks) > 0;
+	
+	// Run S+C finder for all smoothing kernels
+	for(size_t i = 0; i < Array_dbl_get_size(kernels_spat); ++i)
+	{
+		for(size_t j = 0; j < Array_siz_get_size(kernels_spec); ++j)
+		{
+			message("Smoothing kernel:  [%.1f] x [%zu]", Array_dbl_get(kernels_spat, i), Array_siz_get(kernels_spec, j));
+			
+			if(profiler != NULL)
+			{
+				char stage[64];
+				snprintf(stage, sizeof(stage), "scfind [%.1f] x [%zu]", Array_dbl_get(kernels_spat, i), Array_siz_get(kernels_spec, j));
+				Profiler_start(profiler, stage, self->data_size);
+			}
+			
+			// Check if any smoothing requested
+			if(Array_dbl_get(kernels_spat, i) || Array_siz_get(kernels_spec, j))
+			{
+				// Smoothing required; create a copy of the original cube
+				DataCube *smoothedCube = DataCube_copy(self);
+				
+				// Set flux of already detected pixels to maskScaleXY * rms
+				if(maskScaleXY >= 0.0) DataCube_set_masked_bits(smoothedCube, mask, maskScaleXY * rms);
+				
+				// Spatial and spectral smoothing
+				if(Array_dbl_get(kernels_spat, i) > 0.0) DataCube_gaussian_filter(smoothedCube, Array_dbl_get(kernels_spat, i) / FWHM_CONST);
+				if(Array_siz_get(kernels_spec, j) > 0)   DataCube_boxcar_filter(smoothedCube, Array_siz_get(kernels_spec, j) / 2);
+				
+				// Copy original blanks into smoothed cube again
+				// (these were set to 0 during smoothing)
+				if(has_blanks) DataCube_copy_blanked_bits(smoothedCube, blanks);
+				
+				// Scale noise if requested
+				if(scaleNoise == 1)
+				{
+					message("Correcting for noise variations along spectral axis.\n");
+					DataCube_scale_noise_spec(smoothedCube, snStatistic, snRange);
+				}
+				else if(scaleNoise == 2)
+				{
+					message("Correcting for local noise variations.");
+					DataCube *noiseCube = DataCube_scale_noise_local(
+						smoothedCube,
+						snStatistic,
+						snRange,
+						snWindowXY,
+						snWindowZ,
+						snGridXY,
+						snGridZ,
+						snInterpol
+					);
+					DataCube_delete(noiseCube);
+				}
+				
+				// Calculate the RMS of the smoothed cube
+				if(method == NOISE_STAT_STD)      rms_smooth = DataCube_stat_std(smoothedCube, 0.0, cadence, range);
+				else if(method == NOISE_STAT_MAD) rms_smooth = MAD_TO_STD * DataCube_stat_mad(smoothedCube, 0.0, cadence, range, mad_tolerance);
+				else                              rms_smooth = DataCube_stat_gauss(smoothedCube, cadence, range);
+				
+				message("Noise level:       %.3e", rms_smooth);
+				
+				// Add pixels above threshold to mask
+				DataCube_mask_bits(smoothedCube, mask, threshold * rms_smooth);
+				
+				// Delete smoothed cube again
+				DataCube_delete(smoothedCube);
+			}
+			else
+			{
+				// No smoothing required; apply threshold to original cube
+				message("Noise level:       %.3e", rms);
+				DataCube_mask_bits(self, mask, threshold * rms);
+			}
+			
+			// Print time
+			timestamp(start_time, start_clock);
+		}
+	}
+	
+	BitMask_delete(blanks);
+	
+	return;
+}
+
+
+
+/// @brief Run Smooth + Clip (S+C) finder on offload device
+///
+/// Public method for running the **Smooth + Clip** (S+C) finder on
+/// an OpenMP offload device such as a GPU. The algorithm is the same
+/// as in DataCube_run_scfind(), but the original data cube, two work
+/// buffers and the bit mask are kept resident in device memory for
+/// the entire run. Smoothing, replacement of already detected pixels
+/// and thresholding of all kernel combinations are carried out on
+/// the device, and only a sample of every smoothed cube for the
+/// noise measurement and the final bit mask are transferred back to
+/// the host. The boxcar and Gaussian filters replicate the arithmetic
+/// of filter_boxcar_1d_flt() and filter_gauss_2d_flt() element by
+/// element, with each device thread filtering an entire row, column
+/// or spectrum.
+///
+/// The noise sample holds every element of the smoothed cube that is
+/// visited by DataCube_stat_std(), DataCube_stat_mad() or
+/// DataCube_stat_gauss() with the same cadence, in the same order. It
+/// is passed to the same statistics functions on the host, with the
+/// sample limit of the MAD and the histogram limits of the Gaussian
+/// fit (derived from the minimum and maximum of the entire smoothed
+/// cube on the device) set to those of the full cube. Hence, the noise
+/// levels and the resulting mask are identical to those produced by
+/// DataCube_run_scfind() for all noise measurement methods. Only
+/// single-precision data cubes are supported, and noise scaling of the
+/// smoothed data is not available in this mode. If no offload device
+/// is available, the kernels will be executed on the host.
+///
+/// @param self          Data cube to run the S+C finder on.
+/// @param mask          Bit mask for recording detected pixels.
+/// @param kernels_spat  List of spatial smoothing lengths corresponding
+///                      to the FWHM of the Gaussian kernels to be
+///                      applied; 0 = no smoothing.
+/// @param kernels_spec  List of spectral smoothing lengths corresponding
+///                      to the widths of the boxcar filters to be
+///                      applied. Must be odd or 0.
+/// @param threshold     Relative flux threshold to be applied.
+/// @param maskScaleXY   Already detected pixels will be set to this
+///                      value times the original rms of the data
+///                      before smoothing the data again. If negative,
+///                      no replacement will be carried out.
+/// @param method        Method to use for measuring the noise in
+///                      the smoothed copies of the cube; can be
+///                      `NOISE_STAT_STD`, `NOISE_STAT_MAD` or
+///                      `NOISE_STAT_GAUSS` for standard deviation,
+///                      median absolute deviation and Gaussian fit
+///                      to flux histogram, respectively.
+/// @param range         Flux range to used in noise measurement, Can
+///                      be -1, 0 or 1 for negative only, all or
+///                      positive only.
+/// @param mad_tolerance If greater than 0, the MAD will be approximated
+///                      from a histogram with a relative error not
+///                      exceeding this value. See DataCube_stat_mad().
+/// @param profiler      Profiler for recording the statistics of each
+///                      smoothing kernel. Can be `NULL`.
+/// @param start_time    Arbitrary time stamp; progress time of the
+///                      algorithm will be calculated and printed
+///                      relative to `start_time`.
+/// @param start_clock   Arbitrary clock count; progress time of the
+///                      algorithm in term of CPU time will be
+///                      calculated and printed relative to `clock_time`.
+
+PUBLIC void DataCube_run_scfind_device(const DataCube *self, BitMask *mask, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const double mad_tolerance, Profiler *profiler, const time_t start_time, const clock_t start_clock)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	ensure(self->data_type == -32, ERR_USER_INPUT, "The S+C finder can only be offloaded for 32-bit floating-point data.");
+	check_null(mask);
+	ensure(BitMask_get_size(mask) == self->data_size, ERR_USER_INPUT, "Data cube and mask have different sizes.");
+	check_null(kernels_spat);
+	check_null(kernels_spec);
+	ensure(Array_dbl_get_size(kernels_spat) && Array_siz_get_size(kernels_spec), ERR_USER_INPUT, "Invalid spatial or spectral kernel list encountered.");
+	ensure(threshold >= 0.0, ERR_USER_INPUT, "Negative flux threshold encountered.");
+	ensure(method == NOISE_STAT_STD || method == NOISE_STAT_MAD || method == NOISE_STAT_GAUSS, ERR_USER_INPUT, "Invalid noise measurement method: %d.", method);
+	
+	// Report offload device
+	#ifdef _OPENMP
+		if(omp_get_num_devices() > 0) message("Offloading to device %d of %d.", omp_get_default_device() + 1, omp_get_num_devices());
+		else warning("No offload device available; running on host instead.");
+	#else
+		warning("SoFiA was compiled without OpenMP; running on host instead.");
+	#endif
+	
+	// A few additional settings
+	const double FWHM_CONST = 2.0 * sqrt(2.0 * log(2.0));  // Conversion between sigma and FWHM of Gaussian function
+	size_t cadence = self->data_size / NOISE_SAMPLE_SIZE;  // Stride for noise calculation
+	if(cadence < 2) cadence = 1;
+	else if(cadence % self->axis_size[0] == 0) cadence -= 1;    // Ensure stride is not equal to multiple of x-axis size
+	message("Using a stride of %zu in noise measurement.\n", cadence);
+	
+	// Measure noise in original cube with sampling "cadence"
+	double rms;
+	double rms_smooth;
+	
+	if(method == NOISE_STAT_STD)      rms = DataCube_stat_std(self, 0.0, cadence, range);
+	else if(method == NOISE_STAT_MAD) rms = MAD_TO_STD * DataCube_stat_mad(self, 0.0, cadence, range, mad_tolerance);
+	else                              rms = DataCube_stat_gauss(self, cadence, range);
+	
+	// Host copy of bit mask and noise sample
+	// NOTE: Sample k is element size - (n_samples - k) * cadence, or
+	//       NaN if outside of the cube. The standard deviation uses
+	//       the last size / cadence samples, while the MAD and the
+	//       Gaussian fit skip sample 0, just as for the full cube.
+	const size_t size      = self->data_size;
+	const size_t size_x    = self->axis_size[0];
+	const size_t size_y    = self->axis_size[1];
+	const size_t size_z    = self->axis_size[2];
+	const size_t n_words   = BitMask_get_words(mask);
+	const size_t n_samples = (size + cadence - 1) / cadence;
+	const size_t n_std     = size / cadence;
+	const size_t max_mad   = (range == 0) ? (size / cadence) : (size / (2 * cadence));
+	const float *data      = (const float *)(self->data);
+	uint64_t *words  = (uint64_t *)memory(MALLOC, n_words, sizeof(uint64_t));
+	float *sample    = (float *)memory(MALLOC, n_samples, sizeof(float));
+	float *buffer_a  = (float *)memory(MALLOC, size, sizeof(float));
+	float *buffer_b  = (float *)memory(MALLOC, size, sizeof(float));
+	for(size_t w = 0; w < n_words; ++w) words[w] = BitMask_get_word(mask, w);
+	
+	// Transfer data cube and mask to device
+	#pragma omp target enter data map(to: data[0:size], words[0:n_words]) map(alloc: buffer_a[0:size], buffer_b[0:size], sample[0:n_samples])
+	
+	// Run S+C finder for all smoothing kernels
+	for(size_t i = 0; i < Array_dbl_get_size(kernels_spat); ++i)
+	{
+		for(size_t j = 0; j < Array_siz_get_size(kernels_spec); ++j)
+		{
+			message("Smoothing kernel:  [%.1f] x [%zu]", Array_dbl_get(kernels_spat, i), Array_siz_get(kernels_spec, j));
+			
+			if(profiler != NULL)
+			{
+				char stage[64];
+				snprintf(stage, sizeof(stage), "scfind [%.1f] x [%zu]", Array_dbl_get(kernels_spat, i), Array_siz_get(kernels_spec, j));
+				Profiler_start(profiler, stage, size);
+			}
+			
+			// Check if any smoothing requested
+			if(Array_dbl_get(kernels_spat, i) || Array_siz_get(kernels_spec, j))
+			{
+				// Copy original cube and set flux of already detected pixels to maskScaleXY * rms
+				const float *smoothed = DataCube_device_copy(data, buffer_a, words, size, maskScaleXY >= 0.0 ? maskScaleXY * rms : -1.0);
+				float *spare = buffer_b;
+				
+				// Spatial smoothing along rows, then columns
+				if(Array_dbl_get(kernels_spat, i) > 0.0)
+				{
+					size_t n_iter;
+					size_t filter_radius;
+					optimal_filter_size_dbl(Array_dbl_get(kernels_spat, i) / FWHM_CONST, &filter_radius, &n_iter);
+					
+					for(size_t iter = n_iter; iter--;) smoothed = DataCube_device_boxcar(smoothed, &spare, size, size_y * size_z, 1, size_x, 0, 1, size_x, filter_radius);
+					for(size_t iter = n_iter; iter--;) smoothed = DataCube_device_boxcar(smoothed, &spare, size, size_x * size_z, size_x, size_x * size_y, 1, size_x, size_y, filter_radius);
+				}
+				
+				// Spectral smoothing
+				if(Array_siz_get(kernels_spec, j) / 2 > 0) smoothed = DataCube_device_boxcar(smoothed, &spare, size, size_x * size_y, 1, 1, 0, size_x * size_y, size_z, Array_siz_get(kernels_spec, j) / 2);
+				
+				// Extract noise sample, restoring original blanks, and transfer to host
+				#pragma omp target teams distribute parallel for map(alloc: data[0:size], smoothed[0:size], sample[0:n_samples])
+				for(size_t k = 0; k < n_samples; ++k)
+				{
+					const size_t offset = (n_samples - k) * cadence;
+					sample[k] = (offset > size || IS_NAN(data[size - offset])) ? NAN : smoothed[size - offset];
+				}
+				#pragma omp target update from(sample[0:n_samples])
+				
+				// Calculate the RMS of the smoothed cube
+				if(method == NOISE_STAT_STD)      rms_smooth = std_dev_val_flt(sample + n_samples - n_std, n_std, 0.0, 1, range);
+				else if(method == NOISE_STAT_MAD) rms_smooth = MAD_TO_STD * (mad_tolerance > 0.0 ? mad_val_hist_capped_flt(sample, n_samples, 0.0, 1, range, mad_tolerance, max_mad) : mad_val_capped_flt(sample, n_samples, 0.0, 1, range, max_mad));
+				else
+				{
+					// Histogram limits from entire smoothed cube, excluding blanks
+					float data_min = INFINITY;
+					float data_max = -INFINITY;
+					
+					#pragma omp target teams distribute parallel for map(alloc: data[0:size], smoothed[0:size]) reduction(min: data_min) reduction(max: data_max)
+					for(size_t k = 0; k < size; ++k)
+					{
+						if(IS_NAN(data[k]) || IS_NAN(smoothed[k])) continue;
+						if(smoothed[k] < data_min) data_min = smoothed[k];
+						if(smoothed[k] > data_max) data_max = smoothed[k];
+					}
+					
+					rms_smooth = gaufit_limits_flt(sample, n_samples, 1, range, data_min, data_max);
+				}
+				
+				message("Noise level:       %.3e", rms_smooth);
+				
+				// Add pixels above threshold to mask
+				DataCube_device_mask(data, smoothed, words, size, threshold * rms_smooth);
+			}
+			else
+			{
+				// No smoothing required; apply threshold to original cube
+				message("Noise level:       %.3e", rms);
+				DataCube_device_mask(data, data, words, size, threshold * rms);
+			}
+			
+			// Print time
+			timestamp(start_time, start_clock);
+		}
+	}
+	
+	// Transfer mask back to host and release device memory
+	#pragma omp target exit data map(from: words[0:n_words]) map(release: data[0:size]) map(delete: buffer_a[0:size], buffer_b[0:size], sample[0:n_samples])
+	for(size_t w = 0; w < n_words; ++w) if(words[w]) BitMask_set_word(mask, w, words[w]);
+	
+	// Clean up
+	free(words);
+	free(sample);
+	free(buffer_a);
+	free(buffer_b);
+	
+	return;
+}
+
+
+
+/// @brief Copy data cube into device buffer for S+C finder
+///
+/// Private method for copying the device-resident data array into
+/// the specified device buffer, while setting all pixels flagged in
+/// the bit mask to their signum multiplied by `replacement`. This is
+/// the device equivalent of DataCube_copy() followed by
+/// DataCube_set_masked_bits().
+///
+/// @param data         Device-resident data array to be copied.
+/// @param buffer       Device-resident buffer to copy data into.
+/// @param words        Device-resident words of bit mask.
+/// @param size         Number of elements in data array.
+/// @param replacement  Replacement value for already detected pixels.
+///                     If negative, no replacement will be carried
+///                     out.
+///
+/// @return Pointer to `buffer`.
+
+PRIVATE float *DataCube_device_copy(const float *data, float *buffer, const uint64_t *words, const size_t size, const double replacement)
+{
+	#pragma omp target teams distribute parallel for map(alloc: data[0:size], buffer[0:size], words[0:(size + BITMASK_WORD_BITS - 1) / BITMASK_WORD_BITS])
+	for(size_t i = 0; i < size; ++i)
+	{
+		if(replacement >= 0.0 && ((words[i / BITMASK_WORD_BITS] >> (i % BITMASK_WORD_BITS)) & 1u)) buffer[i] = copysign(replacement, data[i]);
+		else buffer[i] = data[i];
+	}
+	
+	return buffer;
+}
+
+
+
+/// @brief Apply boxcar filter to device buffer
+///
+/// Private method for applying a boxcar filter of the specified
+/// radius to all lines of a device-resident data array along one
+/// axis. Each line is filtered by a separate device thread, using
+/// the same recursive algorithm as filter_boxcar_1d_flt(), but
+/// writing the result into the spare buffer instead of filtering in
+/// place. The first element of line `l` is located at index
+/// `(l / n_inner) * outer_step + (l % n_inner) * inner_step`, and
+/// subsequent elements are separated by `stride`. NaN values will be
+/// treated as 0, and the data are padded with 0 on either side.
+/// Input and spare buffer will be swapped on return, such that the
+/// spare buffer then points to the original input data.
+///
+/// @param input       Device-resident data array to be filtered.
+/// @param spare       Pointer to device-resident spare buffer into
+///                    which the filtered data will be written. Will
+///                    be set to `input` on return.
+/// @param size        Total number of elements in data array.
+/// @param n_lines     Number of lines to be filtered.
+/// @param n_inner     Number of lines in the inner dimension.
+/// @param outer_step  Offset between lines in the outer dimension.
+/// @param inner_step  Offset between lines in the inner dimension.
+/// @param stride      Offset between elements within each line.
+/// @param length      Number of elements in each line.
+/// @param radius      Radius of the boxcar filter.
+///
+/// @return Pointer to filtered data array.
+
+PRIVATE float *DataCube_device_boxcar(const float *input, float **spare, const size_t size, const size_t n_lines, const size_t n_inner, const size_t outer_step, const size_t inner_step, const size_t stride, const size_t length, const size_t radius)
+{
+	float *output = *spare;
+	const size_t filter_size = 2 * radius + 1;
+	const float inv_filter_size = 1.0 / filter_size;
+	(void)size;  // only needed for device mapping
+	
+	#pragma omp target teams distribute parallel for map(alloc: input[0:size], output[0:size])
+	for(size_t l = 0; l < n_lines; ++l)
+	{
+		const float *src = input + (l / n_inner) * outer_step + (l % n_inner) * inner_step;
+		float *dst = output + (l / n_inner) * outer_step + (l % n_inner) * inner_step;
+		
+		// Apply boxcar filter to last data point
+		// (element k of zero-padded line corresponds to element k - radius of input line)
+		const size_t last = (length - 1) * stride;
+		dst[last] = 0.0;
+		for(size_t k = length + filter_size - 1; k-- > length - 1;) if(k >= radius && k < length + radius) dst[last] += FILTER_NAN(src[(k - radius) * stride]);
+		dst[last] *= inv_filter_size;
+		
+		// Recursively apply boxcar filter to all previous data points
+		for(size_t k = length - 1; k--;)
+		{
+			const float add = k >= radius ? FILTER_NAN(src[(k - radius) * stride]) : 0.0;
+			const float sub = k + radius + 1 < length ? FILTER_NAN(src[(k + radius + 1) * stride]) : 0.0;
+			dst[k * stride] = dst[(k + 1) * stride] + (add - sub) * inv_filter_size;
+		}
+	}
+	
+	*spare = (float *)input;
+	return output;
+}
+
+
+
+/// @brief Add pixels above threshold in device buffer to bit mask
+///
+/// Private method for setting all bits in the device-resident bit
+/// mask for which the absolute value of the corresponding element
+/// of the smoothed device buffer exceeds the specified threshold.
+/// Elements that are blanked in the original data array will be
+/// ignored. Each device thread assembles one word of the bit mask.
+///
+/// @param data       Device-resident original data array.
+/// @param smoothed   Device-resident smoothed data array.
+/// @param words      Device-resident words of bit mask.
+/// @param size       Number of elements in data array.
+/// @param threshold  Absolute flux threshold to be applied.
+
+PRIVATE void DataCube_device_mask(const float *data, const float *smoothed, uint64_t *words, const size_t size, const double threshold)
+{
+	ensure(threshold > 0.0, ERR_USER_INPUT, "Threshold must be positive.");
+	const size_t n_words = (size + BITMASK_WORD_BITS - 1) / BITMASK_WORD_BITS;
+	
+	#pragma omp target teams distribute parallel for map(alloc: data[0:size], smoothed[0:size], words[0:n_words])
+	for(size_t w = 0; w < n_words; ++w)
+	{
+		const size_t first = w * BITMASK_WORD_BITS;
+		const size_t last  = first + BITMASK_WORD_BITS < size ? first + BITMASK_WORD_BITS : size;
+		uint64_t bits = 0;
+		
+		for(size_t i = first; i < last; ++i) if(IS_NOT_NAN(data[i]) && fabs(smoothed[i]) > threshold) bits |= (uint64_t)1 << (i - first);
+		words[w] |= bits;
+	}
+	
+	return;
+}
+
+
+
+/// @brief Run fused Smooth + Clip (S+C) finder on data cube
+///
+/// Public method for running a memory-efficient variant of the
+/// **Smooth + Clip** (S+C) finder on the specified data cube. The
+/// algorithm is the same as in DataCube_run_scfind(), except that
+/// only a single spatially smoothed buffer is created for each
+/// spatial kernel and then shared by all spectral kernels. For each
+/// spectrum, a cumulative sum along the spectral axis is computed on
+/// the fly, from which the boxcar-filtered values of all spectral
+/// kernels are obtained by differencing in a single pass. This avoids
+/// the creation of a full copy of the data cube for every kernel
+/// combination.
+///
+/// The spatially smoothed buffer can be further restricted to a slab
+/// of consecutive channels by setting `working_set` to the maximum
+/// amount of memory (in bytes) it should occupy. Each slab will be
+/// extended by the radius of the largest spectral kernel on either
+/// side to ensure that spectral smoothing across slab boundaries
+/// remains correct. If more than one slab is required, the spatial
+/// smoothing will need to be carried out twice for each slab, once
+/// for measuring the noise level and once for applying the flux
+/// threshold.
+///
+/// Note that in this mode the replacement of already detected pixels
+/// by `maskScaleXY` times the original rms is based on the mask at
+/// the beginning of each spatial kernel (after applying the spectral
+/// kernel of size 0 in the absence of spatial smoothing) rather than
+/// the mask from the previous kernel combination. The resulting mask
+/// can therefore differ slightly from the one produced by
+/// DataCube_run_scfind(). Noise scaling of the smoothed data is not
+/// supported in this mode.
+///
+/// @param self          Data cube to run the S+C finder on.
+/// @param mask          Bit mask for recording detected pixels.
+/// @param kernels_spat  List of spatial smoothing lengths corresponding
+///                      to the FWHM of the Gaussian kernels to be
+///                      applied; 0 = no smoothing.
+/// @param kernels_spec  List of spectral smoothing lengths corresponding
+///                      to the widths of the boxcar filters to be
+///                      applied. Must be odd or 0.
+/// @param threshold     Relative flux threshold to be applied.
+/// @param maskScaleXY   Already detected pixels will be set to this
+///                      value times the original rms of the data
+///                      before smoothing the data again. If negative,
+///                      no replacement will be carried out.
+/// @param method        Method to use for measuring the noise in
+///                      the smoothed data; can be `NOISE_STAT_STD`,
+///                      `NOISE_STAT_MAD` or `NOISE_STAT_GAUSS` for
+///                      standard deviation, median absolute deviation
+///                      and Gaussian fit to flux histogram, respectively.
+/// @param range         Flux range to used in noise measurement, Can
+///                      be -1, 0 or 1 for negative only, all or
+///                      positive only.
+/// @param mad_tolerance If greater than 0, the MAD will be approximated
+///                      from a histogram with a relative error not
+///                      exceeding this value. See DataCube_stat_mad().
+/// @param working_set   Maximum size of the spatially smoothed buffer
+///                      in bytes. If set to 0, the entire cube will
+///                      be processed in one go.
+/// @param profiler      Profiler for recording the statistics of each
+///                      spatial kernel. Can be `NULL`.
+/// @param start_time    Arbitrary time stamp; progress time of the
+///                      algorithm will be calculated and printed
+///                      relative to `start_time`.
+/// @param start_clock   Arbitrary clock count; progress time of the
+///                      algorithm in term of CPU time will be
+///                      calculated and printed relative to `clock_time`.
+
+PUBLIC void DataCube_run_scfind_fused(const DataCube *self, BitMask *mask, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const double mad_tolerance, const size_t working_set, Profiler *profiler, const time_t start_time, const clock_t start_clock)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	ensure(self->data_type < 0, ERR_USER_INPUT, "The S+C finder can only be applied to floating-point data.");
+	check_null(mask);
+	ensure(BitMask_get_size(mask) == self->data_size, ERR_USER_INPUT, "Data cube and mask have different sizes.");
+	check_null(kernels_spat);
+	check_null(kernels_spec);
+	ensure(Array_dbl_get_size(kernels_spat) && Array_siz_get_size(kernels_spec), ERR_USER_INPUT, "Invalid spatial or spectral kernel list encountered.");
+	ensure(threshold >= 0.0, ERR_USER_INPUT, "Negative flux threshold encountered.");
+	ensure(method == NOISE_STAT_STD || method == NOISE_STAT_MAD || method == NOISE_STAT_GAUSS, ERR_USER_INPUT, "Invalid noise measurement method: %d.", method);
+	
+	// A few additional settings
+	const double FWHM_CONST = 2.0 * sqrt(2.0 * log(2.0));  // Conversion between sigma and FWHM of Gaussian function
+	size_t cadence = self->data_size / NOISE_SAMPLE_SIZE;  // Stride for noise calculation
+	if(cadence < 2) cadence = 1;
+	else if(cadence % self->axis_size[0] == 0) cadence -= 1;    // Ensure stride is not equal to multiple of x-axis size
+	message("Using a stride of %zu in noise measurement.", cadence);
+	
+	// Measure noise in original cube with sampling "cadence"
+	double rms;
+	
+	if(method == NOISE_STAT_STD)      rms = DataCube_stat_std(self, 0.0, cadence, range);
+	else if(method == NOISE_STAT_MAD) rms = MAD_TO_STD * DataCube_stat_mad(self, 0.0, cadence, range, mad_tolerance);
+	else                              rms = DataCube_stat_gauss(self, cadence, range);
+	
+	// Determine slab size from working set
+	const size_t n_spec = Array_siz_get_size(kernels_spec);
+	const size_t size_plane = self->axis_size[0] * self->axis_size[1];
+	size_t radius_max = 0;
+	for(size_t j = 0; j < n_spec; ++j) if(Array_siz_get(kernels_spec, j) / 2 > radius_max) radius_max = Array_siz_get(kernels_spec, j) / 2;
+	
+	size_t slab_size = self->axis_size[2];
+	if(working_set)
+	{
+		const size_t n_planes = working_set / (size_plane * self->word_size);
+		if(n_planes > 2 * radius_max) slab_size = n_planes - 2 * radius_max;
+		else
+		{
+			warning("Working set of %.1f MB too small for largest spectral kernel.\n         Processing one channel at a time.", (double)working_set / MEGABYTE);
+			slab_size = 1;
+		}
+		if(slab_size > self->axis_size[2]) slab_size = self->axis_size[2];
+	}
+	const size_t n_slabs = (self->axis_size[2] + slab_size - 1) / slab_size;
+	message("Processing %zu slab%s of up to %zu channels.\n", n_slabs, n_slabs > 1 ? "s" : "", slab_size);
+	
+	// Memory for noise samples of each spectral kernel
+	const size_t n_samples = self->data_size / cadence;
+	double *samples    = (double *)memory(MALLOC, n_spec * n_samples, sizeof(double));
+	double *rms_smooth = (double *)memory(MALLOC, n_spec, sizeof(double));
+	double *thresholds = (double *)memory(MALLOC, n_spec, sizeof(double));
+	
+	// Separate bit mask for new detections of the current spatial kernel
+	BitMask *mask_new = BitMask_new(self->data_size);
+	
+	// Original blanks, recorded once rather than re-read for every slab
+	BitMask *blanks = DataCube_get_blanked_bits(self);
+	
+	// Run S+C finder for all spatial kernels
+	for(size_t i = 0; i < Array_dbl_get_size(kernels_spat); ++i)
+	{
+		const double sigma = Array_dbl_get(kernels_spat, i) / FWHM_CONST;
+		
+		if(profiler != NULL)
+		{
+			char stage[64];
+			snprintf(stage, sizeof(stage), "scfind [%.1f] x [all]", Array_dbl_get(kernels_spat, i));
+			Profiler_start(profiler, stage, self->data_size);
+		}
+		
+		// Without spatial smoothing, apply threshold to original cube first
+		if(sigma <= 0.0)
+		{
+			for(size_t j = 0; j < n_spec; ++j)
+			{
+				if(Array_siz_get(kernels_spec, j) == 0)
+				{
+					message("Smoothing kernel:  [%.1f] x [%zu]", Array_dbl_get(kernels_spat, i), Array_siz_get(kernels_spec, j));
+					message("Noise level:       %.3e", rms);
+					DataCube_mask_bits(self, mask, threshold * rms);
+				}
+			}
+		}
+		
+		// Check if any smoothing required for current spatial kernel
+		bool smoothing = sigma > 0.0;
+		for(size_t j = 0; j < n_spec; ++j) if(Array_siz_get(kernels_spec, j)) smoothing = true;
+		if(!smoothing)
+		{
+			timestamp(start_time, start_clock);
+			continue;
+		}
+		
+		// Initialise noise samples
+		for(double *ptr = samples + n_spec * n_samples; ptr --> samples;) *ptr = NAN;
+		
+		DataCube *slab = NULL;
+		
+		// Two passes: measure noise first, then apply threshold
+		for(int pass = 0; pass < 2; ++pass)
+		{
+			if(pass == 1)
+			{
+				// Determine noise level of each kernel combination
+				for(size_t j = 0; j < n_spec; ++j)
+				{
+					if(sigma <= 0.0 && Array_siz_get(kernels_spec, j) == 0) continue;
+					
+					double *ptr = samples + j * n_samples;
+					if(method == NOISE_STAT_STD)      rms_smooth[j] = std_dev_val_dbl(ptr, n_samples, 0.0, 1, range);
+					else if(method == NOISE_STAT_MAD) rms_smooth[j] = MAD_TO_STD * mad_val_dbl(ptr, n_samples, 0.0, 1, range);
+					else                              rms_smooth[j] = gaufit_dbl(ptr, n_samples, 1, range);
+					thresholds[j] = threshold * rms_smooth[j];
+					
+					message("Smoothing kernel:  [%.1f] x [%zu]", Array_dbl_get(kernels_spat, i), Array_siz_get(kernels_spec, j));
+					message("Noise level:       %.3e", rms_smooth[j]);
+				}
+			}
+			
+			for(size_t z_min = 0; z_min < self->axis_size[2]; z_min += slab_size)
+			{
+				const size_t z_max = z_min + slab_size < self->axis_size[2] ? z_min + slab_size - 1 : self->axis_size[2] - 1;
+				const size_t z_lo  = z_min > radius_max ? z_min - radius_max : 0;
+				const size_t z_hi  = z_max + radius_max < self->axis_size[2] ? z_max + radius_max : self->axis_size[2] - 1;
+				
+				// Create spatially smoothed slab unless retained from previous pass
+				if(slab == NULL || n_slabs > 1)
+				{
+					DataCube_delete(slab);
+					slab = DataCube_scfind_slab(self, mask, z_lo, z_hi, maskScaleXY >= 0.0 ? maskScaleXY * rms : -1.0, sigma);
+				}
+				
+				// Apply all spectral kernels in a single pass
+				if(pass == 0) DataCube_scfind_filter_slab(slab, self, mask, blanks, mask_new, z_lo, z_min, z_max, kernels_spec, sigma <= 0.0, cadence, samples, NULL);
+				else          DataCube_scfind_filter_slab(slab, self, mask, blanks, mask_new, z_lo, z_min, z_max, kernels_spec, sigma <= 0.0, cadence, NULL, thresholds);
+			}
+		}
+		
+		DataCube_delete(slab);
+		
+		// Turn new detections into regular mask pixels
+		BitMask_merge(mask, mask_new);
+		BitMask_reset(mask_new);
+		
+		// Print time
+		timestamp(start_time, start_clock);
+	}
+	
+	// Clean up
+	free(samples);
+	free(rms_smooth);
+	free(thresholds);
+	BitMask_delete(mask_new);
+	BitMask_delete(blanks);
+	
+	return;
+}
+
+
+
+/// @brief Create spatially smoothed slab for fused S+C finder
+///
+/// Private method for extracting the channel range from `z_min` to
+/// `z_max` of the specified data cube into a new data cube, setting
+/// all pixels previously detected in the mask to their signum
+/// multiplied by `replacement` and then applying a Gaussian filter
+/// of standard deviation `sigma` to each channel. New detections of
+/// the current spatial kernel are kept in a separate mask and will
+/// hence not be replaced. A pointer to the newly created slab will be
+/// returned.
+///
+/// @param self         Object self-reference.
+/// @param mask         Bit mask of previous detections.
+/// @param z_min        First channel of the slab.
+/// @param z_max        Last channel of the slab.
+/// @param replacement  Replacement value for previously detected
+///                     pixels. If negative, no replacement will be
+///                     carried out.
+/// @param sigma        Standard deviation of Gaussian filter in
+///                     pixels. If 0, no spatial smoothing will be
+///                     applied.
+///
+/// @return Pointer to newly created slab.
+///
+/// @note The caller will be responsible for calling the destructor
+///       on the returned slab once it is no longer needed.
+
+PRIVATE DataCube *DataCube_scfind_slab(const DataCube *self, const BitMask *mask, const size_t z_min, const size_t z_max, const double replacement, const double sigma)
+{
+	const size_t size_plane = self->axis_size[0] * self->axis_size[1];
+	DataCube *slab = DataCube_blank(self->axis_size[0], self->axis_size[1], z_max - z_min + 1, self->data_type, self->verbosity);
+	
+	// Copy data
+	memcpy(slab->data, self->data + z_min * size_plane * self->word_size, slab->data_size * slab->word_size);
+	
+	// Set flux of already detected pixels to replacement value
+	if(replacement >= 0.0)
+	{
+		const size_t offset = z_min * size_plane;
+		
+		if(slab->data_type == -32)
+		{
+			float *ptr_data = (float *)(slab->data);
+			
+			#pragma omp parallel for schedule(static)
+			for(size_t i = 0; i < slab->data_size; ++i)
+			{
+				if(BitMask_get(mask, offset + i)) *(ptr_data + i) = copysign(replacement, *(ptr_data + i));
+			}
+		}
+		else
+		{
+			double *ptr_data = (double *)(slab->data);
+			
+			#pragma omp parallel for schedule(static)
+			for(size_t i = 0; i < slab->data_size; ++i)
+			{
+				if(BitMask_get(mask, offset + i)) *(ptr_data + i) = copysign(replacement, *(ptr_data + i));
+			}
+		}
+	}
+	
+	// Spatial smoothing
+	if(sigma > 0.0) DataCube_gaussian_filter(slab, sigma);
 	
-	if(method == NOISE_STAT_STD)      rms = DataCube_stat_std(self, 0.0, cadence, range);
-	else if(method == NOISE_STAT_MAD) rms = MAD_TO_STD * DataCube_stat_mad(self, 0.0, cadence, range);
-	else                              rms = DataCube_stat_gauss(self, cadence, range);
+	return slab;
+}
+
+
+
+/// @brief Apply spectral kernels to slab for fused S+C finder
+///
+/// Private method for applying boxcar filters of size `2 * radius + 1`
+/// for all spectral kernels to each spectrum of the specified slab and
+/// then either recording the noise samples of the smoothed spectra or
+/// adding all pixels with an absolute value greater than the threshold
+/// of any kernel to the mask cube. Rather than filtering each spectrum
+/// once per kernel, the cumulative sum along the spectrum is computed
+/// once, and the boxcar-filtered value for each kernel is obtained by
+/// differencing. As in filter_boxcar_1d_SFX(), `NaN` values and values
+/// beyond the edges of the slab are treated as 0.
+///
+/// Only channels `z_min` to `z_max` of the original cube will be
+/// processed; the remaining channels of the slab serve as margins for
+/// the boxcar filter. Blanked pixels in the original data cube will
+/// be ignored. New detections are recorded in the separate mask
+/// `mask_new` so they can be distinguished from those of previous
+/// kernels.
+///
+/// Noise samples are those pixels that would be used by the noise
+/// measurement functions with a stride of `cadence` on the entire
+/// cube. They will be stored in reverse order, so the same pixels
+/// are picked up when running the noise measurement functions with a
+/// stride of 1 on the sample array.
+///
+/// @param slab          Spatially smoothed slab.
+/// @param self          Original data cube.
+/// @param mask          Bit mask of previous detections.
+/// @param blanks        Bit mask of blanked pixels in the original cube,
+///                      which will be skipped.
+/// @param mask_new      Bit mask for recording new detections.
+/// @param z_offset      First channel of the slab in the original cube.
+/// @param z_min         First channel to be processed.
+/// @param z_max         Last channel to be processed.
+/// @param kernels_spec  List of spectral kernel sizes in channels.
+/// @param skip_zero     If `true`, spectral kernels of size 0 will be
+///                      skipped.
+/// @param cadence       Stride used in noise measurement.
+/// @param samples       Array for storing the noise samples, with
+///                      `data_size / cadence` elements for each
+///                      kernel. If `NULL`, the thresholds will
+///                      instead be applied.
+/// @param thresholds    Array of absolute flux thresholds to be
+///                      applied for each kernel.
+
+PRIVATE void DataCube_scfind_filter_slab(const DataCube *slab, const DataCube *self, const BitMask *mask, const BitMask *blanks, BitMask *mask_new, const size_t z_offset, const size_t z_min, const size_t z_max, const Array_siz *kernels_spec, const bool skip_zero, const size_t cadence, double *samples, const double *thresholds)
+{
+	const size_t size_plane = slab->axis_size[0] * slab->axis_size[1];
+	const size_t size_spec  = slab->axis_size[2];
+	const size_t n_samples  = self->data_size / cadence;
+	const size_t n_spec     = Array_siz_get_size(kernels_spec);
 	
-	// Run S+C finder for all smoothing kernels
-	for(size_t i = 0; i < Array_dbl_get_size(kernels_spat); ++i)
+	#pragma omp parallel
 	{
-		for(size_t j = 0; j < Array_siz_get_size(kernels_spec); ++j)
+		// Memory for a single spectrum and its cumulative sum
+		double *spectrum = (double *)memory(MALLOC, size_spec, sizeof(double));
+		double *prefix   = (double *)memory(MALLOC, size_spec + 1, sizeof(double));
+		
+		#pragma omp for schedule(static)
+		for(size_t xy = 0; xy < size_plane; ++xy)
 		{
-			message("Smoothing kernel:  [%.1f] x [%zu]", Array_dbl_get(kernels_spat, i), Array_siz_get(kernels_spec, j));
+			// Extract spectrum
+			if(slab->data_type == -32) for(size_t z = size_spec; z--;) spectrum[z] = *((float *)(slab->data) + xy + size_plane * z);
+			else for(size_t z = size_spec; z--;) spectrum[z] = *((double *)(slab->data) + xy + size_plane * z);
 			
-			// Check if any smoothing requested
-			if(Array_dbl_get(kernels_spat, i) || Array_siz_get(kernels_spec, j))
+			// Calculate cumulative sum along spectrum
+			prefix[0] = 0.0;
+			for(size_t z = 0; z < size_spec; ++z) prefix[z + 1] = prefix[z] + FILTER_NAN(spectrum[z]);
+			
+			for(size_t z = z_min; z <= z_max; ++z)
 			{
-				// Smoothing required; create a copy of the original cube
-				DataCube *smoothedCube = DataCube_copy(self);
-				
-				// Set flux of already detected pixels to maskScaleXY * rms
-				if(maskScaleXY >= 0.0) DataCube_set_masked_8(smoothedCube, maskCube, maskScaleXY * rms);
-				
-				// Spatial and spectral smoothing
-				if(Array_dbl_get(kernels_spat, i) > 0.0) DataCube_gaussian_filter(smoothedCube, Array_dbl_get(kernels_spat, i) / FWHM_CONST);
-				if(Array_siz_get(kernels_spec, j) > 0)   DataCube_boxcar_filter(smoothedCube, Array_siz_get(kernels_spec, j) / 2);
+				const size_t index = xy + size_plane * z;
+				if(BitMask_get(blanks, index)) continue;
 				
-				// Copy original blanks into smoothed cube again
-				// (these were set to 0 during smoothing)
-				DataCube_copy_blanked(smoothedCube, self);
+				const size_t zz = z - z_offset;
 				
-				// Scale noise if requested
-				if(scaleNoise == 1)
-				{
-					message("Correcting for noise variations along spectral axis.\n");
-					DataCube_scale_noise_spec(smoothedCube, snStatistic, snRange);
-				}
-				else if(scaleNoise == 2)
+				for(size_t j = 0; j < n_spec; ++j)
 				{
-					message("Correcting for local noise variations.");
-					DataCube *noiseCube = DataCube_scale_noise_local(
-						smoothedCube,
-						snStatistic,
-						snRange,
-						snWindowXY,
-						snWindowZ,
-						snGridXY,
-						snGridZ,
-						snInterpol
-					);
-					DataCube_delete(noiseCube);
+					const size_t radius = Array_siz_get(kernels_spec, j) / 2;
+					if(skip_zero && radius == 0) continue;
+					
+					// Boxcar-filtered value from cumulative sum
+					double value;
+					if(radius)
+					{
+						const size_t first = zz > radius ? zz - radius : 0;
+						const size_t last  = zz + radius + 1 < size_spec ? zz + radius + 1 : size_spec;
+						value = (prefix[last] - prefix[first]) / (double)(2 * radius + 1);
+					}
+					else value = spectrum[zz];
+					
+					if(samples != NULL)
+					{
+						if((self->data_size - index) % cadence == 0) samples[j * n_samples + n_samples - (self->data_size - index) / cadence] = value;
+					}
+					else if(fabs(value) > thresholds[j] && !BitMask_get(mask, index)) BitMask_set(mask_new, index);
 				}
-				
-				// Calculate the RMS of the smoothed cube
-				if(method == NOISE_STAT_STD)      rms_smooth = DataCube_stat_std(smoothedCube, 0.0, cadence, range);
-				else if(method == NOISE_STAT_MAD) rms_smooth = MAD_TO_STD * DataCube_stat_mad(smoothedCube, 0.0, cadence, range);
-				else                              rms_smooth = DataCube_stat_gauss(smoothedCube, cadence, range);
-				
-				message("Noise level:       %.3e", rms_smooth);
-				
-				// Add pixels above threshold to mask
-				DataCube_mask_8(smoothedCube, maskCube, threshold * rms_smooth, 1);
-				
-				// Delete smoothed cube again
-				DataCube_delete(smoothedCube);
-			}
-			else
-			{
-				// No smoothing required; apply threshold to original cube
-				message("Noise level:       %.3e", rms);
-				DataCube_mask_8(self, maskCube, threshold * rms, 1);
 			}
-			
-			// Print time
-			timestamp(start_time, start_clock);
 		}
+		
+		// Release memory
+		free(spectrum);
+		free(prefix);
 	}
 	
 	return;
@@ -3988,7 +6107,7 @@ PUBLIC void DataCube_run_scfind(const DataCube *self, DataCube *maskCube, const
 ///
 /// Public method for running a simple threshold finder on the data
 /// cube specified by the user. Detected pixels will be added to
-/// the mask cube provided, which must be of 8-bit integer type.
+/// the bit mask provided.
 /// The specified flux threshold can either be absolute or relative
 /// depending on the value of the `absolute` parameter. In the latter
 /// case, the threshold will be multiplied by the noise level across
@@ -3996,28 +6115,30 @@ PUBLIC void DataCube_run_scfind(const DataCube *self, DataCube *maskCube, const
 /// by the user. In both cases, pixels with an absolute flux value
 /// greater than the threshold will be added to the mask cube.
 ///
-/// @param self       Data cube to run the threshold finder on.
-/// @param maskCube   Mask cube for recording detected pixels.
-/// @param absolute   If true, apply absolute threshold; otherwise
-///                   multiply threshold by noise level.
-/// @param threshold  Absolute or relative flux threshold.
-/// @param method     Method to use for measuring the noise in
-///                   the cube; can be `NOISE_STAT_STD`,
-///                   `NOISE_STAT_MAD` or `NOISE_STAT_GAUSS` for
-///                   standard deviation, median absolute deviation
-///                   and Gaussian fit to flux histogram, respectively.
-/// @param range      Flux range to used in noise measurement, Can
-///                   be -1, 0 or 1 for negative only, all or
-///                   positive only, respectively.
-
-PUBLIC void DataCube_run_threshold(const DataCube *self, DataCube *maskCube, const bool absolute, double threshold, const noise_stat method, const int range)
+/// @param self           Data cube to run the threshold finder on.
+/// @param mask           Bit mask for recording detected pixels.
+/// @param absolute       If true, apply absolute threshold; otherwise
+///                       multiply threshold by noise level.
+/// @param threshold      Absolute or relative flux threshold.
+/// @param method         Method to use for measuring the noise in
+///                       the cube; can be `NOISE_STAT_STD`,
+///                       `NOISE_STAT_MAD` or `NOISE_STAT_GAUSS` for
+///                       standard deviation, median absolute deviation
+///                       and Gaussian fit to flux histogram, respectively.
+/// @param range          Flux range to used in noise measurement, Can
+///                       be -1, 0 or 1 for negative only, all or
+///                       positive only, respectively.
+/// @param mad_tolerance  If greater than 0, the MAD will be approximated
+///                       from a histogram with a relative error not
+///                       exceeding this value. See DataCube_stat_mad().
+
+PUBLIC void DataCube_run_threshold(const DataCube *self, BitMask *mask, const bool absolute, double threshold, const noise_stat method, const int range, const double mad_tolerance)
 {
 	// Sanity checks
 	check_null(self);
 	ensure(self->data_type < 0, ERR_USER_INPUT, "The S+C finder can only be applied to floating-point data.");
-	check_null(maskCube);
-	ensure(maskCube->data_type == 8, ERR_USER_INPUT, "Mask cube must be of 8-bit integer type.");
-	ensure(self->axis_size[0] == maskCube->axis_size[0] && self->axis_size[1] == maskCube->axis_size[1] && self->axis_size[2] == maskCube->axis_size[2], ERR_USER_INPUT, "Data cube and mask cube have different sizes.");
+	check_null(mask);
+	ensure(BitMask_get_size(mask) == self->data_size, ERR_USER_INPUT, "Data cube and mask have different sizes.");
 	ensure(threshold >= 0.0, ERR_USER_INPUT, "Negative flux threshold encountered.");
 	ensure(method == NOISE_STAT_STD || method == NOISE_STAT_MAD || method == NOISE_STAT_GAUSS, ERR_USER_INPUT, "Invalid noise measurement method: %d.", method);
 	
@@ -4032,14 +6153,14 @@ PUBLIC void DataCube_run_threshold(const DataCube *self, DataCube *maskCube, con
 		// Multiply threshold by rms
 		double rms = 0.0;
 		if(method == NOISE_STAT_STD)      rms = DataCube_stat_std(self, 0.0, cadence, range);
-		else if(method == NOISE_STAT_MAD) rms = DataCube_stat_mad(self, 0.0, cadence, range) * MAD_TO_STD;
+		else if(method == NOISE_STAT_MAD) rms = DataCube_stat_mad(self, 0.0, cadence, range, mad_tolerance) * MAD_TO_STD;
 		else                              rms = DataCube_stat_gauss(self, cadence, range);
 		message("- Noise level:      %.3e  (using stride of %zu)", rms, cadence);
 		threshold *= rms;
 	}
 	
 	// Apply threshold
-	DataCube_mask_8(self, maskCube, threshold, 1);
+	DataCube_mask_bits(self, mask, threshold);
 	
 	return;
 }
@@ -4089,9 +6210,13 @@ PUBLIC void DataCube_run_threshold(const DataCube *self, DataCube *maskCube, con
 /// @param pos_src     If `true`, negative sources will be discarded.
 /// @param rms         Global rms value by which all flux values will
 ///                    be normalised. 1 = no normalisation.
+/// @param parallel    If `true`, the parallel linker will be used.
+///                    The result will be identical to that of the
+///                    serial linker.
+///
+/// @return Pointer to newly created LinkerPar object.
 
-
-PUBLIC LinkerPar *DataCube_run_linker(const DataCube *self, DataCube *mask, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms)
+PUBLIC LinkerPar *DataCube_run_linker(const DataCube *self, DataCube *mask, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms, const bool parallel)
 {
 	// Sanity checks
 	check_null(self);
@@ -4104,127 +6229,509 @@ PUBLIC LinkerPar *DataCube_run_linker(const DataCube *self, DataCube *mask, cons
 	if(min_fill < 0.0) warning("Ignoring minimum filling factor; value is negative.");
 	if(max_fill < 0.0) warning("Ignoring maximum filling factor; value is negative.");
 	
-	// Print some information
-	message("Linker settings:");
-	message(" - Merging radii:   %zu, %zu, %zu", radius_x, radius_y, radius_z);
-	message(" - Minimum size:    %zu x %zu x %zu", min_size_x, min_size_y, min_size_z);
-	if(max_size_x || max_size_y || max_size_z) message(" - Maximum size:    %zu x %zu x %zu", max_size_x, max_size_y, max_size_z);
-	if(min_npix || max_npix) message(" - Min/max pixels:  %zu, %zu", min_npix, max_npix);
-	if(min_fill > 0.0 || max_fill > 0.0) message(" - Min/max fill:    %.1f%%, %.1f%%", 100.0 * min_fill, 100.0 * max_fill);
-	message(" - Keep negative:   %s\n", pos_src ? "no" : "yes");
+	// Print some information
+	message("Linker settings:");
+	message(" - Merging radii:   %zu, %zu, %zu", radius_x, radius_y, radius_z);
+	message(" - Minimum size:    %zu x %zu x %zu", min_size_x, min_size_y, min_size_z);
+	if(max_size_x || max_size_y || max_size_z) message(" - Maximum size:    %zu x %zu x %zu", max_size_x, max_size_y, max_size_z);
+	if(min_npix || max_npix) message(" - Min/max pixels:  %zu, %zu", min_npix, max_npix);
+	if(min_fill > 0.0 || max_fill > 0.0) message(" - Min/max fill:    %.1f%%, %.1f%%", 100.0 * min_fill, 100.0 * max_fill);
+	message(" - Keep negative:   %s", pos_src ? "no" : "yes");
+	message(" - Parallel mode:   %s\n", parallel ? "yes" : "no");
+	
+	// Hand over to parallel linker if requested
+	if(parallel) return DataCube_run_linker_parallel(self, mask, radius_x, radius_y, radius_z, min_size_x, min_size_y, min_size_z, min_npix, min_fill, max_size_x, max_size_y, max_size_z, max_npix, max_fill, pos_pix, pos_src, rms);
+	
+	// Create empty linker parameter object
+	LinkerPar *lpar = LinkerPar_new(self->verbosity);
+	
+	// Define a few parameters
+	const size_t nx = mask->axis_size[0];
+	const size_t ny = mask->axis_size[1];
+	const size_t nz = mask->axis_size[2];
+	const double rms_inv = 1.0 / rms;
+	int32_t label = 1;
+	int32_t *ptr_mask = (int32_t *)(mask->data);
+	const size_t cadence = (nz / 100) ? nz / 100 : 1;  // Only used for updating progress bar
+	Stack *stack = Stack_new();  // Scratch stack shared by all sources
+	
+	// Link pixels into sources
+	for(size_t z = nz; z--;)
+	{
+		if(z % cadence == 0) progress_bar("Progress: ", nz - z, nz);
+		
+		for(size_t y = ny; y--;)
+		{
+			for(size_t x = nx; x--;)
+			{
+				// Obtain index
+				const size_t index = DataCube_get_index(mask, x, y, z);
+				
+				// Check if pixel is detected
+				if(ptr_mask[index] < 0)
+				{
+					// Get flux value and check for NaN, Inf and positivity
+					const double flux = DataCube_get_data_flt(self, x, y, z);
+					if(!isfinite(flux) || (pos_pix && flux < 0.0))
+					{
+						ptr_mask[index] = 0;
+						continue;
+					}
+					
+					// Link new source and increment label if retained
+					if(DataCube_link_object(self, mask, lpar, stack, index, label, label, radius_x, radius_y, radius_z, min_size_x, min_size_y, min_size_z, min_npix, min_fill, max_size_x, max_size_y, max_size_z, max_npix, max_fill, pos_pix, pos_src, rms_inv))
+					{
+						ensure(++label > 0, ERR_INT_OVERFLOW, "Too many sources for 32-bit signed integer mask.");
+					}
+				}
+			}
+		}
+	}
+	
+	// Clean up
+	Stack_delete(stack);
+	
+	// Print information
+	LinkerPar_print_info(lpar);
+	
+	// Return LinkerPar object
+	return lpar;
+}
+
+
+
+/// @brief Parallel version of the linker
+///
+/// Private method for linking the detected pixels in the mask in
+/// parallel. The result, including the mask and the returned Linker-
+/// Par object, is identical to that of the serial linker implemented
+/// in DataCube_run_linker(), which is where all parameters are
+/// described.
+///
+/// Linking is carried out in three steps. First, the cube is divided
+/// into as many spectral slabs as there are threads, and the detected
+/// pixels within each slab are merged into connected components using
+/// a union-find structure. Components in neighbouring slabs that are
+/// within `radius_z` of each other are then merged across the slab
+/// boundaries. As the root of each component is always the pixel with
+/// the highest index, it coincides with the seed pixel from which the
+/// serial linker would have started. Lastly, each component is flood-
+/// filled from its seed in parallel, with the same size, pixel, fill
+/// and positivity filters applied, and the retained sources are
+/// labelled in the order in which the serial linker would have found
+/// them.
+///
+/// NOTE: The mask must only contain values of 0 (not detected) and
+///       -1 (detected). The number of detected pixels must not exceed
+///       the range of a 32-bit signed integer.
+///
+/// @return Pointer to newly created LinkerPar object.
+
+PRIVATE LinkerPar *DataCube_run_linker_parallel(const DataCube *self, DataCube *mask, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms)
+{
+	// Define a few parameters
+	const size_t nx = mask->axis_size[0];
+	const size_t ny = mask->axis_size[1];
+	const size_t nz = mask->axis_size[2];
+	const size_t size_xy = nx * ny;
+	const double rms_inv = 1.0 / rms;
+	int32_t *ptr_mask = (int32_t *)(mask->data);
+	const float  *data_flt = (float *)(self->data);
+	const double *data_dbl = (double *)(self->data);
+	
+	#ifdef _OPENMP
+		const size_t n_threads = omp_get_max_threads();
+	#else
+		const size_t n_threads = 1;
+	#endif
+	const size_t n_slabs = (nz < n_threads) ? (nz ? nz : 1) : n_threads;
+	
+	// Discard blanked and negative pixels and count detected pixels per channel
+	size_t *offset = (size_t *)memory(CALLOC, nz + 1, sizeof(size_t));
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < nz; ++z)
+	{
+		size_t counter = 0;
+		
+		for(size_t index = z * size_xy; index < (z + 1) * size_xy; ++index)
+		{
+			if(ptr_mask[index] < 0)
+			{
+				const double flux = (self->data_type == -32) ? data_flt[index] : data_dbl[index];
+				if(!isfinite(flux) || (pos_pix && flux < 0.0)) ptr_mask[index] = 0;
+				else ++counter;
+			}
+		}
+		
+		offset[z + 1] = counter;
+	}
+	
+	for(size_t z = 0; z < nz; ++z) offset[z + 1] += offset[z];
+	const size_t n_det = offset[nz];
+	ensure(n_det <= (size_t)(INT32_MAX), ERR_INT_OVERFLOW, "Too many detected pixels for parallel linker.");
+	
+	// Assign consecutive IDs to detected pixels, stored as -(ID + 1) in the mask
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < nz; ++z)
+	{
+		int64_t id = offset[z];
+		
+		for(size_t index = z * size_xy; index < (z + 1) * size_xy; ++index)
+		{
+			if(ptr_mask[index] < 0) ptr_mask[index] = (int32_t)(-id - 1), ++id;
+		}
+	}
+	
+	// Merge detected pixels within slabs
+	uint32_t *parent = (uint32_t *)memory(MALLOC, n_det ? n_det : 1, sizeof(uint32_t));
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t slab = 0; slab < n_slabs; ++slab)
+	{
+		const size_t z_min = slab * nz / n_slabs;
+		const size_t z_max = (slab + 1) * nz / n_slabs;
+		
+		for(size_t index = z_min * size_xy; index < z_max * size_xy; ++index)
+		{
+			if(ptr_mask[index] < 0)
+			{
+				const uint32_t id = (uint32_t)(-((int64_t)(ptr_mask[index]) + 1));
+				parent[id] = id;
+				DataCube_linker_merge_neighbours(mask, parent, index, radius_x, radius_y, radius_z, z_min, z_max - 1);
+			}
+		}
+	}
+	
+	// Merge components across slab boundaries
+	for(size_t slab = 1; slab < n_slabs; ++slab)
+	{
+		const size_t z_min = slab * nz / n_slabs;
+		const size_t z_max = (slab + 1) * nz / n_slabs;
+		const size_t z_end = (z_min + radius_z < z_max) ? z_min + radius_z : z_max;
+		
+		for(size_t index = z_min * size_xy; index < z_end * size_xy; ++index)
+		{
+			if(ptr_mask[index] < 0) DataCube_linker_merge_neighbours(mask, parent, index, radius_x, radius_y, radius_z, 0, z_min - 1);
+		}
+	}
+	
+	// Count seed pixels (component roots) per channel
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < nz; ++z)
+	{
+		size_t counter = 0;
+		
+		for(size_t index = z * size_xy; index < (z + 1) * size_xy; ++index)
+		{
+			if(ptr_mask[index] < 0)
+			{
+				const uint32_t id = (uint32_t)(-((int64_t)(ptr_mask[index]) + 1));
+				if(parent[id] == id) ++counter;
+			}
+		}
+		
+		offset[z + 1] = counter;
+	}
+	
+	for(size_t z = 0; z < nz; ++z) offset[z + 1] += offset[z];
+	const size_t n_src = offset[nz];
+	
+	// Record seed pixels in the order in which the serial linker would find them
+	size_t *seed = (size_t *)memory(MALLOC, n_src ? n_src : 1, sizeof(size_t));
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < nz; ++z)
+	{
+		size_t counter = n_src - offset[z];
+		
+		for(size_t index = z * size_xy; index < (z + 1) * size_xy; ++index)
+		{
+			if(ptr_mask[index] < 0)
+			{
+				const uint32_t id = (uint32_t)(-((int64_t)(ptr_mask[index]) + 1));
+				if(parent[id] == id) seed[--counter] = index;
+			}
+		}
+	}
+	
+	free(parent);
+	free(offset);
+	
+	// Link components from their seeds in parallel, using temporary mask labels of 1 to n_src
+	// NOTE: Each thread's LinkerPar object uses labels of its own, counting up from 1, such
+	//       that its label lookup table only grows with the number of sources of that thread.
+	LinkerPar **lpar_thread = (LinkerPar **)memory(MALLOC, n_threads, sizeof(LinkerPar *));
+	for(size_t i = 0; i < n_threads; ++i) lpar_thread[i] = LinkerPar_new(self->verbosity);
+	size_t *src_thread = (size_t *)memory(MALLOC, n_src ? n_src : 1, sizeof(size_t));
+	size_t *src_entry  = (size_t *)memory(MALLOC, n_src ? n_src : 1, sizeof(size_t));
+	
+	// NOTE: Blanked and negative pixels were already set to 0 above, so the
+	//       flood fill will only ever change pixels of its own component.
+	#pragma omp parallel
+	{
+		#ifdef _OPENMP
+			const size_t thread = omp_get_thread_num();
+		#else
+			const size_t thread = 0;
+		#endif
+		Stack *stack = Stack_new();  // Scratch stack shared by all sources of this thread
+		
+		#pragma omp for schedule(dynamic)
+		for(size_t i = 0; i < n_src; ++i)
+		{
+			if(DataCube_link_object(self, mask, lpar_thread[thread], stack, seed[i], (int32_t)(i + 1), LinkerPar_get_size(lpar_thread[thread]) + 1, radius_x, radius_y, radius_z, min_size_x, min_size_y, min_size_z, min_npix, min_fill, max_size_x, max_size_y, max_size_z, max_npix, max_fill, pos_pix, pos_src, rms_inv))
+			{
+				src_thread[i] = thread;
+				src_entry[i]  = LinkerPar_get_size(lpar_thread[thread]) - 1;
+			}
+			else src_thread[i] = n_threads;
+		}
+		
+		Stack_delete(stack);
+	}
+	
+	// Collect retained sources in serial order and assign final labels
+	LinkerPar *lpar = LinkerPar_new(self->verbosity);
+	int32_t *new_label = (int32_t *)memory(MALLOC, n_src ? n_src : 1, sizeof(int32_t));
+	int32_t label = 1;
+	
+	size_t n_keep = 0;
+	for(size_t i = 0; i < n_threads; ++i) n_keep += LinkerPar_get_size(lpar_thread[i]);
+	LinkerPar_reserve(lpar, n_keep);
+	
+	for(size_t i = 0; i < n_src; ++i)
+	{
+		if(src_thread[i] < n_threads)
+		{
+			LinkerPar_append(lpar, lpar_thread[src_thread[i]], src_entry[i], label);
+			new_label[i] = label++;
+		}
+		else new_label[i] = 0;
+	}
+	
+	// Relabel mask
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < nz; ++z)
+	{
+		for(size_t index = z * size_xy; index < (z + 1) * size_xy; ++index)
+		{
+			if(ptr_mask[index] > 0) ptr_mask[index] = new_label[ptr_mask[index] - 1];
+		}
+	}
+	
+	// Clean up
+	for(size_t i = 0; i < n_threads; ++i) LinkerPar_delete(lpar_thread[i]);
+	free(lpar_thread);
+	free(src_thread);
+	free(src_entry);
+	free(new_label);
+	free(seed);
 	
-	// Create empty linker parameter object
-	LinkerPar *lpar = LinkerPar_new(self->verbosity);
+	// Print information
+	LinkerPar_print_info(lpar);
 	
+	// Return LinkerPar object
+	return lpar;
+}
+
+
+
+/// @brief Link a single object starting from its seed pixel
+///
+/// Private method for linking the object whose seed pixel is located
+/// at `index`. The seed is assigned the specified `label` in the mask,
+/// and a new entry with label `lpar_label` is added to `lpar` before
+/// all neighbouring pixels are linked by DataCube_process_stack(),
+/// using the empty scratch stack `stack`. The two labels only differ
+/// in the parallel linker, where each thread's `lpar` uses labels of
+/// its own. If the resulting object falls outside the size, pixel,
+/// fill or positivity requirements, its pixels will be set to 0 in
+/// the mask and its entry removed from `lpar` again. Otherwise, its
+/// edge flags will be updated. The seed pixel must be a valid, finite,
+/// detected pixel. All other parameters are the same as for
+/// DataCube_run_linker().
+///
+/// @return `true` if the object was retained, `false` otherwise.
+
+PRIVATE bool DataCube_link_object(const DataCube *self, DataCube *mask, LinkerPar *lpar, Stack *stack, const size_t index, const int32_t label, const size_t lpar_label, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms_inv)
+{
 	// Define a few parameters
-	const size_t nx = mask->axis_size[0];
-	const size_t ny = mask->axis_size[1];
-	const size_t nz = mask->axis_size[2];
 	const size_t max_x = mask->axis_size[0] ? mask->axis_size[0] - 1 : 0;
 	const size_t max_y = mask->axis_size[1] ? mask->axis_size[1] - 1 : 0;
 	const size_t max_z = mask->axis_size[2] ? mask->axis_size[2] - 1 : 0;
-	const double rms_inv = 1.0 / rms;
-	int32_t label = 1;
 	int32_t *ptr_mask = (int32_t *)(mask->data);
-	const size_t cadence = (nz / 100) ? nz / 100 : 1;  // Only used for updating progress bar
+	size_t x, y, z;
+	DataCube_get_xyz(mask, index, &x, &y, &z);
+	const double flux = DataCube_get_data_flt(self, x, y, z);
 	
-	// Link pixels into sources
-	for(size_t z = nz; z--;)
+	// Set pixel to label
+	ptr_mask[index] = label;
+	
+	// Set quality flag
+	unsigned char flag = 0;
+	if(x == 0 || x == max_x || y == 0 || y == max_y) flag |= 1;
+	if(z == 0 || z == max_z) flag |= 2;
+	
+	// Create a new linker parameter entry
+	LinkerPar_push(lpar, lpar_label, x, y, z, flux * rms_inv, flag);
+	
+	// Recursively process neighbouring pixels
+	Stack_push(stack, index);
+	DataCube_process_stack(self, mask, stack, radius_x, radius_y, radius_z, label, lpar, rms_inv, pos_pix);
+	
+	// Check if new source outside size (and other) requirements
+	if(LinkerPar_get_obj_size(lpar, lpar_label, 0) < min_size_x
+	|| LinkerPar_get_obj_size(lpar, lpar_label, 1) < min_size_y
+	|| LinkerPar_get_obj_size(lpar, lpar_label, 2) < min_size_z
+	|| (max_size_x && LinkerPar_get_obj_size(lpar, lpar_label, 0) > max_size_x)
+	|| (max_size_y && LinkerPar_get_obj_size(lpar, lpar_label, 1) > max_size_y)
+	|| (max_size_z && LinkerPar_get_obj_size(lpar, lpar_label, 2) > max_size_z)
+	|| LinkerPar_get_npix(lpar, lpar_label) < min_npix
+	|| (max_npix && LinkerPar_get_npix(lpar, lpar_label) > max_npix)
+	|| (min_fill > 0.0 && (double)LinkerPar_get_npix(lpar, lpar_label) / (double)(LinkerPar_get_obj_size(lpar, lpar_label, 0) * LinkerPar_get_obj_size(lpar, lpar_label, 1) * LinkerPar_get_obj_size(lpar, lpar_label, 2)) < min_fill)
+	|| (max_fill > 0.0 && (double)LinkerPar_get_npix(lpar, lpar_label) / (double)(LinkerPar_get_obj_size(lpar, lpar_label, 0) * LinkerPar_get_obj_size(lpar, lpar_label, 1) * LinkerPar_get_obj_size(lpar, lpar_label, 2)) > max_fill)
+	|| (pos_src && LinkerPar_get_flux(lpar, lpar_label) < 0.0))
 	{
-		if(z % cadence == 0) progress_bar("Progress: ", nz - z, nz);
+		// Yes, it is -> discard source
+		// Get source bounding box
+		size_t x_min, x_max, y_min, y_max, z_min, z_max;
+		LinkerPar_get_bbox(lpar, lpar_label, &x_min, &x_max, &y_min, &y_max, &z_min, &z_max);
 		
-		for(size_t y = ny; y--;)
+		// Set all source pixels to 0 in mask
+		for(size_t zz = z_min; zz <= z_max; ++zz)
 		{
-			for(size_t x = nx; x--;)
+			for(size_t yy = y_min; yy <= y_max; ++yy)
 			{
-				// Obtain index
-				const size_t index = DataCube_get_index(mask, x, y, z);
-				
-				// Check if pixel is detected
-				if(ptr_mask[index] < 0)
+				for(size_t xx = x_min; xx <= x_max; ++xx)
 				{
-					// Get flux value and check for NaN, Inf and positivity
-					const double flux = DataCube_get_data_flt(self, x, y, z);
-					if(!isfinite(flux) || (pos_pix && flux < 0.0))
-					{
-						ptr_mask[index] = 0;
-						continue;
-					}
-					
-					// Set pixel to label
-					ptr_mask[index] = label;
-					
-					// Set quality flag
-					unsigned char flag = 0;
-					if(x == 0 || x == max_x || y == 0 || y == max_y) flag |= 1;
-					if(z == 0 || z == max_z) flag |= 2;
-					
-					// Create a new linker parameter entry
-					LinkerPar_push(lpar, label, x, y, z, flux * rms_inv, flag);
-					
-					// Recursively process neighbouring pixels
-					Stack *stack = Stack_new();
-					Stack_push(stack, index);
-					DataCube_process_stack(self, mask, stack, radius_x, radius_y, radius_z, label, lpar, rms_inv, pos_pix);
-					Stack_delete(stack);
-					
-					// Check if new source outside size (and other) requirements
-					if(LinkerPar_get_obj_size(lpar, label, 0) < min_size_x
-					|| LinkerPar_get_obj_size(lpar, label, 1) < min_size_y
-					|| LinkerPar_get_obj_size(lpar, label, 2) < min_size_z
-					|| (max_size_x && LinkerPar_get_obj_size(lpar, label, 0) > max_size_x)
-					|| (max_size_y && LinkerPar_get_obj_size(lpar, label, 1) > max_size_y)
-					|| (max_size_z && LinkerPar_get_obj_size(lpar, label, 2) > max_size_z)
-					|| LinkerPar_get_npix(lpar, label) < min_npix
-					|| (max_npix && LinkerPar_get_npix(lpar, label) > max_npix)
-					|| (min_fill > 0.0 && (double)LinkerPar_get_npix(lpar, label) / (double)(LinkerPar_get_obj_size(lpar, label, 0) * LinkerPar_get_obj_size(lpar, label, 1) * LinkerPar_get_obj_size(lpar, label, 2)) < min_fill)
-					|| (max_fill > 0.0 && (double)LinkerPar_get_npix(lpar, label) / (double)(LinkerPar_get_obj_size(lpar, label, 0) * LinkerPar_get_obj_size(lpar, label, 1) * LinkerPar_get_obj_size(lpar, label, 2)) > max_fill)
-					|| (pos_src && LinkerPar_get_flux(lpar, label) < 0.0))
-					{
-						// Yes, it is -> discard source
-						// Get source bounding box
-						size_t x_min, x_max, y_min, y_max, z_min, z_max;
-						LinkerPar_get_bbox(lpar, label, &x_min, &x_max, &y_min, &y_max, &z_min, &z_max);
-						
-						// Set all source pixels to 0 in mask
-						for(size_t zz = z_min; zz <= z_max; ++zz)
-						{
-							for(size_t yy = y_min; yy <= y_max; ++yy)
-							{
-								for(size_t xx = x_min; xx <= x_max; ++xx)
-								{
-									// Get index and mask value of pixel
-									int32_t *ptr2 = ptr_mask + DataCube_get_index(mask, xx, yy, zz);
-									if(*ptr2 == label) *ptr2 = 0;
-								}
-							}
-						}
-						
-						// Discard source entry
-						LinkerPar_pop(lpar);
-					}
-					else
-					{
-						// No it isn't -> retain source
-						// Set flags as necessary
-						size_t x_min, x_max, y_min, y_max, z_min, z_max;
-						LinkerPar_get_bbox(lpar, label, &x_min, &x_max, &y_min, &y_max, &z_min, &z_max);
-						if(x_min == 0 || x_max == max_x || y_min == 0 || y_max == max_y) LinkerPar_update_flag(lpar, flag |= 1);
-						if(z_min == 0 || z_max == max_z) LinkerPar_update_flag(lpar, flag |= 2);
-						
-						// Increment label
-						ensure(++label > 0, ERR_INT_OVERFLOW, "Too many sources for 32-bit signed integer mask.");
-					}
+					// Get index and mask value of pixel
+					int32_t *ptr2 = ptr_mask + DataCube_get_index(mask, xx, yy, zz);
+					if(*ptr2 == label) *ptr2 = 0;
 				}
 			}
 		}
+		
+		// Discard source entry
+		LinkerPar_pop(lpar);
+		return false;
 	}
 	
-	// Print information
-	LinkerPar_print_info(lpar);
+	// No it isn't -> retain source
+	// Set flags as necessary
+	size_t x_min, x_max, y_min, y_max, z_min, z_max;
+	LinkerPar_get_bbox(lpar, lpar_label, &x_min, &x_max, &y_min, &y_max, &z_min, &z_max);
+	if(x_min == 0 || x_max == max_x || y_min == 0 || y_max == max_y) LinkerPar_update_flag(lpar, flag |= 1);
+	if(z_min == 0 || z_max == max_z) LinkerPar_update_flag(lpar, flag |= 2);
 	
-	// Return LinkerPar object
-	return lpar;
+	return true;
+}
+
+
+
+/// @brief Merge pixel with its preceding neighbours
+///
+/// Private method for use by the parallel linker. All detected pixels
+/// within the merging radii of the pixel at `index` that have a lower
+/// index and lie in channels `z_min` to `z_max` will be merged with
+/// the pixel in the union-find structure `parent`. Detected pixels
+/// must be labelled as -(ID + 1) in the mask, where ID is the pixel's
+/// index in `parent`.
+///
+/// @param mask      32-bit mask cube.
+/// @param parent    Array of parent IDs of the union-find structure.
+/// @param index     Index of the pixel to be merged.
+/// @param radius_x  Merging radius in x.
+/// @param radius_y  Merging radius in y.
+/// @param radius_z  Merging radius in z.
+/// @param z_min     First channel to search for neighbours.
+/// @param z_max     Last channel to search for neighbours.
+
+PRIVATE void DataCube_linker_merge_neighbours(const DataCube *mask, uint32_t *parent, const size_t index, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t z_min, const size_t z_max)
+{
+	// Set up a few parameters
+	size_t x, y, z;
+	const size_t radius_x_squ   = radius_x * radius_x;
+	const size_t radius_y_squ   = radius_y * radius_y;
+	const size_t radius_z_squ   = radius_z * radius_z;
+	const size_t radius_xy_squ  = radius_x_squ * radius_y_squ;
+	const size_t radius_xz_squ  = radius_x_squ * radius_z_squ;
+	const size_t radius_yz_squ  = radius_y_squ * radius_z_squ;
+	const size_t radius_xyz_squ = radius_x_squ * radius_yz_squ;
+	const int32_t *ptr_mask = (int32_t *)(mask->data);
+	const uint32_t id = (uint32_t)(-((int64_t)(ptr_mask[index]) + 1));
+	DataCube_get_xyz(mask, index, &x, &y, &z);
+	
+	// Determine bounding box within which to search for neighbours
+	const size_t x1 = (x > radius_x) ? (x - radius_x) : 0;
+	const size_t y1 = (y > radius_y) ? (y - radius_y) : 0;
+	const size_t z1 = (z > radius_z + z_min) ? (z - radius_z) : z_min;
+	const size_t x2 = (x + radius_x + 1 < mask->axis_size[0]) ? (x + radius_x) : (mask->axis_size[0] - 1);
+	const size_t y2 = (y + radius_y + 1 < mask->axis_size[1]) ? (y + radius_y) : (mask->axis_size[1] - 1);
+	const size_t z2 = (z < z_max) ? z : z_max;
+	
+	// Loop over all preceding pixels in bounding box
+	for(size_t zz = z1; zz <= z2; ++zz)
+	{
+		const size_t dz_squ = (z - zz) * (z - zz) * radius_xy_squ;
+		const size_t y_end = (zz == z) ? y : y2;
+		
+		for(size_t yy = y1; yy <= y_end; ++yy)
+		{
+			const size_t dy_squ = yy > y ? (yy - y) * (yy - y) * radius_xz_squ : (y - yy) * (y - yy) * radius_xz_squ;
+			const size_t x_end = (zz == z && yy == y) ? x : x2 + 1;
+			
+			for(size_t xx = x1; xx < x_end; ++xx)
+			{
+				const size_t dx_squ = xx > x ? (xx - x) * (xx - x) * radius_yz_squ : (x - xx) * (x - xx) * radius_yz_squ;
+				
+				// Check merging radius, assuming ellipsoid (with dx^2 / rx^2 + dy^2 / ry^2 + dz^2 / rz^2 = 1)
+				if(dx_squ + dy_squ + dz_squ > radius_xyz_squ) continue;
+				
+				// Merge if detected
+				const int32_t value = ptr_mask[DataCube_get_index(mask, xx, yy, zz)];
+				if(value < 0) DataCube_linker_merge(parent, id, (uint32_t)(-((int64_t)value + 1)));
+			}
+		}
+	}
+	
+	return;
+}
+
+
+
+/// @brief Merge two components of union-find structure
+///
+/// Private method for merging the components containing the elements
+/// `a` and `b` of the union-find structure `parent`. The root with
+/// the higher ID will become the root of the merged component, such
+/// that the root of each component will always be its element with
+/// the highest ID. Paths are halved while searching for the roots.
+///
+/// @param parent  Array of parent IDs of the union-find structure.
+/// @param a       ID of first element.
+/// @param b       ID of second element.
+
+PRIVATE void DataCube_linker_merge(uint32_t *parent, uint32_t a, uint32_t b)
+{
+	// Find roots
+	while(parent[a] != a)
+	{
+		parent[a] = parent[parent[a]];
+		a = parent[a];
+	}
+	
+	while(parent[b] != b)
+	{
+		parent[b] = parent[parent[b]];
+		b = parent[b];
+	}
+	
+	// Attach lower root to higher one
+	if(a < b) parent[a] = b;
+	else if(b < a) parent[b] = a;
+	
+	return;
 }
 
 
@@ -4348,6 +6855,80 @@ PRIVATE void DataCube_process_stack(const DataCube *self, DataCube *mask, Stack
 
 
 
+/// @brief Create list of source voxels from mask
+///
+/// Public method for creating a list of the voxels belonging to each
+/// source label in the specified integer mask cube. The list is
+/// stored in compressed sparse row layout (see VoxelList), and the
+/// voxels of each label will be in ascending order of their index,
+/// i.e. in the same order in which a loop over `z`, `y` and `x`
+/// would encounter them. Pixels with a value of 0 or a negative
+/// value will not be included. Algorithms operating on individual
+/// sources can then visit just the voxels of each source instead
+/// of scanning its entire bounding box in the mask cube.
+///
+/// @param self  Object self-reference (integer mask cube).
+///
+/// @return Pointer to newly created VoxelList object.
+///
+/// @note The list will no longer be valid once the mask has been
+///       modified, e.g. by mask dilation or relabelling. It is the
+///       caller's responsibility to call the destructor on the
+///       returned object once it is no longer needed.
+
+PUBLIC VoxelList *DataCube_get_voxel_list(const DataCube *self)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(self->data);
+	ensure(self->data_type > 0, ERR_USER_INPUT, "Mask must be of integer type.");
+	
+	const size_t nx = self->axis_size[0];
+	long int *row = (long int *)memory(MALLOC, nx, sizeof(long int));
+	
+	// Determine highest label
+	size_t n_labels = 1;
+	for(size_t z = 0; z < self->axis_size[2]; ++z)
+	{
+		for(size_t y = 0; y < self->axis_size[1]; ++y)
+		{
+			DataCube_get_row_int(self, 0, nx - 1, y, z, row);
+			for(size_t x = 0; x < nx; ++x) if(row[x] > 0 && (size_t)(row[x]) >= n_labels) n_labels = row[x] + 1;
+		}
+	}
+	
+	// Count voxels per label
+	size_t *counts = (size_t *)memory(CALLOC, n_labels, sizeof(size_t));
+	for(size_t z = 0; z < self->axis_size[2]; ++z)
+	{
+		for(size_t y = 0; y < self->axis_size[1]; ++y)
+		{
+			DataCube_get_row_int(self, 0, nx - 1, y, z, row);
+			for(size_t x = 0; x < nx; ++x) if(row[x] > 0) ++counts[row[x]];
+		}
+	}
+	
+	// Fill voxel list
+	VoxelList *list = VoxelList_new(counts, n_labels);
+	for(size_t z = 0; z < self->axis_size[2]; ++z)
+	{
+		for(size_t y = 0; y < self->axis_size[1]; ++y)
+		{
+			DataCube_get_row_int(self, 0, nx - 1, y, z, row);
+			const size_t offset = DataCube_get_index(self, 0, y, z);
+			for(size_t x = 0; x < nx; ++x) if(row[x] > 0) VoxelList_push(list, row[x], offset + x);
+		}
+	}
+	
+	// Clean up
+	free(row);
+	free(counts);
+	
+	return list;
+}
+
+
+
 /// @brief Source parameterisation
 ///
 /// Public method for measuring advanced parameters of all sources
@@ -4364,6 +6945,9 @@ PRIVATE void DataCube_process_stack(const DataCube *self, DataCube *mask, Stack
 ///
 /// @param self      Object self-reference.
 /// @param mask      32-bit mask cube.
+/// @param voxels    List of source voxels as returned by
+///                  DataCube_get_voxel_list() for `mask`. If `NULL`,
+///                  the list will be created internally.
 /// @param cat       Catalogue of sources to be parameterised.
 /// @param use_wcs   If `true`, attempt to convert the position of
 ///                  the source to WCS.
@@ -4373,7 +6957,7 @@ PRIVATE void DataCube_process_stack(const DataCube *self, DataCube *mask, Stack
 /// @param prefix    Prefix to be used in source names. Defaults to
 ///                  `SoFiA` if set to `NULL`.
 
-PUBLIC void DataCube_parameterise(const DataCube *self, const DataCube *mask, Catalog *cat, bool use_wcs, bool physical, const char *prefix)
+PUBLIC void DataCube_parameterise(const DataCube *self, const DataCube *mask, const VoxelList *voxels, Catalog *cat, bool use_wcs, bool physical, const char *prefix)
 {
 	// Sanity checks
 	check_null(self);
@@ -4390,6 +6974,10 @@ PUBLIC void DataCube_parameterise(const DataCube *self, const DataCube *mask, Ca
 	ensure(cat_size, ERR_USER_INPUT, "No sources in catalogue; nothing to parameterise.");
 	message("Found %zu source%s in need of parameterisation.", cat_size, (cat_size > 1 ? "s" : ""));
 	
+	// Create list of source voxels unless provided
+	VoxelList *voxels_own = (voxels == NULL) ? DataCube_get_voxel_list(mask) : NULL;
+	const VoxelList *voxel_list = (voxels == NULL) ? voxels_own : voxels;
+	
 	// Relevant header information
 	String *unit_flux_dens = NULL;
 	String *unit_flux = NULL;
@@ -4414,7 +7002,8 @@ PUBLIC void DataCube_parameterise(const DataCube *self, const DataCube *mask, Ca
 	String_append(label_lat_peak,  "_peak");
 	String_append(label_spec_peak, "_peak");
 	
-	// Extract WCS object if requested
+	// Check if valid WCS information is available if requested
+	// (each thread will work on its own copy further down)
 	WCS *wcs = NULL;
 	use_wcs = use_wcs ? (wcs = DataCube_extract_wcs(self)) != NULL : use_wcs;
 	
@@ -4422,342 +7011,382 @@ PUBLIC void DataCube_parameterise(const DataCube *self, const DataCube *mask, Ca
 	// (only supported if BUNIT is Jy/beam)
 	if((physical = physical ? String_compare(unit_flux_dens, "Jy/beam") : physical)) message("Attempting to measure parameters in physical units.");
 	
-	// Create string holding source name
-	String *source_name = String_new("");
+	// Number of sources processed so far (for progress bar)
+	size_t n_done = 0;
 	
 	// Loop over all sources in catalogue
-	for(size_t i = 0; i < cat_size; ++i)
+	// NOTE: Sources are independent of each other and are processed in parallel.
+	//       Each thread needs its own WCS object, as the wcslib structures used
+	//       in coordinate conversion must not be shared between threads. The
+	//       catalogue order is not affected, as each source is updated in place.
+	#pragma omp parallel
 	{
-		// Extract source
-		Source *src = Catalog_get_source(cat, i);
-		
-		// Extract source ID
-		const size_t src_id = Source_get_par_by_name_int(src, "id");
-		ensure(src_id, ERR_USER_INPUT, "Source ID missing from catalogue; cannot parameterise.");
-		progress_bar("Progress: ", i + 1, cat_size);
-		
-		// Extract number of detected pixels
-		const size_t n_pix = Source_get_par_by_name_int(src, "n_pix");
-		
-		// Extract source bounding box
-		const size_t x_min = Source_get_par_by_name_int(src, "x_min");
-		const size_t x_max = Source_get_par_by_name_int(src, "x_max");
-		const size_t y_min = Source_get_par_by_name_int(src, "y_min");
-		const size_t y_max = Source_get_par_by_name_int(src, "y_max");
-		const size_t z_min = Source_get_par_by_name_int(src, "z_min");
-		const size_t z_max = Source_get_par_by_name_int(src, "z_max");
-		ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_INDEX_RANGE, "Illegal source bounding box: min > max!");
-		ensure(x_max < self->axis_size[0] && y_max < self->axis_size[1] && z_max < self->axis_size[2], ERR_INDEX_RANGE, "Source bounding box outside data cube boundaries.");
+		// Create string holding source name
+		String *source_name = String_new("");
 		
-		const size_t nx = x_max - x_min + 1;
-		const size_t ny = y_max - y_min + 1;
-		const size_t nz = z_max - z_min + 1;
+		// Create thread-local WCS object
+		WCS *wcs_local = use_wcs ? WCS_copy(wcs) : NULL;
 		
-		// Check if source has negative flux
-		const bool is_negative = (Source_get_par_by_name_flt(src, "f_sum") < 0.0);
-		
-		// Initialise source parameters
-		double rms = 0.0;
-		double pos_x = 0.0;
-		double pos_y = 0.0;
-		double pos_z = 0.0;
-		size_t pos_x_peak = 0.0;
-		size_t pos_y_peak = 0.0;
-		size_t pos_z_peak = 0.0;
-		double f_sum = 0.0;
-		double f_min = INFINITY;
-		double f_max = -INFINITY;
-		double w50 = 0.0;
-		double w20 = 0.0;
-		double wm50 = 0.0;
-		double err_x = 0.0;
-		double err_y = 0.0;
-		double err_z = 0.0;
-		double err_f_sum = 0.0;
-		double longitude = 0.0;
-		double latitude = 0.0;
-		double spectral = 0.0;
-		double longitude_peak = 0.0;
-		double latitude_peak = 0.0;
-		double spectral_peak = 0.0;
-		double ell_maj = 0.0;
-		double ell_min = 0.0;
-		double ell_pa = 0.0;
-		double ell3s_maj = 0.0;
-		double ell3s_min = 0.0;
-		double ell3s_pa = 0.0;
-		double kin_pa = 0.0;
-		
-		// Auxiliary parameters and storage
-		double *kpa_cenX = (double *)memory(MALLOC, nz, sizeof(double));
-		double *kpa_cenY = (double *)memory(MALLOC, nz, sizeof(double));
-		double *kpa_sum  = (double *)memory(MALLOC, nz, sizeof(double));
-		size_t kpa_first = z_max - z_min;
-		size_t kpa_last  = 0;
-		size_t kpa_counter = 0;
-		
-		Array_dbl *array_rms = Array_dbl_new(0);
-		double *spectrum   = (double *)memory(CALLOC, nz, sizeof(double));
-		double *moment_map = (double *)memory(CALLOC, nx * ny,   sizeof(double));
-		size_t *count_map  = (size_t *)memory(CALLOC, nx * ny,   sizeof(size_t));
-		
-		double sum_pos = 0.0;
-		
-		// First pass
-		for(size_t z = z_min; z <= z_max; ++z)
+		#pragma omp for schedule(dynamic)
+		for(size_t i = 0; i < cat_size; ++i)
 		{
-			for(size_t y = y_min; y <= y_max; ++y)
+			// Extract source
+			Source *src = Catalog_get_source(cat, i);
+			
+			// Extract source ID
+			const size_t src_id = Source_get_par_by_name_int(src, "id");
+			ensure(src_id, ERR_USER_INPUT, "Source ID missing from catalogue; cannot parameterise.");
+			#pragma omp critical
+			progress_bar("Progress: ", ++n_done, cat_size);
+			
+			// Extract number of detected pixels
+			const size_t n_pix = Source_get_par_by_name_int(src, "n_pix");
+			
+			// Extract source bounding box
+			const size_t x_min = Source_get_par_by_name_int(src, "x_min");
+			const size_t x_max = Source_get_par_by_name_int(src, "x_max");
+			const size_t y_min = Source_get_par_by_name_int(src, "y_min");
+			const size_t y_max = Source_get_par_by_name_int(src, "y_max");
+			const size_t z_min = Source_get_par_by_name_int(src, "z_min");
+			const size_t z_max = Source_get_par_by_name_int(src, "z_max");
+			ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_INDEX_RANGE, "Illegal source bounding box: min > max!");
+			ensure(x_max < self->axis_size[0] && y_max < self->axis_size[1] && z_max < self->axis_size[2], ERR_INDEX_RANGE, "Source bounding box outside data cube boundaries.");
+			
+			const size_t nx = x_max - x_min + 1;
+			const size_t ny = y_max - y_min + 1;
+			const size_t nz = z_max - z_min + 1;
+			
+			// Check if source has negative flux
+			const bool is_negative = (Source_get_par_by_name_flt(src, "f_sum") < 0.0);
+			
+			// Initialise source parameters
+			double rms = 0.0;
+			double pos_x = 0.0;
+			double pos_y = 0.0;
+			double pos_z = 0.0;
+			size_t pos_x_peak = 0.0;
+			size_t pos_y_peak = 0.0;
+			size_t pos_z_peak = 0.0;
+			double f_sum = 0.0;
+			double f_min = INFINITY;
+			double f_max = -INFINITY;
+			double w50 = 0.0;
+			double w20 = 0.0;
+			double wm50 = 0.0;
+			double err_x = 0.0;
+			double err_y = 0.0;
+			double err_z = 0.0;
+			double err_f_sum = 0.0;
+			double longitude = 0.0;
+			double latitude = 0.0;
+			double spectral = 0.0;
+			double longitude_peak = 0.0;
+			double latitude_peak = 0.0;
+			double spectral_peak = 0.0;
+			double ell_maj = 0.0;
+			double ell_min = 0.0;
+			double ell_pa = 0.0;
+			double ell3s_maj = 0.0;
+			double ell3s_min = 0.0;
+			double ell3s_pa = 0.0;
+			double kin_pa = 0.0;
+			
+			// Auxiliary parameters and storage
+			double *kpa_cenX = (double *)memory(MALLOC, nz, sizeof(double));
+			double *kpa_cenY = (double *)memory(MALLOC, nz, sizeof(double));
+			double *kpa_sum  = (double *)memory(MALLOC, nz, sizeof(double));
+			size_t kpa_first = z_max - z_min;
+			size_t kpa_last  = 0;
+			size_t kpa_counter = 0;
+			
+			Array_dbl *array_rms = Array_dbl_new(0);
+			double *spectrum   = (double *)memory(CALLOC, nz, sizeof(double));
+			double *moment_map = (double *)memory(CALLOC, nx * ny,   sizeof(double));
+			size_t *count_map  = (size_t *)memory(CALLOC, nx * ny,   sizeof(size_t));
+			double *row_data   = (double *)memory(MALLOC, nx, sizeof(double));
+			long int *row_mask = (long int *)memory(MALLOC, nx, sizeof(long int));
+			
+			double sum_pos = 0.0;
+			
+			// First pass
+			for(size_t z = z_min; z <= z_max; ++z)
 			{
-				for(size_t x = x_min; x <= x_max; ++x)
+				for(size_t y = y_min; y <= y_max; ++y)
 				{
-					const size_t id    = DataCube_get_data_int(mask, x, y, z);
-					const double value = is_negative ? -DataCube_get_data_flt(self, x, y, z) : DataCube_get_data_flt(self, x, y, z);
+					DataCube_get_row_int(mask, x_min, x_max, y, z, row_mask);
+					DataCube_get_row_flt(self, x_min, x_max, y, z, row_data);
 					
-					if(id == src_id)
+					for(size_t x = x_min; x <= x_max; ++x)
 					{
-						// ALL PIXELS
-						// Flux
-						f_sum += value;
-						if(f_min > value) f_min = value;
-						if(f_max < value) f_max = value;
+						const size_t id    = row_mask[x - x_min];
+						const double value = is_negative ? -row_data[x - x_min] : row_data[x - x_min];
 						
-						// Moment map for ellipse fitting and peak position
-						moment_map[x - x_min + nx * (y - y_min)] += value;
-						count_map [x - x_min + nx * (y - y_min)] += 1;
-						
-						// Spectrum for line width
-						spectrum[z - z_min] += value;
-						
-						// POSITIVE PIXELS ONLY
-						if(value > 0.0)
+						if(id == src_id)
+						{
+							// ALL PIXELS
+							// Flux
+							f_sum += value;
+							if(f_min > value) f_min = value;
+							if(f_max < value) f_max = value;
+							
+							// Moment map for ellipse fitting and peak position
+							moment_map[x - x_min + nx * (y - y_min)] += value;
+							count_map [x - x_min + nx * (y - y_min)] += 1;
+							
+							// Spectrum for line width
+							spectrum[z - z_min] += value;
+							
+							// POSITIVE PIXELS ONLY
+							if(value > 0.0)
+							{
+								// Centroid position
+								pos_x += value * x;
+								pos_y += value * y;
+								pos_z += value * z;
+								sum_pos += value;
+							}
+						}
+						else if(id == 0)
 						{
-							// Centroid position
-							pos_x += value * x;
-							pos_y += value * y;
-							pos_z += value * z;
-							sum_pos += value;
+							// Retain non-source pixels for RMS measurement
+							Array_dbl_push(array_rms, value);
 						}
 					}
-					else if(id == 0)
+				}
+			}
+			
+			// Finalise centroid
+			pos_x /= sum_pos;
+			pos_y /= sum_pos;
+			pos_z /= sum_pos;
+			
+			// Measure position of peak in moment map and spectrum
+			double value_peak = 0.0;
+			for(size_t y = 0; y < ny; ++y)
+			{
+				for(size_t x = 0; x < nx; ++x)
+				{
+					if(moment_map[x + nx * y] > value_peak)
 					{
-						// Retain non-source pixels for RMS measurement
-						Array_dbl_push(array_rms, value);
+						value_peak = moment_map[x + nx * y];
+						pos_x_peak = x + x_min;
+						pos_y_peak = y + y_min;
 					}
 				}
 			}
-		}
-		
-		// Finalise centroid
-		pos_x /= sum_pos;
-		pos_y /= sum_pos;
-		pos_z /= sum_pos;
-		
-		// Measure position of peak in moment map and spectrum
-		double value_peak = 0.0;
-		for(size_t y = 0; y < ny; ++y)
-		{
-			for(size_t x = 0; x < nx; ++x)
+			
+			value_peak = 0.0;
+			for(size_t z = 0; z < nz; ++z)
+			{
+				if(spectrum[z] > value_peak)
+				{
+					value_peak = spectrum[z];
+					pos_z_peak = z + z_min;
+				}
+			}
+			
+			// Measure local RMS
+			if(Array_dbl_get_size(array_rms)) rms = MAD_TO_STD * mad_val_dbl(Array_dbl_get_ptr(array_rms), Array_dbl_get_size(array_rms), 0.0, 1, 0);
+			else warning_verb(self->verbosity, "Failed to measure local noise level for source %zu.", src_id);
+			
+			// Second pass
+			// (for parameters dependent on first-pass output)
+			// Only source pixels contribute, so iterate over the voxel list
+			// rather than the bounding box. Voxels are in ascending order of
+			// their index, so the order of summation remains the same.
+			for(size_t z = 0; z < nz; ++z)
+			{
+				kpa_cenX[z] = 0.0;
+				kpa_cenY[z] = 0.0;
+				kpa_sum[z] = 0.0;
+			}
+			
+			const size_t *voxels_src = VoxelList_get_voxels(voxel_list, src_id);
+			const size_t n_voxels = VoxelList_get_size(voxel_list, src_id);
+			
+			for(size_t k = 0; k < n_voxels; ++k)
+			{
+				size_t x, y, z;
+				DataCube_get_xyz(self, voxels_src[k], &x, &y, &z);
+				const double value_raw = (self->data_type == -32) ? *((float *)(self->data) + voxels_src[k]) : *((double *)(self->data) + voxels_src[k]);
+				const double value = is_negative ? -value_raw : value_raw;
+				
+				// POSITIVE PIXELS
+				if(value > 0.0)
+				{
+					err_x += ((double)x - pos_x) * ((double)x - pos_x);
+					err_y += ((double)y - pos_y) * ((double)y - pos_y);
+					err_z += ((double)z - pos_z) * ((double)z - pos_z);
+				}
+				
+				// PIXELS > 3 SIGMA
+				if(value > 3.0 * rms)
+				{
+					// Centroids for kinematic major axis
+					kpa_cenX[z - z_min] += value * (double)x;
+					kpa_cenY[z - z_min] += value * (double)y;
+					kpa_sum [z - z_min] += value;
+				}
+			}
+			
+			for(size_t z = z_min; z <= z_max; ++z)
+			{
+				// Determine centroid in each channel
+				if(kpa_sum[z - z_min] > 0.0)
+				{
+					kpa_cenX[z - z_min] /= kpa_sum[z - z_min];
+					kpa_cenY[z - z_min] /= kpa_sum[z - z_min];
+					++kpa_counter;
+					
+					if(kpa_first > z - z_min) kpa_first = z - z_min;
+					if(kpa_last  < z - z_min) kpa_last  = z - z_min;
+				}
+			}
+			
+			// Measure kinematic major axis
+			if(kpa_counter < 2)
+			{
+				warning_verb(self->verbosity, "Failed to determine kinematic major axis for source %zu.\n         Emission is too faint.", i);
+				kin_pa = -1.0;
+			}
+			else
+			{
+				if(kpa_counter == 2) warning_verb(self->verbosity, "Kinematic major axis for source %zu based on just 2 data points.", i);
+				kin_pa = kin_maj_axis_dbl(kpa_cenX, kpa_cenY, kpa_sum, nz, kpa_first, kpa_last);
+			}
+			
+			// Ellipse fit to moment-0 map
+			moment_ellipse_fit_dbl(moment_map, count_map, nx, ny, pos_x - x_min, pos_y - y_min, rms, &ell_maj, &ell_min, &ell_pa, &ell3s_maj, &ell3s_min, &ell3s_pa);
+			
+			// Determine w20 and w50 from spectrum (moving inwards)
+			spectral_line_width_dbl(spectrum, nz, &w20, &w50);
+			
+			// Determine wm50
+			wm50 = wm50_line_width_dbl(spectrum, nz);
+			
+			// Determine uncertainties
+			err_x = sqrt(err_x) * rms / sum_pos;
+			err_y = sqrt(err_y) * rms / sum_pos;
+			err_z = sqrt(err_z) * rms / sum_pos;
+			err_f_sum = rms * sqrt(n_pix);
+			
+			// Carry out WCS conversion if requested
+			if(use_wcs)
+			{
+				// Convert centroid and peak position in one go
+				const double coord_pixel[6] = {pos_x, pos_y, pos_z, (double)pos_x_peak, (double)pos_y_peak, (double)pos_z_peak};
+				double coord_world[6] = {longitude, latitude, spectral, longitude_peak, latitude_peak, spectral_peak};
+				WCS_convertToWorld_batch(wcs_local, coord_pixel, coord_world, 2);
+				longitude      = coord_world[0];
+				latitude       = coord_world[1];
+				spectral       = coord_world[2];
+				longitude_peak = coord_world[3];
+				latitude_peak  = coord_world[4];
+				spectral_peak  = coord_world[5];
+				DataCube_create_src_name(self, &source_name, prefix, longitude, latitude, label_lon);
+			}
+			else
+			{
+				String_set(source_name, prefix ? prefix : "SoFiA");
+				String_append_int(source_name, "-%04zu", src_id);
+			}
+			
+			// Invert flux-related parameters of negative sources
+			if(is_negative)
+			{
+				swap(&f_min, &f_max);
+				f_min = -f_min;
+				f_max = -f_max;
+				f_sum = -f_sum;
+			}
+			
+			// Update catalogue entries
+			Source_set_identifier(src, String_get(source_name));
+			Source_set_par_flt(src, "x",      pos_x,      "pix",                      "pos.cartesian.x");
+			Source_set_par_flt(src, "y",      pos_y,      "pix",                      "pos.cartesian.y");
+			Source_set_par_flt(src, "z",      pos_z,      "pix",                      "pos.cartesian.z");
+			Source_set_par_flt(src, "rms",    rms,        String_get(unit_flux_dens), "instr.det.noise");
+			Source_set_par_flt(src, "f_min",  f_min,      String_get(unit_flux_dens), "phot.flux.density;stat.min");
+			Source_set_par_flt(src, "f_max",  f_max,      String_get(unit_flux_dens), "phot.flux.density;stat.max");
+			
+			if(physical)
 			{
-				if(moment_map[x + nx * y] > value_peak)
-				{
-					value_peak = moment_map[x + nx * y];
-					pos_x_peak = x + x_min;
-					pos_y_peak = y + y_min;
-				}
+				Source_set_par_flt(src, "f_sum", f_sum * chan_size / beam_area, String_get(unit_flux), "phot.flux");
+				Source_set_par_flt(src, "w20",   w20 * chan_size,               String_get(unit_spec), "spect.line.width");
+				Source_set_par_flt(src, "w50",   w50 * chan_size,               String_get(unit_spec), "spect.line.width");
+				Source_set_par_flt(src, "wm50",  wm50 * chan_size,              String_get(unit_spec), "spect.line.width");
 			}
-		}
-		
-		value_peak = 0.0;
-		for(size_t z = 0; z < nz; ++z)
-		{
-			if(spectrum[z] > value_peak)
+			else
 			{
-				value_peak = spectrum[z];
-				pos_z_peak = z + z_min;
+				Source_set_par_flt(src, "f_sum", f_sum, String_get(unit_flux_dens), "phot.flux");
+				Source_set_par_flt(src, "w20",   w20,   "pix",                      "spect.line.width");
+				Source_set_par_flt(src, "w50",   w50,   "pix",                      "spect.line.width");
+				Source_set_par_flt(src, "wm50",  wm50,  "pix",                      "spect.line.width");
 			}
-		}
-		
-		// Measure local RMS
-		if(Array_dbl_get_size(array_rms)) rms = MAD_TO_STD * mad_val_dbl(Array_dbl_get_ptr(array_rms), Array_dbl_get_size(array_rms), 0.0, 1, 0);
-		else warning_verb(self->verbosity, "Failed to measure local noise level for source %zu.", src_id);
-		
-		// Second pass
-		// (for parameters dependent on first-pass output)
-		for(size_t z = z_min; z <= z_max; ++z)
-		{
-			kpa_cenX[z - z_min] = 0.0;
-			kpa_cenY[z - z_min] = 0.0;
-			kpa_sum[z - z_min] = 0.0;
 			
-			for(size_t y = y_min; y <= y_max; ++y)
+			Source_set_par_flt(src, "ell_maj",   ell_maj,   "pix", "phys.angSize");
+			Source_set_par_flt(src, "ell_min",   ell_min,   "pix", "phys.angSize");
+			Source_set_par_flt(src, "ell_pa",    ell_pa,    "deg", "pos.posAng");
+			Source_set_par_flt(src, "ell3s_maj", ell3s_maj, "pix", "phys.angSize");
+			Source_set_par_flt(src, "ell3s_min", ell3s_min, "pix", "phys.angSize");
+			Source_set_par_flt(src, "ell3s_pa",  ell3s_pa,  "deg", "pos.posAng");
+			Source_set_par_flt(src, "kin_pa",    kin_pa,    "deg", "pos.posAng");
+			
+			if(physical)
 			{
-				for(size_t x = x_min; x <= x_max; ++x)
-				{
-					const size_t id    = DataCube_get_data_int(mask, x, y, z);
-					const double value = is_negative ? -DataCube_get_data_flt(self, x, y, z) : DataCube_get_data_flt(self, x, y, z);
-					
-					if(id == src_id)
-					{
-						// POSITIVE PIXELS
-						if(value > 0.0)
-						{
-							err_x += ((double)x - pos_x) * ((double)x - pos_x);
-							err_y += ((double)y - pos_y) * ((double)y - pos_y);
-							err_z += ((double)z - pos_z) * ((double)z - pos_z);
-						}
-						
-						// PIXELS > 3 SIGMA
-						if(value > 3.0 * rms)
-						{
-							// Centroids for kinematic major axis
-							kpa_cenX[z - z_min] += value * (double)x;
-							kpa_cenY[z - z_min] += value * (double)y;
-							kpa_sum [z - z_min] += value;
-						}
-					}
-				}
+				Source_set_par_flt(src, "err_x",     err_x * sqrt(beam_area),                 "pix",                 "stat.error;pos.cartesian.x");
+				Source_set_par_flt(src, "err_y",     err_y * sqrt(beam_area),                 "pix",                 "stat.error;pos.cartesian.y");
+				Source_set_par_flt(src, "err_z",     err_z * sqrt(beam_area),                 "pix",                 "stat.error;pos.cartesian.z");
+				Source_set_par_flt(src, "err_f_sum", err_f_sum * chan_size / sqrt(beam_area), String_get(unit_flux), "stat.error;phot.flux");
+			}
+			else
+			{
+				Source_set_par_flt(src, "err_x",     err_x,     "pix",                      "stat.error;pos.cartesian.x");
+				Source_set_par_flt(src, "err_y",     err_y,     "pix",                      "stat.error;pos.cartesian.y");
+				Source_set_par_flt(src, "err_z",     err_z,     "pix",                      "stat.error;pos.cartesian.z");
+				Source_set_par_flt(src, "err_f_sum", err_f_sum, String_get(unit_flux_dens), "stat.error;phot.flux");
 			}
 			
-			// Determine centroid in each channel
-			if(kpa_sum[z - z_min] > 0.0)
+			if(use_wcs)
 			{
-				kpa_cenX[z - z_min] /= kpa_sum[z - z_min];
-				kpa_cenY[z - z_min] /= kpa_sum[z - z_min];
-				++kpa_counter;
-				
-				if(kpa_first > z - z_min) kpa_first = z - z_min;
-				if(kpa_last  < z - z_min) kpa_last  = z - z_min;
+				// Centroid
+				Source_set_par_flt(src, String_get(label_lon),  longitude, String_get(unit_lon),  String_get(ucd_lon));
+				Source_set_par_flt(src, String_get(label_lat),  latitude,  String_get(unit_lat),  String_get(ucd_lat));
+				Source_set_par_flt(src, String_get(label_spec), spectral,  String_get(unit_spec), String_get(ucd_spec));
 			}
+			
+			Source_set_par_int(src, "x_peak", pos_x_peak, "pix", "pos.cartesian.x");
+			Source_set_par_int(src, "y_peak", pos_y_peak, "pix", "pos.cartesian.y");
+			Source_set_par_int(src, "z_peak", pos_z_peak, "pix", "pos.cartesian.z");
+			
+			if(use_wcs)
+			{
+				// Peak
+				Source_set_par_flt(src, String_get(label_lon_peak),  longitude_peak, String_get(unit_lon),  String_get(ucd_lon));
+				Source_set_par_flt(src, String_get(label_lat_peak),  latitude_peak,  String_get(unit_lat),  String_get(ucd_lat));
+				Source_set_par_flt(src, String_get(label_spec_peak), spectral_peak,  String_get(unit_spec), String_get(ucd_spec));
+			}
+			
+			// Clean up (per source)
+			Array_dbl_delete(array_rms);
+			free(spectrum);
+			free(moment_map);
+			free(count_map);
+			free(row_data);
+			free(row_mask);
+			
+			free(kpa_cenX);
+			free(kpa_cenY);
+			free(kpa_sum);
 		}
 		
-		// Measure kinematic major axis
-		if(kpa_counter < 2)
-		{
-			warning_verb(self->verbosity, "Failed to determine kinematic major axis for source %zu.\n         Emission is too faint.", i);
-			kin_pa = -1.0;
-		}
-		else
-		{
-			if(kpa_counter == 2) warning_verb(self->verbosity, "Kinematic major axis for source %zu based on just 2 data points.", i);
-			kin_pa = kin_maj_axis_dbl(kpa_cenX, kpa_cenY, kpa_sum, nz, kpa_first, kpa_last);
-		}
-		
-		// Ellipse fit to moment-0 map
-		moment_ellipse_fit_dbl(moment_map, count_map, nx, ny, pos_x - x_min, pos_y - y_min, rms, &ell_maj, &ell_min, &ell_pa, &ell3s_maj, &ell3s_min, &ell3s_pa);
-		
-		// Determine w20 and w50 from spectrum (moving inwards)
-		spectral_line_width_dbl(spectrum, nz, &w20, &w50);
-		
-		// Determine wm50
-		wm50 = wm50_line_width_dbl(spectrum, nz);
-		
-		// Determine uncertainties
-		err_x = sqrt(err_x) * rms / sum_pos;
-		err_y = sqrt(err_y) * rms / sum_pos;
-		err_z = sqrt(err_z) * rms / sum_pos;
-		err_f_sum = rms * sqrt(n_pix);
-		
-		// Carry out WCS conversion if requested
-		if(use_wcs)
-		{
-			WCS_convertToWorld(wcs, pos_x, pos_y, pos_z, &longitude, &latitude, &spectral);
-			WCS_convertToWorld(wcs, (double)pos_x_peak, (double)pos_y_peak, (double)pos_z_peak, &longitude_peak, &latitude_peak, &spectral_peak);
-			DataCube_create_src_name(self, &source_name, prefix, longitude, latitude, label_lon);
-		}
-		else
-		{
-			String_set(source_name, prefix ? prefix : "SoFiA");
-			String_append_int(source_name, "-%04zu", src_id);
-		}
-		
-		// Invert flux-related parameters of negative sources
-		if(is_negative)
-		{
-			swap(&f_min, &f_max);
-			f_min = -f_min;
-			f_max = -f_max;
-			f_sum = -f_sum;
-		}
-		
-		// Update catalogue entries
-		Source_set_identifier(src, String_get(source_name));
-		Source_set_par_flt(src, "x",      pos_x,      "pix",                      "pos.cartesian.x");
-		Source_set_par_flt(src, "y",      pos_y,      "pix",                      "pos.cartesian.y");
-		Source_set_par_flt(src, "z",      pos_z,      "pix",                      "pos.cartesian.z");
-		Source_set_par_flt(src, "rms",    rms,        String_get(unit_flux_dens), "instr.det.noise");
-		Source_set_par_flt(src, "f_min",  f_min,      String_get(unit_flux_dens), "phot.flux.density;stat.min");
-		Source_set_par_flt(src, "f_max",  f_max,      String_get(unit_flux_dens), "phot.flux.density;stat.max");
-		
-		if(physical)
-		{
-			Source_set_par_flt(src, "f_sum", f_sum * chan_size / beam_area, String_get(unit_flux), "phot.flux");
-			Source_set_par_flt(src, "w20",   w20 * chan_size,               String_get(unit_spec), "spect.line.width");
-			Source_set_par_flt(src, "w50",   w50 * chan_size,               String_get(unit_spec), "spect.line.width");
-			Source_set_par_flt(src, "wm50",  wm50 * chan_size,              String_get(unit_spec), "spect.line.width");
-		}
-		else
-		{
-			Source_set_par_flt(src, "f_sum", f_sum, String_get(unit_flux_dens), "phot.flux");
-			Source_set_par_flt(src, "w20",   w20,   "pix",                      "spect.line.width");
-			Source_set_par_flt(src, "w50",   w50,   "pix",                      "spect.line.width");
-			Source_set_par_flt(src, "wm50",  wm50,  "pix",                      "spect.line.width");
-		}
-		
-		Source_set_par_flt(src, "ell_maj",   ell_maj,   "pix", "phys.angSize");
-		Source_set_par_flt(src, "ell_min",   ell_min,   "pix", "phys.angSize");
-		Source_set_par_flt(src, "ell_pa",    ell_pa,    "deg", "pos.posAng");
-		Source_set_par_flt(src, "ell3s_maj", ell3s_maj, "pix", "phys.angSize");
-		Source_set_par_flt(src, "ell3s_min", ell3s_min, "pix", "phys.angSize");
-		Source_set_par_flt(src, "ell3s_pa",  ell3s_pa,  "deg", "pos.posAng");
-		Source_set_par_flt(src, "kin_pa",    kin_pa,    "deg", "pos.posAng");
-		
-		if(physical)
-		{
-			Source_set_par_flt(src, "err_x",     err_x * sqrt(beam_area),                 "pix",                 "stat.error;pos.cartesian.x");
-			Source_set_par_flt(src, "err_y",     err_y * sqrt(beam_area),                 "pix",                 "stat.error;pos.cartesian.y");
-			Source_set_par_flt(src, "err_z",     err_z * sqrt(beam_area),                 "pix",                 "stat.error;pos.cartesian.z");
-			Source_set_par_flt(src, "err_f_sum", err_f_sum * chan_size / sqrt(beam_area), String_get(unit_flux), "stat.error;phot.flux");
-		}
-		else
-		{
-			Source_set_par_flt(src, "err_x",     err_x,     "pix",                      "stat.error;pos.cartesian.x");
-			Source_set_par_flt(src, "err_y",     err_y,     "pix",                      "stat.error;pos.cartesian.y");
-			Source_set_par_flt(src, "err_z",     err_z,     "pix",                      "stat.error;pos.cartesian.z");
-			Source_set_par_flt(src, "err_f_sum", err_f_sum, String_get(unit_flux_dens), "stat.error;phot.flux");
-		}
-		
-		if(use_wcs)
-		{
-			// Centroid
-			Source_set_par_flt(src, String_get(label_lon),  longitude, String_get(unit_lon),  String_get(ucd_lon));
-			Source_set_par_flt(src, String_get(label_lat),  latitude,  String_get(unit_lat),  String_get(ucd_lat));
-			Source_set_par_flt(src, String_get(label_spec), spectral,  String_get(unit_spec), String_get(ucd_spec));
-		}
-		
-		Source_set_par_int(src, "x_peak", pos_x_peak, "pix", "pos.cartesian.x");
-		Source_set_par_int(src, "y_peak", pos_y_peak, "pix", "pos.cartesian.y");
-		Source_set_par_int(src, "z_peak", pos_z_peak, "pix", "pos.cartesian.z");
-		
-		if(use_wcs)
-		{
-			// Peak
-			Source_set_par_flt(src, String_get(label_lon_peak),  longitude_peak, String_get(unit_lon),  String_get(ucd_lon));
-			Source_set_par_flt(src, String_get(label_lat_peak),  latitude_peak,  String_get(unit_lat),  String_get(ucd_lat));
-			Source_set_par_flt(src, String_get(label_spec_peak), spectral_peak,  String_get(unit_spec), String_get(ucd_spec));
-		}
-		
-		// Clean up (per source)
-		Array_dbl_delete(array_rms);
-		free(spectrum);
-		free(moment_map);
-		free(count_map);
-		
-		free(kpa_cenX);
-		free(kpa_cenY);
-		free(kpa_sum);
+		// Clean up (per thread)
+		String_delete(source_name);
+		WCS_delete(wcs_local);
 	}
 	
 	// Clean up (globally)
+	VoxelList_delete(voxels_own);
 	WCS_delete(wcs);
 	String_delete(unit_flux_dens);
 	String_delete(unit_flux);
@@ -4773,7 +7402,6 @@ PUBLIC void DataCube_parameterise(const DataCube *self, const DataCube *mask, Ca
 	String_delete(ucd_lon);
 	String_delete(ucd_lat);
 	String_delete(ucd_spec);
-	String_delete(source_name);
 	
 	return;
 }
@@ -4917,6 +7545,43 @@ PRIVATE void DataCube_get_wcs_info(const DataCube *self, String **unit_flux_dens
 
 
 
+/// @brief Convert range of channels to spectral coordinates
+///
+/// Private function for converting `n` consecutive channels, starting
+/// with channel `z_min`, to spectral world coordinates in a single call
+/// to wcslib. The result will be written to the array `spectral`, which
+/// must be of size `n`. Channels that fail to convert will leave the
+/// corresponding array elements unchanged.
+///
+/// @param wcs       WCS object to be used for the conversion. Must be
+///                  valid.
+/// @param z_min     First channel to be converted.
+/// @param n         Number of channels to be converted.
+/// @param spectral  Array of size `n` for holding the spectral
+///                  coordinates.
+
+PRIVATE void DataCube_spectral_coordinates(const WCS *wcs, const size_t z_min, const size_t n, double *spectral)
+{
+	double *coord_pixel = (double *)memory(CALLOC, 3 * n, sizeof(double));
+	double *coord_world = (double *)memory(CALLOC, 3 * n, sizeof(double));
+	
+	for(size_t j = 0; j < n; ++j)
+	{
+		coord_pixel[3 * j + 2] = (double)(z_min + j);
+		coord_world[3 * j + 2] = spectral[j];
+	}
+	
+	WCS_convertToWorld_batch(wcs, coord_pixel, coord_world, n);
+	for(size_t j = 0; j < n; ++j) spectral[j] = coord_world[3 * j + 2];
+	
+	free(coord_pixel);
+	free(coord_world);
+	
+	return;
+}
+
+
+
 /// @brief Generate source name from WCS information
 ///
 /// Private method for generating a source name based on the
@@ -5020,6 +7685,10 @@ PRIVATE void DataCube_create_src_name(const DataCube *self, String **source_name
 /// moment maps. This can be useful to prevent large negative signals
 /// from affecting the moment calculation.
 ///
+/// All maps, including the optional 2-D projection of the mask, are
+/// generated in a single pass through the data and mask cube, with
+/// multiple threads working on separate rows of the output maps.
+///
 /// @param  self       Object self-reference.
 /// @param  mask       32-bit mask cube.
 /// @param  mom0       Pointer to a data cube object that will be
@@ -5036,6 +7705,10 @@ PRIVATE void DataCube_create_src_name(const DataCube *self, String **source_name
 ///                    pointing to the generated map containing the
 ///                    signal-to-noise ratio (SNR) per pixel in the
 ///                    moment 0 map.
+/// @param  mask2d     Pointer to a data cube object that will be
+///                    pointing to the 2-D projection of the mask, as
+///                    returned by `DataCube_2d_mask()`. If `NULL`, no
+///                    projected mask will be created.
 /// @param  obj_name   Name of the object for `OBJECT` header entry.
 ///                    If `NULL`, no `OBJECT` entry will be created.
 /// @param  use_wcs    If `true`, convert channel numbers to WCS.
@@ -5047,7 +7720,7 @@ PRIVATE void DataCube_create_src_name(const DataCube *self, String **source_name
 ///                    channels map to a proper SNR map. Set to 0
 ///                    to disable this conversion.
 
-PUBLIC void DataCube_create_moments(const DataCube *self, const DataCube *mask, DataCube **mom0, DataCube **mom1, DataCube **mom2, DataCube **chan, DataCube **snr, const char *obj_name, bool use_wcs, const double threshold, const double rms)
+PUBLIC void DataCube_create_moments(const DataCube *self, const DataCube *mask, DataCube **mom0, DataCube **mom1, DataCube **mom2, DataCube **chan, DataCube **snr, DataCube **mask2d, const char *obj_name, bool use_wcs, const double threshold, const double rms)
 {
 	// Sanity checks
 	check_null(self);
@@ -5098,13 +7771,11 @@ PUBLIC void DataCube_create_moments(const DataCube *self, const DataCube *mask,
 	*mom2 = NULL;
 	*chan = NULL;
 	*snr  = NULL;
+	if(mask2d != NULL) *mask2d = NULL;
 	
 	// Create empty moment 0 map
 	*mom0 = DataCube_blank(self->axis_size[0], self->axis_size[1], 1, -32, self->verbosity);
 	
-	// Create additional map containing summed flux for moment 1 and 2 calculations
-	DataCube *sum_pos = NULL;
-	
 	// Copy WCS and other header elements from data cube to moment map
 	Header_copy_wcs(self->header, (*mom0)->header);
 	Header_copy_misc(self->header, (*mom0)->header, true, true);
@@ -5117,9 +7788,6 @@ PUBLIC void DataCube_create_moments(const DataCube *self, const DataCube *mask,
 		*mom1 = DataCube_copy(*mom0);
 		*mom2 = DataCube_copy(*mom0);
 		
-		// Create empty sum map (by copying empty moment 0 map)
-		sum_pos = DataCube_copy(*mom0);
-		
 		// Create empty channel map of 32-bit integer type
 		*chan = DataCube_blank(self->axis_size[0], self->axis_size[1], 1, 32, self->verbosity);
 		Header_copy_wcs(self->header, (*chan)->header);
@@ -5130,126 +7798,178 @@ PUBLIC void DataCube_create_moments(const DataCube *self, const DataCube *mask,
 		Header_set_str((*mom1)->header, "BUNIT", use_wcs ? String_get(unit_spec) : " ");
 		Header_set_str((*mom2)->header, "BUNIT", use_wcs ? String_get(unit_spec) : " ");
 		Header_set_str((*chan)->header, "BUNIT", " ");
+		
+		// Create empty SNR map if requested
+		if(rms > 0.0)
+		{
+			*snr = DataCube_blank(self->axis_size[0], self->axis_size[1], 1, -32, self->verbosity);
+			Header_copy_wcs(self->header, (*snr)->header);
+			Header_copy_misc(self->header, (*snr)->header, false, true);
+			Header_set_str((*snr)->header, "BUNIT", " ");
+			if(obj_name != NULL) Header_set_str((*snr)->header, "OBJECT", obj_name);
+		}
+	}
+	
+	// Create empty 2-D mask image if requested
+	if(mask2d != NULL)
+	{
+		*mask2d = DataCube_blank(mask->axis_size[0], mask->axis_size[1], 1, mask->data_type, mask->verbosity);
+		Header_copy_wcs(mask->header, (*mask2d)->header);
+		Header_copy_misc(mask->header, (*mask2d)->header, true, true);
 	}
 	
-	// Determine moments 0 and 1
-	// NOTE: This should not be multi-threaded, as otherwise the moment-0 map would
-	//       no longer be deterministic due to the arbitrary order of the summation
-	//       which would result in slightly different rounding errors. While those
-	//       differences are negligible, the moment maps from different runs would
-	//       no longer be binary-identical, making unit testing impossible.
-	for(size_t z = self->axis_size[2]; z--;)
+	// Determine spectral coordinate of each channel up front, as the
+	// WCS conversion is not thread-safe
+	const size_t nx = self->axis_size[0];
+	const size_t ny = self->axis_size[1];
+	const size_t nz = self->axis_size[2];
+	const double cdelt = use_wcs ? fabs(Header_get_flt(self->header, "CDELT3")) : 1.0;
+	double *spectral = (double *)memory(MALLOC, nz, sizeof(double));
+	for(size_t z = nz; z--;) spectral[z] = z;
+	if(use_wcs) DataCube_spectral_coordinates(wcs, 0, nz, spectral);
+	
+	// Determine all maps in a single pass through the cube
+	// NOTE: Each thread processes entire rows of the output maps, running
+	//       through the spectral axis in descending order for each row.
+	//       As every output pixel is only ever accumulated by one thread and
+	//       in the same channel order as before, the maps remain deterministic
+	//       and binary-identical between runs irrespective of the number of
+	//       threads. The fluxes contributing to moment 1 are buffered per row,
+	//       so moment 2 can be derived without a second pass through the cube.
+	float    *ptr_mom0 = (float *)((*mom0)->data);
+	float    *ptr_mom1 = is_3d ? (float *)((*mom1)->data) : NULL;
+	float    *ptr_mom2 = is_3d ? (float *)((*mom2)->data) : NULL;
+	int32_t  *ptr_chan = is_3d ? (int32_t *)((*chan)->data) : NULL;
+	float    *ptr_snr  = *snr != NULL ? (float *)((*snr)->data) : NULL;
+	
+	#pragma omp parallel
 	{
-		double spectral = z;
-		if(use_wcs) WCS_convertToWorld(wcs, 0, 0, z, NULL, NULL, &spectral);
+		double   *row_data = (double *)memory(MALLOC, nx, sizeof(double));
+		long int *row_mask = (long int *)memory(MALLOC, nx, sizeof(long int));
+		long int *row_proj = mask2d != NULL ? (long int *)memory(MALLOC, nx, sizeof(long int)) : NULL;
+		float    *row_sum  = is_3d ? (float *)memory(MALLOC, nx, sizeof(float)) : NULL;
+		size_t    list_cap = is_3d ? nx : 0;
+		size_t   *list_x   = is_3d ? (size_t *)memory(MALLOC, list_cap, sizeof(size_t)) : NULL;
+		size_t   *list_z   = is_3d ? (size_t *)memory(MALLOC, list_cap, sizeof(size_t)) : NULL;
+		double   *list_f   = is_3d ? (double *)memory(MALLOC, list_cap, sizeof(double)) : NULL;
 		
-		for(size_t y = self->axis_size[1]; y--;)
+		#pragma omp for schedule(static)
+		for(size_t y = 0; y < ny; ++y)
 		{
-			for(size_t x = self->axis_size[0]; x--;)
+			const size_t offset = nx * y;
+			size_t list_size = 0;
+			if(is_3d) memset(row_sum, 0, nx * sizeof(float));
+			if(row_proj != NULL) memset(row_proj, 0, nx * sizeof(long int));
+			
+			for(size_t z = nz; z--;)
 			{
-				if(DataCube_get_data_int(mask, x, y, z))
+				DataCube_get_row_int(mask, 0, nx - 1, y, z, row_mask);
+				
+				// Skip data read if no pixel in row is masked
+				size_t n_masked = 0;
+				for(size_t x = nx; x--;) n_masked += (row_mask[x] != 0);
+				if(n_masked == 0) continue;
+				
+				DataCube_get_row_flt(self, 0, nx - 1, y, z, row_data);
+				
+				for(size_t x = nx; x--;)
 				{
-					const double flux = DataCube_get_data_flt(self, x, y, z);
-					DataCube_add_data_flt(*mom0, x, y, 0, flux);
-					
-					if(is_3d)
+					if(row_mask[x])
 					{
-						DataCube_add_data_int(*chan, x, y, 0, 1);
+						const double flux = row_data[x];
+						ptr_mom0[offset + x] += (float)flux;
+						if(row_proj != NULL && row_proj[x] == 0) row_proj[x] = row_mask[x];
 						
-						if(flux > threshold)
+						if(is_3d)
 						{
-							DataCube_add_data_flt(*mom1, x, y, 0, flux * spectral);
-							DataCube_add_data_flt(sum_pos, x, y, 0, flux);
+							ptr_chan[offset + x] += 1;
+							
+							if(flux > threshold)
+							{
+								ptr_mom1[offset + x] += (float)(flux * spectral[z]);
+								row_sum[x] += (float)flux;
+								
+								// Remember contribution for moment 2
+								if(list_size == list_cap)
+								{
+									list_cap *= 2;
+									list_x = (size_t *)memory_realloc(list_x, list_cap, sizeof(size_t));
+									list_z = (size_t *)memory_realloc(list_z, list_cap, sizeof(size_t));
+									list_f = (double *)memory_realloc(list_f, list_cap, sizeof(double));
+								}
+								list_x[list_size] = x;
+								list_z[list_size] = z;
+								list_f[list_size] = flux;
+								++list_size;
+							}
 						}
 					}
 				}
 			}
-		}
-	}
-	
-	// If image is 2-D then return, as only mom0 needed and nothing else left to do
-	if(!is_3d) return;
-	
-	// Convert channel map to SNR map if requested
-	if(rms > 0.0)
-	{
-		// Create empty SNR map
-		*snr = DataCube_blank(self->axis_size[0], self->axis_size[1], 1, -32, self->verbosity);
-		Header_copy_wcs(self->header, (*snr)->header);
-		Header_copy_misc(self->header, (*snr)->header, false, true);
-		Header_set_str((*snr)->header, "BUNIT", " ");
-		if(obj_name != NULL) Header_set_str((*snr)->header, "OBJECT", obj_name);
-		
-		// Calculate SNR values
-		#pragma omp parallel for collapse(2) schedule(static)
-		for(size_t y = 0; y < self->axis_size[1]; ++y)
-		{
-			for(size_t x = 0; x < self->axis_size[0]; ++x)
+			
+			// Write projected mask row
+			if(row_proj != NULL)
 			{
-				const long int value_chan = DataCube_get_data_int(*chan, x, y, 0);
-				const double   value_flux = DataCube_get_data_flt(*mom0, x, y, 0);
-				if(value_chan > 0) DataCube_set_data_flt(*snr, x, y, 0, value_flux / (rms * sqrt((double)value_chan)));
-				else DataCube_set_data_flt(*snr, x, y, 0, NAN);
+				for(size_t x = nx; x--;) if(row_proj[x]) DataCube_set_data_int(*mask2d, x, y, 0, row_proj[x]);
 			}
-		}
-	}
-	
-	// Continue with creation of moments 1 and 2
-	// Divide moment 1 by moment 0
-	#pragma omp parallel for collapse(2) schedule(static)
-	for(size_t y = 0; y < self->axis_size[1]; ++y)
-	{
-		for(size_t x = 0; x < self->axis_size[0]; ++x)
-		{
-			const double flux = DataCube_get_data_flt(sum_pos, x, y, 0);
-			if(flux > 0.0) DataCube_set_data_flt(*mom1, x, y, 0, DataCube_get_data_flt(*mom1, x, y, 0) / flux);
-			else DataCube_set_data_flt(*mom1, x, y, 0, NAN);
-		}
-	}
-	
-	// Determine moment 2
-	for(size_t z = self->axis_size[2]; z--;)
-	{
-		double spectral = z;
-		if(use_wcs) WCS_convertToWorld(wcs, 0, 0, z, NULL, NULL, &spectral);
-		
-		for(size_t y = self->axis_size[1]; y--;)
-		{
-			for(size_t x = self->axis_size[0]; x--;)
+			
+			// Nothing else left to do for 2-D images
+			if(!is_3d) continue;
+			
+			// Divide moment 1 by summed flux
+			for(size_t x = nx; x--;)
 			{
-				if(DataCube_get_data_int(mask, x, y, z))
+				const double flux = row_sum[x];
+				if(flux > 0.0) ptr_mom1[offset + x] = (float)((double)(ptr_mom1[offset + x]) / flux);
+				else ptr_mom1[offset + x] = NAN;
+			}
+			
+			// Determine moment 2 from buffered contributions
+			for(size_t i = 0; i < list_size; ++i)
+			{
+				const size_t x = list_x[i];
+				const double velo = (double)(ptr_mom1[offset + x]) - spectral[list_z[i]];
+				ptr_mom2[offset + x] += (float)(velo * velo * list_f[i]);
+			}
+			
+			// Divide moment 2 by summed flux density and take square root
+			for(size_t x = nx; x--;)
+			{
+				const double flux = row_sum[x];
+				const double sigma = ptr_mom2[offset + x];
+				if(flux > 0.0 && sigma > 0.0) ptr_mom2[offset + x] = (float)sqrt(sigma / flux);
+				else ptr_mom2[offset + x] = NAN;
+			}
+			
+			// Convert channel map to SNR map if requested
+			if(ptr_snr != NULL)
+			{
+				for(size_t x = nx; x--;)
 				{
-					const double flux = DataCube_get_data_flt(self, x, y, z);
-					
-					if(flux > threshold)
-					{
-						const double velo = DataCube_get_data_flt(*mom1, x, y, 0) - spectral;
-						DataCube_add_data_flt(*mom2, x, y, 0, velo * velo * flux);
-					}
+					const long int value_chan = ptr_chan[offset + x];
+					if(value_chan > 0) ptr_snr[offset + x] = (float)((double)(ptr_mom0[offset + x]) / (rms * sqrt((double)value_chan)));
+					else ptr_snr[offset + x] = NAN;
 				}
 			}
+			
+			// Multiply moment 0 by CDELT3 if requested
+			if(use_wcs)
+			{
+				for(size_t x = nx; x--;) ptr_mom0[offset + x] *= cdelt;
+			}
 		}
+		
+		free(row_data);
+		free(row_mask);
+		free(row_proj);
+		free(row_sum);
+		free(list_x);
+		free(list_z);
+		free(list_f);
 	}
 	
-	// Divide moment 2 by summed flux density and take square root.
-	#pragma omp parallel for collapse(2) schedule(static)
-	for(size_t y = 0; y < self->axis_size[1]; ++y)
-	{
-		for(size_t x = 0; x < self->axis_size[0]; ++x)
-		{
-			// Moment 2
-			const double flux = DataCube_get_data_flt(sum_pos, x, y, 0);
-			const double sigma = DataCube_get_data_flt(*mom2, x, y, 0);
-			if(flux > 0.0 && sigma > 0.0) DataCube_set_data_flt(*mom2, x, y, 0, sqrt(sigma / flux));
-			else DataCube_set_data_flt(*mom2, x, y, 0, NAN);
-		}
-	}
-	
-	// Multiply moment 0 by CDELT3 if requested.
-	if(use_wcs) DataCube_multiply_const(*mom0, fabs(Header_get_flt(self->header, "CDELT3")));
-	
 	// Clean up
-	DataCube_delete(sum_pos);
+	free(spectral);
 	WCS_delete(wcs);
 	String_delete(unit_flux_dens);
 	String_delete(unit_spec);
@@ -5363,8 +8083,15 @@ PUBLIC DataCube *DataCube_create_pv(const DataCube *self, const double x0, const
 	DataCube_puthd_flt(pv, "PVD_PA", 180.0 * angle / M_PI);
 	WCS_delete(wcs);
 	
-	// Extract PV diagram
-	for(size_t x = 0; x <= 2 * steps; ++x)
+	// Precompute position and interpolation weights of each sample
+	// NOTE: The weights only depend on the spatial position, so they are
+	//       determined once per sample and then reused for all channels.
+	//       Samples beyond the axis range are marked with x1 = SIZE_MAX.
+	const size_t n_samples = 2 * steps + 1;
+	size_t *sample_x = (size_t *)memory(MALLOC, 2 * n_samples, sizeof(size_t));
+	double *weights  = (double *)memory(MALLOC, 4 * n_samples, sizeof(double));
+	
+	for(size_t x = 0; x < n_samples; ++x)
 	{
 		// Work out position
 		const double dr = step_size * ((double)x - (double)steps);
@@ -5377,22 +8104,68 @@ PUBLIC DataCube *DataCube_create_pv(const DataCube *self, const double x0, const
 		const size_t y1 = (size_t)floor(y_new);
 		const size_t y2 = (size_t)ceil(y_new);
 		
-		// Blank if pixels are beyond axis range
+		// Flag sample if pixels are beyond axis range
 		if(x1 >= nx || x2 >= nx || y1 >= ny || y2 >= ny || x2 <= x1 || y2 <= y1)
 		{
-			for(size_t z = 0; z < nz; ++z) DataCube_set_data_flt(pv, x, z, 0, NAN);
+			sample_x[2 * x] = SIZE_MAX;
 			continue;
 		}
 		
-		for(size_t z = 0; z < nz; ++z)
+		// NOTE: Here x2 = x1 + 1 and y2 = y1 + 1.
+		sample_x[2 * x]     = x1;
+		sample_x[2 * x + 1] = y1;
+		weights[4 * x]     = x2 - x_new;
+		weights[4 * x + 1] = x_new - x1;
+		weights[4 * x + 2] = y2 - y_new;
+		weights[4 * x + 3] = y_new - y1;
+	}
+	
+	// Extract PV diagram channel by channel
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < nz; ++z)
+	{
+		float *row = (float *)(pv->data) + z * n_samples;
+		const float *plane = (self->data_type == -32) ? (const float *)(self->data) + z * nx * ny : NULL;
+		
+		for(size_t x = 0; x < n_samples; ++x)
 		{
+			const size_t x1 = sample_x[2 * x];
+			if(x1 == SIZE_MAX)
+			{
+				row[x] = NAN;
+				continue;
+			}
+			
+			const size_t y1 = sample_x[2 * x + 1];
+			const double *w = weights + 4 * x;
+			double f11, f21, f12, f22;
+			
+			if(plane != NULL)
+			{
+				const float *ptr = plane + x1 + nx * y1;
+				f11 = ptr[0];
+				f21 = ptr[1];
+				f12 = ptr[nx];
+				f22 = ptr[nx + 1];
+			}
+			else
+			{
+				f11 = DataCube_get_data_flt(self, x1,     y1,     z);
+				f21 = DataCube_get_data_flt(self, x1 + 1, y1,     z);
+				f12 = DataCube_get_data_flt(self, x1,     y1 + 1, z);
+				f22 = DataCube_get_data_flt(self, x1 + 1, y1 + 1, z);
+			}
+			
 			// Bi-linear interpolation
-			const double f1 = (x2 - x_new) * DataCube_get_data_flt(self, x1, y1, z) + (x_new - x1) * DataCube_get_data_flt(self, x2, y1, z);
-			const double f2 = (x2 - x_new) * DataCube_get_data_flt(self, x1, y2, z) + (x_new - x1) * DataCube_get_data_flt(self, x2, y2, z);
-			DataCube_set_data_flt(pv, x, z, 0, (y2 - y_new) * f1 + (y_new - y1) * f2);
+			const double f1 = w[0] * f11 + w[1] * f21;
+			const double f2 = w[0] * f12 + w[1] * f22;
+			row[x] = (float)(w[2] * f1 + w[3] * f2);
 		}
 	}
 	
+	free(sample_x);
+	free(weights);
+	
 	return pv;
 }
 
@@ -5409,6 +8182,9 @@ PUBLIC DataCube *DataCube_create_pv(const DataCube *self, const double x0, const
 ///
 /// @param  self       Object self-reference (data cube).
 /// @param  mask       Mask cube.
+/// @param  voxels     List of source voxels as returned by
+///                    DataCube_get_voxel_list() for `mask`. If `NULL`,
+///                    the list will be created internally.
 /// @param  cat        Source catalogue.
 /// @param  basename   Base name to be used for output files.
 /// @param  overwrite  Replace existing files (`true`) or not (`false`)?
@@ -5422,7 +8198,7 @@ PUBLIC DataCube *DataCube_create_pv(const DataCube *self, const double x0, const
 ///                    to the output FITS file history in the header.
 ///                    If `NULL`, then no history will be written.
 
-PUBLIC void DataCube_create_cubelets(const DataCube *self, const DataCube *mask, const Catalog *cat, const char *basename, const bool overwrite, bool use_wcs, bool physical, const size_t margin, const double threshold, const size_t offset_z, const Parameter *par)
+PUBLIC void DataCube_create_cubelets(const DataCube *self, const DataCube *mask, const VoxelList *voxels, const Catalog *cat, const char *basename, const bool overwrite, bool use_wcs, bool physical, const size_t margin, const double threshold, const size_t offset_z, const Parameter *par)
 {
 	// Sanity checks
 	check_null(self);
@@ -5435,9 +8211,12 @@ PUBLIC void DataCube_create_cubelets(const DataCube *self, const DataCube *mask,
 	ensure(self->axis_size[0] == mask->axis_size[0] && self->axis_size[1] == mask->axis_size[1] && self->axis_size[2] == mask->axis_size[2], ERR_USER_INPUT, "Data cube and mask cube have different sizes.");
 	ensure(Catalog_get_size(cat), ERR_USER_INPUT, "Empty source catalogue provided.");
 	
+	// Create list of source voxels unless provided
+	VoxelList *voxels_own = (voxels == NULL) ? DataCube_get_voxel_list(mask) : NULL;
+	const VoxelList *voxel_list = (voxels == NULL) ? voxels_own : voxels;
+	
 	// Create string for file names
 	String *filename_template = String_append(String_new(basename), "_");
-	String *filename = String_new("");
 	
 	// Extract flux unit from header
 	String *unit_flux_dens = Header_get_string(self->header, "BUNIT");
@@ -5458,7 +8237,8 @@ PUBLIC void DataCube_create_cubelets(const DataCube *self, const DataCube *mask,
 	// (only supported if BUNIT is Jy/beam)
 	physical = physical ? String_compare(unit_flux_dens, "Jy/beam") : physical;
 	
-	// Extract WCS information if requested
+	// Check if valid WCS information is available if requested
+	// (each thread will work on its own copy further down)
 	WCS *wcs = NULL;
 	use_wcs = use_wcs ? (wcs = DataCube_extract_wcs(self)) != NULL : false;
 	
@@ -5504,290 +8284,314 @@ PUBLIC void DataCube_create_cubelets(const DataCube *self, const DataCube *mask,
 	}
 	
 	// Loop over all sources in the catalogue
-	for(size_t i = 0; i < Catalog_get_size(cat); ++i)
-	{
-		const Source *src = Catalog_get_source(cat, i);
-		
-		// Get source ID
-		const size_t src_id = Source_get_par_by_name_int(src, "id");
-		ensure(src_id, ERR_USER_INPUT, "Source ID missing from catalogue; cannot create cubelets.");
-		
-		// Get local RMS
-		double rms = Source_get_par_by_name_flt(src, "rms");
-		if IS_NAN(rms) rms = 0.0;
-		
-		// Get source bounding box
-		size_t x_min = Source_get_par_by_name_int(src, "x_min");
-		size_t x_max = Source_get_par_by_name_int(src, "x_max");
-		size_t y_min = Source_get_par_by_name_int(src, "y_min");
-		size_t y_max = Source_get_par_by_name_int(src, "y_max");
-		size_t z_min = Source_get_par_by_name_int(src, "z_min");
-		size_t z_max = Source_get_par_by_name_int(src, "z_max");
-		ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_INDEX_RANGE, "Illegal source bounding box: min > max!");
-		ensure(x_max < self->axis_size[0] && y_max < self->axis_size[1] && z_max < self->axis_size[2], ERR_INDEX_RANGE, "Source bounding box outside data cube boundaries.");
-		
-		// Add margin if requested
-		if(margin)
-		{
-			x_min = margin > x_min ? 0 : x_min - margin;
-			y_min = margin > y_min ? 0 : y_min - margin;
-			z_min = margin > z_min ? 0 : z_min - margin;
-			x_max = x_max + margin < self->axis_size[0] ? x_max + margin : self->axis_size[0] - 1;
-			y_max = y_max + margin < self->axis_size[1] ? y_max + margin : self->axis_size[1] - 1;
-			z_max = z_max + margin < self->axis_size[2] ? z_max + margin : self->axis_size[2] - 1;
-		}
-		
-		const size_t nx = x_max - x_min + 1;
-		const size_t ny = y_max - y_min + 1;
-		const size_t nz = z_max - z_min + 1;
-		
-		// Create empty cubelet
-		DataCube *cubelet = DataCube_blank(nx, ny, nz, self->data_type, self->verbosity);
-		
-		// Copy and adjust header information
-		Header_copy_wcs(self->header, cubelet->header);
-		Header_adjust_wcs_to_subregion(cubelet->header, x_min, x_max, y_min, y_max, z_min, z_max);
-		Header_copy_misc(self->header, cubelet->header, true, true);
-		Header_set_str(cubelet->header, "OBJECT", Source_get_identifier(src));
-		
-		// Create empty masklet
-		DataCube *masklet = DataCube_blank(nx, ny, nz, 8, self->verbosity);
-		
-		// Copy and adjust header information
-		Header_copy_wcs(self->header, masklet->header);
-		Header_adjust_wcs_to_subregion(masklet->header, x_min, x_max, y_min, y_max, z_min, z_max);
-		Header_set_str(masklet->header, "BUNIT", " ");
-		Header_set_str(masklet->header, "OBJECT", Source_get_identifier(src));
-		
-		// Create data array for spectrum
-		double *spectrum = (double *)memory(CALLOC, nz, sizeof(double));
-		size_t *pixcount = (size_t *)memory(CALLOC, nz, sizeof(size_t));
-		
-		// Copy data into cubelet, masklet and spectrum
-		for(size_t z = z_min; z <= z_max; ++z)
-		{
-			for(size_t y = y_min; y <= y_max; ++y)
-			{
-				for(size_t x = x_min; x <= x_max; ++x)
-				{
-					// Cubelet
-					DataCube_set_data_flt(cubelet, x - x_min, y - y_min, z - z_min, DataCube_get_data_flt(self, x, y, z));
-					
-					// Masklet
-					const size_t id = DataCube_get_data_int(mask, x, y, z);
-					if(id == src_id)
-					{
-						DataCube_set_data_int(masklet, x - x_min, y - y_min, z - z_min, 1);
-						spectrum[z - z_min] += DataCube_get_data_flt(self, x, y, z);
-						pixcount[z - z_min] += 1;
-					}
-					else DataCube_set_data_int(masklet, x - x_min, y - y_min, z - z_min, 0);
-				}
-			}
-		}
-		
-		// Create moment maps etc.
-		DataCube *mom0;
-		DataCube *mom1;
-		DataCube *mom2;
-		DataCube *chan;
-		DataCube *snr;
-		DataCube_create_moments(cubelet, masklet, &mom0, &mom1, &mom2, &chan, &snr, Source_get_identifier(src), use_wcs, threshold * rms, rms);
-		
-		// Create PV diagram
-		DataCube *pv = DataCube_create_pv(cubelet, Source_get_par_by_name_flt(src, "x") - x_min, Source_get_par_by_name_flt(src, "y") - y_min, Source_get_par_by_name_flt(src, "kin_pa") * M_PI / 180.0, 1.0, Source_get_identifier(src));
-		DataCube *pv_min = DataCube_create_pv(cubelet, Source_get_par_by_name_flt(src, "x") - x_min, Source_get_par_by_name_flt(src, "y") - y_min, (Source_get_par_by_name_flt(src, "kin_pa") + 90.0) * M_PI / 180.0, 1.0, Source_get_identifier(src));
-		
-		// Save output products...
-		// ...cubelet
-		String_set(filename, String_get(filename_template));
-		String_append_int(filename, "%ld", src_id);
-		String_append(filename, "_cube.fits");
-		DataCube_add_history(cubelet, par);
-		DataCube_save(cubelet, String_get(filename), overwrite, DESTROY);
-		
-		// ...masklet
-		String_set(filename, String_get(filename_template));
-		String_append_int(filename, "%ld", src_id);
-		String_append(filename, "_mask.fits");
-		DataCube_add_history(masklet, par);
-		DataCube_save(masklet, String_get(filename), overwrite, DESTROY);
-		
-		// ...moment maps
-		if(mom0 != NULL)
-		{
-			String_set(filename, String_get(filename_template));
-			String_append_int(filename, "%ld", src_id);
-			String_append(filename, "_mom0.fits");
-			DataCube_add_history(mom0, par);
-			DataCube_save(mom0, String_get(filename), overwrite, DESTROY);
-		}
-		
-		if(mom1 != NULL)
-		{
-			String_set(filename, String_get(filename_template));
-			String_append_int(filename, "%ld", src_id);
-			String_append(filename, "_mom1.fits");
-			DataCube_add_history(mom1, par);
-			DataCube_save(mom1, String_get(filename), overwrite, DESTROY);
-		}
-		
-		if(mom2 != NULL)
-		{
-			String_set(filename, String_get(filename_template));
-			String_append_int(filename, "%ld", src_id);
-			String_append(filename, "_mom2.fits");
-			DataCube_add_history(mom2, par);
-			DataCube_save(mom2, String_get(filename), overwrite, DESTROY);
-		}
-		
-		if(chan != NULL)
-		{
-			String_set(filename, String_get(filename_template));
-			String_append_int(filename, "%ld", src_id);
-			String_append(filename, "_chan.fits");
-			DataCube_add_history(chan, par);
-			DataCube_save(chan, String_get(filename), overwrite, DESTROY);
-		}
+	// NOTE: Sources are processed in parallel, with each thread creating and
+	//       writing all products of one source at a time. This overlaps the
+	//       computation of one source with the file output of others. Each
+	//       thread needs its own file name and WCS object.
+	const size_t n_src = Catalog_get_size(cat);
+	
+	#pragma omp parallel
+	{
+		String *filename = String_new("");
+		WCS *wcs_local = use_wcs ? WCS_copy(wcs) : NULL;
 		
-		if(snr != NULL)
+		#pragma omp for schedule(dynamic)
+		for(size_t i = 0; i < n_src; ++i)
 		{
+			const Source *src = Catalog_get_source(cat, i);
+			
+			// Get source ID
+			const size_t src_id = Source_get_par_by_name_int(src, "id");
+			ensure(src_id, ERR_USER_INPUT, "Source ID missing from catalogue; cannot create cubelets.");
+			
+			// Get local RMS
+			double rms = Source_get_par_by_name_flt(src, "rms");
+			if IS_NAN(rms) rms = 0.0;
+			
+			// Get source bounding box
+			size_t x_min = Source_get_par_by_name_int(src, "x_min");
+			size_t x_max = Source_get_par_by_name_int(src, "x_max");
+			size_t y_min = Source_get_par_by_name_int(src, "y_min");
+			size_t y_max = Source_get_par_by_name_int(src, "y_max");
+			size_t z_min = Source_get_par_by_name_int(src, "z_min");
+			size_t z_max = Source_get_par_by_name_int(src, "z_max");
+			ensure(x_min <= x_max && y_min <= y_max && z_min <= z_max, ERR_INDEX_RANGE, "Illegal source bounding box: min > max!");
+			ensure(x_max < self->axis_size[0] && y_max < self->axis_size[1] && z_max < self->axis_size[2], ERR_INDEX_RANGE, "Source bounding box outside data cube boundaries.");
+			
+			// Add margin if requested
+			if(margin)
+			{
+				x_min = margin > x_min ? 0 : x_min - margin;
+				y_min = margin > y_min ? 0 : y_min - margin;
+				z_min = margin > z_min ? 0 : z_min - margin;
+				x_max = x_max + margin < self->axis_size[0] ? x_max + margin : self->axis_size[0] - 1;
+				y_max = y_max + margin < self->axis_size[1] ? y_max + margin : self->axis_size[1] - 1;
+				z_max = z_max + margin < self->axis_size[2] ? z_max + margin : self->axis_size[2] - 1;
+			}
+			
+			const size_t nx = x_max - x_min + 1;
+			const size_t ny = y_max - y_min + 1;
+			const size_t nz = z_max - z_min + 1;
+			
+			// Create empty cubelet
+			DataCube *cubelet = DataCube_blank(nx, ny, nz, self->data_type, self->verbosity);
+			
+			// Copy and adjust header information
+			Header_copy_wcs(self->header, cubelet->header);
+			Header_adjust_wcs_to_subregion(cubelet->header, x_min, x_max, y_min, y_max, z_min, z_max);
+			Header_copy_misc(self->header, cubelet->header, true, true);
+			Header_set_str(cubelet->header, "OBJECT", Source_get_identifier(src));
+			
+			// Create empty masklet
+			DataCube *masklet = DataCube_blank(nx, ny, nz, 8, self->verbosity);
+			
+			// Copy and adjust header information
+			Header_copy_wcs(self->header, masklet->header);
+			Header_adjust_wcs_to_subregion(masklet->header, x_min, x_max, y_min, y_max, z_min, z_max);
+			Header_set_str(masklet->header, "BUNIT", " ");
+			Header_set_str(masklet->header, "OBJECT", Source_get_identifier(src));
+			
+			// Create data array for spectrum
+			double *spectrum = (double *)memory(CALLOC, nz, sizeof(double));
+			size_t *pixcount = (size_t *)memory(CALLOC, nz, sizeof(size_t));
+			
+			// Copy data into cubelet one row at a time
+			for(size_t z = z_min; z <= z_max; ++z)
+			{
+				for(size_t y = y_min; y <= y_max; ++y)
+				{
+					memcpy(cubelet->data + DataCube_get_index(cubelet, 0, y - y_min, z - z_min) * cubelet->word_size, self->data + DataCube_get_index(self, x_min, y, z) * self->word_size, nx * self->word_size);
+				}
+			}
+			
+			// Fill masklet and spectrum from list of source voxels
+			// (masklet is already initialised to 0)
+			const size_t *voxels_src = VoxelList_get_voxels(voxel_list, src_id);
+			const size_t n_voxels = VoxelList_get_size(voxel_list, src_id);
+			
+			for(size_t k = 0; k < n_voxels; ++k)
+			{
+				size_t x, y, z;
+				DataCube_get_xyz(self, voxels_src[k], &x, &y, &z);
+				if(x < x_min || x > x_max || y < y_min || y > y_max || z < z_min || z > z_max) continue;
+				
+				DataCube_set_data_int(masklet, x - x_min, y - y_min, z - z_min, 1);
+				spectrum[z - z_min] += DataCube_get_data_flt(self, x, y, z);
+				pixcount[z - z_min] += 1;
+			}
+			
+			// Create moment maps etc.
+			DataCube *mom0;
+			DataCube *mom1;
+			DataCube *mom2;
+			DataCube *chan;
+			DataCube *snr;
+			DataCube_create_moments(cubelet, masklet, &mom0, &mom1, &mom2, &chan, &snr, NULL, Source_get_identifier(src), use_wcs, threshold * rms, rms);
+			
+			// Create PV diagram
+			DataCube *pv = DataCube_create_pv(cubelet, Source_get_par_by_name_flt(src, "x") - x_min, Source_get_par_by_name_flt(src, "y") - y_min, Source_get_par_by_name_flt(src, "kin_pa") * M_PI / 180.0, 1.0, Source_get_identifier(src));
+			DataCube *pv_min = DataCube_create_pv(cubelet, Source_get_par_by_name_flt(src, "x") - x_min, Source_get_par_by_name_flt(src, "y") - y_min, (Source_get_par_by_name_flt(src, "kin_pa") + 90.0) * M_PI / 180.0, 1.0, Source_get_identifier(src));
+			
+			// Save output products...
+			// ...cubelet
 			String_set(filename, String_get(filename_template));
 			String_append_int(filename, "%ld", src_id);
-			String_append(filename, "_snr.fits");
-			DataCube_add_history(snr, par);
-			DataCube_save(snr, String_get(filename), overwrite, DESTROY);
-		}
-		
-		if(pv != NULL)
-		{
+			String_append(filename, "_cube.fits");
+			DataCube_add_history(cubelet, par);
+			DataCube_save(cubelet, String_get(filename), overwrite, DESTROY);
+			
+			// ...masklet
 			String_set(filename, String_get(filename_template));
 			String_append_int(filename, "%ld", src_id);
-			String_append(filename, "_pv.fits");
-			DataCube_add_history(pv, par);
-			DataCube_save(pv, String_get(filename), overwrite, DESTROY);
-		}
-		
-		if(pv_min != NULL)
-		{
+			String_append(filename, "_mask.fits");
+			DataCube_add_history(masklet, par);
+			DataCube_save(masklet, String_get(filename), overwrite, DESTROY);
+			
+			// ...moment maps
+			if(mom0 != NULL)
+			{
+				String_set(filename, String_get(filename_template));
+				String_append_int(filename, "%ld", src_id);
+				String_append(filename, "_mom0.fits");
+				DataCube_add_history(mom0, par);
+				DataCube_save(mom0, String_get(filename), overwrite, DESTROY);
+			}
+			
+			if(mom1 != NULL)
+			{
+				String_set(filename, String_get(filename_template));
+				String_append_int(filename, "%ld", src_id);
+				String_append(filename, "_mom1.fits");
+				DataCube_add_history(mom1, par);
+				DataCube_save(mom1, String_get(filename), overwrite, DESTROY);
+			}
+			
+			if(mom2 != NULL)
+			{
+				String_set(filename, String_get(filename_template));
+				String_append_int(filename, "%ld", src_id);
+				String_append(filename, "_mom2.fits");
+				DataCube_add_history(mom2, par);
+				DataCube_save(mom2, String_get(filename), overwrite, DESTROY);
+			}
+			
+			if(chan != NULL)
+			{
+				String_set(filename, String_get(filename_template));
+				String_append_int(filename, "%ld", src_id);
+				String_append(filename, "_chan.fits");
+				DataCube_add_history(chan, par);
+				DataCube_save(chan, String_get(filename), overwrite, DESTROY);
+			}
+			
+			if(snr != NULL)
+			{
+				String_set(filename, String_get(filename_template));
+				String_append_int(filename, "%ld", src_id);
+				String_append(filename, "_snr.fits");
+				DataCube_add_history(snr, par);
+				DataCube_save(snr, String_get(filename), overwrite, DESTROY);
+			}
+			
+			if(pv != NULL)
+			{
+				String_set(filename, String_get(filename_template));
+				String_append_int(filename, "%ld", src_id);
+				String_append(filename, "_pv.fits");
+				DataCube_add_history(pv, par);
+				DataCube_save(pv, String_get(filename), overwrite, DESTROY);
+			}
+			
+			if(pv_min != NULL)
+			{
+				String_set(filename, String_get(filename_template));
+				String_append_int(filename, "%ld", src_id);
+				String_append(filename, "_pv_min.fits");
+				DataCube_add_history(pv_min, par);
+				DataCube_save(pv_min, String_get(filename), overwrite, DESTROY);
+			}
+			
+			// ...spectrum
 			String_set(filename, String_get(filename_template));
 			String_append_int(filename, "%ld", src_id);
-			String_append(filename, "_pv_min.fits");
-			DataCube_add_history(pv_min, par);
-			DataCube_save(pv_min, String_get(filename), overwrite, DESTROY);
-		}
-		
-		// ...spectrum
-		String_set(filename, String_get(filename_template));
-		String_append_int(filename, "%ld", src_id);
-		String_append(filename, "_spec.txt");
-		message("Creating text file: %s", strrchr(String_get(filename), '/') == NULL ? String_get(filename) : strrchr(String_get(filename), '/') + 1);
-		
-		// Get current date and time
-		char current_time_string[64];
-		time_t current_time = time(NULL);
-		strftime(current_time_string, 64, "%a, %d %b %Y, %H:%M:%S", localtime(&current_time));
-		
-		FILE *fp;
-		if(overwrite) fp = fopen(String_get(filename), "wb");
-		else fp = fopen(String_get(filename), "wxb");
-		ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open output file: %s", String_get(filename));
-		
-		fprintf(fp, "# Integrated source spectrum\n");
-		fprintf(fp, "# Creator: %s (%s)\n", SOFIA_VERSION_FULL, SOFIA_CREATION_DATE);
-		fprintf(fp, "# Time:    %s\n", current_time_string);
-		fprintf(fp, "#\n");
-		fprintf(fp, "# Description of parameters:\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "# - chan    Spectral channel number (zero-based).\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "# - v_opt / v_rad / v_app\n");
-		fprintf(fp, "#           Radial velocity corresponding to the channel number as\n");
-		fprintf(fp, "#           described by the WCS information in the header. The suf-\n");
-		fprintf(fp, "#           fix denotes optical, radio or apparent radial velocity,\n");
-		fprintf(fp, "#           respectively.\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "# - freq    Frequency corresponding to the channel number as described\n");
-		fprintf(fp, "#           by the WCS information in the header.\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "# - f_sum   Sum of flux density values of all spatial pixels covered\n");
-		fprintf(fp, "#           by the source in that channel. If the unit is Jy, then\n");
-		fprintf(fp, "#           the flux density has already been corrected for the solid\n");
-		fprintf(fp, "#           angle of the beam. If instead the unit is Jy/beam, you\n");
-		fprintf(fp, "#           will need to manually divide by the beam area which, for\n");
-		fprintf(fp, "#           Gaussian beams, will be\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "#             pi * a * b / (4 * ln(2))\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "#           where a and b are the major and minor axis of the beam in\n");
-		fprintf(fp, "#           units of pixels.\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "# - n_pix   Number of spatial pixels covered by the source in that\n");
-		fprintf(fp, "#           channel. This can be used to determine the statistical\n");
-		fprintf(fp, "#           uncertainty of the summed flux value. Again, this has\n");
-		fprintf(fp, "#           not yet been corrected for any potential spatial correla-\n");
-		fprintf(fp, "#           tion of pixels due to the beam solid angle.\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "# Note that a WCS-related column will only be present if WCS conversion\n");
-		fprintf(fp, "# was explicitly requested when running the pipeline.\n");
-		fprintf(fp, "#\n");
-		fprintf(fp, "# Header rows:\n");
-		fprintf(fp, "#   1 = column number\n");
-		fprintf(fp, "#   2 = parameter name\n");
-		fprintf(fp, "#   3 = parameter unit\n");
-		fprintf(fp, "#\n");
-		if(use_wcs)
-		{
-			// 4 columns (chan, wcs, f_sum, n_pix)
-			fprintf(fp, "#%*s%*s%*s%*s\n", 9, "1",    18, "2",                    18, "3",                   10, "4");
-			fprintf(fp, "#%*s%*s%*s%*s\n", 9, "chan", 18, String_get(label_spec), 18, "f_sum",               10, "n_pix");
-			fprintf(fp, "#%*s%*s%*s%*s\n", 9, "-",    18, String_get(unit_spec),  18, String_get(unit_flux), 10, "-");
-		}
-		else
-		{
-			// 3 columns (chan, f_sum, n_pix)
-			fprintf(fp, "#%*s%*s%*s\n", 9, "1",    18, "2",                   10, "3");
-			fprintf(fp, "#%*s%*s%*s\n", 9, "chan", 18, "f_sum",               10, "n_pix");
-			fprintf(fp, "#%*s%*s%*s\n", 9, "-",    18, String_get(unit_flux), 10, "-");
-		}
-		fprintf(fp, "#\n");
-		
-		for(size_t j = 0; j < nz; ++j)
-		{
-			// Convert z to WCS if requested and possible
+			String_append(filename, "_spec.txt");
+			message("Creating text file: %s", strrchr(String_get(filename), '/') == NULL ? String_get(filename) : strrchr(String_get(filename), '/') + 1);
+			
+			// Get current date and time
+			// (localtime() is not thread-safe)
+			char current_time_string[64];
+			time_t current_time = time(NULL);
+			#pragma omp critical
+			strftime(current_time_string, 64, "%a, %d %b %Y, %H:%M:%S", localtime(&current_time));
+			
+			FILE *fp;
+			if(overwrite) fp = fopen(String_get(filename), "wb");
+			else fp = fopen(String_get(filename), "wxb");
+			ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open output file: %s", String_get(filename));
+			
+			fprintf(fp, "# Integrated source spectrum\n");
+			fprintf(fp, "# Creator: %s (%s)\n", SOFIA_VERSION_FULL, SOFIA_CREATION_DATE);
+			fprintf(fp, "# Time:    %s\n", current_time_string);
+			fprintf(fp, "#\n");
+			fprintf(fp, "# Description of parameters:\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "# - chan    Spectral channel number (zero-based).\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "# - v_opt / v_rad / v_app\n");
+			fprintf(fp, "#           Radial velocity corresponding to the channel number as\n");
+			fprintf(fp, "#           described by the WCS information in the header. The suf-\n");
+			fprintf(fp, "#           fix denotes optical, radio or apparent radial velocity,\n");
+			fprintf(fp, "#           respectively.\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "# - freq    Frequency corresponding to the channel number as described\n");
+			fprintf(fp, "#           by the WCS information in the header.\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "# - f_sum   Sum of flux density values of all spatial pixels covered\n");
+			fprintf(fp, "#           by the source in that channel. If the unit is Jy, then\n");
+			fprintf(fp, "#           the flux density has already been corrected for the solid\n");
+			fprintf(fp, "#           angle of the beam. If instead the unit is Jy/beam, you\n");
+			fprintf(fp, "#           will need to manually divide by the beam area which, for\n");
+			fprintf(fp, "#           Gaussian beams, will be\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "#             pi * a * b / (4 * ln(2))\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "#           where a and b are the major and minor axis of the beam in\n");
+			fprintf(fp, "#           units of pixels.\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "# - n_pix   Number of spatial pixels covered by the source in that\n");
+			fprintf(fp, "#           channel. This can be used to determine the statistical\n");
+			fprintf(fp, "#           uncertainty of the summed flux value. Again, this has\n");
+			fprintf(fp, "#           not yet been corrected for any potential spatial correla-\n");
+			fprintf(fp, "#           tion of pixels due to the beam solid angle.\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "# Note that a WCS-related column will only be present if WCS conversion\n");
+			fprintf(fp, "# was explicitly requested when running the pipeline.\n");
+			fprintf(fp, "#\n");
+			fprintf(fp, "# Header rows:\n");
+			fprintf(fp, "#   1 = column number\n");
+			fprintf(fp, "#   2 = parameter name\n");
+			fprintf(fp, "#   3 = parameter unit\n");
+			fprintf(fp, "#\n");
+			if(use_wcs)
+			{
+				// 4 columns (chan, wcs, f_sum, n_pix)
+				fprintf(fp, "#%*s%*s%*s%*s\n", 9, "1",    18, "2",                    18, "3",                   10, "4");
+				fprintf(fp, "#%*s%*s%*s%*s\n", 9, "chan", 18, String_get(label_spec), 18, "f_sum",               10, "n_pix");
+				fprintf(fp, "#%*s%*s%*s%*s\n", 9, "-",    18, String_get(unit_spec),  18, String_get(unit_flux), 10, "-");
+			}
+			else
+			{
+				// 3 columns (chan, f_sum, n_pix)
+				fprintf(fp, "#%*s%*s%*s\n", 9, "1",    18, "2",                   10, "3");
+				fprintf(fp, "#%*s%*s%*s\n", 9, "chan", 18, "f_sum",               10, "n_pix");
+				fprintf(fp, "#%*s%*s%*s\n", 9, "-",    18, String_get(unit_flux), 10, "-");
+			}
+			fprintf(fp, "#\n");
+			
+			// Convert all channels to WCS in one go if requested and possible
+			double *spectral = NULL;
 			if(use_wcs)
 			{
-				double spectral = 0.0;
-				WCS_convertToWorld(wcs, 0, 0, j + z_min, NULL, NULL, &spectral);
-				fprintf(fp, "%*zu%*.7e%*.7e%*zu\n", 10, j + z_min + offset_z, 18, spectral, 18, spectrum[j] / beam_area, 10, pixcount[j]);
+				spectral = (double *)memory(CALLOC, nz, sizeof(double));
+				DataCube_spectral_coordinates(wcs_local, z_min, nz, spectral);
+			}
+			
+			for(size_t j = 0; j < nz; ++j)
+			{
+				if(use_wcs) fprintf(fp, "%*zu%*.7e%*.7e%*zu\n", 10, j + z_min + offset_z, 18, spectral[j], 18, spectrum[j] / beam_area, 10, pixcount[j]);
+				else fprintf(fp, "%*zu%*.7e%*zu\n", 10, j + z_min + offset_z, 18, spectrum[j] / beam_area, 10, pixcount[j]);
 			}
-			else fprintf(fp, "%*zu%*.7e%*zu\n", 10, j + z_min + offset_z, 18, spectrum[j] / beam_area, 10, pixcount[j]);
+			
+			fclose(fp);
+			free(spectral);
+			
+			// Delete output products again
+			DataCube_delete(cubelet);
+			DataCube_delete(masklet);
+			DataCube_delete(mom0);
+			DataCube_delete(mom1);
+			DataCube_delete(mom2);
+			DataCube_delete(chan);
+			DataCube_delete(snr);
+			DataCube_delete(pv);
+			DataCube_delete(pv_min);
+			free(spectrum);
+			free(pixcount);
 		}
 		
-		fclose(fp);
-		
-		// Delete output products again
-		DataCube_delete(cubelet);
-		DataCube_delete(masklet);
-		DataCube_delete(mom0);
-		DataCube_delete(mom1);
-		DataCube_delete(mom2);
-		DataCube_delete(chan);
-		DataCube_delete(snr);
-		DataCube_delete(pv);
-		DataCube_delete(pv_min);
-		free(spectrum);
-		free(pixcount);
+		// Clean up (per thread)
+		String_delete(filename);
+		WCS_delete(wcs_local);
 	}
 	
 	// Clean up
+	VoxelList_delete(voxels_own);
+	WCS_delete(wcs);
 	String_delete(filename_template);
-	String_delete(filename);
 	String_delete(unit_flux_dens);
 	String_delete(unit_flux);
 	String_delete(unit_spec);
 	String_delete(label_spec);
-	WCS_delete(wcs);
 	
 	return;
 }
@@ -5881,3 +8685,264 @@ PRIVATE void DataCube_swap_byte_order(const DataCube *self)
 	
 	return;
 }
+
+
+
+/// @brief Read block of data from file
+///
+/// Private method for reading the specified number of bytes from
+/// a file at the specified offset from the start of the file. The
+/// file position is not changed, so several threads can read from
+/// the same file descriptor at the same time. Reads will be repeated
+/// until the requested number of bytes has been read, and the pro-
+/// gram will be terminated if the end of the file is reached or if
+/// an error occurs.
+///
+/// @param fd      File descriptor of the file to be read.
+/// @param buffer  Buffer into which the data will be read. Must be
+///                large enough to hold `size` bytes.
+/// @param size    Number of bytes to be read.
+/// @param offset  Offset from the start of the file in bytes.
+
+PRIVATE void DataCube_read_block(const int fd, char *buffer, size_t size, size_t offset)
+{
+	while(size)
+	{
+		const ssize_t n = pread(fd, buffer, size, (off_t)offset);
+		if(n < 0 && errno == EINTR) continue;
+		ensure(n > 0, ERR_FILE_ACCESS, "FITS file ended unexpectedly while reading data.");
+		buffer += n;
+		offset += n;
+		size   -= n;
+	}
+	
+	return;
+}
+
+
+
+/// @brief Allocate and initialise data array
+///
+/// Private method for allocating memory for a data array consisting
+/// of `n_planes` image planes of `plane_size` bytes each. The array
+/// will be initialised plane by plane in parallel, using the same
+/// static schedule over planes as the parallel loops operating on
+/// the cube. On NUMA systems this first touch will place each plane
+/// in memory local to the thread that will later process it. The
+/// planes will be copied from `source` if specified and otherwise
+/// filled with 0. If huge pages were requested with DataCube_set_-
+/// huge_pages(), arrays of at least `DATACUBE_HUGE_PAGE` bytes will
+/// be aligned to the huge-page size and advised to be backed by
+/// transparent huge pages. The returned array can be reallocated
+/// and released with `realloc()` and `free()` as usual.
+///
+/// @param n_planes    Number of image planes to be allocated.
+/// @param plane_size  Size of a single image plane in bytes.
+/// @param source      Array of the same size to be copied into the
+///                    new array. Set to `NULL` to initialise the new
+///                    array with 0.
+///
+/// @return Pointer to newly allocated array.
+
+PRIVATE char *DataCube_allocate(const size_t n_planes, const size_t plane_size, const char *source)
+{
+	const size_t size = n_planes * plane_size;
+	char *array = NULL;
+	
+	if(DataCube_huge_pages && size >= DATACUBE_HUGE_PAGE)
+	{
+		void *ptr = NULL;
+		ensure(posix_memalign(&ptr, DATACUBE_HUGE_PAGE, size) == 0, ERR_MEM_ALLOC, "Failed to allocate %f GB of memory.", (double)(size) / GIGABYTE);
+		array = (char *)ptr;
+		
+		#ifdef MADV_HUGEPAGE
+			// NOTE: Failure is not fatal, as the array will simply be backed by
+			//       normal pages. Further requests will be skipped in that case.
+			if(madvise(array, size, MADV_HUGEPAGE) != 0)
+			{
+				warning("Huge pages not available; using normal pages instead.");
+				DataCube_huge_pages = false;
+			}
+		#endif
+	}
+	else array = (char *)memory(MALLOC, n_planes, plane_size);
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t z = 0; z < n_planes; ++z)
+	{
+		if(source != NULL) memcpy(array + z * plane_size, source + z * plane_size, plane_size);
+		else memset(array + z * plane_size, 0, plane_size);
+	}
+	
+	return array;
+}
+
+
+
+/// @brief Read data value from memory-mapped cube
+///
+/// Private method for reading a single data value at the specified
+/// position of a memory-mapped data cube. Coordinates are relative to
+/// the mapped region. The value will be converted from the big-endian
+/// byte order of the FITS file to native byte order while reading,
+/// and BSCALE and BZERO will be applied in the native precision of
+/// the data in the same way as in DataCube_load().
+///
+/// @param self  Object self-reference.
+/// @param x     First coordinate.
+/// @param y     Second coordinate.
+/// @param z     Third coordinate.
+///
+/// @return Data value at the specified position.
+
+PRIVATE inline double DataCube_get_mapped_flt(const DataCube *self, const size_t x, const size_t y, const size_t z)
+{
+	const size_t index = (x + self->map_origin[0]) + self->map_axis[0] * ((y + self->map_origin[1]) + self->map_axis[1] * (z + self->map_origin[2]));
+	
+	if(self->data_type == -32)
+	{
+		float value;
+		memcpy(&value, self->data + index * sizeof(float), sizeof(float));
+		if(is_little_endian()) swap_byte_order((char *)&value, sizeof(float));
+		if(self->map_bscale != 1.0) value *= self->map_bscale;
+		if(self->map_bzero  != 0.0) value += self->map_bzero;
+		return value;
+	}
+	
+	double value;
+	memcpy(&value, self->data + index * sizeof(double), sizeof(double));
+	if(is_little_endian()) swap_byte_order((char *)&value, sizeof(double));
+	if(self->map_bscale != 1.0) value *= self->map_bscale;
+	if(self->map_bzero  != 0.0) value += self->map_bzero;
+	return value;
+}
+
+
+
+/// @brief Read and parse FITS header
+///
+/// Private method for reading the entire header of a FITS file from
+/// the current position of the specified file pointer and setting
+/// the header, data type, dimensions and axis sizes of the data cube
+/// accordingly. The file pointer will be left at the start of the
+/// data array. 4-dimensional cubes with a degenerate 3rd axis will
+/// have their 3rd and 4th axis swapped.
+///
+/// @param self  Object self-reference.
+/// @param fp    File pointer to the start of the FITS header.
+
+PRIVATE void DataCube_read_header(DataCube *self, FILE *fp)
+{
+	// Read entire header into temporary array
+	char *header = NULL;
+	size_t header_size = 0;
+	bool end_reached = false;
+	
+	while(!end_reached)
+	{
+		// (Re-)allocate memory as needed
+		header = (char *)memory_realloc(header, header_size + FITS_HEADER_BLOCK_SIZE, sizeof(char));
+		
+		// Read header block
+		ensure(fread(header + header_size, 1, FITS_HEADER_BLOCK_SIZE, fp) == FITS_HEADER_BLOCK_SIZE, ERR_FILE_ACCESS, "FITS file ended unexpectedly while reading header.");
+		
+		// Check if we have reached the end of the header
+		char *ptr = header + header_size;
+		
+		while(!end_reached && ptr < header + header_size + FITS_HEADER_BLOCK_SIZE)
+		{
+			if(strncmp(ptr, "END", 3) == 0) end_reached = true;
+			else ptr += FITS_HEADER_LINE_SIZE;
+		}
+		
+		// Set header size parameter
+		header_size += FITS_HEADER_BLOCK_SIZE;
+	}
+	
+	// Check if valid FITS file
+	ensure(strncmp(header, "SIMPLE", 6) == 0, ERR_USER_INPUT, "Missing \'SIMPLE\' keyword; file does not appear to be a FITS file.");
+	
+	// Create Header object and de-allocate memory again
+	self->header = Header_new(header, header_size, self->verbosity);
+	free(header);
+	
+	// Extract crucial header elements
+	self->data_type    = Header_get_int(self->header, "BITPIX");
+	self->dimension    = Header_get_int(self->header, "NAXIS");
+	self->axis_size[0] = Header_get_int(self->header, "NAXIS1");
+	self->axis_size[1] = Header_get_int(self->header, "NAXIS2");
+	self->axis_size[2] = Header_get_int(self->header, "NAXIS3");
+	self->axis_size[3] = Header_get_int(self->header, "NAXIS4");
+	self->word_size    = abs(self->data_type) / 8;             // WARNING: Assumes 8 bits per char; see CHAR_BIT in limits.h.
+	self->data_size    = self->axis_size[0];
+	for(size_t i = 1; i < self->dimension; ++i) self->data_size *= self->axis_size[i];
+	
+	// Sanity checks
+	ensure(self->data_type == -64
+		|| self->data_type == -32
+		|| self->data_type == 8
+		|| self->data_type == 16
+		|| self->data_type == 32
+		|| self->data_type == 64,
+		ERR_USER_INPUT, "Invalid BITPIX keyword encountered.");
+	
+	ensure(self->dimension > 0
+		&& self->dimension < 5,
+		ERR_USER_INPUT, "Only FITS files with 1-4 dimensions are supported.");
+	
+	ensure(self->dimension < 4
+		|| self->axis_size[3] == 1
+		|| self->axis_size[2] == 1,
+		ERR_USER_INPUT, "The size of the 3rd or 4th axis must be 1.");
+	
+	ensure(self->data_size > 0,
+		ERR_USER_INPUT, "Invalid NAXISn keyword encountered.");
+	
+	if(self->dimension < 3) self->axis_size[2] = 1;
+	if(self->dimension < 2) self->axis_size[1] = 1;
+	
+	// Swap third and fourth axis header keywords if necessary
+	if(self->dimension == 4 && self->axis_size[2] == 1 && self->axis_size[3] > 1)
+	{
+		warning("Swapping order of 3rd and 4th axis of 4D cube.");
+		
+		double tmp;
+		size_t tmp2;
+		String *str3, *str4;
+		
+		tmp2 = self->axis_size[2];
+		self->axis_size[2] = self->axis_size[3];
+		self->axis_size[3] = tmp2;
+		
+		Header_set_int(self->header, "NAXIS3", Header_get_int(self->header, "NAXIS4"));
+		Header_set_int(self->header, "NAXIS4", 1);
+		
+		tmp = Header_get_flt(self->header, "CRPIX3");
+		Header_set_flt(self->header, "CRPIX3", Header_get_flt(self->header, "CRPIX4"));
+		Header_set_flt(self->header, "CRPIX4", tmp);
+		
+		tmp = Header_get_flt(self->header, "CRVAL3");
+		Header_set_flt(self->header, "CRVAL3", Header_get_flt(self->header, "CRVAL4"));
+		Header_set_flt(self->header, "CRVAL4", tmp);
+		
+		tmp = Header_get_flt(self->header, "CDELT3");
+		Header_set_flt(self->header, "CDELT3", Header_get_flt(self->header, "CDELT4"));
+		Header_set_flt(self->header, "CDELT4", tmp);
+		
+		str3 = Header_get_string(self->header, "CTYPE3");
+		str4 = Header_get_string(self->header, "CTYPE4");
+		Header_set_str(self->header, "CTYPE3", String_get(str4));
+		Header_set_str(self->header, "CTYPE4", String_get(str3));
+		String_delete(str3);
+		String_delete(str4);
+		
+		str3 = Header_get_string(self->header, "CUNIT3");
+		str4 = Header_get_string(self->header, "CUNIT4");
+		Header_set_str(self->header, "CUNIT3", String_get(str4));
+		Header_set_str(self->header, "CUNIT4", String_get(str3));
+		String_delete(str3);
+		String_delete(str4);
+	}
+	
+	return;
+}
@@ -44,6 +44,8 @@
 #include "common.h"
 #include "String.h"
 #include "Stack.h"
+#include "BitMask.h"
+#include "VoxelList.h"
 #include "Array_dbl.h"
 #include "Array_siz.h"
 #include "Map.h"
@@ -52,6 +54,7 @@
 #include "Header.h"
 #include "WCS.h"
 #include "Parameter.h"
+#include "Profiler.h"
 
 enum {DESTROY, PRESERVE};
 typedef enum {NOISE_STAT_STD, NOISE_STAT_MAD, NOISE_STAT_GAUSS, NOISE_STAT_MEAN, NOISE_STAT_MEDIAN} noise_stat;
@@ -73,11 +76,17 @@ typedef CLASS DataCube DataCube;
 PUBLIC DataCube  *DataCube_new              (const bool verbosity);
 PUBLIC DataCube  *DataCube_copy             (const DataCube *source);
 PUBLIC DataCube  *DataCube_blank            (const size_t nx, const size_t ny, const size_t nz, const int type, const bool verbosity);
+PUBLIC DataCube  *DataCube_wrap             (void *data, const size_t nx, const size_t ny, const size_t nz, const int type, const Header *header, const bool verbosity);
 PUBLIC void       DataCube_delete           (DataCube *self);
+PUBLIC void       DataCube_set_huge_pages   (const bool enable);
 
 // Public methods
 // Loading/saving from/to FITS format
 PUBLIC void       DataCube_load             (DataCube *self, const char *filename, const Array_siz *region);
+PUBLIC void       DataCube_load_header      (DataCube *self, const char *filename);
+PUBLIC void       DataCube_wait_for_planes  (DataCube *self, const char *filename, const size_t z_max, const unsigned int timeout);
+PUBLIC void       DataCube_convert_single   (DataCube *self);
+PUBLIC void       DataCube_map              (DataCube *self, const char *filename, const Array_siz *region);
 PUBLIC void       DataCube_save             (const DataCube *self, const char *filename, const bool overwrite, const bool preserve);
 
 // Getting basic information
@@ -114,12 +123,13 @@ PUBLIC void       DataCube_fill_flt         (DataCube *self, const double value)
 // Arithmetic operations
 PUBLIC void       DataCube_divide           (DataCube *self, const DataCube *divisor);
 PUBLIC void       DataCube_apply_weights    (DataCube *self, const DataCube *weights);
+PUBLIC void       DataCube_preprocess       (DataCube *self, const DataCube *noise, const DataCube *weights, const bool invert);
 PUBLIC void       DataCube_multiply_const   (DataCube *self, const double factor);
 PUBLIC void       DataCube_add_const        (DataCube *self, const double summand);
 
 // Statistical measurements
 PUBLIC double     DataCube_stat_std         (const DataCube *self, const double value, const size_t cadence, const int range);
-PUBLIC double     DataCube_stat_mad         (const DataCube *self, const double value, const size_t cadence, const int range);
+PUBLIC double     DataCube_stat_mad         (const DataCube *self, const double value, const size_t cadence, const int range, const double tolerance);
 PUBLIC double     DataCube_stat_gauss       (const DataCube *self, const size_t cadence, const int range);
 
 // Noise scaling
@@ -138,6 +148,9 @@ PUBLIC void       DataCube_mask             (const DataCube *self, DataCube *mas
 PUBLIC void       DataCube_mask_8           (const DataCube *self, DataCube *maskCube, const double threshold, const uint8_t value);
 PUBLIC void       DataCube_set_masked       (DataCube *self, const DataCube *maskCube, const double value);
 PUBLIC void       DataCube_set_masked_8     (DataCube *self, const DataCube *maskCube, const double value);
+PUBLIC void       DataCube_mask_bits        (const DataCube *self, BitMask *mask, const double threshold);
+PUBLIC void       DataCube_set_masked_bits  (DataCube *self, const BitMask *mask, const double value);
+PUBLIC size_t     DataCube_copy_bitmask     (DataCube *self, const BitMask *source, const long int value);
 PUBLIC void       DataCube_reset_mask_32    (DataCube *self, const int32_t value);
 PUBLIC void       DataCube_filter_mask_32   (DataCube *self, const Map *filter);
 PUBLIC size_t     DataCube_copy_mask_32     (DataCube *self, const DataCube *source, const int32_t value);
@@ -147,24 +160,30 @@ PUBLIC DataCube  *DataCube_2d_mask          (const DataCube *self);
 
 // Flagging
 PUBLIC void       DataCube_flag_regions     (DataCube *self, const Array_siz *region);
+PUBLIC void       DataCube_flag_regions_bits(const DataCube *self, BitMask *mask, const Array_siz *region);
 PUBLIC void       DataCube_copy_blanked     (DataCube *self, const DataCube *source);
+PUBLIC BitMask   *DataCube_get_blanked_bits (const DataCube *self);
+PUBLIC void       DataCube_copy_blanked_bits(DataCube *self, const BitMask *blanks);
 PUBLIC void       DataCube_autoflag         (const DataCube *self, const double threshold, const unsigned int mode, Array_siz *region);
 PUBLIC size_t     DataCube_flag_infinity    (const DataCube *self, Array_siz *region);
 
 // Source finding
-PUBLIC void       DataCube_run_scfind       (const DataCube *self, DataCube *maskCube, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const int scaleNoise, const noise_stat snStatistic, const int snRange, const size_t snWindowXY, const size_t snWindowZ, const size_t snGridXY, const size_t snGridZ, const bool snInterpol, const time_t start_time, const clock_t start_clock);
-PUBLIC void       DataCube_run_threshold    (const DataCube *self, DataCube *maskCube, const bool absolute, double threshold, const noise_stat method, const int range);
+PUBLIC void       DataCube_run_scfind       (const DataCube *self, BitMask *mask, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const double mad_tolerance, const int scaleNoise, const noise_stat snStatistic, const int snRange, const size_t snWindowXY, const size_t snWindowZ, const size_t snGridXY, const size_t snGridZ, const bool snInterpol, Profiler *profiler, const time_t start_time, const clock_t start_clock);
+PUBLIC void       DataCube_run_scfind_fused (const DataCube *self, BitMask *mask, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const double mad_tolerance, const size_t working_set, Profiler *profiler, const time_t start_time, const clock_t start_clock);
+PUBLIC void       DataCube_run_scfind_device(const DataCube *self, BitMask *mask, const Array_dbl *kernels_spat, const Array_siz *kernels_spec, const double threshold, const double maskScaleXY, const noise_stat method, const int range, const double mad_tolerance, Profiler *profiler, const time_t start_time, const clock_t start_clock);
+PUBLIC void       DataCube_run_threshold    (const DataCube *self, BitMask *mask, const bool absolute, double threshold, const noise_stat method, const int range, const double mad_tolerance);
 
 // Linking
-PUBLIC LinkerPar *DataCube_run_linker       (const DataCube *self, DataCube *mask, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms);
+PUBLIC LinkerPar *DataCube_run_linker       (const DataCube *self, DataCube *mask, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms, const bool parallel);
 
 // Parameterisation
-PUBLIC void       DataCube_parameterise     (const DataCube *self, const DataCube *mask, Catalog *cat, bool use_wcs, bool physical, const char *prefix);
+PUBLIC VoxelList *DataCube_get_voxel_list   (const DataCube *self);
+PUBLIC void       DataCube_parameterise     (const DataCube *self, const DataCube *mask, const VoxelList *voxels, Catalog *cat, bool use_wcs, bool physical, const char *prefix);
 
 // Create moment maps and cubelets
-PUBLIC void       DataCube_create_moments   (const DataCube *self, const DataCube *mask, DataCube **mom0, DataCube **mom1, DataCube **mom2, DataCube **chan, DataCube **snr, const char *obj_name, bool use_wcs, const double threshold, const double rms);
+PUBLIC void       DataCube_create_moments   (const DataCube *self, const DataCube *mask, DataCube **mom0, DataCube **mom1, DataCube **mom2, DataCube **chan, DataCube **snr, DataCube **mask2d, const char *obj_name, bool use_wcs, const double threshold, const double rms);
 PUBLIC DataCube  *DataCube_create_pv        (const DataCube *self, const double x0, const double y0, const double angle, const double step_size, const char *obj_name);
-PUBLIC void       DataCube_create_cubelets  (const DataCube *self, const DataCube *mask, const Catalog *cat, const char *basename, const bool overwrite, bool use_wcs, bool physical, const size_t margin, const double threshold, const size_t offset_z, const Parameter *par);
+PUBLIC void       DataCube_create_cubelets  (const DataCube *self, const DataCube *mask, const VoxelList *voxels, const Catalog *cat, const char *basename, const bool overwrite, bool use_wcs, bool physical, const size_t margin, const double threshold, const size_t offset_z, const Parameter *par);
 
 // WCS
 PUBLIC WCS       *DataCube_extract_wcs      (const DataCube *self);
@@ -173,11 +192,37 @@ PUBLIC WCS       *DataCube_extract_wcs      (const DataCube *self);
 PRIVATE inline size_t DataCube_get_index       (const DataCube *self, const size_t x, const size_t y, const size_t z);
 PRIVATE        void   DataCube_get_xyz         (const DataCube *self, const size_t index, size_t *x, size_t *y, size_t *z);
 PRIVATE        void   DataCube_process_stack   (const DataCube *self, DataCube *mask, Stack *stack, const size_t radius_x, const size_t radius_y, const size_t radius_z, const int32_t label, LinkerPar *lpar, const double rms, const bool pos_pix);
-PRIVATE        void   DataCube_grow_mask_xy    (const DataCube *self, DataCube *mask, const long int src_id, const size_t radius, const long int mask_value, double *f_sum, double *f_min, double *f_max, size_t *n_pix, long int *flag, size_t *x_min, size_t *x_max, size_t *y_min, size_t *y_max, const size_t z_min, const size_t z_max);
+PRIVATE        LinkerPar *DataCube_run_linker_parallel(const DataCube *self, DataCube *mask, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms);
+PRIVATE        bool   DataCube_link_object     (const DataCube *self, DataCube *mask, LinkerPar *lpar, Stack *stack, const size_t index, const int32_t label, const size_t lpar_label, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t min_size_x, const size_t min_size_y, const size_t min_size_z, const size_t min_npix, const double min_fill, const size_t max_size_x, const size_t max_size_y, const size_t max_size_z, const size_t max_npix, const double max_fill, const bool pos_pix, const bool pos_src, const double rms_inv);
+PRIVATE        void   DataCube_linker_merge_neighbours(const DataCube *mask, uint32_t *parent, const size_t index, const size_t radius_x, const size_t radius_y, const size_t radius_z, const size_t z_min, const size_t z_max);
+PRIVATE        void   DataCube_linker_merge    (uint32_t *parent, uint32_t a, uint32_t b);
+PRIVATE        size_t DataCube_dilation_batch  (const size_t *box, const size_t first, const size_t size);
+PRIVATE        size_t *DataCube_dilation_boxes (const DataCube *self, const Catalog *cat, const size_t extent_xy, const size_t extent_z);
+PRIVATE        void   DataCube_dilate_source_xy(const DataCube *self, DataCube *mask, Source *src, const size_t index, const size_t iter_max, const double threshold, const long int *ring, const size_t *ring_start);
+PRIVATE        void   DataCube_dilate_source_z (const DataCube *self, DataCube *mask, Source *src, const size_t index, const size_t iter_max, const double threshold);
+PRIVATE        void   DataCube_set_data_list   (DataCube *self, const size_t *list, const size_t size, const long int value);
 PRIVATE        double DataCube_get_beam_area   (const DataCube *self);
 PRIVATE        void   DataCube_get_wcs_info    (const DataCube *self, String **unit_flux_dens, String **unit_flux, String **label_lon, String **label_lat, String **label_spec, String **ucd_lon, String **ucd_lat, String **ucd_spec, String **unit_lon, String **unit_lat, String **unit_spec, double *beam_area, double *chan_size);
+PRIVATE        void   DataCube_spectral_coordinates(const WCS *wcs, const size_t z_min, const size_t n, double *spectral);
 PRIVATE        void   DataCube_create_src_name (const DataCube *self, String **source_name, const char *prefix, const double longitude, const double latitude, const String *label_lon);
 PRIVATE        void   DataCube_swap_byte_order (const DataCube *self);
+PRIVATE        void   DataCube_read_header     (DataCube *self, FILE *fp);
+PRIVATE        void   DataCube_read_block      (const int fd, char *buffer, size_t size, size_t offset);
+PRIVATE        char  *DataCube_allocate        (const size_t n_planes, const size_t plane_size, const char *source);
+PRIVATE        void   DataCube_convert_int     (DataCube *self, const double bscale, const double bzero);
+PRIVATE inline double DataCube_get_mapped_flt  (const DataCube *self, const size_t x, const size_t y, const size_t z);
+PRIVATE        size_t DataCube_copy_window     (const DataCube *self, const size_t *window, float *array);
+PRIVATE        void   DataCube_get_row_flt     (const DataCube *self, const size_t x_min, const size_t x_max, const size_t y, const size_t z, double *row);
+PRIVATE        void   DataCube_get_row_int     (const DataCube *self, const size_t x_min, const size_t x_max, const size_t y, const size_t z, long int *row);
+PRIVATE        void   DataCube_read_row_flt    (const DataCube *self, const size_t y, const size_t z, double *row);
+PRIVATE        void   DataCube_divide_row      (DataCube *self, const double *divisor, const size_t y, const size_t z);
+PRIVATE        void   DataCube_weight_row      (DataCube *self, const double *weights, const size_t y, const size_t z);
+PRIVATE        void   DataCube_sum_window_columns(const DataCube *self, const size_t *window, const bool squares, const int range, double *sums, size_t *counts);
+PRIVATE        DataCube *DataCube_scfind_slab   (const DataCube *self, const BitMask *mask, const size_t z_min, const size_t z_max, const double replacement, const double sigma);
+PRIVATE        void   DataCube_scfind_filter_slab(const DataCube *slab, const DataCube *self, const BitMask *mask, const BitMask *blanks, BitMask *mask_new, const size_t z_offset, const size_t z_min, const size_t z_max, const Array_siz *kernels_spec, const bool skip_zero, const size_t cadence, double *samples, const double *thresholds);
+PRIVATE        float *DataCube_device_copy   (const float *data, float *buffer, const uint64_t *words, const size_t size, const double replacement);
+PRIVATE        float *DataCube_device_boxcar (const float *input, float **spare, const size_t size, const size_t n_lines, const size_t n_inner, const size_t outer_step, const size_t inner_step, const size_t stride, const size_t length, const size_t radius);
+PRIVATE        void   DataCube_device_mask   (const float *data, const float *smoothed, uint64_t *words, const size_t size, const double threshold);
 
 // TEST
 PUBLIC void DataCube_continuum_flagging(DataCube *self, const char *filename, const int coord_system, const long int radius);
@@ -54,6 +54,8 @@ CLASS Header
 	char   *header;     ///< Pointer to `char` array containing the header block.
 	size_t  size;       ///< Size of header block in bytes.
 	bool    verbosity;  ///< Verbosity level (0 or 1).
+	size_t *index;      ///< Hash table of line numbers of the first occurrence of each keyword (0 = empty slot).
+	size_t  n_slots;    ///< Number of slots in hash table; always a power of 2.
 };
 
 
@@ -92,6 +94,11 @@ PUBLIC Header *Header_new(const char *header, const size_t size, const bool verb
 	self->size      = size;
 	self->header    = header_copy;
 	self->verbosity = verbosity;
+	self->index     = NULL;
+	self->n_slots   = 0;
+	
+	// Create keyword index
+	Header_index_build(self);
 	
 	return self;
 }
@@ -114,7 +121,20 @@ PUBLIC Header *Header_new(const char *header, const size_t size, const bool verb
 PUBLIC Header *Header_copy(const Header *source)
 {
 	check_null(source);
-	return Header_new(source->header, source->size, source->verbosity);
+	
+	// Allocate memory for new Header object
+	Header *self = (Header *)memory(MALLOC, 1, sizeof(Header));
+	
+	// Copy header data and keyword index
+	self->size      = source->size;
+	self->verbosity = source->verbosity;
+	self->n_slots   = source->n_slots;
+	self->header    = (char *)memory(MALLOC, self->size, sizeof(char));
+	self->index     = (size_t *)memory(MALLOC, self->n_slots, sizeof(size_t));
+	memcpy(self->header, source->header, self->size);
+	memcpy(self->index, source->index, self->n_slots * sizeof(size_t));
+	
+	return self;
 }
 
 
@@ -148,6 +168,11 @@ PUBLIC Header *Header_blank(const bool verbosity)
 	// Insert END keyword
 	memcpy(self->header, "END", 3);
 	
+	// Create keyword index
+	self->index   = NULL;
+	self->n_slots = 0;
+	Header_index_build(self);
+	
 	return self;
 }
 
@@ -163,7 +188,11 @@ PUBLIC Header *Header_blank(const bool verbosity)
 
 PUBLIC void Header_delete(Header *self)
 {
-	if(self != NULL) free(self->header);
+	if(self != NULL)
+	{
+		free(self->header);
+		free(self->index);
+	}
 	free(self);
 	return;
 }
@@ -227,18 +256,13 @@ PRIVATE int Header_get_raw(const Header *self, const char *key, char *buffer)
 	check_null(buffer);
 	check_null(key);
 	
-	const char *ptr = self->header;
+	const size_t line = Header_find(self, key);
 	
-	while(ptr < self->header + self->size)
+	if(line)
 	{
-		if(strncmp(ptr, key, strlen(key)) == 0)
-		{
-			memcpy(buffer, ptr + FITS_HEADER_KEY_SIZE, FITS_HEADER_VALUE_SIZE);
-			buffer[FITS_HEADER_VALUE_SIZE] = '\0';
-			return 0;
-		}
-		
-		ptr += FITS_HEADER_LINE_SIZE;
+		memcpy(buffer, self->header + (line - 1) * FITS_HEADER_LINE_SIZE + FITS_HEADER_KEY_SIZE, FITS_HEADER_VALUE_SIZE);
+		buffer[FITS_HEADER_VALUE_SIZE] = '\0';
+		return 0;
 	}
 	
 	warning_verb(self->verbosity, "Header keyword \'%s\' not found.", key);
@@ -469,8 +493,14 @@ PRIVATE int Header_set_raw(Header *self, const char *key, const char *buffer)
 		self->size += FITS_HEADER_BLOCK_SIZE;
 		self->header = (char *)memory_realloc(self->header, self->size, sizeof(char));
 		memset(self->header + self->size - FITS_HEADER_BLOCK_SIZE, ' ', FITS_HEADER_BLOCK_SIZE); // fill with space
+		
+		// Enlarge keyword index if necessary
+		if(self->n_slots < 2 * self->size / FITS_HEADER_LINE_SIZE) Header_index_build(self);
 	}
 	
+	// Locate END keyword in index before it gets overwritten
+	const size_t slot_end = Header_index_slot(self, "END", 3);
+	
 	ptr = self->header;
 	
 	// Add new header keyword at end
@@ -479,6 +509,10 @@ PRIVATE int Header_set_raw(Header *self, const char *key, const char *buffer)
 	memcpy(ptr + (line - 1) * FITS_HEADER_LINE_SIZE + FITS_HEADER_KEY_SIZE, buffer, FITS_HEADER_VALUE_SIZE); // value
 	memcpy(ptr + line * FITS_HEADER_LINE_SIZE, "END", 3); // new end
 	
+	// Update keyword index
+	self->index[slot_end] = line + 1;
+	Header_index_insert(self, line);
+	
 	return 1;
 }
 
@@ -644,18 +678,10 @@ PUBLIC size_t Header_check(const Header *self, const char *key)
 	const size_t size = strlen(key);
 	ensure(size > 0 && size <= FITS_HEADER_KEYWORD_SIZE, ERR_USER_INPUT, "Illegal FITS header keyword: %s.", key);
 	
-	char *ptr = self->header;
-	size_t line = 1;
-	
-	while(ptr < self->header + self->size)
-	{
-		if(strncmp(ptr, key, size) == 0 && (*(ptr + size) == ' ' || *(ptr + size) == '=')) return line;
-		ptr += FITS_HEADER_LINE_SIZE;
-		++line;
-	}
+	const size_t line = Header_find(self, key);
 	
-	warning_verb(self->verbosity, "Header keyword \'%s\' not found.", key);
-	return 0;
+	if(line == 0) warning_verb(self->verbosity, "Header keyword \'%s\' not found.", key);
+	return line;
 }
 
 
@@ -708,16 +734,26 @@ PUBLIC int Header_remove(Header *self, const char *key)
 	size_t line = Header_check(self, key);
 	if(line == 0) return 1;
 	
-	// Header keyword found; shift all subsequent lines up by 1
-	// and fill last line with spaces. Do this repeatedly until
-	// the keyword is no longer found.
-	while(line)
+	// Header keyword found; shift all subsequent lines up, skipping
+	// any further occurrences of the keyword, and fill the lines
+	// freed up at the end with spaces.
+	const size_t size = strlen(key);
+	const size_t n_lines = self->size / FITS_HEADER_LINE_SIZE;
+	size_t target = line - 1;
+	
+	for(size_t i = line; i < n_lines; ++i)
 	{
-		memmove(self->header + (line - 1) * FITS_HEADER_LINE_SIZE, self->header + line * FITS_HEADER_LINE_SIZE, self->size - line * FITS_HEADER_LINE_SIZE);
-		memset(self->header + self->size - FITS_HEADER_LINE_SIZE, ' ', FITS_HEADER_LINE_SIZE);
-		line = Header_check(self, key);
+		const char *card = self->header + i * FITS_HEADER_LINE_SIZE;
+		if(Header_key_size(card) == size && strncmp(card, key, size) == 0) continue;
+		if(target < i) memcpy(self->header + target * FITS_HEADER_LINE_SIZE, card, FITS_HEADER_LINE_SIZE);
+		++target;
 	}
 	
+	memset(self->header + target * FITS_HEADER_LINE_SIZE, ' ', (n_lines - target) * FITS_HEADER_LINE_SIZE);
+	
+	// Line numbers have changed; rebuild keyword index
+	Header_index_build(self);
+	
 	// Check if the header block can be shortened.
 	line = Header_check(self, "END");
 	ensure(line, ERR_USER_INPUT, "END keyword missing from FITS header.");
@@ -985,3 +1021,146 @@ PUBLIC void Header_adjust_wcs_to_subregion(Header *self, const size_t x_min, con
 	
 	return;
 }
+
+
+
+/// @brief Determine size of keyword of header line
+///
+/// Private method for determining the size of the keyword at the
+/// beginning of the specified header line. The keyword is terminated
+/// by the first space or `=` character within the first 9 characters
+/// of the line. If no such character is found or if the line starts
+/// with a space, 0 will be returned.
+///
+/// @param card  Pointer to the start of the header line.
+///
+/// @return Size of the keyword in characters, or 0 if the header line
+///         does not contain a valid keyword.
+
+PRIVATE size_t Header_key_size(const char *card)
+{
+	for(size_t i = 0; i <= FITS_HEADER_KEYWORD_SIZE; ++i)
+	{
+		if(card[i] == ' ' || card[i] == '=') return i;
+	}
+	
+	return 0;
+}
+
+
+
+/// @brief Locate slot of keyword in index
+///
+/// Private method for locating the slot of the hash table in which
+/// the line number of the specified keyword is stored. The hash
+/// table uses open addressing with linear probing. If the keyword
+/// is not in the index, the first empty slot encountered will be
+/// returned instead.
+///
+/// @param self  Object self-reference.
+/// @param key   Pointer to the keyword; need not be `NUL`-terminated.
+/// @param size  Size of the keyword in characters.
+///
+/// @return Index of the slot containing the keyword or of the empty
+///         slot at which the keyword would have to be inserted.
+
+PRIVATE size_t Header_index_slot(const Header *self, const char *key, const size_t size)
+{
+	// FNV-1a hash of keyword
+	size_t hash = 2166136261u;
+	for(size_t i = 0; i < size; ++i) hash = (hash ^ (unsigned char)key[i]) * 16777619u;
+	
+	const size_t mask = self->n_slots - 1;
+	size_t slot = hash & mask;
+	
+	while(self->index[slot])
+	{
+		const char *card = self->header + (self->index[slot] - 1) * FITS_HEADER_LINE_SIZE;
+		if(Header_key_size(card) == size && strncmp(card, key, size) == 0) break;
+		slot = (slot + 1) & mask;
+	}
+	
+	return slot;
+}
+
+
+
+/// @brief Add header line to index
+///
+/// Private method for adding the keyword of the specified header
+/// line to the index. If the keyword is already in the index, the
+/// existing entry will be retained, as it must refer to an earlier
+/// line. Lines without a valid keyword will be ignored. Note that
+/// the hash table must already be large enough to accommodate the
+/// new entry.
+///
+/// @param self  Object self-reference.
+/// @param line  Number of the header line to be added (starting
+///              at 1).
+
+PRIVATE void Header_index_insert(Header *self, const size_t line)
+{
+	const char *card = self->header + (line - 1) * FITS_HEADER_LINE_SIZE;
+	const size_t size = Header_key_size(card);
+	if(size == 0) return;
+	
+	const size_t slot = Header_index_slot(self, card, size);
+	if(self->index[slot] == 0) self->index[slot] = line;
+	
+	return;
+}
+
+
+
+/// @brief Rebuild keyword index
+///
+/// Private method for rebuilding the keyword index from scratch. The
+/// hash table will be resized to at least twice the number of header
+/// lines to keep probe sequences short. For keywords occurring more
+/// than once, e.g. `HISTORY`, only the first occurrence is recorded,
+/// consistent with the behaviour of Header_check().
+///
+/// @param self  Object self-reference.
+
+PRIVATE void Header_index_build(Header *self)
+{
+	const size_t n_lines = self->size / FITS_HEADER_LINE_SIZE;
+	
+	// Resize hash table if necessary
+	size_t n_slots = 64;
+	while(n_slots < 2 * n_lines) n_slots *= 2;
+	
+	if(n_slots != self->n_slots)
+	{
+		self->index = (size_t *)memory_realloc(self->index, n_slots, sizeof(size_t));
+		self->n_slots = n_slots;
+	}
+	
+	// Fill hash table
+	memset(self->index, 0, self->n_slots * sizeof(size_t));
+	for(size_t line = 1; line <= n_lines; ++line) Header_index_insert(self, line);
+	
+	return;
+}
+
+
+
+/// @brief Look up line number of header keyword
+///
+/// Private method for looking up the line number of the first
+/// occurrence of the specified header keyword in the index. Unlike
+/// Header_check(), this will not print a warning message if the
+/// keyword is not found.
+///
+/// @param self  Object self-reference.
+/// @param key   Name of the header keyword to be looked up.
+///
+/// @return Line number of the first occurrence of the specified
+///         keyword, or 0 if the keyword is not found.
+
+PRIVATE size_t Header_find(const Header *self, const char *key)
+{
+	const size_t size = strlen(key);
+	if(size == 0 || size > FITS_HEADER_KEYWORD_SIZE) return 0;
+	return self->index[Header_index_slot(self, key, size)];
+}
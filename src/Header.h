@@ -95,5 +95,10 @@ PUBLIC  void        Header_adjust_wcs_to_subregion(Header *self, const size_t x_
 // Private methods
 PRIVATE int         Header_get_raw    (const Header *self, const char *key, char *buffer);
 PRIVATE int         Header_set_raw    (Header *self, const char *key, const char *buffer);
+PRIVATE size_t      Header_key_size   (const char *card);
+PRIVATE size_t      Header_index_slot (const Header *self, const char *key, const size_t size);
+PRIVATE void        Header_index_insert(Header *self, const size_t line);
+PRIVATE void        Header_index_build(Header *self);
+PRIVATE size_t      Header_find       (const Header *self, const char *key);
 
 #endif
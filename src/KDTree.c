@@ -0,0 +1,436 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (KDTree.c) - Source Finding Application                  //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+
+/// @file   KDTree.c
+/// @date   14/10/2026
+/// @brief  Class implementing a k-d tree for Gaussian kernel density estimation.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "KDTree.h"
+
+/// Maximum number of points stored in a leaf node.
+#define KDTREE_LEAF_SIZE 16
+
+
+
+/// @brief Class implementing a k-d tree for Gaussian kernel density estimation.
+///
+/// The purpose of this class is to provide a k-d tree of points in an
+/// N-dimensional parameter space that allows the sum of a Gaussian
+/// kernel over all points near a given position to be evaluated
+/// efficiently by skipping all nodes beyond a given search radius.
+/// Each node records the range of points it contains and their
+/// bounding box. Leaf nodes have no children.
+
+CLASS KDTree
+{
+	size_t  size;      ///< Number of points stored.
+	size_t  dim;       ///< Dimensionality of parameter space.
+	double *points;    ///< Coordinates of points, reordered by node.
+	size_t  n_nodes;   ///< Number of nodes in tree.
+	size_t  capacity;  ///< Number of nodes memory is allocated for.
+	size_t *first;     ///< Index of first point of each node.
+	size_t *last;      ///< Index of last point + 1 of each node.
+	size_t *left;      ///< Index of left child of each node; 0 = leaf.
+	size_t *right;     ///< Index of right child of each node; 0 = leaf.
+	double *box_min;   ///< Lower bounding box corner of each node.
+	double *box_max;   ///< Upper bounding box corner of each node.
+};
+
+
+
+/// @brief Standard constructor
+///
+/// Standard constructor. Will create a new k-d tree from the specified
+/// points and return a pointer to the newly created object. The points
+/// must be stored consecutively in the array `points`, with `dim`
+/// coordinates per point. The points will be copied, so the original
+/// array can be released again. Note that the destructor will need to
+/// be called explicitly once the object is no longer required.
+///
+/// @param points  Array of point coordinates of size `size * dim`.
+/// @param size    Number of points.
+/// @param dim     Dimensionality of parameter space.
+///
+/// @return Pointer to newly created KDTree object.
+
+PUBLIC KDTree *KDTree_new(const double *points, const size_t size, const size_t dim)
+{
+	// Sanity checks
+	ensure(dim, ERR_USER_INPUT, "Dimensionality of k-d tree must be > 0.");
+	ensure(size == 0 || points != NULL, ERR_NULL_PTR, "No points provided for k-d tree.");
+	
+	KDTree *self = (KDTree *)memory(MALLOC, 1, sizeof(KDTree));
+	
+	self->size     = size;
+	self->dim      = dim;
+	self->points   = NULL;
+	self->n_nodes  = 0;
+	self->capacity = 0;
+	self->first    = NULL;
+	self->last     = NULL;
+	self->left     = NULL;
+	self->right    = NULL;
+	self->box_min  = NULL;
+	self->box_max  = NULL;
+	
+	if(size)
+	{
+		self->points = (double *)memory(MALLOC, size * dim, sizeof(double));
+		memcpy(self->points, points, size * dim * sizeof(double));
+		KDTree_build(self, 0, size);
+	}
+	
+	return self;
+}
+
+
+
+/// @brief Destructor
+///
+/// Destructor. Note that the destructor must be called explicitly
+/// if the object is no longer required. This will release the
+/// memory occupied by the object.
+///
+/// @param self  Object self-reference.
+
+PUBLIC void KDTree_delete(KDTree *self)
+{
+	if(self != NULL)
+	{
+		free(self->points);
+		free(self->first);
+		free(self->last);
+		free(self->left);
+		free(self->right);
+		free(self->box_min);
+		free(self->box_max);
+		free(self);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Sum Gaussian kernel over nearby points
+///
+/// Public method for calculating the sum of exp(-d^2 / 2) over all
+/// points within a distance `d` of `sqrt(radius_squ)` of the specified
+/// position, where `d` is the Euclidean distance. Nodes whose bounding
+/// box lies entirely beyond that radius will be skipped. Points must
+/// therefore have been transformed such that the desired kernel is a
+/// unit Gaussian, e.g. with the Cholesky factor of the inverse of the
+/// kernel's covariance matrix. The method is thread-safe.
+///
+/// @param self        Object self-reference.
+/// @param position    Array of `dim` coordinates of the position.
+/// @param radius_squ  Square of the search radius.
+///
+/// @return Sum of the Gaussian kernel over all points within the
+///         search radius.
+
+PUBLIC double KDTree_kernel_sum(const KDTree *self, const double *position, const double radius_squ)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(position);
+	
+	return self->size ? KDTree_kernel_sum_node(self, 0, position, radius_squ) : 0.0;
+}
+
+
+
+/// @brief Squared distances of nearby points
+///
+/// Public method for determining the squared Euclidean distances of
+/// all points within a distance of `sqrt(radius_squ)` of the specified
+/// position. The squared distances will be appended to the array
+/// `dist_squ`. Nodes whose bounding box lies entirely beyond the
+/// search radius will be skipped. A radius of `INFINITY` will return
+/// the distances of all points. The method is thread-safe as long as
+/// each thread supplies its own array.
+///
+/// @param self        Object self-reference.
+/// @param position    Array of `dim` coordinates of the position.
+/// @param radius_squ  Square of the search radius.
+/// @param dist_squ    Array to which the squared distances will be
+///                    appended.
+
+PUBLIC void KDTree_neighbours(const KDTree *self, const double *position, const double radius_squ, Array_dbl *dist_squ)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(position);
+	check_null(dist_squ);
+	
+	if(self->size) KDTree_neighbours_node(self, 0, position, radius_squ, dist_squ);
+	return;
+}
+
+
+
+/// @brief Return number of points in tree
+///
+/// Public method for returning the number of points stored in the
+/// specified k-d tree.
+///
+/// @param self  Object self-reference.
+///
+/// @return Number of points in tree.
+
+PUBLIC size_t KDTree_get_size(const KDTree *self)
+{
+	check_null(self);
+	return self->size;
+}
+
+
+
+/// @brief Recursively build tree
+///
+/// Private method for creating a new node containing the points from
+/// `first` to `last - 1` and recursively splitting it into two child
+/// nodes at the median along the dimension of greatest extent until
+/// no more than KDTREE_LEAF_SIZE points remain in a node.
+///
+/// @param self   Object self-reference.
+/// @param first  Index of first point of node.
+/// @param last   Index of last point + 1 of node.
+///
+/// @return Index of the newly created node.
+
+PRIVATE size_t KDTree_build(KDTree *self, const size_t first, const size_t last)
+{
+	const size_t dim = self->dim;
+	
+	// Create new node, doubling memory if needed
+	const size_t node = self->n_nodes++;
+	if(self->n_nodes > self->capacity)
+	{
+		self->capacity = self->capacity ? 2 * self->capacity : 64;
+		self->first   = (size_t *)memory_realloc(self->first,   self->capacity, sizeof(size_t));
+		self->last    = (size_t *)memory_realloc(self->last,    self->capacity, sizeof(size_t));
+		self->left    = (size_t *)memory_realloc(self->left,    self->capacity, sizeof(size_t));
+		self->right   = (size_t *)memory_realloc(self->right,   self->capacity, sizeof(size_t));
+		self->box_min = (double *)memory_realloc(self->box_min, self->capacity * dim, sizeof(double));
+		self->box_max = (double *)memory_realloc(self->box_max, self->capacity * dim, sizeof(double));
+	}
+	
+	self->first[node] = first;
+	self->last[node]  = last;
+	self->left[node]  = 0;
+	self->right[node] = 0;
+	
+	// Determine bounding box
+	double *box_min = self->box_min + node * dim;
+	double *box_max = self->box_max + node * dim;
+	memcpy(box_min, self->points + first * dim, dim * sizeof(double));
+	memcpy(box_max, self->points + first * dim, dim * sizeof(double));
+	
+	for(size_t i = first + 1; i < last; ++i)
+	{
+		for(size_t j = 0; j < dim; ++j)
+		{
+			const double value = self->points[i * dim + j];
+			if(value < box_min[j]) box_min[j] = value;
+			else if(value > box_max[j]) box_max[j] = value;
+		}
+	}
+	
+	if(last - first <= KDTREE_LEAF_SIZE) return node;
+	
+	// Split along dimension of greatest extent
+	size_t split = 0;
+	for(size_t j = 1; j < dim; ++j) if(box_max[j] - box_min[j] > box_max[split] - box_min[split]) split = j;
+	
+	// Partially sort points such that the median ends up in the middle (quickselect)
+	const size_t middle = first + (last - first) / 2;
+	size_t lo = first;
+	size_t hi = last - 1;
+	
+	while(lo < hi)
+	{
+		const double pivot = self->points[((lo + hi) / 2) * dim + split];
+		size_t i = lo;
+		size_t j = hi;
+		
+		while(i <= j)
+		{
+			while(self->points[i * dim + split] < pivot) ++i;
+			while(self->points[j * dim + split] > pivot) --j;
+			
+			if(i <= j)
+			{
+				KDTree_swap_points(self, i, j);
+				++i;
+				if(j == 0) break;
+				--j;
+			}
+		}
+		
+		if(middle <= j) hi = j;
+		else if(middle >= i) lo = i;
+		else break;
+	}
+	
+	// Create child nodes (note that the node arrays may get reallocated)
+	const size_t child_left  = KDTree_build(self, first, middle);
+	const size_t child_right = KDTree_build(self, middle, last);
+	self->left[node]  = child_left;
+	self->right[node] = child_right;
+	
+	return node;
+}
+
+
+
+/// @brief Recursively sum Gaussian kernel over node
+///
+/// Private method for summing the Gaussian kernel over all points of
+/// the specified node within the search radius. See KDTree_kernel_sum()
+/// for details.
+///
+/// @param self        Object self-reference.
+/// @param node        Index of the node to be processed.
+/// @param position    Array of `dim` coordinates of the position.
+/// @param radius_squ  Square of the search radius.
+///
+/// @return Sum of the Gaussian kernel over all points of the node
+///         within the search radius.
+
+PRIVATE double KDTree_kernel_sum_node(const KDTree *self, const size_t node, const double *position, const double radius_squ)
+{
+	const size_t dim = self->dim;
+	const double *box_min = self->box_min + node * dim;
+	const double *box_max = self->box_max + node * dim;
+	
+	// Skip node if bounding box beyond search radius
+	double dist_squ = 0.0;
+	for(size_t j = 0; j < dim; ++j)
+	{
+		if(position[j] < box_min[j]) dist_squ += (box_min[j] - position[j]) * (box_min[j] - position[j]);
+		else if(position[j] > box_max[j]) dist_squ += (position[j] - box_max[j]) * (position[j] - box_max[j]);
+	}
+	if(dist_squ > radius_squ) return 0.0;
+	
+	// Recursively process child nodes
+	if(self->left[node]) return KDTree_kernel_sum_node(self, self->left[node], position, radius_squ) + KDTree_kernel_sum_node(self, self->right[node], position, radius_squ);
+	
+	// Leaf node -> sum over points
+	double sum = 0.0;
+	
+	for(const double *ptr = self->points + self->first[node] * dim; ptr < self->points + self->last[node] * dim; ptr += dim)
+	{
+		dist_squ = 0.0;
+		for(size_t j = 0; j < dim; ++j) dist_squ += (ptr[j] - position[j]) * (ptr[j] - position[j]);
+		if(dist_squ <= radius_squ) sum += exp(-0.5 * dist_squ);
+	}
+	
+	return sum;
+}
+
+
+
+/// @brief Recursively collect squared distances of node
+///
+/// Private method for appending the squared distances of all points
+/// of the specified node within the search radius to the array
+/// `dist_squ`. See KDTree_neighbours() for details.
+///
+/// @param self        Object self-reference.
+/// @param node        Index of the node to be processed.
+/// @param position    Array of `dim` coordinates of the position.
+/// @param radius_squ  Square of the search radius.
+/// @param dist_squ    Array to which the squared distances will be
+///                    appended.
+
+PRIVATE void KDTree_neighbours_node(const KDTree *self, const size_t node, const double *position, const double radius_squ, Array_dbl *dist_squ)
+{
+	const size_t dim = self->dim;
+	const double *box_min = self->box_min + node * dim;
+	const double *box_max = self->box_max + node * dim;
+	
+	// Skip node if bounding box beyond search radius
+	double dist = 0.0;
+	for(size_t j = 0; j < dim; ++j)
+	{
+		if(position[j] < box_min[j]) dist += (box_min[j] - position[j]) * (box_min[j] - position[j]);
+		else if(position[j] > box_max[j]) dist += (position[j] - box_max[j]) * (position[j] - box_max[j]);
+	}
+	if(dist > radius_squ) return;
+	
+	// Recursively process child nodes
+	if(self->left[node])
+	{
+		KDTree_neighbours_node(self, self->left[node], position, radius_squ, dist_squ);
+		KDTree_neighbours_node(self, self->right[node], position, radius_squ, dist_squ);
+		return;
+	}
+	
+	// Leaf node -> collect points
+	for(const double *ptr = self->points + self->first[node] * dim; ptr < self->points + self->last[node] * dim; ptr += dim)
+	{
+		dist = 0.0;
+		for(size_t j = 0; j < dim; ++j) dist += (ptr[j] - position[j]) * (ptr[j] - position[j]);
+		if(dist <= radius_squ) Array_dbl_push(dist_squ, dist);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Swap two points
+///
+/// Private method for swapping the coordinates of the two points with
+/// the specified indices.
+///
+/// @param self  Object self-reference.
+/// @param i     Index of first point.
+/// @param j     Index of second point.
+
+PRIVATE void KDTree_swap_points(KDTree *self, const size_t i, const size_t j)
+{
+	for(size_t k = 0; k < self->dim; ++k)
+	{
+		const double tmp = self->points[i * self->dim + k];
+		self->points[i * self->dim + k] = self->points[j * self->dim + k];
+		self->points[j * self->dim + k] = tmp;
+	}
+	
+	return;
+}
@@ -0,0 +1,71 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (KDTree.h) - Source Finding Application                  //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+
+/// @file   KDTree.h
+/// @date   14/10/2026
+/// @brief  Class implementing a k-d tree for Gaussian kernel density estimation (header).
+
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include "common.h"
+#include "Array_dbl.h"
+
+
+// ----------------------------------------------------------------- //
+// Class 'KDTree'                                                    //
+// ----------------------------------------------------------------- //
+// The purpose of this class is to provide a k-d tree of points in   //
+// an N-dimensional parameter space for the efficient evaluation of  //
+// Gaussian kernel density estimates, as used in the reliability     //
+// calculation. Nodes beyond a given search radius are skipped.      //
+// ----------------------------------------------------------------- //
+
+typedef CLASS KDTree KDTree;
+
+// Constructor and destructor
+PUBLIC  KDTree *KDTree_new             (const double *points, const size_t size, const size_t dim);
+PUBLIC  void    KDTree_delete          (KDTree *self);
+
+// Public methods
+PUBLIC  double  KDTree_kernel_sum      (const KDTree *self, const double *position, const double radius_squ);
+PUBLIC  void    KDTree_neighbours      (const KDTree *self, const double *position, const double radius_squ, Array_dbl *dist_squ);
+PUBLIC  size_t  KDTree_get_size        (const KDTree *self);
+
+// Private methods
+PRIVATE size_t  KDTree_build           (KDTree *self, const size_t first, const size_t last);
+PRIVATE double  KDTree_kernel_sum_node (const KDTree *self, const size_t node, const double *position, const double radius_squ);
+PRIVATE void    KDTree_neighbours_node (const KDTree *self, const size_t node, const double *position, const double radius_squ, Array_dbl *dist_squ);
+PRIVATE void    KDTree_swap_points     (KDTree *self, const size_t i, const size_t j);
+
+#endif
@@ -46,6 +46,7 @@
 #endif
 
 #include "LinkerPar.h"
+#include "KDTree.h"
 #include "String.h"
 #include "statistics_dbl.h"
 
@@ -65,6 +66,7 @@
 CLASS LinkerPar
 {
 	size_t  size;          ///< Number of detections currently stored.
+	size_t  capacity;      ///< Number of detections memory is allocated for.
 	int     verbosity;     ///< Verbosity level (0 or 1).
 	size_t *label;         ///< Label of the detection.
 	size_t *n_pix;         ///< Number of pixels contained in detection mask.
@@ -89,6 +91,8 @@ CLASS LinkerPar
 	double *m2;            ///< 2nd moment of flux densities within mask.
 	double *m3;            ///< 3rd moment of flux densities within mask.
 	double *m4;            ///< 4th moment of flux densities within mask.
+	size_t *lookup;        ///< Index + 1 of detection by label; 0 = not present.
+	size_t  lookup_size;   ///< Number of elements in lookup table.
 };
 
 
@@ -110,6 +114,7 @@ PUBLIC LinkerPar *LinkerPar_new(const bool verbosity)
 	
 	self->verbosity = verbosity;
 	self->size = 0;
+	self->capacity = 0;
 	
 	self->label = NULL;
 	self->n_pix = NULL;
@@ -135,6 +140,9 @@ PUBLIC LinkerPar *LinkerPar_new(const bool verbosity)
 	self->m3    = NULL;
 	self->m4    = NULL;
 	
+	self->lookup = NULL;
+	self->lookup_size = 0;
+	
 	return self;
 }
 
@@ -151,7 +159,9 @@ PUBLIC void LinkerPar_delete(LinkerPar *self)
 	if(self != NULL)
 	{
 		self->size = 0;
+		self->capacity = 0;
 		LinkerPar_reallocate_memory(self);
+		free(self->lookup);
 		free(self);
 	}
 	
@@ -197,11 +207,12 @@ PUBLIC void LinkerPar_push(LinkerPar *self, const size_t label, const size_t x,
 	// Increment size counter
 	++self->size;
 	
-	// Allocate additional memory
-	LinkerPar_reallocate_memory(self);
+	// Allocate additional memory if needed
+	if(self->size > self->capacity) LinkerPar_reserve(self, self->capacity ? 2 * self->capacity : 16);
 	
 	// Insert new element at end
 	self->label[self->size - 1] = label;
+	LinkerPar_set_lookup(self, label);
 	self->n_pix[self->size - 1] = 1;
 	self->x_min[self->size - 1] = x;
 	self->x_max[self->size - 1] = x;
@@ -242,11 +253,12 @@ PUBLIC void LinkerPar_pop(LinkerPar *self)
 	check_null(self);
 	ensure(self->size, ERR_FAILURE, "Failed to pop element from empty LinkerPar object.");
 	
-	// Decrement size
-	--self->size;
+	// Remove element from lookup table
+	const size_t label = self->label[self->size - 1];
+	if(self->lookup[label] == self->size) self->lookup[label] = 0;
 	
-	// Reallocate memory
-	LinkerPar_reallocate_memory(self);
+	// Decrement size; memory is retained for the next push
+	--self->size;
 	
 	return;
 }
@@ -329,6 +341,88 @@ PUBLIC void LinkerPar_update_flag(LinkerPar *self, const unsigned char flag)
 }
 
 
+/// @brief Reserve memory for objects
+///
+/// Public method for ensuring that memory for at least `capacity`
+/// objects is allocated, such that no further reallocation will be
+/// required until the list grows beyond that size. Memory is never
+/// released by this method. When a new object is added to a full
+/// list, its capacity will be doubled automatically.
+///
+/// @param self      Object self-reference.
+/// @param capacity  Number of objects to reserve memory for.
+
+PUBLIC void LinkerPar_reserve(LinkerPar *self, const size_t capacity)
+{
+	// Sanity checks
+	check_null(self);
+	
+	if(capacity > self->capacity)
+	{
+		self->capacity = capacity;
+		LinkerPar_reallocate_memory(self);
+	}
+	
+	return;
+}
+
+
+/// @brief Append copy of object from another list
+///
+/// Public method for appending a copy of the object with the specified
+/// `index` in the LinkerPar object `source` to the end of the current
+/// list. The copy will be assigned the new label `label`, while all other
+/// parameters will be copied unchanged. The process will be terminated if
+/// the `index` is out of range.
+///
+/// @param self    Object self-reference.
+/// @param source  LinkerPar object from which to copy the object.
+/// @param index   Index of the object in `source` to be copied.
+/// @param label   Label to be assigned to the copied object.
+
+PUBLIC void LinkerPar_append(LinkerPar *self, const LinkerPar *source, const size_t index, const size_t label)
+{
+	// Sanity checks
+	check_null(self);
+	check_null(source);
+	ensure(index < source->size, ERR_INDEX_RANGE, "Index out of range. Cannot append object to LinkerPar object.");
+	
+	// Increment size counter
+	++self->size;
+	
+	// Allocate additional memory if needed
+	if(self->size > self->capacity) LinkerPar_reserve(self, self->capacity ? 2 * self->capacity : 16);
+	
+	// Copy element to end
+	self->label[self->size - 1] = label;
+	LinkerPar_set_lookup(self, label);
+	self->n_pix[self->size - 1] = source->n_pix[index];
+	self->x_min[self->size - 1] = source->x_min[index];
+	self->x_max[self->size - 1] = source->x_max[index];
+	self->y_min[self->size - 1] = source->y_min[index];
+	self->y_max[self->size - 1] = source->y_max[index];
+	self->z_min[self->size - 1] = source->z_min[index];
+	self->z_max[self->size - 1] = source->z_max[index];
+	#if MEASURE_CENTROID_POSITION
+	self->x_ctr[self->size - 1] = source->x_ctr[index];
+	self->y_ctr[self->size - 1] = source->y_ctr[index];
+	self->z_ctr[self->size - 1] = source->z_ctr[index];
+	#endif
+	self->f_min[self->size - 1] = source->f_min[index];
+	self->f_max[self->size - 1] = source->f_max[index];
+	self->f_sum[self->size - 1] = source->f_sum[index];
+	self->rel  [self->size - 1] = source->rel[index];
+	self->flags[self->size - 1] = source->flags[index];
+	self->fill[self->size - 1]  = source->fill[index];
+	self->m1[self->size - 1]    = source->m1[index];
+	self->m2[self->size - 1]    = source->m2[index];
+	self->m3[self->size - 1]    = source->m3[index];
+	self->m4[self->size - 1]    = source->m4[index];
+	
+	return;
+}
+
+
 /// @brief Get size of object in x, y or z
 ///
 /// Public method for returning the size of the specified object along the specified axis.
@@ -652,9 +746,9 @@ PUBLIC void LinkerPar_print_info(const LinkerPar *self)
 	
 	// Calculate memory usage
 	#if MEASURE_CENTROID_POSITION
-		const double memory_usage = (double)(self->size * (8 * sizeof(size_t) + 12 * sizeof(double) + 1 * sizeof(char)));
+		const double memory_usage = (double)(self->capacity * (8 * sizeof(size_t) + 12 * sizeof(double) + 1 * sizeof(char)) + self->lookup_size * sizeof(size_t));
 	#else
-		const double memory_usage = (double)(self->size * (8 * sizeof(size_t) + 9 * sizeof(double) + 1 * sizeof(char)));
+		const double memory_usage = (double)(self->capacity * (8 * sizeof(size_t) + 9 * sizeof(double) + 1 * sizeof(char)) + self->lookup_size * sizeof(size_t));
 	#endif
 	
 	// Print size and memory information
@@ -670,8 +764,10 @@ PUBLIC void LinkerPar_print_info(const LinkerPar *self)
 /// @brief Return index of element by label
 ///
 /// Private method for finding and returning the index of the element
-/// with the specified label. The process will be terminated if the
-/// requested label does not exist.
+/// with the specified label. The most recently added element, which is
+/// the one queried by the linker, is checked first; all other elements
+/// are looked up in the label table in constant time. The process will
+/// be terminated if the requested label does not exist.
 ///
 /// @param self   Object self-reference.
 /// @param label  Label of the element the index of which is to be returned.
@@ -680,50 +776,77 @@ PUBLIC void LinkerPar_print_info(const LinkerPar *self)
 
 PRIVATE size_t LinkerPar_get_index(const LinkerPar *self, const size_t label)
 {
-	size_t index = 0;
-	while(index < self->size && self->label[index] != label) ++index;
-	ensure(self->size && self->label[index] == label, ERR_USER_INPUT, "Label not found.");
-	return index;
+	if(self->size && self->label[self->size - 1] == label) return self->size - 1;
+	ensure(label < self->lookup_size && self->lookup[label], ERR_USER_INPUT, "Label not found.");
+	return self->lookup[label] - 1;
+}
+
+
+/// @brief Register label of last element in lookup table
+///
+/// Private method for recording the index of the most recently added
+/// element under its label in the lookup table, which is a dense array
+/// indexed by label. The table will be enlarged as needed by doubling
+/// its size. If the same label already exists, the earlier element
+/// will be retained in the table.
+///
+/// @param self   Object self-reference.
+/// @param label  Label of the most recently added element.
+
+PRIVATE void LinkerPar_set_lookup(LinkerPar *self, const size_t label)
+{
+	if(label >= self->lookup_size)
+	{
+		size_t new_size = self->lookup_size ? self->lookup_size : 64;
+		while(new_size <= label) new_size *= 2;
+		self->lookup = (size_t *)memory_realloc(self->lookup, new_size, sizeof(size_t));
+		memset(self->lookup + self->lookup_size, 0, (new_size - self->lookup_size) * sizeof(size_t));
+		self->lookup_size = new_size;
+	}
+	
+	if(!self->lookup[label]) self->lookup[label] = self->size;
+	
+	return;
 }
 
 
 /// @brief Reallocate memory for LinkerPar object
 ///
-/// Private method for reallocating the memory requirements of the
-/// specified LinkerPar object, e.g. as necessitated by a change in
-/// size. If the new size is 0, all memory will be de-allocated and
-/// the pointers will be set to `NULL`.
+/// Private method for reallocating the memory of the specified
+/// LinkerPar object to match its current capacity, e.g. as
+/// necessitated by an increase in size. If the capacity is 0, all
+/// memory will be de-allocated and the pointers will be set to `NULL`.
 ///
 /// @param self  Object self-reference.
 
 PRIVATE void LinkerPar_reallocate_memory(LinkerPar *self)
 {
-	if(self->size)
+	if(self->capacity)
 	{
 		// Reallocate memory
-		self->label = (size_t *)memory_realloc(self->label, self->size, sizeof(size_t));
-		self->n_pix = (size_t *)memory_realloc(self->n_pix, self->size, sizeof(size_t));
-		self->x_min = (size_t *)memory_realloc(self->x_min, self->size, sizeof(size_t));
-		self->x_max = (size_t *)memory_realloc(self->x_max, self->size, sizeof(size_t));
-		self->y_min = (size_t *)memory_realloc(self->y_min, self->size, sizeof(size_t));
-		self->y_max = (size_t *)memory_realloc(self->y_max, self->size, sizeof(size_t));
-		self->z_min = (size_t *)memory_realloc(self->z_min, self->size, sizeof(size_t));
-		self->z_max = (size_t *)memory_realloc(self->z_max, self->size, sizeof(size_t));
+		self->label = (size_t *)memory_realloc(self->label, self->capacity, sizeof(size_t));
+		self->n_pix = (size_t *)memory_realloc(self->n_pix, self->capacity, sizeof(size_t));
+		self->x_min = (size_t *)memory_realloc(self->x_min, self->capacity, sizeof(size_t));
+		self->x_max = (size_t *)memory_realloc(self->x_max, self->capacity, sizeof(size_t));
+		self->y_min = (size_t *)memory_realloc(self->y_min, self->capacity, sizeof(size_t));
+		self->y_max = (size_t *)memory_realloc(self->y_max, self->capacity, sizeof(size_t));
+		self->z_min = (size_t *)memory_realloc(self->z_min, self->capacity, sizeof(size_t));
+		self->z_max = (size_t *)memory_realloc(self->z_max, self->capacity, sizeof(size_t));
 		#if MEASURE_CENTROID_POSITION
-		self->x_ctr = (double *)memory_realloc(self->x_ctr, self->size, sizeof(double));
-		self->y_ctr = (double *)memory_realloc(self->y_ctr, self->size, sizeof(double));
-		self->z_ctr = (double *)memory_realloc(self->z_ctr, self->size, sizeof(double));
+		self->x_ctr = (double *)memory_realloc(self->x_ctr, self->capacity, sizeof(double));
+		self->y_ctr = (double *)memory_realloc(self->y_ctr, self->capacity, sizeof(double));
+		self->z_ctr = (double *)memory_realloc(self->z_ctr, self->capacity, sizeof(double));
 		#endif
-		self->f_min = (double *)memory_realloc(self->f_min, self->size, sizeof(double));
-		self->f_max = (double *)memory_realloc(self->f_max, self->size, sizeof(double));
-		self->f_sum = (double *)memory_realloc(self->f_sum, self->size, sizeof(double));
-		self->rel   = (double *)memory_realloc(self->rel,   self->size, sizeof(double));
-		self->flags = (unsigned char *)memory_realloc(self->flags, self->size, sizeof(unsigned char));
-		self->fill  = (double *)memory_realloc(self->fill,  self->size, sizeof(double));
-		self->m1    = (double *)memory_realloc(self->m1,    self->size, sizeof(double));
-		self->m2    = (double *)memory_realloc(self->m2,    self->size, sizeof(double));
-		self->m3    = (double *)memory_realloc(self->m3,    self->size, sizeof(double));
-		self->m4    = (double *)memory_realloc(self->m4,    self->size, sizeof(double));
+		self->f_min = (double *)memory_realloc(self->f_min, self->capacity, sizeof(double));
+		self->f_max = (double *)memory_realloc(self->f_max, self->capacity, sizeof(double));
+		self->f_sum = (double *)memory_realloc(self->f_sum, self->capacity, sizeof(double));
+		self->rel   = (double *)memory_realloc(self->rel,   self->capacity, sizeof(double));
+		self->flags = (unsigned char *)memory_realloc(self->flags, self->capacity, sizeof(unsigned char));
+		self->fill  = (double *)memory_realloc(self->fill,  self->capacity, sizeof(double));
+		self->m1    = (double *)memory_realloc(self->m1,    self->capacity, sizeof(double));
+		self->m2    = (double *)memory_realloc(self->m2,    self->capacity, sizeof(double));
+		self->m3    = (double *)memory_realloc(self->m3,    self->capacity, sizeof(double));
+		self->m4    = (double *)memory_realloc(self->m4,    self->capacity, sizeof(double));
 	}
 	else
 	{
@@ -849,14 +972,29 @@ PRIVATE void LinkerPar_reallocate_memory(LinkerPar *self)
 /// @param tolerance      Skellam parameter tolerance for convergence of the auto-kernel
 ///                       algorithm. The algorithm converges when the absolute value of
 ///                       the median of the Skellam distribution drops below this value.
+/// @param kde_tolerance  If greater than 0, kernel density estimation will be approximate,
+///                       neglecting all detections for which the Gaussian kernel has
+///                       dropped below this fraction of its peak. This allows distant
+///                       detections to be skipped by means of a k-d tree. If set to 0,
+///                       the exact kernel density will be calculated for all pairs of
+///                       detections.
+/// @param cache_limit    Maximum memory in bytes to be used by the auto-kernel algorithm
+///                       for caching the distances between detections across iterations.
+///                       If the cache would exceed this limit, distances will instead be
+///                       recalculated in each iteration. Set to 0 to disable caching.
+///                       Note that with caching enabled the kernel is rescaled by
+///                       dividing the cached distances by the variance scale factor
+///                       rather than by inverting the rescaled covariance matrix, so
+///                       the Skellam parameters can differ in the last digits.
 ///
 /// @return Covariance matrix from the negative detections.
 
-PUBLIC Matrix *LinkerPar_reliability(LinkerPar *self, const Array_siz *rel_par_space, double *scale_kernel, const double fmin, const size_t minpix, const Table *rel_cat, Array_dbl **skellam, const bool autokernel, const int iterations, const double tolerance)
+PUBLIC Matrix *LinkerPar_reliability(LinkerPar *self, const Array_siz *rel_par_space, double *scale_kernel, const double fmin, const size_t minpix, const Table *rel_cat, Array_dbl **skellam, const bool autokernel, const int iterations, const double tolerance, const double kde_tolerance, const size_t cache_limit)
 {
 	// Sanity checks
 	check_null(self);
 	ensure(self->size, ERR_NO_SRC_FOUND, "No sources left after linking. Cannot proceed.");
+	ensure(kde_tolerance >= 0.0 && kde_tolerance < 1.0, ERR_USER_INPUT, "Kernel density tolerance must be in the range of 0 to 1.");
 	ensure(skellam != NULL || !autokernel, ERR_USER_INPUT, "With kernel auto-scaling enabled, skellam must not be NULL.");
 	if(*scale_kernel <= 0.0)
 	{
@@ -1065,7 +1203,7 @@ PUBLIC Matrix *LinkerPar_reliability(LinkerPar *self, const Array_siz *rel_par_s
 		ensure(covar_inv != NULL, ERR_FAILURE, "Covariance matrix is not invertible; cannot measure reliability.\n       Ensure that there are enough negative detections.");
 		
 		// Create Skellam array if requested
-		if(skellam != NULL) LinkerPar_calculate_skellam(skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, scal_fact);
+		if(skellam != NULL) LinkerPar_calculate_skellam(skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, scal_fact, kde_tolerance);
 	}
 	else
 	{
@@ -1079,13 +1217,41 @@ PUBLIC Matrix *LinkerPar_reliability(LinkerPar *self, const Array_siz *rel_par_s
 		const double scale_default = *scale_kernel;
 		const double step_size = 0.02;
 		
+		// Cache of squared Mahalanobis distances for the unscaled covariance matrix
+		// NOTE: Scaling the kernel merely divides these distances by the variance
+		//       scale factor, so they need not be recalculated on every iteration.
+		//       In approximate mode the cache covers up to twice the current kernel
+		//       scale and is rebuilt whenever the kernel outgrows it.
+		const double cache_radius_squ = (kde_tolerance > 0.0) ? -2.0 * log(kde_tolerance) : INFINITY;
+		Array_dbl **cache = (Array_dbl **)memory(CALLOC, 2 * n_neg, sizeof(Array_dbl *));
+		Matrix *covar_inv_unscaled = Matrix_invert(covar);
+		ensure(covar_inv_unscaled != NULL, ERR_FAILURE, "Covariance matrix is not invertible; cannot measure reliability.\n       Ensure that there are enough negative detections.");
+		bool use_cache = cache_limit > 0;
+		double variance = 1.0;
+		double cache_variance = 0.0;
+		
 		while(iter < iterations && skellam_med > tolerance)
 		{
 			// Calculate skellam array
 			Matrix_mul_scalar(covar, pow(scale / scale_old, 2));  // NOTE: Variance = sigma^2, hence scale_kernel^2 here.
-			covar_inv = Matrix_invert(covar);
-			ensure(covar_inv != NULL, ERR_FAILURE, "Covariance matrix is not invertible; cannot measure reliability.\n       Ensure that there are enough negative detections.");
-			LinkerPar_calculate_skellam(skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, scal_fact);
+			variance *= pow(scale / scale_old, 2);
+			
+			if(use_cache && variance > cache_variance)
+			{
+				cache_variance = (kde_tolerance > 0.0) ? 4.0 * variance : INFINITY;
+				use_cache = LinkerPar_cache_distances(cache, par_pos, par_neg, dim, n_pos, n_neg, covar_inv_unscaled, cache_radius_squ * cache_variance, cache_limit);
+				if(!use_cache) message("  Distance cache would exceed %zu MB; recalculating distances.", cache_limit / MEGABYTE);
+			}
+			
+			if(use_cache) LinkerPar_cached_skellam(skellam, cache, n_neg, variance, cache_radius_squ, scal_fact);
+			else
+			{
+				Matrix_delete(covar_inv);
+				covar_inv = Matrix_invert(covar);
+				ensure(covar_inv != NULL, ERR_FAILURE, "Covariance matrix is not invertible; cannot measure reliability.\n       Ensure that there are enough negative detections.");
+				Array_dbl_delete(*skellam);
+				LinkerPar_calculate_skellam(skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, scal_fact, kde_tolerance);
+			}
 			
 			// Calculate new median
 			skellam_med = fabs(median_dbl((double *)Array_dbl_get_ptr(*skellam), Array_dbl_get_size(*skellam), false));
@@ -1113,11 +1279,53 @@ PUBLIC Matrix *LinkerPar_reliability(LinkerPar *self, const Array_siz *rel_par_s
 			*scale_kernel = scale_default;
 			
 			Matrix_mul_scalar(covar, pow(*scale_kernel / scale_old, 2));
-			covar_inv = Matrix_invert(covar);
-			ensure(covar_inv != NULL, ERR_FAILURE, "Covariance matrix is not invertible; cannot measure reliability.\n       Ensure that there are enough negative detections.");
-			if(skellam != NULL) LinkerPar_calculate_skellam(skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, scal_fact);
+			variance *= pow(*scale_kernel / scale_old, 2);
+			
+			if(use_cache && variance <= cache_variance) LinkerPar_cached_skellam(skellam, cache, n_neg, variance, cache_radius_squ, scal_fact);
+			else
+			{
+				Matrix_delete(covar_inv);
+				covar_inv = Matrix_invert(covar);
+				ensure(covar_inv != NULL, ERR_FAILURE, "Covariance matrix is not invertible; cannot measure reliability.\n       Ensure that there are enough negative detections.");
+				Array_dbl_delete(*skellam);
+				LinkerPar_calculate_skellam(skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, scal_fact, kde_tolerance);
+			}
 			warning("Auto-kernel failed to converge, defaulting to kernel scale of %.3f.", *scale_kernel);
 		}
+		
+		// Invert final covariance matrix
+		Matrix_delete(covar_inv);
+		covar_inv = Matrix_invert(covar);
+		ensure(covar_inv != NULL, ERR_FAILURE, "Covariance matrix is not invertible; cannot measure reliability.\n       Ensure that there are enough negative detections.");
+		
+		// Release distance cache
+		for(size_t i = 0; i < 2 * n_neg; ++i) Array_dbl_delete(cache[i]);
+		free(cache);
+		Matrix_delete(covar_inv_unscaled);
+	}
+	
+	// Set up k-d trees of whitened parameters if approximate kernel density estimation requested
+	const double radius_squ = (kde_tolerance > 0.0) ? -2.0 * log(kde_tolerance) : 0.0;
+	double *white_pos = NULL;
+	double *soa_pos = NULL;
+	double *soa_neg = NULL;
+	KDTree *tree_pos = NULL;
+	KDTree *tree_neg = NULL;
+	
+	if(kde_tolerance > 0.0)
+	{
+		message("Using approximate kernel density with cut-off at %.2f sigma.", sqrt(radius_squ));
+		double *white_neg = LinkerPar_whiten(par_neg, n_neg, dim, covar_inv);
+		white_pos = LinkerPar_whiten(par_pos, n_pos, dim, covar_inv);
+		tree_neg = KDTree_new(white_neg, n_neg, dim);
+		tree_pos = KDTree_new(white_pos, n_pos, dim);
+		free(white_neg);
+	}
+	else
+	{
+		// Otherwise rearrange parameters for batched kernel density estimation
+		soa_neg = LinkerPar_transpose(par_neg, n_neg, dim);
+		soa_pos = LinkerPar_transpose(par_pos, n_pos, dim);
 	}
 	
 	// Loop over all positive detections to measure their reliability
@@ -1125,57 +1333,43 @@ PUBLIC Matrix *LinkerPar_reliability(LinkerPar *self, const Array_siz *rel_par_s
 	size_t progress = 0;
 	message("");
 	
-	#pragma omp parallel
+	// Loop over all positive detections to calculate their reliability
+	#pragma omp parallel for schedule(static)
+	for(size_t i = 0; i < n_pos; ++i)
 	{
-		Matrix *vector = Matrix_new(dim, 1);
+		#pragma omp critical
+		if(++progress % cadence == 0 || progress == n_pos) progress_bar("Progress: ", progress, n_pos);
 		
-		// Loop over all positive detections to calculate their reliability
-		#pragma omp for schedule(static)
-		for(size_t i = 0; i < n_pos; ++i)
+		// Only process sources above fmin and minpix
+		if(self->f_sum[idx_pos[i]] * self->f_sum[idx_pos[i]] / self->n_pix[idx_pos[i]] > fmin_squared && self->n_pix[idx_pos[i]] > minpix)
 		{
-			#pragma omp critical
-			if(++progress % cadence == 0 || progress == n_pos) progress_bar("Progress: ", progress, n_pos);
+			double pdf_neg_sum = 0.0;
+			double pdf_pos_sum = 0.0;
 			
-			// Only process sources above fmin and minpix
-			if(self->f_sum[idx_pos[i]] * self->f_sum[idx_pos[i]] / self->n_pix[idx_pos[i]] > fmin_squared && self->n_pix[idx_pos[i]] > minpix)
+			if(tree_pos != NULL)
 			{
-				// Multivariate kernel density estimation for negative detections
-				double pdf_neg_sum = 0.0;
-				
-				for(double *ptr = par_neg; ptr < par_neg + n_neg * dim;)
-				{
-					// Set up relative position vector
-					for(int j = 0; j < dim; ++j)
-					{
-						Matrix_set_value_nocheck(vector, j, 0, *ptr - par_pos[dim * i + j]);
-						++ptr;
-					}
-					pdf_neg_sum += Matrix_prob_dens_nocheck(covar_inv, vector, scal_fact);
-				}
-				
-				// Multivariate kernel density estimation for positive detections
-				double pdf_pos_sum = 0.0;
-				
-				for(double *ptr = par_pos; ptr < par_pos + n_pos * dim;)
-				{
-					// Set up relative position vector
-					for(int j = 0; j < dim; ++j)
-					{
-						Matrix_set_value_nocheck(vector, j, 0, *ptr - par_pos[dim * i + j]);
-						++ptr;
-					}
-					pdf_pos_sum += Matrix_prob_dens_nocheck(covar_inv, vector, scal_fact);
-				}
-				
-				// Determine reliability
-				self->rel[idx_pos[i]] = pdf_pos_sum > pdf_neg_sum ? (pdf_pos_sum - pdf_neg_sum) / pdf_pos_sum : 0.0;
+				// Approximate kernel density estimation from nearby detections only
+				pdf_neg_sum = scal_fact * KDTree_kernel_sum(tree_neg, white_pos + dim * i, radius_squ);
+				pdf_pos_sum = scal_fact * KDTree_kernel_sum(tree_pos, white_pos + dim * i, radius_squ);
 			}
+			else
+			{
+				// Multivariate kernel density estimation for negative and positive detections
+				pdf_neg_sum = Matrix_prob_dens_sum(covar_inv, soa_neg, n_neg, par_pos + dim * i, scal_fact);
+				pdf_pos_sum = Matrix_prob_dens_sum(covar_inv, soa_pos, n_pos, par_pos + dim * i, scal_fact);
+			}
+			
+			// Determine reliability
+			self->rel[idx_pos[i]] = pdf_pos_sum > pdf_neg_sum ? (pdf_pos_sum - pdf_neg_sum) / pdf_pos_sum : 0.0;
 		}
-		
-		Matrix_delete(vector);
 	}
 	
 	// Release memory again
+	KDTree_delete(tree_pos);
+	KDTree_delete(tree_neg);
+	free(white_pos);
+	free(soa_pos);
+	free(soa_neg);
 	Matrix_delete(covar_inv);
 	free(par_pos);
 	free(par_neg);
@@ -1822,64 +2016,319 @@ PUBLIC void LinkerPar_skellam_plot(Array_dbl *skellam, const char *filename, con
 /// determined from the specified covariance matrix. An additional `scale` factor
 /// can be specified to normalise the integral under the Gaussian kernel.
 ///
-/// @param skellam    Pointer to skellam array.
-/// @param covar_inv  Pointer to inverse of covariance matrix. Used to set the size of
-///                   the Gaussian kernel. Can be calculated with Matrix_invert().
-/// @param pos        Array of parameters for positive detections. Must be of length
-///                   `dim * n_pos`.
-/// @param neg        Array of parameters for negative detections. Must be of length
-///                   `dim * n_neg`.
+/// @param skellam        Pointer to skellam array.
+/// @param covar_inv      Pointer to inverse of covariance matrix. Used to set the size of
+///                       the Gaussian kernel. Can be calculated with Matrix_invert().
+/// @param pos            Array of parameters for positive detections. Must be of length
+///                       `dim * n_pos`.
+/// @param neg            Array of parameters for negative detections. Must be of length
+///                       `dim * n_neg`.
+/// @param dim            Dimensionality of parameter space.
+/// @param n_pos          Number of positive detections.
+/// @param n_neg          Number of negative detections.
+/// @param scale          Scale factor for normalisation.
+/// @param kde_tolerance  If greater than 0, use approximate kernel density estimation
+///                       by neglecting detections for which the kernel has dropped below
+///                       this fraction of its peak. See LinkerPar_reliability().
+
+PUBLIC void LinkerPar_calculate_skellam(Array_dbl **skellam, const Matrix *covar_inv, double *pos, double *neg, const int dim, const size_t n_pos, const size_t n_neg, const double scale, const double kde_tolerance)
+{
+	// Calculate skellam
+	*skellam = Array_dbl_new(n_neg);
+	
+	// Set up k-d trees of whitened parameters if approximate kernel density estimation requested
+	const double radius_squ = (kde_tolerance > 0.0) ? -2.0 * log(kde_tolerance) : 0.0;
+	double *white_neg = NULL;
+	double *soa_pos = NULL;
+	double *soa_neg = NULL;
+	KDTree *tree_pos = NULL;
+	KDTree *tree_neg = NULL;
+	
+	if(kde_tolerance > 0.0)
+	{
+		double *white_pos = LinkerPar_whiten(pos, n_pos, dim, covar_inv);
+		white_neg = LinkerPar_whiten(neg, n_neg, dim, covar_inv);
+		tree_pos = KDTree_new(white_pos, n_pos, dim);
+		tree_neg = KDTree_new(white_neg, n_neg, dim);
+		free(white_pos);
+	}
+	else
+	{
+		// Otherwise rearrange parameters for batched kernel density estimation
+		soa_pos = LinkerPar_transpose(pos, n_pos, dim);
+		soa_neg = LinkerPar_transpose(neg, n_neg, dim);
+	}
+	
+	// Loop over all negative sources to derive Skellam distribution
+	#pragma omp parallel for schedule(static)
+	for(size_t i = 0; i < n_neg; ++i)
+	{
+		double pdf_neg_sum = 0.0;
+		double pdf_pos_sum = 0.0;
+		
+		if(tree_neg != NULL)
+		{
+			// Approximate kernel density estimation from nearby detections only
+			pdf_neg_sum = scale * KDTree_kernel_sum(tree_neg, white_neg + dim * i, radius_squ);
+			pdf_pos_sum = scale * KDTree_kernel_sum(tree_pos, white_neg + dim * i, radius_squ);
+		}
+		else
+		{
+			// Multivariate kernel density estimation for negative and positive detections
+			pdf_neg_sum = Matrix_prob_dens_sum(covar_inv, soa_neg, n_neg, neg + dim * i, scale);
+			pdf_pos_sum = Matrix_prob_dens_sum(covar_inv, soa_pos, n_pos, neg + dim * i, scale);
+		}
+		
+		// Determine normalised Skellam parameter S = (P - N) / SQRT(P + N)
+		Array_dbl_set(*skellam, i, (pdf_pos_sum - pdf_neg_sum) / sqrt(pdf_pos_sum + pdf_neg_sum));
+	}
+	
+	KDTree_delete(tree_pos);
+	KDTree_delete(tree_neg);
+	free(white_neg);
+	free(soa_pos);
+	free(soa_neg);
+	
+	return;
+}
+
+
+
+/// @brief Cache squared Mahalanobis distances between detections
+///
+/// Public function for determining the squared Mahalanobis distances,
+/// with respect to the inverse covariance matrix `covar_inv`, of all
+/// positive and negative detections from each negative detection and
+/// storing them in the array `cache`, which must be of size `2 * n_neg`.
+/// For the negative detection `i`, the distances to all negative
+/// detections will be stored in `cache[2 * i]` and those to all positive
+/// detections in `cache[2 * i + 1]`. Only distances of up to
+/// `sqrt(radius_squ)` will be retained, and a radius of `INFINITY` will
+/// retain all distances. In the latter case, the distances are stored
+/// in the original order of the detections and calculated with the same
+/// arithmetic as Matrix_vMv_nocheck(), so that the Skellam distribution
+/// derived from them is identical to that from
+/// LinkerPar_calculate_skellam() for the same covariance matrix. Any
+/// arrays already present in the cache will be deleted first. As the squared distances scale with the inverse of the
+/// kernel variance, the cache allows the Skellam distribution to be
+/// recalculated for any kernel scale without having to revisit all pairs
+/// of detections; see LinkerPar_cached_skellam(). If the cache would
+/// exceed `limit` bytes, it will be cleared and `false` returned.
+///
+/// @param cache      Array of `2 * n_neg` pointers to hold the cached
+///                   distances.
+/// @param pos        Array of parameters for positive detections. Must be
+///                   of length `dim * n_pos`.
+/// @param neg        Array of parameters for negative detections. Must be
+///                   of length `dim * n_neg`.
 /// @param dim        Dimensionality of parameter space.
 /// @param n_pos      Number of positive detections.
 /// @param n_neg      Number of negative detections.
-/// @param scale      Scale factor for normalisation.
+/// @param covar_inv  Inverse of covariance matrix defining the distances.
+/// @param radius_squ Square of the largest distance to be retained.
+/// @param limit      Maximum size of the cache in bytes.
+///
+/// @return `true` if the cache was successfully filled, `false` if the
+///         size limit was exceeded.
 
-PUBLIC void LinkerPar_calculate_skellam(Array_dbl **skellam, const Matrix *covar_inv, double *pos, double *neg, const int dim, const size_t n_pos, const size_t n_neg, const double scale)
+PUBLIC bool LinkerPar_cache_distances(Array_dbl **cache, const double *pos, const double *neg, const int dim, const size_t n_pos, const size_t n_neg, const Matrix *covar_inv, const double radius_squ, const size_t limit)
 {
-	// Calculate skellam
-	*skellam = Array_dbl_new(n_neg);
+	// Clear existing cache
+	for(size_t i = 0; i < 2 * n_neg; ++i)
+	{
+		Array_dbl_delete(cache[i]);
+		cache[i] = NULL;
+	}
 	
-	#pragma omp parallel
+	// Check size limit in advance if all distances requested
+	if(isinf(radius_squ))
 	{
-		Matrix *vector = Matrix_new(dim, 1);
+		if((n_pos + n_neg) * n_neg > limit / sizeof(double)) return false;
+		
+		// Calculate all distances exactly, as in LinkerPar_calculate_skellam()
+		double *soa_pos = LinkerPar_transpose(pos, n_pos, dim);
+		double *soa_neg = LinkerPar_transpose(neg, n_neg, dim);
 		
-		// Loop over all negative sources to derive Skellam distribution
-		#pragma omp for schedule(static)
+		#pragma omp parallel for schedule(static)
 		for(size_t i = 0; i < n_neg; ++i)
 		{
-			// Multivariate kernel density estimation for negative detections
-			double pdf_neg_sum = 0.0;
-			
-			for(double *ptr = neg; ptr < neg + n_neg * dim;)
-			{
-				// Set up relative position vector
-				for(int j = 0; j < dim; ++j)
-				{
-					Matrix_set_value_nocheck(vector, j, 0, *ptr - neg[dim * i + j]);
-					++ptr;
-				}
-				pdf_neg_sum += Matrix_prob_dens_nocheck(covar_inv, vector, scale);
-			}
-			
-			// Multivariate kernel density estimation for positive detections
-			double pdf_pos_sum = 0.0;
-			
-			for(double *ptr = pos; ptr < pos + n_pos * dim;)
+			cache[2 * i]     = Array_dbl_new(n_neg);
+			cache[2 * i + 1] = Array_dbl_new(n_pos);
+			// NOTE: Casting constness away, as the arrays are filled in place.
+			Matrix_vMv_points(covar_inv, soa_neg, n_neg, neg + dim * i, (double *)Array_dbl_get_ptr(cache[2 * i]));
+			Matrix_vMv_points(covar_inv, soa_pos, n_pos, neg + dim * i, (double *)Array_dbl_get_ptr(cache[2 * i + 1]));
+		}
+		
+		free(soa_pos);
+		free(soa_neg);
+		return true;
+	}
+	
+	// Set up k-d trees of whitened parameters
+	double *white_pos = LinkerPar_whiten(pos, n_pos, dim, covar_inv);
+	double *white_neg = LinkerPar_whiten(neg, n_neg, dim, covar_inv);
+	KDTree *tree_pos = KDTree_new(white_pos, n_pos, dim);
+	KDTree *tree_neg = KDTree_new(white_neg, n_neg, dim);
+	free(white_pos);
+	
+	size_t size = 0;
+	bool success = true;
+	
+	#pragma omp parallel for schedule(dynamic)
+	for(size_t i = 0; i < n_neg; ++i)
+	{
+		bool proceed;
+		#pragma omp atomic read
+		proceed = success;
+		if(!proceed) continue;
+		
+		cache[2 * i]     = Array_dbl_new(0);
+		cache[2 * i + 1] = Array_dbl_new(0);
+		KDTree_neighbours(tree_neg, white_neg + dim * i, radius_squ, cache[2 * i]);
+		KDTree_neighbours(tree_pos, white_neg + dim * i, radius_squ, cache[2 * i + 1]);
+		
+		#pragma omp critical(LinkerPar_cache_distances)
+		{
+			size += Array_dbl_get_size(cache[2 * i]) + Array_dbl_get_size(cache[2 * i + 1]);
+			if(size > limit / sizeof(double))
 			{
-				// Set up relative position vector
-				for(int j = 0; j < dim; ++j)
-				{
-					Matrix_set_value_nocheck(vector, j, 0, *ptr - neg[dim * i + j]);
-					++ptr;
-				}
-				pdf_pos_sum += Matrix_prob_dens_nocheck(covar_inv, vector, scale);
+				#pragma omp atomic write
+				success = false;
 			}
+		}
+	}
+	
+	KDTree_delete(tree_pos);
+	KDTree_delete(tree_neg);
+	free(white_neg);
+	
+	// Clear cache again if size limit exceeded
+	if(!success)
+	{
+		for(size_t i = 0; i < 2 * n_neg; ++i)
+		{
+			Array_dbl_delete(cache[i]);
+			cache[i] = NULL;
+		}
+	}
+	
+	return success;
+}
+
+
+
+/// @brief Calculate Skellam distribution from cached distances
+///
+/// Public function for calculating the Skellam distribution from the
+/// squared Mahalanobis distances cached by LinkerPar_cache_distances().
+/// The kernel variance is given relative to that of the covariance
+/// matrix used to fill the cache, i.e. `variance` is the square of the
+/// kernel scale factor applied since. Only detections within a scaled
+/// distance of `sqrt(radius_squ)` will contribute, which must not exceed
+/// the radius of the cache. Any existing Skellam array will be deleted.
+///
+/// @param skellam     Pointer to skellam array.
+/// @param cache       Array of `2 * n_neg` cached distance arrays.
+/// @param n_neg       Number of negative detections.
+/// @param variance    Kernel variance relative to that of the cache.
+/// @param radius_squ  Square of the search radius for the currently
+///                    scaled kernel. Set to `INFINITY` for exact
+///                    kernel density estimation.
+/// @param scale       Scale factor for normalisation.
+
+PUBLIC void LinkerPar_cached_skellam(Array_dbl **skellam, Array_dbl * const *cache, const size_t n_neg, const double variance, const double radius_squ, const double scale)
+{
+	Array_dbl_delete(*skellam);
+	*skellam = Array_dbl_new(n_neg);
+	
+	const double limit = radius_squ * variance;
+	
+	#pragma omp parallel for schedule(static)
+	for(size_t i = 0; i < n_neg; ++i)
+	{
+		double pdf_sum[2] = {0.0, 0.0};
+		
+		for(size_t j = 0; j < 2; ++j)
+		{
+			const double *ptr = Array_dbl_get_ptr(cache[2 * i + j]);
+			const double *end = ptr + Array_dbl_get_size(cache[2 * i + j]);
 			
-			// Determine normalised Skellam parameter S = (P - N) / SQRT(P + N)
-			Array_dbl_set(*skellam, i, (pdf_pos_sum - pdf_neg_sum) / sqrt(pdf_pos_sum + pdf_neg_sum));
+			for(; ptr < end; ++ptr) if(*ptr <= limit) pdf_sum[j] += scale * exp(-0.5 * (*ptr / variance));
 		}
 		
-		Matrix_delete(vector);
+		// Determine normalised Skellam parameter S = (P - N) / SQRT(P + N)
+		Array_dbl_set(*skellam, i, (pdf_sum[1] - pdf_sum[0]) / sqrt(pdf_sum[1] + pdf_sum[0]));
 	}
+	
 	return;
 }
+
+
+
+/// @brief Rearrange parameters into structure-of-arrays layout
+///
+/// Private function for copying the specified parameters, stored as
+/// `n` consecutive vectors of `dim` elements each, into a newly
+/// allocated array in which all `n` values of the first parameter
+/// are followed by all values of the second parameter, etc. This is
+/// the layout expected by Matrix_prob_dens_sum(). The user will be
+/// responsible for releasing the returned array.
+///
+/// @param par  Array of parameters of size `n * dim`.
+/// @param n    Number of parameter vectors.
+/// @param dim  Number of parameters per vector.
+///
+/// @return Rearranged copy of the parameter array.
+
+PRIVATE double *LinkerPar_transpose(const double *par, const size_t n, const int dim)
+{
+	double *result = (double *)memory(MALLOC, n * dim, sizeof(double));
+	
+	for(size_t i = 0; i < n; ++i)
+	{
+		for(int j = 0; j < dim; ++j) result[j * n + i] = par[dim * i + j];
+	}
+	
+	return result;
+}
+
+
+
+/// @brief Transform parameters into whitened space
+///
+/// Private function for transforming the specified parameters into a
+/// space in which the Gaussian kernel described by the inverse
+/// covariance matrix `covar_inv` becomes a unit Gaussian. This is
+/// achieved by multiplying each parameter vector, p, by L^T, where L
+/// is the Cholesky factor of `covar_inv`, such that the Mahalanobis
+/// distance between two detections turns into their Euclidean
+/// distance. The process will be terminated if `covar_inv` is not
+/// positive-definite. The user will assume ownership of the returned
+/// array and must release its memory when no longer needed.
+///
+/// @param par        Array of parameters. Must be of length `dim * n`.
+/// @param n          Number of detections.
+/// @param dim        Dimensionality of parameter space.
+/// @param covar_inv  Inverse of covariance matrix of Gaussian kernel.
+///
+/// @return Array of whitened parameters of length `dim * n`.
+
+PRIVATE double *LinkerPar_whiten(const double *par, const size_t n, const int dim, const Matrix *covar_inv)
+{
+	Matrix *chol = Matrix_cholesky(covar_inv);
+	ensure(chol != NULL, ERR_FAILURE, "Covariance matrix is not positive-definite; cannot measure reliability.");
+	
+	double *white = (double *)memory(CALLOC, n * dim, sizeof(double));
+	
+	for(size_t i = 0; i < n; ++i)
+	{
+		for(int k = 0; k < dim; ++k)
+		{
+			for(int j = k; j < dim; ++j) white[i * dim + k] += Matrix_get_value_nocheck(chol, j, k) * par[i * dim + j];
+		}
+	}
+	
+	Matrix_delete(chol);
+	
+	return white;
+}
@@ -75,10 +75,12 @@ PUBLIC  void       LinkerPar_delete       (LinkerPar *self);
 
 // Public methods
 PUBLIC  size_t     LinkerPar_get_size     (const LinkerPar *self);
+PUBLIC  void       LinkerPar_reserve      (LinkerPar *self, const size_t capacity);
 PUBLIC  void       LinkerPar_push         (LinkerPar *self, const size_t label, const size_t x, const size_t y, const size_t z, const double flux, const unsigned char flag);
 PUBLIC  void       LinkerPar_pop          (LinkerPar *self);
 PUBLIC  void       LinkerPar_update       (LinkerPar *self, const size_t x, const size_t y, const size_t z, const double flux, const unsigned char flag);
 PUBLIC  void       LinkerPar_update_flag  (LinkerPar *self, const unsigned char flag);
+PUBLIC  void       LinkerPar_append       (LinkerPar *self, const LinkerPar *source, const size_t index, const size_t label);
 PUBLIC  size_t     LinkerPar_get_obj_size (const LinkerPar *self, const size_t label, const int axis);
 PUBLIC  size_t     LinkerPar_get_npix     (const LinkerPar *self, const size_t label);
 PUBLIC  void       LinkerPar_get_bbox     (const LinkerPar *self, const size_t label, size_t *x_min, size_t *x_max, size_t *y_min, size_t *y_max, size_t *z_min, size_t *z_max);
@@ -91,15 +93,20 @@ PUBLIC  void       LinkerPar_get_rel_cat  (const LinkerPar *self, const char *fl
 PUBLIC  void       LinkerPar_print_info   (const LinkerPar *self);
 
 // Reliability filtering
-PUBLIC  Matrix    *LinkerPar_reliability  (LinkerPar *self, const Array_siz *rel_par_space, double *scale_kernel, const double fmin, const size_t minpix, const Table *rel_cat, Array_dbl **skellam, const bool autokernel, const int iterations, const double tolerance);
+PUBLIC  Matrix    *LinkerPar_reliability  (LinkerPar *self, const Array_siz *rel_par_space, double *scale_kernel, const double fmin, const size_t minpix, const Table *rel_cat, Array_dbl **skellam, const bool autokernel, const int iterations, const double tolerance, const double kde_tolerance, const size_t cache_limit);
 PUBLIC  void       LinkerPar_rel_plots    (const LinkerPar *self, const Array_siz *rel_par_space, const double threshold, const double fmin, const double minSNR, const Matrix *covar, const char *filename, const bool overwrite);
 
 // Private methods
 PRIVATE size_t     LinkerPar_get_index    (const LinkerPar *self, const size_t label);
+PRIVATE void       LinkerPar_set_lookup   (LinkerPar *self, const size_t label);
+PRIVATE double    *LinkerPar_transpose    (const double *par, const size_t n, const int dim);
+PRIVATE double    *LinkerPar_whiten       (const double *par, const size_t n, const int dim, const Matrix *covar_inv);
 PRIVATE void       LinkerPar_reallocate_memory(LinkerPar *self);
 
 // Public functions
-PUBLIC  void       LinkerPar_calculate_skellam(Array_dbl **skellam, const Matrix *covar_inv, double *pos, double *neg, const int dim, const size_t n_pos, const size_t n_neg, const double scale);
+PUBLIC  void       LinkerPar_calculate_skellam(Array_dbl **skellam, const Matrix *covar_inv, double *pos, double *neg, const int dim, const size_t n_pos, const size_t n_neg, const double scale, const double kde_tolerance);
+PUBLIC  bool       LinkerPar_cache_distances(Array_dbl **cache, const double *pos, const double *neg, const int dim, const size_t n_pos, const size_t n_neg, const Matrix *covar_inv, const double radius_squ, const size_t limit);
+PUBLIC  void       LinkerPar_cached_skellam(Array_dbl **skellam, Array_dbl * const *cache, const size_t n_neg, const double variance, const double radius_squ, const double scale);
 PUBLIC  void       LinkerPar_skellam_plot (Array_dbl *skellam, const char *filename, const bool overwrite, const double kernelScale);
 
 #endif
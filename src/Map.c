@@ -36,6 +36,8 @@
 
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include "Map.h"
 
 
@@ -48,9 +50,12 @@
 
 CLASS Map
 {
-	size_t  size;    ///< Number of key-value pairs stored.
-	size_t *keys;    ///< Pointer to array of keys.
-	size_t *values;  ///< Pointer to array of values.
+	size_t  size;      ///< Number of key-value pairs stored.
+	size_t  capacity;  ///< Number of key-value pairs memory is allocated for.
+	size_t *keys;      ///< Pointer to array of keys.
+	size_t *values;    ///< Pointer to array of values.
+	size_t *table;     ///< Hash table holding index + 1 of last occurrence of each key; 0 = empty.
+	size_t  n_slots;   ///< Number of slots in hash table (power of 2).
 };
 
 
@@ -70,8 +75,11 @@ PUBLIC Map *Map_new(void)
 	Map *self = (Map *)memory(MALLOC, 1, sizeof(Map));
 	
 	self->size = 0;
+	self->capacity = 0;
 	self->keys = NULL;
 	self->values = NULL;
+	self->table = NULL;
+	self->n_slots = 0;
 	
 	return self;
 }
@@ -92,6 +100,7 @@ PUBLIC void Map_delete(Map *self)
 	{
 		free(self->keys);
 		free(self->values);
+		free(self->table);
 		free(self);
 	}
 	
@@ -105,7 +114,8 @@ PUBLIC void Map_delete(Map *self)
 /// Public method for pushing a new key-value pair onto the specified
 /// map. Note that there will be no check as to whether the key
 /// already exists, and it is therefore possible to create more than
-/// one entry with the same key.
+/// one entry with the same key. If the map is full, its capacity will
+/// automatically be doubled.
 ///
 /// @param self   Object self-reference.
 /// @param key    Key to be created.
@@ -116,13 +126,17 @@ PUBLIC void Map_push(Map *self, const size_t key, const size_t value)
 	// Sanity checks
 	check_null(self);
 	
-	++self->size;
+	// Grow storage before adding the entry, as Map_reserve() may
+	// rehash all entries up to the current size
+	if(self->size == self->capacity) Map_reserve(self, self->capacity ? 2 * self->capacity : 16);
 	
-	self->keys   = (size_t *)memory_realloc(self->keys, self->size, sizeof(size_t));
-	self->values = (size_t *)memory_realloc(self->values, self->size, sizeof(size_t));
+	self->keys[self->size] = key;
+	self->values[self->size] = value;
+	++self->size;
 	
-	self->keys[self->size - 1] = key;
-	self->values[self->size - 1] = value;
+	// Update hash table, keeping load factor at or below 0.5
+	if(2 * self->size > self->n_slots) Map_rehash(self, self->n_slots ? 2 * self->n_slots : 32);
+	else self->table[Map_find_slot(self, key)] = self->size;
 	
 	return;
 }
@@ -147,14 +161,10 @@ PUBLIC size_t Map_get_value(const Map *self, const size_t key)
 	// Sanity checks
 	check_null(self);
 	
-	// Search for key and return value
-	for(size_t i = self->size; i--;) if(self->keys[i] == key) return self->values[i];
-	
-	// Key not found
-	ensure(false, ERR_USER_INPUT, "Key \'%zu\' not found in map.", key);
-	
-	// While this return statement is never executed, it is required by the compiler:
-	return 0;
+	// Look up key and return value
+	const size_t index = self->n_slots ? self->table[Map_find_slot(self, key)] : 0;
+	ensure(index, ERR_USER_INPUT, "Key \'%zu\' not found in map.", key);
+	return self->values[index - 1];
 }
 
 
@@ -194,7 +204,96 @@ PUBLIC bool Map_key_exists(const Map *self, const size_t key)
 	// Sanity checks
 	check_null(self);
 	
-	// Search for key
-	for(size_t i = 0; i < self->size; ++i) if(self->keys[i] == key) return true;
-	return false;
+	// Look up key
+	return self->n_slots && self->table[Map_find_slot(self, key)];
+}
+
+
+
+/// @brief Reserve memory for key-value pairs
+///
+/// Public method for ensuring that memory for at least `capacity`
+/// key-value pairs is allocated, such that no further reallocation
+/// will be required until the map grows beyond that size. Memory is
+/// never released by this method.
+///
+/// @param self      Object self-reference.
+/// @param capacity  Number of key-value pairs to reserve memory for.
+
+PUBLIC void Map_reserve(Map *self, const size_t capacity)
+{
+	// Sanity checks
+	check_null(self);
+	
+	if(capacity > self->capacity)
+	{
+		self->keys   = (size_t *)memory_realloc(self->keys, capacity, sizeof(size_t));
+		self->values = (size_t *)memory_realloc(self->values, capacity, sizeof(size_t));
+		self->capacity = capacity;
+	}
+	
+	if(2 * capacity > self->n_slots)
+	{
+		size_t n_slots = self->n_slots ? self->n_slots : 32;
+		while(n_slots < 2 * capacity) n_slots *= 2;
+		Map_rehash(self, n_slots);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Find hash table slot of key
+///
+/// Private method for returning the slot of the hash table that
+/// either holds the specified key or is the empty slot at which the
+/// key would have to be inserted. Collisions are resolved by linear
+/// probing. The hash table must not be empty or full.
+///
+/// @param self  Object self-reference.
+/// @param key   Key to be looked up.
+///
+/// @return Slot of the key in the hash table.
+
+PRIVATE size_t Map_find_slot(const Map *self, const size_t key)
+{
+	// Hash key using 64-bit finaliser of MurmurHash3
+	uint64_t hash = key;
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	
+	// Probe until key or empty slot found
+	const size_t mask = self->n_slots - 1;
+	size_t slot = (size_t)hash & mask;
+	while(self->table[slot] && self->keys[self->table[slot] - 1] != key) slot = (slot + 1) & mask;
+	
+	return slot;
+}
+
+
+
+/// @brief Rebuild hash table
+///
+/// Private method for rebuilding the hash table with the specified
+/// number of slots, which must be a power of 2 and greater than the
+/// number of key-value pairs stored. All entries are re-inserted in
+/// their original order, such that the table will point to the last
+/// occurrence of each key.
+///
+/// @param self     Object self-reference.
+/// @param n_slots  New number of slots of the hash table.
+
+PRIVATE void Map_rehash(Map *self, const size_t n_slots)
+{
+	self->n_slots = n_slots;
+	self->table = (size_t *)memory_realloc(self->table, n_slots, sizeof(size_t));
+	memset(self->table, 0, n_slots * sizeof(size_t));
+	
+	for(size_t i = 0; i < self->size; ++i) self->table[Map_find_slot(self, self->keys[i])] = i + 1;
+	
+	return;
 }
@@ -47,7 +47,9 @@
 // The purpose of this class is to provide a simple map structure    //
 // that allows key-value pairs to be handled. Both key and value are //
 // of type size_t (to facilitate handling of source mask labels).    //
-// Multiple entries with the same key are allowed.                   //
+// Multiple entries with the same key are allowed, in which case the //
+// last occurrence will be returned. Keys are looked up in constant  //
+// time by means of an internal hash table.                          //
 // ----------------------------------------------------------------- //
 
 typedef CLASS Map Map;
@@ -61,5 +63,10 @@ PUBLIC void          Map_push       (Map *self, const size_t key, const size_t v
 PUBLIC size_t        Map_get_value  (const Map *self, const size_t key);
 PUBLIC size_t        Map_get_size   (const Map *self);
 PUBLIC bool          Map_key_exists (const Map *self, const size_t key);
+PUBLIC void          Map_reserve    (Map *self, const size_t capacity);
+
+// Private methods
+PRIVATE size_t       Map_find_slot  (const Map *self, const size_t key);
+PRIVATE void         Map_rehash     (Map *self, const size_t n_slots);
 
 #endif
@@ -745,6 +745,57 @@ PUBLIC Matrix *Matrix_invert(const Matrix *self)
 
 
 
+/// @brief Cholesky decomposition
+///
+/// Public method for calculating the Cholesky decomposition,
+/// M = L L^T, of the specified symmetric, positive-definite matrix
+/// M. The lower-triangular matrix L will be returned. If the matrix
+/// is not positive-definite, a `NULL` pointer will instead be
+/// returned. The user is responsible for calling the destructor
+/// once the matrix is no longer needed.
+///
+/// @param self  Object self-reference.
+///
+/// @return Lower-triangular matrix L, or NULL if not positive-definite.
+
+PUBLIC Matrix *Matrix_cholesky(const Matrix *self)
+{
+	// Sanity checks
+	check_null(self);
+	ensure(self->rows == self->cols, ERR_USER_INPUT, "Cannot decompose non-square matrix.");
+	
+	const size_t size = self->rows;
+	Matrix *result = Matrix_new(size, size);
+	
+	for(size_t j = 0; j < size; ++j)
+	{
+		// Diagonal element
+		double sum = self->values[Matrix_get_index(self, j, j)];
+		for(size_t k = 0; k < j; ++k) sum -= result->values[Matrix_get_index(result, j, k)] * result->values[Matrix_get_index(result, j, k)];
+		
+		if(!(sum > 0.0))
+		{
+			Matrix_delete(result);
+			return NULL;
+		}
+		
+		const double diag = sqrt(sum);
+		result->values[Matrix_get_index(result, j, j)] = diag;
+		
+		// Elements below diagonal
+		for(size_t i = j + 1; i < size; ++i)
+		{
+			sum = self->values[Matrix_get_index(self, i, j)];
+			for(size_t k = 0; k < j; ++k) sum -= result->values[Matrix_get_index(result, i, k)] * result->values[Matrix_get_index(result, j, k)];
+			result->values[Matrix_get_index(result, i, j)] = sum / diag;
+		}
+	}
+	
+	return result;
+}
+
+
+
 /// @brief Print matrix
 ///
 /// Public method for printing the matrix to the standard output.
@@ -951,6 +1002,79 @@ PUBLIC double Matrix_prob_dens_nocheck(const Matrix *covar_inv, const Matrix *ve
 
 
 
+/// @brief Sum of probability densities for many points
+///
+/// Public method for calculating the sum of the probability
+/// densities of a multivariate normal distribution, centred on
+/// `position`, at `n` points. This is equivalent to summing
+/// Matrix_prob_dens_nocheck() over all points in order, and the
+/// result will be identical, but the points are processed in
+/// batches, and specialised kernels for 1 to 4 dimensions keep the
+/// inverse covariance matrix in local variables. The points must be
+/// provided in structure-of-arrays layout, i.e. the j-th coordinate
+/// of point i must be stored at `points[j * n + i]`. No sanity
+/// checks are carried out.
+///
+/// @param covar_inv  Inverse of the covariance matrix. Can be
+///                   calculated with Matrix_invert().
+/// @param points     Array of point coordinates of size `n * dim`
+///                   in structure-of-arrays layout.
+/// @param n          Number of points.
+/// @param position   Array of `dim` coordinates of the mean.
+/// @param scal_fact  Scale factor of 1 divided by the square root of
+///                   the determinant of 2 pi times the covariance
+///                   matrix, 1 / SQRT(|2 pi COV|).
+///
+/// @return Sum of the probability densities at all points.
+
+PUBLIC double Matrix_prob_dens_sum(const Matrix *covar_inv, const double *points, const size_t n, const double *position, const double scal_fact)
+{
+	double vMv[MATRIX_BATCH_SIZE];
+	double sum = 0.0;
+	
+	for(size_t first = 0; first < n; first += MATRIX_BATCH_SIZE)
+	{
+		const size_t size = (n - first < MATRIX_BATCH_SIZE) ? n - first : MATRIX_BATCH_SIZE;
+		
+		// Calculate v^T M v for entire batch
+		Matrix_vMv_batch(covar_inv, points + first, n, position, vMv, size);
+		
+		// Add up PDF = exp(-0.5 v^T C^-1 v) / SQRT((2 pi)^n |C|) in order
+		for(size_t i = 0; i < size; ++i) sum += scal_fact * exp(-0.5 * vMv[i]);
+	}
+	
+	return sum;
+}
+
+
+
+/// @brief Calculate v^T M v for many points
+///
+/// Public method for calculating the product v^T M v, where v is
+/// the difference vector between each of the `n` points and
+/// `position`, and writing the results into the array `result` of
+/// size `n`. The results will be identical to those returned by
+/// Matrix_vMv_nocheck() for each point. The points must be provided
+/// in structure-of-arrays layout, i.e. the j-th coordinate of point
+/// i must be stored at `points[j * n + i]`. No sanity checks are
+/// carried out.
+///
+/// @param self      Object self-reference.
+/// @param points    Array of point coordinates of size `n * dim`
+///                  in structure-of-arrays layout.
+/// @param n         Number of points.
+/// @param position  Array of `dim` coordinates of the reference
+///                  position.
+/// @param result    Array of size `n` to hold the results.
+
+PUBLIC void Matrix_vMv_points(const Matrix *self, const double *points, const size_t n, const double *position, double *result)
+{
+	Matrix_vMv_batch(self, points, n, position, result, n);
+	return;
+}
+
+
+
 /// @brief Create error ellipse from covariance matrix
 ///
 /// Public method for determining the radii and position angle of
@@ -1035,6 +1159,174 @@ PUBLIC void Matrix_err_ellipse(const Matrix *covar, const size_t par1, const siz
 
 
 
+/// @brief Calculate v^T M v for a batch of points
+///
+/// Private method for calculating v^T M v for `size` points in
+/// structure-of-arrays layout with a spacing of `stride` between
+/// coordinates, using the specialised kernel for the dimensionality
+/// of the matrix where available.
+///
+/// @param self      Object self-reference.
+/// @param points    Pointer to first coordinate of first point.
+/// @param stride    Spacing between coordinates of the same point.
+/// @param position  Array of coordinates of the reference position.
+/// @param result    Array of size `size` to hold the results.
+/// @param size      Number of points.
+
+PRIVATE void Matrix_vMv_batch(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size)
+{
+	switch(self->rows)
+	{
+		case 1:
+			Matrix_vMv_batch_1(self, points, stride, position, result, size);
+			break;
+		case 2:
+			Matrix_vMv_batch_2(self, points, stride, position, result, size);
+			break;
+		case 3:
+			Matrix_vMv_batch_3(self, points, stride, position, result, size);
+			break;
+		case 4:
+			Matrix_vMv_batch_4(self, points, stride, position, result, size);
+			break;
+		default:
+			Matrix_vMv_batch_n(self, points, stride, position, result, size);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Calculate v^T M v for batch of vectors (1 dimension)
+///
+/// Private methods for calculating v^T M v for a batch of `size`
+/// vectors v = p - position, where the points p are stored in
+/// structure-of-arrays layout with the specified `stride` between
+/// coordinates. The operations are carried out in the same order
+/// as in Matrix_vMv_nocheck() to ensure identical results. There
+/// are specialised versions for 1 to 4 dimensions as well as a
+/// generic version for any number of dimensions. No sanity checks
+/// are carried out.
+///
+/// @param self      Object self-reference.
+/// @param points    Pointer to first coordinate of first point.
+/// @param stride    Offset between consecutive coordinates of a point.
+/// @param position  Array of coordinates of the position.
+/// @param result    Array of size `size` for holding the results.
+/// @param size      Number of vectors in batch.
+
+PRIVATE void Matrix_vMv_batch_1(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size)
+{
+	const double m00 = self->values[0];
+	const double x0 = position[0];
+	const double *p0 = points;
+	(void)stride;
+	
+	for(size_t i = 0; i < size; ++i)
+	{
+		const double v0 = p0[i] - x0;
+		result[i] = (v0 * m00) * v0;
+	}
+	
+	return;
+}
+
+/// @brief Calculate v^T M v for batch of vectors (2 dimensions)
+
+PRIVATE void Matrix_vMv_batch_2(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size)
+{
+	const double m00 = self->values[0], m10 = self->values[1];
+	const double m01 = self->values[2], m11 = self->values[3];
+	const double x0 = position[0], x1 = position[1];
+	const double *p0 = points, *p1 = points + stride;
+	
+	for(size_t i = 0; i < size; ++i)
+	{
+		const double v0 = p0[i] - x0;
+		const double v1 = p1[i] - x1;
+		const double a0 = v1 * m10 + v0 * m00;
+		const double a1 = v1 * m11 + v0 * m01;
+		result[i] = a1 * v1 + a0 * v0;
+	}
+	
+	return;
+}
+
+/// @brief Calculate v^T M v for batch of vectors (3 dimensions)
+
+PRIVATE void Matrix_vMv_batch_3(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size)
+{
+	const double m00 = self->values[0], m10 = self->values[1], m20 = self->values[2];
+	const double m01 = self->values[3], m11 = self->values[4], m21 = self->values[5];
+	const double m02 = self->values[6], m12 = self->values[7], m22 = self->values[8];
+	const double x0 = position[0], x1 = position[1], x2 = position[2];
+	const double *p0 = points, *p1 = points + stride, *p2 = points + 2 * stride;
+	
+	for(size_t i = 0; i < size; ++i)
+	{
+		const double v0 = p0[i] - x0;
+		const double v1 = p1[i] - x1;
+		const double v2 = p2[i] - x2;
+		const double a0 = v2 * m20 + v1 * m10 + v0 * m00;
+		const double a1 = v2 * m21 + v1 * m11 + v0 * m01;
+		const double a2 = v2 * m22 + v1 * m12 + v0 * m02;
+		result[i] = a2 * v2 + a1 * v1 + a0 * v0;
+	}
+	
+	return;
+}
+
+/// @brief Calculate v^T M v for batch of vectors (4 dimensions)
+
+PRIVATE void Matrix_vMv_batch_4(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size)
+{
+	const double m00 = self->values[0],  m10 = self->values[1],  m20 = self->values[2],  m30 = self->values[3];
+	const double m01 = self->values[4],  m11 = self->values[5],  m21 = self->values[6],  m31 = self->values[7];
+	const double m02 = self->values[8],  m12 = self->values[9],  m22 = self->values[10], m32 = self->values[11];
+	const double m03 = self->values[12], m13 = self->values[13], m23 = self->values[14], m33 = self->values[15];
+	const double x0 = position[0], x1 = position[1], x2 = position[2], x3 = position[3];
+	const double *p0 = points, *p1 = points + stride, *p2 = points + 2 * stride, *p3 = points + 3 * stride;
+	
+	for(size_t i = 0; i < size; ++i)
+	{
+		const double v0 = p0[i] - x0;
+		const double v1 = p1[i] - x1;
+		const double v2 = p2[i] - x2;
+		const double v3 = p3[i] - x3;
+		const double a0 = v3 * m30 + v2 * m20 + v1 * m10 + v0 * m00;
+		const double a1 = v3 * m31 + v2 * m21 + v1 * m11 + v0 * m01;
+		const double a2 = v3 * m32 + v2 * m22 + v1 * m12 + v0 * m02;
+		const double a3 = v3 * m33 + v2 * m23 + v1 * m13 + v0 * m03;
+		result[i] = a3 * v3 + a2 * v2 + a1 * v1 + a0 * v0;
+	}
+	
+	return;
+}
+
+/// @brief Calculate v^T M v for batch of vectors (any dimension)
+
+PRIVATE void Matrix_vMv_batch_n(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size)
+{
+	const size_t dim = self->rows;
+	
+	for(size_t i = 0; i < size; ++i) result[i] = 0.0;
+	
+	for(size_t col = dim; col--;)
+	{
+		for(size_t i = 0; i < size; ++i)
+		{
+			double value = 0.0;
+			for(size_t row = dim; row--;) value += (points[row * stride + i] - position[row]) * self->values[Matrix_get_index(self, row, col)];
+			result[i] += value * (points[col * stride + i] - position[col]);
+		}
+	}
+	
+	return;
+}
+
+
+
 /// @brief Get array index from row and column
 ///
 /// Private method for returning the array index corresponding to
@@ -41,6 +41,8 @@
 #include <stdio.h>
 #include "common.h"
 
+#define MATRIX_BATCH_SIZE 256  ///< Number of points processed per batch by Matrix_prob_dens_sum().
+
 
 // ----------------------------------------------------------------- //
 // Class 'Matrix'                                                    //
@@ -74,10 +76,13 @@ PUBLIC  double        Matrix_vMv        (const Matrix *self, const Matrix *vecto
 PUBLIC  double        Matrix_vMv_nocheck(const Matrix *self, const Matrix *vector);
 PUBLIC  Matrix       *Matrix_transpose  (const Matrix *self);
 PUBLIC  Matrix       *Matrix_invert     (const Matrix *self);
+PUBLIC  Matrix       *Matrix_cholesky   (const Matrix *self);
 PUBLIC  void          Matrix_print      (const Matrix *self, const unsigned int width, const unsigned int decimals);
 PUBLIC  double        Matrix_det        (const Matrix *self, const double scale_factor);
 PUBLIC  double        Matrix_prob_dens  (const Matrix *covar_inv, const Matrix *vector, const double scal_fact);
 PUBLIC  double        Matrix_prob_dens_nocheck(const Matrix *covar_inv, const Matrix *vector, const double scal_fact);
+PUBLIC  double        Matrix_prob_dens_sum(const Matrix *covar_inv, const double *points, const size_t n, const double *position, const double scal_fact);
+PUBLIC  void          Matrix_vMv_points (const Matrix *self, const double *points, const size_t n, const double *position, double *result);
 PUBLIC  void          Matrix_err_ellipse(const Matrix *covar, const size_t par1, const size_t par2, double *radius_maj, double *radius_min, double *pa);
 //PUBLIC  void          Matrix_covariance (Matrix *self, const double values[], const size_t dim, const size_t length);
 
@@ -86,5 +91,11 @@ PRIVATE inline size_t Matrix_get_index  (const Matrix *self, const size_t row, c
 PRIVATE void          Matrix_swap_rows  (Matrix *self, const size_t row1, const size_t row2);
 PRIVATE void          Matrix_add_row    (Matrix *self, const size_t row1, const size_t row2, const double factor);
 PRIVATE void          Matrix_mul_row    (Matrix *self, const size_t row, const double factor);
+PRIVATE void          Matrix_vMv_batch  (const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size);
+PRIVATE void          Matrix_vMv_batch_1(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size);
+PRIVATE void          Matrix_vMv_batch_2(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size);
+PRIVATE void          Matrix_vMv_batch_3(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size);
+PRIVATE void          Matrix_vMv_batch_4(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size);
+PRIVATE void          Matrix_vMv_batch_n(const Matrix *self, const double *points, const size_t stride, const double *position, double *result, const size_t size);
 
 #endif
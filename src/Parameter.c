@@ -93,6 +93,37 @@ PUBLIC Parameter *Parameter_new(const bool verbosity)
 
 
 
+/// @brief Copy constructor
+///
+/// Copy constructor. Will create a new Parameter object that is a
+/// physical copy of the object pointed to by `source`. A pointer
+/// to the newly created object will be returned. Note that the
+/// destructor will need to be called explicitly once the object
+/// is no longer required to release any memory allocated to the
+/// object.
+///
+/// @param source  Parameter object to be copied.
+///
+/// @return Pointer to newly created Parameter object.
+
+PUBLIC Parameter *Parameter_copy(const Parameter *source)
+{
+	check_null(source);
+	
+	Parameter *self = Parameter_new(source->verbosity);
+	
+	for(size_t i = 0; i < source->n_par; ++i)
+	{
+		Parameter_append_memory(self);
+		String_set(self->keys[i],   String_get(source->keys[i]));
+		String_set(self->values[i], String_get(source->values[i]));
+	}
+	
+	return self;
+}
+
+
+
 /// @brief Destructor
 ///
 /// Destructor. Note that the destructor must be called explicitly
@@ -489,15 +520,33 @@ PUBLIC void Parameter_default(Parameter *self)
 	Parameter_set(self, "pipeline.verbose"         , "false");
 	Parameter_set(self, "pipeline.pedantic"        , "true");
 	Parameter_set(self, "pipeline.threads"         , "0");
+	Parameter_set(self, "pipeline.device"          , "cpu");
+	Parameter_set(self, "pipeline.hugePages"       , "false");
+	Parameter_set(self, "pipeline.memoryLimit"     , "0");
+	Parameter_set(self, "pipeline.madTolerance"    , "0");
+	Parameter_set(self, "pipeline.profile"         , "false");
+	Parameter_set(self, "pipeline.checkpoint"      , "false");
+	Parameter_set(self, "pipeline.sweep"           , "");
 	
 	// Input
 	Parameter_set(self, "input.data"               , "");
+	Parameter_set(self, "input.batch"              , "");
 	Parameter_set(self, "input.region"             , "");
 	Parameter_set(self, "input.gain"               , "");
 	Parameter_set(self, "input.noise"              , "");
 	Parameter_set(self, "input.weights"            , "");
 	Parameter_set(self, "input.mask"               , "");
 	Parameter_set(self, "input.invert"             , "false");
+	Parameter_set(self, "input.precision"          , "native");
+	
+	// Tiling
+	Parameter_set(self, "tiling.enable"            , "false");
+	Parameter_set(self, "tiling.sizeXY"            , "0");
+	Parameter_set(self, "tiling.sizeZ"             , "0");
+	Parameter_set(self, "tiling.overlapXY"         , "20");
+	Parameter_set(self, "tiling.overlapZ"          , "20");
+	Parameter_set(self, "tiling.stream"            , "false");
+	Parameter_set(self, "tiling.streamTimeout"     , "600");
 	
 	// Flagging
 	Parameter_set(self, "flag.region"              , "");
@@ -543,6 +592,8 @@ PUBLIC void Parameter_default(Parameter *self)
 	Parameter_set(self, "scfind.replacement"       , "2.0");
 	Parameter_set(self, "scfind.statistic"         , "mad");
 	Parameter_set(self, "scfind.fluxRange"         , "negative");
+	Parameter_set(self, "scfind.fused"             , "false");
+	Parameter_set(self, "scfind.workingSet"        , "0");
 	
 	// Threshold finder
 	Parameter_set(self, "threshold.enable"         , "false");
@@ -565,6 +616,7 @@ PUBLIC void Parameter_default(Parameter *self)
 	Parameter_set(self, "linker.maxFill"           , "0.0");
 	Parameter_set(self, "linker.positivity"        , "false");
 	Parameter_set(self, "linker.keepNegative"      , "false");
+	Parameter_set(self, "linker.parallel"          , "false");
 	
 	// Reliability
 	Parameter_set(self, "reliability.enable"       , "false");
@@ -576,6 +628,8 @@ PUBLIC void Parameter_default(Parameter *self)
 	Parameter_set(self, "reliability.autoKernel"   , "false");
 	Parameter_set(self, "reliability.iterations"   , "30");
 	Parameter_set(self, "reliability.tolerance"    , "0.05");
+	Parameter_set(self, "reliability.kdeTolerance" , "0.0");
+	Parameter_set(self, "reliability.cacheLimit"   , "0");
 	Parameter_set(self, "reliability.catalog"      , "");
 	Parameter_set(self, "reliability.plot"         , "true");
 	Parameter_set(self, "reliability.debug"        , "false");
@@ -592,6 +646,7 @@ PUBLIC void Parameter_default(Parameter *self)
 	Parameter_set(self, "parameter.physical"       , "false");
 	Parameter_set(self, "parameter.prefix"         , "SoFiA");
 	Parameter_set(self, "parameter.offset"         , "false");
+	Parameter_set(self, "parameter.keepData"       , "false");
 	
 	// Output
 	Parameter_set(self, "output.directory"         , "");
@@ -599,6 +654,7 @@ PUBLIC void Parameter_default(Parameter *self)
 	Parameter_set(self, "output.writeCatASCII"     , "true");
 	Parameter_set(self, "output.writeCatXML"       , "true");
 	Parameter_set(self, "output.writeCatSQL"       , "false");
+	Parameter_set(self, "output.writeCatFITS"      , "false");
 	Parameter_set(self, "output.writeNoise"        , "false");
 	Parameter_set(self, "output.writeFiltered"     , "false");
 	Parameter_set(self, "output.writeMask"         , "false");
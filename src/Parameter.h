@@ -60,6 +60,7 @@ typedef CLASS Parameter Parameter;
 
 // Constructor and destructor
 PUBLIC  Parameter        *Parameter_new       (const bool verbosity);
+PUBLIC  Parameter        *Parameter_copy      (const Parameter *source);
 PUBLIC  void              Parameter_delete    (Parameter *self);
 
 // Public methods
@@ -0,0 +1,442 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (Profiler.c) - Source Finding Application                //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+
+/// @file   Profiler.c
+/// @date   14/10/2026
+/// @brief  Class for recording run-time statistics of pipeline stages.
+
+
+// NOTE: Required for clock_gettime() and getrusage() when compiling with --std=c99.
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+#include "Profiler.h"
+
+
+
+// ----------------------------------------------------------------- //
+// Declaration of properties of class Profiler                       //
+// ----------------------------------------------------------------- //
+
+CLASS Profiler
+{
+	size_t size;
+	size_t capacity;
+	char   **names;
+	double *wall_time;
+	double *cpu_time;
+	size_t *peak_rss;
+	size_t *bytes_read;
+	size_t *bytes_written;
+	size_t *voxels;
+	bool   io_valid;
+	bool   running;
+	double start_wall;
+	double start_cpu;
+	size_t start_read;
+	size_t start_written;
+	size_t threads;
+};
+
+
+
+// ----------------------------------------------------------------- //
+// Standard constructor                                              //
+// ----------------------------------------------------------------- //
+// Arguments:                                                        //
+//                                                                   //
+//   No arguments.                                                   //
+//                                                                   //
+// Return value:                                                     //
+//                                                                   //
+//   Pointer to newly created Profiler object.                       //
+//                                                                   //
+// Description:                                                      //
+//                                                                   //
+//   Standard constructor. Will create a new and empty Profiler ob-  //
+//   ject and return a pointer to the newly created object. Note     //
+//   that the destructor will need to be called explicitly once the  //
+//   object is no longer required to release any memory allocated   //
+//   during the lifetime of the object.                              //
+// ----------------------------------------------------------------- //
+
+PUBLIC Profiler *Profiler_new(void)
+{
+	Profiler *self = (Profiler *)memory(MALLOC, 1, sizeof(Profiler));
+	
+	self->size          = 0;
+	self->capacity      = 0;
+	self->names         = NULL;
+	self->wall_time     = NULL;
+	self->cpu_time      = NULL;
+	self->peak_rss      = NULL;
+	self->bytes_read    = NULL;
+	self->bytes_written = NULL;
+	self->voxels        = NULL;
+	self->io_valid      = true;
+	self->running       = false;
+	self->start_wall    = 0.0;
+	self->start_cpu     = 0.0;
+	self->start_read    = 0;
+	self->start_written = 0;
+	
+	#ifdef _OPENMP
+		self->threads = omp_get_max_threads();
+	#else
+		self->threads = 1;
+	#endif
+	
+	return self;
+}
+
+
+
+// ----------------------------------------------------------------- //
+// Destructor                                                        //
+// ----------------------------------------------------------------- //
+// Arguments:                                                        //
+//                                                                   //
+//   (1) self - Object self-reference.                               //
+//                                                                   //
+// Return value:                                                     //
+//                                                                   //
+//   No return value.                                                //
+//                                                                   //
+// Description:                                                      //
+//                                                                   //
+//   Destructor. Note that the destructor must be called explicitly  //
+//   if the object is no longer required. This will release the me-  //
+//   mory occupied by the object.                                    //
+// ----------------------------------------------------------------- //
+
+PUBLIC void Profiler_delete(Profiler *self)
+{
+	if(self != NULL)
+	{
+		for(size_t i = 0; i < self->size; ++i) free(self->names[i]);
+		free(self->names);
+		free(self->wall_time);
+		free(self->cpu_time);
+		free(self->peak_rss);
+		free(self->bytes_read);
+		free(self->bytes_written);
+		free(self->voxels);
+		free(self);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Start a new pipeline stage
+///
+/// Starts recording the statistics of a new pipeline stage of the
+/// specified name. Any stage that is still running will be stopped
+/// automatically first. If `self` is `NULL`, the function will do
+/// nothing, which allows profiling to be switched off by passing a
+/// `NULL` pointer.
+///
+/// @param self    Object self-reference.
+/// @param stage   Name of the pipeline stage.
+/// @param voxels  Number of voxels processed during the stage. Set
+///                to 0 if not applicable.
+
+PUBLIC void Profiler_start(Profiler *self, const char *stage, const size_t voxels)
+{
+	if(self == NULL) return;
+	check_null(stage);
+	
+	// Stop any running stage
+	Profiler_stop(self);
+	
+	// Extend arrays if necessary
+	if(self->size >= self->capacity)
+	{
+		self->capacity      = self->capacity ? 2 * self->capacity : 32;
+		self->names         = (char  **)memory_realloc(self->names,         self->capacity, sizeof(char *));
+		self->wall_time     = (double *)memory_realloc(self->wall_time,     self->capacity, sizeof(double));
+		self->cpu_time      = (double *)memory_realloc(self->cpu_time,      self->capacity, sizeof(double));
+		self->peak_rss      = (size_t *)memory_realloc(self->peak_rss,      self->capacity, sizeof(size_t));
+		self->bytes_read    = (size_t *)memory_realloc(self->bytes_read,    self->capacity, sizeof(size_t));
+		self->bytes_written = (size_t *)memory_realloc(self->bytes_written, self->capacity, sizeof(size_t));
+		self->voxels        = (size_t *)memory_realloc(self->voxels,        self->capacity, sizeof(size_t));
+	}
+	
+	// Register new stage
+	self->names[self->size] = (char *)memory(MALLOC, strlen(stage) + 1, sizeof(char));
+	strcpy(self->names[self->size], stage);
+	self->wall_time[self->size]     = 0.0;
+	self->cpu_time[self->size]      = 0.0;
+	self->peak_rss[self->size]      = 0;
+	self->bytes_read[self->size]    = 0;
+	self->bytes_written[self->size] = 0;
+	self->voxels[self->size]        = voxels;
+	++self->size;
+	
+	// Record start values
+	size_t peak_rss;
+	Profiler_sample(&self->start_wall, &self->start_cpu, &peak_rss, &self->start_read, &self->start_written, &self->io_valid);
+	self->running = true;
+	
+	return;
+}
+
+
+
+/// @brief Stop the current pipeline stage
+///
+/// Stops recording the statistics of the currently running pipeline
+/// stage. The function will do nothing if `self` is `NULL` or if no
+/// stage is currently running.
+///
+/// @param self  Object self-reference.
+
+PUBLIC void Profiler_stop(Profiler *self)
+{
+	if(self == NULL || !self->running) return;
+	
+	double wall, cpu;
+	size_t peak_rss, bytes_read, bytes_written;
+	Profiler_sample(&wall, &cpu, &peak_rss, &bytes_read, &bytes_written, &self->io_valid);
+	
+	const size_t i = self->size - 1;
+	self->wall_time[i]     = wall - self->start_wall;
+	self->cpu_time[i]      = cpu  - self->start_cpu;
+	self->peak_rss[i]      = peak_rss;
+	self->bytes_read[i]    = bytes_read    > self->start_read    ? bytes_read    - self->start_read    : 0;
+	self->bytes_written[i] = bytes_written > self->start_written ? bytes_written - self->start_written : 0;
+	self->running = false;
+	
+	return;
+}
+
+
+
+/// @brief Return number of recorded stages
+///
+/// Returns the number of pipeline stages recorded so far. Returns 0
+/// if `self` is `NULL`.
+///
+/// @param self  Object self-reference.
+///
+/// @return Number of recorded stages.
+
+PUBLIC size_t Profiler_get_size(const Profiler *self)
+{
+	return self == NULL ? 0 : self->size;
+}
+
+
+
+/// @brief Save profiling report to JSON file
+///
+/// Stops any running stage and writes the statistics of all recorded
+/// stages into a JSON file. For each stage the wall-clock time and
+/// CPU time (in s), the thread utilisation (CPU time divided by wall-
+/// clock time and number of threads), the peak resident memory size
+/// of the process (in bytes), the number of bytes read and written,
+/// the number of voxels processed and the resulting throughput (in
+/// voxels per second) will be written. Quantities that are not avail-
+/// able on the current platform will be set to `null`. The function
+/// will do nothing if `self` is `NULL`.
+///
+/// @param self       Object self-reference.
+/// @param filename   Name of the output file.
+/// @param overwrite  If `true`, overwrite existing file.
+
+PUBLIC void Profiler_save(Profiler *self, const char *filename, const bool overwrite)
+{
+	if(self == NULL) return;
+	check_null(filename);
+	ensure(strlen(filename), ERR_USER_INPUT, "File name is empty.");
+	
+	Profiler_stop(self);
+	
+	// Open output file
+	FILE *fp;
+	if(overwrite) fp = fopen(filename, "wb");
+	else fp = fopen(filename, "wxb");
+	ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open output file: %s", filename);
+	
+	double total_wall = 0.0;
+	double total_cpu  = 0.0;
+	size_t total_rss  = 0;
+	size_t total_read = 0;
+	size_t total_written = 0;
+	
+	fprintf(fp, "{\n\t\"version\": \"%s\",\n\t\"threads\": %zu,\n\t\"stages\": [", SOFIA_VERSION, self->threads);
+	
+	for(size_t i = 0; i < self->size; ++i)
+	{
+		const double wall = self->wall_time[i];
+		const double cpu  = self->cpu_time[i];
+		
+		fprintf(fp, "%s\n\t\t{\n\t\t\t\"stage\": ", i ? "," : "");
+		Profiler_put_string(fp, self->names[i]);
+		fprintf(fp, ",\n\t\t\t\"wall_time\": %.6f,\n\t\t\t\"cpu_time\": %.6f,\n", wall, cpu);
+		if(wall > 0.0) fprintf(fp, "\t\t\t\"thread_utilisation\": %.4f,\n", cpu / (wall * self->threads));
+		else fprintf(fp, "\t\t\t\"thread_utilisation\": null,\n");
+		fprintf(fp, "\t\t\t\"peak_rss\": %zu,\n", self->peak_rss[i]);
+		if(self->io_valid) fprintf(fp, "\t\t\t\"bytes_read\": %zu,\n\t\t\t\"bytes_written\": %zu,\n", self->bytes_read[i], self->bytes_written[i]);
+		else fprintf(fp, "\t\t\t\"bytes_read\": null,\n\t\t\t\"bytes_written\": null,\n");
+		fprintf(fp, "\t\t\t\"voxels\": %zu,\n", self->voxels[i]);
+		if(wall > 0.0 && self->voxels[i]) fprintf(fp, "\t\t\t\"voxels_per_second\": %.6e\n\t\t}", (double)(self->voxels[i]) / wall);
+		else fprintf(fp, "\t\t\t\"voxels_per_second\": null\n\t\t}");
+		
+		total_wall    += wall;
+		total_cpu     += cpu;
+		total_read    += self->bytes_read[i];
+		total_written += self->bytes_written[i];
+		if(self->peak_rss[i] > total_rss) total_rss = self->peak_rss[i];
+	}
+	
+	fprintf(fp, "\n\t],\n\t\"total\": {\n\t\t\"wall_time\": %.6f,\n\t\t\"cpu_time\": %.6f,\n", total_wall, total_cpu);
+	if(total_wall > 0.0) fprintf(fp, "\t\t\"thread_utilisation\": %.4f,\n", total_cpu / (total_wall * self->threads));
+	else fprintf(fp, "\t\t\"thread_utilisation\": null,\n");
+	fprintf(fp, "\t\t\"peak_rss\": %zu,\n", total_rss);
+	if(self->io_valid) fprintf(fp, "\t\t\"bytes_read\": %zu,\n\t\t\"bytes_written\": %zu\n", total_read, total_written);
+	else fprintf(fp, "\t\t\"bytes_read\": null,\n\t\t\"bytes_written\": null\n");
+	fprintf(fp, "\t}\n}\n");
+	
+	fclose(fp);
+	
+	return;
+}
+
+
+
+/// @brief Sample current process statistics
+///
+/// Private method for sampling the current wall-clock time, CPU time,
+/// peak resident memory size and cumulative file I/O of the process.
+/// File I/O is read from `/proc/self/io` where available; otherwise,
+/// `io_valid` will be set to `false`.
+///
+/// @param wall           Pointer for wall-clock time (in s).
+/// @param cpu            Pointer for CPU time (in s).
+/// @param peak_rss       Pointer for peak resident memory (in bytes).
+/// @param bytes_read     Pointer for number of bytes read.
+/// @param bytes_written  Pointer for number of bytes written.
+/// @param io_valid       Pointer to flag that will be set to `false`
+///                       if file I/O statistics are unavailable.
+
+PRIVATE void Profiler_sample(double *wall, double *cpu, size_t *peak_rss, size_t *bytes_read, size_t *bytes_written, bool *io_valid)
+{
+	// Wall-clock and CPU time
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	*wall = (double)(ts.tv_sec) + 1.0e-9 * (double)(ts.tv_nsec);
+	*cpu  = (double)(clock()) / CLOCKS_PER_SEC;
+	
+	// Peak resident memory
+	struct rusage usage;
+	*peak_rss = 0;
+	if(getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		#ifdef __APPLE__
+			*peak_rss = (size_t)(usage.ru_maxrss);        // bytes
+		#else
+			*peak_rss = (size_t)(usage.ru_maxrss) * 1024; // kilobytes
+		#endif
+	}
+	
+	// File I/O
+	*bytes_read = 0;
+	*bytes_written = 0;
+	bool found_read = false;
+	bool found_written = false;
+	
+	FILE *fp = fopen("/proc/self/io", "r");
+	if(fp != NULL)
+	{
+		char line[128];
+		unsigned long long value;
+		
+		while(fgets(line, sizeof(line), fp) != NULL)
+		{
+			if(sscanf(line, "rchar: %llu", &value) == 1)
+			{
+				*bytes_read = (size_t)value;
+				found_read = true;
+			}
+			else if(sscanf(line, "wchar: %llu", &value) == 1)
+			{
+				*bytes_written = (size_t)value;
+				found_written = true;
+			}
+		}
+		
+		fclose(fp);
+	}
+	
+	if(!found_read || !found_written) *io_valid = false;
+	
+	return;
+}
+
+
+
+/// @brief Write string to file as JSON string literal
+///
+/// Private method for writing a string to the specified file as a
+/// JSON string literal enclosed in double quotes, escaping any
+/// double quotes, backslashes and control characters.
+///
+/// @param fp      Pointer to output file.
+/// @param string  String to be written.
+
+PRIVATE void Profiler_put_string(FILE *fp, const char *string)
+{
+	fputc('"', fp);
+	
+	for(const char *ptr = string; *ptr; ++ptr)
+	{
+		if(*ptr == '"' || *ptr == '\\') fprintf(fp, "\\%c", *ptr);
+		else if((unsigned char)(*ptr) < 0x20) fprintf(fp, "\\u%04x", (unsigned int)(unsigned char)(*ptr));
+		else fputc(*ptr, fp);
+	}
+	
+	fputc('"', fp);
+	
+	return;
+}
@@ -0,0 +1,70 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (Profiler.h) - Source Finding Application                //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+
+/// @file   Profiler.h
+/// @date   14/10/2026
+/// @brief  Class for recording run-time statistics of pipeline stages (header).
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "common.h"
+
+
+// ----------------------------------------------------------------- //
+// Class 'Profiler'                                                  //
+// ----------------------------------------------------------------- //
+// The purpose of this class is to record the wall-clock time, CPU   //
+// time, peak memory usage, file I/O and throughput of each stage of //
+// the pipeline and to write the results into a JSON file. All pub-  //
+// lic methods accept a NULL pointer and will then do nothing, such  //
+// that profiling can be disabled by simply passing NULL.            //
+// ----------------------------------------------------------------- //
+
+typedef CLASS Profiler Profiler;
+
+// Constructor and destructor
+PUBLIC Profiler     *Profiler_new       (void);
+PUBLIC void          Profiler_delete    (Profiler *self);
+
+// Public methods
+PUBLIC void          Profiler_start     (Profiler *self, const char *stage, const size_t voxels);
+PUBLIC void          Profiler_stop      (Profiler *self);
+PUBLIC size_t        Profiler_get_size  (const Profiler *self);
+PUBLIC void          Profiler_save      (Profiler *self, const char *filename, const bool overwrite);
+
+// Private methods
+PRIVATE void         Profiler_sample    (double *wall, double *cpu, size_t *peak_rss, size_t *bytes_read, size_t *bytes_written, bool *io_valid);
+PRIVATE void         Profiler_put_string(FILE *fp, const char *string);
+
+#endif
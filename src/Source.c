@@ -56,6 +56,48 @@ union SourceValue
 
 
 
+/// @brief Structure for storing a parameter schema
+///
+/// Parameter names, units, Unified Content Descriptors (UCDs) and
+/// data types are not stored with each source, but in a parameter
+/// schema that is shared between all sources with the same list of
+/// parameters. Schemas are immutable and organised in a tree, with
+/// each schema being derived from its parent by either appending a
+/// new parameter or changing an existing one. Derived schemas are
+/// cached by their parent, so sources undergoing the same sequence
+/// of parameter definitions, e.g. all sources created by the linker
+/// or subsequently parameterised, end up sharing the same schema.
+/// Schemas are reference-counted and released once no longer used
+/// by any source or derived schema.
+
+struct SourceSchema
+{
+	SourceSchema   *parent;      ///< Schema from which this one was derived; `NULL` for the root.
+	SourceSchema  **children;    ///< Array of schemas derived from this one.
+	size_t          n_children;  ///< Number of derived schemas.
+	size_t          n_refs;      ///< Number of sources and derived schemas referring to this schema.
+	size_t          n_par;       ///< Number of source parameters.
+	size_t          column;      ///< Index of the parameter defined by this schema.
+	unsigned char  *types;       ///< Array of source parameter data types. Can be SOURCE_TYPE_INT or SOURCE_TYPE_FLT.
+	const char    **names;       ///< Array of source parameter names.
+	const char    **units;       ///< Array of source parameter units.
+	const char    **ucds;        ///< Array of Unified Content Descriptors (UCDs).
+	char           *strings;     ///< Name, unit and UCD of the parameter defined by this schema.
+	size_t         *index;       ///< Hash table of column + 1 of last occurrence of each name; 0 = empty.
+	size_t          n_slots;     ///< Number of slots in hash table (power of 2).
+};
+
+/// @brief Root of the parameter schema tree
+///
+/// Empty parameter schema from which all other schemas are derived.
+/// It is statically allocated and holds a permanent reference to
+/// itself, so it will never be released. Access to the schema tree
+/// must be synchronised through the `source_schema` critical section.
+
+static SourceSchema Source_schema_root = {NULL, NULL, 0, 1, 0, 0, NULL, NULL, NULL, NULL, NULL, NULL, 0};
+
+
+
 /// @brief Class for storing and handling source parameters
 ///
 /// The purpose of this class is to provide a structure for storing
@@ -68,12 +110,9 @@ union SourceValue
 CLASS Source
 {
 	String         *identifier;  ///< Source name.
-	size_t          n_par;       ///< Total number of source parameters stored.
-	SourceValue    *values;      ///< Array of source parameter values.
-	unsigned char  *types;       ///< Array of source parameter data types. Can be SOURCE_TYPE_INT or SOURCE_TYPE_FLT.
-	String        **names;       ///< Array of source parameter names.
-	String        **units;       ///< Array of source parameter units.
-	String        **ucds;        ///< Array of Unified Content Descriptors (UCDs).
+	SourceSchema   *schema;      ///< Shared schema defining names, units, UCDs and types of parameters.
+	SourceValue    *values;      ///< Array of source parameter values in the order defined by the schema.
+	size_t          capacity;    ///< Number of parameter values for which memory has been allocated.
 	int             verbosity;   ///< Verbosity level (0 or 1).
 };
 
@@ -99,15 +138,57 @@ PUBLIC Source *Source_new(const bool verbosity)
 	
 	// Initialise properties
 	self->identifier = String_new("");
-	self->n_par      = 0;
+	self->schema     = &Source_schema_root;
 	self->values     = NULL;
-	self->types      = NULL;
-	self->names      = NULL;
-	self->units      = NULL;
-	self->ucds       = NULL;
+	self->capacity   = 0;
 	
 	self->verbosity  = verbosity;
 	
+	#pragma omp critical(source_schema)
+	++self->schema->n_refs;
+	
+	return self;
+}
+
+
+
+/// @brief Copy constructor
+///
+/// Copy constructor. Will create a new Source object that is a
+/// physical copy of the object pointed to by `source`, including
+/// its identifier and all parameters. A pointer to the newly created
+/// object will be returned. Note that the destructor will need to be
+/// called explicitly once the object is no longer required, unless
+/// the copy is handed over to a Catalog object.
+///
+/// @param source  Source object to be copied.
+///
+/// @return Pointer to newly created Source object.
+
+PUBLIC Source *Source_copy(const Source *source)
+{
+	check_null(source);
+	
+	Source *self = Source_new(source->verbosity);
+	
+	String_set(self->identifier, String_get(source->identifier));
+	
+	// Share schema of original source
+	#pragma omp critical(source_schema)
+	{
+		Source_schema_release(self->schema);
+		self->schema = source->schema;
+		++self->schema->n_refs;
+	}
+	
+	// Copy parameter values
+	if(self->schema->n_par)
+	{
+		self->capacity = self->schema->n_par;
+		self->values = (SourceValue *)memory(MALLOC, self->capacity, sizeof(SourceValue));
+		memcpy(self->values, source->values, self->capacity * sizeof(SourceValue));
+	}
+	
 	return self;
 }
 
@@ -130,21 +211,11 @@ PUBLIC void Source_delete(Source *self)
 {
 	if(self != NULL)
 	{
-		for(size_t i = self->n_par; i--;)
-		{
-			if(self->names != NULL) String_delete(self->names[i]);
-			if(self->units != NULL) String_delete(self->units[i]);
-			if(self->ucds  != NULL) String_delete(self->ucds[i]);
-		}
+		#pragma omp critical(source_schema)
+		Source_schema_release(self->schema);
 		
 		String_delete(self->identifier);
-		
 		free(self->values);
-		free(self->types);
-		free(self->names);
-		free(self->units);
-		free(self->ucds);
-		
 		free(self);
 	}
 	
@@ -194,15 +265,13 @@ PUBLIC void Source_add_par_flt(Source *self, const char *name, const double valu
 	check_null(unit);
 	check_null(ucd);
 	
-	// Reserve memory for one additional parameter
+	// Append new parameter to schema and reserve memory for its value
+	const size_t index = self->schema->n_par;
+	Source_define_par(self, index, SOURCE_TYPE_FLT, name, unit, ucd);
 	Source_append_memory(self);
 	
-	// Copy new parameter information
-	self->values[self->n_par - 1].value_flt = value;
-	self->types[self->n_par - 1] = SOURCE_TYPE_FLT;
-	String_set(self->names[self->n_par - 1], name);
-	String_set(self->units[self->n_par - 1], unit);
-	String_set(self->ucds [self->n_par - 1],  ucd);
+	// Copy new parameter value
+	self->values[index].value_flt = value;
 	
 	return;
 }
@@ -232,15 +301,13 @@ PUBLIC void Source_add_par_int(Source *self, const char *name, const long int va
 	check_null(unit);
 	check_null(ucd);
 	
-	// Reserve memory for one additional parameter
+	// Append new parameter to schema and reserve memory for its value
+	const size_t index = self->schema->n_par;
+	Source_define_par(self, index, SOURCE_TYPE_INT, name, unit, ucd);
 	Source_append_memory(self);
 	
-	// Copy new parameter information
-	self->values[self->n_par - 1].value_int = value;
-	self->types[self->n_par - 1] = SOURCE_TYPE_INT;
-	String_set(self->names[self->n_par - 1], name);
-	String_set(self->units[self->n_par - 1], unit);
-	String_set(self->ucds [self->n_par - 1],  ucd);
+	// Copy new parameter value
+	self->values[index].value_int = value;
 	
 	return;
 }
@@ -277,11 +344,8 @@ PUBLIC void Source_set_par_flt(Source *self, const char *name, const double valu
 	if(Source_par_exists(self, name, &index))
 	{
 		// If so, overwrite with new parameter information
+		Source_update_par(self, index, SOURCE_TYPE_FLT, unit, ucd);
 		self->values[index].value_flt = value;
-		self->types[index] = SOURCE_TYPE_FLT;
-		String_set(self->names[index], name);
-		if(unit != NULL) String_set(self->units[index], unit);
-		if(ucd  != NULL) String_set(self->ucds [index],  ucd);
 	}
 	else
 	{
@@ -326,11 +390,8 @@ PUBLIC void Source_set_par_int(Source *self, const char *name, const long int va
 	if(Source_par_exists(self, name, &index))
 	{
 		// If so, overwrite with new parameter information
+		Source_update_par(self, index, SOURCE_TYPE_INT, unit, ucd);
 		self->values[index].value_int = value;
-		self->types[index] = SOURCE_TYPE_INT;
-		String_set(self->names[index], name);
-		if(unit != NULL) String_set(self->units[index], unit);
-		if(ucd  != NULL) String_set(self->ucds [index], ucd);
 	}
 	else
 	{
@@ -359,7 +420,7 @@ PUBLIC void Source_set_par_int(Source *self, const char *name, const long int va
 PUBLIC double Source_get_par_flt(const Source *self, const size_t index)
 {
 	check_null(self);
-	ensure(index < self->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
+	ensure(index < self->schema->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
 	return self->values[index].value_flt;
 }
 
@@ -378,7 +439,7 @@ PUBLIC double Source_get_par_flt(const Source *self, const size_t index)
 PUBLIC long int Source_get_par_int(const Source *self, const size_t index)
 {
 	check_null(self);
-	ensure(index < self->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
+	ensure(index < self->schema->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
 	return self->values[index].value_int;
 }
 
@@ -400,7 +461,8 @@ PUBLIC double Source_get_par_by_name_flt(const Source *self, const char *name)
 {
 	check_null(self);
 	check_null(name);
-	for(size_t i = self->n_par; i--;) if(String_compare(self->names[i], name)) return self->values[i].value_flt;
+	const size_t column = Source_schema_find(self->schema, name);
+	if(column) return self->values[column - 1].value_flt;
 	warning_verb(self->verbosity, "Parameter \'%s\' not found.", name);
 	return NAN;
 }
@@ -423,7 +485,8 @@ PUBLIC long int Source_get_par_by_name_int(const Source *self, const char *name)
 {
 	check_null(self);
 	check_null(name);
-	for(size_t i = self->n_par; i--;) if(String_compare(self->names[i], name)) return self->values[i].value_int;
+	const size_t column = Source_schema_find(self->schema, name);
+	if(column) return self->values[column - 1].value_int;
 	warning_verb(self->verbosity, "Parameter \'%s\' not found.", name);
 	return 0;
 }
@@ -488,13 +551,12 @@ PUBLIC bool Source_par_exists(const Source *self, const char *name, size_t *inde
 	check_null(self);
 	check_null(name);
 	
-	for(size_t i = self->n_par; --i;)
+	const size_t column = Source_schema_find(self->schema, name);
+	
+	if(column)
 	{
-		if(String_compare(self->names[i], name))
-		{
-			if(index != NULL) *index = i;
-			return true;
-		}
+		if(index != NULL) *index = column - 1;
+		return true;
 	}
 	
 	return false;
@@ -516,8 +578,8 @@ PUBLIC bool Source_par_exists(const Source *self, const char *name, size_t *inde
 PUBLIC const char *Source_get_name(const Source *self, const size_t index)
 {
 	check_null(self);
-	ensure(index < self->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
-	return String_get(self->names[index]);
+	ensure(index < self->schema->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
+	return self->schema->names[index];
 }
 
 
@@ -536,8 +598,8 @@ PUBLIC const char *Source_get_name(const Source *self, const size_t index)
 PUBLIC const char *Source_get_unit(const Source *self, const size_t index)
 {
 	check_null(self);
-	ensure(index < self->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
-	return String_get(self->units[index]);
+	ensure(index < self->schema->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
+	return self->schema->units[index];
 }
 
 
@@ -556,8 +618,8 @@ PUBLIC const char *Source_get_unit(const Source *self, const size_t index)
 PUBLIC unsigned char Source_get_type(const Source *self, const size_t index)
 {
 	check_null(self);
-	ensure(index < self->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
-	return self->types[index];
+	ensure(index < self->schema->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
+	return self->schema->types[index];
 }
 
 
@@ -576,8 +638,8 @@ PUBLIC unsigned char Source_get_type(const Source *self, const size_t index)
 PUBLIC const char *Source_get_ucd(const Source *self, const size_t index)
 {
 	check_null(self);
-	ensure(index < self->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
-	return String_get(self->ucds[index]);
+	ensure(index < self->schema->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
+	return self->schema->ucds[index];
 }
 
 
@@ -612,7 +674,7 @@ PUBLIC const char *Source_get_identifier(const Source *self)
 PUBLIC size_t Source_get_num_par(const Source *self)
 {
 	check_null(self);
-	return self->n_par;
+	return self->schema->n_par;
 }
 
 
@@ -621,27 +683,276 @@ PUBLIC size_t Source_get_num_par(const Source *self)
 ///
 /// Private method for allocating additional memory for one more
 /// parameter in the specified source. Note that this will not
-/// create a new parameter yet, but just allocate the memory needed
-/// to append a parameter at the end of the parameter list. The
-/// function should be called from public member functions that will
-/// add parameters to a source prior to assigning the new parameter
-/// values.
+/// create a new parameter yet, but just ensure that memory for at
+/// least as many values as defined in the current schema of the
+/// source is available. The capacity will be doubled whenever it is
+/// exceeded to avoid reallocation each time a parameter is added.
+/// The function should be called from public member functions that
+/// will add parameters to a source after extending the schema and
+/// prior to assigning the new parameter values.
 ///
 /// @param self  Object self-reference.
 
 PRIVATE void Source_append_memory(Source *self)
 {
-	self->n_par += 1;
-	self->values = (SourceValue *)   memory_realloc(self->values, self->n_par, sizeof(SourceValue));
-	self->types  = (unsigned char *) memory_realloc(self->types,  self->n_par, sizeof(unsigned char));
-	self->names  = (String **)       memory_realloc(self->names,  self->n_par, sizeof(String *));
-	self->units  = (String **)       memory_realloc(self->units,  self->n_par, sizeof(String *));
-	self->ucds   = (String **)       memory_realloc(self->ucds,   self->n_par, sizeof(String *));
-	
-	// Call constructor on all strings
-	self->names[self->n_par - 1] = String_new("");
-	self->units[self->n_par - 1] = String_new("");
-	self->ucds [self->n_par - 1] = String_new("");
+	if(self->schema->n_par > self->capacity)
+	{
+		self->capacity = self->capacity ? 2 * self->capacity : 32;
+		if(self->capacity < self->schema->n_par) self->capacity = self->schema->n_par;
+		self->values = (SourceValue *)memory_realloc(self->values, self->capacity, sizeof(SourceValue));
+	}
+	
+	return;
+}
+
+
+
+/// @brief Define name, type, unit and UCD of parameter
+///
+/// Private method for defining the name, type, unit and UCD of the
+/// parameter with the specified index. If the index is equal to the
+/// current number of parameters, a new parameter will be appended.
+/// As schemas are shared between sources, this will switch the
+/// source over to a different schema in which the parameter has
+/// the requested definition, while all other parameters remain the
+/// same. Parameter values are not affected.
+///
+/// @param self   Object self-reference.
+/// @param index  Index of the parameter to be defined.
+/// @param type   Data type of the parameter.
+/// @param name   Name of the parameter.
+/// @param unit   Unit of the parameter.
+/// @param ucd    Unified Content Descriptor of the parameter.
+
+PRIVATE void Source_define_par(Source *self, const size_t index, const unsigned char type, const char *name, const char *unit, const char *ucd)
+{
+	#pragma omp critical(source_schema)
+	{
+		SourceSchema *schema = Source_schema_derive(self->schema, index, type, name, unit, ucd);
+		Source_schema_release(self->schema);
+		self->schema = schema;
+	}
+	
+	return;
+}
+
+
+
+/// @brief Update type, unit and UCD of existing parameter
+///
+/// Private method for updating the type, unit and UCD of the
+/// existing parameter with the specified index. If `unit` or `ucd`
+/// are `NULL`, the current unit or UCD will be retained. The schema
+/// of the source will only be changed if the definition of the
+/// parameter actually differs from the current one, so that updating
+/// just the parameter value remains cheap.
+///
+/// @param self   Object self-reference.
+/// @param index  Index of the parameter to be updated.
+/// @param type   New data type of the parameter.
+/// @param unit   New unit of the parameter or `NULL`.
+/// @param ucd    New Unified Content Descriptor or `NULL`.
+
+PRIVATE void Source_update_par(Source *self, const size_t index, const unsigned char type, const char *unit, const char *ucd)
+{
+	const SourceSchema *schema = self->schema;
+	if(unit == NULL) unit = schema->units[index];
+	if(ucd  == NULL) ucd  = schema->ucds[index];
+	
+	if(type != schema->types[index] || strcmp(unit, schema->units[index]) != 0 || strcmp(ucd, schema->ucds[index]) != 0)
+	{
+		Source_define_par(self, index, type, schema->names[index], unit, ucd);
+	}
 	
 	return;
 }
+
+
+
+/// @brief Derive new parameter schema
+///
+/// Private method for returning a schema that is equal to the
+/// specified one, except for the parameter with the specified index
+/// being defined by the specified name, type, unit and UCD. If the
+/// index is equal to the number of parameters of the original
+/// schema, a new parameter will be appended instead. If a matching
+/// schema has already been derived before, it will be reused;
+/// otherwise, a new schema will be created. The reference count of
+/// the returned schema will be incremented, and the caller will be
+/// responsible for releasing it again.
+///
+/// @param self   Schema from which to derive the new schema.
+/// @param index  Index of the parameter to be defined.
+/// @param type   Data type of the parameter.
+/// @param name   Name of the parameter.
+/// @param unit   Unit of the parameter.
+/// @param ucd    Unified Content Descriptor of the parameter.
+///
+/// @return Pointer to derived schema.
+///
+/// @note This function must only be called from within the
+///       `source_schema` critical section.
+
+PRIVATE SourceSchema *Source_schema_derive(SourceSchema *self, const size_t index, const unsigned char type, const char *name, const char *unit, const char *ucd)
+{
+	ensure(index <= self->n_par, ERR_INDEX_RANGE, "Source parameter index out of range.");
+	
+	// Check if matching schema has already been derived
+	for(size_t i = 0; i < self->n_children; ++i)
+	{
+		SourceSchema *child = self->children[i];
+		if(child->column == index && child->types[index] == type && strcmp(child->names[index], name) == 0 && strcmp(child->units[index], unit) == 0 && strcmp(child->ucds[index], ucd) == 0)
+		{
+			++child->n_refs;
+			return child;
+		}
+	}
+	
+	// Otherwise create new schema
+	SourceSchema *child = (SourceSchema *)memory(MALLOC, 1, sizeof(SourceSchema));
+	child->parent     = self;
+	child->children   = NULL;
+	child->n_children = 0;
+	child->n_refs     = 1;
+	child->n_par      = (index < self->n_par) ? self->n_par : self->n_par + 1;
+	child->column     = index;
+	child->types      = (unsigned char *)memory(MALLOC, child->n_par, sizeof(unsigned char));
+	child->names      = (const char **)  memory(MALLOC, child->n_par, sizeof(const char *));
+	child->units      = (const char **)  memory(MALLOC, child->n_par, sizeof(const char *));
+	child->ucds       = (const char **)  memory(MALLOC, child->n_par, sizeof(const char *));
+	
+	// Copy parameter definitions of parent, sharing their strings
+	if(self->n_par)
+	{
+		memcpy(child->types, self->types, self->n_par * sizeof(unsigned char));
+		memcpy(child->names, self->names, self->n_par * sizeof(const char *));
+		memcpy(child->units, self->units, self->n_par * sizeof(const char *));
+		memcpy(child->ucds,  self->ucds,  self->n_par * sizeof(const char *));
+	}
+	
+	// Add new parameter definition
+	const size_t size_name = strlen(name) + 1;
+	const size_t size_unit = strlen(unit) + 1;
+	const size_t size_ucd  = strlen(ucd)  + 1;
+	child->strings = (char *)memory(MALLOC, size_name + size_unit + size_ucd, sizeof(char));
+	memcpy(child->strings, name, size_name);
+	memcpy(child->strings + size_name, unit, size_unit);
+	memcpy(child->strings + size_name + size_unit, ucd, size_ucd);
+	
+	child->types[index] = type;
+	child->names[index] = child->strings;
+	child->units[index] = child->strings + size_name;
+	child->ucds [index] = child->strings + size_name + size_unit;
+	
+	// Create hash table of parameter names, keeping load factor at or below 0.5
+	child->n_slots = 16;
+	while(child->n_slots < 2 * child->n_par) child->n_slots *= 2;
+	child->index = (size_t *)memory(CALLOC, child->n_slots, sizeof(size_t));
+	
+	for(size_t i = 0; i < child->n_par; ++i) child->index[Source_schema_slot(child, child->names[i])] = i + 1;
+	
+	// Register new schema with parent
+	self->children = (SourceSchema **)memory_realloc(self->children, self->n_children + 1, sizeof(SourceSchema *));
+	self->children[self->n_children++] = child;
+	++self->n_refs;
+	
+	return child;
+}
+
+
+
+/// @brief Release parameter schema
+///
+/// Private method for decrementing the reference count of the
+/// specified schema. If the schema is no longer referenced, it will
+/// be removed from its parent and deleted, which in turn will
+/// release the parent schema.
+///
+/// @param self  Schema to be released.
+///
+/// @note This function must only be called from within the
+///       `source_schema` critical section.
+
+PRIVATE void Source_schema_release(SourceSchema *self)
+{
+	while(self != NULL && --self->n_refs == 0)
+	{
+		SourceSchema *parent = self->parent;
+		
+		// Remove schema from list of children of parent
+		for(size_t i = 0; i < parent->n_children; ++i)
+		{
+			if(parent->children[i] == self)
+			{
+				parent->children[i] = parent->children[--parent->n_children];
+				break;
+			}
+		}
+		
+		if(parent->n_children == 0)
+		{
+			free(parent->children);
+			parent->children = NULL;
+		}
+		
+		// Delete schema
+		free(self->types);
+		free(self->names);
+		free(self->units);
+		free(self->ucds);
+		free(self->strings);
+		free(self->index);
+		free(self);
+		
+		// Release reference to parent
+		self = parent;
+	}
+	
+	return;
+}
+
+
+
+/// @brief Find hash table slot of parameter name
+///
+/// Private method for returning the slot of the hash table of the
+/// specified schema that holds the specified parameter name, or the
+/// empty slot at which the name would have to be inserted if it does
+/// not yet exist. Collisions are resolved by linear probing.
+///
+/// @param self  Schema to be searched.
+/// @param name  Name of the parameter.
+///
+/// @return Slot of the parameter name in the hash table.
+
+PRIVATE size_t Source_schema_slot(const SourceSchema *self, const char *name)
+{
+	// FNV-1a hash of parameter name
+	size_t hash = 2166136261u;
+	for(const char *c = name; *c; ++c) hash = (hash ^ (unsigned char)*c) * 16777619u;
+	
+	const size_t mask = self->n_slots - 1;
+	size_t slot = hash & mask;
+	
+	while(self->index[slot] && strcmp(self->names[self->index[slot] - 1], name) != 0) slot = (slot + 1) & mask;
+	
+	return slot;
+}
+
+
+
+/// @brief Look up parameter by name
+///
+/// Private method for looking up the parameter of the specified name
+/// in the specified schema. If the name occurs more than once, the
+/// last occurrence will be returned.
+///
+/// @param self  Schema to be searched.
+/// @param name  Name of the parameter.
+///
+/// @return Index + 1 of the parameter, or 0 if not found.
+
+PRIVATE size_t Source_schema_find(const SourceSchema *self, const char *name)
+{
+	return self->n_par ? self->index[Source_schema_slot(self, name)] : 0;
+}
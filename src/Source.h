@@ -52,13 +52,17 @@
 // composed of a name, value, type and unit. Both long integer and   //
 // double-precision floating-point values are supported. In addi-    //
 // tion, a source can be assigned an identifier in the form of a     //
-// string, e.g. a source name.                                       //
+// string, e.g. a source name. Parameter names, types, units and     //
+// UCDs are kept in a schema shared by all sources with the same     //
+// parameter list, while each source only stores its values.         //
 // ----------------------------------------------------------------- //
 
 typedef CLASS Source Source;
+typedef struct SourceSchema SourceSchema;
 
 // Constructor and destructor
 PUBLIC  Source       *Source_new                 (const bool verbosity);
+PUBLIC  Source       *Source_copy                (const Source *source);
 PUBLIC  void          Source_delete              (Source *self);
 
 // Public methods
@@ -87,5 +91,11 @@ PUBLIC  const char   *Source_get_ucd             (const Source *self, const size
 
 // Private methods
 PRIVATE void          Source_append_memory       (Source *self);
+PRIVATE void          Source_define_par          (Source *self, const size_t index, const unsigned char type, const char *name, const char *unit, const char *ucd);
+PRIVATE void          Source_update_par          (Source *self, const size_t index, const unsigned char type, const char *unit, const char *ucd);
+PRIVATE SourceSchema *Source_schema_derive       (SourceSchema *self, const size_t index, const unsigned char type, const char *name, const char *unit, const char *ucd);
+PRIVATE void          Source_schema_release      (SourceSchema *self);
+PRIVATE size_t        Source_schema_slot         (const SourceSchema *self, const char *name);
+PRIVATE size_t        Source_schema_find         (const SourceSchema *self, const char *name);
 
 #endif
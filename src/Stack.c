@@ -52,8 +52,9 @@
 
 CLASS Stack
 {
-	size_t  size;  ///< Current size of the stack, i.e. number of elements stored.
-	size_t *data;  ///< Pointer to array of currently stored stack elements.
+	size_t  size;      ///< Current size of the stack, i.e. number of elements stored.
+	size_t  capacity;  ///< Number of elements memory is currently allocated for.
+	size_t *data;      ///< Pointer to array of currently stored stack elements.
 };
 
 
@@ -71,6 +72,7 @@ PUBLIC Stack *Stack_new(void)
 	Stack *self = (Stack *)memory(MALLOC, 1, sizeof(Stack));
 	
 	self->size = 0;
+	self->capacity = 0;
 	self->data = NULL;
 	
 	return self;
@@ -98,9 +100,9 @@ PUBLIC void Stack_delete(Stack *self)
 
 /// @brief Push element onto stack
 ///
-/// Public method for pushing a new element onto the stack. The
-/// stack will automatically expand its memory to hold the extra
-/// item and terminate with a stack overflow error if memory
+/// Public method for pushing a new element onto the stack. If the
+/// stack is full, its capacity will automatically be doubled, and
+/// the process will terminate with a stack overflow error if memory
 /// allocation fails.
 ///
 /// @param self   Object self-reference.
@@ -111,10 +113,9 @@ PUBLIC void Stack_push(Stack *self, const size_t value)
 	// Sanity checks
 	check_null(self);
 	
+	if(self->size == self->capacity) Stack_reserve(self, self->capacity ? 2 * self->capacity : 1024);
+	self->data[self->size] = value;
 	self->size += 1;
-	self->data = (size_t *)realloc(self->data, self->size * sizeof(size_t));
-	ensure(self->data != NULL, ERR_MEM_ALLOC, "Stack overflow error at %.5f GB memory usage.", (double)(self->size * sizeof(size_t)) / GIGABYTE);
-	self->data[self->size - 1] = value;
 	
 	return;
 }
@@ -124,10 +125,10 @@ PUBLIC void Stack_push(Stack *self, const size_t value)
 /// @brief Pop element from stack
 ///
 /// Public method for popping the last element from the stack. The
-/// stack will automatically adjust its memory allocation to the
-/// new, smaller size after popping. A stack underflow error will
-/// be raised and the process terminated if the method is called on
-/// an empty stack.
+/// memory allocation of the stack will be retained, so the stack can
+/// be reused without further reallocation. A stack underflow error
+/// will be raised and the process terminated if the method is called
+/// on an empty stack.
 ///
 /// @param self  Object self-reference.
 ///
@@ -140,21 +141,8 @@ PUBLIC size_t Stack_pop(Stack *self)
 	ensure(self->size, ERR_FAILURE, "Stack underflow error.");
 	check_null(self->data);
 	
-	const size_t value = self->data[self->size - 1];
 	self->size -= 1;
-	
-	if(self->size)
-	{
-		self->data = (size_t *)realloc(self->data, self->size * sizeof(size_t));
-		ensure(self->data != NULL, ERR_MEM_ALLOC, "Stack overflow error at %.5f GB memory usage.", (double)(self->size * sizeof(size_t)) / GIGABYTE);
-	}
-	else
-	{
-		free(self->data);
-		self->data = NULL;
-	}
-	
-	return value;
+	return self->data[self->size];
 }
 
 
@@ -173,3 +161,31 @@ PUBLIC size_t Stack_get_size(const Stack *self)
 	check_null(self);
 	return self->size;
 }
+
+
+
+/// @brief Reserve memory for stack elements
+///
+/// Public method for ensuring that memory for at least `capacity`
+/// elements is allocated, such that no further reallocation will
+/// be required until the stack grows beyond that size. Memory is
+/// never released by this method. The process will terminate with
+/// a stack overflow error if memory allocation fails.
+///
+/// @param self      Object self-reference.
+/// @param capacity  Number of elements to reserve memory for.
+
+PUBLIC void Stack_reserve(Stack *self, const size_t capacity)
+{
+	// Sanity checks
+	check_null(self);
+	
+	if(capacity > self->capacity)
+	{
+		self->data = (size_t *)realloc(self->data, capacity * sizeof(size_t));
+		ensure(self->data != NULL, ERR_MEM_ALLOC, "Stack overflow error at %.5f GB memory usage.", (double)(capacity * sizeof(size_t)) / GIGABYTE);
+		self->capacity = capacity;
+	}
+	
+	return;
+}
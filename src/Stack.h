@@ -60,5 +60,6 @@ PUBLIC void          Stack_delete   (Stack *self);
 PUBLIC void          Stack_push     (Stack *self, const size_t value);
 PUBLIC size_t        Stack_pop      (Stack *self);
 PUBLIC size_t        Stack_get_size (const Stack *self);
+PUBLIC void          Stack_reserve  (Stack *self, const size_t capacity);
 
 #endif
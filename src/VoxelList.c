@@ -0,0 +1,198 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (VoxelList.c) - Source Finding Application               //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+/// @file   VoxelList.c
+/// @date   14/10/2026
+/// @brief  Class implementing a compressed list of source voxels per label.
+
+
+#include <stdlib.h>
+
+#include "VoxelList.h"
+
+
+
+/// @brief Class implementing a compressed list of source voxels per label
+///
+/// The purpose of this class is to store the indices of all voxels
+/// belonging to each source label of a mask in compressed sparse row
+/// (CSR) layout. The voxels of label `i` are stored in `indices` from
+/// position `offsets[i]` to `offsets[i + 1] - 1`. The list is filled
+/// once via VoxelList_push() after the number of voxels per label has
+/// been established, and voxels are retained in the order they were
+/// pushed.
+
+CLASS VoxelList
+{
+	size_t  n_labels;  ///< Number of labels, including label 0.
+	size_t *offsets;   ///< Offset of the first voxel of each label (`n_labels + 1` elements).
+	size_t *cursor;    ///< Next free position for each label while filling the list.
+	size_t *indices;   ///< Voxel indices, grouped by label.
+};
+
+
+
+/// @brief Standard constructor
+///
+/// Standard constructor. Will create a new VoxelList object for the
+/// labels from 0 to `n_labels - 1`, reserving space for `counts[i]`
+/// voxels for label `i`. The voxels then need to be added using
+/// VoxelList_push(). Note that the destructor will need to be called
+/// explicitly once the object is no longer required to release its
+/// memory again.
+///
+/// @param counts    Array of `n_labels` elements specifying the
+///                  number of voxels of each label.
+/// @param n_labels  Number of labels, including label 0.
+///
+/// @return Pointer to newly created VoxelList object.
+
+PUBLIC VoxelList *VoxelList_new(const size_t *counts, const size_t n_labels)
+{
+	check_null(counts);
+	
+	VoxelList *self = (VoxelList *)memory(MALLOC, 1, sizeof(VoxelList));
+	
+	self->n_labels = n_labels;
+	self->offsets  = (size_t *)memory(MALLOC, n_labels + 1, sizeof(size_t));
+	self->cursor   = (size_t *)memory(MALLOC, n_labels + 1, sizeof(size_t));
+	
+	// Cumulative sum of counts
+	self->offsets[0] = 0;
+	for(size_t i = 0; i < n_labels; ++i) self->offsets[i + 1] = self->offsets[i] + counts[i];
+	for(size_t i = 0; i <= n_labels; ++i) self->cursor[i] = self->offsets[i];
+	
+	self->indices = (size_t *)memory(MALLOC, self->offsets[n_labels] ? self->offsets[n_labels] : 1, sizeof(size_t));
+	
+	return self;
+}
+
+
+
+/// @brief Destructor
+///
+/// Destructor. Note that the destructor must be called explicitly
+/// if the object is no longer required. This will release the
+/// memory occupied by the object.
+///
+/// @param self  Object self-reference.
+
+PUBLIC void VoxelList_delete(VoxelList *self)
+{
+	if(self != NULL)
+	{
+		free(self->offsets);
+		free(self->cursor);
+		free(self->indices);
+		free(self);
+	}
+	
+	return;
+}
+
+
+
+/// @brief Add voxel to list
+///
+/// Public method for adding the voxel with the specified index to
+/// the list of voxels of the specified label. The number of voxels
+/// added for each label must not exceed the count specified in the
+/// constructor.
+///
+/// @param self   Object self-reference.
+/// @param label  Label the voxel belongs to.
+/// @param index  Index of the voxel.
+
+PUBLIC void VoxelList_push(VoxelList *self, const size_t label, const size_t index)
+{
+	check_null(self);
+	ensure(label < self->n_labels, ERR_INDEX_RANGE, "Label %zu out of range.", label);
+	ensure(self->cursor[label] < self->offsets[label + 1], ERR_INDEX_RANGE, "Voxel list of label %zu is full.", label);
+	
+	self->indices[self->cursor[label]++] = index;
+	
+	return;
+}
+
+
+
+/// @brief Return number of labels
+///
+/// Public method for returning the number of labels of the specified
+/// voxel list, including label 0.
+///
+/// @param self  Object self-reference.
+///
+/// @return Number of labels.
+
+PUBLIC size_t VoxelList_get_labels(const VoxelList *self)
+{
+	check_null(self);
+	return self->n_labels;
+}
+
+
+
+/// @brief Return number of voxels of label
+///
+/// Public method for returning the number of voxels stored for the
+/// specified label. If the label is out of range, 0 will be returned.
+///
+/// @param self   Object self-reference.
+/// @param label  Label to be queried.
+///
+/// @return Number of voxels of the label.
+
+PUBLIC size_t VoxelList_get_size(const VoxelList *self, const size_t label)
+{
+	check_null(self);
+	return label < self->n_labels ? self->offsets[label + 1] - self->offsets[label] : 0;
+}
+
+
+
+/// @brief Return voxels of label
+///
+/// Public method for returning a pointer to the indices of the
+/// voxels of the specified label. The number of elements can be
+/// obtained from VoxelList_get_size(). If the label is out of range,
+/// `NULL` will be returned.
+///
+/// @param self   Object self-reference.
+/// @param label  Label to be queried.
+///
+/// @return Pointer to array of voxel indices.
+
+PUBLIC const size_t *VoxelList_get_voxels(const VoxelList *self, const size_t label)
+{
+	check_null(self);
+	return label < self->n_labels ? self->indices + self->offsets[label] : NULL;
+}
@@ -0,0 +1,66 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (VoxelList.h) - Source Finding Application               //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+/// @file   VoxelList.h
+/// @date   14/10/2026
+/// @brief  Class implementing a compressed list of source voxels per label (header).
+
+
+#ifndef VOXELLIST_H
+#define VOXELLIST_H
+
+#include "common.h"
+
+
+// ----------------------------------------------------------------- //
+// Class 'VoxelList'                                                 //
+// ----------------------------------------------------------------- //
+// The purpose of this class is to store the indices of all voxels   //
+// belonging to each source label of a mask in compressed sparse row //
+// (CSR) layout, i.e. as a single array of voxel indices grouped by  //
+// label plus an array of offsets into it. This allows algorithms to //
+// visit only the voxels of a source rather than rescanning its full //
+// bounding box in the mask cube.                                    //
+// ----------------------------------------------------------------- //
+
+typedef CLASS VoxelList VoxelList;
+
+// Constructor and destructor
+PUBLIC VoxelList    *VoxelList_new        (const size_t *counts, const size_t n_labels);
+PUBLIC void          VoxelList_delete     (VoxelList *self);
+
+// Public methods
+PUBLIC void          VoxelList_push       (VoxelList *self, const size_t label, const size_t index);
+PUBLIC size_t        VoxelList_get_labels (const VoxelList *self);
+PUBLIC size_t        VoxelList_get_size   (const VoxelList *self, const size_t label);
+PUBLIC const size_t *VoxelList_get_voxels (const VoxelList *self, const size_t label);
+
+#endif
@@ -36,6 +36,7 @@
 
 
 #include <stdlib.h>
+#include <limits.h>
 
 #include <wcslib/wcs.h>
 #include <wcslib/wcshdr.h>
@@ -109,6 +110,51 @@ PUBLIC WCS *WCS_new(const char *header, const int n_keys, const int n_axes, cons
 
 
 
+/// @brief Copy constructor
+///
+/// Copy constructor. Will create a new WCS object that is an exact
+/// copy of the specified source object and return a pointer to the
+/// newly created object. This is considerably faster than parsing
+/// the FITS header again and can be used to provide each thread
+/// with its own WCS object for concurrent coordinate conversion.
+/// Note that the destructor will need to be called explicitly once
+/// the object is no longer required.
+///
+/// @param source  Pointer to WCS object to be copied. Must be valid.
+///
+/// @return Pointer to newly created copy of the WCS object.
+
+PUBLIC WCS *WCS_copy(const WCS *source)
+{
+	// Sanity checks
+	ensure(WCS_is_valid(source), ERR_USER_INPUT, "Failed to copy WCS; no valid WCS definition found.");
+	
+	// Create new WCS object
+	WCS *self = (WCS *)memory(MALLOC, 1, sizeof(WCS));
+	
+	// Initialise properties
+	self->valid = false;
+	self->wcs_pars = (struct wcsprm *)memory(CALLOC, 1, sizeof(struct wcsprm));
+	self->wcs_pars->flag = -1;
+	self->n_wcs_rep = 1;
+	
+	int status = 0;
+	
+	// Copy all axes and set up derived parameters
+	#pragma omp critical(wcs_setup)
+	{
+		status = wcssub(true, source->wcs_pars, NULL, NULL, self->wcs_pars);
+		if(!status) status = wcsset(self->wcs_pars);
+	}
+	
+	if(status) warning("wcslib error %d: %s\n         Failed to copy WCS information.", status, wcs_errmsg[status]);
+	else self->valid = true;
+	
+	return self;
+}
+
+
+
 /// @brief Destructor
 ///
 /// Destructor. Note that the destructor must be called explicitly
@@ -179,23 +225,31 @@ PRIVATE void WCS_setup(WCS *self, const char *header, const int n_keys, const in
 	self->wcs_pars = (struct wcsprm *)memory(CALLOC, 1, sizeof(struct wcsprm));
 	self->wcs_pars->flag = -1;
 	
-	// Initialise wcsprm structure
-	int status = wcsini(true, n_axes, self->wcs_pars);
-	
-	// Parse the FITS header to fill in the wcsprm structure
-	if(!status) status = wcspih((char *)header, n_keys, WCSHDR_all, 0, &n_rejected, &self->n_wcs_rep, &self->wcs_pars);
-	// NOTE: The (char *) cast is necessary as wcspih would actually
-	//       manipulate the header if the 4th argument was negative!
+	int status = 0;
 	
-	// Apply all necessary corrections to wcsprm structure
-	// (missing cards, non-standard units or spectral types, etc.)
-	if(!status) status = wcsfix(1, dim_axes, self->wcs_pars, stat);
-	
-	// Set up additional parameters in wcsprm structure derived from imported data
-	if(!status) status = wcsset(self->wcs_pars);
-	
-	// Redo the corrections to account for things like NCP projections
-	if(!status) status = wcsfix(1, dim_axes, self->wcs_pars, stat);
+	// NOTE: The header parser of wcslib is not re-entrant, so WCS objects
+	//       must not be set up concurrently by multiple threads. Once set
+	//       up, each object can be used independently by its own thread.
+	#pragma omp critical(wcs_setup)
+	{
+		// Initialise wcsprm structure
+		status = wcsini(true, n_axes, self->wcs_pars);
+		
+		// Parse the FITS header to fill in the wcsprm structure
+		if(!status) status = wcspih((char *)header, n_keys, WCSHDR_all, 0, &n_rejected, &self->n_wcs_rep, &self->wcs_pars);
+		// NOTE: The (char *) cast is necessary as wcspih would actually
+		//       manipulate the header if the 4th argument was negative!
+		
+		// Apply all necessary corrections to wcsprm structure
+		// (missing cards, non-standard units or spectral types, etc.)
+		if(!status) status = wcsfix(1, dim_axes, self->wcs_pars, stat);
+		
+		// Set up additional parameters in wcsprm structure derived from imported data
+		if(!status) status = wcsset(self->wcs_pars);
+		
+		// Redo the corrections to account for things like NCP projections
+		if(!status) status = wcsfix(1, dim_axes, self->wcs_pars, stat);
+	}
 	
 	if(status)
 	{
@@ -224,7 +278,8 @@ PRIVATE void WCS_setup(WCS *self, const char *header, const int n_keys, const in
 /// `NULL`, in which case they are not updated. If invalid input
 /// coordinates are supplied by the user, then a warning message will
 /// be printed and the output coordinate variables will be left
-/// unchanged.
+/// unchanged. Use WCS_convertToWorld_batch() for converting large
+/// numbers of coordinates.
 ///
 /// @param self       Object self-reference.
 /// @param x          x coordinate (0-based).
@@ -235,118 +290,205 @@ PRIVATE void WCS_setup(WCS *self, const char *header, const int n_keys, const in
 /// @param spectral   Pointer for holding spectral coordinate.
 
 PUBLIC void WCS_convertToWorld(const WCS *self, const double x, const double y, const double z, double *longitude, double *latitude, double *spectral)
+{
+	const double pixel[3] = {x, y, z};
+	double world[3] = {longitude != NULL ? *longitude : 0.0, latitude != NULL ? *latitude : 0.0, spectral != NULL ? *spectral : 0.0};
+	
+	WCS_convertToWorld_batch(self, pixel, world, 1);
+	
+	// Pass back world coordinates
+	if(longitude != NULL) *longitude = world[0];
+	if(latitude  != NULL) *latitude  = world[1];
+	if(spectral  != NULL) *spectral  = world[2];
+	
+	return;
+}
+
+
+
+/// @brief Convert from world to pixel coordinates
+///
+/// Public method for converting the world coordinates (longitude,
+/// latitude, spectral) to world coordinates (x, y, z). Note that
+/// the implicit assumption is made that the first up-to-three axes
+/// of the cube are in the aforementioned order. Pixel coordinates
+/// will be zero-based; world coordinates must be in the native
+/// units of the data cube. X, y or z can be `NULL`, in which case
+/// they are not updated. If invalid input coordinates are supplied
+/// by the user, then a warning message will be printed and the
+/// output coordinate variables will be left unchanged. Use
+/// WCS_convertToPixel_batch() for converting large numbers of
+/// coordinates.
+///
+/// @param self       Object self-reference.
+/// @param longitude  Longitude coordinate.
+/// @param latitude   Latitude coordinate.
+/// @param spectral   Spectral coordinate.
+/// @param x          Pointer for holding x coordinate (0-based).
+/// @param y          Pointer for holding y coordinate (0-based).
+/// @param z          Pointer for holding z coordinate (0-based).
+
+PUBLIC void WCS_convertToPixel(const WCS *self, const double longitude, const double latitude, const double spectral, double *x, double *y, double *z)
+{
+	const double world[3] = {longitude, latitude, spectral};
+	double pixel[3] = {x != NULL ? *x : 0.0, y != NULL ? *y : 0.0, z != NULL ? *z : 0.0};
+	
+	WCS_convertToPixel_batch(self, world, pixel, 1);
+	
+	// Pass back pixel coordinates
+	if(x != NULL) *x = pixel[0];
+	if(y != NULL) *y = pixel[1];
+	if(z != NULL) *z = pixel[2];
+	
+	return;
+}
+
+
+
+/// @brief Convert array of pixel coordinates to world coordinates
+///
+/// Public method for converting `n` sets of pixel coordinates (x, y, z)
+/// to world coordinates (longitude, latitude, spectral) in a single call
+/// to wcslib. Both arrays must be of size `3 * n`, with the three
+/// coordinates of each point stored consecutively. The same assumptions
+/// as for WCS_convertToWorld() apply. If fewer than three WCS axes are
+/// defined, the surplus world coordinates will be left unchanged. If
+/// some of the input coordinates are invalid, a warning message will be
+/// printed and the corresponding world coordinates will be left
+/// unchanged, while all other points will still be converted. The method
+/// is thread-safe as long as each thread uses its own WCS object, e.g.
+/// one created with WCS_copy().
+///
+/// @param self   Object self-reference.
+/// @param pixel  Array of `3 * n` pixel coordinates (0-based).
+/// @param world  Array of `3 * n` elements for holding the world
+///               coordinates.
+/// @param n      Number of points to be converted.
+
+PUBLIC void WCS_convertToWorld_batch(const WCS *self, const double *pixel, double *world, const size_t n)
 {
 	// Sanity checks
 	ensure(WCS_is_valid(self), ERR_USER_INPUT, "Failed to convert coordinates; no valid WCS definition found.");
+	check_null(pixel);
+	check_null(world);
+	if(n == 0) return;
+	ensure(n <= INT_MAX, ERR_USER_INPUT, "Failed to convert coordinates; too many points.");
 	
 	// Determine number of WCS axes
 	const size_t n_axes = self->wcs_pars->naxis;
 	ensure(n_axes, ERR_USER_INPUT, "Failed to convert coordinates; no valid WCS axes found.");
 	
 	// Allocate memory for coordinate arrays
-	double *coord_pixel = (double *)memory(MALLOC, n_axes, sizeof(double));
-	double *coord_world = (double *)memory(MALLOC, n_axes, sizeof(double));
-	double *tmp_world   = (double *)memory(MALLOC, n_axes, sizeof(double));
+	double *coord_pixel = (double *)memory(MALLOC, n * n_axes, sizeof(double));
+	double *coord_world = (double *)memory(MALLOC, n * n_axes, sizeof(double));
+	double *tmp_world   = (double *)memory(MALLOC, n * n_axes, sizeof(double));
+	double *phi         = (double *)memory(MALLOC, n, sizeof(double));
+	double *theta       = (double *)memory(MALLOC, n, sizeof(double));
+	int    *stat        = (int *)memory(MALLOC, n, sizeof(int));
 	
 	// Initialise pixel coordinates
-	for(size_t i = 0; i < n_axes; ++i)
+	// NOTE: WCS pixel arrays are 1-based!!!
+	for(size_t j = 0; j < n; ++j)
 	{
-		// NOTE: WCS pixel arrays are 1-based!!!
-		if(i == 0)      coord_pixel[i] = 1.0 + x;
-		else if(i == 1) coord_pixel[i] = 1.0 + y;
-		else if(i == 2) coord_pixel[i] = 1.0 + z;
-		else            coord_pixel[i] = 1.0;
+		for(size_t i = 0; i < n_axes; ++i) coord_pixel[j * n_axes + i] = (i < 3) ? 1.0 + pixel[3 * j + i] : 1.0;
 	}
 	
-	// Declare a few variables
-	double phi;
-	double theta;
-	int stat;
-	
 	// Call WCS conversion module
-	int status = wcsp2s(self->wcs_pars, 1, n_axes, coord_pixel, tmp_world, &phi, &theta, coord_world, &stat);
-	if(!status)
+	int status = wcsp2s(self->wcs_pars, (int)n, n_axes, coord_pixel, tmp_world, phi, theta, coord_world, stat);
+	if(status) warning("wcslib error %d: %s", status, wcs_errmsg[status]);
+	
+	// Pass back world coordinates of all points successfully converted
+	if(!status || status == WCSERR_BAD_PIX)
 	{
-		// Pass back world coordinates
-		if(n_axes > 0 && longitude != NULL) *longitude = coord_world[0];
-		if(n_axes > 1 &&  latitude != NULL) *latitude  = coord_world[1];
-		if(n_axes > 2 &&  spectral != NULL) *spectral  = coord_world[2];
+		for(size_t j = 0; j < n; ++j)
+		{
+			if(stat[j]) continue;
+			for(size_t i = 0; i < n_axes && i < 3; ++i) world[3 * j + i] = coord_world[j * n_axes + i];
+		}
 	}
-	else warning("wcslib error %d: %s", status, wcs_errmsg[status]);
 	
 	// Clean up
 	free(coord_pixel);
 	free(coord_world);
 	free(tmp_world);
+	free(phi);
+	free(theta);
+	free(stat);
 	
 	return;
 }
 
 
 
-/// @brief Convert from world to pixel coordinates
+/// @brief Convert array of world coordinates to pixel coordinates
 ///
-/// Public method for converting the world coordinates (longitude,
-/// latitude, spectral) to world coordinates (x, y, z). Note that
-/// the implicit assumption is made that the first up-to-three axes
-/// of the cube are in the aforementioned order. Pixel coordinates
-/// will be zero-based; world coordinates must be in the native
-/// units of the data cube. X, y or z can be `NULL`, in which case
-/// they are not updated. If invalid input coordinates are supplied
-/// by the user, then a warning message will be printed and the
-/// output coordinate variables will be left unchanged.
+/// Public method for converting `n` sets of world coordinates (longitude,
+/// latitude, spectral) to pixel coordinates (x, y, z) in a single call
+/// to wcslib. Both arrays must be of size `3 * n`, with the three
+/// coordinates of each point stored consecutively. The same assumptions
+/// as for WCS_convertToPixel() apply. If fewer than three WCS axes are
+/// defined, the surplus pixel coordinates will be left unchanged. If
+/// some of the input coordinates are invalid, a warning message will be
+/// printed and the corresponding pixel coordinates will be left
+/// unchanged, while all other points will still be converted. The method
+/// is thread-safe as long as each thread uses its own WCS object, e.g.
+/// one created with WCS_copy().
 ///
-/// @param self       Object self-reference.
-/// @param longitude  Longitude coordinate.
-/// @param latitude   Latitude coordinate.
-/// @param spectral   Spectral coordinate.
-/// @param x          Pointer for holding x coordinate (0-based).
-/// @param y          Pointer for holding y coordinate (0-based).
-/// @param z          Pointer for holding z coordinate (0-based).
+/// @param self   Object self-reference.
+/// @param world  Array of `3 * n` world coordinates.
+/// @param pixel  Array of `3 * n` elements for holding the pixel
+///               coordinates (0-based).
+/// @param n      Number of points to be converted.
 
-PUBLIC void WCS_convertToPixel(const WCS *self, const double longitude, const double latitude, const double spectral, double *x, double *y, double *z)
+PUBLIC void WCS_convertToPixel_batch(const WCS *self, const double *world, double *pixel, const size_t n)
 {
 	// Sanity checks
 	ensure(WCS_is_valid(self), ERR_USER_INPUT, "Failed to convert coordinates; no valid WCS definition found.");
+	check_null(world);
+	check_null(pixel);
+	if(n == 0) return;
+	ensure(n <= INT_MAX, ERR_USER_INPUT, "Failed to convert coordinates; too many points.");
 	
 	// Determine number of WCS axes
 	const size_t n_axes = self->wcs_pars->naxis;
 	ensure(n_axes, ERR_USER_INPUT, "Failed to convert coordinates; no valid WCS axes found.");
 	
 	// Allocate memory for coordinate arrays
-	double *coord_pixel = (double *)memory(MALLOC, n_axes, sizeof(double));
-	double *coord_world = (double *)memory(MALLOC, n_axes, sizeof(double));
-	double *tmp_world   = (double *)memory(MALLOC, n_axes, sizeof(double));
+	double *coord_pixel = (double *)memory(MALLOC, n * n_axes, sizeof(double));
+	double *coord_world = (double *)memory(MALLOC, n * n_axes, sizeof(double));
+	double *tmp_world   = (double *)memory(MALLOC, n * n_axes, sizeof(double));
+	double *phi         = (double *)memory(MALLOC, n, sizeof(double));
+	double *theta       = (double *)memory(MALLOC, n, sizeof(double));
+	int    *stat        = (int *)memory(MALLOC, n, sizeof(int));
 	
-	// Initialise pixel coordinates
-	for(size_t i = 0; i < n_axes; ++i)
+	// Initialise world coordinates
+	for(size_t j = 0; j < n; ++j)
 	{
-		if(i == 0)      coord_world[i] = longitude;
-		else if(i == 1) coord_world[i] = latitude;
-		else if(i == 2) coord_world[i] = spectral;
-		else            coord_world[i] = 0.0;
+		for(size_t i = 0; i < n_axes; ++i) coord_world[j * n_axes + i] = (i < 3) ? world[3 * j + i] : 0.0;
 	}
 	
-	// Declare a few variables
-	double phi;
-	double theta;
-	int stat;
+	// Call WCS conversion module
+	int status = wcss2p(self->wcs_pars, (int)n, n_axes, coord_world, phi, theta, tmp_world, coord_pixel, stat);
+	if(status) warning("wcslib error %d: %s", status, wcs_errmsg[status]);
 	
-	int status = wcss2p(self->wcs_pars, 1, n_axes, coord_world, &phi, &theta, tmp_world, coord_pixel, &stat);
-	if(!status)
+	// Pass back pixel coordinates of all points successfully converted
+	// NOTE: WCS pixel arrays are 1-based!!!
+	if(!status || status == WCSERR_BAD_WORLD)
 	{
-		// Pass back pixel coordinates
-		// NOTE: WCS pixel arrays are 1-based!!!
-		if(n_axes > 0 && x != NULL) *x = coord_pixel[0] - 1.0;
-		if(n_axes > 1 && y != NULL) *y = coord_pixel[1] - 1.0;
-		if(n_axes > 2 && z != NULL) *z = coord_pixel[2] - 1.0;
+		for(size_t j = 0; j < n; ++j)
+		{
+			if(stat[j]) continue;
+			for(size_t i = 0; i < n_axes && i < 3; ++i) pixel[3 * j + i] = coord_pixel[j * n_axes + i] - 1.0;
+		}
 	}
-	else warning("wcslib error %d: %s", status, wcs_errmsg[status]);
 	
 	// Clean up
 	free(coord_pixel);
 	free(coord_world);
 	free(tmp_world);
+	free(phi);
+	free(theta);
+	free(stat);
 	
 	return;
 }
@@ -55,15 +55,18 @@
 typedef CLASS WCS WCS;
 
 // Constructor and destructor
-PUBLIC  WCS  *WCS_new            (const char *header, const int n_keys, const int n_axes, const int *dim_axes);
-PUBLIC  void  WCS_delete         (WCS *self);
+PUBLIC  WCS  *WCS_new                  (const char *header, const int n_keys, const int n_axes, const int *dim_axes);
+PUBLIC  WCS  *WCS_copy                 (const WCS *source);
+PUBLIC  void  WCS_delete               (WCS *self);
 
 // Public methods
-PUBLIC  bool  WCS_is_valid       (const WCS *self);
-PUBLIC  void  WCS_convertToWorld (const WCS *self, const double x, const double y, const double z, double *longitude, double *latitude, double *spectral);
-PUBLIC  void  WCS_convertToPixel (const WCS *self, const double longitude, const double latitude, const double spectral, double *x, double *y, double *z);
+PUBLIC  bool  WCS_is_valid             (const WCS *self);
+PUBLIC  void  WCS_convertToWorld       (const WCS *self, const double x, const double y, const double z, double *longitude, double *latitude, double *spectral);
+PUBLIC  void  WCS_convertToPixel       (const WCS *self, const double longitude, const double latitude, const double spectral, double *x, double *y, double *z);
+PUBLIC  void  WCS_convertToWorld_batch (const WCS *self, const double *pixel, double *world, const size_t n);
+PUBLIC  void  WCS_convertToPixel_batch (const WCS *self, const double *world, double *pixel, const size_t n);
 
 // Private methods
-PRIVATE void  WCS_setup          (WCS *self, const char *header, const int n_keys, const int n_axes, const int *dim_axes);
+PRIVATE void  WCS_setup                (WCS *self, const char *header, const int n_keys, const int n_axes, const int *dim_axes);
 
 #endif
@@ -568,3 +568,37 @@ void swap_byte_order(char *word, const size_t size)
 	
 	return;
 }
+
+
+
+/// @brief Determine extent of tile
+///
+/// Determines the core and the full extent, including overlap, of
+/// the tile with the specified index along each axis when dividing
+/// the region `bounds` into tiles of size `tile_size` that overlap
+/// their neighbours by `overlap` pixels. All positions are absolute
+/// pixel coordinates in the input cube.
+///
+/// @param index      Index of the tile along each of the 3 axes.
+/// @param bounds     Region covered by the tiles, given as minimum
+///                   and maximum along each of the 3 axes.
+/// @param tile_size  Core size of the tiles along each axis.
+/// @param overlap    Overlap of the tiles along each axis.
+/// @param core_min   Array of size 3 for holding the core minimum.
+/// @param core_max   Array of size 3 for holding the core maximum.
+/// @param tile_min   Array of size 3 for holding the tile minimum.
+/// @param tile_max   Array of size 3 for holding the tile maximum.
+
+void tile_extent(const size_t *index, const size_t *bounds, const size_t *tile_size, const size_t *overlap, size_t *core_min, size_t *core_max, size_t *tile_min, size_t *tile_max)
+{
+	for(size_t i = 0; i < 3; ++i)
+	{
+		core_min[i] = bounds[2 * i] + index[i] * tile_size[i];
+		core_max[i] = core_min[i] + tile_size[i] - 1;
+		if(core_max[i] > bounds[2 * i + 1]) core_max[i] = bounds[2 * i + 1];
+		tile_min[i] = core_min[i] >= bounds[2 * i] + overlap[i] ? core_min[i] - overlap[i] : bounds[2 * i];
+		tile_max[i] = core_max[i] + overlap[i] <= bounds[2 * i + 1] ? core_max[i] + overlap[i] : bounds[2 * i + 1];
+	}
+	
+	return;
+}
@@ -86,6 +86,18 @@ enum {MALLOC, CALLOC};  // Define memory allocation modes
 #define MEGABYTE    1048576  ///< Size of a megabyte (in bytes).
 #define GIGABYTE 1073741824  ///< Size of a gigabyte (in bytes).
 
+// Define runtime dispatch of vectorised kernels
+// NOTE: On x86-64 with GCC or Clang, functions marked as SIMD_DISPATCH
+//       are compiled for AVX-512, AVX2 and the generic instruction set,
+//       and the best variant is selected via CPUID when the program is
+//       loaded. On AArch64, NEON is part of the base instruction set
+//       and hence always used. Define NO_SIMD_DISPATCH to disable.
+#if !defined(NO_SIMD_DISPATCH) && defined(__x86_64__) && defined(__ELF__) && ((defined(__clang__) && __clang_major__ >= 14) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 6))
+#define SIMD_DISPATCH __attribute__((target_clones("avx512f", "avx2", "default")))  ///< Compile function for several instruction sets with runtime dispatch.
+#else
+#define SIMD_DISPATCH  ///< Runtime dispatch not available.
+#endif
+
 // Define object-oriented terminology
 #define CLASS struct    ///< Define `CLASS` as alias of `struct` (in analogy to C++ '`class`').
 #define PUBLIC extern   ///< Define `PUBLIC` as alias of `extern` (in analogy to C++ '`public`').
@@ -143,4 +155,7 @@ void write_eps_footer(FILE *fp);
 bool is_little_endian(void);
 void swap_byte_order(char *word, const size_t size);
 
+// Tiling
+void tile_extent(const size_t *index, const size_t *bounds, const size_t *tile_size, const size_t *overlap, size_t *core_min, size_t *core_max, size_t *tile_min, size_t *tile_max);
+
 #endif
@@ -0,0 +1,85 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (sofia.h) - Source Finding Application                   //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+
+/// @file   sofia.h
+/// @date   14/10/2026
+/// @brief  Public interface of the SoFiA library (libsofia).
+
+
+#ifndef SOFIA_H
+#define SOFIA_H
+
+
+// ----------------------------------------------------------------- //
+// SoFiA library interface                                           //
+// ----------------------------------------------------------------- //
+// Applications linking against libsofia.a or libsofia.so only need  //
+// to include this header to gain access to all pipeline stages. A   //
+// data cube already held in memory can be processed without writing //
+// it to disk by wrapping it with DataCube_wrap(), which does not    //
+// copy the data. The typical sequence of calls is:                  //
+//                                                                   //
+//   1. DataCube_wrap()          - wrap caller's 32-bit float array  //
+//   2. DataCube_run_scfind()    - run S+C finder into a BitMask     //
+//   3. DataCube_copy_bitmask()  - copy BitMask into a 32-bit mask,  //
+//                                 e.g. wrapping caller's int array  //
+//   4. DataCube_run_linker()    - link detected pixels into sources //
+//   5. LinkerPar_reliability()  - optional reliability filtering    //
+//   6. LinkerPar_make_catalog() - create in-memory source catalogue //
+//   7. DataCube_parameterise()  - measure source parameters         //
+//                                                                   //
+// Note that the wrapped data cube will be modified in place by pre- //
+// processing steps such as flagging or noise normalisation. Errors  //
+// are handled by ensure(), which will terminate the process.        //
+// ----------------------------------------------------------------- //
+
+#include "common.h"
+#include "Array_dbl.h"
+#include "Array_siz.h"
+#include "BitMask.h"
+#include "Catalog.h"
+#include "DataCube.h"
+#include "Flagger.h"
+#include "Header.h"
+#include "LinkerPar.h"
+#include "Map.h"
+#include "Matrix.h"
+#include "Parameter.h"
+#include "Path.h"
+#include "Profiler.h"
+#include "Source.h"
+#include "String.h"
+#include "Table.h"
+#include "VoxelList.h"
+#include "WCS.h"
+
+#endif
@@ -51,6 +51,18 @@
 // -------------------------- //
 #define BOXCAR_MIN_ITER 3  ///< Minimum number of iterations required for boxcar approximation of Gaussian smoothing kernel.
 #define BOXCAR_MAX_ITER 6  ///< Maximum number of iterations allowed for boxcar approximation of Gaussian smoothing kernel.
+#define FILTER_BLOCK_SIZE 16  ///< Number of adjacent columns filtered together by filter_gauss_2d_dbl().
+
+// -------------------------------- //
+// Settings for histogram-based MAD //
+// -------------------------------- //
+#define MAD_HIST_OCTAVES  32  ///< Number of factors of 2 below the maximum covered by the histogram of absolute deviations.
+#define MAD_HIST_MAX_BITS 12  ///< Maximum number of mantissa bits used to define histogram bins, limiting the achievable tolerance.
+
+// ------------------------------- //
+// Settings for vectorised kernels //
+// ------------------------------- //
+#define SIMD_LANES 16  ///< Number of independent lanes used by vectorised kernels; fixed to ensure identical results on all instruction sets.
 
 
 
@@ -88,6 +100,9 @@ double median_dbl(double *data, const size_t size, const bool fast);
 double median_safe_dbl(const double *data, const size_t size, const bool fast);
 double mad_dbl(double *data, const size_t size);
 double mad_val_dbl(const double *data, const size_t size, const double value, const size_t cadence, const int range);
+double mad_val_capped_dbl(const double *data, const size_t size, const double value, const size_t cadence, const int range, const size_t max_samples);
+double mad_val_hist_dbl(const double *data, const size_t size, const double value, const size_t cadence, const int range, const double tolerance);
+double mad_val_hist_capped_dbl(const double *data, const size_t size, const double value, const size_t cadence, const int range, const double tolerance, const size_t max_samples);
 
 // Robust and fast noise measurement
 double robust_noise_dbl(const double *data, const size_t size);
@@ -97,6 +112,7 @@ double robust_noise_in_region_dbl(const double *data, const size_t nx, const siz
 // Gaussian fit to histogram
 size_t *create_histogram_dbl(const double *data, const size_t size, const size_t n_bins, const double data_min, const double data_max, const size_t cadence);
 double gaufit_dbl(const double *data, const size_t size, const size_t cadence, const int range);
+double gaufit_limits_dbl(const double *data, const size_t size, const size_t cadence, const int range, double data_min, double data_max);
 
 // Skewness and kurtosis
 void skew_kurt_dbl(const double *data, const size_t size, double *skew, double *kurt);
@@ -105,6 +121,7 @@ double kurtosis_dbl(const double *data, const size_t size);
 
 // 1D boxcar filter
 void filter_boxcar_1d_dbl(double *data, double *data_copy, const size_t size, const size_t filter_radius);
+void filter_boxcar_1d_block_dbl(double *data, double *data_copy, const size_t size, const size_t filter_radius, const size_t width);
 
 // 2D Gaussian filter
 void filter_gauss_2d_dbl(double *data, double *data_copy, double *data_row, double *data_col, const size_t size_x, const size_t size_y, const size_t n_iter, const size_t filter_radius);
@@ -51,6 +51,18 @@
 // -------------------------- //
 #define BOXCAR_MIN_ITER 3  ///< Minimum number of iterations required for boxcar approximation of Gaussian smoothing kernel.
 #define BOXCAR_MAX_ITER 6  ///< Maximum number of iterations allowed for boxcar approximation of Gaussian smoothing kernel.
+#define FILTER_BLOCK_SIZE 16  ///< Number of adjacent columns filtered together by filter_gauss_2d_flt().
+
+// -------------------------------- //
+// Settings for histogram-based MAD //
+// -------------------------------- //
+#define MAD_HIST_OCTAVES  32  ///< Number of factors of 2 below the maximum covered by the histogram of absolute deviations.
+#define MAD_HIST_MAX_BITS 12  ///< Maximum number of mantissa bits used to define histogram bins, limiting the achievable tolerance.
+
+// ------------------------------- //
+// Settings for vectorised kernels //
+// ------------------------------- //
+#define SIMD_LANES 16  ///< Number of independent lanes used by vectorised kernels; fixed to ensure identical results on all instruction sets.
 
 
 
@@ -88,6 +100,9 @@ float median_flt(float *data, const size_t size, const bool fast);
 float median_safe_flt(const float *data, const size_t size, const bool fast);
 float mad_flt(float *data, const size_t size);
 float mad_val_flt(const float *data, const size_t size, const float value, const size_t cadence, const int range);
+float mad_val_capped_flt(const float *data, const size_t size, const float value, const size_t cadence, const int range, const size_t max_samples);
+float mad_val_hist_flt(const float *data, const size_t size, const float value, const size_t cadence, const int range, const double tolerance);
+float mad_val_hist_capped_flt(const float *data, const size_t size, const float value, const size_t cadence, const int range, const double tolerance, const size_t max_samples);
 
 // Robust and fast noise measurement
 float robust_noise_flt(const float *data, const size_t size);
@@ -97,6 +112,7 @@ float robust_noise_in_region_flt(const float *data, const size_t nx, const size_
 // Gaussian fit to histogram
 size_t *create_histogram_flt(const float *data, const size_t size, const size_t n_bins, const float data_min, const float data_max, const size_t cadence);
 float gaufit_flt(const float *data, const size_t size, const size_t cadence, const int range);
+float gaufit_limits_flt(const float *data, const size_t size, const size_t cadence, const int range, float data_min, float data_max);
 
 // Skewness and kurtosis
 void skew_kurt_flt(const float *data, const size_t size, double *skew, double *kurt);
@@ -105,6 +121,7 @@ double kurtosis_flt(const float *data, const size_t size);
 
 // 1D boxcar filter
 void filter_boxcar_1d_flt(float *data, float *data_copy, const size_t size, const size_t filter_radius);
+void filter_boxcar_1d_block_flt(float *data, float *data_copy, const size_t size, const size_t filter_radius, const size_t width);
 
 // 2D Gaussian filter
 void filter_gauss_2d_flt(float *data, float *data_copy, float *data_row, float *data_col, const size_t size_x, const size_t size_y, const size_t n_iter, const size_t filter_radius);
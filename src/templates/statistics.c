@@ -53,17 +53,27 @@
 /// @brief Check if data contains `NaN`
 ///
 /// Checks if the data array contains values of Not a
-/// Number (`NaN`).
+/// Number (`NaN`). The array is checked in blocks of
+/// 64 * `SIMD_LANES` elements to allow for vectorisation.
 ///
 /// @param data  Pointer to the input data array.
 /// @param size  Size of the input data array.
 ///
 /// @return True if `NaN` found, false otherwise.
 
-bool contains_nan_SFX(const DATA_T *data, const size_t size)
+SIMD_DISPATCH bool contains_nan_SFX(const DATA_T *data, const size_t size)
 {
-	const DATA_T *ptr = data + size;
-	while(ptr --> data) if(IS_NAN(*ptr)) return true;
+	const size_t block = 64 * SIMD_LANES;
+	size_t i = 0;
+	
+	for(; i + block <= size; i += block)
+	{
+		int found = 0;
+		for(size_t j = i; j < i + block; ++j) found |= IS_NAN(data[j]);
+		if(found) return true;
+	}
+	
+	for(; i < size; ++i) if(IS_NAN(data[i])) return true;
 	return false;
 }
 
@@ -108,14 +118,15 @@ bool contains_inf_SFX(DATA_T *data, const size_t size, const bool flag_inf)
 /// the max() and min() functions separately in situations
 /// where both values are required. If the array contains
 /// only `NaN`, `value_min` and `value_max` will both be
-/// set to `NaN`.
+/// set to `NaN`. Separate extrema are tracked for each of
+/// `SIMD_LANES` lanes to allow for vectorisation.
 ///
 /// @param data       Pointer to the input data array.
 /// @param size       Size of the input data array.
 /// @param value_max  Pointer to variable for holding maximum.
 /// @param value_min  Pointer to variable for holding minimum.
 
-void max_min_SFX(const DATA_T *data, const size_t size, DATA_T *value_max, DATA_T *value_min)
+SIMD_DISPATCH void max_min_SFX(const DATA_T *data, const size_t size, DATA_T *value_max, DATA_T *value_min)
 {
 	// Find the last non-NaN element
 	const DATA_T *ptr = data + size - 1;
@@ -125,11 +136,36 @@ void max_min_SFX(const DATA_T *data, const size_t size, DATA_T *value_max, DATA_
 	*value_min = *ptr;
 	*value_max = *ptr;
 	
+	DATA_T lane_min[SIMD_LANES];
+	DATA_T lane_max[SIMD_LANES];
+	for(size_t j = 0; j < SIMD_LANES; ++j) lane_min[j] = lane_max[j] = *ptr;
+	
 	// Check remaining elements
-	for(const DATA_T *ptr2 = ptr; ptr2 --> data;)
+	const size_t n = ptr - data;
+	size_t i = 0;
+	
+	for(; i + SIMD_LANES <= n; i += SIMD_LANES)
+	{
+		#pragma GCC unroll 1
+		for(size_t j = 0; j < SIMD_LANES; ++j)
+		{
+			const DATA_T value = data[i + j];
+			lane_min[j] = value < lane_min[j] ? value : lane_min[j];
+			lane_max[j] = value > lane_max[j] ? value : lane_max[j];
+		}
+	}
+	
+	for(; i < n; ++i)
+	{
+		if(data[i] < *value_min) *value_min = data[i];
+		else if(data[i] > *value_max) *value_max = data[i];
+	}
+	
+	// Combine lanes
+	for(size_t j = 0; j < SIMD_LANES; ++j)
 	{
-		if(*ptr2 < *value_min) *value_min = *ptr2;
-		else if(*ptr2 > *value_max) *value_max = *ptr2;
+		if(lane_min[j] < *value_min) *value_min = lane_min[j];
+		if(lane_max[j] > *value_max) *value_max = lane_max[j];
 	}
 	
 	return;
@@ -191,7 +227,10 @@ DATA_T min_SFX(const DATA_T *data, const size_t size)
 /// mean of the non-`NaN` elements of the input array is
 /// returned. Two convenient wrapper functions, sum() and
 /// mean(), have been provided to explicitly return the sum
-/// and the mean of the array, respectively.
+/// and the mean of the array, respectively. Partial sums are
+/// accumulated in a fixed number of `SIMD_LANES` lanes to allow
+/// for vectorisation while keeping the result independent of the
+/// instruction set used.
 ///
 /// @param data  Pointer to the input data array.
 /// @param size  Size of the input data array.
@@ -200,17 +239,37 @@ DATA_T min_SFX(const DATA_T *data, const size_t size)
 /// @return Sum or mean of the data array. `NaN` will be returned for
 ///         `NaN`-only input arrays.
 
-double summation_SFX(const DATA_T *data, const size_t size, const bool mean)
+SIMD_DISPATCH double summation_SFX(const DATA_T *data, const size_t size, const bool mean)
 {
 	double result = 0.0;
 	size_t counter = 0;
-	const DATA_T *ptr = data + size;
+	double lane_sum[SIMD_LANES] = {0.0};
+	size_t lane_cnt[SIMD_LANES] = {0};
+	size_t i = 0;
 	
-	while(ptr --> data)
+	for(; i + SIMD_LANES <= size; i += SIMD_LANES)
 	{
-		if(IS_NOT_NAN(*ptr))
+		#pragma GCC unroll 1
+		for(size_t j = 0; j < SIMD_LANES; ++j)
 		{
-			result += *ptr;
+			const double value = data[i + j];
+			lane_sum[j] += IS_NOT_NAN(value) ? value : 0.0;
+			lane_cnt[j] += IS_NOT_NAN(value);
+		}
+	}
+	
+	// Combine lanes and add remaining elements
+	for(size_t j = 0; j < SIMD_LANES; ++j)
+	{
+		result += lane_sum[j];
+		counter += lane_cnt[j];
+	}
+	
+	for(; i < size; ++i)
+	{
+		if(IS_NOT_NAN(data[i]))
+		{
+			result += data[i];
 			++counter;
 		}
 	}
@@ -360,7 +419,9 @@ void moments_SFX(const DATA_T *data, const size_t size, const double value, doub
 ///   sqrt[sum(x - value)^2 / n]
 ///
 /// where the summation is over all n non-`NaN` elements, x,
-/// of the input array.
+/// of the input array. Partial sums are accumulated in a fixed
+/// number of `SIMD_LANES` lanes to allow for vectorisation while
+/// keeping the result independent of the instruction set used.
 ///
 /// @param data     Pointer to the input data array.
 /// @param size     Size of the input data array.
@@ -374,21 +435,46 @@ void moments_SFX(const DATA_T *data, const size_t size, const double value, doub
 ///         the elements in the input data array. `NaN` will
 ///         be returned for `NaN`-only input arrays.
 
-double std_dev_val_SFX(const DATA_T *data, const size_t size, const double value, const size_t cadence, const int range)
+SIMD_DISPATCH double std_dev_val_SFX(const DATA_T *data, const size_t size, const double value, const size_t cadence, const int range)
 {
-	const DATA_T *ptr = data + size;
-	const DATA_T *ptr2 = data + cadence - 1;
+	// Sample i is element size - (i + 1) * cadence
+	const size_t n_samples = size / cadence;
+	const bool range_full = range == 0;
+	const bool range_neg  = range < 0;
+	const bool range_pos  = range > 0;
 	double result = 0.0;
 	size_t counter = 0;
-	double tmp;
+	double lane_sum[SIMD_LANES] = {0.0};
+	size_t lane_cnt[SIMD_LANES] = {0};
+	size_t i = 0;
 	
-	while(ptr > ptr2)
+	for(; i + SIMD_LANES <= n_samples; i += SIMD_LANES)
 	{
-		ptr -= cadence;
+		#pragma GCC unroll 1
+		for(size_t j = 0; j < SIMD_LANES; ++j)
+		{
+			const double x = data[size - (i + j + 1) * cadence];
+			const bool use = (range_full & IS_NOT_NAN(x)) | (range_neg & (x < 0.0)) | (range_pos & (x > 0.0));
+			const double tmp = x - value;
+			lane_sum[j] += use ? tmp * tmp : 0.0;
+			lane_cnt[j] += use;
+		}
+	}
+	
+	// Combine lanes and add remaining samples
+	for(size_t j = 0; j < SIMD_LANES; ++j)
+	{
+		result += lane_sum[j];
+		counter += lane_cnt[j];
+	}
+	
+	for(; i < n_samples; ++i)
+	{
+		const double x = data[size - (i + 1) * cadence];
 		
-		if((range == 0 && IS_NOT_NAN(*ptr)) || (range < 0 && *ptr < 0.0) || (range > 0 && *ptr > 0.0))
+		if((range == 0 && IS_NOT_NAN(x)) || (range < 0 && x < 0.0) || (range > 0 && x > 0.0))
 		{
-			tmp = (*ptr - value);
+			const double tmp = x - value;
 			result += tmp * tmp;
 			++counter;
 		}
@@ -552,9 +638,37 @@ DATA_T median_safe_SFX(const DATA_T *data, const size_t size, const bool fast)
 /// the specified data value.
 
 DATA_T mad_val_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range)
+{
+	return mad_val_capped_SFX(data, size, value, cadence, range, (range == 0) ? (size / cadence) : (size / (2 * cadence)));
+}
+
+
+
+/// @brief Median absolute deviation from value with sample limit
+///
+/// Same as mad_val_SFX(), but with the maximum number of valid
+/// samples used in the calculation of the MAD specified by the
+/// user instead of being derived from `size`. This allows the
+/// MAD of a sample that was extracted from a larger array to
+/// be calculated with the same sample limit as that of the
+/// original array.
+///
+/// @param data         Pointer to the data array.
+/// @param size         Size of the input array.
+/// @param value        Value about which to calculate the MAD.
+/// @param cadence      Can be set to > 1 to speed up algorithm.
+/// @param range        Flux range to be used. Can be Negative
+///                     (-1), Full (0) or Positive (1).
+/// @param max_samples  Maximum number of valid samples to be
+///                     used.
+///
+/// @return Median absolute deviation of the array values from
+/// the specified data value.
+
+DATA_T mad_val_capped_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range, const size_t max_samples)
 {
 	// Create copy of data array with specified range and cadence
-	const size_t data_copy_size = (range == 0) ? (size / cadence) : (size / (2 * cadence));
+	const size_t data_copy_size = max_samples;
 	DATA_T *data_copy = (DATA_T *)memory(MALLOC, data_copy_size, sizeof(DATA_T));
 	
 	// Some settings
@@ -583,6 +697,188 @@ DATA_T mad_val_SFX(const DATA_T *data, const size_t size, const DATA_T value, co
 
 
 
+/// @brief Approximate median absolute deviation from value
+///
+/// Calculates an approximation of the median absolute deviation
+/// (MAD) of the data array values from a user-specified value,
+/// with a relative error not exceeding `tolerance`. Unlike
+/// mad_val_SFX(), no copy of the data is made. Instead, the
+/// absolute deviations, |x - value|, are sorted into a histogram
+/// with logarithmically spaced bins derived from the bit pattern
+/// of their single-precision representation, such that the
+/// relative width of each bin does not exceed twice the specified
+/// tolerance. After a first pass to determine the largest absolute
+/// deviation, the histogram is filled in a second, parallel pass,
+/// and the median is derived from the centre of the bin(s) holding
+/// the central element(s) of the sample. The sample is drawn with
+/// exactly the same cadence, range and size limit as in
+/// mad_val_SFX(), such that the error bound applies to the exact
+/// result of the latter. The histogram covers
+/// `MAD_HIST_OCTAVES` factors of 2 below the largest deviation.
+/// If the median falls below that range, or if the requested
+/// tolerance is smaller than what can be achieved with at most
+/// `MAD_HIST_MAX_BITS` bits of the mantissa, the exact result
+/// from mad_val_SFX() will be returned instead.
+///
+/// @param data       Pointer to the data array.
+/// @param size       Size of the input array.
+/// @param value      Value about which to calculate the MAD.
+/// @param cadence    Can be set to > 1 to speed up algorithm.
+/// @param range      Flux range to be used. Can be -1 (negative),
+///                   0 (full) or +1 (positive).
+/// @param tolerance  Maximum relative error of the result. If
+///                   zero, the exact MAD will be returned.
+///
+/// @return Approximate MAD of the data array values. `NaN` will be
+///         returned if no valid data are found.
+///
+/// @note This function **is** `NaN`-safe and will **not** modify
+/// the original data array.
+
+DATA_T mad_val_hist_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range, const double tolerance)
+{
+	const size_t step = cadence ? cadence : 1;
+	return mad_val_hist_capped_SFX(data, size, value, step, range, tolerance, (range == 0) ? (size / step) : (size / (2 * step)));
+}
+
+
+
+/// @brief Approximate median absolute deviation with sample limit
+///
+/// Same as mad_val_hist_SFX(), but with the maximum number of
+/// valid samples specified by the user instead of being derived
+/// from `size`, in analogy to mad_val_capped_SFX(), which will
+/// also be used to calculate the exact MAD where needed.
+///
+/// @param data         Pointer to the data array.
+/// @param size         Size of the input array.
+/// @param value        Value about which to calculate the MAD.
+/// @param cadence      Can be set to > 1 to speed up algorithm.
+/// @param range        Flux range to be used. Can be -1 (negative),
+///                     0 (full) or +1 (positive).
+/// @param tolerance    Maximum relative error of the result. If
+///                     zero, the exact MAD will be returned.
+/// @param max_samples  Maximum number of valid samples to be
+///                     used.
+///
+/// @return Approximate MAD of the data array values. `NaN` will be
+///         returned if no valid data are found.
+
+DATA_T mad_val_hist_capped_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range, const double tolerance, const size_t max_samples)
+{
+	// Number of mantissa bits needed to achieve tolerance
+	int bits = 0;
+	while(bits <= MAD_HIST_MAX_BITS && ldexp(1.0, -bits - 1) > tolerance) ++bits;
+	if(tolerance <= 0.0 || bits > MAD_HIST_MAX_BITS) return mad_val_capped_SFX(data, size, value, cadence, range, max_samples);
+	
+	// Sample elements size - k * cadence for k = 1, 2, ..., excluding
+	// the first element, and limit the number of valid samples to the
+	// specified maximum
+	const int shift = 23 - bits;
+	const size_t step = cadence ? cadence : 1;
+	size_t n_samples = size ? (size - 1) / step : 0;
+	
+	// First pass: determine largest absolute deviation
+	float dev_max = 0.0;
+	size_t counter = 0;
+	
+	#pragma omp parallel for schedule(static) reduction(max: dev_max) reduction(+: counter)
+	for(size_t i = 0; i < n_samples; ++i)
+	{
+		const DATA_T x = data[size - (i + 1) * step];
+		if((range == 0 && IS_NOT_NAN(x)) || (range < 0 && x < 0.0) || (range > 0 && x > 0.0))
+		{
+			const float dev = fabs(x - value);
+			if(dev > dev_max) dev_max = dev;
+			++counter;
+		}
+	}
+	
+	// Drop trailing samples beyond the maximum
+	// NOTE: dev_max may still include dropped samples, which merely
+	//       extends the histogram range without affecting the result.
+	while(counter > max_samples)
+	{
+		const DATA_T x = data[size - (n_samples--) * step];
+		if((range == 0 && IS_NOT_NAN(x)) || (range < 0 && x < 0.0) || (range > 0 && x > 0.0)) --counter;
+	}
+	
+	if(counter == 0) return NAN;
+	
+	// Set up histogram bins, with bin 0 collecting all values below range
+	uint32_t key_max;
+	memcpy(&key_max, &dev_max, sizeof(uint32_t));
+	key_max >>= shift;
+	const uint32_t key_min = key_max > ((uint32_t)(MAD_HIST_OCTAVES) << bits) ? key_max - ((uint32_t)(MAD_HIST_OCTAVES) << bits) : 0;
+	const size_t n_bins = key_max - key_min + 2;
+	size_t *histogram = (size_t *)memory(CALLOC, n_bins, sizeof(size_t));
+	
+	// Second pass: fill histogram in parallel
+	#pragma omp parallel
+	{
+		size_t *histogram_local = (size_t *)memory(CALLOC, n_bins, sizeof(size_t));
+		
+		#pragma omp for schedule(static)
+		for(size_t i = 0; i < n_samples; ++i)
+		{
+			const DATA_T x = data[size - (i + 1) * step];
+			if((range == 0 && IS_NOT_NAN(x)) || (range < 0 && x < 0.0) || (range > 0 && x > 0.0))
+			{
+				const float dev = fabs(x - value);
+				uint32_t key;
+				memcpy(&key, &dev, sizeof(uint32_t));
+				key >>= shift;
+				++histogram_local[key < key_min ? 0 : key - key_min + 1];
+			}
+		}
+		
+		#pragma omp critical
+		for(size_t i = 0; i < n_bins; ++i) histogram[i] += histogram_local[i];
+		
+		free(histogram_local);
+	}
+	
+	// Locate bins holding central element(s)
+	const size_t rank_upper = counter / 2;
+	const size_t rank_lower = IS_ODD(counter) ? rank_upper : rank_upper - 1;
+	size_t bin_lower = 0;
+	size_t bin_upper = 0;
+	size_t cumulative = 0;
+	
+	for(size_t i = 0; i < n_bins; ++i)
+	{
+		if(cumulative <= rank_lower && rank_lower < cumulative + histogram[i]) bin_lower = i;
+		if(cumulative <= rank_upper && rank_upper < cumulative + histogram[i])
+		{
+			bin_upper = i;
+			break;
+		}
+		cumulative += histogram[i];
+	}
+	
+	free(histogram);
+	
+	// Fall back to exact solution if median below histogram range
+	if(bin_lower == 0) return mad_val_capped_SFX(data, size, value, step, range, max_samples);
+	
+	// Return average of bin centres
+	double result = 0.0;
+	for(int i = 0; i < 2; ++i)
+	{
+		const uint32_t key = key_min + (i ? bin_upper : bin_lower) - 1;
+		const uint32_t bits_lower = key << shift;
+		const uint32_t bits_upper = (key + 1) << shift;
+		float edge_lower, edge_upper;
+		memcpy(&edge_lower, &bits_lower, sizeof(float));
+		memcpy(&edge_upper, &bits_upper, sizeof(float));
+		result += 0.25 * ((double)edge_lower + (double)edge_upper);
+	}
+	
+	return result;
+}
+
+
+
 /// @brief Median absolute deviation
 ///
 /// Calculates the median absolute deviation (MAD) of the
@@ -781,25 +1077,40 @@ DATA_T robust_noise_in_region_SFX(const DATA_T *data, const size_t nx, const siz
 /// required (using `free()`) to ensure that there are no
 /// memory leaks. This function is `NaN`-safe, and `NaN` values
 /// will simply be ignored (due to `>=` and `<=` comparison).
+/// Bin indices are computed in blocks of `SIMD_LANES` elements
+/// to allow for vectorisation.
 
-size_t *create_histogram_SFX(const DATA_T *data, const size_t size, const size_t n_bins, const DATA_T data_min, const DATA_T data_max, const size_t cadence)
+SIMD_DISPATCH size_t *create_histogram_SFX(const DATA_T *data, const size_t size, const size_t n_bins, const DATA_T data_min, const DATA_T data_max, const size_t cadence)
 {
 	// Allocate memory
 	size_t *histogram = (size_t *)memory(CALLOC, n_bins, sizeof(size_t));
 	
 	// Basic setup
 	const DATA_T slope = (DATA_T)(n_bins - 1) / (data_max - data_min);
-	const DATA_T *ptr  = data + size;
 	const DATA_T tmp   = 0.5 - slope * data_min;  // The 0.5 is needed for correct rounding later on.
 	
+	// Elements size - cadence, size - 2 * cadence, ... down to 1
+	const size_t n_samples = size ? (size - 1) / cadence : 0;
+	size_t bins[SIMD_LANES];
+	size_t i = 0;
+	
 	// Generate histogram
-	while((ptr -= cadence) > data)
+	for(; i + SIMD_LANES <= n_samples; i += SIMD_LANES)
 	{
-		if(*ptr >= data_min && *ptr <= data_max)
+		// Bin index of each element, with n_bins marking elements outside of range
+		#pragma GCC unroll 1
+		for(size_t j = 0; j < SIMD_LANES; ++j)
 		{
-			size_t bin = (size_t)(slope * *ptr + tmp);
-			++histogram[bin];
+			const DATA_T x = data[size - (i + j + 1) * cadence];
+			bins[j] = (x >= data_min && x <= data_max) ? (size_t)(slope * x + tmp) : n_bins;
 		}
+		for(size_t j = 0; j < SIMD_LANES; ++j) if(bins[j] < n_bins) ++histogram[bins[j]];
+	}
+	
+	for(; i < n_samples; ++i)
+	{
+		const DATA_T x = data[size - (i + 1) * cadence];
+		if(x >= data_min && x <= data_max) ++histogram[(size_t)(slope * x + tmp)];
 	}
 	
 	return histogram;
@@ -850,6 +1161,33 @@ DATA_T gaufit_SFX(const DATA_T *data, const size_t size, const size_t cadence, c
 	DATA_T data_min = 0.0;
 	max_min_SFX(data, size, &data_max, &data_min);
 	
+	return gaufit_limits_SFX(data, size, cadence, range, data_min, data_max);
+}
+
+
+
+/// @brief Gaussian fit to histogram with given data limits
+///
+/// Same as gaufit_SFX(), but with the minimum and maximum of the
+/// data, from which the initial histogram range is derived,
+/// specified by the user rather than determined from the input
+/// array. This allows a sample extracted from a larger array to
+/// be fitted with the same histogram range as the original array.
+///
+/// @param data      Pointer to the data array.
+/// @param size      Size of the input array.
+/// @param cadence   Cadence for generation of histogram.
+/// @param range     Flux range to use in histogram. Can be
+///                  -1, 0 or +1 to use only negative pixels,
+///                  all pixels, or only positive pixels,
+///                  respectively.
+/// @param data_min  Minimum of the data.
+/// @param data_max  Maximum of the data.
+///
+/// @return Standard deviation from Gaussian fit.
+
+DATA_T gaufit_limits_SFX(const DATA_T *data, const size_t size, const size_t cadence, const int range, DATA_T data_min, DATA_T data_max)
+{
 	if(data_min >= 0.0 || data_max <= 0.0)
 	{
 		warning("Maximum is not greater than minimum.");
@@ -1062,7 +1400,7 @@ void skew_kurt_SFX(const DATA_T *data, const size_t size, double *skew, double *
 ///
 /// @note This function will modify the original data array.
 
-void filter_boxcar_1d_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, const size_t filter_radius)
+SIMD_DISPATCH void filter_boxcar_1d_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, const size_t filter_radius)
 {
 	// Define filter size
 	const size_t filter_size = 2 * filter_radius + 1;
@@ -1088,6 +1426,72 @@ void filter_boxcar_1d_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, co
 
 
 
+/// @brief 1D boxcar filter for block of interleaved arrays
+///
+/// Applies a boxcar filter to a block of `width` data arrays that
+/// are stored in interleaved order, such that element `i` of array
+/// `j` is located at `data[i * width + j]`. This allows several
+/// adjacent columns of an image to be filtered at once using
+/// contiguous memory access. The result for each array is identical
+/// to that of filter_boxcar_1d_SFX(). `NaN` values will be set to 0
+/// prior to filtering, and values outside of the boundaries of the
+/// arrays are assumed to be 0.
+///
+/// @param data           Pointer to block of data arrays to be
+///                       filtered. Its size must be `size` * `width`.
+/// @param data_copy      Pointer to data array to be used for
+///                       storing a copy of the data during
+///                       filtering. Its size must be equal to
+///                       (`size` + 2 * `filter_radius`) * `width`.
+/// @param size           Size of each input array.
+/// @param filter_radius  Radius of boxcar filter.
+/// @param width          Number of interleaved arrays.
+///
+/// @note This function will modify the original data array.
+
+SIMD_DISPATCH void filter_boxcar_1d_block_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, const size_t filter_radius, const size_t width)
+{
+	// Define filter size
+	const size_t filter_size = 2 * filter_radius + 1;
+	const DATA_T inv_filter_size = 1.0 / filter_size;
+	DATA_T *last = data + (size - 1) * width;
+	size_t i;
+	
+	// Make copy of data, taking care of NaN
+	for(i = size; i--;)
+	{
+		const DATA_T *src = data + i * width;
+		DATA_T *dst = data_copy + (filter_radius + i) * width;
+		for(size_t j = 0; j < width; ++j) dst[j] = FILTER_NAN(src[j]);
+	}
+	
+	// Fill overlap regions with 0
+	for(i = filter_radius * width; i--;) data_copy[i] = data_copy[(size + filter_radius) * width + i] = 0.0;
+	
+	// Apply boxcar filter to last data point
+	for(size_t j = 0; j < width; ++j) last[j] = 0.0;
+	for(i = filter_size; i--;)
+	{
+		const DATA_T *src = data_copy + (size + i - 1) * width;
+		for(size_t j = 0; j < width; ++j) last[j] += src[j];
+	}
+	for(size_t j = 0; j < width; ++j) last[j] *= inv_filter_size;
+	
+	// Recursively apply boxcar filter to all previous data points
+	for(i = size - 1; i--;)
+	{
+		DATA_T *dst = data + i * width;
+		const DATA_T *prev = dst + width;
+		const DATA_T *add = data_copy + i * width;
+		const DATA_T *sub = data_copy + (filter_size + i) * width;
+		for(size_t j = 0; j < width; ++j) dst[j] = prev[j] + (add[j] - sub[j]) * inv_filter_size;
+	}
+	
+	return;
+}
+
+
+
 /// @brief 2D Gaussian filter
 ///
 /// Applies a pseudo-Gaussian filter to the two-dimensional
@@ -1101,14 +1505,15 @@ void filter_boxcar_1d_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, co
 /// For reasons of speed several data arrays must have been
 /// pre-allocated and passed on to this function:
 ///
-/// * `data_copy`: Used to store a single column of the input
-///   data. Must be of size `size_y`.
+/// * `data_copy`: Used to store a block of `FILTER_BLOCK_SIZE`
+///   adjacent columns of the input data. Must be of size
+///   `FILTER_BLOCK_SIZE` * `size_y`.
 /// * `data_row`:  Used to store a copy of the data passed on
 ///   to the boxcar filter. Must be of size `size_x` +
 ///   2 * `filter_radius`.
 /// * `data_col`:  Used to store a copy of the data passed on
-///   to the boxcar filter. Must be of size `size_y` +
-///   2 * `filter_radius`.
+///   to the boxcar filter. Must be of size `FILTER_BLOCK_SIZE` *
+///   (`size_y` + 2 * `filter_radius`).
 ///
 /// The sole purpose of having these array created externally
 /// and then passed on to the function is to improve
@@ -1127,17 +1532,18 @@ void filter_boxcar_1d_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, co
 /// @param data           Pointer to data array to be
 ///                       filtered.
 /// @param data_copy      Pointer to data array to be used
-///                       for storing a single column of the
+///                       for storing a block of columns of the
 ///                       data array. Its size must be equal
-///                       to `size_y`.
+///                       to `FILTER_BLOCK_SIZE` * `size_y`.
 /// @param data_row       Pointer to data array to be used by
 ///                       the boxcar filter to be employed.
 ///                       Its size must be equal to `size_x` +
 ///                       2 * `filter_radius`.
 /// @param data_col       Pointer to data array to be used by
 ///                       the boxcar filter to be employed.
-///                       Its size must be equal to `size_y` +
-///                       2 * `filter_radius`.
+///                       Its size must be equal to
+///                       `FILTER_BLOCK_SIZE` * (`size_y` +
+///                       2 * `filter_radius`).
 /// @param size_x         Size of the first dimension of the
 ///                       input data array.
 /// @param size_y         Size of the second dimension of the
@@ -1165,27 +1571,33 @@ void filter_gauss_2d_SFX(DATA_T *data, DATA_T *data_copy, DATA_T *data_row, DATA
 	
 	// Run column filter (along y-axis)
 	// This is more complicated, as the data are non-contiguous in y.
-	for(size_t x = size_x; x--;)
+	// Blocks of adjacent columns are therefore copied into a tile
+	// and filtered together to allow for contiguous memory access.
+	for(size_t x = 0; x < size_x; x += FILTER_BLOCK_SIZE)
 	{
-		// Copy data into column array
-		ptr = data + size_xy - size_x + x;
-		ptr2 = data_copy + size_y;
-		while(ptr2 --> data_copy)
+		const size_t width = (size_x - x < FILTER_BLOCK_SIZE) ? size_x - x : FILTER_BLOCK_SIZE;
+		
+		// Copy block of columns into tile
+		ptr = data + x;
+		ptr2 = data_copy;
+		for(size_t y = size_y; y--;)
 		{
-			*ptr2 = *ptr;
-			ptr -= size_x;
+			memcpy(ptr2, ptr, width * sizeof(DATA_T));
+			ptr += size_x;
+			ptr2 += width;
 		}
 		
-		// Apply filter
-		for(size_t i = n_iter; i--;) filter_boxcar_1d_SFX(data_copy, data_col, size_y, filter_radius);
+		// Apply all filter iterations to tile
+		for(size_t i = n_iter; i--;) filter_boxcar_1d_block_SFX(data_copy, data_col, size_y, filter_radius, width);
 		
-		// Copy column array back into data array
-		ptr = data + size_xy - size_x + x;
-		ptr2 = data_copy + size_y;
-		while(ptr2 --> data_copy)
+		// Copy tile back into data array
+		ptr = data + x;
+		ptr2 = data_copy;
+		for(size_t y = size_y; y--;)
 		{
-			*ptr = *ptr2;
-			ptr -= size_x;
+			memcpy(ptr, ptr2, width * sizeof(DATA_T));
+			ptr += size_x;
+			ptr2 += width;
 		}
 	}
 	
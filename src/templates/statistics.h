@@ -51,6 +51,18 @@
 // -------------------------- //
 #define BOXCAR_MIN_ITER 3  ///< Minimum number of iterations required for boxcar approximation of Gaussian smoothing kernel.
 #define BOXCAR_MAX_ITER 6  ///< Maximum number of iterations allowed for boxcar approximation of Gaussian smoothing kernel.
+#define FILTER_BLOCK_SIZE 16  ///< Number of adjacent columns filtered together by filter_gauss_2d_SFX().
+
+// -------------------------------- //
+// Settings for histogram-based MAD //
+// -------------------------------- //
+#define MAD_HIST_OCTAVES  32  ///< Number of factors of 2 below the maximum covered by the histogram of absolute deviations.
+#define MAD_HIST_MAX_BITS 12  ///< Maximum number of mantissa bits used to define histogram bins, limiting the achievable tolerance.
+
+// ------------------------------- //
+// Settings for vectorised kernels //
+// ------------------------------- //
+#define SIMD_LANES 16  ///< Number of independent lanes used by vectorised kernels; fixed to ensure identical results on all instruction sets.
 
 
 
@@ -88,6 +100,9 @@ DATA_T median_SFX(DATA_T *data, const size_t size, const bool fast);
 DATA_T median_safe_SFX(const DATA_T *data, const size_t size, const bool fast);
 DATA_T mad_SFX(DATA_T *data, const size_t size);
 DATA_T mad_val_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range);
+DATA_T mad_val_capped_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range, const size_t max_samples);
+DATA_T mad_val_hist_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range, const double tolerance);
+DATA_T mad_val_hist_capped_SFX(const DATA_T *data, const size_t size, const DATA_T value, const size_t cadence, const int range, const double tolerance, const size_t max_samples);
 
 // Robust and fast noise measurement
 DATA_T robust_noise_SFX(const DATA_T *data, const size_t size);
@@ -97,6 +112,7 @@ DATA_T robust_noise_in_region_SFX(const DATA_T *data, const size_t nx, const siz
 // Gaussian fit to histogram
 size_t *create_histogram_SFX(const DATA_T *data, const size_t size, const size_t n_bins, const DATA_T data_min, const DATA_T data_max, const size_t cadence);
 DATA_T gaufit_SFX(const DATA_T *data, const size_t size, const size_t cadence, const int range);
+DATA_T gaufit_limits_SFX(const DATA_T *data, const size_t size, const size_t cadence, const int range, DATA_T data_min, DATA_T data_max);
 
 // Skewness and kurtosis
 void skew_kurt_SFX(const DATA_T *data, const size_t size, double *skew, double *kurt);
@@ -105,6 +121,7 @@ double kurtosis_SFX(const DATA_T *data, const size_t size);
 
 // 1D boxcar filter
 void filter_boxcar_1d_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, const size_t filter_radius);
+void filter_boxcar_1d_block_SFX(DATA_T *data, DATA_T *data_copy, const size_t size, const size_t filter_radius, const size_t width);
 
 // 2D Gaussian filter
 void filter_gauss_2d_SFX(DATA_T *data, DATA_T *data_copy, DATA_T *data_row, DATA_T *data_col, const size_t size_x, const size_t size_y, const size_t n_iter, const size_t filter_radius);
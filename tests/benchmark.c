@@ -0,0 +1,617 @@
+// ____________________________________________________________________ //
+//                                                                      //
+// SoFiA 2.5.1 (benchmark.c) - Source Finding Application               //
+// Copyright (C) 2026 The SoFiA 2 Authors                               //
+// ____________________________________________________________________ //
+//                                                                      //
+// Address:  Tobias Westmeier                                           //
+//           ICRAR M468                                                 //
+//           The University of Western Australia                        //
+//           35 Stirling Highway                                        //
+//           Crawley WA 6009                                            //
+//           Australia                                                  //
+//                                                                      //
+// E-mail:   tobias.westmeier [at] uwa.edu.au                           //
+// ____________________________________________________________________ //
+//                                                                      //
+// This program is free software: you can redistribute it and/or modify //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program. If not, see http://www.gnu.org/licenses/.   //
+// ____________________________________________________________________ //
+//                                                                      //
+
+
+/// @file   benchmark.c
+/// @date   14/10/2026
+/// @brief  Benchmark suite with synthetic data cube generator.
+///
+/// Generates a synthetic data cube containing Gaussian noise, an
+/// injected population of Gaussian sources and blanked regions, and
+/// measures the run time of the performance-critical algorithms and
+/// of the full pipeline for different numbers of threads. Settings
+/// are passed as `key=value` pairs on the command line:
+///
+///   size=NX,NY,NZ    Size of the synthetic cube (default: 200,200,200).
+///   bitpix=B         BITPIX of the cube written for the pipeline runs
+///                    (8, 16, 32, 64, -32 or -64; default: -32).
+///   noise=S          Standard deviation of the noise (default: 1).
+///   sources=N        Number of injected sources (default: 100).
+///   nan=F            Fraction of blanked voxels (default: 0.05).
+///   seed=N           Seed of the random number generator (default: 1).
+///   threads=T1,T2    Thread counts to benchmark (default: 1).
+///   repeat=N         Number of repetitions; the fastest run will be
+///                    reported (default: 3).
+///   sofia=PATH       SoFiA executable for end-to-end runs; none will
+///                    be carried out if empty (default: empty).
+///   dir=PATH         Directory for temporary files (default: .).
+
+
+// NOTE: Required for clock_gettime() when compiling with --std=c99.
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/wait.h>
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+#include "../src/common.h"
+#include "../src/statistics_flt.h"
+#include "../src/Array_siz.h"
+#include "../src/BitMask.h"
+#include "../src/Map.h"
+#include "../src/Matrix.h"
+#include "../src/Catalog.h"
+#include "../src/LinkerPar.h"
+#include "../src/DataCube.h"
+
+#define BENCH_MAX_RESULTS 256  ///< Maximum number of benchmark results recorded.
+
+typedef struct
+{
+	char   name[32];     ///< Name of the benchmark.
+	size_t threads;      ///< Number of threads used.
+	double time;         ///< Fastest run time in s.
+	size_t items;        ///< Number of items processed.
+	const char *unit;    ///< Unit of the items processed.
+} Result;
+
+static Result results[BENCH_MAX_RESULTS];
+static size_t n_results = 0;
+
+
+
+/// @brief Return wall-clock time in s
+
+static double bench_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)(ts.tv_sec) + 1.0e-9 * (double)(ts.tv_nsec);
+}
+
+
+
+/// @brief Set number of threads
+
+static void bench_set_threads(const size_t threads)
+{
+	#ifdef _OPENMP
+		omp_set_num_threads((int)threads);
+	#else
+		(void)threads;
+	#endif
+	return;
+}
+
+
+
+/// @brief Record benchmark result
+
+static void bench_record(const char *name, const size_t threads, const double time, const size_t items, const char *unit)
+{
+	ensure(n_results < BENCH_MAX_RESULTS, ERR_INDEX_RANGE, "Too many benchmark results.");
+	snprintf(results[n_results].name, sizeof(results[n_results].name), "%s", name);
+	results[n_results].threads = threads;
+	results[n_results].time    = time;
+	results[n_results].items   = items;
+	results[n_results].unit    = unit;
+	++n_results;
+	return;
+}
+
+
+
+/// @brief Random number generator (xorshift64*)
+///
+/// Returns a uniformly distributed random number in the range of
+/// (0, 1). A dedicated generator is used to ensure that the synthetic
+/// cube is reproducible across platforms for a given seed.
+
+static double rng_uniform(uint64_t *state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return ((double)((*state * 2685821657736338717ULL) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+
+
+/// @brief Normally distributed random number (Box-Muller)
+
+static double rng_gauss(uint64_t *state)
+{
+	return sqrt(-2.0 * log(rng_uniform(state))) * cos(2.0 * M_PI * rng_uniform(state));
+}
+
+
+
+/// @brief Generate synthetic data
+///
+/// Generates an array of `nx * ny * nz` single-precision values
+/// containing Gaussian noise of standard deviation `noise` and
+/// `n_src` injected sources with 3-D Gaussian profiles of random
+/// position, size and peak flux density (2 to 10 times the noise).
+/// A strip of spatial columns at the left edge and a block of channels
+/// at the high end of the spectral axis are blanked with NaN, each
+/// covering half of the requested fraction `nan_frac` of voxels.
+
+static float *generate_data(const size_t nx, const size_t ny, const size_t nz, const double noise, const size_t n_src, const double nan_frac, uint64_t seed)
+{
+	const size_t size = nx * ny * nz;
+	float *data = (float *)memory(MALLOC, size, sizeof(float));
+	uint64_t state = seed ? seed : 1;
+	
+	// Gaussian noise
+	for(size_t i = 0; i < size; ++i) data[i] = noise * rng_gauss(&state);
+	
+	// Injected sources
+	for(size_t s = 0; s < n_src; ++s)
+	{
+		const double x0 = nx * rng_uniform(&state);
+		const double y0 = ny * rng_uniform(&state);
+		const double z0 = nz * rng_uniform(&state);
+		const double sx = 1.5 + 2.5 * rng_uniform(&state);
+		const double sz = 2.0 + 8.0 * rng_uniform(&state);
+		const double peak = noise * (2.0 + 8.0 * rng_uniform(&state));
+		
+		const size_t x_min = x0 > 4.0 * sx ? x0 - 4.0 * sx : 0;
+		const size_t y_min = y0 > 4.0 * sx ? y0 - 4.0 * sx : 0;
+		const size_t z_min = z0 > 4.0 * sz ? z0 - 4.0 * sz : 0;
+		const size_t x_max = x0 + 4.0 * sx < nx - 1 ? x0 + 4.0 * sx : nx - 1;
+		const size_t y_max = y0 + 4.0 * sx < ny - 1 ? y0 + 4.0 * sx : ny - 1;
+		const size_t z_max = z0 + 4.0 * sz < nz - 1 ? z0 + 4.0 * sz : nz - 1;
+		
+		for(size_t z = z_min; z <= z_max; ++z)
+		{
+			const double fz = exp(-0.5 * (z - z0) * (z - z0) / (sz * sz));
+			
+			for(size_t y = y_min; y <= y_max; ++y)
+			{
+				for(size_t x = x_min; x <= x_max; ++x)
+				{
+					const double r2 = ((x - x0) * (x - x0) + (y - y0) * (y - y0)) / (sx * sx);
+					data[x + nx * (y + ny * z)] += peak * fz * exp(-0.5 * r2);
+				}
+			}
+		}
+	}
+	
+	// Blanked regions
+	const size_t n_cols = (size_t)(0.5 * nan_frac * nx + 0.5);
+	const size_t n_chan = (size_t)(0.5 * nan_frac * nz + 0.5);
+	
+	for(size_t z = 0; z < nz; ++z)
+	{
+		for(size_t y = 0; y < ny; ++y)
+		{
+			for(size_t x = 0; x < nx; ++x)
+			{
+				if(x < n_cols || z >= nz - n_chan) data[x + nx * (y + ny * z)] = NAN;
+			}
+		}
+	}
+	
+	return data;
+}
+
+
+
+/// @brief Create data cube from synthetic data
+///
+/// Creates a data cube of the specified BITPIX from the synthetic
+/// data and sets up a basic WCS and beam. Integer cubes are quantised
+/// using BSCALE and BZERO, with blanked voxels set to BLANK.
+
+static DataCube *generate_cube(const float *data, const size_t nx, const size_t ny, const size_t nz, const int bitpix, const double noise)
+{
+	DataCube *cube = DataCube_blank(nx, ny, nz, bitpix, false);
+	
+	DataCube_puthd_str(cube, "CTYPE1", "RA---SIN");
+	DataCube_puthd_str(cube, "CTYPE2", "DEC--SIN");
+	DataCube_puthd_str(cube, "CTYPE3", "FREQ");
+	DataCube_puthd_str(cube, "CUNIT1", "deg");
+	DataCube_puthd_str(cube, "CUNIT2", "deg");
+	DataCube_puthd_str(cube, "CUNIT3", "Hz");
+	DataCube_puthd_flt(cube, "CRPIX1", nx / 2 + 1);
+	DataCube_puthd_flt(cube, "CRPIX2", ny / 2 + 1);
+	DataCube_puthd_flt(cube, "CRPIX3", 1.0);
+	DataCube_puthd_flt(cube, "CDELT1", -1.0 / 720.0);
+	DataCube_puthd_flt(cube, "CDELT2", 1.0 / 720.0);
+	DataCube_puthd_flt(cube, "CDELT3", 18518.5);
+	DataCube_puthd_flt(cube, "CRVAL1", 180.0);
+	DataCube_puthd_flt(cube, "CRVAL2", -30.0);
+	DataCube_puthd_flt(cube, "CRVAL3", 1.4e+9);
+	DataCube_puthd_flt(cube, "EQUINOX", 2000.0);
+	DataCube_puthd_flt(cube, "BMAJ", 5.0 / 720.0);
+	DataCube_puthd_flt(cube, "BMIN", 5.0 / 720.0);
+	DataCube_puthd_flt(cube, "BPA", 0.0);
+	DataCube_puthd_str(cube, "BUNIT", "Jy/beam");
+	
+	// Quantisation of integer data
+	double bscale = 1.0;
+	double offset = 0.0;
+	double v_min = 0.0;
+	double v_max = 0.0;
+	long int blank = 0;
+	
+	if(bitpix > 0)
+	{
+		bscale = noise / (bitpix == 8 ? 10.0 : 1000.0);
+		offset = bitpix == 8 ? 128.0 : 0.0;
+		v_min  = bitpix == 8 ? 1.0 : -(pow(2.0, (bitpix < 32 ? bitpix : 32) - 1) - 1.0);
+		v_max  = bitpix == 8 ? 255.0 : pow(2.0, (bitpix < 32 ? bitpix : 32) - 1) - 1.0;
+		blank  = bitpix == 8 ? 0 : (long int)(v_min - 1.0);
+		DataCube_puthd_flt(cube, "BSCALE", bscale);
+		DataCube_puthd_flt(cube, "BZERO", offset > 0.0 ? -offset * bscale : 0.0);
+		DataCube_puthd_int(cube, "BLANK", blank);
+	}
+	
+	for(size_t z = 0; z < nz; ++z)
+	{
+		for(size_t y = 0; y < ny; ++y)
+		{
+			for(size_t x = 0; x < nx; ++x)
+			{
+				const double value = data[x + nx * (y + ny * z)];
+				
+				if(bitpix < 0) DataCube_set_data_flt(cube, x, y, z, value);
+				else if(IS_NAN(value)) DataCube_set_data_int(cube, x, y, z, blank);
+				else
+				{
+					double q = floor(value / bscale + offset + 0.5);
+					if(q < v_min) q = v_min;
+					if(q > v_max) q = v_max;
+					DataCube_set_data_int(cube, x, y, z, (long int)q);
+				}
+			}
+		}
+	}
+	
+	return cube;
+}
+
+
+
+/// @brief Main function of the benchmark suite
+
+int main(int argc, char **argv)
+{
+	// ---------------------------- //
+	// Parse settings               //
+	// ---------------------------- //
+	
+	size_t nx = 200, ny = 200, nz = 200;
+	int    bitpix   = -32;
+	double noise    = 1.0;
+	size_t n_src    = 100;
+	double nan_frac = 0.05;
+	size_t seed     = 1;
+	size_t repeat   = 3;
+	const char *threads_str = "1";
+	const char *sofia = "";
+	const char *dir   = ".";
+	
+	for(int i = 1; i < argc; ++i)
+	{
+		const char *value = strchr(argv[i], '=');
+		ensure(value != NULL, ERR_USER_INPUT, "Invalid argument: '%s'; expected key=value.", argv[i]);
+		const size_t length = value++ - argv[i];
+		
+		if     (length == 4 && strncmp(argv[i], "size",    4) == 0) ensure(sscanf(value, "%zu,%zu,%zu", &nx, &ny, &nz) == 3, ERR_USER_INPUT, "Invalid cube size: '%s'.", value);
+		else if(length == 6 && strncmp(argv[i], "bitpix",  6) == 0) bitpix   = atoi(value);
+		else if(length == 5 && strncmp(argv[i], "noise",   5) == 0) noise    = atof(value);
+		else if(length == 7 && strncmp(argv[i], "sources", 7) == 0) n_src    = strtoul(value, NULL, 10);
+		else if(length == 3 && strncmp(argv[i], "nan",     3) == 0) nan_frac = atof(value);
+		else if(length == 4 && strncmp(argv[i], "seed",    4) == 0) seed     = strtoul(value, NULL, 10);
+		else if(length == 6 && strncmp(argv[i], "repeat",  6) == 0) repeat   = strtoul(value, NULL, 10);
+		else if(length == 7 && strncmp(argv[i], "threads", 7) == 0) threads_str = value;
+		else if(length == 5 && strncmp(argv[i], "sofia",   5) == 0) sofia    = value;
+		else if(length == 3 && strncmp(argv[i], "dir",     3) == 0) dir      = value;
+		else ensure(false, ERR_USER_INPUT, "Unknown setting: '%s'.", argv[i]);
+	}
+	
+	ensure(nx > 1 && ny > 1 && nz > 1, ERR_USER_INPUT, "Cube size must be greater than 1 along each axis.");
+	ensure(bitpix == 8 || bitpix == 16 || bitpix == 32 || bitpix == 64 || bitpix == -32 || bitpix == -64, ERR_USER_INPUT, "Invalid BITPIX: %d.", bitpix);
+	ensure(noise > 0.0, ERR_USER_INPUT, "Noise level must be positive.");
+	ensure(nan_frac >= 0.0 && nan_frac < 1.0, ERR_USER_INPUT, "Fraction of blanked voxels must be in the range of 0 to 1.");
+	if(repeat < 1) repeat = 1;
+	
+	Array_siz *threads = Array_siz_new_str(threads_str);
+	ensure(Array_siz_get_size(threads), ERR_USER_INPUT, "No thread counts specified.");
+	
+	#ifndef _OPENMP
+		warning("Benchmark compiled without OpenMP; all runs will use a single thread.");
+	#endif
+	
+	
+	
+	// ---------------------------- //
+	// Generate synthetic data      //
+	// ---------------------------- //
+	
+	status("Generating synthetic data cube");
+	message("Size:      %zu x %zu x %zu", nx, ny, nz);
+	message("Noise:     %.3e", noise);
+	message("Sources:   %zu", n_src);
+	message("Blanked:   %.1f%%", 100.0 * nan_frac);
+	
+	const size_t size = nx * ny * nz;
+	float *data = generate_data(nx, ny, nz, noise, n_src, nan_frac, seed);
+	float *work = (float *)memory(MALLOC, size, sizeof(float));
+	DataCube *cube = generate_cube(data, nx, ny, nz, -32, noise);
+	
+	// Filter settings
+	const double sigma = 5.0 / (2.0 * sqrt(2.0 * log(2.0)));
+	const size_t box_radius = 3;
+	size_t filter_radius, n_iter;
+	optimal_filter_size_flt(sigma, &filter_radius, &n_iter);
+	
+	
+	
+	// ---------------------------- //
+	// Micro-benchmarks             //
+	// ---------------------------- //
+	
+	status("Running micro-benchmarks");
+	
+	for(size_t t = 0; t < Array_siz_get_size(threads); ++t)
+	{
+		const size_t n_threads = Array_siz_get(threads, t);
+		bench_set_threads(n_threads);
+		message("Threads: %zu", n_threads);
+		
+		double t_gauss = INFINITY, t_boxcar = INFINITY, t_mad = INFINITY, t_gaufit = INFINITY;
+		double t_linker = INFINITY, t_rel = INFINITY, t_param = INFINITY;
+		size_t n_sources = 0;
+		
+		for(size_t r = 0; r < repeat; ++r)
+		{
+			// Spatial Gaussian filter (blanked voxels set to 0, as in the S+C finder)
+			for(size_t i = 0; i < size; ++i) work[i] = IS_NAN(data[i]) ? 0.0f : data[i];
+			
+			double t0 = bench_time();
+			#pragma omp parallel
+			{
+				float *column   = (float *)memory(MALLOC, FILTER_BLOCK_SIZE * ny, sizeof(float));
+				float *data_row = (float *)memory(MALLOC, nx + 2 * filter_radius, sizeof(float));
+				float *data_col = (float *)memory(MALLOC, FILTER_BLOCK_SIZE * (ny + 2 * filter_radius), sizeof(float));
+				
+				#pragma omp for schedule(static)
+				for(size_t z = 0; z < nz; ++z) filter_gauss_2d_flt(work + z * nx * ny, column, data_row, data_col, nx, ny, n_iter, filter_radius);
+				
+				free(column);
+				free(data_row);
+				free(data_col);
+			}
+			double t1 = bench_time();
+			if(t1 - t0 < t_gauss) t_gauss = t1 - t0;
+			
+			// Spectral boxcar filter
+			t0 = bench_time();
+			#pragma omp parallel
+			{
+				float *spectrum = (float *)memory(MALLOC, nz, sizeof(float));
+				float *data_box = (float *)memory(MALLOC, nz + 2 * box_radius, sizeof(float));
+				
+				#pragma omp for schedule(static)
+				for(size_t xy = 0; xy < nx * ny; ++xy)
+				{
+					for(size_t z = 0; z < nz; ++z) spectrum[z] = work[xy + z * nx * ny];
+					filter_boxcar_1d_flt(spectrum, data_box, nz, box_radius);
+					for(size_t z = 0; z < nz; ++z) work[xy + z * nx * ny] = spectrum[z];
+				}
+				
+				free(spectrum);
+				free(data_box);
+			}
+			t1 = bench_time();
+			if(t1 - t0 < t_boxcar) t_boxcar = t1 - t0;
+			
+			// Noise statistics
+			t0 = bench_time();
+			const double rms_mad = MAD_TO_STD * mad_val_flt(data, size, 0.0, 1, 0);
+			t1 = bench_time();
+			if(t1 - t0 < t_mad) t_mad = t1 - t0;
+			
+			t0 = bench_time();
+			const double rms_gauss = gaufit_flt(data, size, 1, 0);
+			t1 = bench_time();
+			if(t1 - t0 < t_gaufit) t_gaufit = t1 - t0;
+			
+			if(r == 0 && t == 0) message("Noise:   %.3e (MAD), %.3e (Gaussian fit)", rms_mad, rms_gauss);
+			
+			// Linker on mask created from smoothed data
+			DataCube *smoothed = generate_cube(work, nx, ny, nz, -32, noise);
+			const double rms_smooth = DataCube_stat_std(smoothed, 0.0, 1, -1);
+			BitMask *bits = BitMask_new(size);
+			DataCube_mask_bits(smoothed, bits, 3.0 * rms_smooth);
+			DataCube_delete(smoothed);
+			
+			DataCube *mask = DataCube_blank(nx, ny, nz, 32, false);
+			DataCube_copy_bitmask(mask, bits, -1);
+			BitMask_delete(bits);
+			
+			t0 = bench_time();
+			LinkerPar *lpar = DataCube_run_linker(cube, mask, 1, 1, 1, 3, 3, 3, 0, 0.0, 0, 0, 0, 0, 0.0, false, false, noise, false);
+			t1 = bench_time();
+			if(t1 - t0 < t_linker) t_linker = t1 - t0;
+			n_sources = LinkerPar_get_size(lpar);
+			
+			// Reliability, provided that there are enough positive and negative
+			// sources for the covariance matrix to be well defined
+			size_t n_neg = 0;
+			for(size_t i = 0; i < n_sources; ++i) if(LinkerPar_get_flux(lpar, LinkerPar_get_label(lpar, i)) < 0.0) ++n_neg;
+			
+			if(n_neg >= 10 && n_sources - n_neg >= 10)
+			{
+				Array_siz *par_space = Array_siz_new(0);
+				Array_siz_push(par_space, LINKERPAR_PEAK);
+				Array_siz_push(par_space, LINKERPAR_SUM);
+				Array_siz_push(par_space, LINKERPAR_MEAN);
+				double scale_kernel = 0.4;
+				
+				t0 = bench_time();
+				Matrix *covar = LinkerPar_reliability(lpar, par_space, &scale_kernel, 0.0, 0, NULL, NULL, false, 30, 0.05, 0.0, 256 * MEGABYTE);
+				t1 = bench_time();
+				if(t1 - t0 < t_rel) t_rel = t1 - t0;
+				
+				Matrix_delete(covar);
+				Array_siz_delete(par_space);
+			}
+			else if(r == 0) warning("Too few positive or negative detections; skipping reliability benchmark.");
+			
+			// Parameterisation of all detections
+			if(n_sources)
+			{
+				Map *filter = Map_new();
+				Catalog *catalog = LinkerPar_make_catalog(lpar, filter, "Jy/beam");
+				VoxelList *voxels = DataCube_get_voxel_list(mask);
+				
+				t0 = bench_time();
+				DataCube_parameterise(cube, mask, voxels, catalog, false, false, "SoFiA");
+				t1 = bench_time();
+				if(t1 - t0 < t_param) t_param = t1 - t0;
+				
+				VoxelList_delete(voxels);
+				Catalog_delete(catalog);
+				Map_delete(filter);
+			}
+			
+			LinkerPar_delete(lpar);
+			DataCube_delete(mask);
+		}
+		
+		bench_record("filter_gauss_2d_flt",   n_threads, t_gauss,  size, "vox");
+		bench_record("filter_boxcar_1d_flt",  n_threads, t_boxcar, size, "vox");
+		bench_record("mad_val_flt",           n_threads, t_mad,    size, "vox");
+		bench_record("gaufit_flt",            n_threads, t_gaufit, size, "vox");
+		bench_record("DataCube_run_linker",   n_threads, t_linker, size, "vox");
+		if(isfinite(t_rel))   bench_record("LinkerPar_reliability", n_threads, t_rel,   n_sources, "src");
+		if(isfinite(t_param)) bench_record("DataCube_parameterise", n_threads, t_param, n_sources, "src");
+	}
+	
+	
+	
+	// ---------------------------- //
+	// End-to-end pipeline runs     //
+	// ---------------------------- //
+	
+	if(strlen(sofia))
+	{
+		status("Running end-to-end benchmarks");
+		
+		// Write synthetic cube with requested BITPIX
+		char file_cube[4096], file_par[4096], file_log[4096], command[16384];
+		snprintf(file_cube, sizeof(file_cube), "%s/bench_cube.fits", dir);
+		snprintf(file_par,  sizeof(file_par),  "%s/bench.par", dir);
+		snprintf(file_log,  sizeof(file_log),  "%s/bench.log", dir);
+		
+		DataCube *cube_out = generate_cube(data, nx, ny, nz, bitpix, noise);
+		DataCube_save(cube_out, file_cube, true, DESTROY);
+		DataCube_delete(cube_out);
+		
+		for(size_t t = 0; t < Array_siz_get_size(threads); ++t)
+		{
+			const size_t n_threads = Array_siz_get(threads, t);
+			
+			FILE *fp = fopen(file_par, "wb");
+			ensure(fp != NULL, ERR_FILE_ACCESS, "Failed to open output file: %s", file_par);
+			fprintf(fp, "input.data = %s\n", file_cube);
+			fprintf(fp, "output.directory = %s\n", dir);
+			fprintf(fp, "output.filename = bench\n");
+			fprintf(fp, "output.overwrite = true\n");
+			fprintf(fp, "output.writeCubelets = false\n");
+			fprintf(fp, "pipeline.threads = %zu\n", n_threads);
+			fclose(fp);
+			
+			snprintf(command, sizeof(command), "\"%s\" \"%s\" > \"%s\" 2>&1", sofia, file_par, file_log);
+			message("Threads: %zu", n_threads);
+			
+			double t_best = INFINITY;
+			for(size_t r = 0; r < repeat; ++r)
+			{
+				const double t0 = bench_time();
+				const int ret = system(command);
+				const double t1 = bench_time();
+				ensure(ret != -1 && WIFEXITED(ret) && (WEXITSTATUS(ret) == ERR_SUCCESS || WEXITSTATUS(ret) == ERR_NO_SRC_FOUND), ERR_FAILURE, "Pipeline run failed; see %s for details.", file_log);
+				if(t1 - t0 < t_best) t_best = t1 - t0;
+			}
+			
+			bench_record("pipeline", n_threads, t_best, size, "vox");
+		}
+	}
+	
+	
+	
+	// ---------------------------- //
+	// Report results               //
+	// ---------------------------- //
+	
+	status("Benchmark results (fastest of %zu run%s)", repeat, repeat > 1 ? "s" : "");
+	printf("  %-24s %7s %12s %16s %9s\n", "Benchmark", "Threads", "Time (s)", "Throughput", "Speed-up");
+	
+	for(size_t i = 0; i < n_results; ++i)
+	{
+		// Speed-up relative to first thread count of same benchmark
+		double t_ref = results[i].time;
+		for(size_t j = 0; j < i; ++j)
+		{
+			if(strcmp(results[j].name, results[i].name) == 0)
+			{
+				t_ref = results[j].time;
+				break;
+			}
+		}
+		
+		printf("  %-24s %7zu %12.4f %12.3e %s/s %8.2fx\n", results[i].name, results[i].threads, results[i].time, results[i].time > 0.0 ? results[i].items / results[i].time : 0.0, results[i].unit, results[i].time > 0.0 ? t_ref / results[i].time : 0.0);
+	}
+	
+	printf("\n");
+	
+	// Clean up
+	DataCube_delete(cube);
+	Array_siz_delete(threads);
+	free(data);
+	free(work);
+	
+	return ERR_SUCCESS;
+}
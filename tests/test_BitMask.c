@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "test_BitMask.h"
+
+#include "../src/BitMask.h"
+#include "../src/DataCube.h"
+
+// Mask sizes around multiples of the word size
+static const size_t sizes[] = {1, 63, 64, 65, 127, 128, 129, 1000};
+static const size_t n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+/**
+ * @brief Test setting and getting of bits at word boundaries
+ * 
+ * Sets the bits on either side of each word boundary as well as the first and last bit for masks
+ * of different sizes, including sizes that are not a multiple of 64. This test asserts that
+ * exactly these bits are set, that the number of words is correct and that no bits beyond the
+ * size of the mask are set in the last word.
+ * 
+ */
+START_TEST (bitmask_set_get)
+{
+    for(size_t s = 0; s < n_sizes; ++s)
+    {
+        const size_t size = sizes[s];
+        BitMask *mask = BitMask_new(size);
+        bool *expected = (bool *)calloc(size, sizeof(bool));
+        
+        ck_assert(BitMask_get_size(mask) == size);
+        ck_assert(BitMask_get_words(mask) == (size + 63) / 64);
+        ck_assert(BitMask_count(mask) == 0);
+        
+        for(size_t i = 0; i < size; ++i)
+        {
+            if(i == 0 || i == size - 1 || i % 64 == 0 || i % 64 == 63)
+            {
+                BitMask_set(mask, i);
+                expected[i] = true;
+            }
+        }
+        
+        size_t count = 0;
+        for(size_t i = 0; i < size; ++i)
+        {
+            ck_assert(BitMask_get(mask, i) == expected[i]);
+            count += expected[i];
+        }
+        ck_assert(BitMask_count(mask) == count);
+        if(size % 64) ck_assert((BitMask_get_word(mask, BitMask_get_words(mask) - 1) >> (size % 64)) == 0);
+        
+        // Resetting clears all bits
+        BitMask_reset(mask);
+        ck_assert(BitMask_count(mask) == 0);
+        
+        free(expected);
+        BitMask_delete(mask);
+    }
+}
+END_TEST
+
+/**
+ * @brief Test clearing of bit ranges
+ * 
+ * Clears ranges of bits within a single word, across one or more word boundaries and beyond the
+ * end of fully set masks of different sizes. This test asserts that exactly the requested bits
+ * are cleared, with ranges beyond the end of the mask being truncated.
+ * 
+ */
+START_TEST (bitmask_clear_range)
+{
+    const size_t ranges[][2] = {{0, 0}, {63, 64}, {10, 20}, {60, 130}, {64, 127}, {5, 3}, {120, 2000}};
+    const size_t n_ranges = sizeof(ranges) / sizeof(ranges[0]);
+    
+    for(size_t s = 0; s < n_sizes; ++s)
+    {
+        const size_t size = sizes[s];
+        
+        for(size_t r = 0; r < n_ranges; ++r)
+        {
+            BitMask *mask = BitMask_new(size);
+            for(size_t w = 0; w < BitMask_get_words(mask); ++w) BitMask_set_word(mask, w, w + 1 < BitMask_get_words(mask) || size % 64 == 0 ? ~(uint64_t)0 : ((uint64_t)1 << (size % 64)) - 1);
+            ck_assert(BitMask_count(mask) == size);
+            
+            BitMask_clear_range(mask, ranges[r][0], ranges[r][1]);
+            
+            size_t count = 0;
+            for(size_t i = 0; i < size; ++i)
+            {
+                const bool cleared = i >= ranges[r][0] && i <= ranges[r][1];
+                ck_assert(BitMask_get(mask, i) == !cleared);
+                count += !cleared;
+            }
+            ck_assert(BitMask_count(mask) == count);
+            
+            BitMask_delete(mask);
+        }
+    }
+}
+END_TEST
+
+/**
+ * @brief Test conversion between bit mask and mask cubes
+ * 
+ * Creates a random bit mask for a cube of 7 x 5 x 3 pixels, the size of which is not a multiple
+ * of 64, and copies it into a 32-bit integer mask as used by the linker and an 8-bit mask as used
+ * for output. The bit mask is then recreated from a floating-point cube holding the same pattern.
+ * This test asserts that the pattern is reproduced at every pixel in either direction.
+ * 
+ */
+START_TEST (bitmask_mask_cube)
+{
+    const size_t nx = 7, ny = 5, nz = 3;
+    const size_t size = nx * ny * nz;
+    BitMask *mask = BitMask_new(size);
+    
+    srand(42);
+    for(size_t i = 0; i < size; ++i) if(rand() % 3 == 0 || i == 63 || i == 64 || i == size - 1) BitMask_set(mask, i);
+    
+    // Bit mask to integer masks
+    DataCube *mask_32 = DataCube_blank(nx, ny, nz, 32, false);
+    DataCube *mask_8  = DataCube_blank(nx, ny, nz, 8, false);
+    DataCube_set_data_int(mask_32, 0, 0, 0, 7);
+    ck_assert(DataCube_copy_bitmask(mask_32, mask, -1) == BitMask_count(mask));
+    ck_assert(DataCube_copy_bitmask(mask_8, mask, 1) == BitMask_count(mask));
+    
+    for(size_t z = 0; z < nz; ++z)
+    {
+        for(size_t y = 0; y < ny; ++y)
+        {
+            for(size_t x = 0; x < nx; ++x)
+            {
+                const size_t i = x + nx * (y + ny * z);
+                const bool set = BitMask_get(mask, i);
+                ck_assert(DataCube_get_data_int(mask_32, x, y, z) == (set ? -1 : (i == 0 ? 7 : 0)));
+                ck_assert(DataCube_get_data_int(mask_8, x, y, z) == (set ? 1 : 0));
+            }
+        }
+    }
+    
+    // Floating-point cube to bit mask
+    DataCube *cube = DataCube_blank(nx, ny, nz, -32, false);
+    for(size_t z = 0; z < nz; ++z)
+        for(size_t y = 0; y < ny; ++y)
+            for(size_t x = 0; x < nx; ++x) DataCube_set_data_flt(cube, x, y, z, DataCube_get_data_int(mask_32, x, y, z) == -1 ? -2.0 : 0.5);
+    
+    BitMask *mask_copy = BitMask_new(size);
+    DataCube_mask_bits(cube, mask_copy, 1.0);
+    for(size_t w = 0; w < BitMask_get_words(mask); ++w) ck_assert(BitMask_get_word(mask_copy, w) == BitMask_get_word(mask, w));
+    
+    // Cleanup
+    BitMask_delete(mask);
+    BitMask_delete(mask_copy);
+    DataCube_delete(mask_32);
+    DataCube_delete(mask_8);
+    DataCube_delete(cube);
+}
+END_TEST
+
+Suite *BitMask_test_suite(void) {
+    Suite *s;
+    TCase *tc_bitmask_set_get, *tc_bitmask_clear_range, *tc_bitmask_mask_cube;
+
+    // Create test suite
+    s = suite_create("BitMask");
+
+    // Create test cases
+    tc_bitmask_set_get = tcase_create("bitmask_set_get");
+    tc_bitmask_clear_range = tcase_create("bitmask_clear_range");
+    tc_bitmask_mask_cube = tcase_create("bitmask_mask_cube");
+
+    // Add test cases to test suite
+    tcase_add_test(tc_bitmask_set_get, bitmask_set_get);
+    tcase_add_test(tc_bitmask_clear_range, bitmask_clear_range);
+    tcase_add_test(tc_bitmask_mask_cube, bitmask_mask_cube);
+    suite_add_tcase(s, tc_bitmask_set_get);
+    suite_add_tcase(s, tc_bitmask_clear_range);
+    suite_add_tcase(s, tc_bitmask_mask_cube);
+    
+    return s;
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_BitMask_H
+#define TEST_BitMask_H
+
+#include <check.h>
+
+Suite *BitMask_test_suite (void);
+
+#endif
@@ -0,0 +1,317 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "test_Catalog.h"
+
+#include "../src/Catalog.h"
+#include "../src/Source.h"
+#include "../src/Array_siz.h"
+#include "../src/Header.h"
+
+/**
+ * @brief Create mock source
+ * 
+ * Creates a source with the specified ID, bounding box and number of pixels, with its centroid
+ * placed at the centre of the bounding box.
+ * 
+ */
+static Source *mock_source(const long int id, const long int *bbox, const long int n_pix)
+{
+    const char *names[6] = {"x_min", "x_max", "y_min", "y_max", "z_min", "z_max"};
+    const char *pos[3] = {"x", "y", "z"};
+    Source *src = Source_new(false);
+    
+    Source_add_par_int(src, "id", id, "", "meta.id");
+    for(size_t i = 0; i < 3; ++i) Source_add_par_flt(src, pos[i], 0.5 * (bbox[2 * i] + bbox[2 * i + 1]), "pix", "pos.cartesian");
+    for(size_t i = 0; i < 6; ++i) Source_add_par_int(src, names[i], bbox[i], "pix", "pos.cartesian");
+    Source_add_par_int(src, "n_pix", n_pix, "", "meta.number;instr.pixel");
+    
+    return src;
+}
+
+/**
+ * @brief Decode big-endian 64-bit value
+ * 
+ * Assembles an unsigned 64-bit integer from 8 bytes in big-endian order, independent of the byte
+ * order of the host.
+ * 
+ */
+static uint64_t read_big_endian(const unsigned char *ptr)
+{
+    uint64_t value = 0;
+    for(size_t i = 0; i < 8; ++i) value = (value << 8) | ptr[i];
+    return value;
+}
+
+/**
+ * @brief Compare FITS header string value
+ * 
+ * Returns true if the string value of the specified header keyword, ignoring trailing blanks,
+ * equals the expected value.
+ * 
+ */
+static int header_str_equal(const Header *header, const char *key, const char *expected)
+{
+    char value[FITS_HEADER_VALUE_SIZE + 1];
+    if(Header_get_str(header, key, value)) return 0;
+    size_t size = strlen(value);
+    while(size && value[size - 1] == ' ') value[--size] = '\0';
+    return strcmp(value, expected) == 0;
+}
+
+/**
+ * @brief Determine size of FITS header
+ * 
+ * Returns the size of the FITS header starting at the specified position, i.e. the number of
+ * header blocks up to and including the END keyword times the block size, or 0 if no END keyword
+ * is found within the specified number of bytes.
+ * 
+ */
+static size_t header_size(const char *ptr, const size_t size)
+{
+    for(size_t pos = 0; pos + FITS_HEADER_LINE_SIZE <= size; pos += FITS_HEADER_LINE_SIZE)
+    {
+        if(strncmp(ptr + pos, "END     ", 8) == 0) return (pos / FITS_HEADER_BLOCK_SIZE + 1) * FITS_HEADER_BLOCK_SIZE;
+    }
+    return 0;
+}
+
+/**
+ * @brief Test merging of sources split across tile boundary
+ * 
+ * Two tiles of 50 pixels along the x-axis, overlapping by 10 pixels, such that the first tile
+ * covers x = 0-59 and the second tile covers x = 40-99. Source 1 crosses the core boundary and is
+ * detected in full by both tiles; source 2 is larger than the overlap and only detected in part by
+ * either tile; source 3 is detected in full by the first tile, but truncated by the second tile;
+ * source 4 lies entirely within the second tile. This test asserts that each of them ends up in
+ * the merged catalogue exactly once, represented by the expected copy.
+ * 
+ */
+START_TEST (catalog_merge_tiles)
+{
+    const size_t bounds[6] = {0, 99, 0, 49, 0, 9};
+    const size_t tile_size[3] = {50, 50, 10};
+    const size_t overlap[3] = {10, 0, 0};
+    const size_t n_tiles[3] = {2, 1, 1};
+    
+    // Copies of each source, as detected by each tile: ID, tile, bounding box and size
+    const long int copies[][9] = {
+        {101, 0, 45, 55,  5, 10, 2, 4, 100},  // Source 1: complete, centroid outside core
+        {102, 1, 45, 55,  5, 10, 2, 4, 100},  // Source 1: complete, centroid inside core
+        {201, 0, 30, 59, 20, 30, 2, 6, 300},  // Source 2: truncated at x = 59
+        {202, 1, 40, 70, 20, 30, 2, 6, 350},  // Source 2: truncated at x = 40
+        {301, 0, 38, 52, 35, 40, 0, 3,  80},  // Source 3: complete, centroid inside core
+        {302, 1, 40, 52, 35, 40, 0, 3,  70},  // Source 3: truncated at x = 40
+        {401, 1, 80, 85, 10, 15, 5, 8,  30}   // Source 4: complete, centroid inside core
+    };
+    const long int expected[] = {102, 202, 301, 401};
+    
+    Catalog *catalog = Catalog_new();
+    Array_siz *source_tiles = Array_siz_new(0);
+    
+    for(size_t i = 0; i < 7; ++i)
+    {
+        Catalog_add_source(catalog, mock_source(copies[i][0], copies[i] + 2, copies[i][8]));
+        Array_siz_push(source_tiles, copies[i][1]);
+    }
+    
+    Catalog *merged = Catalog_merge_tiles(catalog, source_tiles, bounds, tile_size, overlap, n_tiles, true);
+    
+    // Assert one entry per source, and original catalogue unchanged
+    ck_assert(Catalog_get_size(catalog) == 7);
+    ck_assert(Catalog_get_size(merged) == 4);
+    for(size_t i = 0; i < 4; ++i) ck_assert(Source_get_par_by_name_int(Catalog_get_source(merged, i), "id") == expected[i]);
+    
+    // Cleanup
+    Catalog_delete(merged);
+    Catalog_delete(catalog);
+    Array_siz_delete(source_tiles);
+}
+END_TEST
+
+/**
+ * @brief Test stability of catalogue column order
+ * 
+ * Creates three sources with the same parameters, then overwrites some of them with a new value,
+ * unit or type, and in a different order on each source, as done during parameterisation. This
+ * test asserts that all sources retain the original parameter order and that the columns of the
+ * catalogue saved in XML format appear in that same order.
+ * 
+ */
+START_TEST (catalog_column_order)
+{
+    const char *names[5] = {"id", "x", "y", "f_sum", "rms"};
+    const char *filename = "test_catalog_column_order.xml";
+    Catalog *catalog = Catalog_new();
+    
+    for(size_t i = 0; i < 3; ++i)
+    {
+        Source *src = Source_new(false);
+        Source_set_identifier(src, "SoFiA");
+        Source_set_par_int(src, names[0], i + 1, "", "meta.id");
+        for(size_t j = 1; j < 5; ++j) Source_set_par_flt(src, names[j], j, "", "");
+        Catalog_add_source(catalog, src);
+    }
+    
+    Source_set_par_flt(Catalog_get_source(catalog, 0), "rms", 0.5, NULL, NULL);
+    Source_set_par_flt(Catalog_get_source(catalog, 0), "x", 2.5, "pix", "pos.cartesian.x");
+    Source_set_par_flt(Catalog_get_source(catalog, 1), "f_sum", 3.5, "Jy", "phot.flux");
+    Source_set_par_int(Catalog_get_source(catalog, 1), "y", 4, NULL, NULL);
+    Source_set_par_flt(Catalog_get_source(catalog, 2), "y", 4.5, NULL, NULL);
+    
+    // Assert parameter order of all sources
+    for(size_t i = 0; i < 3; ++i)
+    {
+        const Source *src = Catalog_get_source(catalog, i);
+        ck_assert(Source_get_num_par(src) == 5);
+        for(size_t j = 0; j < 5; ++j) ck_assert(strcmp(Source_get_name(src, j), names[j]) == 0);
+    }
+    
+    // Assert column order of saved catalogue
+    Catalog_save(catalog, filename, CATALOG_FORMAT_XML, true, NULL);
+    FILE *fp = fopen(filename, "r");
+    ck_assert(fp != NULL);
+    
+    char line[1024];
+    char field[64];
+    size_t n_col = 0;
+    while(fgets(line, sizeof(line), fp) != NULL)
+    {
+        const char *name = strstr(line, "<FIELD ");
+        if(name == NULL || (name = strstr(name, " name=\"")) == NULL) continue;
+        ck_assert(sscanf(name, " name=\"%63[^\"]\"", field) == 1);
+        if(n_col == 0) ck_assert(strcmp(field, "name") == 0);
+        else ck_assert(n_col <= 5 && strcmp(field, names[n_col - 1]) == 0);
+        ++n_col;
+    }
+    ck_assert(n_col == 6);
+    
+    // Cleanup
+    fclose(fp);
+    remove(filename);
+    Catalog_delete(catalog);
+}
+END_TEST
+
+/**
+ * @brief Test FITS binary table output
+ * 
+ * Saves a catalogue of three sources with names of different length and with integer and floating-
+ * point parameters in FITS format and reads the file back in. This test asserts that the primary
+ * HDU is empty, that the binary table header contains the expected NAXISn, TFIELDS, TTYPEn, TFORMn
+ * and TUNITn entries, that each row contains the NUL-padded name followed by all parameters in
+ * big-endian byte order, and that the file is padded with zeros to a multiple of 2880 bytes.
+ * 
+ */
+START_TEST (catalog_save_fits)
+{
+    const char *filename = "test_catalog_save_fits.fits";
+    const char *names[3] = {"SoFiA J1", "SoFiA J123456", "SoFiA J12"};
+    const long int values_int[3] = {1, -5, 1099511627776};
+    const double values_flt[3] = {1.5, -2.25e10, 3.0e-300};
+    Catalog *catalog = Catalog_new();
+    
+    for(size_t i = 0; i < 3; ++i)
+    {
+        Source *src = Source_new(false);
+        Source_set_identifier(src, names[i]);
+        Source_add_par_int(src, "id", values_int[i], "", "meta.id");
+        Source_add_par_flt(src, "f_sum", values_flt[i], "Jy", "phot.flux");
+        Catalog_add_source(catalog, src);
+    }
+    
+    Catalog_save(catalog, filename, CATALOG_FORMAT_FITS, true, NULL);
+    
+    // Read file back in
+    FILE *fp = fopen(filename, "rb");
+    ck_assert(fp != NULL);
+    fseek(fp, 0, SEEK_END);
+    const size_t size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *data = (char *)malloc(size);
+    ck_assert(data != NULL);
+    ck_assert(fread(data, 1, size, fp) == size);
+    fclose(fp);
+    remove(filename);
+    
+    ck_assert(size % FITS_HEADER_BLOCK_SIZE == 0);
+    
+    // Primary HDU
+    const size_t size_primary = header_size(data, size);
+    ck_assert(size_primary == FITS_HEADER_BLOCK_SIZE);
+    Header *header = Header_new(data, size_primary, false);
+    ck_assert(Header_get_bool(header, "SIMPLE"));
+    ck_assert(Header_get_int(header, "NAXIS") == 0);
+    ck_assert(Header_get_bool(header, "EXTEND"));
+    Header_delete(header);
+    
+    // Binary table header
+    const size_t size_table = header_size(data + size_primary, size - size_primary);
+    ck_assert(size_table > 0);
+    header = Header_new(data + size_primary, size_table, false);
+    ck_assert(header_str_equal(header, "XTENSION", "BINTABLE"));
+    ck_assert(Header_get_int(header, "NAXIS") == 2);
+    ck_assert(Header_get_int(header, "NAXIS1") == 13 + 2 * 8);
+    ck_assert(Header_get_int(header, "NAXIS2") == 3);
+    ck_assert(Header_get_int(header, "TFIELDS") == 3);
+    ck_assert(header_str_equal(header, "TTYPE1", "name"));
+    ck_assert(header_str_equal(header, "TFORM1", "13A"));
+    ck_assert(header_str_equal(header, "TTYPE2", "id"));
+    ck_assert(header_str_equal(header, "TFORM2", "K"));
+    ck_assert(!Header_check(header, "TUNIT2"));
+    ck_assert(header_str_equal(header, "TTYPE3", "f_sum"));
+    ck_assert(header_str_equal(header, "TFORM3", "D"));
+    ck_assert(header_str_equal(header, "TUNIT3", "Jy"));
+    Header_delete(header);
+    
+    // Table rows
+    const unsigned char *row = (const unsigned char *)data + size_primary + size_table;
+    const size_t row_size = 13 + 2 * 8;
+    ck_assert(size_primary + size_table + 3 * row_size <= size);
+    
+    for(size_t i = 0; i < 3; ++i, row += row_size)
+    {
+        const size_t length = strlen(names[i]);
+        ck_assert(memcmp(row, names[i], length) == 0);
+        for(size_t j = length; j < 13; ++j) ck_assert(row[j] == 0);
+        
+        ck_assert((int64_t)read_big_endian(row + 13) == values_int[i]);
+        const uint64_t bits = read_big_endian(row + 21);
+        double value_flt;
+        memcpy(&value_flt, &bits, sizeof(double));
+        ck_assert(value_flt == values_flt[i]);
+    }
+    
+    // Zero padding
+    for(const unsigned char *ptr = row; ptr < (const unsigned char *)data + size; ++ptr) ck_assert(*ptr == 0);
+    
+    // Cleanup
+    free(data);
+    Catalog_delete(catalog);
+}
+END_TEST
+
+Suite *Catalog_test_suite(void) {
+    Suite *s;
+    TCase *tc_catalog_merge_tiles, *tc_catalog_column_order, *tc_catalog_save_fits;
+
+    // Create test suite
+    s = suite_create("Catalog");
+
+    // Create test cases
+    tc_catalog_merge_tiles = tcase_create("catalog_merge_tiles");
+    tc_catalog_column_order = tcase_create("catalog_column_order");
+    tc_catalog_save_fits = tcase_create("catalog_save_fits");
+
+    // Add test cases to test suite
+    tcase_add_test(tc_catalog_merge_tiles, catalog_merge_tiles);
+    tcase_add_test(tc_catalog_column_order, catalog_column_order);
+    tcase_add_test(tc_catalog_save_fits, catalog_save_fits);
+    suite_add_tcase(s, tc_catalog_merge_tiles);
+    suite_add_tcase(s, tc_catalog_column_order);
+    suite_add_tcase(s, tc_catalog_save_fits);
+    
+    return s;
+}
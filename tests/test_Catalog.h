@@ -0,0 +1,8 @@
+#ifndef TEST_Catalog_H
+#define TEST_Catalog_H
+
+#include <check.h>
+
+Suite *Catalog_test_suite (void);
+
+#endif
@@ -0,0 +1,218 @@
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "test_DataCube.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../src/DataCube.h"
+#include "../src/BitMask.h"
+#include "../src/Array_dbl.h"
+#include "../src/Array_siz.h"
+#include "../src/LinkerPar.h"
+#include "../src/Catalog.h"
+#include "../src/Source.h"
+
+/**
+ * @brief Create mock data cube
+ * 
+ * Creates a single-precision data cube of the specified size filled with approximately Gaussian
+ * noise of unit standard deviation, a bright, extended source near the centre and a blanked
+ * region near the edge of the cube.
+ * 
+ */
+static DataCube *mock_cube(const size_t nx, const size_t ny, const size_t nz)
+{
+    DataCube *cube = DataCube_blank(nx, ny, nz, -32, false);
+    
+    srand(42);
+    for(size_t z = 0; z < nz; ++z)
+    {
+        for(size_t y = 0; y < ny; ++y)
+        {
+            for(size_t x = 0; x < nx; ++x)
+            {
+                double value = -6.0;
+                for(int i = 0; i < 12; ++i) value += (double)rand() / RAND_MAX;
+                
+                const double r_squ = (x - nx / 2.0) * (x - nx / 2.0) + (y - ny / 2.0) * (y - ny / 2.0);
+                const double z_squ = (z - nz / 2.0) * (z - nz / 2.0);
+                value += 2.0 * exp(-r_squ / 50.0 - z_squ / 200.0);
+                
+                if(x < 10 && y < 20 && z > nz - 15) value = NAN;
+                DataCube_set_data_flt(cube, x, y, z, value);
+            }
+        }
+    }
+    
+    return cube;
+}
+
+/**
+ * @brief Compare S+C finder on offload device with S+C finder on CPU
+ * 
+ * Runs @p DataCube_run_scfind and @p DataCube_run_scfind_device with all noise measurement methods
+ * and flux ranges on two mock cubes and asserts that the resulting masks are identical. Both cubes
+ * are large enough for a noise sampling cadence of 2 to be used; the first has a size that is a
+ * multiple of the cadence, while the second has an odd size and an odd number of samples, which
+ * exercises the sample limits of the MAD. If no offload device is available, the device kernels
+ * are executed on the host.
+ * 
+ */
+START_TEST (scfind_device_identical)
+{
+    const size_t sizes[][3] = {{100, 100, 200}, {101, 101, 203}};
+    const noise_stat methods[] = {NOISE_STAT_STD, NOISE_STAT_MAD, NOISE_STAT_MAD, NOISE_STAT_GAUSS};
+    const double tolerances[] = {0.0, 0.0, 0.01, 0.0};
+    Array_dbl *kernels_spat = Array_dbl_new_str("0, 3");
+    Array_siz *kernels_spec = Array_siz_new_str("0, 3");
+    
+    for(size_t c = 0; c < 2; ++c)
+    {
+        DataCube *cube = mock_cube(sizes[c][0], sizes[c][1], sizes[c][2]);
+        const size_t size = sizes[c][0] * sizes[c][1] * sizes[c][2];
+        
+        for(size_t m = 0; m < 4; ++m)
+        {
+            for(int range = -1; range <= 1; ++range)
+            {
+                BitMask *mask_cpu = BitMask_new(size);
+                BitMask *mask_dev = BitMask_new(size);
+                
+                DataCube_run_scfind(cube, mask_cpu, kernels_spat, kernels_spec, 3.5, 2.0, methods[m], range, tolerances[m], 0, NOISE_STAT_STD, 0, 0, 0, 0, 0, false, NULL, time(NULL), clock());
+                DataCube_run_scfind_device(cube, mask_dev, kernels_spat, kernels_spec, 3.5, 2.0, methods[m], range, tolerances[m], NULL, time(NULL), clock());
+                
+                // Assert non-trivial and identical masks
+                ck_assert(BitMask_count(mask_cpu) > 0);
+                ck_assert(BitMask_count(mask_cpu) < size / 10);
+                for(size_t w = 0; w < BitMask_get_words(mask_cpu); ++w) ck_assert(BitMask_get_word(mask_cpu, w) == BitMask_get_word(mask_dev, w));
+                
+                BitMask_delete(mask_cpu);
+                BitMask_delete(mask_dev);
+            }
+        }
+        
+        DataCube_delete(cube);
+    }
+    
+    // Cleanup
+    Array_dbl_delete(kernels_spat);
+    Array_siz_delete(kernels_spec);
+}
+END_TEST
+
+/**
+ * @brief Compare parallel linker with serial linker
+ * 
+ * Links a mock mask containing noise detections and several extended sources, some of which span
+ * the boundaries between the spectral slabs of the parallel linker, with both the serial and the
+ * parallel linker. The number of threads is fixed to 4, such that the 40 channels of the cube are
+ * divided into slabs at z = 10, 20 and 30. This test asserts that both linkers produce identical
+ * labels in the mask, the same number of sources and identical parameters for each source in the
+ * returned LinkerPar object.
+ * 
+ */
+START_TEST (linker_parallel_identical)
+{
+    const size_t nx = 60, ny = 50, nz = 40;
+    DataCube *cube = mock_cube(nx, ny, nz);
+    DataCube *mask_serial = DataCube_blank(nx, ny, nz, 32, false);
+    
+    // Extended sources crossing one or more slab boundaries, including a negative one
+    const size_t sources[][6] = {{5, 8, 5, 8, 6, 14}, {20, 22, 30, 34, 8, 32}, {40, 45, 10, 12, 19, 21}, {50, 52, 40, 44, 28, 39}};
+    const double fluxes[] = {5.0, 4.0, -6.0, 3.0};
+    
+    for(size_t i = 0; i < 4; ++i)
+    {
+        for(size_t z = sources[i][4]; z <= sources[i][5]; ++z)
+            for(size_t y = sources[i][2]; y <= sources[i][3]; ++y)
+                for(size_t x = sources[i][0]; x <= sources[i][1]; ++x) DataCube_set_data_flt(cube, x, y, z, fluxes[i]);
+    }
+    
+    // Detect noise peaks and sources
+    for(size_t z = 0; z < nz; ++z)
+        for(size_t y = 0; y < ny; ++y)
+            for(size_t x = 0; x < nx; ++x) if(fabs(DataCube_get_data_flt(cube, x, y, z)) > 2.5) DataCube_set_data_int(mask_serial, x, y, z, -1);
+    
+    DataCube *mask_parallel = DataCube_copy(mask_serial);
+    
+    #ifdef _OPENMP
+        const int n_threads = omp_get_max_threads();
+        omp_set_num_threads(4);
+    #endif
+    
+    for(int pos_src = 0; pos_src < 2; ++pos_src)
+    {
+        DataCube *mask_a = DataCube_copy(mask_serial);
+        DataCube *mask_b = DataCube_copy(mask_parallel);
+        LinkerPar *lpar_serial = DataCube_run_linker(cube, mask_a, 2, 2, 2, 2, 2, 2, 5, 0.0, 0, 0, 0, 0, 0.0, false, pos_src, 1.0, false);
+        LinkerPar *lpar_parallel = DataCube_run_linker(cube, mask_b, 2, 2, 2, 2, 2, 2, 5, 0.0, 0, 0, 0, 0, 0.0, false, pos_src, 1.0, true);
+        
+        // Assert identical labels
+        for(size_t z = 0; z < nz; ++z)
+            for(size_t y = 0; y < ny; ++y)
+                for(size_t x = 0; x < nx; ++x) ck_assert(DataCube_get_data_int(mask_a, x, y, z) == DataCube_get_data_int(mask_b, x, y, z));
+        
+        // Assert identical source counts and parameters
+        ck_assert(LinkerPar_get_size(lpar_serial) >= 4 - pos_src);
+        ck_assert(LinkerPar_get_size(lpar_serial) == LinkerPar_get_size(lpar_parallel));
+        
+        Catalog *cat_serial = LinkerPar_make_catalog(lpar_serial, NULL, "Jy");
+        Catalog *cat_parallel = LinkerPar_make_catalog(lpar_parallel, NULL, "Jy");
+        ck_assert(Catalog_get_size(cat_serial) == Catalog_get_size(cat_parallel));
+        
+        for(size_t i = 0; i < Catalog_get_size(cat_serial); ++i)
+        {
+            const Source *src_serial = Catalog_get_source(cat_serial, i);
+            const Source *src_parallel = Catalog_get_source(cat_parallel, i);
+            ck_assert(Source_get_num_par(src_serial) == Source_get_num_par(src_parallel));
+            
+            for(size_t j = 0; j < Source_get_num_par(src_serial); ++j)
+            {
+                ck_assert(Source_get_type(src_serial, j) == Source_get_type(src_parallel, j));
+                if(Source_get_type(src_serial, j) == SOURCE_TYPE_INT) ck_assert(Source_get_par_int(src_serial, j) == Source_get_par_int(src_parallel, j));
+                else ck_assert(Source_get_par_flt(src_serial, j) == Source_get_par_flt(src_parallel, j));
+            }
+        }
+        
+        Catalog_delete(cat_serial);
+        Catalog_delete(cat_parallel);
+        LinkerPar_delete(lpar_serial);
+        LinkerPar_delete(lpar_parallel);
+        DataCube_delete(mask_a);
+        DataCube_delete(mask_b);
+    }
+    
+    #ifdef _OPENMP
+        omp_set_num_threads(n_threads);
+    #endif
+    
+    // Cleanup
+    DataCube_delete(cube);
+    DataCube_delete(mask_serial);
+    DataCube_delete(mask_parallel);
+}
+END_TEST
+
+Suite *DataCube_test_suite(void) {
+    Suite *s;
+    TCase *tc_scfind_device_identical, *tc_linker_parallel_identical;
+
+    // Create test suite
+    s = suite_create("DataCube");
+
+    // Create test cases
+    tc_scfind_device_identical = tcase_create("scfind_device_identical");
+    tcase_set_timeout(tc_scfind_device_identical, 120);
+    tc_linker_parallel_identical = tcase_create("linker_parallel_identical");
+
+    // Add test cases to test suite
+    tcase_add_test(tc_scfind_device_identical, scfind_device_identical);
+    tcase_add_test(tc_linker_parallel_identical, linker_parallel_identical);
+    suite_add_tcase(s, tc_scfind_device_identical);
+    suite_add_tcase(s, tc_linker_parallel_identical);
+    
+    return s;
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_DataCube_H
+#define TEST_DataCube_H
+
+#include <check.h>
+
+Suite *DataCube_test_suite (void);
+
+#endif
@@ -0,0 +1,227 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "test_Header.h"
+
+#include "../src/Header.h"
+
+/**
+ * @brief Reference keyword search
+ * 
+ * Line number of the first occurrence of the specified keyword, determined by scanning all lines
+ * of the header in the same way as @p Header_check did before the introduction of the keyword index.
+ * Returns 0 if the keyword is not found.
+ * 
+ */
+static size_t linear_check(const Header *header, const char *key)
+{
+    const char *ptr = Header_get(header);
+    const size_t size = strlen(key);
+    size_t line = 1;
+    
+    while(ptr < Header_get(header) + Header_get_size(header))
+    {
+        if(strncmp(ptr, key, size) == 0 && (*(ptr + size) == ' ' || *(ptr + size) == '=')) return line;
+        ptr += FITS_HEADER_LINE_SIZE;
+        ++line;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Assert index lookups against reference search
+ * 
+ * Asserts that @p Header_check returns the same line number as the reference search for keywords
+ * KEY0 to KEY(n - 1) and a number of additional keywords, including ones that are prefixes of
+ * other keywords, commentary keywords and keywords that do not exist.
+ * 
+ */
+static int keys_consistent(const Header *header, const size_t n)
+{
+    const char *extra[] = {"SIMPLE", "NAXIS", "NAXIS1", "NAXIS3", "END", "HISTORY", "COMMENT", "KEY", "KEY1000", "BUNIT", "CDELT3"};
+    char key[16];
+    
+    for(size_t i = 0; i < n; ++i)
+    {
+        snprintf(key, sizeof(key), "KEY%zu", i);
+        if(Header_check(header, key) != linear_check(header, key)) return 0;
+    }
+    for(size_t i = 0; i < sizeof(extra) / sizeof(extra[0]); ++i) if(Header_check(header, extra[i]) != linear_check(header, extra[i])) return 0;
+    
+    return 1;
+}
+
+/**
+ * @brief Test keyword lookup after setting header entries
+ * 
+ * Adds 150 keywords of different types to a blank header, interleaved with @p HISTORY and
+ * @p COMMENT entries, such that the header grows across several blocks, and overwrites some of
+ * them afterwards. This test asserts that all lookups agree with the linear search, that
+ * overwriting does not move a keyword and that all values can be retrieved.
+ * 
+ */
+START_TEST (header_index_set)
+{
+    Header *header = Header_blank(false);
+    char key[16];
+    
+    Header_set_int(header, "NAXIS", 3);
+    Header_set_int(header, "NAXIS1", 100);
+    Header_set_int(header, "NAXIS3", 300);
+    
+    for(size_t i = 0; i < 150; ++i)
+    {
+        snprintf(key, sizeof(key), "KEY%zu", i);
+        if(i % 3 == 0) Header_set_int(header, key, i);
+        else if(i % 3 == 1) Header_set_flt(header, key, i + 0.5);
+        else Header_set_str(header, key, "value");
+        if(i % 10 == 0) Header_comment(header, "Some history.", true);
+        if(i % 25 == 0) Header_comment(header, "Some comment.", false);
+    }
+    
+    ck_assert(Header_get_size(header) > 4 * FITS_HEADER_BLOCK_SIZE);
+    ck_assert(keys_consistent(header, 150));
+    
+    // Overwrite existing keywords
+    const size_t line = Header_check(header, "KEY42");
+    Header_set_int(header, "KEY42", -42);
+    Header_set_int(header, "NAXIS", 2);
+    ck_assert(Header_check(header, "KEY42") == line);
+    ck_assert(keys_consistent(header, 150));
+    
+    // Retrieve values
+    ck_assert(Header_get_int(header, "KEY42") == -42);
+    ck_assert(Header_get_int(header, "KEY99") == 99);
+    ck_assert(Header_get_flt(header, "KEY100") == 100.5);
+    ck_assert(Header_get_int(header, "NAXIS") == 2);
+    ck_assert(Header_get_int(header, "NAXIS1") == 100);
+    ck_assert(Header_get_int(header, "NAXIS3") == 300);
+    
+    // Copy retains index
+    Header *copy = Header_copy(header);
+    ck_assert(keys_consistent(copy, 150));
+    
+    // Cleanup
+    Header_delete(copy);
+    Header_delete(header);
+}
+END_TEST
+
+/**
+ * @brief Test keyword lookup after removing header entries
+ * 
+ * Removes a single keyword, all @p HISTORY entries and a keyword that does not exist from a header
+ * spanning several blocks, and adds new keywords afterwards. This test asserts that all lookups
+ * agree with the linear search after each operation, and that all occurrences of @p HISTORY have
+ * been removed.
+ * 
+ */
+START_TEST (header_index_remove)
+{
+    Header *header = Header_blank(false);
+    char key[16];
+    
+    for(size_t i = 0; i < 100; ++i)
+    {
+        snprintf(key, sizeof(key), "KEY%zu", i);
+        Header_set_int(header, key, i);
+        if(i % 5 == 0) Header_comment(header, "Some history.", true);
+    }
+    
+    const size_t size = Header_get_size(header);
+    
+    ck_assert(Header_remove(header, "KEY50") == 0);
+    ck_assert(Header_check(header, "KEY50") == 0);
+    ck_assert(keys_consistent(header, 100));
+    
+    ck_assert(Header_remove(header, "HISTORY") == 0);
+    ck_assert(linear_check(header, "HISTORY") == 0);
+    ck_assert(keys_consistent(header, 100));
+    ck_assert(Header_get_size(header) < size);
+    
+    ck_assert(Header_remove(header, "KEY1000") == 1);
+    ck_assert(keys_consistent(header, 100));
+    
+    // Add keywords after removal
+    Header_set_int(header, "KEY50", 5050);
+    Header_comment(header, "New history.", true);
+    ck_assert(keys_consistent(header, 100));
+    ck_assert(Header_get_int(header, "KEY50") == 5050);
+    ck_assert(Header_get_int(header, "KEY51") == 51);
+    
+    // Cleanup
+    Header_delete(header);
+}
+END_TEST
+
+/**
+ * @brief Test keyword lookup for duplicate keywords
+ * 
+ * Creates a header from a raw header block in which the keywords @p HISTORY, @p COMMENT and
+ * @p KEY1 occur more than once. This test asserts that lookups return the first occurrence of each
+ * keyword, as the linear search did, both for the original header and a copy.
+ * 
+ */
+START_TEST (header_index_duplicates)
+{
+    const char *cards[] = {
+        "SIMPLE  =                    T",
+        "HISTORY First history entry",
+        "KEY1    =                    1",
+        "COMMENT First comment",
+        "HISTORY Second history entry",
+        "KEY1    =                    2",
+        "KEY10   =                   10",
+        "COMMENT Second comment",
+        "END"
+    };
+    const size_t n_cards = sizeof(cards) / sizeof(cards[0]);
+    char block[FITS_HEADER_BLOCK_SIZE];
+    memset(block, ' ', FITS_HEADER_BLOCK_SIZE);
+    for(size_t i = 0; i < n_cards; ++i) memcpy(block + i * FITS_HEADER_LINE_SIZE, cards[i], strlen(cards[i]));
+    
+    Header *header = Header_new(block, FITS_HEADER_BLOCK_SIZE, false);
+    Header *copy = Header_copy(header);
+    
+    ck_assert(Header_check(header, "HISTORY") == 2);
+    ck_assert(Header_check(header, "COMMENT") == 4);
+    ck_assert(Header_check(header, "KEY1") == 3);
+    ck_assert(Header_check(header, "KEY10") == 7);
+    ck_assert(Header_get_int(header, "KEY1") == 1);
+    ck_assert(keys_consistent(header, 20));
+    ck_assert(keys_consistent(copy, 20));
+    
+    // Appending further duplicates does not change first occurrence
+    Header_comment(header, "Third history entry", true);
+    ck_assert(Header_check(header, "HISTORY") == 2);
+    ck_assert(keys_consistent(header, 20));
+    
+    // Cleanup
+    Header_delete(copy);
+    Header_delete(header);
+}
+END_TEST
+
+Suite *Header_test_suite(void) {
+    Suite *s;
+    TCase *tc_header_index_set, *tc_header_index_remove, *tc_header_index_duplicates;
+
+    // Create test suite
+    s = suite_create("Header");
+
+    // Create test cases
+    tc_header_index_set = tcase_create("header_index_set");
+    tc_header_index_remove = tcase_create("header_index_remove");
+    tc_header_index_duplicates = tcase_create("header_index_duplicates");
+
+    // Add test cases to test suite
+    tcase_add_test(tc_header_index_set, header_index_set);
+    tcase_add_test(tc_header_index_remove, header_index_remove);
+    tcase_add_test(tc_header_index_duplicates, header_index_duplicates);
+    suite_add_tcase(s, tc_header_index_set);
+    suite_add_tcase(s, tc_header_index_remove);
+    suite_add_tcase(s, tc_header_index_duplicates);
+    
+    return s;
+}
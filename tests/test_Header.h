@@ -0,0 +1,8 @@
+#ifndef TEST_Header_H
+#define TEST_Header_H
+
+#include <check.h>
+
+Suite *Header_test_suite (void);
+
+#endif
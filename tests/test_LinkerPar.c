@@ -1,10 +1,13 @@
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
 #include "test_LinkerPar.h"
 
 #include "../src/LinkerPar.h"
 #include "../src/Array_dbl.h"
 #include "../src/Matrix.h"
+#include "../src/Map.h"
+#include "../src/KDTree.h"
 
 /**
  * @brief Test calculation of covariance matrix
@@ -168,7 +171,7 @@ START_TEST (skellam_array)
 
     // Calculate skellam
     Array_dbl *skellam = NULL;
-    LinkerPar_calculate_skellam(&skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, 1.0);
+    LinkerPar_calculate_skellam(&skellam, covar_inv, par_pos, par_neg, dim, n_pos, n_neg, 1.0, 0.0);
 
     // Assert calculated value within tolerance of known value
     double values[] = {
@@ -185,10 +188,337 @@ START_TEST (skellam_array)
 } 
 END_TEST
 
+// Test that duplicate keys in a map resolve to their last occurrence
+START_TEST (map_duplicate_keys)
+{
+    Map *map = Map_new();
+    
+    Map_push(map, 7, 1);
+    Map_push(map, 3, 2);
+    Map_push(map, 7, 3);
+    Map_push(map, 7, 4);
+    
+    ck_assert(Map_get_size(map) == 4);
+    ck_assert(Map_get_value(map, 7) == 4);
+    ck_assert(Map_get_value(map, 3) == 2);
+    ck_assert(!Map_key_exists(map, 5));
+    
+    // Cleanup
+    Map_delete(map);
+}
+END_TEST
+
+// Test that a map keeps all entries and last occurrences across rehashes
+START_TEST (map_rehash)
+{
+    // Keys are multiples of 1024 to force collisions in the low bits
+    const size_t n = 1000;
+    Map *map = Map_new();
+    
+    for(size_t i = 0; i < n; ++i) Map_push(map, i * 1024, i);
+    
+    // Overwrite every third key after the table has been grown several times
+    for(size_t i = 0; i < n; i += 3) Map_push(map, i * 1024, i + n);
+    
+    ck_assert(Map_get_size(map) == n + (n + 2) / 3);
+    for(size_t i = 0; i < n; ++i)
+    {
+        ck_assert(Map_key_exists(map, i * 1024));
+        ck_assert(Map_get_value(map, i * 1024) == (i % 3 ? i : i + n));
+        ck_assert(!Map_key_exists(map, i * 1024 + 1));
+    }
+    
+    // Reserving afterwards must not lose any entries either
+    Map_reserve(map, 4 * n);
+    for(size_t i = 0; i < n; ++i) ck_assert(Map_get_value(map, i * 1024) == (i % 3 ? i : i + n));
+    
+    // Cleanup
+    Map_delete(map);
+}
+END_TEST
+
+// Test key lookup on an empty map
+START_TEST (map_empty)
+{
+    Map *map = Map_new();
+    
+    ck_assert(Map_get_size(map) == 0);
+    ck_assert(!Map_key_exists(map, 0));
+    ck_assert(!Map_key_exists(map, 42));
+    
+    // Still empty after reserving space
+    Map_reserve(map, 100);
+    ck_assert(!Map_key_exists(map, 0));
+    
+    // Cleanup
+    Map_delete(map);
+}
+END_TEST
+
+// Test that the Cholesky factor reproduces the original matrix
+START_TEST (matrix_cholesky)
+{
+    const size_t dim = 4;
+    const double values[] = {
+        4.0, 1.2, -0.6, 0.3,
+        1.2, 3.0, 0.5, -0.2,
+        -0.6, 0.5, 2.5, 0.8,
+        0.3, -0.2, 0.8, 1.9
+    };
+    Matrix *matrix = Matrix_new(dim, dim);
+    for(size_t i = 0; i < dim; ++i)
+        for(size_t j = 0; j < dim; ++j) Matrix_set_value(matrix, i, j, values[i * dim + j]);
+    
+    // Decompose and multiply back together
+    Matrix *lower = Matrix_cholesky(matrix);
+    ck_assert(lower != NULL);
+    Matrix *upper = Matrix_transpose(lower);
+    Matrix *product = Matrix_mul_matrix(lower, upper);
+    
+    // Assert L is lower-triangular and L L^T equals the input
+    double tol = 1.0e-12;
+    for(size_t i = 0; i < dim; ++i)
+    {
+        for(size_t j = 0; j < dim; ++j)
+        {
+            if(j > i) ck_assert(Matrix_get_value(lower, i, j) == 0.0);
+            ck_assert(fabs(Matrix_get_value(product, i, j) - values[i * dim + j]) < tol);
+        }
+    }
+    
+    // Cleanup
+    Matrix_delete(matrix);
+    Matrix_delete(lower);
+    Matrix_delete(upper);
+    Matrix_delete(product);
+}
+END_TEST
+
+// Test that the Cholesky decomposition rejects non-positive-definite matrices
+START_TEST (matrix_cholesky_not_pos_def)
+{
+    // Symmetric but indefinite (eigenvalues 3 and -1)
+    Matrix *matrix = Matrix_new(2, 2);
+    Matrix_set_value(matrix, 0, 0, 1.0);
+    Matrix_set_value(matrix, 0, 1, 2.0);
+    Matrix_set_value(matrix, 1, 0, 2.0);
+    Matrix_set_value(matrix, 1, 1, 1.0);
+    ck_assert(Matrix_cholesky(matrix) == NULL);
+    
+    // Singular (positive semi-definite only)
+    Matrix_set_value(matrix, 0, 1, 1.0);
+    Matrix_set_value(matrix, 1, 0, 1.0);
+    ck_assert(Matrix_cholesky(matrix) == NULL);
+    
+    // Cleanup
+    Matrix_delete(matrix);
+}
+END_TEST
+
+// Test that the k-d tree kernel sum with infinite radius agrees with brute force
+START_TEST (kdtree_kernel_sum)
+{
+    const size_t dim = 3;
+    const size_t size = 500;
+    double *points = (double *)malloc(size * dim * sizeof(double));
+    ck_assert(points != NULL);
+    
+    srand(42);
+    for(size_t i = 0; i < size * dim; ++i) points[i] = 4.0 * rand() / RAND_MAX - 2.0;
+    
+    KDTree *tree = KDTree_new(points, size, dim);
+    ck_assert(KDTree_get_size(tree) == size);
+    
+    const double positions[][3] = {{0.0, 0.0, 0.0}, {1.5, -0.7, 0.2}, {10.0, 10.0, -10.0}};
+    
+    for(size_t p = 0; p < 3; ++p)
+    {
+        // Brute-force sum
+        double sum = 0.0;
+        for(size_t i = 0; i < size; ++i)
+        {
+            double d_squ = 0.0;
+            for(size_t j = 0; j < dim; ++j) d_squ += (points[i * dim + j] - positions[p][j]) * (points[i * dim + j] - positions[p][j]);
+            sum += exp(-0.5 * d_squ);
+        }
+        
+        // Kernel sum only differs in summation order
+        const double kernel_sum = KDTree_kernel_sum(tree, positions[p], INFINITY);
+        ck_assert(fabs(kernel_sum - sum) <= 1.0e-12 * sum);
+    }
+    
+    // Cleanup
+    KDTree_delete(tree);
+    free(points);
+}
+END_TEST
+
+// Test that k-d tree neighbour search with infinite radius agrees with brute force
+START_TEST (kdtree_neighbours)
+{
+    const size_t dim = 3;
+    const size_t size = 500;
+    double *points = (double *)malloc(size * dim * sizeof(double));
+    ck_assert(points != NULL);
+    
+    srand(42);
+    for(size_t i = 0; i < size * dim; ++i) points[i] = 4.0 * rand() / RAND_MAX - 2.0;
+    
+    KDTree *tree = KDTree_new(points, size, dim);
+    
+    const double positions[][3] = {{0.0, 0.0, 0.0}, {1.5, -0.7, 0.2}, {10.0, 10.0, -10.0}};
+    
+    for(size_t p = 0; p < 3; ++p)
+    {
+        // Brute-force squared distances
+        Array_dbl *expected = Array_dbl_new(0);
+        for(size_t i = 0; i < size; ++i)
+        {
+            double d_squ = 0.0;
+            for(size_t j = 0; j < dim; ++j) d_squ += (points[i * dim + j] - positions[p][j]) * (points[i * dim + j] - positions[p][j]);
+            Array_dbl_push(expected, d_squ);
+        }
+        
+        // Same set of squared distances, in any order
+        Array_dbl *dist_squ = Array_dbl_new(0);
+        KDTree_neighbours(tree, positions[p], INFINITY, dist_squ);
+        ck_assert(Array_dbl_get_size(dist_squ) == size);
+        Array_dbl_sort(expected);
+        Array_dbl_sort(dist_squ);
+        for(size_t i = 0; i < size; ++i) ck_assert(fabs(Array_dbl_get(dist_squ, i) - Array_dbl_get(expected, i)) <= 1.0e-12 * Array_dbl_get(expected, i));
+        
+        Array_dbl_delete(expected);
+        Array_dbl_delete(dist_squ);
+    }
+    
+    // Cleanup
+    KDTree_delete(tree);
+    free(points);
+}
+END_TEST
+
+// Test that the batched density sum is bit-identical to the scalar version
+START_TEST (matrix_prob_dens_sum)
+{
+    // Not a multiple of MATRIX_BATCH_SIZE, so the last batch is partial
+    const size_t n = 1000;
+    const double scal_fact = 0.37;
+    
+    srand(7);
+    for(size_t dim = 1; dim <= 5; ++dim)
+    {
+        // Random positive-definite inverse covariance matrix M = A A^T + dim I
+        Matrix *a = Matrix_new(dim, dim);
+        for(size_t i = 0; i < dim; ++i)
+            for(size_t j = 0; j < dim; ++j) Matrix_set_value(a, i, j, 2.0 * rand() / RAND_MAX - 1.0);
+        Matrix *a_t = Matrix_transpose(a);
+        Matrix *covar_inv = Matrix_mul_matrix(a, a_t);
+        for(size_t i = 0; i < dim; ++i) Matrix_add_value(covar_inv, i, i, (double)dim);
+        
+        // Points stored as one array per dimension
+        double *points = (double *)malloc(n * dim * sizeof(double));
+        ck_assert(points != NULL);
+        for(size_t i = 0; i < n * dim; ++i) points[i] = 3.0 * rand() / RAND_MAX - 1.5;
+        double position[5];
+        for(size_t j = 0; j < dim; ++j) position[j] = 0.5 * rand() / RAND_MAX;
+        
+        // Reference: scalar density of each point, summed in order
+        Matrix *vector = Matrix_new(dim, 1);
+        double expected = 0.0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            for(size_t j = 0; j < dim; ++j) Matrix_set_value(vector, j, 0, points[j * n + i] - position[j]);
+            expected += Matrix_prob_dens_nocheck(covar_inv, vector, scal_fact);
+        }
+        
+        ck_assert(Matrix_prob_dens_sum(covar_inv, points, n, position, scal_fact) == expected);
+        
+        // Single point, i.e. one partial batch only
+        double point[5];
+        for(size_t j = 0; j < dim; ++j)
+        {
+            point[j] = points[j * n];
+            Matrix_set_value(vector, j, 0, point[j] - position[j]);
+        }
+        ck_assert(Matrix_prob_dens_sum(covar_inv, point, 1, position, scal_fact) == Matrix_prob_dens_nocheck(covar_inv, vector, scal_fact));
+        
+        // Cleanup
+        Matrix_delete(a);
+        Matrix_delete(a_t);
+        Matrix_delete(covar_inv);
+        Matrix_delete(vector);
+        free(points);
+    }
+}
+END_TEST
+
+// Test that the Skellam distribution from cached distances is bit-identical
+START_TEST (skellam_cache_identical)
+{
+    // More detections than MATRIX_BATCH_SIZE, so batches are partial
+    const size_t n_pos = 200;
+    const size_t n_neg = 300;
+    
+    srand(11);
+    for(int dim = 3; dim <= 5; ++dim)
+    {
+        double *pos = (double *)malloc(n_pos * dim * sizeof(double));
+        double *neg = (double *)malloc(n_neg * dim * sizeof(double));
+        ck_assert(pos != NULL && neg != NULL);
+        for(size_t i = 0; i < n_pos * dim; ++i) pos[i] = 2.0 * rand() / RAND_MAX + 0.5;
+        for(size_t i = 0; i < n_neg * dim; ++i) neg[i] = 2.0 * rand() / RAND_MAX;
+        
+        Matrix *covar = Matrix_covar(dim, n_neg, neg);
+        Array_dbl **cache = (Array_dbl **)calloc(2 * n_neg, sizeof(Array_dbl *));
+        ck_assert(cache != NULL);
+        
+        // Cache all distances for the unscaled kernel
+        Matrix *covar_inv = Matrix_invert(covar);
+        ck_assert(LinkerPar_cache_distances(cache, pos, neg, dim, n_pos, n_neg, covar_inv, INFINITY, SIZE_MAX));
+        Matrix_delete(covar_inv);
+        
+        // Compare at kernel variances that can be rescaled without rounding
+        const double variances[] = {1.0, 4.0, 0.25};
+        for(size_t k = 0; k < 3; ++k)
+        {
+            Matrix *covar_scaled = Matrix_copy(covar);
+            Matrix_mul_scalar(covar_scaled, variances[k]);
+            covar_inv = Matrix_invert(covar_scaled);
+            
+            Array_dbl *skellam = NULL;
+            Array_dbl *skellam_cached = NULL;
+            LinkerPar_calculate_skellam(&skellam, covar_inv, pos, neg, dim, n_pos, n_neg, 1.0, 0.0);
+            LinkerPar_cached_skellam(&skellam_cached, cache, n_neg, variances[k], INFINITY, 1.0);
+            
+            ck_assert(Array_dbl_get_size(skellam_cached) == n_neg);
+            for(size_t i = 0; i < n_neg; ++i) ck_assert(Array_dbl_get(skellam_cached, i) == Array_dbl_get(skellam, i));
+            
+            Array_dbl_delete(skellam);
+            Array_dbl_delete(skellam_cached);
+            Matrix_delete(covar_inv);
+            Matrix_delete(covar_scaled);
+        }
+        
+        // Cache must be refused if it exceeds the size limit
+        ck_assert(!LinkerPar_cache_distances(cache, pos, neg, dim, n_pos, n_neg, covar, INFINITY, 1024));
+        
+        // Cleanup
+        for(size_t i = 0; i < 2 * n_neg; ++i) Array_dbl_delete(cache[i]);
+        free(cache);
+        Matrix_delete(covar);
+        free(pos);
+        free(neg);
+    }
+}
+END_TEST
+
 // LinkerPar reliability suite
 Suite *LinkerPar_test_suite(void) {
     Suite *s;
     TCase *tc_matrix_covar_calculation, *tc_matrix_scaled_covar, *tc_skellam_array;
+    TCase *tc_map_duplicate_keys, *tc_map_rehash, *tc_map_empty;
+    TCase *tc_matrix_cholesky, *tc_matrix_cholesky_not_pos_def, *tc_kdtree_kernel_sum;
+    TCase *tc_matrix_prob_dens_sum, *tc_kdtree_neighbours, *tc_skellam_cache_identical;
 
     // Create test suite
     s = suite_create("LinkerPar");
@@ -197,14 +527,41 @@ Suite *LinkerPar_test_suite(void) {
     tc_matrix_covar_calculation = tcase_create("matrix_covar_calculation");
     tc_matrix_scaled_covar = tcase_create("matrix_scaled_covar");
     tc_skellam_array = tcase_create("skellam_array");
+    tc_map_duplicate_keys = tcase_create("map_duplicate_keys");
+    tc_map_rehash = tcase_create("map_rehash");
+    tc_map_empty = tcase_create("map_empty");
+    tc_matrix_cholesky = tcase_create("matrix_cholesky");
+    tc_matrix_cholesky_not_pos_def = tcase_create("matrix_cholesky_not_pos_def");
+    tc_kdtree_kernel_sum = tcase_create("kdtree_kernel_sum");
+    tc_matrix_prob_dens_sum = tcase_create("matrix_prob_dens_sum");
+    tc_kdtree_neighbours = tcase_create("kdtree_neighbours");
+    tc_skellam_cache_identical = tcase_create("skellam_cache_identical");
 
     // Add test cases to test suite
     tcase_add_test(tc_matrix_covar_calculation, matrix_covar_calculation);
     tcase_add_test(tc_matrix_scaled_covar, matrix_scaled_covar);
     tcase_add_test(tc_skellam_array, skellam_array);
+    tcase_add_test(tc_map_duplicate_keys, map_duplicate_keys);
+    tcase_add_test(tc_map_rehash, map_rehash);
+    tcase_add_test(tc_map_empty, map_empty);
+    tcase_add_test(tc_matrix_cholesky, matrix_cholesky);
+    tcase_add_test(tc_matrix_cholesky_not_pos_def, matrix_cholesky_not_pos_def);
+    tcase_add_test(tc_kdtree_kernel_sum, kdtree_kernel_sum);
+    tcase_add_test(tc_matrix_prob_dens_sum, matrix_prob_dens_sum);
+    tcase_add_test(tc_kdtree_neighbours, kdtree_neighbours);
+    tcase_add_test(tc_skellam_cache_identical, skellam_cache_identical);
     suite_add_tcase(s, tc_matrix_covar_calculation);
     suite_add_tcase(s, tc_matrix_scaled_covar);
     suite_add_tcase(s, tc_skellam_array);
+    suite_add_tcase(s, tc_map_duplicate_keys);
+    suite_add_tcase(s, tc_map_rehash);
+    suite_add_tcase(s, tc_map_empty);
+    suite_add_tcase(s, tc_matrix_cholesky);
+    suite_add_tcase(s, tc_matrix_cholesky_not_pos_def);
+    suite_add_tcase(s, tc_kdtree_kernel_sum);
+    suite_add_tcase(s, tc_matrix_prob_dens_sum);
+    suite_add_tcase(s, tc_kdtree_neighbours);
+    suite_add_tcase(s, tc_skellam_cache_identical);
     
     return s;
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "test_Source.h"
+
+#include "../src/Source.h"
+
+/**
+ * @brief Reference parameter search
+ * 
+ * Index of the last parameter of the specified name, determined by comparing the names of all
+ * parameters, as @p Source_par_exists did before the introduction of parameter schemas. Returns
+ * the number of parameters if the name is not found.
+ * 
+ */
+static size_t linear_find(const Source *src, const char *name)
+{
+    for(size_t i = Source_get_num_par(src); i--;) if(strcmp(Source_get_name(src, i), name) == 0) return i;
+    return Source_get_num_par(src);
+}
+
+/**
+ * @brief Assert parameter lookups against reference search
+ * 
+ * Asserts that @p Source_par_exists finds every parameter, as well as a name that does not exist,
+ * at the same index as the reference search.
+ * 
+ */
+static int lookups_consistent(const Source *src)
+{
+    for(size_t i = 0; i < Source_get_num_par(src); ++i)
+    {
+        size_t index = 0;
+        if(!Source_par_exists(src, Source_get_name(src, i), &index)) return 0;
+        if(index != linear_find(src, Source_get_name(src, i))) return 0;
+    }
+    
+    return !Source_par_exists(src, "no_such_parameter", NULL);
+}
+
+/**
+ * @brief Test parameter lookup after adding parameters
+ * 
+ * Adds integer and floating-point parameters, including one whose name is a prefix of another and
+ * one whose name occurs twice. This test asserts that all lookups agree with the reference search,
+ * with the last occurrence of a duplicate name being found, and that values, units and UCDs can
+ * be retrieved by name and index.
+ * 
+ */
+START_TEST (source_lookup_add)
+{
+    Source *src = Source_new(false);
+    
+    Source_add_par_int(src, "id", 1, "", "meta.id");
+    Source_add_par_flt(src, "x", 10.5, "pix", "pos.cartesian.x");
+    Source_add_par_flt(src, "x_peak", 11.0, "pix", "pos.cartesian.x");
+    Source_add_par_flt(src, "f_sum", 2.5, "Jy", "phot.flux");
+    ck_assert(lookups_consistent(src));
+    
+    size_t index = 99;
+    ck_assert(Source_par_exists(src, "x", &index) && index == 1);
+    ck_assert(!Source_par_exists(src, "x_", &index) && index == 1);
+    ck_assert(Source_get_par_by_name_int(src, "id") == 1);
+    ck_assert(Source_get_par_by_name_flt(src, "x_peak") == 11.0);
+    ck_assert(strcmp(Source_get_unit(src, 3), "Jy") == 0);
+    ck_assert(strcmp(Source_get_ucd(src, 3), "phot.flux") == 0);
+    
+    // Duplicate name resolves to last occurrence
+    Source_add_par_flt(src, "x", 20.5, "pix", "pos.cartesian.x");
+    ck_assert(Source_get_num_par(src) == 5);
+    ck_assert(Source_par_exists(src, "x", &index) && index == 4);
+    ck_assert(Source_get_par_by_name_flt(src, "x") == 20.5);
+    ck_assert(lookups_consistent(src));
+    
+    // Cleanup
+    Source_delete(src);
+}
+END_TEST
+
+/**
+ * @brief Test parameter lookup after overwriting parameters
+ * 
+ * Overwrites existing parameters with @p Source_set_par_* using the same definition, a new unit
+ * and UCD, a new type and @p NULL as unit and UCD, and creates a new parameter in the same way.
+ * This test asserts that overwritten parameters keep their index and that the definition, value
+ * and lookups of all parameters are as expected, without affecting a copy made beforehand.
+ * 
+ */
+START_TEST (source_lookup_overwrite)
+{
+    Source *src = Source_new(false);
+    Source_add_par_int(src, "id", 1, "", "meta.id");
+    Source_add_par_flt(src, "f_sum", 2.5, "Jy", "phot.flux");
+    Source_add_par_flt(src, "rms", 0.1, "Jy", "instr.det.noise");
+    Source *copy = Source_copy(src);
+    
+    size_t index = 0;
+    Source_set_par_flt(src, "f_sum", 3.5, "Jy", "phot.flux");
+    ck_assert(Source_par_exists(src, "f_sum", &index) && index == 1);
+    ck_assert(Source_get_par_flt(src, 1) == 3.5);
+    
+    Source_set_par_flt(src, "f_sum", 4.5, "Jy*Hz", "phot.flux.density");
+    ck_assert(Source_par_exists(src, "f_sum", &index) && index == 1);
+    ck_assert(strcmp(Source_get_unit(src, 1), "Jy*Hz") == 0);
+    ck_assert(strcmp(Source_get_ucd(src, 1), "phot.flux.density") == 0);
+    
+    Source_set_par_int(src, "rms", 7, NULL, NULL);
+    ck_assert(Source_par_exists(src, "rms", &index) && index == 2);
+    ck_assert(Source_get_type(src, 2) == SOURCE_TYPE_INT);
+    ck_assert(Source_get_par_int(src, 2) == 7);
+    ck_assert(strcmp(Source_get_unit(src, 2), "Jy") == 0);
+    
+    Source_set_par_flt(src, "ell_maj", 5.0, "pix", "phys.angSize");
+    ck_assert(Source_get_num_par(src) == 4);
+    ck_assert(Source_par_exists(src, "ell_maj", &index) && index == 3);
+    ck_assert(lookups_consistent(src));
+    
+    // Copy unaffected
+    ck_assert(Source_get_num_par(copy) == 3);
+    ck_assert(Source_get_par_by_name_flt(copy, "f_sum") == 2.5);
+    ck_assert(strcmp(Source_get_unit(copy, 1), "Jy") == 0);
+    ck_assert(Source_get_type(copy, 2) == SOURCE_TYPE_FLT);
+    ck_assert(!Source_par_exists(copy, "ell_maj", NULL));
+    ck_assert(lookups_consistent(copy));
+    
+    // Cleanup
+    Source_delete(copy);
+    Source_delete(src);
+}
+END_TEST
+
+/**
+ * @brief Test parameter lookup after many insertions
+ * 
+ * Adds 1000 parameters to two sources, forcing repeated growth of the parameter arrays and name
+ * hash tables. This test asserts that all lookups agree with the reference search and return the
+ * correct values, and that both sources share the same parameter names.
+ * 
+ */
+START_TEST (source_lookup_growth)
+{
+    const size_t n_par = 1000;
+    Source *src_a = Source_new(false);
+    Source *src_b = Source_new(false);
+    char name[32];
+    
+    for(size_t i = 0; i < n_par; ++i)
+    {
+        snprintf(name, sizeof(name), "par%zu", i);
+        Source_add_par_int(src_a, name, i, "", "meta.code");
+        Source_add_par_int(src_b, name, 2 * i, "", "meta.code");
+    }
+    
+    ck_assert(Source_get_num_par(src_a) == n_par);
+    ck_assert(lookups_consistent(src_a));
+    ck_assert(lookups_consistent(src_b));
+    
+    for(size_t i = 0; i < n_par; ++i)
+    {
+        snprintf(name, sizeof(name), "par%zu", i);
+        ck_assert(Source_get_par_by_name_int(src_a, name) == (long int)i);
+        ck_assert(Source_get_par_by_name_int(src_b, name) == 2 * (long int)i);
+        ck_assert(Source_get_name(src_a, i) == Source_get_name(src_b, i));
+    }
+    
+    // Cleanup
+    Source_delete(src_a);
+    Source_delete(src_b);
+}
+END_TEST
+
+Suite *Source_test_suite(void) {
+    Suite *s;
+    TCase *tc_source_lookup_add, *tc_source_lookup_overwrite, *tc_source_lookup_growth;
+
+    // Create test suite
+    s = suite_create("Source");
+
+    // Create test cases
+    tc_source_lookup_add = tcase_create("source_lookup_add");
+    tc_source_lookup_overwrite = tcase_create("source_lookup_overwrite");
+    tc_source_lookup_growth = tcase_create("source_lookup_growth");
+
+    // Add test cases to test suite
+    tcase_add_test(tc_source_lookup_add, source_lookup_add);
+    tcase_add_test(tc_source_lookup_overwrite, source_lookup_overwrite);
+    tcase_add_test(tc_source_lookup_growth, source_lookup_growth);
+    suite_add_tcase(s, tc_source_lookup_add);
+    suite_add_tcase(s, tc_source_lookup_overwrite);
+    suite_add_tcase(s, tc_source_lookup_growth);
+    
+    return s;
+}
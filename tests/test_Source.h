@@ -0,0 +1,8 @@
+#ifndef TEST_Source_H
+#define TEST_Source_H
+
+#include <check.h>
+
+Suite *Source_test_suite (void);
+
+#endif
@@ -1,5 +1,10 @@
 #include <stdlib.h>
 #include "test_LinkerPar.h"
+#include "test_DataCube.h"
+#include "test_Catalog.h"
+#include "test_BitMask.h"
+#include "test_Header.h"
+#include "test_Source.h"
 
 // Run unittest suite
 int main(void) {
@@ -10,6 +15,11 @@ int main(void) {
     s = suite_create("SoFiA-2");
     runner = srunner_create(s);
     srunner_add_suite(runner, LinkerPar_test_suite());
+    srunner_add_suite(runner, DataCube_test_suite());
+    srunner_add_suite(runner, Catalog_test_suite());
+    srunner_add_suite(runner, BitMask_test_suite());
+    srunner_add_suite(runner, Header_test_suite());
+    srunner_add_suite(runner, Source_test_suite());
 
     srunner_run_all(runner, CK_NORMAL);  
     no_failed = srunner_ntests_failed(runner); 